@@ -85,7 +85,15 @@
    to tx_port.h for descriptions on each of these options.  */
 
 /*#define TX_MAX_PRIORITIES                32*/
-/*#define TX_THREAD_USER_EXTENSION                ????*/
+/* Per thread state of the thread profiler, see thread_profile.c */
+#define TX_THREAD_USER_EXTENSION                                                                                       \
+  ULONG   tx_thread_profile_waiting;     /* Suspended on event flags, not resumed yet */                               \
+  ULONG   tx_thread_profile_wake_pending; /* Resumed by tx_event_flags_set, not running yet */                         \
+  ULONG   tx_thread_profile_wake_cycles;                                                                               \
+  ULONG   tx_thread_profile_wakes;                                                                                     \
+  ULONG   tx_thread_profile_wake_max;                                                                                  \
+  ULONG64 tx_thread_profile_wake_total;                                                                                \
+  ULONG64 tx_thread_profile_window_start; /* tx_thread_execution_time_total at the start of the window */
 /*#define TX_TIMER_THREAD_STACK_SIZE                1024*/
 /*#define TX_TIMER_THREAD_PRIORITY                0*/
 
@@ -128,7 +136,8 @@
    enabled. If the application does not use notify callbacks, they may be disabled to reduce
    code size and improve performance.  */
 
-#define TX_DISABLE_NOTIFY_CALLBACKS
+/* The thread profiler times the event flags wakes from the set notify. */
+/*#define TX_DISABLE_NOTIFY_CALLBACKS*/
 
 /* Determine if the tx_thread_resume and tx_thread_suspend services should have their internal
    code in-line. This results in a larger image, but improves the performance of the thread
@@ -191,6 +200,12 @@
 
 /*#define TX_ENABLE_EXECUTION_CHANGE_NOTIFY*/
 
+/* Define if the execution profile is enabled. The scheduler then calls the _tx_execution_* hooks
+   implemented by the thread profiler. The port assembly files do not include this file, so the
+   symbol must also be passed to the assembler.  */
+
+#define TX_EXECUTION_PROFILE_ENABLE
+
 /* Define the get system state macro. */
 
 /*#define TX_THREAD_GET_SYSTEM_STATE() _tx_thread_system_state */
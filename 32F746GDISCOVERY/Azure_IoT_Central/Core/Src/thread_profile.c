@@ -0,0 +1,280 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    thread_profile.c
+  * @author  MCD Application Team
+  * @brief   ThreadX per thread profiler
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "thread_profile.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include "stm32f7xx.h"
+#include "tx_event_flags.h"
+#include "tx_thread.h"
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+/* USER CODE END PTD */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+/* USER CODE END PD */
+
+/* Private macro -------------------------------------------------------------*/
+/* USER CODE BEGIN PM */
+
+/* USER CODE END PM */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+static ULONG window_start_tick;
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+VOID _tx_execution_thread_enter(VOID);
+VOID _tx_execution_thread_exit(VOID);
+VOID _tx_execution_isr_enter(VOID);
+VOID _tx_execution_isr_exit(VOID);
+/* USER CODE END PFP */
+
+/* USER CODE BEGIN 1 */
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+
+/* Scheduler hook, the thread in _tx_thread_current_ptr starts running. Interrupts are disabled. */
+VOID _tx_execution_thread_enter(VOID)
+{
+  TX_THREAD* thread = _tx_thread_current_ptr;
+  ULONG      now    = THREAD_PROFILE_CYCLES();
+  ULONG      latency;
+
+  thread->tx_thread_execution_time_last_start = now;
+  thread->tx_thread_profile_waiting           = TX_FALSE;
+
+  if (thread->tx_thread_profile_wake_pending)
+  {
+    latency = now - thread->tx_thread_profile_wake_cycles;
+
+    thread->tx_thread_profile_wake_pending = TX_FALSE;
+    thread->tx_thread_profile_wakes++;
+    thread->tx_thread_profile_wake_total += latency;
+    if (latency > thread->tx_thread_profile_wake_max)
+    {
+      thread->tx_thread_profile_wake_max = latency;
+    }
+  }
+}
+
+/* Scheduler hook, the thread in _tx_thread_current_ptr stops running. Interrupts are disabled. */
+VOID _tx_execution_thread_exit(VOID)
+{
+  TX_THREAD* thread = _tx_thread_current_ptr;
+
+  if (thread == TX_NULL)
+  {
+    return;
+  }
+
+  // A single run is far shorter than the 32 bit counter period
+  thread->tx_thread_execution_time_total +=
+      (ULONG)(THREAD_PROFILE_CYCLES() - (ULONG)thread->tx_thread_execution_time_last_start);
+
+  // Leaving to wait for event flags, the next set notify may be the one resuming it
+  thread->tx_thread_profile_waiting = (thread->tx_thread_state == TX_EVENT_FLAG);
+}
+
+/* The ISRs do not call _tx_thread_context_save / restore, their time is charged to the preempted thread */
+VOID _tx_execution_isr_enter(VOID)
+{
+}
+
+VOID _tx_execution_isr_exit(VOID)
+{
+}
+
+/* Called after tx_event_flags_set resumed its waiters and before they are scheduled */
+static VOID thread_profile_set_notify(TX_EVENT_FLAGS_GROUP* group)
+{
+  TX_THREAD* thread;
+  ULONG      count;
+  ULONG      now = THREAD_PROFILE_CYCLES();
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+
+  for (thread = _tx_thread_created_ptr, count = _tx_thread_created_count; count > 0;
+       thread = thread->tx_thread_created_next, count--)
+  {
+    if (thread->tx_thread_profile_waiting && thread->tx_thread_state == TX_READY &&
+        thread->tx_thread_suspend_control_block == (VOID*)group)
+    {
+      thread->tx_thread_profile_waiting      = TX_FALSE;
+      thread->tx_thread_profile_wake_pending = TX_TRUE;
+      thread->tx_thread_profile_wake_cycles  = now;
+    }
+  }
+
+  TX_RESTORE
+}
+
+/* Hook the groups without a notify of their own */
+static VOID thread_profile_watch_event_flags(VOID)
+{
+  TX_EVENT_FLAGS_GROUP* group;
+  ULONG                 count;
+
+  for (group = _tx_event_flags_created_ptr, count = _tx_event_flags_created_count; count > 0;
+       group = group->tx_event_flags_group_created_next, count--)
+  {
+    if (group->tx_event_flags_group_set_notify == TX_NULL)
+    {
+      tx_event_flags_set_notify(group, thread_profile_set_notify);
+    }
+  }
+}
+
+/* Copy the counters of the window that ends and start the next one. Interrupts are disabled. */
+static UINT thread_profile_window_restart(THREAD_PROFILE_ENTRY* entries, ULONG64* run_cycles, ULONG64* wake_cycles,
+                                          TX_THREAD** threads)
+{
+  TX_THREAD* thread;
+  ULONG      count;
+  ULONG      now = THREAD_PROFILE_CYCLES();
+  UINT       index;
+
+  // Charge the caller for its current run
+  thread = _tx_thread_current_ptr;
+  thread->tx_thread_execution_time_total += (ULONG)(now - (ULONG)thread->tx_thread_execution_time_last_start);
+  thread->tx_thread_execution_time_last_start = now;
+
+  for (thread = _tx_thread_created_ptr, count = _tx_thread_created_count, index = 0; count > 0;
+       thread = thread->tx_thread_created_next, count--)
+  {
+    if (index < THREAD_PROFILE_MAX_THREADS)
+    {
+      threads[index]             = thread;
+      run_cycles[index]          = thread->tx_thread_execution_time_total - thread->tx_thread_profile_window_start;
+      wake_cycles[index]         = thread->tx_thread_profile_wake_total;
+      entries[index].wakes       = thread->tx_thread_profile_wakes;
+      entries[index].wake_max_us = thread->tx_thread_profile_wake_max;
+      index++;
+    }
+
+    thread->tx_thread_profile_window_start = thread->tx_thread_execution_time_total;
+    thread->tx_thread_profile_wake_total   = 0;
+    thread->tx_thread_profile_wakes        = 0;
+    thread->tx_thread_profile_wake_max     = 0;
+  }
+
+  return index;
+}
+
+UINT thread_profile_init(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  // The Cortex-M7 DWT is write protected until unlocked
+  DWT->LAR = 0xC5ACCE55;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  thread_profile_watch_event_flags();
+
+  TX_DISABLE
+  window_start_tick = tx_time_get();
+  TX_RESTORE
+
+  return TX_SUCCESS;
+}
+
+UINT thread_profile_get(THREAD_PROFILE* profile)
+{
+  ULONG64               run_cycles[THREAD_PROFILE_MAX_THREADS];
+  ULONG64               wake_cycles[THREAD_PROFILE_MAX_THREADS];
+  TX_THREAD*            threads[THREAD_PROFILE_MAX_THREADS];
+  ULONG64               window_cycles;
+  ULONG64               busy_cycles   = 0;
+  ULONG                 cycles_per_us = SystemCoreClock / 1000000;
+  ULONG                 now_tick;
+  UINT                  index;
+  TX_THREAD*            thread;
+  THREAD_PROFILE_ENTRY* entry;
+  TX_INTERRUPT_SAVE_AREA
+
+  thread_profile_watch_event_flags();
+
+  TX_DISABLE
+  now_tick       = tx_time_get();
+  profile->count = thread_profile_window_restart(profile->thread, run_cycles, wake_cycles, threads);
+  TX_RESTORE
+
+  window_cycles      = (ULONG64)(now_tick - window_start_tick) * (SystemCoreClock / TX_TIMER_TICKS_PER_SECOND);
+  profile->window_ms = (now_tick - window_start_tick) * 1000 / TX_TIMER_TICKS_PER_SECOND;
+  window_start_tick  = now_tick;
+
+  for (index = 0; index < profile->count; index++)
+  {
+    thread = threads[index];
+    entry  = &profile->thread[index];
+
+    // Without TX_ENABLE_STACK_CHECKING create leaves the mark unset, the search starts from the saved stack pointer
+    if (thread->tx_thread_stack_highest_ptr == TX_NULL)
+    {
+      thread->tx_thread_stack_highest_ptr = thread->tx_thread_stack_ptr;
+    }
+
+    // Search the stack fill pattern for the high-water mark
+    _tx_thread_stack_analyze(thread);
+
+    entry->name         = thread->tx_thread_name;
+    entry->priority     = thread->tx_thread_priority;
+    entry->cpu_permille = (window_cycles > 0) ? (ULONG)(run_cycles[index] * 1000 / window_cycles) : 0;
+    entry->stack_size   = thread->tx_thread_stack_size;
+    entry->stack_used =
+        (ULONG)((UCHAR*)thread->tx_thread_stack_end - (UCHAR*)thread->tx_thread_stack_highest_ptr) + 1;
+    entry->wake_avg_us = (entry->wakes > 0) ? (ULONG)(wake_cycles[index] / entry->wakes / cycles_per_us) : 0;
+    entry->wake_max_us = entry->wake_max_us / cycles_per_us;
+
+    busy_cycles += run_cycles[index];
+  }
+
+  profile->idle_permille =
+      (window_cycles > busy_cycles) ? (ULONG)((window_cycles - busy_cycles) * 1000 / window_cycles) : 0;
+
+  return TX_SUCCESS;
+}
+
+#else
+
+UINT thread_profile_init(VOID)
+{
+  return TX_FEATURE_NOT_ENABLED;
+}
+
+UINT thread_profile_get(THREAD_PROFILE* profile)
+{
+  (void)profile;
+
+  return TX_FEATURE_NOT_ENABLED;
+}
+
+#endif
+/* USER CODE END 1 */
@@ -33,6 +33,10 @@
 #include "nx_azure_iot_hub_client.h"
 
 #include "pnp_device_info.h"
+
+#include "stm32746g_discovery_qspi.h"
+
+#include "thread_profile.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -43,6 +47,7 @@ typedef enum TELEMETRY_STATE_ENUM
   // TELEMETRY_STATE_MAGNETOMETER,
   // TELEMETRY_STATE_ACCELEROMETER,
   // TELEMETRY_STATE_GYROSCOPE,
+  TELEMETRY_STATE_THREAD_PROFILE,
   TELEMETRY_STATE_END
 } TELEMETRY_STATE;
 /* USER CODE END PTD */
@@ -52,6 +57,20 @@ typedef enum TELEMETRY_STATE_ENUM
 #define TELEMETRY_TEMPERATURE "temperature"
 #define TELEMETRY_HUMIDITY    "humidity"
 #define PROPERTY_LED_STATE    "led_state"
+
+/* Thread profile component, one window per telemetry rotation */
+#define THREAD_PROFILE_COMPONENT "threadProfile"
+#define TELEMETRY_CPU_LOAD       "cpuLoad"
+#define TELEMETRY_THREADS        "threads"
+
+/* Telemetry batch flush thresholds, samples / bytes / seconds */
+#define TELEMETRY_BATCH_MAX_SAMPLES 6
+#define TELEMETRY_BATCH_MAX_BYTES   1024
+#define TELEMETRY_BATCH_MAX_AGE     60
+
+/* DPS cache and DHCP lease locations, the last two subsectors of the N25Q128A QSPI flash */
+#define DPS_CACHE_QSPI_ADDRESS  (N25Q128A_FLASH_SIZE - N25Q128A_SUBSECTOR_SIZE)
+#define DHCP_LEASE_QSPI_ADDRESS (N25Q128A_FLASH_SIZE - 2 * N25Q128A_SUBSECTOR_SIZE)
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -64,6 +83,9 @@ typedef enum TELEMETRY_STATE_ENUM
 static AZURE_IOT_CONTEXT nx_azure_iot_client;
 
 static int32_t telemetry_interval = 10;
+
+/* Per thread CPU, stack and wake latency of the window closed by the last thread profile telemetry */
+static THREAD_PROFILE thread_profile;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -141,17 +163,148 @@ static UINT append_device_telemetry(NX_AZURE_IOT_JSON_WRITER* json_writer)
   return NX_AZURE_IOT_SUCCESS;
 }
 
+static UINT append_thread_profile_telemetry(NX_AZURE_IOT_JSON_WRITER* json_writer)
+{
+  THREAD_PROFILE_ENTRY* entry;
+  UINT                  index;
+
+  if (nx_azure_iot_json_writer_append_property_with_double_value(json_writer,
+          (UCHAR*)TELEMETRY_CPU_LOAD,
+          sizeof(TELEMETRY_CPU_LOAD) - 1,
+          (1000 - thread_profile.idle_permille) / 10.0,
+          1) ||
+      nx_azure_iot_json_writer_append_property_name(
+          json_writer, (UCHAR*)TELEMETRY_THREADS, sizeof(TELEMETRY_THREADS) - 1) ||
+      nx_azure_iot_json_writer_append_begin_array(json_writer))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  for (index = 0; index < thread_profile.count; index++)
+  {
+    entry = &thread_profile.thread[index];
+
+    if (nx_azure_iot_json_writer_append_begin_object(json_writer) ||
+        nx_azure_iot_json_writer_append_property_with_string_value(json_writer,
+            (UCHAR*)"name",
+            sizeof("name") - 1,
+            (UCHAR*)entry->name,
+            strlen(entry->name)) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"priority", sizeof("priority") - 1, entry->priority) ||
+        nx_azure_iot_json_writer_append_property_with_double_value(
+            json_writer, (UCHAR*)"cpu", sizeof("cpu") - 1, entry->cpu_permille / 10.0, 1) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"stackUsed", sizeof("stackUsed") - 1, entry->stack_used) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"stackSize", sizeof("stackSize") - 1, entry->stack_size) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"wakes", sizeof("wakes") - 1, entry->wakes) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"wakeAvgUs", sizeof("wakeAvgUs") - 1, entry->wake_avg_us) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"wakeMaxUs", sizeof("wakeMaxUs") - 1, entry->wake_max_us) ||
+        nx_azure_iot_json_writer_append_end_object(json_writer))
+    {
+      return NX_NOT_SUCCESSFUL;
+    }
+  }
+
+  if (nx_azure_iot_json_writer_append_end_array(json_writer))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  printf("Thread profile: %lu.%lu%% CPU over %lu ms, %u threads\r\n",
+      (1000 - thread_profile.idle_permille) / 10,
+      (1000 - thread_profile.idle_permille) % 10,
+      thread_profile.window_ms,
+      thread_profile.count);
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
 static VOID telemetry_callback(AZURE_IOT_CONTEXT* context)
 {
   static TELEMETRY_STATE telemetry_state = TELEMETRY_STATE_DEFAULT;
 
+  // Timestamps and SAS tokens rely on the clock, keep it disciplined while connected
+  sntp_poll();
+
   switch (telemetry_state)
   {
     case TELEMETRY_STATE_DEFAULT:
-      nx_azure_iot_client_publish_telemetry(&nx_azure_iot_client, NULL, append_device_telemetry);
+      nx_azure_iot_client_queue_telemetry(&nx_azure_iot_client, NULL, append_device_telemetry);
+      break;
+
+    case TELEMETRY_STATE_THREAD_PROFILE:
+      if (thread_profile_get(&thread_profile) == TX_SUCCESS)
+      {
+        nx_azure_iot_client_queue_telemetry(
+            &nx_azure_iot_client, THREAD_PROFILE_COMPONENT, append_thread_profile_telemetry);
+      }
+      break;
+
     default:
       break;
   }
+
+  telemetry_state = (telemetry_state + 1) % TELEMETRY_STATE_END;
+}
+
+static UINT dps_cache_read(AZURE_IOT_DPS_CACHE* cache)
+{
+  if (BSP_QSPI_Read((uint8_t*)cache, DPS_CACHE_QSPI_ADDRESS, sizeof(AZURE_IOT_DPS_CACHE)) != QSPI_OK)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_SUCCESS;
+}
+
+static UINT dps_cache_write(const AZURE_IOT_DPS_CACHE* cache)
+{
+  if (BSP_QSPI_Erase_Block(DPS_CACHE_QSPI_ADDRESS) != QSPI_OK ||
+      BSP_QSPI_Write((uint8_t*)cache, DPS_CACHE_QSPI_ADDRESS, sizeof(AZURE_IOT_DPS_CACHE)) != QSPI_OK)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_SUCCESS;
+}
+
+static UINT dhcp_lease_read(DHCP_LEASE* lease)
+{
+  if (BSP_QSPI_Read((uint8_t*)lease, DHCP_LEASE_QSPI_ADDRESS, sizeof(DHCP_LEASE)) != QSPI_OK)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_SUCCESS;
+}
+
+static UINT dhcp_lease_write(const DHCP_LEASE* lease)
+{
+  if (BSP_QSPI_Erase_Block(DHCP_LEASE_QSPI_ADDRESS) != QSPI_OK ||
+      BSP_QSPI_Write((uint8_t*)lease, DHCP_LEASE_QSPI_ADDRESS, sizeof(DHCP_LEASE)) != QSPI_OK)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_SUCCESS;
+}
+
+static UINT network_connect()
+{
+  CHAR hostname[AZURE_IOT_HOST_NAME_SIZE + 1];
+
+  // Let the bring-up resolve the endpoint while it waits for SNTP
+  if (nx_azure_iot_client_endpoint_get(&nx_azure_iot_client, hostname, sizeof(hostname)) != NX_SUCCESS)
+  {
+    hostname[0] = 0;
+  }
+
+  return MX_NetXDuo_Connect(hostname);
 }
 
 static VOID properties_complete_callback(AZURE_IOT_CONTEXT* context)
@@ -183,10 +336,22 @@ UINT Azure_Iot_Entry(
     return ret;
   }
 
+  /* Profile the threads, reported with the telemetry. */
+  if (thread_profile_init() != TX_SUCCESS)
+  {
+    printf("WARNING: Thread profile not available\r\n");
+  }
+
   /* Register the callbacks. */
   nx_azure_iot_client_register_timer_callback(&nx_azure_iot_client, telemetry_callback, telemetry_interval);
   nx_azure_iot_client_register_properties_complete_callback(&nx_azure_iot_client, properties_complete_callback);
 
+  /* Batch telemetry samples into fewer, larger messages. */
+  nx_azure_iot_client_telemetry_batch_set(&nx_azure_iot_client,
+      TELEMETRY_BATCH_MAX_SAMPLES,
+      TELEMETRY_BATCH_MAX_BYTES,
+      TELEMETRY_BATCH_MAX_AGE);
+
   /* Set up authentication. */
 #ifdef ENABLE_X509
 
@@ -200,11 +365,24 @@ UINT Azure_Iot_Entry(
   }
 #endif
 
+  /* Keep the DHCP lease and the DPS result in the QSPI flash to shorten the next boot. */
+  if (BSP_QSPI_Init() == QSPI_OK)
+  {
+    MX_NetXDuo_Register_Lease_Storage(dhcp_lease_read, dhcp_lease_write);
+#ifdef ENABLE_DPS
+    nx_azure_iot_client_register_dps_cache(&nx_azure_iot_client, dps_cache_read, dps_cache_write);
+#endif
+  }
+  else
+  {
+    printf("WARNING: QSPI flash not available, DHCP and provisioning run in full on every boot\r\n");
+  }
+
   /* Enter the main loop. */
 #ifdef ENABLE_DPS
-  nx_azure_iot_client_dps_run(&nx_azure_iot_client, IOT_DPS_ID_SCOPE, IOT_DPS_REGISTRATION_ID, MX_NetXDuo_Connect);
+  nx_azure_iot_client_dps_run(&nx_azure_iot_client, IOT_DPS_ID_SCOPE, IOT_DPS_REGISTRATION_ID, network_connect);
 #else
-  nx_azure_iot_client_hub_run(&nx_azure_iot_client, IOT_HUB_HOSTNAME, IOT_HUB_DEVICE_ID, MX_NetXDuo_Connect);
+  nx_azure_iot_client_hub_run(&nx_azure_iot_client, IOT_HUB_HOSTNAME, IOT_HUB_DEVICE_ID, network_connect);
 #endif
 
   return NX_SUCCESS;
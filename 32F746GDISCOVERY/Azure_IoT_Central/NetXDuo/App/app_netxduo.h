@@ -41,7 +41,21 @@
 
 /* Exported types ------------------------------------------------------------*/
 /* USER CODE BEGIN ET */
-
+/* Last DHCP lease, kept in non-volatile storage to request the same address after a reboot */
+typedef struct DHCP_LEASE_STRUCT
+{
+  ULONG magic;
+  ULONG ip_address;
+  ULONG network_mask;
+  ULONG gateway_address;
+  ULONG server_address;
+  ULONG lease_time;
+  ULONG checksum;
+} DHCP_LEASE;
+
+/* Storage backend for the DHCP lease, returns NX_SUCCESS once the whole record is read or written */
+typedef UINT (*func_ptr_dhcp_lease_read)(DHCP_LEASE*);
+typedef UINT (*func_ptr_dhcp_lease_write)(const DHCP_LEASE*);
 /* USER CODE END ET */
 
 /* Exported constants --------------------------------------------------------*/
@@ -62,14 +76,20 @@
 
 #define NX_PACKET_SIZE      1536
 #define NX_PACKET_COUNT     32
-#define NX_PACKET_POOL_SIZE ((NX_PACKET_SIZE + sizeof(NX_PACKET)) * NX_PACKET_COUNT)
+/* Headers are padded to NX_PACKET_ALIGNMENT, so that the payloads start on a cache line */
+#define NX_PACKET_HEADER_SIZE ((sizeof(NX_PACKET) + NX_PACKET_ALIGNMENT - 1) & ~(NX_PACKET_ALIGNMENT - 1))
+#define NX_PACKET_POOL_SIZE   ((NX_PACKET_SIZE + NX_PACKET_HEADER_SIZE) * NX_PACKET_COUNT)
 
 #define NX_ARP_CACHE_SIZE   512
+#define NX_DNS_CACHE_SIZE   1024
 
 
 #define NULL_ADDRESS     IP_ADDRESS(0, 0, 0, 0)
 
 #define DEFAULT_TIMEOUT 5 * NX_IP_PERIODIC_RATE
+
+/* Marks a valid DHCP lease record */
+#define DHCP_LEASE_MAGIC 0x31504844
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
@@ -93,9 +113,18 @@ extern NX_IP          IpInstance;
 extern NX_DNS         DnsClient;
 
 UINT MX_NetXDuo_Init();
-UINT MX_NetXDuo_Connect();
+/* Bring the network up, hostname is resolved ahead of the connect when set */
+UINT MX_NetXDuo_Connect(CHAR* hostname);
 
+/* Persist the DHCP lease so the next boot requests it directly (INIT-REBOOT). */
+UINT MX_NetXDuo_Register_Lease_Storage(func_ptr_dhcp_lease_read read, func_ptr_dhcp_lease_write write);
+
+/* Unix time kept by nx_azure_iot_clock, valid after the first connect */
 UINT sntp_time(ULONG* unix_time);
+UINT sntp_time_ms(ULONG64* unix_ms);
+
+/* Keeps the clock disciplined once connected, cheap to call often */
+VOID sntp_poll();
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
@@ -0,0 +1,242 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    nx_azure_iot_clock.c
+  * @author  Microsoft
+  * @brief   Wall clock disciplined by SNTP file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 Microsoft.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "nx_azure_iot_clock.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+/* USER CODE END PTD */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+#define PPB 1000000000LL
+/* USER CODE END PD */
+
+/* Private macro -------------------------------------------------------------*/
+/* USER CODE BEGIN PM */
+
+/* USER CODE END PM */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+static AZURE_IOT_CLOCK azure_iot_clock;
+
+/* Number of drift estimates so far, the first one is taken in full */
+static ULONG drift_estimates;
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+
+/* USER CODE END PFP */
+
+/* USER CODE BEGIN 1 */
+static int64_t ticks_to_us(int64_t ticks)
+{
+  return ticks * 1000000 / TX_TIMER_TICKS_PER_SECOND;
+}
+
+static int64_t us_to_ticks(int64_t us)
+{
+  return (us * TX_TIMER_TICKS_PER_SECOND + 999999) / 1000000;
+}
+
+/* Extend a tx_time_get value to 64 bits. Ticks older than the last one seen are placed
+   behind it rather than being taken for a wrap. Called with interrupts disabled. */
+static ULONG64 clock_tick_extend(ULONG tick)
+{
+  int32_t delta = (int32_t)(tick - azure_iot_clock.tick_last);
+
+  if (delta >= 0)
+  {
+    azure_iot_clock.tick_extended += (ULONG)delta;
+    azure_iot_clock.tick_last = tick;
+    return azure_iot_clock.tick_extended;
+  }
+
+  return azure_iot_clock.tick_extended - (ULONG)(-(int64_t)delta);
+}
+
+/* Clock reading at an extended tick, before the monotonic clamp. Called with interrupts disabled. */
+static ULONG64 clock_read(ULONG64 tick)
+{
+  int64_t elapsed_us = ticks_to_us((int64_t)(tick - azure_iot_clock.base_tick));
+  ULONG64 slew_tick  = (tick < azure_iot_clock.slew_end_tick) ? tick : azure_iot_clock.slew_end_tick;
+  int64_t slew_us    = ticks_to_us((int64_t)(slew_tick - azure_iot_clock.base_tick));
+
+  return azure_iot_clock.base_us + elapsed_us + (elapsed_us * azure_iot_clock.drift_ppb) / PPB +
+         (slew_us * azure_iot_clock.slew_ppb) / PPB;
+}
+
+static int32_t clock_clamp_ppb(int64_t ppb)
+{
+  if (ppb > AZURE_IOT_CLOCK_MAX_PPB)
+  {
+    return AZURE_IOT_CLOCK_MAX_PPB;
+  }
+
+  if (ppb < -AZURE_IOT_CLOCK_MAX_PPB)
+  {
+    return -AZURE_IOT_CLOCK_MAX_PPB;
+  }
+
+  return (int32_t)ppb;
+}
+
+VOID nx_azure_iot_clock_update(ULONG64 unix_us, ULONG tick)
+{
+  ULONG64 extended;
+  ULONG64 local_us;
+  int64_t offset_us;
+  int64_t interval;
+  int64_t slew_ticks;
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+
+  if (!azure_iot_clock.synced)
+  {
+    azure_iot_clock.tick_last     = tick;
+    azure_iot_clock.tick_extended = tick;
+  }
+
+  extended  = clock_tick_extend(tick);
+  local_us  = clock_read(extended);
+  offset_us = (int64_t)(unix_us - local_us);
+
+  if (!azure_iot_clock.synced || offset_us > AZURE_IOT_CLOCK_STEP_LIMIT_US ||
+      offset_us < -AZURE_IOT_CLOCK_STEP_LIMIT_US)
+  {
+    // Too far off to slew, jump. A step back holds the readings until the clock catches up.
+    if (azure_iot_clock.synced)
+    {
+      azure_iot_clock.steps++;
+    }
+
+    azure_iot_clock.base_us       = unix_us;
+    azure_iot_clock.base_tick     = extended;
+    azure_iot_clock.slew_ppb      = 0;
+    azure_iot_clock.slew_end_tick = extended;
+  }
+  else
+  {
+    // The previous offset was slewed out, what accumulated since is the oscillator drift.
+    // More than the bound is not, the reference moved: it is only slewed out.
+    interval = (int64_t)(extended - azure_iot_clock.update_tick);
+    if (interval >= AZURE_IOT_CLOCK_DRIFT_MIN_TICKS && extended >= azure_iot_clock.slew_end_tick)
+    {
+      int64_t measured_ppb = (offset_us * PPB) / ticks_to_us(interval);
+
+      if (measured_ppb <= AZURE_IOT_CLOCK_MAX_PPB && measured_ppb >= -AZURE_IOT_CLOCK_MAX_PPB)
+      {
+        azure_iot_clock.drift_ppb =
+            clock_clamp_ppb(azure_iot_clock.drift_ppb + ((drift_estimates == 0) ? measured_ppb : measured_ppb / 2));
+        drift_estimates++;
+      }
+    }
+
+    // Continue from the current reading and slew the offset out at the highest rate
+    slew_ticks = us_to_ticks(((offset_us < 0) ? -offset_us : offset_us) * (PPB / AZURE_IOT_CLOCK_MAX_PPB));
+
+    azure_iot_clock.base_us       = local_us;
+    azure_iot_clock.base_tick     = extended;
+    azure_iot_clock.slew_ppb      = (slew_ticks > 0) ? clock_clamp_ppb((offset_us * PPB) / ticks_to_us(slew_ticks)) : 0;
+    azure_iot_clock.slew_end_tick = extended + (ULONG64)slew_ticks;
+  }
+
+  azure_iot_clock.update_tick    = extended;
+  azure_iot_clock.last_offset_us = offset_us;
+  azure_iot_clock.synced         = TX_TRUE;
+  azure_iot_clock.updates++;
+
+  TX_RESTORE
+}
+
+UINT nx_azure_iot_clock_get_us(ULONG64* unix_us)
+{
+  ULONG64 now_us;
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+
+  if (!azure_iot_clock.synced)
+  {
+    TX_RESTORE
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  now_us = clock_read(clock_tick_extend(tx_time_get()));
+
+  if (now_us < azure_iot_clock.last_us)
+  {
+    now_us = azure_iot_clock.last_us;
+  }
+
+  azure_iot_clock.last_us = now_us;
+
+  TX_RESTORE
+
+  *unix_us = now_us;
+
+  return NX_SUCCESS;
+}
+
+UINT nx_azure_iot_clock_get_ms(ULONG64* unix_ms)
+{
+  UINT    status;
+  ULONG64 unix_us;
+
+  if ((status = nx_azure_iot_clock_get_us(&unix_us)) == NX_SUCCESS)
+  {
+    *unix_ms = unix_us / 1000;
+  }
+
+  return status;
+}
+
+UINT nx_azure_iot_clock_get(ULONG* unix_time)
+{
+  UINT    status;
+  ULONG64 unix_us;
+
+  if ((status = nx_azure_iot_clock_get_us(&unix_us)) == NX_SUCCESS)
+  {
+    *unix_time = (ULONG)(unix_us / 1000000);
+  }
+
+  return status;
+}
+
+VOID nx_azure_iot_clock_state_get(AZURE_IOT_CLOCK* state)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  *state = azure_iot_clock;
+  TX_RESTORE
+}
+/* USER CODE END 1 */
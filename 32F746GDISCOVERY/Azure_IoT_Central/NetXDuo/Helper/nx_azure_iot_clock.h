@@ -0,0 +1,114 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    nx_azure_iot_clock.h
+ * @author  Microsoft
+ * @brief   Wall clock disciplined by SNTP header file
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2022 Microsoft.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __NX_AZURE_IOT_CLOCK_H__
+#define __NX_AZURE_IOT_CLOCK_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include <stdint.h>
+
+#include "nx_api.h"
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+
+/* State of the clock, read it with nx_azure_iot_clock_state_get for diagnostics */
+typedef struct AZURE_IOT_CLOCK_STRUCT
+{
+  UINT synced;
+
+  // Extended 64 bit tick counter, survives the wrap of tx_time_get
+  ULONG   tick_last;
+  ULONG64 tick_extended;
+
+  // Clock reading at base_tick, in microseconds since the Unix epoch
+  ULONG64 base_us;
+  ULONG64 base_tick;
+
+  // Frequency correction estimated from successive updates, and the temporary slew of the last offset
+  int32_t drift_ppb;
+  int32_t slew_ppb;
+  ULONG64 slew_end_tick;
+
+  // Last reading handed out, readers never see the clock go backwards
+  ULONG64 last_us;
+
+  // Reference of the previous update, the offset accumulated since then is the drift
+  ULONG64 update_tick;
+
+  int64_t last_offset_us;
+  ULONG   updates;
+  ULONG   steps;
+} AZURE_IOT_CLOCK;
+/* USER CODE END ET */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+
+/* Offsets above this are stepped, smaller ones are slewed out */
+#define AZURE_IOT_CLOCK_STEP_LIMIT_US 1000000
+/* Bound of the drift and slew corrections, in parts per billion */
+#define AZURE_IOT_CLOCK_MAX_PPB 500000
+/* Shortest interval between updates used to estimate the drift */
+#define AZURE_IOT_CLOCK_DRIFT_MIN_TICKS (60 * TX_TIMER_TICKS_PER_SECOND)
+/* USER CODE END EC */
+
+/* Exported macro ------------------------------------------------------------*/
+/* USER CODE BEGIN EM */
+
+/* USER CODE END EM */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/* Feed a reference time, unix_us was true at tick (a tx_time_get value). Callable from any thread. */
+VOID nx_azure_iot_clock_update(ULONG64 unix_us, ULONG tick);
+
+/* Current time, return NX_NOT_SUCCESSFUL until the first update. Resolution is one tick.
+   Must be read or updated at least once every 2^31 ticks to follow the tick wrap. */
+UINT nx_azure_iot_clock_get_us(ULONG64* unix_us);
+UINT nx_azure_iot_clock_get_ms(ULONG64* unix_ms);
+
+/* Seconds, matches the unix_time_callback of nx_azure_iot_client_create */
+UINT nx_azure_iot_clock_get(ULONG* unix_time);
+
+VOID nx_azure_iot_clock_state_get(AZURE_IOT_CLOCK* state);
+/* USER CODE END EFP */
+
+/* Private defines -----------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+/* USER CODE END PD */
+
+/* USER CODE BEGIN 1 */
+
+/* USER CODE END 1 */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NX_AZURE_IOT_CLOCK_H__ */
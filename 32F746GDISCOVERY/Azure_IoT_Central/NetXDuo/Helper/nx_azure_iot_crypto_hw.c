@@ -0,0 +1,685 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    nx_azure_iot_crypto_hw.c
+  * @author  Microsoft
+  * @brief   Crypto methods offloaded to a hardware driver file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 Microsoft.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "nx_azure_iot_crypto_hw.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include <string.h>
+
+#include "nx_crypto_aes.h"
+#include "nx_crypto_ec.h"
+#include "nx_crypto_hmac_sha2.h"
+#include "nx_crypto_sha2.h"
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+/* Copy of a software curve with the scalar multiplication replaced, the curve comes first so
+   that the NX_CRYPTO_EC pointer handed to ECDH and ECDSA leads back here */
+typedef struct CRYPTO_HW_EC_STRUCT
+{
+  NX_CRYPTO_EC                 curve;
+  NX_AZURE_IOT_CRYPTO_HW_CURVE params;
+  UINT                         ready;
+} CRYPTO_HW_EC;
+
+/* Blocks of a chunk already run through the peripheral, handed out in order to the software modes */
+typedef struct CRYPTO_HW_AES_CHUNK_STRUCT
+{
+  UCHAR* next;
+} CRYPTO_HW_AES_CHUNK;
+/* USER CODE END PTD */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+/* USER CODE END PD */
+
+/* Private macro -------------------------------------------------------------*/
+/* USER CODE BEGIN PM */
+
+/* USER CODE END PM */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+static const NX_AZURE_IOT_CRYPTO_HW_DRIVER* crypto_hw_driver;
+
+static CRYPTO_HW_EC crypto_hw_secp256r1;
+static CRYPTO_HW_EC crypto_hw_secp384r1;
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+static UINT crypto_hw_aes_operation(UINT op,
+    VOID* handle,
+    struct NX_CRYPTO_METHOD_STRUCT* method,
+    UCHAR* key,
+    NX_CRYPTO_KEY_SIZE key_size_in_bits,
+    UCHAR* input,
+    ULONG input_length_in_byte,
+    UCHAR* iv_ptr,
+    UCHAR* output,
+    ULONG output_length_in_byte,
+    VOID* crypto_metadata,
+    ULONG crypto_metadata_size,
+    VOID* packet_ptr,
+    VOID (*nx_crypto_hw_process_callback)(VOID* packet_ptr, UINT status));
+static UINT crypto_hw_sha256_operation(UINT op,
+    VOID* handle,
+    struct NX_CRYPTO_METHOD_STRUCT* method,
+    UCHAR* key,
+    NX_CRYPTO_KEY_SIZE key_size_in_bits,
+    UCHAR* input,
+    ULONG input_length_in_byte,
+    UCHAR* iv_ptr,
+    UCHAR* output,
+    ULONG output_length_in_byte,
+    VOID* crypto_metadata,
+    ULONG crypto_metadata_size,
+    VOID* packet_ptr,
+    VOID (*nx_crypto_hw_process_callback)(VOID* packet_ptr, UINT status));
+static UINT crypto_hw_hmac_sha256_operation(UINT op,
+    VOID* handle,
+    struct NX_CRYPTO_METHOD_STRUCT* method,
+    UCHAR* key,
+    NX_CRYPTO_KEY_SIZE key_size_in_bits,
+    UCHAR* input,
+    ULONG input_length_in_byte,
+    UCHAR* iv_ptr,
+    UCHAR* output,
+    ULONG output_length_in_byte,
+    VOID* crypto_metadata,
+    ULONG crypto_metadata_size,
+    VOID* packet_ptr,
+    VOID (*nx_crypto_hw_process_callback)(VOID* packet_ptr, UINT status));
+static UINT crypto_hw_ec_operation(UINT op,
+    VOID* handle,
+    struct NX_CRYPTO_METHOD_STRUCT* method,
+    UCHAR* key,
+    NX_CRYPTO_KEY_SIZE key_size_in_bits,
+    UCHAR* input,
+    ULONG input_length_in_byte,
+    UCHAR* iv_ptr,
+    UCHAR* output,
+    ULONG output_length_in_byte,
+    VOID* crypto_metadata,
+    ULONG crypto_metadata_size,
+    VOID* packet_ptr,
+    VOID (*nx_crypto_hw_process_callback)(VOID* packet_ptr, UINT status));
+/* USER CODE END PFP */
+
+/* USER CODE BEGIN 1 */
+
+/* Same algorithm, sizes, metadata and init as the software methods in nx_crypto_methods.c,
+   NX Secure picks methods by algorithm so these replace them in the supported crypto table */
+NX_CRYPTO_METHOD crypto_method_aes_cbc_128_hw = {
+    NX_CRYPTO_ENCRYPTION_AES_CBC,
+    NX_CRYPTO_AES_128_KEY_LEN_IN_BITS,
+    NX_CRYPTO_AES_IV_LEN_IN_BITS,
+    0,
+    (NX_CRYPTO_AES_BLOCK_SIZE_IN_BITS >> 3),
+    sizeof(NX_CRYPTO_AES),
+    _nx_crypto_method_aes_init,
+    _nx_crypto_method_aes_cleanup,
+    crypto_hw_aes_operation,
+};
+
+NX_CRYPTO_METHOD crypto_method_aes_128_gcm_16_hw = {
+    NX_CRYPTO_ENCRYPTION_AES_GCM_16,
+    NX_CRYPTO_AES_128_KEY_LEN_IN_BITS,
+    32,
+    128,
+    (NX_CRYPTO_AES_BLOCK_SIZE_IN_BITS >> 3),
+    sizeof(NX_CRYPTO_AES),
+    _nx_crypto_method_aes_init,
+    _nx_crypto_method_aes_cleanup,
+    crypto_hw_aes_operation,
+};
+
+NX_CRYPTO_METHOD crypto_method_sha256_hw = {
+    NX_CRYPTO_HASH_SHA256,
+    0,
+    0,
+    NX_CRYPTO_SHA256_ICV_LEN_IN_BITS,
+    NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES,
+    sizeof(NX_CRYPTO_SHA256),
+    _nx_crypto_method_sha256_init,
+    _nx_crypto_method_sha256_cleanup,
+    crypto_hw_sha256_operation,
+};
+
+NX_CRYPTO_METHOD crypto_method_hmac_sha256_hw = {
+    NX_CRYPTO_AUTHENTICATION_HMAC_SHA2_256,
+    0,
+    0,
+    NX_CRYPTO_HMAC_SHA256_ICV_FULL_LEN_IN_BITS,
+    NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES,
+    sizeof(NX_CRYPTO_SHA256_HMAC),
+    _nx_crypto_method_hmac_sha256_init,
+    _nx_crypto_method_hmac_sha256_cleanup,
+    crypto_hw_hmac_sha256_operation,
+};
+
+NX_CRYPTO_METHOD crypto_method_ec_secp256_hw = {
+    NX_CRYPTO_EC_SECP256R1,
+    256,
+    0,
+    0,
+    0,
+    0,
+    NX_CRYPTO_NULL,
+    NX_CRYPTO_NULL,
+    crypto_hw_ec_operation,
+};
+
+NX_CRYPTO_METHOD crypto_method_ec_secp384_hw = {
+    NX_CRYPTO_EC_SECP384R1,
+    384,
+    0,
+    0,
+    0,
+    0,
+    NX_CRYPTO_NULL,
+    NX_CRYPTO_NULL,
+    crypto_hw_ec_operation,
+};
+
+/* Block function for the software CBC and GCM modes, between aes_begin and aes_end */
+static UINT crypto_hw_aes_block(VOID* crypto_metadata, UCHAR* input, UCHAR* output, UINT length)
+{
+  NX_CRYPTO_PARAMETER_NOT_USED(crypto_metadata);
+  NX_CRYPTO_PARAMETER_NOT_USED(length);
+
+  crypto_hw_driver->aes_block(input, output);
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+/* Block function for the software CBC and GCM modes, the next block of the chunk */
+static UINT crypto_hw_aes_chunk_block(VOID* crypto_metadata, UCHAR* input, UCHAR* output, UINT length)
+{
+  CRYPTO_HW_AES_CHUNK* chunk = (CRYPTO_HW_AES_CHUNK*)crypto_metadata;
+
+  NX_CRYPTO_PARAMETER_NOT_USED(input);
+  NX_CRYPTO_PARAMETER_NOT_USED(length);
+
+  memcpy(output, chunk->next, NX_CRYPTO_AES_BLOCK_SIZE);
+  chunk->next += NX_CRYPTO_AES_BLOCK_SIZE;
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+/* ECB on whole blocks, one at a time */
+static VOID crypto_hw_aes_blocks(UCHAR* input, UCHAR* output, UINT length)
+{
+  UINT offset;
+
+  for (offset = 0; offset < length; offset += NX_CRYPTO_AES_BLOCK_SIZE)
+  {
+    crypto_hw_driver->aes_block(input + offset, output + offset);
+  }
+}
+
+/* ECB on whole blocks in one transfer, when the driver has one */
+static UINT crypto_hw_aes_chunk_run(UCHAR* input, UCHAR* output, UINT length)
+{
+  return (crypto_hw_driver->aes_chunk != NX_CRYPTO_NULL &&
+          crypto_hw_driver->aes_chunk(input, output, length) == NX_CRYPTO_SUCCESS);
+}
+
+/* The next counter blocks of GCM, counter moves on by the same 32 bit increment as the software mode */
+static VOID crypto_hw_aes_gcm_counters(UCHAR* stream, UCHAR* counter, ULONG blocks)
+{
+  ULONG index;
+  INT   byte;
+
+  for (index = 0; index < blocks; index++)
+  {
+    memcpy(&stream[index * NX_CRYPTO_AES_BLOCK_SIZE], counter, NX_CRYPTO_AES_BLOCK_SIZE);
+    for (byte = NX_CRYPTO_AES_BLOCK_SIZE - 1; byte >= NX_CRYPTO_AES_BLOCK_SIZE - 4 && ++counter[byte] == 0; byte--)
+    {
+    }
+  }
+}
+
+/* GCM: the counter blocks of a chunk are independent, they are encrypted together and the software
+   mode takes the key stream from the chunk, GHASH included. The counter of the context moves on in
+   the software mode, the copies here follow the same 32 bit increment. */
+static UINT crypto_hw_aes_gcm_chunked(NX_CRYPTO_AES* ctx, UINT decrypt, UCHAR* input, UCHAR* output, ULONG length)
+{
+  ULONG               stream_words[NX_AZURE_IOT_CRYPTO_HW_AES_CHUNK_BYTES / sizeof(ULONG)]; // aligned for DMA
+  UCHAR*              stream = (UCHAR*)stream_words;
+  UCHAR               counter[NX_CRYPTO_AES_BLOCK_SIZE];
+  UCHAR               first[NX_CRYPTO_AES_BLOCK_SIZE];
+  CRYPTO_HW_AES_CHUNK chunk;
+  ULONG               size;
+  ULONG               blocks;
+  UINT                status = NX_CRYPTO_SUCCESS;
+
+  memcpy(counter, ctx->nx_crypto_aes_mode_context.gcm.nx_crypto_gcm_counter, sizeof(counter));
+
+  while (length > 0 && status == NX_CRYPTO_SUCCESS)
+  {
+    size   = (length < sizeof(stream_words)) ? length : sizeof(stream_words);
+    blocks = (size + NX_CRYPTO_AES_BLOCK_SIZE - 1) / NX_CRYPTO_AES_BLOCK_SIZE;
+
+    memcpy(first, counter, sizeof(first));
+    crypto_hw_aes_gcm_counters(stream, counter, blocks);
+
+    // A failed transfer may have overwritten part of the counter blocks
+    if (!crypto_hw_aes_chunk_run(stream, stream, blocks * NX_CRYPTO_AES_BLOCK_SIZE))
+    {
+      crypto_hw_aes_gcm_counters(stream, first, blocks);
+      crypto_hw_aes_blocks(stream, stream, blocks * NX_CRYPTO_AES_BLOCK_SIZE);
+    }
+
+    chunk.next = stream;
+    status     = (decrypt ? _nx_crypto_gcm_decrypt_update : _nx_crypto_gcm_encrypt_update)(&chunk,
+        &ctx->nx_crypto_aes_mode_context.gcm,
+        crypto_hw_aes_chunk_block,
+        input,
+        output,
+        size,
+        NX_CRYPTO_AES_BLOCK_SIZE);
+
+    input += size;
+    output += size;
+    length -= size;
+  }
+
+  memset(stream_words, 0, sizeof(stream_words));
+
+  return status;
+}
+
+/* CBC decryption: each block is decrypted on its own, the chaining only needs the ciphertext */
+static UINT crypto_hw_aes_cbc_decrypt_chunked(NX_CRYPTO_AES* ctx, UCHAR* input, UCHAR* output, ULONG length)
+{
+  ULONG               plain_words[NX_AZURE_IOT_CRYPTO_HW_AES_CHUNK_BYTES / sizeof(ULONG)]; // aligned for DMA
+  UCHAR*              plain = (UCHAR*)plain_words;
+  CRYPTO_HW_AES_CHUNK chunk;
+  ULONG               size;
+  UINT                status = NX_CRYPTO_SUCCESS;
+
+  if (length % NX_CRYPTO_AES_BLOCK_SIZE)
+  {
+    return NX_CRYPTO_PTR_ERROR;
+  }
+
+  while (length > 0 && status == NX_CRYPTO_SUCCESS)
+  {
+    size = (length < sizeof(plain_words)) ? length : sizeof(plain_words);
+
+    if (!crypto_hw_aes_chunk_run(input, plain, size))
+    {
+      crypto_hw_aes_blocks(input, plain, size);
+    }
+
+    chunk.next = plain;
+    status     = _nx_crypto_cbc_decrypt(&chunk,
+        &ctx->nx_crypto_aes_mode_context.cbc,
+        crypto_hw_aes_chunk_block,
+        input,
+        output,
+        size,
+        NX_CRYPTO_AES_BLOCK_SIZE);
+
+    input += size;
+    output += size;
+    length -= size;
+  }
+
+  memset(plain_words, 0, sizeof(plain_words));
+
+  return status;
+}
+
+/* The record data goes through the peripheral, the chaining and GHASH stay in the software modes.
+   The GCM counter blocks and the CBC decryption go in chunks, CBC encryption chains each block on
+   the previous output and goes one block at a time. The GCM setup and tag are a couple of blocks and
+   stay in software entirely. The raw key is the start of the key schedule, the expansion leaves the
+   first words untouched. */
+static UINT crypto_hw_aes_operation(UINT op,
+    VOID* handle,
+    struct NX_CRYPTO_METHOD_STRUCT* method,
+    UCHAR* key,
+    NX_CRYPTO_KEY_SIZE key_size_in_bits,
+    UCHAR* input,
+    ULONG input_length_in_byte,
+    UCHAR* iv_ptr,
+    UCHAR* output,
+    ULONG output_length_in_byte,
+    VOID* crypto_metadata,
+    ULONG crypto_metadata_size,
+    VOID* packet_ptr,
+    VOID (*nx_crypto_hw_process_callback)(VOID* packet_ptr, UINT status))
+{
+  NX_CRYPTO_AES* ctx = (NX_CRYPTO_AES*)crypto_metadata;
+  UINT           cbc;
+  UINT           decrypt;
+  UINT           status;
+
+  if ((op != NX_CRYPTO_ENCRYPT_UPDATE && op != NX_CRYPTO_DECRYPT_UPDATE) || crypto_hw_driver == NX_CRYPTO_NULL ||
+      crypto_hw_driver->aes_begin == NX_CRYPTO_NULL || input_length_in_byte < NX_AZURE_IOT_CRYPTO_HW_AES_MIN_BYTES ||
+      ctx == NX_CRYPTO_NULL || ((ULONG)ctx & 0x3) != 0 || crypto_metadata_size < sizeof(NX_CRYPTO_AES))
+  {
+    return _nx_crypto_method_aes_operation(op,
+        handle,
+        method,
+        key,
+        key_size_in_bits,
+        input,
+        input_length_in_byte,
+        iv_ptr,
+        output,
+        output_length_in_byte,
+        crypto_metadata,
+        crypto_metadata_size,
+        packet_ptr,
+        nx_crypto_hw_process_callback);
+  }
+
+  // GCM runs the block cipher forward in both directions
+  cbc     = (method->nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_AES_CBC);
+  decrypt = cbc && (op == NX_CRYPTO_DECRYPT_UPDATE);
+
+  if (crypto_hw_driver->aes_begin((UCHAR*)ctx->nx_crypto_aes_key_schedule,
+          (UINT)ctx->nx_crypto_aes_key_size << 5,
+          decrypt) != NX_CRYPTO_SUCCESS)
+  {
+    return _nx_crypto_method_aes_operation(op,
+        handle,
+        method,
+        key,
+        key_size_in_bits,
+        input,
+        input_length_in_byte,
+        iv_ptr,
+        output,
+        output_length_in_byte,
+        crypto_metadata,
+        crypto_metadata_size,
+        packet_ptr,
+        nx_crypto_hw_process_callback);
+  }
+
+  if (cbc && decrypt)
+  {
+    status = crypto_hw_aes_cbc_decrypt_chunked(ctx, input, output, input_length_in_byte);
+  }
+  else if (cbc)
+  {
+    status = _nx_crypto_cbc_encrypt(ctx,
+        &ctx->nx_crypto_aes_mode_context.cbc,
+        crypto_hw_aes_block,
+        input,
+        output,
+        input_length_in_byte,
+        NX_CRYPTO_AES_BLOCK_SIZE);
+  }
+  else
+  {
+    status = crypto_hw_aes_gcm_chunked(ctx, (op == NX_CRYPTO_DECRYPT_UPDATE), input, output, input_length_in_byte);
+  }
+
+  crypto_hw_driver->aes_end();
+
+  return status;
+}
+
+/* Only the one shot digests are offloaded, certificate signatures and SAS tokens. The streamed
+   handshake and record digests keep their state in the metadata, which NX Secure copies to
+   fork the running handshake hash, so that state cannot live in the peripheral. */
+static UINT crypto_hw_sha256_operation(UINT op,
+    VOID* handle,
+    struct NX_CRYPTO_METHOD_STRUCT* method,
+    UCHAR* key,
+    NX_CRYPTO_KEY_SIZE key_size_in_bits,
+    UCHAR* input,
+    ULONG input_length_in_byte,
+    UCHAR* iv_ptr,
+    UCHAR* output,
+    ULONG output_length_in_byte,
+    VOID* crypto_metadata,
+    ULONG crypto_metadata_size,
+    VOID* packet_ptr,
+    VOID (*nx_crypto_hw_process_callback)(VOID* packet_ptr, UINT status))
+{
+  if ((op == NX_CRYPTO_AUTHENTICATE || op == NX_CRYPTO_VERIFY) && crypto_hw_driver != NX_CRYPTO_NULL &&
+      crypto_hw_driver->sha256 != NX_CRYPTO_NULL && output_length_in_byte >= 32 &&
+      crypto_hw_driver->sha256(input, input_length_in_byte, output) == NX_CRYPTO_SUCCESS)
+  {
+    return NX_CRYPTO_SUCCESS;
+  }
+
+  return _nx_crypto_method_sha256_operation(op,
+      handle,
+      method,
+      key,
+      key_size_in_bits,
+      input,
+      input_length_in_byte,
+      iv_ptr,
+      output,
+      output_length_in_byte,
+      crypto_metadata,
+      crypto_metadata_size,
+      packet_ptr,
+      nx_crypto_hw_process_callback);
+}
+
+static UINT crypto_hw_hmac_sha256_operation(UINT op,
+    VOID* handle,
+    struct NX_CRYPTO_METHOD_STRUCT* method,
+    UCHAR* key,
+    NX_CRYPTO_KEY_SIZE key_size_in_bits,
+    UCHAR* input,
+    ULONG input_length_in_byte,
+    UCHAR* iv_ptr,
+    UCHAR* output,
+    ULONG output_length_in_byte,
+    VOID* crypto_metadata,
+    ULONG crypto_metadata_size,
+    VOID* packet_ptr,
+    VOID (*nx_crypto_hw_process_callback)(VOID* packet_ptr, UINT status))
+{
+  UCHAR digest[32];
+
+  if ((op == NX_CRYPTO_AUTHENTICATE || op == NX_CRYPTO_VERIFY) && crypto_hw_driver != NX_CRYPTO_NULL &&
+      crypto_hw_driver->hmac_sha256 != NX_CRYPTO_NULL && key != NX_CRYPTO_NULL && output_length_in_byte > 0 &&
+      crypto_hw_driver->hmac_sha256(key, key_size_in_bits >> 3, input, input_length_in_byte, digest) ==
+          NX_CRYPTO_SUCCESS)
+  {
+    memcpy(output, digest, (output_length_in_byte < sizeof(digest)) ? output_length_in_byte : sizeof(digest));
+    return NX_CRYPTO_SUCCESS;
+  }
+
+  return _nx_crypto_method_hmac_sha256_operation(op,
+      handle,
+      method,
+      key,
+      key_size_in_bits,
+      input,
+      input_length_in_byte,
+      iv_ptr,
+      output,
+      output_length_in_byte,
+      crypto_metadata,
+      crypto_metadata_size,
+      packet_ptr,
+      nx_crypto_hw_process_callback);
+}
+
+/* r = g * d, affine like the software multiplication. The byte buffers are taken past the
+   caller's scratch pointer, where the software multiplication would put its own. */
+static VOID crypto_hw_ec_multiple(
+    NX_CRYPTO_EC* curve, NX_CRYPTO_EC_POINT* g, NX_CRYPTO_HUGE_NUMBER* d, NX_CRYPTO_EC_POINT* r, HN_UBASE* scratch)
+{
+  CRYPTO_HW_EC* hw   = (CRYPTO_HW_EC*)curve;
+  UINT          size = hw->params.size;
+  UCHAR*        k    = (UCHAR*)scratch;
+  UCHAR*        x    = k + size;
+  UCHAR*        y    = x + size;
+
+  if (crypto_hw_driver == NX_CRYPTO_NULL || crypto_hw_driver->ecc_multiply == NX_CRYPTO_NULL ||
+      _nx_crypto_huge_number_extract_fixed_size(d, k, size) != NX_CRYPTO_SUCCESS ||
+      _nx_crypto_huge_number_extract_fixed_size(&g->nx_crypto_ec_point_x, x, size) != NX_CRYPTO_SUCCESS ||
+      _nx_crypto_huge_number_extract_fixed_size(&g->nx_crypto_ec_point_y, y, size) != NX_CRYPTO_SUCCESS ||
+      crypto_hw_driver->ecc_multiply(&hw->params, k, x, y, x, y) != NX_CRYPTO_SUCCESS)
+  {
+    // Busy, or a zero scalar the peripheral reports as an error
+    _nx_crypto_ec_fp_projective_multiple(curve, g, d, r, scratch);
+    return;
+  }
+
+  _nx_crypto_huge_number_setup(&r->nx_crypto_ec_point_x, x, size);
+  _nx_crypto_huge_number_setup(&r->nx_crypto_ec_point_y, y, size);
+}
+
+/* x - y on big endian numbers, x >= y */
+static VOID crypto_hw_bytes_subtract(const UCHAR* x, const UCHAR* y, UCHAR* result, UINT size)
+{
+  INT borrow = 0;
+  INT digit;
+  INT i;
+
+  for (i = (INT)size - 1; i >= 0; i--)
+  {
+    digit     = (INT)x[i] - (INT)y[i] - borrow;
+    borrow    = (digit < 0);
+    result[i] = (UCHAR)(digit + (borrow << 8));
+  }
+}
+
+static VOID crypto_hw_ec_setup(CRYPTO_HW_EC* hw, NX_CRYPTO_METHOD* sw_method)
+{
+  NX_CRYPTO_EC*                 sw_curve;
+  NX_AZURE_IOT_CRYPTO_HW_CURVE* params = &hw->params;
+  UCHAR                         a[NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES];
+
+  if (sw_method->nx_crypto_operation(NX_CRYPTO_EC_CURVE_GET,
+          NX_CRYPTO_NULL,
+          sw_method,
+          NX_CRYPTO_NULL,
+          0,
+          NX_CRYPTO_NULL,
+          0,
+          NX_CRYPTO_NULL,
+          (UCHAR*)&sw_curve,
+          sizeof(sw_curve),
+          NX_CRYPTO_NULL,
+          0,
+          NX_CRYPTO_NULL,
+          NX_CRYPTO_NULL) != NX_CRYPTO_SUCCESS)
+  {
+    return;
+  }
+
+  hw->curve                       = *sw_curve;
+  hw->curve.nx_crypto_ec_multiple = crypto_hw_ec_multiple;
+
+  params->size = (sw_curve->nx_crypto_ec_bits + 7) >> 3;
+  if (params->size > NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES ||
+      _nx_crypto_huge_number_extract_fixed_size(&hw->curve.nx_crypto_ec_field.fp, params->p, params->size) ||
+      _nx_crypto_huge_number_extract_fixed_size(&hw->curve.nx_crypto_ec_b, params->b, params->size) ||
+      _nx_crypto_huge_number_extract_fixed_size(&hw->curve.nx_crypto_ec_n, params->n, params->size) ||
+      _nx_crypto_huge_number_extract_fixed_size(&hw->curve.nx_crypto_ec_a, a, params->size))
+  {
+    return;
+  }
+
+  // The curves store a mod p, the peripheral wants the smallest magnitude (-3 for the NIST curves)
+  crypto_hw_bytes_subtract(params->p, a, params->a_abs, params->size);
+  params->a_negative = (memcmp(params->a_abs, a, params->size) < 0);
+  if (!params->a_negative)
+  {
+    memcpy(params->a_abs, a, params->size);
+  }
+
+  hw->ready = NX_CRYPTO_TRUE;
+}
+
+/* Hand out the curve with the offloaded multiplication, ECDHE and ECDSA then use it */
+static UINT crypto_hw_ec_operation(UINT op,
+    VOID* handle,
+    struct NX_CRYPTO_METHOD_STRUCT* method,
+    UCHAR* key,
+    NX_CRYPTO_KEY_SIZE key_size_in_bits,
+    UCHAR* input,
+    ULONG input_length_in_byte,
+    UCHAR* iv_ptr,
+    UCHAR* output,
+    ULONG output_length_in_byte,
+    VOID* crypto_metadata,
+    ULONG crypto_metadata_size,
+    VOID* packet_ptr,
+    VOID (*nx_crypto_hw_process_callback)(VOID* packet_ptr, UINT status))
+{
+  CRYPTO_HW_EC* hw = (method->nx_crypto_algorithm == NX_CRYPTO_EC_SECP256R1) ? &crypto_hw_secp256r1
+                                                                            : &crypto_hw_secp384r1;
+
+  if (op != NX_CRYPTO_EC_CURVE_GET || !hw->ready)
+  {
+    return ((method->nx_crypto_algorithm == NX_CRYPTO_EC_SECP256R1) ? _nx_crypto_method_ec_secp256r1_operation
+                                                                    : _nx_crypto_method_ec_secp384r1_operation)(op,
+        handle,
+        method,
+        key,
+        key_size_in_bits,
+        input,
+        input_length_in_byte,
+        iv_ptr,
+        output,
+        output_length_in_byte,
+        crypto_metadata,
+        crypto_metadata_size,
+        packet_ptr,
+        nx_crypto_hw_process_callback);
+  }
+
+  *((NX_CRYPTO_EC**)output) = &hw->curve;
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+VOID nx_azure_iot_crypto_hw_driver_set(const NX_AZURE_IOT_CRYPTO_HW_DRIVER* driver)
+{
+  extern NX_CRYPTO_METHOD crypto_method_ec_secp256;
+  extern NX_CRYPTO_METHOD crypto_method_ec_secp384;
+
+  if (driver != NX_CRYPTO_NULL && driver->ecc_multiply != NX_CRYPTO_NULL)
+  {
+    if (!crypto_hw_secp256r1.ready)
+    {
+      crypto_hw_ec_setup(&crypto_hw_secp256r1, &crypto_method_ec_secp256);
+    }
+
+    if (!crypto_hw_secp384r1.ready)
+    {
+      crypto_hw_ec_setup(&crypto_hw_secp384r1, &crypto_method_ec_secp384);
+    }
+  }
+
+  crypto_hw_driver = driver;
+}
+/* USER CODE END 1 */
@@ -0,0 +1,117 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    nx_azure_iot_crypto_hw.h
+ * @author  Microsoft
+ * @brief   Crypto methods offloaded to a hardware driver header file
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2022 Microsoft.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __NX_AZURE_IOT_CRYPTO_HW_H__
+#define __NX_AZURE_IOT_CRYPTO_HW_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include "nx_crypto.h"
+/* USER CODE END Includes */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+
+/* Largest curve handed to the driver, P-384 */
+#define NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES 48
+
+/* Shorter AES updates stay in software, taking the peripheral and loading the key costs more */
+#define NX_AZURE_IOT_CRYPTO_HW_AES_MIN_BYTES 64
+
+/* Largest transfer handed to aes_chunk, a multiple of the block size, on the caller's stack */
+#define NX_AZURE_IOT_CRYPTO_HW_AES_CHUNK_BYTES 256
+/* USER CODE END EC */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+
+/* Short Weierstrass curve y^2 = x^3 + ax + b mod p, big endian values of size bytes */
+typedef struct NX_AZURE_IOT_CRYPTO_HW_CURVE_STRUCT
+{
+  UINT  size;
+  UINT  a_negative; // a is -a_abs
+  UCHAR a_abs[NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES];
+  UCHAR b[NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES];
+  UCHAR p[NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES];
+  UCHAR n[NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES];
+} NX_AZURE_IOT_CRYPTO_HW_CURVE;
+
+/* Peripheral driver behind the methods below. Any entry may be NULL. An entry returns
+   NX_CRYPTO_NOT_SUCCESSFUL when its peripheral is busy or fails, the method then runs in software. */
+typedef struct NX_AZURE_IOT_CRYPTO_HW_DRIVER_STRUCT
+{
+  // Take the AES peripheral and load a 128 or 256 bit key, for single block ECB encryption (or decryption)
+  UINT (*aes_begin)(const UCHAR* key, UINT key_size_in_bits, UINT decrypt);
+  VOID (*aes_block)(const UCHAR* input, UCHAR* output);
+  // Optional, the same on length bytes of whole blocks in one transfer (DMA on the board), up to
+  // NX_AZURE_IOT_CRYPTO_HW_AES_CHUNK_BYTES. The output may be the input. On failure the output may hold part of
+  // the transfer, the blocks then go through aes_block.
+  UINT (*aes_chunk)(const UCHAR* input, UCHAR* output, UINT length);
+  VOID (*aes_end)(VOID);
+
+  UINT (*sha256)(const UCHAR* input, UINT length, UCHAR* digest);
+  UINT (*hmac_sha256)(const UCHAR* key, UINT key_length, const UCHAR* input, UINT length, UCHAR* digest);
+
+  // (rx, ry) = k * (px, py), all of curve->size bytes. Outputs may alias the inputs.
+  UINT (*ecc_multiply)(
+      const NX_AZURE_IOT_CRYPTO_HW_CURVE* curve, const UCHAR* k, const UCHAR* px, const UCHAR* py, UCHAR* rx, UCHAR* ry);
+} NX_AZURE_IOT_CRYPTO_HW_DRIVER;
+/* USER CODE END ET */
+
+/* Exported macro ------------------------------------------------------------*/
+/* USER CODE BEGIN EM */
+
+/* USER CODE END EM */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/* Route the methods below to driver, NULL goes back to software. Call before the first TLS session. */
+VOID nx_azure_iot_crypto_hw_driver_set(const NX_AZURE_IOT_CRYPTO_HW_DRIVER* driver);
+
+/* Drop-in replacements for the software methods of the same algorithm, see nx_azure_iot_ciphersuites.c.
+   AES-CBC and AES-GCM offload the record data, in chunks where the blocks are independent, SHA-256 and HMAC-SHA256 the one shot digests, the curves
+   the scalar multiplication of ECDHE and ECDSA. */
+extern NX_CRYPTO_METHOD crypto_method_aes_cbc_128_hw;
+extern NX_CRYPTO_METHOD crypto_method_aes_128_gcm_16_hw;
+extern NX_CRYPTO_METHOD crypto_method_sha256_hw;
+extern NX_CRYPTO_METHOD crypto_method_hmac_sha256_hw;
+extern NX_CRYPTO_METHOD crypto_method_ec_secp256_hw;
+extern NX_CRYPTO_METHOD crypto_method_ec_secp384_hw;
+/* USER CODE END EFP */
+
+/* Private defines -----------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+/* USER CODE END PD */
+
+/* USER CODE BEGIN 1 */
+
+/* USER CODE END 1 */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NX_AZURE_IOT_CRYPTO_HW_H__ */
@@ -0,0 +1,219 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    nx_azure_iot_trace.c
+  * @author  Microsoft
+  * @brief   Azure IoT connection phase trace file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 Microsoft.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "nx_azure_iot_trace.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include <stdio.h>
+#include <string.h>
+
+#include "main.h"
+#include "nx_secure_x509.h"
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+/* USER CODE END PTD */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+#define TICKS_TO_MS(ticks) ((ticks) * 1000 / TX_TIMER_TICKS_PER_SECOND)
+
+/* Longest phase the cycle counter measures before it wraps, with a tick of margin */
+#define CYCLES_MAX_TICKS (0xFFFFFFFFUL / (SystemCoreClock / TX_TIMER_TICKS_PER_SECOND) - 1)
+/* USER CODE END PD */
+
+/* Private macro -------------------------------------------------------------*/
+/* USER CODE BEGIN PM */
+
+/* USER CODE END PM */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+static AZURE_IOT_PHASE_TRACE phase_trace;
+
+/* Names used for printing and as telemetry property names, in NX_PHASE_* order */
+static const CHAR* phase_names[NX_PHASE_COUNT] = {
+    "linkUp",
+    "dhcpBound",
+    "sntpSync",
+    "dnsResolve",
+    "tcpConnect",
+    "tlsHandshake",
+    "tlsCertVerify",
+    "mqttConnack",
+    "twinGet",
+    "mqttPuback",
+};
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+
+/* USER CODE END PFP */
+
+/* USER CODE BEGIN 1 */
+
+/* Last duration in ms, from the cycle counter when the phase is too short for the tick to resolve it, e.g. the
+   certificate check that runs without waiting */
+static ULONG phase_last_ms(const AZURE_IOT_PHASE* phase_ptr)
+{
+  if (phase_ptr->last_ticks < CYCLES_MAX_TICKS)
+  {
+    return (ULONG)((ULONG64)phase_ptr->last_cycles * 1000 / SystemCoreClock);
+  }
+
+  return TICKS_TO_MS(phase_ptr->last_ticks);
+}
+
+/* Called from the IP, MQTT and application threads, so the update is done with interrupts off */
+VOID nx_azure_iot_trace_phase(UINT phase, UINT end)
+{
+  AZURE_IOT_PHASE* phase_ptr;
+  ULONG            now    = tx_time_get();
+  ULONG            cycles = DWT->CYCCNT;
+  TX_INTERRUPT_SAVE_AREA
+
+  if (phase >= NX_PHASE_COUNT)
+  {
+    return;
+  }
+
+  phase_ptr = &phase_trace.phase[phase];
+
+  TX_DISABLE
+
+  if (!end)
+  {
+    phase_ptr->begin_tick   = now;
+    phase_ptr->begin_cycles = cycles;
+    phase_ptr->active       = NX_TRUE;
+  }
+
+  // Ignore an end without a begin, e.g. a phase completing after the trace was reset
+  else if (phase_ptr->active)
+  {
+    phase_ptr->last_ticks  = now - phase_ptr->begin_tick;
+    phase_ptr->last_cycles = cycles - phase_ptr->begin_cycles;
+    phase_ptr->total_ticks += phase_ptr->last_ticks;
+    phase_ptr->count++;
+    phase_ptr->active = NX_FALSE;
+
+    if (phase == NX_PHASE_MQTT_PUBACK && phase_trace.first_puback_tick == 0)
+    {
+      phase_trace.first_puback_tick = now;
+    }
+  }
+
+  TX_RESTORE
+}
+
+VOID nx_azure_iot_trace_reset(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  // Cycle counter for the phases shorter than a tick, the Cortex-M7 DWT is write protected until unlocked
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR = 0xC5ACCE55;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  TX_DISABLE
+  memset(&phase_trace, 0, sizeof(phase_trace));
+  phase_trace.reset_tick = tx_time_get();
+  TX_RESTORE
+}
+
+const AZURE_IOT_PHASE_TRACE* nx_azure_iot_trace_get(VOID)
+{
+  return &phase_trace;
+}
+
+VOID nx_azure_iot_trace_print(VOID)
+{
+  UINT                   index;
+  const AZURE_IOT_PHASE* phase_ptr;
+
+  printf("\r\nConnection phases\r\n");
+
+  for (index = 0; index < NX_PHASE_COUNT; index++)
+  {
+    phase_ptr = &phase_trace.phase[index];
+    if (phase_ptr->count == 0)
+    {
+      continue;
+    }
+
+    printf("\t%-14s at %6lu ms: last %5lu ms, total %5lu ms (%lu)\r\n",
+        phase_names[index],
+        TICKS_TO_MS(phase_ptr->begin_tick - phase_trace.reset_tick),
+        phase_last_ms(phase_ptr),
+        TICKS_TO_MS(phase_ptr->total_ticks),
+        phase_ptr->count);
+  }
+
+  if (phase_trace.first_puback_tick != 0)
+  {
+    printf("\tTime to first telemetry: %lu ms\r\n", TICKS_TO_MS(phase_trace.first_puback_tick - phase_trace.reset_tick));
+  }
+
+#ifdef NX_SECURE_X509_VERIFY_CACHE_SIZE
+  printf("\tCertificate signature checks: %lu skipped, %lu done\r\n",
+      _nx_secure_x509_verify_cache_hits,
+      _nx_secure_x509_verify_cache_misses);
+#endif
+}
+
+UINT nx_azure_iot_trace_append_properties(NX_AZURE_IOT_JSON_WRITER* json_writer_ptr)
+{
+  UINT                   status;
+  UINT                   index;
+  const AZURE_IOT_PHASE* phase_ptr;
+
+  for (index = 0; index < NX_PHASE_COUNT; index++)
+  {
+    phase_ptr = &phase_trace.phase[index];
+    if (phase_ptr->count == 0)
+    {
+      continue;
+    }
+
+    if ((status = nx_azure_iot_json_writer_append_property_with_int32_value(json_writer_ptr,
+             (const UCHAR*)phase_names[index],
+             strlen(phase_names[index]),
+             (int32_t)phase_last_ms(phase_ptr))))
+    {
+      return status;
+    }
+  }
+
+  if (phase_trace.first_puback_tick != 0)
+  {
+    return nx_azure_iot_json_writer_append_property_with_int32_value(json_writer_ptr,
+        (const UCHAR*)"firstTelemetry",
+        sizeof("firstTelemetry") - 1,
+        (int32_t)TICKS_TO_MS(phase_trace.first_puback_tick - phase_trace.reset_tick));
+  }
+
+  return NX_SUCCESS;
+}
+/* USER CODE END 1 */
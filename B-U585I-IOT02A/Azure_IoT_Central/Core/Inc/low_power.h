@@ -0,0 +1,91 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    low_power.h
+  * @author  MCD Application Team
+  * @brief   ThreadX tickless idle header file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOW_POWER_H
+#define __LOW_POWER_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+/* Idle periods over the window closed by low_power_stats_get */
+typedef struct LOW_POWER_STATS_STRUCT
+{
+  ULONG window_ticks;
+  ULONG sleeps;           // idle periods with the tick stopped
+  ULONG stops;            // of which in Stop 2
+  ULONG sleep_ticks;      // ticks spent with the tick stopped, Stop 2 included
+  ULONG stop_ticks;
+  ULONG early_wakes;      // woken by an interrupt before the next timer expiry
+  ULONG wake_late_max_us; // timer expiry to the tick running again, clock restore included
+  ULONG wake_late_avg_us;
+} LOW_POWER_STATS;
+/* USER CODE END ET */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+/* Shorter idle periods keep the periodic tick */
+#define LOW_POWER_MIN_TICKS      2
+/* Shorter idle periods only sleep, restoring the clocks after Stop 2 costs more than it saves */
+#define LOW_POWER_STOP_MIN_TICKS 5
+/* USER CODE END EC */
+
+/* Exported macro ------------------------------------------------------------*/
+/* USER CODE BEGIN EM */
+
+/* USER CODE END EM */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+/* Start LPTIM1 on the LSE (LSI if the LSE does not start) and enable the tickless idle.
+   Returns TX_FEATURE_NOT_ENABLED without TX_LOW_POWER. */
+UINT low_power_init(VOID);
+
+/* Allow or forbid Stop 2, for a driver with a transfer the idle check cannot see. Calls nest. */
+VOID low_power_stop_lock(VOID);
+VOID low_power_stop_unlock(VOID);
+
+/* Close the current window and start the next one */
+UINT low_power_stats_get(LOW_POWER_STATS* stats);
+
+VOID low_power_isr(VOID);
+/* USER CODE END EFP */
+
+/* Private defines -----------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+/* USER CODE END PD */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOW_POWER_H */
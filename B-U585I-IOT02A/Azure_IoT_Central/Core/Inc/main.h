@@ -73,6 +73,9 @@ void Success_Handler(void);
 #define MXCHIP_RESET_Pin GPIO_PIN_15
 #define MXCHIP_RESET_GPIO_Port GPIOF
 /* USER CODE BEGIN Private defines */
+#define ISM330DHCX_INT1_Pin GPIO_PIN_11
+#define ISM330DHCX_INT1_GPIO_Port GPIOE
+#define ISM330DHCX_INT1_EXTI_IRQn EXTI11_IRQn
 
 /* USER CODE END Private defines */
 
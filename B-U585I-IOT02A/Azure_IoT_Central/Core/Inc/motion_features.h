@@ -0,0 +1,91 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    motion_features.h
+  * @author  MCD Application Team
+  * @brief   Vibration feature extraction header file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MOTION_FEATURES_H
+#define __MOTION_FEATURES_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+#define MOTION_FEATURES_AXES  3
+#define MOTION_FEATURES_BANDS 4
+
+/* Features of one accelerometer axis over a window, gravity and offsets removed, in mg */
+typedef struct MOTION_AXIS_FEATURES_STRUCT
+{
+  float rms;
+  float peak_to_peak;
+  float crest_factor; // peak / rms
+  float band_rms[MOTION_FEATURES_BANDS];
+} MOTION_AXIS_FEATURES;
+
+/* Features of all the blocks processed since the previous motion_features_get */
+typedef struct MOTION_FEATURES_STRUCT
+{
+  ULONG                samples;
+  ULONG                blocks;
+  ULONG                dropped_blocks;
+  ULONG                max_block_cycles; // worst case processing time of a block
+  ULONG                avg_block_cycles;
+  MOTION_AXIS_FEATURES axis[MOTION_FEATURES_AXES];
+} MOTION_FEATURES;
+/* USER CODE END ET */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+
+/* USER CODE END EC */
+
+/* Exported macro ------------------------------------------------------------*/
+/* USER CODE BEGIN EM */
+
+/* USER CODE END EM */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+/* Start consuming the motion FIFO blocks, motion_fifo_init must have succeeded */
+UINT motion_features_init(VOID);
+
+/* Close the current window, returns TX_NOT_DONE if no block was processed since the last call */
+UINT motion_features_get(MOTION_FEATURES* features);
+/* USER CODE END EFP */
+
+/* Private defines -----------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+/* USER CODE END PD */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOTION_FEATURES_H */
@@ -0,0 +1,107 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    motion_fifo.h
+  * @author  MCD Application Team
+  * @brief   ISM330DHCX FIFO acquisition header file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MOTION_FIFO_H
+#define __MOTION_FIFO_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include <stdint.h>
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+#define MOTION_FIFO_BLOCK_SAMPLES 128
+
+/* Raw accelerometer sample, scale by acc_sensitivity for mg */
+typedef struct MOTION_SAMPLE_STRUCT
+{
+  int16_t x;
+  int16_t y;
+  int16_t z;
+} MOTION_SAMPLE;
+
+/* A full block of consecutive samples handed to the consumer */
+typedef struct MOTION_BLOCK_STRUCT
+{
+  ULONG         sequence; // gaps in the sequence are blocks dropped while the ring was full
+  ULONG         end_tick;
+  MOTION_SAMPLE sample[MOTION_FIFO_BLOCK_SAMPLES];
+} MOTION_BLOCK;
+
+typedef struct MOTION_FIFO_STATS_STRUCT
+{
+  ULONG samples;
+  ULONG blocks;
+  ULONG dropped_blocks;
+  ULONG drains;
+  ULONG max_drain;   // largest number of FIFO words read in one drain
+  ULONG drain_ticks; // time spent draining, to estimate the cost per sample
+  float acc_sensitivity;
+} MOTION_FIFO_STATS;
+/* USER CODE END ET */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+#define MOTION_FIFO_ODR           208.0f
+#define MOTION_FIFO_WATERMARK     64
+/* Blocks in the ring, a power of 2. 16 blocks of 128 samples hold ~10 s at 208 Hz */
+#define MOTION_FIFO_BLOCKS        16
+/* USER CODE END EC */
+
+/* Exported macro ------------------------------------------------------------*/
+/* USER CODE BEGIN EM */
+
+/* USER CODE END EM */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+UINT motion_fifo_init(VOID);
+VOID motion_fifo_isr(VOID);
+
+/* Consumer side of the block ring, only one thread may consume */
+const MOTION_BLOCK* motion_fifo_block_get(VOID);
+VOID                motion_fifo_block_release(VOID);
+
+const MOTION_FIFO_STATS* motion_fifo_stats_get(VOID);
+
+/* I2C2 is shared with the environment sensors and the EEPROM, and the BSP bus only locks with an OS layer */
+VOID motion_fifo_bus_lock(VOID);
+VOID motion_fifo_bus_unlock(VOID);
+/* USER CODE END EFP */
+
+/* Private defines -----------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+/* USER CODE END PD */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOTION_FIFO_H */
@@ -37,6 +37,11 @@ int32_t mxwifi_probe(void **ll_drv_context);
 #define MX_WIFI_USE_SPI                                                     (1)
 #endif /* MX_WIFI_USE_SPI */
 
+/* replace the module by a loopback fake answering the IPC requests, keeps the SPI or UART framing */
+#ifndef MX_WIFI_USE_LOOPBACK
+#define MX_WIFI_USE_LOOPBACK                                                (0)
+#endif /* MX_WIFI_USE_LOOPBACK */
+
 /* do not use RTOS but bare metal approach by default */
 #ifndef MX_WIFI_USE_CMSIS_OS
 #define MX_WIFI_USE_CMSIS_OS                                                (0) 
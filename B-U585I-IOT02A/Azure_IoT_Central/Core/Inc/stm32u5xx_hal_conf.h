@@ -45,7 +45,7 @@
 /*#define HAL_FDCAN_MODULE_ENABLED */
 /*#define HAL_FMAC_MODULE_ENABLED */
 /*#define HAL_GTZC_MODULE_ENABLED */
-/*#define HAL_HASH_MODULE_ENABLED */
+#define HAL_HASH_MODULE_ENABLED
 /*#define HAL_HRTIM_MODULE_ENABLED */
 /*#define HAL_IRDA_MODULE_ENABLED */
 /*#define HAL_IWDG_MODULE_ENABLED */
@@ -58,7 +58,7 @@
 /*#define HAL_OSPI_MODULE_ENABLED */
 /*#define HAL_OTFDEC_MODULE_ENABLED */
 /*#define HAL_PCD_MODULE_ENABLED */
-/*#define HAL_PKA_MODULE_ENABLED */
+#define HAL_PKA_MODULE_ENABLED
 /*#define HAL_QSPI_MODULE_ENABLED */
 #define HAL_RNG_MODULE_ENABLED
 /*#define HAL_RTC_MODULE_ENABLED */
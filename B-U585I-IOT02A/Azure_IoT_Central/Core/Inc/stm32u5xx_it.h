@@ -57,6 +57,8 @@ void EXTI15_IRQHandler(void);
 void TIM6_IRQHandler(void);
 void USART1_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void EXTI11_IRQHandler(void);
+void LPTIM1_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -0,0 +1,95 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    thread_profile.h
+  * @author  MCD Application Team
+  * @brief   ThreadX per thread profiler header file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __THREAD_PROFILE_H
+#define __THREAD_PROFILE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+#define THREAD_PROFILE_MAX_THREADS 16
+
+/* One thread over the window closed by thread_profile_get */
+typedef struct THREAD_PROFILE_ENTRY_STRUCT
+{
+  CHAR* name;
+  UINT  priority;
+  ULONG cpu_permille;
+  ULONG stack_size;
+  ULONG stack_used; // high-water mark since the thread was created
+  ULONG wakes;      // resumes by tx_event_flags_set
+  ULONG wake_avg_us; // from the set to the thread running
+  ULONG wake_max_us;
+} THREAD_PROFILE_ENTRY;
+
+typedef struct THREAD_PROFILE_STRUCT
+{
+  ULONG                window_ms;
+  ULONG                idle_permille; // time with no thread running, interrupts are charged to the thread they preempt
+  UINT                 count;
+  THREAD_PROFILE_ENTRY thread[THREAD_PROFILE_MAX_THREADS];
+} THREAD_PROFILE;
+/* USER CODE END ET */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+
+/* USER CODE END EC */
+
+/* Exported macro ------------------------------------------------------------*/
+/* USER CODE BEGIN EM */
+/* Free running 32 bit cycle counter, may be redefined to a simulated counter */
+#ifndef THREAD_PROFILE_CYCLES
+#define THREAD_PROFILE_CYCLES() (DWT->CYCCNT)
+#endif
+/* USER CODE END EM */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+/* Start the cycle counter and the first window, returns TX_FEATURE_NOT_ENABLED without TX_EXECUTION_PROFILE_ENABLE */
+UINT thread_profile_init(VOID);
+
+/* Close the current window and start the next one. Event flags groups created since the
+   previous call are picked up for the wake latency from now on. */
+UINT thread_profile_get(THREAD_PROFILE* profile);
+/* USER CODE END EFP */
+
+/* Private defines -----------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+/* USER CODE END PD */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __THREAD_PROFILE_H */
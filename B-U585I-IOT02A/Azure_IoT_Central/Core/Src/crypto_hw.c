@@ -0,0 +1,344 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    crypto_hw.c
+  * @author  MCD Application Team
+  * @brief   AES, HASH and PKA driver for the TLS crypto methods
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "crypto_hw.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include <string.h>
+
+#include "main.h"
+#include "nx_api.h"
+#include "nx_azure_iot_crypto_hw.h"
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+/* USER CODE END PTD */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+/* Linear GPDMA1 channels feeding and draining the AES peripheral */
+#define AES_DMA_IN  GPDMA1_Channel10
+#define AES_DMA_OUT GPDMA1_Channel11
+
+#define AES_DMA_FLAGS \
+  (DMA_CFCR_TCF | DMA_CFCR_HTF | DMA_CFCR_DTEF | DMA_CFCR_ULEF | DMA_CFCR_USEF | DMA_CFCR_SUSPF | DMA_CFCR_TOF)
+#define AES_DMA_ERRORS (DMA_CSR_DTEF | DMA_CSR_ULEF | DMA_CSR_USEF)
+/* USER CODE END PD */
+
+/* Private macro -------------------------------------------------------------*/
+/* USER CODE BEGIN PM */
+
+/* USER CODE END PM */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+#ifdef NX_AZURE_IOT_CRYPTO_HW
+static HASH_HandleTypeDef hhash;
+static PKA_HandleTypeDef  hpka;
+
+/* One owner per peripheral, taken without waiting, a busy peripheral sends the caller to software */
+static TX_MUTEX aes_mutex;
+static TX_MUTEX hash_mutex;
+static TX_MUTEX pka_mutex;
+#endif
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+
+/* USER CODE END PFP */
+
+/* USER CODE BEGIN 1 */
+#ifdef NX_AZURE_IOT_CRYPTO_HW
+
+static ULONG crypto_hw_word(const UCHAR* bytes)
+{
+  ULONG word;
+
+  memcpy(&word, bytes, sizeof(word));
+
+  return word;
+}
+
+static VOID aes_wait(VOID)
+{
+  while ((AES->ISR & AES_ISR_CCF) == 0)
+  {
+  }
+
+  AES->ICR = AES_ICR_CCF;
+}
+
+/* ECB with byte swapped data, so the block words go in and out in memory order. The key
+   registers hold the key big endian, KEYR0 the last word, and are written from KEYR0 up. */
+static UINT aes_begin(const UCHAR* key, UINT key_size_in_bits, UINT decrypt)
+{
+  UINT words = key_size_in_bits >> 5;
+
+  if ((key_size_in_bits != 128 && key_size_in_bits != 256) || tx_mutex_get(&aes_mutex, TX_NO_WAIT) != TX_SUCCESS)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  AES->CR &= ~AES_CR_EN;
+  AES->CR = AES_CR_DATATYPE_1 | ((key_size_in_bits == 256) ? AES_CR_KEYSIZE : 0);
+
+  AES->KEYR0 = __REV(crypto_hw_word(key + (words - 1) * 4));
+  AES->KEYR1 = __REV(crypto_hw_word(key + (words - 2) * 4));
+  AES->KEYR2 = __REV(crypto_hw_word(key + (words - 3) * 4));
+  AES->KEYR3 = __REV(crypto_hw_word(key + (words - 4) * 4));
+  if (words == 8)
+  {
+    AES->KEYR4 = __REV(crypto_hw_word(key + 12));
+    AES->KEYR5 = __REV(crypto_hw_word(key + 8));
+    AES->KEYR6 = __REV(crypto_hw_word(key + 4));
+    AES->KEYR7 = __REV(crypto_hw_word(key));
+  }
+
+  if ((AES->SR & AES_SR_KEYVALID) == 0)
+  {
+    tx_mutex_put(&aes_mutex);
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  if (decrypt)
+  {
+    // Derive the decryption key schedule from the loaded key
+    AES->CR |= AES_CR_MODE_0 | AES_CR_EN;
+    aes_wait();
+    AES->CR = (AES->CR & ~AES_CR_MODE) | AES_CR_MODE_1;
+  }
+
+  AES->CR |= AES_CR_EN;
+
+  return NX_SUCCESS;
+}
+
+static VOID aes_block(const UCHAR* input, UCHAR* output)
+{
+  ULONG word;
+
+  AES->DINR = crypto_hw_word(input);
+  AES->DINR = crypto_hw_word(input + 4);
+  AES->DINR = crypto_hw_word(input + 8);
+  AES->DINR = crypto_hw_word(input + 12);
+  aes_wait();
+
+  word = AES->DOUTR;
+  memcpy(output, &word, 4);
+  word = AES->DOUTR;
+  memcpy(output + 4, &word, 4);
+  word = AES->DOUTR;
+  memcpy(output + 8, &word, 4);
+  word = AES->DOUTR;
+  memcpy(output + 12, &word, 4);
+}
+
+/* A chunk of blocks by DMA, one channel writes DINR and the other drains DOUTR as each block completes.
+   The output channel lags the input one by a block, so the output may be the input. */
+static UINT aes_chunk(const UCHAR* input, UCHAR* output, UINT length)
+{
+  ULONG status;
+
+  // Word transfers, the Helper hands aligned buffers and unaligned ones go block by block
+  if ((((ULONG)input | (ULONG)output | length) & 0x3) != 0)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  AES_DMA_OUT->CFCR = AES_DMA_FLAGS;
+  AES_DMA_OUT->CTR1 = DMA_CTR1_SDW_LOG2_1 | DMA_CTR1_DDW_LOG2_1 | DMA_CTR1_DINC;
+  AES_DMA_OUT->CTR2 = GPDMA1_REQUEST_AES_OUT;
+  AES_DMA_OUT->CBR1 = length;
+  AES_DMA_OUT->CSAR = (ULONG)&AES->DOUTR;
+  AES_DMA_OUT->CDAR = (ULONG)output;
+  AES_DMA_OUT->CCR  = DMA_CCR_EN;
+
+  AES_DMA_IN->CFCR = AES_DMA_FLAGS;
+  AES_DMA_IN->CTR1 = DMA_CTR1_SDW_LOG2_1 | DMA_CTR1_SINC | DMA_CTR1_DDW_LOG2_1;
+  AES_DMA_IN->CTR2 = GPDMA1_REQUEST_AES_IN | DMA_CTR2_DREQ;
+  AES_DMA_IN->CBR1 = length;
+  AES_DMA_IN->CSAR = (ULONG)input;
+  AES_DMA_IN->CDAR = (ULONG)&AES->DINR;
+  AES_DMA_IN->CCR  = DMA_CCR_EN;
+
+  AES->CR |= AES_CR_DMAINEN | AES_CR_DMAOUTEN;
+
+  // A chunk is a few microseconds, shorter than a thread switch
+  do
+  {
+    status = AES_DMA_OUT->CSR | (AES_DMA_IN->CSR & AES_DMA_ERRORS);
+  } while ((status & (DMA_CSR_TCF | AES_DMA_ERRORS)) == 0);
+
+  AES->CR &= ~(AES_CR_DMAINEN | AES_CR_DMAOUTEN);
+
+  AES_DMA_IN->CCR   = 0;
+  AES_DMA_OUT->CCR  = 0;
+  AES_DMA_IN->CFCR  = AES_DMA_FLAGS;
+  AES_DMA_OUT->CFCR = AES_DMA_FLAGS;
+
+  if ((status & AES_DMA_ERRORS) != 0)
+  {
+    // Leave the peripheral at a block boundary for the block by block retry
+    AES->CR &= ~AES_CR_EN;
+    AES->CR |= AES_CR_EN;
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_SUCCESS;
+}
+
+static VOID aes_end(VOID)
+{
+  AES->CR &= ~AES_CR_EN;
+
+  tx_mutex_put(&aes_mutex);
+}
+
+static UINT sha256(const UCHAR* input, UINT length, UCHAR* digest)
+{
+  HAL_StatusTypeDef status;
+
+  if (tx_mutex_get(&hash_mutex, TX_NO_WAIT) != TX_SUCCESS)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  status = HAL_HASHEx_SHA256_Start(&hhash, (uint8_t*)input, length, digest, CRYPTO_HW_TIMEOUT_MS);
+
+  tx_mutex_put(&hash_mutex);
+
+  return (status == HAL_OK) ? NX_SUCCESS : NX_NOT_SUCCESSFUL;
+}
+
+static UINT hmac_sha256(const UCHAR* key, UINT key_length, const UCHAR* input, UINT length, UCHAR* digest)
+{
+  HAL_StatusTypeDef status;
+
+  // The HAL rejects an empty key or message
+  if (key_length == 0 || length == 0 || tx_mutex_get(&hash_mutex, TX_NO_WAIT) != TX_SUCCESS)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  hhash.Init.pKey    = (uint8_t*)key;
+  hhash.Init.KeySize = key_length;
+  status             = HAL_HMACEx_SHA256_Start(&hhash, (uint8_t*)input, length, digest, CRYPTO_HW_TIMEOUT_MS);
+  hhash.Init.pKey    = NULL;
+  hhash.Init.KeySize = 0;
+
+  tx_mutex_put(&hash_mutex);
+
+  return (status == HAL_OK) ? NX_SUCCESS : NX_NOT_SUCCESSFUL;
+}
+
+static UINT ecc_multiply(
+    const NX_AZURE_IOT_CRYPTO_HW_CURVE* curve, const UCHAR* k, const UCHAR* px, const UCHAR* py, UCHAR* rx, UCHAR* ry)
+{
+  PKA_ECCMulInTypeDef  in;
+  PKA_ECCMulOutTypeDef out;
+  HAL_StatusTypeDef    status;
+
+  if (tx_mutex_get(&pka_mutex, TX_NO_WAIT) != TX_SUCCESS)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  in.scalarMulSize = curve->size;
+  in.modulusSize   = curve->size;
+  in.coefSign      = curve->a_negative;
+  in.coefA         = curve->a_abs;
+  in.coefB         = curve->b;
+  in.modulus       = curve->p;
+  in.pointX        = px;
+  in.pointY        = py;
+  in.scalarMul     = k;
+  in.primeOrder    = curve->n;
+
+  // The result is read from the PKA RAM once the operation is done, so it may overwrite the point
+  status = HAL_PKA_ECCMul(&hpka, &in, CRYPTO_HW_TIMEOUT_MS);
+  if (status == HAL_OK)
+  {
+    out.ptX = rx;
+    out.ptY = ry;
+    HAL_PKA_ECCMul_GetResult(&hpka, &out);
+  }
+
+  // Leave no scalar behind, it is a private key for ECDHE and ECDSA signing
+  HAL_PKA_RAMReset(&hpka);
+
+  tx_mutex_put(&pka_mutex);
+
+  return (status == HAL_OK) ? NX_SUCCESS : NX_NOT_SUCCESSFUL;
+}
+
+static const NX_AZURE_IOT_CRYPTO_HW_DRIVER crypto_hw_driver = {
+    .aes_begin    = aes_begin,
+    .aes_block    = aes_block,
+    .aes_chunk    = aes_chunk,
+    .aes_end      = aes_end,
+    .sha256       = sha256,
+    .hmac_sha256  = hmac_sha256,
+    .ecc_multiply = ecc_multiply,
+};
+
+UINT crypto_hw_init(VOID)
+{
+  __HAL_RCC_AES_CLK_ENABLE();
+  __HAL_RCC_GPDMA1_CLK_ENABLE();
+
+  hhash.Init.DataType = HASH_DATATYPE_8B;
+  if (HAL_HASH_Init(&hhash) != HAL_OK)
+  {
+    return TX_NOT_DONE;
+  }
+
+  // The PKA needs the RNG clock, already running for NX Secure
+  hpka.Instance = PKA;
+  if (HAL_PKA_Init(&hpka) != HAL_OK)
+  {
+    return TX_NOT_DONE;
+  }
+
+  if (tx_mutex_create(&aes_mutex, "AES", TX_NO_INHERIT) != TX_SUCCESS ||
+      tx_mutex_create(&hash_mutex, "HASH", TX_NO_INHERIT) != TX_SUCCESS ||
+      tx_mutex_create(&pka_mutex, "PKA", TX_NO_INHERIT) != TX_SUCCESS)
+  {
+    return TX_NOT_DONE;
+  }
+
+  nx_azure_iot_crypto_hw_driver_set(&crypto_hw_driver);
+
+  return TX_SUCCESS;
+}
+
+#else
+
+UINT crypto_hw_init(VOID)
+{
+  return TX_FEATURE_NOT_ENABLED;
+}
+
+#endif
+/* USER CODE END 1 */
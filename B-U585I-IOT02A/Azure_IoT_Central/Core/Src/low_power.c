@@ -0,0 +1,413 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    low_power.c
+  * @author  MCD Application Team
+  * @brief   ThreadX tickless idle on LPTIM1
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "low_power.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include <stdio.h>
+#include <string.h>
+
+#include "main.h"
+#include "tx_timer.h"
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+/* USER CODE END PTD */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+/* Longest sleep in LPTIM counts, leaves the compare well ahead of the 16 bit counter */
+#define LOW_POWER_MAX_COUNTS 0xF000U
+/* USER CODE END PD */
+
+/* Private macro -------------------------------------------------------------*/
+/* USER CODE BEGIN PM */
+
+/* USER CODE END PM */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+extern SPI_HandleTypeDef  hspi2;
+extern UART_HandleTypeDef huart1;
+
+static UINT  low_power_ready;
+static ULONG lptim_hz;
+static ULONG stop_locks;
+
+/* State of the idle period between tx_low_power_enter and tx_low_power_exit */
+static UINT   sleeping;
+static UINT   stopping;
+static USHORT sleep_start;
+static USHORT sleep_end;
+static ULONG  sleep_ticks;
+
+/* Time not credited to the tick yet, one tick is lptim_hz */
+static ULONG residual;
+
+static LOW_POWER_STATS stats;
+static ULONG           wake_late_total_us;
+static ULONG           wake_late_count;
+static ULONG           window_start_tick;
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+void SystemClock_Config(void);
+
+VOID tx_low_power_enter(VOID);
+VOID tx_low_power_exit(VOID);
+/* USER CODE END PFP */
+
+/* USER CODE BEGIN 1 */
+#ifdef TX_LOW_POWER
+
+/* The counter runs on the asynchronous kernel clock, read until two reads agree */
+static USHORT lptim_count(VOID)
+{
+  ULONG first;
+  ULONG second;
+
+  do
+  {
+    first  = LPTIM1->CNT;
+    second = LPTIM1->CNT;
+  } while (first != second);
+
+  return (USHORT)first;
+}
+
+static VOID lptim_wait(ULONG flag, ULONG clear)
+{
+  while ((LPTIM1->ISR & flag) == 0)
+  {
+  }
+
+  LPTIM1->ICR = clear;
+}
+
+/* Ticks until the timer interrupt has something to expire. A timer lands in the slot
+   (remaining - 1) after the current one, and the interrupt only moves past empty slots. */
+static ULONG low_power_ticks_to_expiry(VOID)
+{
+  TX_TIMER_INTERNAL** slot = _tx_timer_current_ptr;
+  ULONG               ticks;
+
+  for (ticks = 1; ticks <= TX_TIMER_ENTRIES; ticks++)
+  {
+    if (*slot != TX_NULL)
+    {
+      return ticks;
+    }
+
+    slot++;
+    if (slot == _tx_timer_list_end)
+    {
+      slot = _tx_timer_list_start;
+    }
+  }
+
+  // No timer active, only an interrupt can make a thread ready
+  return 0xFFFFFFFF;
+}
+
+/* Do what the timer interrupt does on ticks with nothing to expire */
+static VOID low_power_timer_advance(ULONG ticks)
+{
+  _tx_timer_system_clock += ticks;
+
+  while (ticks-- > 0)
+  {
+    _tx_timer_current_ptr++;
+    if (_tx_timer_current_ptr == _tx_timer_list_end)
+    {
+      _tx_timer_current_ptr = _tx_timer_list_start;
+    }
+  }
+}
+
+/* Stop 2 freezes the clocks of anything in flight, only enter it with the drivers idle */
+static UINT low_power_stop_allowed(VOID)
+{
+  return stop_locks == 0 && HAL_SPI_GetState(&hspi2) == HAL_SPI_STATE_READY &&
+         __HAL_UART_GET_FLAG(&huart1, UART_FLAG_TC);
+}
+
+/* Called by the scheduler with interrupts disabled and no thread ready, before the WFI */
+VOID tx_low_power_enter(VOID)
+{
+  ULONG ticks;
+  ULONG max_ticks;
+  ULONG counts;
+
+  if (!low_power_ready || (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+  {
+    return;
+  }
+
+  // A tick owed by a previous sleep, let the timer interrupt take it first
+  if (residual >= lptim_hz)
+  {
+    residual -= lptim_hz;
+    SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+    return;
+  }
+
+  // The previous compare write must have reached the counter clock domain
+  if ((LPTIM1->ISR & LPTIM_ISR_CMP1OK) == 0)
+  {
+    return;
+  }
+
+  max_ticks = (LOW_POWER_MAX_COUNTS * TX_TIMER_TICKS_PER_SECOND) / lptim_hz;
+  ticks     = low_power_ticks_to_expiry();
+
+  if (ticks < LOW_POWER_MIN_TICKS)
+  {
+    return;
+  }
+
+  if (ticks > max_ticks)
+  {
+    ticks = max_ticks;
+  }
+
+  // Stop the tick, the part of it already elapsed is credited on wake
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  residual += (ULONG)(((ULONG64)(SysTick->LOAD - SysTick->VAL) * lptim_hz) / (SysTick->LOAD + 1));
+
+  counts = (ticks * lptim_hz - residual + TX_TIMER_TICKS_PER_SECOND - 1) / TX_TIMER_TICKS_PER_SECOND;
+
+  sleep_start = lptim_count();
+  sleep_end   = (USHORT)(sleep_start + counts);
+  sleep_ticks = ticks;
+
+  LPTIM1->ICR  = LPTIM_ICR_CMP1OKCF | LPTIM_ICR_CC1CF;
+  LPTIM1->CCR1 = sleep_end;
+  NVIC_ClearPendingIRQ(LPTIM1_IRQn);
+
+  stopping = (ticks >= LOW_POWER_STOP_MIN_TICKS) && low_power_stop_allowed();
+  if (stopping)
+  {
+    __HAL_RCC_PWR_CLK_ENABLE();
+    MODIFY_REG(PWR->CR1, PWR_CR1_LPMS, PWR_CR1_LPMS_1);
+    SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+  }
+
+  HAL_SuspendTick();
+  sleeping = TX_TRUE;
+}
+
+/* Called by the scheduler after the WFI, interrupts are still disabled */
+VOID tx_low_power_exit(VOID)
+{
+  USHORT now;
+  ULONG  ticks;
+  ULONG  late_us;
+
+  if (!sleeping)
+  {
+    return;
+  }
+
+  sleeping = TX_FALSE;
+
+  if (stopping)
+  {
+    // Woken on the HSI, bring the PLL and HSI48 back. Leaves the PWR clock disabled.
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+    SystemClock_Config();
+  }
+
+  HAL_ResumeTick();
+
+  now = lptim_count();
+  residual += (USHORT)(now - sleep_start) * TX_TIMER_TICKS_PER_SECOND;
+  ticks = residual / lptim_hz;
+  residual -= ticks * lptim_hz;
+
+  if (LPTIM1->ISR & LPTIM_ISR_CC1IF)
+  {
+    LPTIM1->ICR = LPTIM_ICR_CC1CF;
+
+    late_us = ((ULONG)(USHORT)(now - sleep_end) * 1000000) / lptim_hz;
+    wake_late_total_us += late_us;
+    wake_late_count++;
+    if (late_us > stats.wake_late_max_us)
+    {
+      stats.wake_late_max_us = late_us;
+    }
+  }
+  else
+  {
+    stats.early_wakes++;
+  }
+
+  // Never step past the expiry the sleep was planned for, the rest is owed to the next idle period
+  if (ticks > sleep_ticks)
+  {
+    residual += (ticks - sleep_ticks) * lptim_hz;
+    ticks = sleep_ticks;
+  }
+
+  // The skipped ticks had nothing to expire, the last one goes through the timer interrupt
+  if (ticks > 0)
+  {
+    low_power_timer_advance(ticks - 1);
+    SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+  }
+
+  SysTick->VAL = 0;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+  stats.sleeps++;
+  stats.sleep_ticks += ticks;
+  if (stopping)
+  {
+    stats.stops++;
+    stats.stop_ticks += ticks;
+  }
+}
+
+UINT low_power_init(VOID)
+{
+  RCC_OscInitTypeDef osc = {0};
+  TX_INTERRUPT_SAVE_AREA
+
+  __HAL_RCC_PWR_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+
+  osc.OscillatorType = RCC_OSCILLATORTYPE_LSE;
+  osc.LSEState       = RCC_LSE_ON;
+  if (HAL_RCC_OscConfig(&osc) == HAL_OK)
+  {
+    __HAL_RCC_LPTIM1_CONFIG(RCC_LPTIM1CLKSOURCE_LSE);
+    lptim_hz = LSE_VALUE;
+  }
+  else
+  {
+    printf("WARNING: LSE not running, the tickless idle runs on the LSI\r\n");
+
+    osc.OscillatorType = RCC_OSCILLATORTYPE_LSI;
+    osc.LSIState       = RCC_LSI_ON;
+    osc.LSIDiv         = RCC_LSI_DIV1;
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK)
+    {
+      printf("ERROR: LSI not running\r\n");
+      __HAL_RCC_PWR_CLK_DISABLE();
+      return TX_NOT_DONE;
+    }
+
+    __HAL_RCC_LPTIM1_CONFIG(RCC_LPTIM1CLKSOURCE_LSI);
+    lptim_hz = LSI_VALUE;
+  }
+
+  __HAL_RCC_PWR_CLK_DISABLE();
+
+  // Free running 16 bit counter, kept clocked in Stop 2, the compare wakes the core
+  __HAL_RCC_LPTIM1_CLK_ENABLE();
+  __HAL_RCC_LPTIM1_CLKAM_ENABLE();
+
+  LPTIM1->CFGR = 0;
+  LPTIM1->CR   = LPTIM_CR_ENABLE;
+  LPTIM1->DIER = LPTIM_DIER_CC1IE;
+  lptim_wait(LPTIM_ISR_DIEROK, LPTIM_ICR_DIEROKCF);
+  LPTIM1->ARR = 0xFFFF;
+  lptim_wait(LPTIM_ISR_ARROK, LPTIM_ICR_ARROKCF);
+  LPTIM1->CCR1 = 0xFFFF;
+  while ((LPTIM1->ISR & LPTIM_ISR_CMP1OK) == 0)
+  {
+  }
+  LPTIM1->CR |= LPTIM_CR_CNTSTRT;
+
+  HAL_NVIC_SetPriority(LPTIM1_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(LPTIM1_IRQn);
+
+  // Wake from Stop 2 on the HSI, the PLL input, so the clock restore is short
+  __HAL_RCC_WAKEUPSTOP_CLK_CONFIG(RCC_STOP_WAKEUPCLOCK_HSI);
+
+  TX_DISABLE
+  window_start_tick = tx_time_get();
+  low_power_ready   = TX_TRUE;
+  TX_RESTORE
+
+  return TX_SUCCESS;
+}
+
+#else
+
+UINT low_power_init(VOID)
+{
+  return TX_FEATURE_NOT_ENABLED;
+}
+
+#endif
+
+VOID low_power_stop_lock(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  stop_locks++;
+  TX_RESTORE
+}
+
+VOID low_power_stop_unlock(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  stop_locks--;
+  TX_RESTORE
+}
+
+UINT low_power_stats_get(LOW_POWER_STATS* out)
+{
+  ULONG now_tick = tx_time_get();
+  TX_INTERRUPT_SAVE_AREA
+
+  if (!low_power_ready)
+  {
+    return TX_FEATURE_NOT_ENABLED;
+  }
+
+  TX_DISABLE
+  stats.window_ticks     = now_tick - window_start_tick;
+  stats.wake_late_avg_us = (wake_late_count > 0) ? wake_late_total_us / wake_late_count : 0;
+  *out                   = stats;
+
+  memset(&stats, 0, sizeof(stats));
+  wake_late_total_us = 0;
+  wake_late_count    = 0;
+  window_start_tick  = now_tick;
+  TX_RESTORE
+
+  return TX_SUCCESS;
+}
+
+/* The compare flag is read by tx_low_power_exit, this only keeps a match outside an idle period from pending */
+VOID low_power_isr(VOID)
+{
+  LPTIM1->ICR = LPTIM_ICR_CC1CF;
+}
+/* USER CODE END 1 */
@@ -23,6 +23,7 @@
 #include "app_threadx.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "motion_fifo.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -78,6 +79,10 @@ void HAL_GPIO_EXTI_Rising_Callback(uint16_t GPIO_Pin)
     case (GPIO_PIN_1):
 
       break;
+
+    case (ISM330DHCX_INT1_Pin):
+      motion_fifo_isr();
+      break;
 #if MX_WIFI_USE_SPI == 1
     case (MXCHIP_FLOW_Pin):
       mxchip_WIFI_ISR(MXCHIP_FLOW_Pin);
@@ -0,0 +1,426 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    motion_features.c
+  * @author  MCD Application Team
+  * @brief   Vibration feature extraction from the motion FIFO blocks
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "motion_features.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "main.h"
+#include "motion_fifo.h"
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+typedef struct MOTION_AXIS_WINDOW_STRUCT
+{
+  int64_t sum_squares; // of the samples minus their block mean, raw LSB^2
+  int32_t min;
+  int32_t max;
+  int32_t peak;        // largest deviation from the block mean
+  float   band_power[MOTION_FEATURES_BANDS];
+} MOTION_AXIS_WINDOW;
+/* USER CODE END PTD */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+#define FEATURES_THREAD_STACK_SIZE 1024
+#define FEATURES_THREAD_PRIORITY   8
+
+#define FFT_SIZE   MOTION_FIFO_BLOCK_SAMPLES
+#define FFT_STAGES 7
+
+/* Check for new blocks twice per block period */
+#define FEATURES_POLL_TICKS \
+  ((MOTION_FIFO_BLOCK_SAMPLES * TX_TIMER_TICKS_PER_SECOND) / (2 * (ULONG)MOTION_FIFO_ODR))
+
+/* Mean power of the Hann window, corrects the band power for the windowing loss */
+#define HANN_POWER 0.375f
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+/* USER CODE END PD */
+
+/* Private macro -------------------------------------------------------------*/
+/* USER CODE BEGIN PM */
+
+/* USER CODE END PM */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+static TX_THREAD features_thread;
+static ULONG     features_thread_stack[FEATURES_THREAD_STACK_SIZE / sizeof(ULONG)];
+static TX_MUTEX  features_mutex;
+
+/* First FFT bin of each band, 1.625 Hz per bin at 208 Hz, the DC bin is skipped.
+   Bands are 1.6-13 Hz, 13-26 Hz, 26-52 Hz and 52-104 Hz. */
+static const UINT band_start[MOTION_FEATURES_BANDS + 1] = {1, 8, 16, 32, FFT_SIZE / 2};
+
+static int16_t twiddle_cos[FFT_SIZE / 2];
+static int16_t twiddle_sin[FFT_SIZE / 2];
+static int16_t hann[FFT_SIZE];
+
+static int16_t centered[FFT_SIZE] __ALIGNED(4);
+static int16_t fft_re[FFT_SIZE];
+static int16_t fft_im[FFT_SIZE];
+
+static MOTION_AXIS_WINDOW window[MOTION_FEATURES_AXES];
+static ULONG              window_samples;
+static ULONG              window_blocks;
+static ULONG              window_dropped;
+static ULONG              window_cycles;
+static ULONG              window_max_cycles;
+static ULONG              next_sequence;
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+
+/* USER CODE END PFP */
+
+/* USER CODE BEGIN 1 */
+static VOID window_reset(VOID)
+{
+  UINT axis;
+
+  memset(window, 0, sizeof(window));
+  for (axis = 0; axis < MOTION_FEATURES_AXES; axis++)
+  {
+    window[axis].min = INT16_MAX;
+    window[axis].max = INT16_MIN;
+  }
+
+  window_samples    = 0;
+  window_blocks     = 0;
+  window_dropped    = 0;
+  window_cycles     = 0;
+  window_max_cycles = 0;
+}
+
+/* Radix-2 decimation in time Q15 FFT, each stage is scaled by 1/2 so the output is the DFT / FFT_SIZE */
+static VOID fft_q15(int16_t* re, int16_t* im)
+{
+  UINT    i;
+  UINT    j;
+  UINT    k;
+  UINT    bit;
+  UINT    span;
+  UINT    step;
+  int16_t swap;
+  int32_t wr;
+  int32_t wi;
+  int32_t tr;
+  int32_t ti;
+
+  for (i = 1, j = 0; i < FFT_SIZE; i++)
+  {
+    for (bit = FFT_SIZE >> 1; j & bit; bit >>= 1)
+    {
+      j ^= bit;
+    }
+    j ^= bit;
+
+    if (i < j)
+    {
+      swap  = re[i];
+      re[i] = re[j];
+      re[j] = swap;
+      swap  = im[i];
+      im[i] = im[j];
+      im[j] = swap;
+    }
+  }
+
+  for (span = 1, step = FFT_SIZE / 2; span < FFT_SIZE; span <<= 1, step >>= 1)
+  {
+    for (k = 0; k < span; k++)
+    {
+      wr = twiddle_cos[k * step];
+      wi = -twiddle_sin[k * step];
+
+      for (i = k; i < FFT_SIZE; i += span << 1)
+      {
+        j  = i + span;
+        tr = (re[j] * wr - im[j] * wi) >> 15;
+        ti = (re[j] * wi + im[j] * wr) >> 15;
+
+        re[j] = (int16_t)((re[i] - tr) >> 1);
+        im[j] = (int16_t)((im[i] - ti) >> 1);
+        re[i] = (int16_t)((re[i] + tr) >> 1);
+        im[i] = (int16_t)((im[i] + ti) >> 1);
+      }
+    }
+  }
+}
+
+static int64_t sum_squares_q15(const int16_t* data)
+{
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+  const uint32_t* pair = (const uint32_t*)data;
+  uint64_t        sum  = 0;
+  UINT            index;
+
+  // Two multiply-accumulates per instruction on packed halfwords
+  for (index = 0; index < FFT_SIZE / 2; index++)
+  {
+    sum = __SMLALD(pair[index], pair[index], sum);
+  }
+
+  return (int64_t)sum;
+#else
+  int64_t sum = 0;
+  UINT    index;
+
+  for (index = 0; index < FFT_SIZE; index++)
+  {
+    sum += data[index] * data[index];
+  }
+
+  return sum;
+#endif
+}
+
+static VOID process_axis(const MOTION_BLOCK* block, UINT axis)
+{
+  MOTION_AXIS_WINDOW* axis_window = &window[axis];
+  const int16_t*      raw         = (const int16_t*)block->sample + axis;
+  int32_t             sum         = 0;
+  int32_t             mean;
+  int32_t             value;
+  int32_t             peak = 0;
+  INT                 shift;
+  UINT                band;
+  UINT                index;
+  uint64_t            energy;
+
+  // Samples are interleaved x, y, z
+  for (index = 0; index < FFT_SIZE; index++)
+  {
+    value = raw[index * MOTION_FEATURES_AXES];
+    sum += value;
+
+    if (value < axis_window->min)
+    {
+      axis_window->min = value;
+    }
+    if (value > axis_window->max)
+    {
+      axis_window->max = value;
+    }
+  }
+
+  // Remove gravity and the sensor offset, the FFT_SIZE division is a shift
+  mean = (sum + FFT_SIZE / 2) >> FFT_STAGES;
+
+  for (index = 0; index < FFT_SIZE; index++)
+  {
+    value           = __SSAT(raw[index * MOTION_FEATURES_AXES] - mean, 16);
+    centered[index] = (int16_t)value;
+
+    if (value < 0)
+    {
+      value = -value;
+    }
+    if (value > peak)
+    {
+      peak = value;
+    }
+  }
+
+  if (peak > axis_window->peak)
+  {
+    axis_window->peak = peak;
+  }
+
+  axis_window->sum_squares += sum_squares_q15(centered);
+
+  // Block floating point, keep the FFT input below 2^14 so the butterflies cannot overflow,
+  // and scale small vibrations up to keep the resolution
+  shift = (peak >= 0x4000) ? -1 : 0;
+  while (peak > 0 && (peak << (shift + 1)) < 0x4000)
+  {
+    shift++;
+  }
+
+  for (index = 0; index < FFT_SIZE; index++)
+  {
+    value         = (shift < 0) ? (centered[index] >> 1) : (centered[index] << shift);
+    fft_re[index] = (int16_t)((value * hann[index]) >> 15);
+    fft_im[index] = 0;
+  }
+
+  fft_q15(fft_re, fft_im);
+
+  for (band = 0; band < MOTION_FEATURES_BANDS; band++)
+  {
+    energy = 0;
+    for (index = band_start[band]; index < band_start[band + 1]; index++)
+    {
+      energy += (uint32_t)(fft_re[index] * fft_re[index]) + (uint32_t)(fft_im[index] * fft_im[index]);
+    }
+
+    // One sided spectrum, mean square of the windowed block in raw LSB^2
+    axis_window->band_power[band] += ldexpf(2.0f * (float)energy / HANN_POWER, -2 * shift);
+  }
+}
+
+static VOID process_block(const MOTION_BLOCK* block)
+{
+  UINT  axis;
+  ULONG cycles = DWT->CYCCNT;
+
+  if (block->sequence != next_sequence)
+  {
+    window_dropped += block->sequence - next_sequence;
+  }
+  next_sequence = block->sequence + 1;
+
+  for (axis = 0; axis < MOTION_FEATURES_AXES; axis++)
+  {
+    process_axis(block, axis);
+  }
+
+  cycles = DWT->CYCCNT - cycles;
+
+  window_samples += MOTION_FIFO_BLOCK_SAMPLES;
+  window_blocks++;
+  window_cycles += cycles;
+  if (cycles > window_max_cycles)
+  {
+    window_max_cycles = cycles;
+  }
+}
+
+static VOID features_thread_entry(ULONG parameter)
+{
+  const MOTION_BLOCK* block;
+
+  (void)parameter;
+
+  while (TX_TRUE)
+  {
+    while ((block = motion_fifo_block_get()) != TX_NULL)
+    {
+      tx_mutex_get(&features_mutex, TX_WAIT_FOREVER);
+      process_block(block);
+      tx_mutex_put(&features_mutex);
+
+      motion_fifo_block_release();
+    }
+
+    tx_thread_sleep(FEATURES_POLL_TICKS);
+  }
+}
+
+UINT motion_features_init(VOID)
+{
+  UINT status;
+  UINT index;
+
+  for (index = 0; index < FFT_SIZE / 2; index++)
+  {
+    twiddle_cos[index] = (int16_t)lrintf(32767.0f * cosf(2.0f * (float)M_PI * index / FFT_SIZE));
+    twiddle_sin[index] = (int16_t)lrintf(32767.0f * sinf(2.0f * (float)M_PI * index / FFT_SIZE));
+  }
+
+  for (index = 0; index < FFT_SIZE; index++)
+  {
+    hann[index] = (int16_t)lrintf(32767.0f * 0.5f * (1.0f - cosf(2.0f * (float)M_PI * index / FFT_SIZE)));
+  }
+
+  window_reset();
+
+  // Cycle counter for the processing cost
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  if ((status = tx_mutex_create(&features_mutex, "Motion features", TX_INHERIT)))
+  {
+    printf("ERROR: tx_mutex_create (0x%08x)\r\n", status);
+    return status;
+  }
+
+  if ((status = tx_thread_create(&features_thread,
+           "Motion Features Thread",
+           features_thread_entry,
+           0,
+           features_thread_stack,
+           FEATURES_THREAD_STACK_SIZE,
+           FEATURES_THREAD_PRIORITY,
+           FEATURES_THREAD_PRIORITY,
+           TX_NO_TIME_SLICE,
+           TX_AUTO_START)))
+  {
+    printf("ERROR: motion features thread creation failed (0x%08x)\r\n", status);
+    return status;
+  }
+
+  return TX_SUCCESS;
+}
+
+UINT motion_features_get(MOTION_FEATURES* features)
+{
+  UINT                  axis;
+  UINT                  band;
+  float                 mean_square;
+  float                 sensitivity = motion_fifo_stats_get()->acc_sensitivity;
+  MOTION_AXIS_FEATURES* axis_features;
+
+  tx_mutex_get(&features_mutex, TX_WAIT_FOREVER);
+
+  if (window_blocks == 0)
+  {
+    tx_mutex_put(&features_mutex);
+    return TX_NOT_DONE;
+  }
+
+  features->samples          = window_samples;
+  features->blocks           = window_blocks;
+  features->dropped_blocks   = window_dropped;
+  features->max_block_cycles = window_max_cycles;
+  features->avg_block_cycles = window_cycles / window_blocks;
+
+  for (axis = 0; axis < MOTION_FEATURES_AXES; axis++)
+  {
+    axis_features = &features->axis[axis];
+
+    mean_square                 = (float)window[axis].sum_squares / window_samples;
+    axis_features->rms          = sqrtf(mean_square) * sensitivity;
+    axis_features->peak_to_peak = (window[axis].max - window[axis].min) * sensitivity;
+    axis_features->crest_factor = (mean_square > 0.0f) ? window[axis].peak / sqrtf(mean_square) : 0.0f;
+
+    for (band = 0; band < MOTION_FEATURES_BANDS; band++)
+    {
+      axis_features->band_rms[band] = sqrtf(window[axis].band_power[band] / window_blocks) * sensitivity;
+    }
+  }
+
+  window_reset();
+
+  tx_mutex_put(&features_mutex);
+
+  return TX_SUCCESS;
+}
+/* USER CODE END 1 */
@@ -0,0 +1,346 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    motion_fifo.c
+  * @author  MCD Application Team
+  * @brief   ISM330DHCX FIFO acquisition
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2022 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "motion_fifo.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include <stdio.h>
+
+#include "main.h"
+#include "b_u585i_iot02a_motion_sensors.h"
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+/* USER CODE END PTD */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+#define MOTION_THREAD_STACK_SIZE 1024
+#define MOTION_THREAD_PRIORITY   5
+
+#define MOTION_WATERMARK_EVENT 1
+
+/* FIFO words read per I2C transfer, each word is a tag byte and 6 data bytes */
+#define MOTION_FIFO_WORD_SIZE   7
+#define MOTION_FIFO_BURST_WORDS 32
+
+/* Drain anyway if the watermark edge was missed, e.g. the FIFO stayed above it */
+#define MOTION_WATERMARK_TIMEOUT \
+  ((2 * MOTION_FIFO_WATERMARK * TX_TIMER_TICKS_PER_SECOND) / (ULONG)MOTION_FIFO_ODR + 1)
+/* USER CODE END PD */
+
+/* Private macro -------------------------------------------------------------*/
+/* USER CODE BEGIN PM */
+
+/* USER CODE END PM */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+static TX_THREAD            motion_thread;
+static ULONG                motion_thread_stack[MOTION_THREAD_STACK_SIZE / sizeof(ULONG)];
+static TX_EVENT_FLAGS_GROUP motion_events;
+static TX_MUTEX             bus_mutex;
+static UINT                 bus_mutex_ready;
+
+static ISM330DHCX_Object_t* sensor;
+static UCHAR                burst[MOTION_FIFO_BURST_WORDS * MOTION_FIFO_WORD_SIZE];
+
+/* Single producer (motion thread) / single consumer ring. head and tail are free running,
+   head is only written by the producer and tail only by the consumer. */
+static MOTION_BLOCK  blocks[MOTION_FIFO_BLOCKS];
+static volatile UINT block_head;
+static volatile UINT block_tail;
+static UINT          block_fill;
+static UINT          block_dropped;
+static ULONG         block_sequence;
+
+static MOTION_FIFO_STATS stats;
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+
+/* USER CODE END PFP */
+
+/* USER CODE BEGIN 1 */
+static VOID block_push(const UCHAR* data)
+{
+  MOTION_BLOCK* block;
+
+  // A block is dropped whole when the ring is full as it starts, the consumer never sees a partial block
+  if (block_fill == 0)
+  {
+    block_dropped = (block_head - block_tail == MOTION_FIFO_BLOCKS);
+  }
+
+  block = &blocks[block_head % MOTION_FIFO_BLOCKS];
+
+  if (!block_dropped)
+  {
+    block->sample[block_fill].x = (int16_t)((data[1] << 8) | data[0]);
+    block->sample[block_fill].y = (int16_t)((data[3] << 8) | data[2]);
+    block->sample[block_fill].z = (int16_t)((data[5] << 8) | data[4]);
+  }
+
+  if (++block_fill < MOTION_FIFO_BLOCK_SAMPLES)
+  {
+    return;
+  }
+
+  block_fill = 0;
+
+  if (block_dropped)
+  {
+    block_sequence++;
+    stats.dropped_blocks++;
+    return;
+  }
+
+  block->sequence = block_sequence++;
+  block->end_tick = tx_time_get();
+  stats.blocks++;
+
+  // Publish the samples before the block
+  __DMB();
+  block_head++;
+}
+
+static VOID motion_fifo_drain(VOID)
+{
+  uint16_t level;
+  UINT     count;
+  UINT     index;
+  ULONG    words      = 0;
+  ULONG    start_tick = tx_time_get();
+
+  motion_fifo_bus_lock();
+
+  if (ISM330DHCX_FIFO_Get_Num_Samples(sensor, &level) != ISM330DHCX_OK)
+  {
+    motion_fifo_bus_unlock();
+    return;
+  }
+
+  while (level > 0)
+  {
+    count = (level > MOTION_FIFO_BURST_WORDS) ? MOTION_FIFO_BURST_WORDS : level;
+
+    // The FIFO output address rolls back to the tag after Z_H, so consecutive words are read in one transfer
+    if (ism330dhcx_read_reg(&sensor->Ctx, ISM330DHCX_FIFO_DATA_OUT_TAG, burst, count * MOTION_FIFO_WORD_SIZE) !=
+        ISM330DHCX_OK)
+    {
+      break;
+    }
+
+    for (index = 0; index < count; index++)
+    {
+      if ((burst[index * MOTION_FIFO_WORD_SIZE] >> 3) == ISM330DHCX_XL_NC_TAG)
+      {
+        block_push(&burst[index * MOTION_FIFO_WORD_SIZE + 1]);
+        stats.samples++;
+      }
+    }
+
+    level -= count;
+    words += count;
+  }
+
+  motion_fifo_bus_unlock();
+
+  stats.drains++;
+  stats.drain_ticks += tx_time_get() - start_tick;
+  if (words > stats.max_drain)
+  {
+    stats.max_drain = words;
+  }
+}
+
+static VOID motion_thread_entry(ULONG parameter)
+{
+  ULONG events;
+
+  (void)parameter;
+
+  while (TX_TRUE)
+  {
+    tx_event_flags_get(&motion_events, MOTION_WATERMARK_EVENT, TX_OR_CLEAR, &events, MOTION_WATERMARK_TIMEOUT);
+
+    motion_fifo_drain();
+  }
+}
+
+static UINT motion_fifo_sensor_init(VOID)
+{
+  ism330dhcx_reg_t reg;
+
+  if (BSP_MOTION_SENSOR_Init(0, MOTION_ACCELERO | MOTION_GYRO) != BSP_ERROR_NONE ||
+      BSP_MOTION_SENSOR_SetOutputDataRate(0, MOTION_ACCELERO, MOTION_FIFO_ODR) != BSP_ERROR_NONE ||
+      BSP_MOTION_SENSOR_SetFullScale(0, MOTION_ACCELERO, 4) != BSP_ERROR_NONE ||
+      BSP_MOTION_SENSOR_Enable(0, MOTION_ACCELERO) != BSP_ERROR_NONE ||
+      BSP_MOTION_SENSOR_Enable(0, MOTION_GYRO) != BSP_ERROR_NONE)
+  {
+    printf("ERROR: BSP_MOTION_SENSOR_Init\r\n");
+    return TX_NOT_DONE;
+  }
+
+  sensor = (ISM330DHCX_Object_t*)Motion_Sensor_CompObj[0];
+
+  // Batch the accelerometer only, the gyroscope is read on demand
+  if (ISM330DHCX_FIFO_Set_Mode(sensor, ISM330DHCX_BYPASS_MODE) != ISM330DHCX_OK ||
+      ISM330DHCX_FIFO_Set_Watermark_Level(sensor, MOTION_FIFO_WATERMARK) != ISM330DHCX_OK ||
+      ISM330DHCX_FIFO_ACC_Set_BDR(sensor, MOTION_FIFO_ODR) != ISM330DHCX_OK ||
+      ism330dhcx_fifo_gy_batch_set(&sensor->Ctx, ISM330DHCX_GY_NOT_BATCHED) != ISM330DHCX_OK ||
+      ISM330DHCX_ACC_GetSensitivity(sensor, &stats.acc_sensitivity) != ISM330DHCX_OK)
+  {
+    printf("ERROR: ISM330DHCX FIFO configuration\r\n");
+    return TX_NOT_DONE;
+  }
+
+  // Route the FIFO watermark to INT1
+  if (ism330dhcx_read_reg(&sensor->Ctx, ISM330DHCX_INT1_CTRL, &reg.byte, 1) != ISM330DHCX_OK)
+  {
+    return TX_NOT_DONE;
+  }
+
+  reg.int1_ctrl.int1_fifo_th = 1;
+
+  if (ism330dhcx_write_reg(&sensor->Ctx, ISM330DHCX_INT1_CTRL, &reg.byte, 1) != ISM330DHCX_OK ||
+      ISM330DHCX_FIFO_Set_Mode(sensor, ISM330DHCX_STREAM_MODE) != ISM330DHCX_OK)
+  {
+    printf("ERROR: ISM330DHCX FIFO interrupt\r\n");
+    return TX_NOT_DONE;
+  }
+
+  return TX_SUCCESS;
+}
+
+static VOID motion_fifo_gpio_init(VOID)
+{
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+  __HAL_RCC_GPIOE_CLK_ENABLE();
+
+  GPIO_InitStruct.Pin  = ISM330DHCX_INT1_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  HAL_GPIO_Init(ISM330DHCX_INT1_GPIO_Port, &GPIO_InitStruct);
+
+  HAL_NVIC_SetPriority(ISM330DHCX_INT1_EXTI_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(ISM330DHCX_INT1_EXTI_IRQn);
+}
+
+UINT motion_fifo_init(VOID)
+{
+  UINT status;
+
+  if ((status = tx_mutex_create(&bus_mutex, "I2C2 bus", TX_INHERIT)))
+  {
+    printf("ERROR: tx_mutex_create (0x%08x)\r\n", status);
+    return status;
+  }
+  bus_mutex_ready = TX_TRUE;
+
+  if ((status = tx_event_flags_create(&motion_events, "Motion events")))
+  {
+    printf("ERROR: tx_event_flags_create (0x%08x)\r\n", status);
+    return status;
+  }
+
+  motion_fifo_bus_lock();
+  status = motion_fifo_sensor_init();
+  motion_fifo_bus_unlock();
+
+  if (status != TX_SUCCESS)
+  {
+    return status;
+  }
+
+  if ((status = tx_thread_create(&motion_thread,
+           "Motion Thread",
+           motion_thread_entry,
+           0,
+           motion_thread_stack,
+           MOTION_THREAD_STACK_SIZE,
+           MOTION_THREAD_PRIORITY,
+           MOTION_THREAD_PRIORITY,
+           TX_NO_TIME_SLICE,
+           TX_AUTO_START)))
+  {
+    printf("ERROR: motion thread creation failed (0x%08x)\r\n", status);
+    return status;
+  }
+
+  motion_fifo_gpio_init();
+
+  printf("SUCCESS: Motion FIFO started at %d Hz\r\n", (INT)MOTION_FIFO_ODR);
+
+  return TX_SUCCESS;
+}
+
+/* Called from the EXTI interrupt on the FIFO watermark, the I2C transfers are left to the motion thread */
+VOID motion_fifo_isr(VOID)
+{
+  tx_event_flags_set(&motion_events, MOTION_WATERMARK_EVENT, TX_OR);
+}
+
+const MOTION_BLOCK* motion_fifo_block_get(VOID)
+{
+  if (block_tail == block_head)
+  {
+    return TX_NULL;
+  }
+
+  // Read the block only after seeing it published
+  __DMB();
+  return &blocks[block_tail % MOTION_FIFO_BLOCKS];
+}
+
+VOID motion_fifo_block_release(VOID)
+{
+  // Finish reading the block before handing the slot back
+  __DMB();
+  block_tail++;
+}
+
+const MOTION_FIFO_STATS* motion_fifo_stats_get(VOID)
+{
+  return &stats;
+}
+
+VOID motion_fifo_bus_lock(VOID)
+{
+  if (bus_mutex_ready)
+  {
+    tx_mutex_get(&bus_mutex, TX_WAIT_FOREVER);
+  }
+}
+
+VOID motion_fifo_bus_unlock(VOID)
+{
+  if (bus_mutex_ready)
+  {
+    tx_mutex_put(&bus_mutex);
+  }
+}
+/* USER CODE END 1 */
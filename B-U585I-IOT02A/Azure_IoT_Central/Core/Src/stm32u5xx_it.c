@@ -22,6 +22,7 @@
 #include "stm32u5xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "low_power.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -217,5 +218,20 @@ void USART1_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+/**
+  * @brief This function handles EXTI Line11 interrupt, the ISM330DHCX FIFO watermark.
+  */
+void EXTI11_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(ISM330DHCX_INT1_Pin);
+}
+
+/**
+  * @brief This function handles LPTIM1 global interrupt, the tickless idle wake-up.
+  */
+void LPTIM1_IRQHandler(void)
+{
+  low_power_isr();
+}
 
 /* USER CODE END 1 */
@@ -38,7 +38,11 @@
 #define DEBUG_LOG(M, ...)
 #endif /* MX_WIFI_IPC_DEBUG */
 
+#ifndef MIPC_REQ_LIST_SIZE
 #define MIPC_REQ_LIST_SIZE      (64)
+#endif /* MIPC_REQ_LIST_SIZE */
+
+#define MIPC_REQ_ID_FREE        (0xFFFFFFFFU)
 
 /**
   * @brief IPC API event handlers
@@ -65,24 +69,43 @@ event_item_t event_table[3] =
 typedef struct _mipc_req_s
 {
   uint32_t req_id;
+  uint16_t api_id;
+  bool answered;
   SEM_DECLARE(resp_flag);
   uint16_t *rbuffer_size; /* in/out*/
   uint8_t *rbuffer;
+  mipc_resp_callback_t callback; /* NULL for a blocking request */
+  void *callback_arg;
 } mipc_req_t;
 
-
-static mipc_req_t pending_request;
+/* Requests waiting for their answer, matched by req_id. The table is protected
+ * by pending_request_lock, the transmit path by wifi_obj_get()->lockcmd only,
+ * so several threads may have a command in flight at the same time. */
+static mipc_req_t pending_request[MIPC_REQ_LIST_SIZE];
+static LOCK_DECLARE(pending_request_lock);
 
 static uint32_t get_new_req_id(void);
 static uint32_t mpic_get_req_id(uint8_t *buffer_in);
 static uint16_t mpic_get_api_id(uint8_t *buffer_in);
+static mipc_req_t *mipc_req_alloc(uint16_t api_id, uint8_t *rbuffer, uint16_t *rbuffer_size,
+                                  mipc_resp_callback_t callback, void *callback_arg);
+static mipc_req_t *mipc_req_find(uint32_t req_id);
+static void mipc_req_free(mipc_req_t *req);
+static int32_t mipc_send(const mipc_req_t *req, uint8_t *cparams, uint16_t cparams_size);
+static void mipc_response(uint32_t req_id, mx_buf_t *netbuf);
 static uint32_t mipc_event(mx_buf_t *netbuf);
 
-/* unique sequence number */
+/* unique sequence number, called with pending_request_lock held */
 static uint32_t get_new_req_id(void)
 {
   static uint32_t id = 1;
-  return id++;
+  uint32_t new_id = id++;
+
+  if ((MIPC_REQ_ID_NONE == id) || (MIPC_REQ_ID_FREE == id))
+  {
+    id = 1;
+  }
+  return new_id;
 }
 
 static uint32_t mpic_get_req_id(uint8_t *buffer_in)
@@ -95,6 +118,185 @@ static uint16_t mpic_get_api_id(uint8_t *buffer_in)
   return *((uint16_t *) & (buffer_in[MIPC_PKT_API_ID_OFFSET]));
 }
 
+static mipc_req_t *mipc_req_alloc(uint16_t api_id, uint8_t *rbuffer, uint16_t *rbuffer_size,
+                                  mipc_resp_callback_t callback, void *callback_arg)
+{
+  mipc_req_t *req = NULL;
+  uint32_t i;
+
+  LOCK(pending_request_lock);
+  for (i = 0; i < (uint32_t)MIPC_REQ_LIST_SIZE; i++)
+  {
+    if (MIPC_REQ_ID_FREE == pending_request[i].req_id)
+    {
+      req = &pending_request[i];
+      req->req_id = get_new_req_id();
+      req->api_id = api_id;
+      req->answered = false;
+      req->rbuffer = rbuffer;
+      req->rbuffer_size = rbuffer_size;
+      req->callback = callback;
+      req->callback_arg = callback_arg;
+      break;
+    }
+  }
+  UNLOCK(pending_request_lock);
+
+  return req;
+}
+
+/* called with pending_request_lock held */
+static mipc_req_t *mipc_req_find(uint32_t req_id)
+{
+  mipc_req_t *req = NULL;
+  uint32_t i;
+
+  if ((MIPC_REQ_ID_NONE != req_id) && (MIPC_REQ_ID_FREE != req_id))
+  {
+    for (i = 0; i < (uint32_t)MIPC_REQ_LIST_SIZE; i++)
+    {
+      if (req_id == pending_request[i].req_id)
+      {
+        req = &pending_request[i];
+        break;
+      }
+    }
+  }
+  return req;
+}
+
+/* called with pending_request_lock held */
+static void mipc_req_free(mipc_req_t *req)
+{
+  req->req_id = MIPC_REQ_ID_FREE;
+  req->rbuffer = NULL;
+  req->rbuffer_size = NULL;
+  req->callback = NULL;
+  req->callback_arg = NULL;
+}
+
+static int32_t mipc_send(const mipc_req_t *req, uint8_t *cparams, uint16_t cparams_size)
+{
+  int32_t ret = MIPC_CODE_ERROR;
+  uint8_t *cbuf;
+  uint8_t *pos;
+  uint16_t cbuf_size;
+  uint32_t req_id = req->req_id;
+  uint16_t api_id = req->api_id;
+  bool copy_buffer = true;
+
+  /* create cmd data */
+  cbuf_size = sizeof(req_id) + sizeof(api_id) + cparams_size;
+
+#if MX_WIFI_TX_BUFFER_NO_COPY
+  if (api_id == MIPC_API_WIFI_BYPASS_OUT_CMD)
+  {
+    cbuf = cparams - sizeof(req_id) - sizeof(api_id);
+    copy_buffer = false;
+  }
+  else
+#endif /* MX_WIFI_TX_BUFFER_NO_COPY */
+  {
+    cbuf = (uint8_t *)MX_WIFI_MALLOC(cbuf_size);
+  }
+
+  if (NULL != cbuf)
+  {
+    /* copy the protocol parameter to the head part of the buffer */
+    pos = cbuf;
+    memcpy(pos, &req_id, sizeof(req_id));
+    pos += sizeof(req_id);
+    memcpy(pos, &api_id, sizeof(api_id));
+    pos += sizeof(api_id);
+
+    if ((true == copy_buffer) && (cparams_size > 0))
+    {
+      memcpy(pos, cparams, cparams_size);
+    }
+
+    /* the bus carries one frame at a time, the answer is not waited for here */
+    DEBUG_LOG("cmd %"PRIu32"\n", req_id);
+    LOCK(wifi_obj_get()->lockcmd);
+    if (0 == mx_wifi_hci_send(cbuf, cbuf_size))
+    {
+      ret = MIPC_CODE_SUCCESS;
+    }
+    else
+    {
+      DEBUG_ERROR("Failed to send command 0x%04x to Hci\n", api_id);
+    }
+    UNLOCK(wifi_obj_get()->lockcmd);
+
+    if (true == copy_buffer)
+    {
+      MX_WIFI_FREE(cbuf);
+    }
+  }
+  else
+  {
+    ret = MIPC_CODE_NO_MEMORY;
+  }
+
+  return ret;
+}
+
+static void mipc_response(uint32_t req_id, mx_buf_t *netbuf)
+{
+  uint8_t *buffer_in = MX_NET_BUFFER_PAYLOAD(netbuf);
+  uint32_t buffer_size = MX_NET_BUFFER_GET_PAYLOAD_SIZE(netbuf);
+  mipc_resp_callback_t callback = NULL;
+  void *callback_arg = NULL;
+  uint8_t *rbuffer = NULL;
+  uint16_t rbuffer_size = 0;
+  mipc_req_t *req;
+
+  LOCK(pending_request_lock);
+  req = mipc_req_find(req_id);
+  if ((NULL != req) && (false == req->answered))
+  {
+    /* return params */
+    if ((req->rbuffer_size != NULL) && (*(req->rbuffer_size) > 0) && (NULL != req->rbuffer))
+    {
+      *(req->rbuffer_size) = *(req->rbuffer_size) < (buffer_size - MIPC_PKT_MIN_SIZE) ? \
+                             *(req->rbuffer_size) : (buffer_size - MIPC_PKT_MIN_SIZE);
+      memcpy(req->rbuffer, buffer_in + MIPC_PKT_PARAMS_OFFSET, *(req->rbuffer_size));
+      rbuffer = req->rbuffer;
+      rbuffer_size = *(req->rbuffer_size);
+    }
+
+    if (NULL == req->callback)
+    {
+      /* blocking request, the waiting thread releases the slot */
+      req->answered = true;
+      if (SEM_OK != SEM_SIGNAL(req->resp_flag))
+      {
+        DEBUG_ERROR("Failed to signal command response\n");
+        while (1);
+      }
+    }
+    else
+    {
+      callback = req->callback;
+      callback_arg = req->callback_arg;
+      mipc_req_free(req);
+    }
+  }
+  else
+  {
+    /* timed out or cancelled request */
+    DEBUG_ERROR("Drop answer for unknown request %"PRIu32"\n", req_id);
+  }
+  UNLOCK(pending_request_lock);
+
+  MX_STAT(cmd_get_answer);
+  mx_wifi_hci_free(netbuf);
+
+  if (NULL != callback)
+  {
+    callback(req_id, MIPC_CODE_SUCCESS, rbuffer, rbuffer_size, callback_arg);
+  }
+}
+
 static uint32_t mipc_event(mx_buf_t *netbuf)
 {
   uint32_t req_id = MIPC_REQ_ID_NONE;
@@ -114,27 +316,8 @@ static uint32_t mipc_event(mx_buf_t *netbuf)
       DEBUG_LOG("req_id: 0x%08"PRIx32", api_id: 0x%04x\n", req_id, api_id);
       if ((0 == (api_id & MIPC_API_EVENT_BASE)) && (MIPC_REQ_ID_NONE != req_id))
       {
-        /* cmd response must match pending req id */
-        MX_ASSERT(pending_request.req_id == req_id);
-        {
-          /* return params */
-          if ((pending_request.rbuffer_size != NULL) && (*(pending_request.rbuffer_size) > 0)
-              && (NULL != pending_request.rbuffer))
-          {
-            *(pending_request.rbuffer_size) = *(pending_request.rbuffer_size) < (buffer_size - MIPC_PKT_MIN_SIZE) ? \
-                                              *(pending_request.rbuffer_size) : (buffer_size - MIPC_PKT_MIN_SIZE);
-            memcpy(pending_request.rbuffer, buffer_in + MIPC_PKT_PARAMS_OFFSET, *(pending_request.rbuffer_size));
-          }
-          /* printf("Signal for %d\n",pending_request.req_id); */
-          pending_request.req_id = 0xFFFFFFFF;
-          if (SEM_OK != SEM_SIGNAL(pending_request.resp_flag))
-          {
-            DEBUG_ERROR("Failed to signal command response\n");
-            while (1);
-          }
-          MX_STAT(cmd_get_answer);
-          mx_wifi_hci_free(netbuf);
-        }
+        /* cmd response, matched against the pending request list */
+        mipc_response(req_id, netbuf);
       }
       else /* event callback */
       {
@@ -179,9 +362,14 @@ static uint32_t mipc_event(mx_buf_t *netbuf)
 int32_t mipc_init(mipc_send_func_t ipc_send)
 {
   int32_t ret;
+  uint32_t i;
 
-  pending_request.req_id = 0xFFFFFFFF;
-  SEM_INIT(pending_request.resp_flag, 1);
+  LOCK_INIT(pending_request_lock);
+  for (i = 0; i < (uint32_t)MIPC_REQ_LIST_SIZE; i++)
+  {
+    mipc_req_free(&pending_request[i]);
+    SEM_INIT(pending_request[i].resp_flag, 1);
+  }
 
   ret = mx_wifi_hci_init(ipc_send);
 
@@ -192,7 +380,13 @@ int32_t mipc_init(mipc_send_func_t ipc_send)
 int32_t mipc_deinit(void)
 {
   int32_t ret;
-  SEM_DEINIT(pending_request.resp_flag);
+  uint32_t i;
+
+  for (i = 0; i < (uint32_t)MIPC_REQ_LIST_SIZE; i++)
+  {
+    SEM_DEINIT(pending_request[i].resp_flag);
+  }
+  LOCK_DEINIT(pending_request_lock);
   ret = mx_wifi_hci_deinit();
 
   return ret;
@@ -203,91 +397,149 @@ int32_t mipc_request(uint16_t api_id, uint8_t *cparams, uint16_t cparams_size,
                      uint8_t *rbuffer, uint16_t *rbuffer_size, uint32_t timeout_ms)
 {
   int32_t ret = MIPC_CODE_ERROR;
-
-  uint8_t *cbuf;
-  uint8_t *pos;
-  uint16_t cbuf_size;
+  mipc_req_t *req;
   uint32_t req_id;
-  bool copy_buffer = true;
 
-  LOCK(wifi_obj_get()->lockcmd);
   if (cparams_size <= MX_WIFI_IPC_PAYLOAD_SIZE)
   {
-    /* create cmd data */
-    cbuf_size = sizeof(req_id) + sizeof(api_id) + cparams_size;
-
-#if MX_WIFI_TX_BUFFER_NO_COPY
-    if (api_id == MIPC_API_WIFI_BYPASS_OUT_CMD)
+    req = mipc_req_alloc(api_id, rbuffer, rbuffer_size, NULL, NULL);
+    if (NULL == req)
     {
-      cbuf = cparams - sizeof(req_id) - sizeof(api_id);
-      copy_buffer = false;
+      DEBUG_ERROR("Error: no free request slot for command 0x%04x\n", api_id);
+      ret = MIPC_CODE_NO_MEMORY;
     }
     else
-#endif /* MX_WIFI_TX_BUFFER_NO_COPY */
     {
-      cbuf = (uint8_t *)MX_WIFI_MALLOC(cbuf_size);
-    }
-
-    if (NULL != cbuf)
-    {
-      /* get an uniq identifier */
-      req_id = get_new_req_id();
-      /* copy the protocol parameter to the head part of the buffer */
-      pos = cbuf;
-      memcpy(pos, &req_id, sizeof(req_id));
-      pos += sizeof(req_id);
-      memcpy(pos, &api_id, sizeof(api_id));
-      pos += sizeof(api_id);
-
-      if ((true == copy_buffer) && (cparams_size > 0))
+      req_id = req->req_id;
+      ret = mipc_send(req, cparams, cparams_size);
+      if (MIPC_CODE_SUCCESS == ret)
       {
-        memcpy(pos, cparams, cparams_size);
+        /* wait for command answer */
+        if (SEM_WAIT(req->resp_flag, timeout_ms, mipc_poll) != SEM_OK)
+        {
+          ret = MIPC_CODE_TIMEOUT;
+        }
       }
 
-      /* a single pending request due to LOCK usage on command */
-      if (pending_request.req_id != 0xFFFFFFFF)
+      LOCK(pending_request_lock);
+      if ((MIPC_CODE_TIMEOUT == ret) && (true == req->answered))
       {
-        DEBUG_LOG("Error req_id must be 0xffffffff here %"PRIu32"\n", pending_request.req_id);
-        while (1);
+        /* the answer came in between the timeout and the lock, consume its signal */
+        (void) SEM_WAIT(req->resp_flag, 0, NULL);
+        ret = MIPC_CODE_SUCCESS;
       }
-      pending_request.req_id = req_id;
-      pending_request.rbuffer = rbuffer;
-      pending_request.rbuffer_size = rbuffer_size;
-      /* static int iter=0;                       */
-      /* printf("%d push %d\n",iter++,cbuf_size); */
-
-      /* send the command */
-      DEBUG_LOG("cmd %"PRIu32"\n", req_id);
-      ret = mx_wifi_hci_send(cbuf, cbuf_size);
-      if (ret == 0)
+      mipc_req_free(req);
+      UNLOCK(pending_request_lock);
+
+      if (MIPC_CODE_TIMEOUT == ret)
       {
-        /* wait for command answer */
-        if (SEM_WAIT(pending_request.resp_flag, timeout_ms, mipc_poll) != SEM_OK)
-        {
-          DEBUG_ERROR("Error: command 0x%04x timeout(%"PRIu32" ms) waiting answer %"PRIu32"\n",
-                      api_id, timeout_ms, pending_request.req_id);
-          pending_request.req_id = 0xFFFFFFFF;
-          ret = MIPC_CODE_ERROR;
-        }
+        DEBUG_ERROR("Error: command 0x%04x timeout(%"PRIu32" ms) waiting answer %"PRIu32"\n",
+                    api_id, timeout_ms, req_id);
+        ret = MIPC_CODE_ERROR;
       }
-      else
+      DEBUG_LOG("done %"PRIu32"\n", req_id);
+    }
+  }
+
+  return ret;
+}
+
+
+/**
+  * @brief                   post a request without waiting for its answer
+  * @param  api_id           command identifier
+  * @param  cparams          command parameters
+  * @param  cparams_size     command parameters size
+  * @param  rbuffer          buffer filled with the answer, must stay valid until the callback
+  * @param  rbuffer_size     in: rbuffer size, out: answer size
+  * @param  callback         called from the receive thread once the answer is in rbuffer
+  * @param  callback_arg     user argument passed to the callback
+  * @param  req_id           returns the request identifier, may be NULL
+  * @return int32_t          MIPC_CODE_SUCCESS if the command was sent
+  */
+int32_t mipc_request_async(uint16_t api_id, uint8_t *cparams, uint16_t cparams_size,
+                           uint8_t *rbuffer, uint16_t *rbuffer_size,
+                           mipc_resp_callback_t callback, void *callback_arg, uint32_t *req_id)
+{
+  int32_t ret = MIPC_CODE_ERROR;
+  mipc_req_t *req;
+  uint32_t id;
+
+  if ((NULL != callback) && (cparams_size <= MX_WIFI_IPC_PAYLOAD_SIZE))
+  {
+    req = mipc_req_alloc(api_id, rbuffer, rbuffer_size, callback, callback_arg);
+    if (NULL == req)
+    {
+      ret = MIPC_CODE_NO_MEMORY;
+    }
+    else
+    {
+      /* the answer may be processed before mipc_send returns */
+      id = req->req_id;
+      if (NULL != req_id)
       {
-        DEBUG_ERROR("Failed to send command to Hci\n");
-        while (1);
+        *req_id = id;
       }
-      DEBUG_LOG("done %"PRIu32"\n", req_id);
-      if (true == copy_buffer)
+
+      ret = mipc_send(req, cparams, cparams_size);
+      if (MIPC_CODE_SUCCESS != ret)
       {
-        MX_WIFI_FREE(cbuf);
+        (void) mipc_request_cancel(id);
       }
     }
   }
-  UNLOCK(wifi_obj_get()->lockcmd);
 
   return ret;
 }
 
 
+/**
+  * @brief                   forget a request posted by mipc_request_async
+  * @param  req_id           request identifier
+  * @return int32_t          MIPC_CODE_SUCCESS if the request was still pending,
+  *                          its callback will not be called
+  */
+int32_t mipc_request_cancel(uint32_t req_id)
+{
+  int32_t ret = MIPC_CODE_ERROR;
+  mipc_req_t *req;
+
+  LOCK(pending_request_lock);
+  req = mipc_req_find(req_id);
+  if ((NULL != req) && (NULL != req->callback))
+  {
+    mipc_req_free(req);
+    ret = MIPC_CODE_SUCCESS;
+  }
+  UNLOCK(pending_request_lock);
+
+  return ret;
+}
+
+
+/**
+  * @brief                   number of requests waiting for an answer
+  * @return uint32_t         pending request count
+  */
+uint32_t mipc_request_pending(void)
+{
+  uint32_t count = 0;
+  uint32_t i;
+
+  LOCK(pending_request_lock);
+  for (i = 0; i < (uint32_t)MIPC_REQ_LIST_SIZE; i++)
+  {
+    if (MIPC_REQ_ID_FREE != pending_request[i].req_id)
+    {
+      count++;
+    }
+  }
+  UNLOCK(pending_request_lock);
+
+  return count;
+}
+
+
 /**
   * @brief                   mipc poll
   * @param  timeout_ms       timeout in ms
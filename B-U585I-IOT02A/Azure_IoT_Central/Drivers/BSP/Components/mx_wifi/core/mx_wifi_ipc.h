@@ -157,6 +157,11 @@ extern "C" {
 /* Exported typedef ----------------------------------------------------------*/
 typedef uint16_t (*mipc_send_func_t)(uint8_t *data, uint16_t size);
 
+/* answer of an asynchronous request, called from the receive thread;
+ * it must not issue a blocking mipc_request() */
+typedef void (*mipc_resp_callback_t)(uint32_t req_id, int32_t status,
+                                     uint8_t *rbuffer, uint16_t rbuffer_size, void *arg);
+
 /* Exported functions --------------------------------------------------------*/
 
 /* MX_IPC */
@@ -166,6 +171,11 @@ int32_t mipc_deinit(void);
 /* ipc api request */
 int32_t mipc_request(uint16_t api_id, uint8_t *cparams, uint16_t cparams_size,
                      uint8_t *rbuffer, uint16_t *rbuffer_size, uint32_t timeout_ms);
+int32_t mipc_request_async(uint16_t api_id, uint8_t *cparams, uint16_t cparams_size,
+                           uint8_t *rbuffer, uint16_t *rbuffer_size,
+                           mipc_resp_callback_t callback, void *callback_arg, uint32_t *req_id);
+int32_t mipc_request_cancel(uint32_t req_id);
+uint32_t mipc_request_pending(void);
 
 /* ipc handle response/event */
 void mipc_poll(uint32_t timeout);
@@ -0,0 +1,565 @@
+/**
+  ******************************************************************************
+  * @file    mx_wifi_loopback.c
+  * @author  MCD Application Team
+  * @brief   Loopback bus answering the MXCHIP IPC requests without a module.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+
+/*****************************************************************************
+  * This file replaces mx_wifi_spi.c or mx_wifi_uart.c when MX_WIFI_USE_LOOPBACK
+  * is set. The frames sent by the HCI layer are decoded (raw frames for SPI,
+  * SLIP frames for UART) by a fake module thread which answers them after
+  * MX_WIFI_LOOPBACK_LATENCY_MS, encoded with the same framing and pushed
+  * through mx_wifi_hci_input as the real bus would.
+  *
+  * With MX_WIFI_LOOPBACK_REORDER set, the requests queued at the same time are
+  * answered last first, so the request id matching of mx_wifi_ipc.c is used.
+  *
+  * Nothing depends on the MCU, so the driver can run on a host with an OS port
+  * of mx_wifi_conf.h and be measured with mx_wifi_loopback_bench.
+  */
+/* Includes ------------------------------------------------------------------*/
+/* Private includes ----------------------------------------------------------*/
+#include <string.h>
+#include "mx_wifi.h"
+#include "core/mx_wifi_hci.h"
+#include "core/mx_wifi_slip.h"
+
+#if (MX_WIFI_USE_LOOPBACK == 1)
+
+#ifdef MX_WIFI_IO_DEBUG
+#define DEBUG_LOG(M, ...)       printf((M), ##__VA_ARGS__)
+#else
+#define DEBUG_LOG(M, ...)
+#endif /* MX_WIFI_IO_DEBUG */
+
+#define DEBUG_ERROR(M, ...)     printf((M), ##__VA_ARGS__)
+
+/* Private define ------------------------------------------------------------*/
+#ifndef MX_WIFI_LOOPBACK_LATENCY_MS
+#define MX_WIFI_LOOPBACK_LATENCY_MS             (1)
+#endif /* MX_WIFI_LOOPBACK_LATENCY_MS */
+
+#ifndef MX_WIFI_LOOPBACK_REORDER
+#define MX_WIFI_LOOPBACK_REORDER                (1)
+#endif /* MX_WIFI_LOOPBACK_REORDER */
+
+#ifndef MX_WIFI_LOOPBACK_QUEUE_SIZE
+#define MX_WIFI_LOOPBACK_QUEUE_SIZE             (8)
+#endif /* MX_WIFI_LOOPBACK_QUEUE_SIZE */
+
+#ifndef MX_WIFI_LOOPBACK_BENCH_MAX_THREADS
+#define MX_WIFI_LOOPBACK_BENCH_MAX_THREADS      (4)
+#endif /* MX_WIFI_LOOPBACK_BENCH_MAX_THREADS */
+
+#ifndef MX_WIFI_LOOPBACK_BENCH_STACK_SIZE
+#define MX_WIFI_LOOPBACK_BENCH_STACK_SIZE       (1024)
+#endif /* MX_WIFI_LOOPBACK_BENCH_STACK_SIZE */
+
+#define LOOPBACK_VERSION          ("loopback-1.0")
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct _loopback_frame_s
+{
+  uint16_t len;
+  uint8_t data[1];
+} loopback_frame_t;
+
+typedef struct _loopback_worker_s
+{
+  THREAD_DECLARE(thread);
+  SEM_DECLARE(start);
+  uint32_t requests;
+  uint16_t payload_size;
+  uint32_t done;
+  uint32_t errors;
+  uint32_t latency_min_us;
+  uint32_t latency_max_us;
+  uint64_t latency_sum_us;
+  uint32_t max_pending;
+} loopback_worker_t;
+
+/* Private variables ---------------------------------------------------------*/
+static MX_WIFIObject_t MxWifiObj;
+static FIFO_DECLARE(loopback_req_fifo);
+static THREAD_DECLARE(MX_WIFI_LoopbackThreadId);
+
+static loopback_worker_t loopback_worker[MX_WIFI_LOOPBACK_BENCH_MAX_THREADS];
+static uint32_t loopback_worker_count = 0;
+static SEM_DECLARE(loopback_bench_done);
+static mx_wifi_loopback_clock_t loopback_bench_clock = NULL;
+
+/* Private function prototypes -----------------------------------------------*/
+static void MX_WIFI_IO_DELAY(uint32_t ms);
+static int8_t MX_WIFI_LOOPBACK_Init(uint16_t mode);
+static int8_t MX_WIFI_LOOPBACK_DeInit(void);
+static uint16_t MX_WIFI_LOOPBACK_Write(uint8_t *data, uint16_t len);
+static uint16_t MX_WIFI_LOOPBACK_Read(uint8_t *buffer, uint16_t buff_size);
+
+static loopback_frame_t *loopback_frame_decode(uint8_t *data, uint16_t len);
+static void loopback_answer(loopback_frame_t *req);
+static void loopback_deliver(uint8_t *data, uint16_t len);
+static void mx_wifi_loopback_task(THREAD_CONTEXT_TYPE argument);
+static void mx_wifi_loopback_bench_task(THREAD_CONTEXT_TYPE argument);
+
+void process_txrx_poll(uint32_t timeout);
+
+
+static void MX_WIFI_IO_DELAY(uint32_t ms)
+{
+  DELAYms(ms);
+}
+
+
+static int8_t MX_WIFI_LOOPBACK_Init(uint16_t mode)
+{
+  int8_t ret = 0;
+
+  if (MX_WIFI_INIT == mode)
+  {
+    FIFO_INIT(loopback_req_fifo, MX_WIFI_LOOPBACK_QUEUE_SIZE);
+    if (THREAD_OK != THREAD_INIT(MX_WIFI_LoopbackThreadId, mx_wifi_loopback_task, NULL,
+                                 MX_WIFI_SPI_THREAD_STACK_SIZE,
+                                 MX_WIFI_SPI_THREAD_PRIORITY))
+    {
+      ret = -1;
+    }
+  }
+  return ret;
+}
+
+
+static int8_t MX_WIFI_LOOPBACK_DeInit(void)
+{
+  THREAD_DEINIT(MX_WIFI_LoopbackThreadId);
+  FIFO_DEINIT(loopback_req_fifo);
+  return 0;
+}
+
+
+/* module side of the bus, the frame is consumed before returning like the SPI write */
+static uint16_t MX_WIFI_LOOPBACK_Write(uint8_t *data, uint16_t len)
+{
+  loopback_frame_t *frame;
+
+  if ((NULL == data) || (0 == len))
+  {
+    return 0;
+  }
+
+  frame = loopback_frame_decode(data, len);
+  if (NULL == frame)
+  {
+    return 0;
+  }
+
+  if (FIFO_OK != FIFO_PUSH(loopback_req_fifo, frame, WAIT_FOREVER, NULL))
+  {
+    MX_WIFI_FREE(frame);
+    return 0;
+  }
+  return len;
+}
+
+
+static uint16_t MX_WIFI_LOOPBACK_Read(uint8_t *buffer, uint16_t buff_size)
+{
+  (void)buffer;
+  (void)buff_size;
+  return 0;
+}
+
+
+/* strip the bus framing, a SLIP frame is only used on UART */
+static loopback_frame_t *loopback_frame_decode(uint8_t *data, uint16_t len)
+{
+  loopback_frame_t *frame = (loopback_frame_t *)MX_WIFI_MALLOC(sizeof(loopback_frame_t) + len);
+
+  if (NULL != frame)
+  {
+#if (MX_WIFI_USE_SPI == 1)
+    memcpy(frame->data, data, len);
+    frame->len = len;
+#else
+    uint16_t i;
+    uint16_t j = 0;
+    bool escape = false;
+
+    for (i = 0; i < len; i++)
+    {
+      if ((SLIP_START == data[i]) || (SLIP_END == data[i]))
+      {
+        continue;
+      }
+      if (true == escape)
+      {
+        escape = false;
+        if (SLIP_ESCAPE_START == data[i])
+        {
+          frame->data[j++] = SLIP_START;
+        }
+        else if (SLIP_ESCAPE_END == data[i])
+        {
+          frame->data[j++] = SLIP_END;
+        }
+        else
+        {
+          frame->data[j++] = SLIP_ESCAPE;
+        }
+      }
+      else if (SLIP_ESCAPE == data[i])
+      {
+        escape = true;
+      }
+      else
+      {
+        frame->data[j++] = data[i];
+      }
+    }
+    frame->len = j;
+#endif /* MX_WIFI_USE_SPI */
+
+    if (frame->len < MIPC_HEADER_SIZE)
+    {
+      DEBUG_ERROR("loopback: short frame %d\n", frame->len);
+      MX_WIFI_FREE(frame);
+      frame = NULL;
+    }
+  }
+  return frame;
+}
+
+
+static void loopback_answer(loopback_frame_t *req)
+{
+  static const uint8_t loopback_mac[MX_WIFI_MAC_SIZE] = {0x02, 0x80, 0xE1, 0x00, 0x00, 0x01};
+  uint8_t *resp;
+  uint16_t resp_len = MIPC_HEADER_SIZE;
+  uint16_t api_id;
+  int32_t status = MIPC_CODE_SUCCESS;
+
+  resp = (uint8_t *)MX_WIFI_MALLOC(MIPC_PKT_MAX_SIZE);
+  if (NULL == resp)
+  {
+    DEBUG_ERROR("loopback: no memory for answer\n");
+    return;
+  }
+
+  /* same req_id and api_id as the request */
+  memcpy(resp, req->data, MIPC_HEADER_SIZE);
+  memcpy(&api_id, &req->data[MIPC_PKT_API_ID_OFFSET], sizeof(api_id));
+
+  switch (api_id)
+  {
+    case MIPC_API_SYS_ECHO_CMD:
+      memcpy(&resp[MIPC_PKT_PARAMS_OFFSET], &req->data[MIPC_PKT_PARAMS_OFFSET],
+             req->len - MIPC_HEADER_SIZE);
+      resp_len += req->len - MIPC_HEADER_SIZE;
+      break;
+
+    case MIPC_API_SYS_VERSION_CMD:
+      memcpy(&resp[MIPC_PKT_PARAMS_OFFSET], LOOPBACK_VERSION, sizeof(LOOPBACK_VERSION));
+      resp_len += sizeof(LOOPBACK_VERSION);
+      break;
+
+    case MIPC_API_WIFI_GET_MAC_CMD:
+      memcpy(&resp[MIPC_PKT_PARAMS_OFFSET], loopback_mac, sizeof(loopback_mac));
+      resp_len += sizeof(loopback_mac);
+      break;
+
+    default:
+      /* most commands answer a single status word */
+      memcpy(&resp[MIPC_PKT_PARAMS_OFFSET], &status, sizeof(status));
+      resp_len += sizeof(status);
+      break;
+  }
+
+  loopback_deliver(resp, resp_len);
+  MX_WIFI_FREE(resp);
+}
+
+
+/* host side of the bus, framed as the real module would */
+static void loopback_deliver(uint8_t *data, uint16_t len)
+{
+#if (MX_WIFI_USE_SPI == 1)
+  mx_buf_t *netb = MX_NET_BUFFER_ALLOC(MX_WIFI_BUFFER_SIZE);
+
+  if (NULL != netb)
+  {
+    memcpy(MX_NET_BUFFER_PAYLOAD(netb), data, len);
+    MX_NET_BUFFER_SET_PAYLOAD_SIZE(netb, len);
+    mx_wifi_hci_input(netb);
+  }
+  else
+  {
+    DEBUG_ERROR("loopback: running out of buffer for RX\n");
+  }
+#else
+  uint8_t *slip_frame;
+  uint16_t slip_len = 0;
+  uint16_t i;
+  mx_buf_t *nbuf;
+
+  slip_frame = slip_transfer(data, len, &slip_len);
+  if (NULL != slip_frame)
+  {
+    for (i = 0; i < slip_len; i++)
+    {
+      nbuf = slip_input_byte(slip_frame[i]);
+      if (NULL != nbuf)
+      {
+        mx_wifi_hci_input(nbuf);
+      }
+    }
+    MX_WIFI_FREE(slip_frame);
+  }
+#endif /* MX_WIFI_USE_SPI */
+}
+
+
+void process_txrx_poll(uint32_t timeout)
+{
+  loopback_frame_t *batch[MX_WIFI_LOOPBACK_QUEUE_SIZE];
+  uint32_t count = 0;
+  uint32_t i;
+
+  batch[0] = (loopback_frame_t *)FIFO_POP(loopback_req_fifo, timeout, NULL);
+  if (NULL == batch[0])
+  {
+    return;
+  }
+  count = 1;
+
+  /* emulated module processing time */
+  DELAYms(MX_WIFI_LOOPBACK_LATENCY_MS);
+
+#if (MX_WIFI_LOOPBACK_REORDER == 1)
+  /* everything queued meanwhile is answered in reverse order */
+  while (count < (uint32_t)MX_WIFI_LOOPBACK_QUEUE_SIZE)
+  {
+    batch[count] = (loopback_frame_t *)FIFO_POP(loopback_req_fifo, 0, NULL);
+    if (NULL == batch[count])
+    {
+      break;
+    }
+    count++;
+  }
+#endif /* MX_WIFI_LOOPBACK_REORDER */
+
+  for (i = count; i > 0u; i--)
+  {
+    loopback_answer(batch[i - 1u]);
+    MX_WIFI_FREE(batch[i - 1u]);
+  }
+}
+
+
+#ifndef MX_WIFI_BARE_OS_H
+static void mx_wifi_loopback_task(THREAD_CONTEXT_TYPE argument)
+{
+  (void)argument;
+
+  while (1)
+  {
+    process_txrx_poll(WAIT_FOREVER);
+  }
+}
+#endif /* MX_WIFI_BARE_OS_H */
+
+
+static void mx_wifi_loopback_bench_task(THREAD_CONTEXT_TYPE argument)
+{
+  loopback_worker_t *worker = &loopback_worker[(uint32_t)argument];
+  uint8_t *in;
+  uint8_t *out;
+  uint16_t out_len;
+  uint32_t pending;
+  uint32_t start;
+  uint32_t latency;
+  uint32_t i;
+
+  while (1)
+  {
+    (void) SEM_WAIT(worker->start, WAIT_FOREVER, NULL);
+
+    in = (uint8_t *)MX_WIFI_MALLOC(worker->payload_size);
+    out = (uint8_t *)MX_WIFI_MALLOC(worker->payload_size);
+    if ((NULL == in) || (NULL == out))
+    {
+      worker->errors = worker->requests;
+    }
+    else
+    {
+      for (i = 0; i < worker->requests; i++)
+      {
+        (void) memset(in, (int32_t)(i + (uint32_t)argument), worker->payload_size);
+        out_len = worker->payload_size;
+
+        pending = mipc_request_pending() + 1u;
+        if (pending > worker->max_pending)
+        {
+          worker->max_pending = pending;
+        }
+
+        start = loopback_bench_clock();
+        if ((MIPC_CODE_SUCCESS != mipc_echo(in, worker->payload_size, out, &out_len, MX_WIFI_CMD_TIMEOUT))
+            || (out_len != worker->payload_size) || (0 != memcmp(in, out, out_len)))
+        {
+          worker->errors++;
+          continue;
+        }
+        latency = loopback_bench_clock() - start;
+
+        worker->done++;
+        worker->latency_sum_us += latency;
+        if (latency < worker->latency_min_us)
+        {
+          worker->latency_min_us = latency;
+        }
+        if (latency > worker->latency_max_us)
+        {
+          worker->latency_max_us = latency;
+        }
+      }
+    }
+
+    MX_WIFI_FREE(in);
+    MX_WIFI_FREE(out);
+    (void) SEM_SIGNAL(loopback_bench_done);
+  }
+}
+
+
+int32_t mx_wifi_loopback_bench(uint32_t threads, uint32_t requests, uint16_t payload_size,
+                               mx_wifi_loopback_clock_t clock, mx_wifi_loopback_bench_t *result)
+{
+  uint64_t latency_sum = 0;
+  uint32_t start;
+  uint32_t i;
+
+  if ((0u == threads) || (threads > (uint32_t)MX_WIFI_LOOPBACK_BENCH_MAX_THREADS) ||
+      (0u == payload_size) || (payload_size > (uint16_t)MX_WIFI_IPC_PAYLOAD_SIZE) ||
+      (NULL == clock) || (NULL == result))
+  {
+    return -1;
+  }
+
+  /* the requesting threads are kept between runs */
+  if (0u == loopback_worker_count)
+  {
+    SEM_INIT(loopback_bench_done, MX_WIFI_LOOPBACK_BENCH_MAX_THREADS);
+  }
+  while (loopback_worker_count < threads)
+  {
+    SEM_INIT(loopback_worker[loopback_worker_count].start, 1);
+    if (THREAD_OK != THREAD_INIT(loopback_worker[loopback_worker_count].thread,
+                                 mx_wifi_loopback_bench_task, loopback_worker_count,
+                                 MX_WIFI_LOOPBACK_BENCH_STACK_SIZE,
+                                 OSPRIORITYNORMAL))
+    {
+      SEM_DEINIT(loopback_worker[loopback_worker_count].start);
+      return -1;
+    }
+    loopback_worker_count++;
+  }
+
+  (void) memset(result, 0, sizeof(*result));
+  result->latency_min_us = UINT32_MAX;
+  loopback_bench_clock = clock;
+
+  for (i = 0; i < threads; i++)
+  {
+    loopback_worker[i].requests = requests;
+    loopback_worker[i].payload_size = payload_size;
+    loopback_worker[i].done = 0;
+    loopback_worker[i].errors = 0;
+    loopback_worker[i].latency_min_us = UINT32_MAX;
+    loopback_worker[i].latency_max_us = 0;
+    loopback_worker[i].latency_sum_us = 0;
+    loopback_worker[i].max_pending = 0;
+  }
+
+  start = clock();
+  for (i = 0; i < threads; i++)
+  {
+    (void) SEM_SIGNAL(loopback_worker[i].start);
+  }
+  for (i = 0; i < threads; i++)
+  {
+    (void) SEM_WAIT(loopback_bench_done, WAIT_FOREVER, NULL);
+  }
+  result->elapsed_us = clock() - start;
+
+  for (i = 0; i < threads; i++)
+  {
+    result->requests += loopback_worker[i].done;
+    result->errors += loopback_worker[i].errors;
+    latency_sum += loopback_worker[i].latency_sum_us;
+    if (loopback_worker[i].latency_min_us < result->latency_min_us)
+    {
+      result->latency_min_us = loopback_worker[i].latency_min_us;
+    }
+    if (loopback_worker[i].latency_max_us > result->latency_max_us)
+    {
+      result->latency_max_us = loopback_worker[i].latency_max_us;
+    }
+    if (loopback_worker[i].max_pending > result->max_pending)
+    {
+      result->max_pending = loopback_worker[i].max_pending;
+    }
+  }
+  if (result->requests > 0u)
+  {
+    result->latency_avg_us = (uint32_t)(latency_sum / result->requests);
+  }
+  else
+  {
+    result->latency_min_us = 0;
+  }
+
+  DEBUG_LOG("loopback bench: %"PRIu32" requests in %"PRIu32" us\n", result->requests, result->elapsed_us);
+  return (0u == result->errors) ? 0 : -1;
+}
+
+
+/**
+  * @brief  probe function to register wifi to connectivity framwotk
+  * @param  None
+  * @retval None
+  */
+int32_t mxwifi_probe(void **ll_drv_context)
+{
+  if (MX_WIFI_RegisterBusIO(&MxWifiObj,
+                            MX_WIFI_LOOPBACK_Init,
+                            MX_WIFI_LOOPBACK_DeInit,
+                            MX_WIFI_IO_DELAY,
+                            MX_WIFI_LOOPBACK_Write,
+                            MX_WIFI_LOOPBACK_Read) == 0)
+  {
+    *ll_drv_context = &MxWifiObj;
+    return 0;
+  }
+
+  return -1;
+}
+
+
+MX_WIFIObject_t *wifi_obj_get(void)
+{
+  return &MxWifiObj;
+}
+
+#endif /* MX_WIFI_USE_LOOPBACK */
@@ -68,7 +68,7 @@ typedef struct _spi_header
 #endif /* MX_WIFI_RESET_PIN */
 
 
-#if (MX_WIFI_USE_SPI == 1)
+#if (MX_WIFI_USE_SPI == 1) && (MX_WIFI_USE_LOOPBACK == 0)
 
 #ifndef NET_PERF_TASK_TAG
 #define NET_PERF_TASK_TAG(...)
@@ -84,6 +84,7 @@ typedef struct _spi_header
 #define SPI_WRITE_SLAVE_IDLE_TIMEOUT    (100)
 #define SPI_WRITE_DATA_TIMEOUT          (100)
 #define SPI_READ_DATA_TIMEOUT           (100)
+#define SPI_WRITE_COMPLETE_TIMEOUT      (MX_WIFI_CMD_TIMEOUT)
 
 /* HW RESET */
 
@@ -138,6 +139,7 @@ static uint16_t MX_WIFI_SPI_Write(uint8_t *data, uint16_t len);
 static SEM_DECLARE(spi_txrx_sem);
 static SEM_DECLARE(spi_flow_rise_sem);
 static SEM_DECLARE(spi_transfer_done_sem);
+static SEM_DECLARE(spi_tx_done_sem);
 
 static uint8_t *spi_tx_data = NULL;
 static uint16_t spi_tx_len  = 0;
@@ -259,6 +261,21 @@ static uint16_t MX_WIFI_SPI_Write(uint8_t *data, uint16_t len)
     DEBUG_WARNING("Warning, spi semaphore has been already notified\n");
   }
 
+  /* several requests may be in flight, so the frame must be on the bus
+   * before the next writer can reuse spi_tx_data and the caller its buffer */
+  if (SEM_WAIT(spi_tx_done_sem, SPI_WRITE_COMPLETE_TIMEOUT, process_txrx_poll) != SEM_OK)
+  {
+    DEBUG_ERROR("spi write timeout\r\n");
+    spi_tx_data = NULL;
+    spi_tx_len = 0;
+    len = 0;
+
+    /* a transfer completing after the timeout would release the next write early */
+    while (SEM_WAIT(spi_tx_done_sem, 0, NULL) == SEM_OK)
+    {
+    }
+  }
+
   return len;
 }
 
@@ -472,6 +489,7 @@ void process_txrx_poll(uint32_t timeout)
       {
         ret = Transmit(hspi_mx, txdata, datalen, timeout);
       }
+      SEM_SIGNAL(spi_tx_done_sem);
     }
     else
     {
@@ -518,6 +536,7 @@ static int8_t mx_wifi_spi_txrx_start(void)
   SEM_INIT(spi_txrx_sem, 2);
   SEM_INIT(spi_flow_rise_sem, 1);
   SEM_INIT(spi_transfer_done_sem, 1);
+  SEM_INIT(spi_tx_done_sem, 1);
 
   if (THREAD_OK != THREAD_INIT(MX_WIFI_TxRxThreadId, mx_wifi_spi_txrx_task, NULL,
                                MX_WIFI_SPI_THREAD_STACK_SIZE,
@@ -533,6 +552,7 @@ static int8_t mx_wifi_spi_txrx_stop(void)
   THREAD_DEINIT(MX_WIFI_TxRxThreadId);
   SEM_DEINIT(spi_txrx_sem);
   SEM_DEINIT(spi_flow_rise_sem);
+  SEM_DEINIT(spi_tx_done_sem);
   return 0;
 }
 
@@ -564,4 +584,4 @@ MX_WIFIObject_t *wifi_obj_get(void)
   return &MxWifiObj;
 }
 
-#endif /* (MX_WIFI_USE_SPI == 1) */
+#endif /* (MX_WIFI_USE_SPI == 1) && (MX_WIFI_USE_LOOPBACK == 0) */
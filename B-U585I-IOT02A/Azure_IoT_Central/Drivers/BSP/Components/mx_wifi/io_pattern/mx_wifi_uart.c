@@ -71,7 +71,7 @@ void debug_print(int8_t *prefix, uint8_t *data, uint16_t len)
 #define debug_print(...)
 #endif /* DEBUG_UART_DATA */
 
-#if (MX_WIFI_USE_SPI == 0)
+#if (MX_WIFI_USE_SPI == 0) && (MX_WIFI_USE_LOOPBACK == 0)
 
 /* Private define ------------------------------------------------------------*/
 #define MX_WIFI_HW_RESET() \
@@ -318,4 +318,4 @@ MX_WIFIObject_t *wifi_obj_get(void)
 {
   return &MxWifiObj;
 }
-#endif /* MX_WIFI_USE_SPI */
+#endif /* (MX_WIFI_USE_SPI == 0) && (MX_WIFI_USE_LOOPBACK == 0) */
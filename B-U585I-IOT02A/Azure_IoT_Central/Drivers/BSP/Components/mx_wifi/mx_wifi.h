@@ -400,6 +400,52 @@ MX_WIFI_STATUS_T MX_WIFI_IO_YIELD(MX_WIFIObject_t *Obj, uint32_t timeout);
   * @} **
   */
 
+#if (MX_WIFI_USE_LOOPBACK == 1)
+/**
+  * @defgroup MX_WIFI_LOOPBACK Loopback bus
+  * @brief Fake module answering IPC requests, to measure the host driver alone
+  * @{ **
+  */
+
+/**
+  * @brief Free running clock used by the loopback benchmark, in microseconds.
+  */
+typedef uint32_t (*mx_wifi_loopback_clock_t)(void);
+
+/**
+  * @brief Loopback benchmark result.
+  */
+typedef struct
+{
+  uint32_t requests;            /**< answered requests. */
+  uint32_t errors;              /**< failed or mismatched requests. */
+  uint32_t elapsed_us;          /**< wall time of the whole run. */
+  uint32_t latency_min_us;      /**< fastest request round trip. */
+  uint32_t latency_max_us;      /**< slowest request round trip. */
+  uint32_t latency_avg_us;      /**< mean request round trip. */
+  uint32_t max_pending;         /**< highest number of requests seen in flight. */
+} mx_wifi_loopback_bench_t;
+
+/**
+  * @brief Run echo requests from several threads at once over the loopback bus.
+  * @param threads number of requesting threads, up to MX_WIFI_LOOPBACK_BENCH_MAX_THREADS
+  * @param requests number of requests issued by each thread
+  * @param payload_size echo payload size
+  * @param clock microsecond clock
+  * @param result filled with the measurements
+  *
+  * @return result
+  * @retval 0 success
+  * @retval others failure
+  */
+int32_t mx_wifi_loopback_bench(uint32_t threads, uint32_t requests, uint16_t payload_size,
+                               mx_wifi_loopback_clock_t clock, mx_wifi_loopback_bench_t *result);
+
+/**
+  * @} **
+  */
+#endif /* MX_WIFI_USE_LOOPBACK */
+
 /**
   * @defgroup MX_WIFI_NETWORK_BYPASS_MODE Network bypass mode
   * @brief Network bypass mode API
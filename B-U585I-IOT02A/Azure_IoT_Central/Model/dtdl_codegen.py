@@ -0,0 +1,761 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022 Microsoft.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Generate the C serializers and writable property parser of a DTDL v2 interface.
+
+Telemetry and properties of the interface become C structs and append functions
+for the NetX Duo Azure IoT JSON writer. Names are emitted as constants with
+their lengths, and each serializer has a worst case size known at compile time.
+Objects are formatted from precomputed fragments, the names and punctuation
+between two values, and go to the writer in a single call that does not read
+them back. Writable properties are looked up through a perfect hash, searched
+here and confirmed by a single compare on the device.
+
+Components, arrays, maps and string writable properties are left to the
+application. From the Model folder:
+
+    python3 dtdl_codegen.py stm32-b-u585i-iot02a.json ../NetXDuo/App --integer-digits 7
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+# Largest integer part the JSON writer prints is 2^53 - 1
+MAX_INTEGER_DIGITS = 16
+INT32_MAX_SIZE = len(str(-(2**31)))
+
+FNV_OFFSET_BASIS = 0x811C9DC5
+FNV_PRIME = 16777619
+MASK32 = 0xFFFFFFFF
+
+COLUMN_LIMIT = 120
+
+
+class Field:
+    def __init__(self, name, schema, path):
+        self.name = name
+        self.path = path
+        self.schema = schema
+
+
+def type_name(prefix, path):
+    return "%s_%s" % (prefix.upper(), "_".join(path).upper())
+
+
+def fnv1a(seed, name):
+    hash = seed
+
+    for byte in name:
+        hash = ((hash ^ byte) * FNV_PRIME) & MASK32
+
+    return hash
+
+
+def call(head, args, tail, indent=""):
+    """Lay out a call or declaration the way the tree's clang-format does, continuation lines
+    are indented from indent"""
+    line = "%s%s(%s)%s" % (indent, head, ", ".join(args), tail)
+
+    if len(line) <= COLUMN_LIMIT:
+        return [line]
+
+    line = "%s    %s)%s" % (indent, ", ".join(args), tail)
+
+    if len(line) <= COLUMN_LIMIT:
+        return ["%s%s(" % (indent, head), line]
+
+    return ["%s%s(" % (indent, head)] + ["%s    %s," % (indent, a) for a in args[:-1]] + [
+        "%s    %s)%s" % (indent, args[-1], tail)]
+
+
+def declaration(head, params, tail):
+    """Parameters one per line, names aligned on the first one"""
+    lines = call(head, params, tail)
+
+    if len(lines) <= 2:
+        return lines
+
+    split = [p.rsplit(" ", 1) for p in params]
+    column = len(head) + 1 + len(split[0][0]) + 1
+    lines = ["%s(%s," % (head, params[0])]
+
+    for type, name in split[1:]:
+        lines.append("    %s%s," % (type.ljust(column - 4), name))
+
+    lines[-1] = lines[-1][:-1] + ")" + tail
+    return lines
+
+
+def aligned(lines, separator):
+    """Align the text following the last separator, as AlignConsecutive* does"""
+    split = [line.rsplit(separator, 1) for line in lines]
+    width = max(len(left) for left, _ in split)
+    return ["%s%s%s" % (left.ljust(width), separator, right) for left, right in split]
+
+
+class Generator:
+    def __init__(self, interface, prefix, integer_digits, fractional_digits):
+        self.interface = interface
+        self.prefix = prefix
+        self.integer_digits = integer_digits
+        self.fractional_digits = fractional_digits
+        self.names = []
+        self.objects = []
+        self.object_types = {}
+        self.enums = []
+
+        self.telemetry = []
+        self.properties = []
+        self.writable = []
+
+        for content in interface["contents"]:
+            kinds = content["@type"] if isinstance(content["@type"], list) else [content["@type"]]
+
+            if "Component" in kinds:
+                continue
+
+            field = self.field(content["name"], content["schema"], [content["name"]])
+
+            if "Telemetry" in kinds:
+                self.telemetry.append(field)
+            elif "Property" in kinds:
+                self.properties.append(field)
+
+                if content.get("writable", False):
+                    if field.schema["kind"] in ("string", "object"):
+                        raise ValueError("%s: writable %s is not supported" % (field.name, field.schema["kind"]))
+
+                    self.writable.append(field)
+
+        # The hash reads the length, first and last bytes of a name when they tell the writable
+        # properties apart, as the properties of a model usually are, and every byte otherwise
+        keys = set((len(f.name), f.name[0], f.name[-1]) for f in self.writable)
+        self.short_key = len(keys) == len(self.writable)
+
+    def field(self, name, schema, path):
+        # Names go out as is, without JSON escaping, and name the C members
+        if not re.match(r"^[A-Za-z][A-Za-z0-9_]*$", name):
+            raise ValueError("%s: name is not a C identifier" % name)
+
+        if name not in self.names:
+            self.names.append(name)
+
+        if isinstance(schema, str):
+            if schema not in ("double", "float", "integer", "long", "boolean", "string"):
+                raise ValueError("%s: schema %s is not supported" % (name, schema))
+
+            return Field(name, {"kind": schema}, path)
+
+        kind = schema["@type"]
+
+        if kind == "Object":
+            fields = [self.field(f["name"], f["schema"], path + [f["name"]]) for f in schema["fields"]]
+            shape = json.dumps(schema["fields"], sort_keys=True)
+
+            # Objects of the same shape share the type of the first one
+            if shape not in self.object_types:
+                self.object_types[shape] = type_name(self.prefix, path)
+                self.objects.append((self.object_types[shape], fields))
+
+            return Field(name, {"kind": "object", "type": self.object_types[shape], "fields": fields}, path)
+
+        if kind == "Enum":
+            if schema["valueSchema"] != "integer":
+                raise ValueError("%s: only integer enums are supported" % name)
+
+            values = [(v["name"], v["enumValue"]) for v in schema["enumValues"]]
+            enum = {"kind": "enum", "type": type_name(self.prefix, path), "values": values}
+            self.enums.append(enum)
+            return Field(name, enum, path)
+
+        raise ValueError("%s: schema %s is not supported" % (name, kind))
+
+    def max_size(self, field, integer_digits=None):
+        """Worst case bytes of "name":value, None when unbounded"""
+        kind = field.schema["kind"]
+        integer_digits = integer_digits or self.integer_digits
+
+        if kind in ("double", "float"):
+            value = 1 + integer_digits + (1 + self.fractional_digits if self.fractional_digits > 0 else 0)
+        elif kind in ("integer", "long"):
+            value = INT32_MAX_SIZE
+        elif kind == "boolean":
+            value = len("false")
+        elif kind == "enum":
+            value = max(len(str(v)) for _, v in field.schema["values"])
+        elif kind == "object":
+            sizes = [self.max_size(f, integer_digits) for f in field.schema["fields"]]
+            if None in sizes:
+                return None
+            value = 2 + sum(sizes) + len(sizes) - 1
+        else:
+            return None
+
+        return len(field.name) + 3 + value
+
+    def c_type(self, field):
+        kind = field.schema["kind"]
+
+        if kind in ("double", "float"):
+            return "double"
+        if kind in ("integer", "long"):
+            return "int32_t"
+        if kind == "boolean":
+            return "bool"
+        if kind == "string":
+            return "const CHAR*"
+        return field.schema["type"]
+
+    def parameter(self, field):
+        if field.schema["kind"] == "object":
+            return "const %s* %s" % (field.schema["type"], field.name)
+
+        return "%s %s" % (self.c_type(field), field.name)
+
+    def writable_type(self, field):
+        # The reader hands booleans back as UINT
+        return "UINT" if field.schema["kind"] == "boolean" else self.c_type(field)
+
+    def object_function(self, type, verb="append"):
+        return "%s_%s" % (verb, type[len(self.prefix) + 1:].lower())
+
+    def nested_types(self, field):
+        """The type of an object and of the objects within it"""
+        types = [field.schema["type"]]
+
+        for f in field.schema["fields"]:
+            if f.schema["kind"] == "object":
+                types += self.nested_types(f)
+
+        return types
+
+    def leaves(self, field):
+        return [kind for kind, _ in self.fragments(field, "") if kind != "text"]
+
+    def fragments(self, field, member):
+        """The value of an object as the text between the values of its members, member being the
+        C expression of the object followed by its member operator"""
+        pieces = [("text", "{")]
+
+        for index, f in enumerate(field.schema["fields"]):
+            pieces.append(("text", "%s\\\"%s\\\":" % ("," if index > 0 else "", f.name)))
+
+            if f.schema["kind"] == "object":
+                pieces += self.fragments(f, "%s%s." % (member, f.name))
+            else:
+                pieces.append((f.schema["kind"], member + f.name))
+
+        pieces.append(("text", "}"))
+
+        # Consecutive text is copied at once
+        merged = []
+        for piece in pieces:
+            if merged and piece[0] == "text" and merged[-1][0] == "text":
+                merged[-1] = ("text", merged[-1][1] + piece[1])
+            else:
+                merged.append(piece)
+
+        return merged
+
+    def formatted(self, field):
+        return field.schema["kind"] == "object" and self.max_size(field) is not None
+
+    def format_size(self, field):
+        """Bytes of the formatted value of an object for any double the JSON writer prints"""
+        return self.max_size(field, MAX_INTEGER_DIGITS) - len(field.name) - 3
+
+    def format_lines(self, field):
+        out = []
+
+        for kind, text in self.fragments(field, "value->"):
+            if kind == "text":
+                out.append("  json = FRAGMENT_COPY(json, \"%s\");" % text)
+            elif kind in ("double", "float"):
+                out.append("  json = double_format(json, %s);" % text)
+            elif kind == "boolean":
+                out.append("  json = %s ? FRAGMENT_COPY(json, \"true\") : FRAGMENT_COPY(json, \"false\");" % text)
+            else:
+                out.append("  json = int32_format(json, (int32_t)%s);" % text)
+
+        out[-1] = out[-1].replace("  json = ", "  return ")
+        return out
+
+    def append(self, field, value, head, tail, indent):
+        """Append "name":value, value being a C expression of the field"""
+        kind = field.schema["kind"]
+        name = "name_%s" % field.name
+        args = ["json_writer", name, "sizeof(%s) - 1" % name]
+
+        if kind in ("double", "float"):
+            function = "nx_azure_iot_json_writer_append_property_with_double_value"
+            args += [value, str(self.fractional_digits)]
+        elif kind in ("integer", "long", "enum"):
+            function = "nx_azure_iot_json_writer_append_property_with_int32_value"
+            args += [value]
+        elif kind == "boolean":
+            function = "nx_azure_iot_json_writer_append_property_with_bool_value"
+            args += [value]
+        elif kind == "string":
+            function = "nx_azure_iot_json_writer_append_property_with_string_value"
+            args += ["(const UCHAR*)%s" % value, "strlen(%s)" % value]
+        else:
+            function = self.object_function(field.schema["type"])
+            args += [value]
+
+        return call(head + function, args, tail, indent)
+
+    def header(self, banner_lines):
+        guard = "__%s_H__" % self.prefix.upper()
+        prefix = self.prefix.upper()
+        out = list(banner_lines)
+
+        out.append("/* Define to prevent recursive inclusion -------------------------------------*/")
+        out.append("#ifndef %s" % guard)
+        out.append("#define %s" % guard)
+        out.append("")
+        out.append("#ifdef __cplusplus")
+        out.append("extern \"C\"")
+        out.append("{")
+        out.append("#endif")
+        out.append("")
+        out.append("/* Includes ------------------------------------------------------------------*/")
+        out.append("#include <stdbool.h>")
+        out.append("#include <stdint.h>")
+        out.append("")
+        out.append("#include \"nx_azure_iot_json_reader.h\"")
+        out.append("#include \"nx_azure_iot_json_writer.h\"")
+        out.append("")
+        out.append("/* Exported constants --------------------------------------------------------*/")
+        out.append("#define %s_ID \"%s\"" % (prefix, self.interface["@id"]))
+        out.append("")
+        out.append("/* Worst case bytes appended by each serializer, separating comma included.")
+        out.append("   Doubles are bounded to %d integer and %d fractional digits. */" % (
+            self.integer_digits, self.fractional_digits))
+
+        sizes = []
+        telemetry = 0
+        for field in self.telemetry + self.properties:
+            size = self.max_size(field)
+            if size is not None:
+                sizes.append("#define %s_MAX_SIZE %d" % (type_name(self.prefix, field.path), size + 1))
+                if field in self.telemetry:
+                    telemetry += size + 1
+
+        out += aligned(sizes, " ")
+        out.append("")
+        out.append("/* Every telemetry above in one object */")
+        out.append("#define %s_TELEMETRY_MAX_SIZE %d" % (prefix, 2 + telemetry - 1))
+        out.append("")
+        out.append("/* Exported types ------------------------------------------------------------*/")
+
+        for enum in self.enums:
+            out.append("typedef enum %s_ENUM" % enum["type"])
+            out.append("{")
+            out += aligned(["  %s_%s = %d," % (enum["type"], name.upper(), value) for name, value in enum["values"]],
+                           " = ")
+            out.append("} %s;" % enum["type"])
+            out.append("")
+
+        for type, fields in self.objects:
+            out.append("typedef struct %s_STRUCT" % type)
+            out.append("{")
+            out += aligned(["  %s %s;" % (self.c_type(f), f.name) for f in fields], " ")
+            out.append("} %s;" % type)
+            out.append("")
+
+        out.append("typedef enum %s_WRITABLE_ENUM" % prefix)
+        out.append("{")
+        for field in self.writable:
+            out.append("  %s_WRITABLE_%s," % (prefix, field.name.upper()))
+        out.append("  %s_WRITABLE_COUNT" % prefix)
+        out.append("} %s_WRITABLE;" % prefix)
+        out.append("")
+        out.append("/* Last value received for each writable property */")
+        out.append("typedef struct %s_WRITABLE_PROPERTIES_STRUCT" % prefix)
+        out.append("{")
+        out += aligned(["  %s %s;" % (self.writable_type(f), f.name) for f in self.writable], " ")
+        out.append("} %s_WRITABLE_PROPERTIES;" % prefix)
+        out.append("")
+        out.append("/* Exported functions prototypes ---------------------------------------------*/")
+        out.append("")
+        out.append("/* Append \"name\":value to an open object, for telemetry and reported properties */")
+
+        for field in self.telemetry + self.properties:
+            out += call("UINT %s_append_%s" % (self.prefix, field.name),
+                        ["NX_AZURE_IOT_JSON_WRITER* json_writer", self.parameter(field)], ";")
+
+        out.append("")
+        out.append("/* Store the value of the writable property name, the reader is on the value. Returns")
+        out.append("   NX_AZURE_IOT_NOT_FOUND for a name outside the model and NX_NOT_SUCCESSFUL for a value")
+        out.append("   outside its schema. */")
+        out += declaration("UINT %s_writable_property_parse" % self.prefix, self.parse_parameters(), ";")
+        out.append("")
+        out.append("#ifdef __cplusplus")
+        out.append("}")
+        out.append("#endif")
+        out.append("#endif /* %s */" % guard)
+        return "\n".join(out) + "\n"
+
+    def parse_parameters(self):
+        prefix = self.prefix.upper()
+        return ["const UCHAR* name", "UINT name_length", "NX_AZURE_IOT_JSON_READER* json_reader",
+                "%s_WRITABLE_PROPERTIES* properties" % prefix, "%s_WRITABLE* property" % prefix]
+
+    def perfect_hash(self):
+        """Seed and table size that give each writable property a slot of its own"""
+        names = [f.name.encode() for f in self.writable]
+        bits = 1
+
+        while (1 << bits) < len(names):
+            bits += 1
+
+        while True:
+            for seed in range(FNV_OFFSET_BASIS, FNV_OFFSET_BASIS + (1 << 16)):
+                slots = set(self.slot(seed, bits, n) for n in names)
+                if len(slots) == len(names):
+                    return seed, bits
+            bits += 1
+
+    def slot(self, seed, bits, name):
+        key = [len(name), name[0], name[-1]] if self.short_key else name
+        # The high bits are the best mixed, the low ones only see the low bits of each byte
+        return fnv1a(seed, key) >> (32 - bits)
+
+    def source(self, banner_lines):
+        prefix = self.prefix.upper()
+        seed, bits = self.perfect_hash()
+        out = list(banner_lines)
+
+        out.append("")
+        out.append("/* Includes ------------------------------------------------------------------*/")
+        out.append("#include \"%s.h\"" % self.prefix)
+        out.append("")
+        out.append("#include <string.h>")
+        out.append("")
+        out.append("#include \"nx_azure_iot.h\"")
+        out.append("")
+        # Objects with every member bounded are formatted from fragments, one function per type
+        formatted = []
+        chained = set()
+        for field in self.telemetry + self.properties:
+            if self.formatted(field):
+                if field.schema["type"] not in [f.schema["type"] for f in formatted]:
+                    formatted.append(field)
+            elif field.schema["kind"] == "object":
+                chained.update(self.nested_types(field))
+
+        leaves = set(kind for f in formatted for kind in self.leaves(f))
+        doubles = bool(leaves & set(["double", "float"]))
+        integers = bool(leaves & set(["integer", "long", "enum"]))
+
+        out.append("/* Private define ------------------------------------------------------------*/")
+        out += aligned(["#define WRITABLE_HASH_SEED 0x%08XU" % seed, "#define WRITABLE_HASH_BITS %d" % bits],
+                       " ")
+        out.append("")
+
+        if formatted:
+            defines = []
+            if doubles:
+                defines.append("#define FRACTIONAL_DIGITS %d" % self.fractional_digits)
+                defines.append("#define DOUBLE_MAX_SIZE %d" % (
+                    1 + MAX_INTEGER_DIGITS + (1 + self.fractional_digits if self.fractional_digits > 0 else 0)))
+            if integers:
+                defines.append("#define INT32_MAX_SIZE %d" % INT32_MAX_SIZE)
+            for f in formatted:
+                defines.append("#define %s_FORMAT_SIZE %d" % (f.schema["type"][len(self.prefix) + 1:],
+                                                              self.format_size(f)))
+
+            out.append("/* Formatted objects, for any value the JSON writer prints */")
+            out += aligned(defines, " ")
+            out.append("")
+            out.append("/* Copy a fragment, the text between two values of an object */")
+            out.append("#define FRAGMENT_COPY(json, fragment) fragment_copy((json), (fragment), sizeof(fragment) - 1)")
+            out.append("")
+        out.append("/* Private typedef -----------------------------------------------------------*/")
+        out.append("typedef struct WRITABLE_ENTRY_STRUCT")
+        out.append("{")
+        out.append("  const UCHAR* name;")
+        out.append("  UINT         name_length;")
+        out.append("  UINT (*parse)(NX_AZURE_IOT_JSON_READER* json_reader, %s_WRITABLE_PROPERTIES* properties);" % prefix)
+        out.append("  %s_WRITABLE property;" % prefix)
+        out.append("} WRITABLE_ENTRY;")
+        out.append("")
+        out.append("/* Private variables ---------------------------------------------------------*/")
+        # Members of formatted objects are in their fragments
+        used = set(f.name for f in self.telemetry + self.properties)
+        for type, fields in self.objects:
+            if type in chained:
+                used.update(f.name for f in fields)
+
+        out += aligned(["static const UCHAR name_%s[] = \"%s\";" % (name, name) for name in self.names if name in used],
+                       " = ")
+
+        if formatted:
+            out.append("")
+            out.append("/* A null json is a value that could not be formatted, it stays null to the end of the object */")
+            out.append("static UCHAR* fragment_copy(UCHAR* json, const CHAR* fragment, UINT length)")
+            out.append("{")
+            out.append("  if (json == NX_NULL)")
+            out.append("  {")
+            out.append("    return NX_NULL;")
+            out.append("  }")
+            out.append("")
+            out.append("  memcpy(json, fragment, length);")
+            out.append("  return json + length;")
+            out.append("}")
+
+        for name, size, function, args in (
+                ("double", "DOUBLE_MAX_SIZE", "az_span_dtoa", "value, FRACTIONAL_DIGITS, &remainder"),
+                ("int32", "INT32_MAX_SIZE", "az_span_i32toa", "value, &remainder")):
+            if not (doubles if name == "double" else integers):
+                continue
+
+            out.append("")
+            out.append("/* The value as the JSON writer prints it */")
+            out.append("static UCHAR* %s_format(UCHAR* json, %s value)" % (name, "double" if name == "double" else "int32_t"))
+            out.append("{")
+            out.append("  az_span remainder;")
+            out.append("")
+            out.append("  if ((json == NX_NULL) ||")
+            out.append("      az_result_failed(%s(az_span_create(json, %s), %s)))" % (function, size, args))
+            out.append("  {")
+            out.append("    return NX_NULL;")
+            out.append("  }")
+            out.append("")
+            out.append("  return az_span_ptr(remainder);")
+            out.append("}")
+
+        for field in formatted:
+            type = field.schema["type"]
+            out.append("")
+            out += declaration("static UCHAR* %s" % self.object_function(type, "format"),
+                               ["UCHAR* json", "const %s* value" % type], "")
+            out.append("{")
+            out += self.format_lines(field)
+            out.append("}")
+            out.append("")
+            out += declaration("static UINT %s" % self.object_function(type),
+                               ["NX_AZURE_IOT_JSON_WRITER* json_writer", "const UCHAR* name", "UINT name_length",
+                                "const %s* value" % type], "")
+            out.append("{")
+            out.append("  UCHAR  json[%s_FORMAT_SIZE];" % type[len(self.prefix) + 1:])
+            out.append("  UCHAR* end = %s(json, value);" % self.object_function(type, "format"))
+            out.append("")
+            out.append("  if ((end == NX_NULL) || nx_azure_iot_json_writer_append_property_name(json_writer, name, name_length) ||")
+            out += call("nx_azure_iot_json_writer_append_json_text_trusted",
+                        ["json_writer", "json", "(UINT)(end - json)", "AZ_JSON_TOKEN_END_OBJECT"], ")", "      ")
+            out.append("  {")
+            out.append("    return NX_NOT_SUCCESSFUL;")
+            out.append("  }")
+            out.append("")
+            out.append("  return NX_AZURE_IOT_SUCCESS;")
+            out.append("}")
+
+        for type, fields in self.objects:
+            if type not in chained:
+                continue
+
+            out.append("")
+            out += declaration("static UINT %s" % self.object_function(type),
+                               ["NX_AZURE_IOT_JSON_WRITER* json_writer", "const UCHAR* name", "UINT name_length",
+                                "const %s* value" % type], "")
+            out.append("{")
+            out.append("  if (nx_azure_iot_json_writer_append_property_name(json_writer, name, name_length) ||")
+            out.append("      nx_azure_iot_json_writer_append_begin_object(json_writer) ||")
+            for f in fields:
+                value = "&value->%s" % f.name if f.schema["kind"] == "object" else "value->%s" % f.name
+                out += self.append(f, value, "", " ||", "      ")
+            out.append("      nx_azure_iot_json_writer_append_end_object(json_writer))")
+            out.append("  {")
+            out.append("    return NX_NOT_SUCCESSFUL;")
+            out.append("  }")
+            out.append("")
+            out.append("  return NX_AZURE_IOT_SUCCESS;")
+            out.append("}")
+
+        for field in self.writable:
+            kind = field.schema["kind"]
+            out.append("")
+            out += call("static UINT parse_%s" % field.name,
+                        ["NX_AZURE_IOT_JSON_READER* json_reader", "%s_WRITABLE_PROPERTIES* properties" % prefix], "")
+            out.append("{")
+
+            if kind != "enum":
+                getter = {"double": "double", "float": "double", "integer": "int32", "long": "int32",
+                          "boolean": "bool"}[kind]
+                out += call("return nx_azure_iot_json_reader_token_%s_get" % getter,
+                            ["json_reader", "&properties->%s" % field.name], ";", "  ")
+            else:
+                values = sorted(v for _, v in field.schema["values"])
+                out.append("  int32_t value;")
+                out.append("")
+                out.append("  if (nx_azure_iot_json_reader_token_int32_get(json_reader, &value))")
+                out.append("  {")
+                out.append("    return NX_NOT_SUCCESSFUL;")
+                out.append("  }")
+                out.append("")
+
+                if values == list(range(values[0], values[-1] + 1)):
+                    out.append("  if (value < %d || value > %d)" % (values[0], values[-1]))
+                    out.append("  {")
+                    out.append("    return NX_NOT_SUCCESSFUL;")
+                    out.append("  }")
+                else:
+                    out.append("  switch (value)")
+                    out.append("  {")
+                    for v in values:
+                        out.append("    case %d:" % v)
+                    out.append("      break;")
+                    out.append("")
+                    out.append("    default:")
+                    out.append("      return NX_NOT_SUCCESSFUL;")
+                    out.append("  }")
+
+                out.append("")
+                out.append("  properties->%s = (%s)value;" % (field.name, field.schema["type"]))
+                out.append("  return NX_AZURE_IOT_SUCCESS;")
+
+            out.append("}")
+
+        slots = {}
+        for field in self.writable:
+            slots[self.slot(seed, bits, field.name.encode())] = field
+
+        out.append("")
+        out.append("/* Writable properties by hash, empty slots have no name */")
+        out.append("static const WRITABLE_ENTRY writable_table[1 << WRITABLE_HASH_BITS] = {")
+        for slot in range(1 << bits):
+            if slot in slots:
+                f = slots[slot]
+                out.append("    {name_%s," % f.name)
+                out.append("        sizeof(name_%s) - 1," % f.name)
+                out.append("        parse_%s," % f.name)
+                out.append("        %s_WRITABLE_%s}," % (prefix, f.name.upper()))
+            else:
+                out.append("    {NX_NULL, 0, NX_NULL, %s_WRITABLE_COUNT}," % prefix)
+        out.append("};")
+        out.append("")
+        if self.short_key:
+            out.append("/* FNV-1a of the length, first and last bytes, which tell the writable properties apart. The")
+            out.append("   seed was searched by the generator for a hash without collisions. */")
+            out.append("static UINT writable_hash(const UCHAR* name, UINT name_length)")
+            out.append("{")
+            out.append("  uint32_t hash = (WRITABLE_HASH_SEED ^ name_length) * %dU;" % FNV_PRIME)
+            out.append("")
+            out.append("  hash = (hash ^ name[0]) * %dU;" % FNV_PRIME)
+            out.append("  hash = (hash ^ name[name_length - 1]) * %dU;" % FNV_PRIME)
+            out.append("")
+        else:
+            out.append("/* FNV-1a, the seed was searched by the generator for a hash without collisions */")
+            out.append("static UINT writable_hash(const UCHAR* name, UINT name_length)")
+            out.append("{")
+            out.append("  uint32_t hash = WRITABLE_HASH_SEED;")
+            out.append("")
+            out.append("  while (name_length--)")
+            out.append("  {")
+            out.append("    hash = (hash ^ *name++) * %dU;" % FNV_PRIME)
+            out.append("  }")
+            out.append("")
+        out.append("  return hash >> (32 - WRITABLE_HASH_BITS);")
+        out.append("}")
+
+        for field in self.telemetry + self.properties:
+            value = "%s" % field.name
+            out.append("")
+            out += call("UINT %s_append_%s" % (self.prefix, field.name),
+                        ["NX_AZURE_IOT_JSON_WRITER* json_writer", self.parameter(field)], "")
+            out.append("{")
+            out += self.append(field, value, "return ", ";", "  ")
+            out.append("}")
+
+        out.append("")
+        out += declaration("UINT %s_writable_property_parse" % self.prefix, self.parse_parameters(), "")
+        out.append("{")
+        out.append("  const WRITABLE_ENTRY* entry;")
+        out.append("")
+        out.append("  // Empty slots have no name, an empty name would match them")
+        out.append("  if (name_length == 0)")
+        out.append("  {")
+        out.append("    return NX_AZURE_IOT_NOT_FOUND;")
+        out.append("  }")
+        out.append("")
+        out.append("  entry = &writable_table[writable_hash(name, name_length)];")
+        out.append("")
+        out.append("  if (entry->name_length != name_length || memcmp(entry->name, name, name_length) != 0)")
+        out.append("  {")
+        out.append("    return NX_AZURE_IOT_NOT_FOUND;")
+        out.append("  }")
+        out.append("")
+        out.append("  *property = entry->property;")
+        out.append("")
+        out.append("  if (entry->parse(json_reader, properties))")
+        out.append("  {")
+        out.append("    return NX_NOT_SUCCESSFUL;")
+        out.append("  }")
+        out.append("")
+        out.append("  return NX_AZURE_IOT_SUCCESS;")
+        out.append("}")
+        return "\n".join(out) + "\n"
+
+
+def banner(file, brief, source, command):
+    return [
+        "/**",
+        " ******************************************************************************",
+        " * @file    %s" % file,
+        " * @author  Microsoft",
+        " * @brief   %s" % brief,
+        " ******************************************************************************",
+        " * @attention",
+        " *",
+        " * Generated from %s by" % source,
+        " *   %s" % command,
+        " * Do not edit, change the model and run the generator again.",
+        " *",
+        " ******************************************************************************",
+        " */",
+    ]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("model", help="DTDL v2 model, the first interface is generated")
+    parser.add_argument("output", help="directory of the generated .h and .c")
+    parser.add_argument("--prefix", default="pnp_model", help="file name and C identifier prefix")
+    parser.add_argument("--integer-digits", type=int, default=MAX_INTEGER_DIGITS,
+                        help="integer digits of the largest double, bounds the worst case sizes")
+    parser.add_argument("--fractional-digits", type=int, default=2, help="digits written after the point")
+    args = parser.parse_args()
+
+    with open(args.model) as file:
+        model = json.load(file)
+
+    interface = model[0] if isinstance(model, list) else model
+    generator = Generator(interface, args.prefix, args.integer_digits, args.fractional_digits)
+
+    command = "python3 %s %s" % (os.path.basename(sys.argv[0]), " ".join(sys.argv[1:]))
+    source = os.path.basename(args.model)
+
+    outputs = (
+        ("%s.h" % args.prefix, generator.header(banner("%s.h" % args.prefix,
+            "Device model serializers and writable property parser header file", source, command))),
+        ("%s.c" % args.prefix, generator.source(banner("%s.c" % args.prefix,
+            "Device model serializers and writable property parser", source, command))),
+    )
+
+    for name, text in outputs:
+        with open(os.path.join(args.output, name), "w", newline="\n") as file:
+            file.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -33,6 +33,16 @@
 #include "nx_azure_iot_hub_client.h"
 
 #include "pnp_device_info.h"
+#include "pnp_model.h"
+
+#include "b_u585i_iot02a_eeprom.h"
+#include "b_u585i_iot02a_motion_sensors.h"
+
+#include "crypto_hw.h"
+#include "motion_features.h"
+#include "low_power.h"
+#include "motion_fifo.h"
+#include "thread_profile.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -41,17 +51,40 @@ typedef enum TELEMETRY_STATE_ENUM
 {
   TELEMETRY_STATE_DEFAULT,
   // TELEMETRY_STATE_MAGNETOMETER,
-  // TELEMETRY_STATE_ACCELEROMETER,
-  // TELEMETRY_STATE_GYROSCOPE,
+  TELEMETRY_STATE_VIBRATION,
+  TELEMETRY_STATE_GYROSCOPE,
+  TELEMETRY_STATE_THREAD_PROFILE,
   TELEMETRY_STATE_END
 } TELEMETRY_STATE;
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-#define TELEMETRY_TEMPERATURE "temperature"
-#define TELEMETRY_HUMIDITY    "humidity"
-#define PROPERTY_LED_STATE    "led_state"
+/* Thread profile component, one window per telemetry rotation */
+#define THREAD_PROFILE_COMPONENT "threadProfile"
+#define TELEMETRY_CPU_LOAD       "cpuLoad"
+#define TELEMETRY_THREADS        "threads"
+#define TELEMETRY_SLEEP          "sleep"
+#define TELEMETRY_STOP           "stop"
+#define TELEMETRY_WAKEUPS        "wakeups"
+#define TELEMETRY_WAKE_LATE_MAX  "wakeLateMaxUs"
+
+/* Telemetry batch flush thresholds, samples / bytes / seconds */
+#define TELEMETRY_BATCH_MAX_SAMPLES 6
+#define TELEMETRY_BATCH_MAX_BYTES   1024
+#define TELEMETRY_BATCH_MAX_AGE     60
+
+/* DPS cache and DHCP lease locations in the M24LR64 EEPROM */
+#define DPS_CACHE_EEPROM_ADDRESS  0x0000U
+#define DHCP_LEASE_EEPROM_ADDRESS 0x0400U
+
+/* A batched sample wraps the telemetry as {"timestamp":<13 digits>,...}, and the writer
+   reserves 24 bytes ahead of any double */
+#define TELEMETRY_SAMPLE_OVERHEAD (14 + 13 + 24)
+
+#if PNP_MODEL_VIBRATION_MAX_SIZE + TELEMETRY_SAMPLE_OVERHEAD > AZURE_IOT_TELEMETRY_SAMPLE_SIZE
+#error "Vibration telemetry does not fit a telemetry batch sample"
+#endif
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -64,6 +97,22 @@ typedef enum TELEMETRY_STATE_ENUM
 static AZURE_IOT_CONTEXT nx_azure_iot_client;
 
 static int32_t telemetry_interval = 10;
+
+/* Writable properties, as set by the board at boot */
+static PNP_MODEL_WRITABLE_PROPERTIES writable_properties = {
+    10, PNP_MODEL_ACC_FULLSCALE_G4, PNP_MODEL_GYRO_FULLSCALE_DPS2000};
+
+/* Gyroscope full scale of each model enum value, in dps */
+static const INT gyro_fullscale_dps[] = {125, 250, 500, 1000, 2000};
+
+/* Accelerometer features of the window closed by the last vibration telemetry */
+static MOTION_FEATURES vibration;
+
+/* Per thread CPU, stack and wake latency of the window closed by the last thread profile telemetry */
+static THREAD_PROFILE thread_profile;
+
+/* Tickless idle residency over the same window */
+static LOW_POWER_STATS low_power;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -126,18 +175,168 @@ static UINT append_device_info_properties(NX_AZURE_IOT_JSON_WRITER* json_writer)
 static UINT append_device_telemetry(NX_AZURE_IOT_JSON_WRITER* json_writer)
 {
   float temperature;
+  INT   status;
 
-  if (BSP_ENV_SENSOR_GetValue(0, ENV_TEMPERATURE, &temperature) != BSP_ERROR_NONE)
+  motion_fifo_bus_lock();
+  status = BSP_ENV_SENSOR_GetValue(0, ENV_TEMPERATURE, &temperature);
+  motion_fifo_bus_unlock();
+
+  if (status != BSP_ERROR_NONE)
   {
     printf("ERROR: BSP_ENV_SENSOR_GetValue\r\n");
   }
 
-  if (nx_azure_iot_json_writer_append_property_with_double_value(
-          json_writer, (UCHAR*)TELEMETRY_TEMPERATURE, sizeof(TELEMETRY_TEMPERATURE) - 1, temperature, 2))
+  return pnp_model_append_temperature(json_writer, temperature);
+}
+
+static VOID vibration_axis_get(PNP_MODEL_VIBRATION_X* model, const MOTION_AXIS_FEATURES* axis)
+{
+  model->rms    = axis->rms;
+  model->p2p    = axis->peak_to_peak;
+  model->crest  = axis->crest_factor;
+  model->band_1 = axis->band_rms[0];
+  model->band_2 = axis->band_rms[1];
+  model->band_3 = axis->band_rms[2];
+  model->band_4 = axis->band_rms[3];
+}
+
+static UINT append_vibration_telemetry(NX_AZURE_IOT_JSON_WRITER* json_writer)
+{
+  PNP_MODEL_VIBRATION model;
+  UINT                start_length = nx_azure_iot_json_writer_get_bytes_used(json_writer);
+
+  vibration_axis_get(&model.x, &vibration.axis[0]);
+  vibration_axis_get(&model.y, &vibration.axis[1]);
+  vibration_axis_get(&model.z, &vibration.axis[2]);
+
+  if (pnp_model_append_vibration(json_writer, &model))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  printf("Vibration: %lu samples (%lu bytes raw) sent as %u bytes, %lu cycles per block (max %lu), %lu blocks lost\r\n",
+      vibration.samples,
+      (ULONG)(vibration.samples * sizeof(MOTION_SAMPLE)),
+      nx_azure_iot_json_writer_get_bytes_used(json_writer) - start_length,
+      vibration.avg_block_cycles,
+      vibration.max_block_cycles,
+      vibration.dropped_blocks);
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+static UINT append_gyroscope_telemetry(NX_AZURE_IOT_JSON_WRITER* json_writer)
+{
+  BSP_MOTION_SENSOR_Axes_t axes;
+  PNP_MODEL_GYROSCOPE      model;
+  INT                      status;
+
+  // The gyroscope is not batched in the FIFO, read the current output
+  motion_fifo_bus_lock();
+  status = BSP_MOTION_SENSOR_GetAxes(0, MOTION_GYRO, &axes);
+  motion_fifo_bus_unlock();
+
+  if (status != BSP_ERROR_NONE)
+  {
+    printf("ERROR: BSP_MOTION_SENSOR_GetAxes\r\n");
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  model.g_x = axes.x;
+  model.g_y = axes.y;
+  model.g_z = axes.z;
+
+  return pnp_model_append_gyroscope(json_writer, &model);
+}
+
+static UINT append_thread_profile_telemetry(NX_AZURE_IOT_JSON_WRITER* json_writer)
+{
+  THREAD_PROFILE_ENTRY* entry;
+  UINT                  index;
+
+  if (nx_azure_iot_json_writer_append_property_with_double_value(json_writer,
+          (UCHAR*)TELEMETRY_CPU_LOAD,
+          sizeof(TELEMETRY_CPU_LOAD) - 1,
+          (1000 - thread_profile.idle_permille) / 10.0,
+          1) ||
+      nx_azure_iot_json_writer_append_property_name(
+          json_writer, (UCHAR*)TELEMETRY_THREADS, sizeof(TELEMETRY_THREADS) - 1) ||
+      nx_azure_iot_json_writer_append_begin_array(json_writer))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  for (index = 0; index < thread_profile.count; index++)
+  {
+    entry = &thread_profile.thread[index];
+
+    if (nx_azure_iot_json_writer_append_begin_object(json_writer) ||
+        nx_azure_iot_json_writer_append_property_with_string_value(json_writer,
+            (UCHAR*)"name",
+            sizeof("name") - 1,
+            (UCHAR*)entry->name,
+            strlen(entry->name)) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"priority", sizeof("priority") - 1, entry->priority) ||
+        nx_azure_iot_json_writer_append_property_with_double_value(
+            json_writer, (UCHAR*)"cpu", sizeof("cpu") - 1, entry->cpu_permille / 10.0, 1) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"stackUsed", sizeof("stackUsed") - 1, entry->stack_used) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"stackSize", sizeof("stackSize") - 1, entry->stack_size) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"wakes", sizeof("wakes") - 1, entry->wakes) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"wakeAvgUs", sizeof("wakeAvgUs") - 1, entry->wake_avg_us) ||
+        nx_azure_iot_json_writer_append_property_with_int32_value(
+            json_writer, (UCHAR*)"wakeMaxUs", sizeof("wakeMaxUs") - 1, entry->wake_max_us) ||
+        nx_azure_iot_json_writer_append_end_object(json_writer))
+    {
+      return NX_NOT_SUCCESSFUL;
+    }
+  }
+
+  if (nx_azure_iot_json_writer_append_end_array(json_writer))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  if (low_power.window_ticks > 0 &&
+      (nx_azure_iot_json_writer_append_property_with_double_value(json_writer,
+           (UCHAR*)TELEMETRY_SLEEP,
+           sizeof(TELEMETRY_SLEEP) - 1,
+           low_power.sleep_ticks * 100.0 / low_power.window_ticks,
+           1) ||
+          nx_azure_iot_json_writer_append_property_with_double_value(json_writer,
+              (UCHAR*)TELEMETRY_STOP,
+              sizeof(TELEMETRY_STOP) - 1,
+              low_power.stop_ticks * 100.0 / low_power.window_ticks,
+              1) ||
+          nx_azure_iot_json_writer_append_property_with_int32_value(
+              json_writer, (UCHAR*)TELEMETRY_WAKEUPS, sizeof(TELEMETRY_WAKEUPS) - 1, low_power.sleeps) ||
+          nx_azure_iot_json_writer_append_property_with_int32_value(json_writer,
+              (UCHAR*)TELEMETRY_WAKE_LATE_MAX,
+              sizeof(TELEMETRY_WAKE_LATE_MAX) - 1,
+              low_power.wake_late_max_us)))
   {
     return NX_NOT_SUCCESSFUL;
   }
 
+  printf("Low power: %lu/%lu ticks asleep (%lu in Stop 2), %lu wakeups (%lu early), late %lu/%lu us avg/max\r\n",
+      low_power.sleep_ticks,
+      low_power.window_ticks,
+      low_power.stop_ticks,
+      low_power.sleeps,
+      low_power.early_wakes,
+      low_power.wake_late_avg_us,
+      low_power.wake_late_max_us);
+
+  printf("Thread profile: %lu.%lu%% CPU over %lu ms, %u threads\r\n",
+      (1000 - thread_profile.idle_permille) / 10,
+      (1000 - thread_profile.idle_permille) % 10,
+      thread_profile.window_ms,
+      thread_profile.count);
+
   return NX_AZURE_IOT_SUCCESS;
 }
 
@@ -145,10 +344,192 @@ static VOID telemetry_callback(AZURE_IOT_CONTEXT* context)
 {
   static TELEMETRY_STATE telemetry_state = TELEMETRY_STATE_DEFAULT;
 
+  // Timestamps and SAS tokens rely on the clock, keep it disciplined while connected
+  sntp_poll();
+
   switch (telemetry_state)
   {
     case TELEMETRY_STATE_DEFAULT:
-      nx_azure_iot_client_publish_telemetry(&nx_azure_iot_client, NULL, append_device_telemetry);
+      nx_azure_iot_client_queue_telemetry(&nx_azure_iot_client, NULL, append_device_telemetry);
+      break;
+
+    case TELEMETRY_STATE_VIBRATION:
+      // Only the features leave the device, the raw samples stay in the motion FIFO blocks
+      if (motion_features_get(&vibration) == TX_SUCCESS)
+      {
+        nx_azure_iot_client_queue_telemetry(&nx_azure_iot_client, NULL, append_vibration_telemetry);
+      }
+      break;
+
+    case TELEMETRY_STATE_GYROSCOPE:
+      nx_azure_iot_client_queue_telemetry(&nx_azure_iot_client, NULL, append_gyroscope_telemetry);
+      break;
+
+    case TELEMETRY_STATE_THREAD_PROFILE:
+      if (thread_profile_get(&thread_profile) == TX_SUCCESS)
+      {
+        if (low_power_stats_get(&low_power) != TX_SUCCESS)
+        {
+          low_power.window_ticks = 0;
+        }
+
+
+        nx_azure_iot_client_queue_telemetry(
+            &nx_azure_iot_client, THREAD_PROFILE_COMPONENT, append_thread_profile_telemetry);
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  telemetry_state = (telemetry_state + 1) % TELEMETRY_STATE_END;
+}
+
+static UINT dps_cache_read(AZURE_IOT_DPS_CACHE* cache)
+{
+  INT status;
+
+  motion_fifo_bus_lock();
+  status = BSP_EEPROM_ReadBuffer(0, (uint8_t*)cache, DPS_CACHE_EEPROM_ADDRESS, sizeof(AZURE_IOT_DPS_CACHE));
+  motion_fifo_bus_unlock();
+
+  if (status != BSP_ERROR_NONE)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_SUCCESS;
+}
+
+static UINT dps_cache_write(const AZURE_IOT_DPS_CACHE* cache)
+{
+  INT status;
+
+  motion_fifo_bus_lock();
+  status = BSP_EEPROM_WriteBuffer(0, (uint8_t*)cache, DPS_CACHE_EEPROM_ADDRESS, sizeof(AZURE_IOT_DPS_CACHE));
+  motion_fifo_bus_unlock();
+
+  if (status != BSP_ERROR_NONE)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_SUCCESS;
+}
+
+static UINT dhcp_lease_read(DHCP_LEASE* lease)
+{
+  INT status;
+
+  motion_fifo_bus_lock();
+  status = BSP_EEPROM_ReadBuffer(0, (uint8_t*)lease, DHCP_LEASE_EEPROM_ADDRESS, sizeof(DHCP_LEASE));
+  motion_fifo_bus_unlock();
+
+  if (status != BSP_ERROR_NONE)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_SUCCESS;
+}
+
+static UINT dhcp_lease_write(const DHCP_LEASE* lease)
+{
+  INT status;
+
+  motion_fifo_bus_lock();
+  status = BSP_EEPROM_WriteBuffer(0, (uint8_t*)lease, DHCP_LEASE_EEPROM_ADDRESS, sizeof(DHCP_LEASE));
+  motion_fifo_bus_unlock();
+
+  if (status != BSP_ERROR_NONE)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_SUCCESS;
+}
+
+static UINT network_connect()
+{
+  CHAR hostname[AZURE_IOT_HOST_NAME_SIZE + 1];
+
+  // Let the bring-up resolve the endpoint while it waits for SNTP
+  if (nx_azure_iot_client_endpoint_get(&nx_azure_iot_client, hostname, sizeof(hostname)) != NX_SUCCESS)
+  {
+    hostname[0] = 0;
+  }
+
+  return MX_NetXDuo_Connect(hostname);
+}
+
+static UINT append_reported_properties(NX_AZURE_IOT_JSON_WRITER* json_writer)
+{
+  return pnp_model_append_led_state(json_writer, false);
+}
+
+static VOID writable_property_received_callback(AZURE_IOT_CONTEXT* context,
+    const UCHAR*                                                   component_name,
+    UINT                                                           component_name_len,
+    UCHAR*                                                         property_name,
+    UINT                                                           property_name_len,
+    NX_AZURE_IOT_JSON_READER*                                      json_reader,
+    UINT                                                           version)
+{
+  PNP_MODEL_WRITABLE property;
+  UINT               status;
+
+  // The components only report
+  if (component_name != NX_NULL)
+  {
+    return;
+  }
+
+  status = pnp_model_writable_property_parse(
+      property_name, property_name_len, json_reader, &writable_properties, &property);
+
+  if (status == NX_AZURE_IOT_NOT_FOUND)
+  {
+    printf("WARNING: Unknown writable property %.*s\r\n", (INT)property_name_len, property_name);
+    return;
+  }
+
+  if (status != NX_AZURE_IOT_SUCCESS)
+  {
+    printf("ERROR: Invalid value for writable property %.*s\r\n", (INT)property_name_len, property_name);
+    return;
+  }
+
+  switch (property)
+  {
+    case PNP_MODEL_WRITABLE_TELEMETRY_INTERVAL:
+      if (writable_properties.telemetry_interval < 1)
+      {
+        printf("ERROR: Telemetry interval below 1 second\r\n");
+        break;
+      }
+
+      telemetry_interval = (int32_t)writable_properties.telemetry_interval;
+      nx_azure_iot_client_periodic_interval_set(context, telemetry_interval);
+      printf("Telemetry interval set to %d seconds\r\n", (INT)telemetry_interval);
+      break;
+
+    case PNP_MODEL_WRITABLE_ACC_FULLSCALE:
+      // The FIFO scales the vibration features with the sensitivity read at init
+      printf("WARNING: Accelerometer full scale is fixed at 4g\r\n");
+      break;
+
+    case PNP_MODEL_WRITABLE_GYRO_FULLSCALE:
+      motion_fifo_bus_lock();
+      status = BSP_MOTION_SENSOR_SetFullScale(0, MOTION_GYRO, gyro_fullscale_dps[writable_properties.gyro_fullscale]);
+      motion_fifo_bus_unlock();
+
+      if (status != BSP_ERROR_NONE)
+      {
+        printf("ERROR: BSP_MOTION_SENSOR_SetFullScale\r\n");
+      }
+      break;
+
     default:
       break;
   }
@@ -158,8 +539,7 @@ static VOID properties_complete_callback(AZURE_IOT_CONTEXT* context)
 {
   /* Device twin processing is done, send out property updates */
   nx_azure_iot_client_publish_properties(context, DEVICE_INFO_COMPONENT_NAME, append_device_info_properties);
-  nx_azure_iot_client_publish_bool_property(context, NULL, PROPERTY_LED_STATE, false);
-  //nx_azure_iot_client_publish_int_writable_property(context, NULL, TELEMETRY_INTERVAL_PROPERTY, telemetry_interval);
+  nx_azure_iot_client_publish_properties(context, NULL, append_reported_properties);
 
   printf("\r\nStarting Main loop\r\n");
 }
@@ -169,6 +549,12 @@ UINT Azure_Iot_Entry(
 {
   UINT ret = NX_SUCCESS;
 
+  /* Offload the TLS crypto, before the first connection. */
+  if (crypto_hw_init() != TX_SUCCESS)
+  {
+    printf("WARNING: Crypto peripherals not available\r\n");
+  }
+
   ret = nx_azure_iot_client_create(&nx_azure_iot_client,
       ip_ptr,
       pool_ptr,
@@ -183,10 +569,36 @@ UINT Azure_Iot_Entry(
     return ret;
   }
 
+  /* Start the accelerometer FIFO acquisition, shares I2C2 with the sensors above. */
+  if (motion_fifo_init() != TX_SUCCESS || motion_features_init() != TX_SUCCESS)
+  {
+    printf("WARNING: Motion FIFO not available\r\n");
+  }
+
+  /* Profile the threads, reported with the telemetry. */
+  if (thread_profile_init() != TX_SUCCESS)
+  {
+    printf("WARNING: Thread profile not available\r\n");
+  }
+
+  /* Stop the tick while idle, the telemetry timers bound the sleep. */
+  if (low_power_init() != TX_SUCCESS)
+  {
+    printf("WARNING: Tickless idle not available\r\n");
+  }
+
   /* Register the callbacks. */
   nx_azure_iot_client_register_timer_callback(&nx_azure_iot_client, telemetry_callback, telemetry_interval);
+  nx_azure_iot_client_register_writable_property_callback(
+      &nx_azure_iot_client, writable_property_received_callback);
   nx_azure_iot_client_register_properties_complete_callback(&nx_azure_iot_client, properties_complete_callback);
 
+  /* Batch telemetry samples into fewer, larger messages. */
+  nx_azure_iot_client_telemetry_batch_set(&nx_azure_iot_client,
+      TELEMETRY_BATCH_MAX_SAMPLES,
+      TELEMETRY_BATCH_MAX_BYTES,
+      TELEMETRY_BATCH_MAX_AGE);
+
   /* Set up authentication. */
 #ifdef ENABLE_X509
 
@@ -200,11 +612,28 @@ UINT Azure_Iot_Entry(
   }
 #endif
 
+  /* Keep the DHCP lease and the DPS result in the EEPROM to shorten the next boot. */
+  motion_fifo_bus_lock();
+  ret = BSP_EEPROM_Init(0);
+  motion_fifo_bus_unlock();
+
+  if (ret == BSP_ERROR_NONE)
+  {
+    MX_NetXDuo_Register_Lease_Storage(dhcp_lease_read, dhcp_lease_write);
+#ifdef ENABLE_DPS
+    nx_azure_iot_client_register_dps_cache(&nx_azure_iot_client, dps_cache_read, dps_cache_write);
+#endif
+  }
+  else
+  {
+    printf("WARNING: EEPROM not available, DHCP and provisioning run in full on every boot\r\n");
+  }
+
   /* Enter the main loop. */
 #ifdef ENABLE_DPS
-  nx_azure_iot_client_dps_run(&nx_azure_iot_client, IOT_DPS_ID_SCOPE, IOT_DPS_REGISTRATION_ID, MX_NetXDuo_Connect);
+  nx_azure_iot_client_dps_run(&nx_azure_iot_client, IOT_DPS_ID_SCOPE, IOT_DPS_REGISTRATION_ID, network_connect);
 #else
-  nx_azure_iot_client_hub_run(&nx_azure_iot_client, IOT_HUB_HOSTNAME, IOT_HUB_DEVICE_ID, MX_NetXDuo_Connect);
+  nx_azure_iot_client_hub_run(&nx_azure_iot_client, IOT_HUB_HOSTNAME, IOT_HUB_DEVICE_ID, network_connect);
 #endif
 
   return NX_SUCCESS;
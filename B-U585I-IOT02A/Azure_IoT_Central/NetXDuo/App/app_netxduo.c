@@ -23,23 +23,24 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include <stddef.h>
+#include <string.h>
+
 #include "app_azure_rtos.h"
+#include "nx_azure_iot_clock.h"
 #include "nx_ip.h"
 /* USER CODE END Includes */
 
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
-/* Declare SNTP servers */
+/* Declare SNTP servers, each name may resolve to several pool servers */
 static const CHAR* SNTP_SERVER[] = {
     "0.pool.ntp.org",
     "1.pool.ntp.org",
     "2.pool.ntp.org",
     "3.pool.ntp.org",
 };
-static UINT sntp_server_count;
-
-static TX_EVENT_FLAGS_GROUP sntp_flags;
 
 ULONG   IpAddress;
 ULONG   NetMask;
@@ -49,13 +50,32 @@ ULONG   GatewayAddress;
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-#define SNTP_UPDATE_EVENT 1
+/* Servers queried in parallel, the first valid answer wins */
+#define SNTP_SERVER_MAX 4
+
+#define SNTP_PORT        123
+#define SNTP_PACKET_SIZE 48
+
+/* Resend the requests to all the servers until one answers or the sync times out. */
+#define SNTP_RETRY_TIME (1 * NX_IP_PERIODIC_RATE)
+#define SNTP_SYNC_TIME  (30 * NX_IP_PERIODIC_RATE)
+
+/* Requests still matched by their nonce, a reply may come after later retries were sent. */
+#define SNTP_REQUEST_MAX 4
+
+/* Period of the background requests that keep the clock disciplined, see sntp_poll. */
+#define SNTP_RESYNC_TIME (3600 * NX_IP_PERIODIC_RATE)
 
-/* Time to wait for each server poll. */
-#define SNTP_WAIT_TIME (10 * NX_IP_PERIODIC_RATE)
+#define SNTP_SYNC_EVENT 1
+
+/* Time to wait for the ACK to an INIT-REBOOT request before falling back to discovery.
+   A server that does not know the lease stays silent (RFC 2131, 4.3.2). */
+#define DHCP_INIT_REBOOT_WAIT (3 * NX_IP_PERIODIC_RATE)
 
 /* Seconds between Unix Epoch (1/1/1970) and NTP Epoch (1/1/1999). */
 #define UNIX_TO_NTP_EPOCH_SECS 0x83AA7E80
+
+#define TICKS_TO_MS(ticks) ((ticks) * 1000 / TX_TIMER_TICKS_PER_SECOND)
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -69,16 +89,30 @@ NX_PACKET_POOL AppPool;
 NX_IP          IpInstance;
 NX_DHCP        DhcpClient;
 NX_DNS         DnsClient;
-NX_SNTP_CLIENT SntpClient;
 
 static UCHAR nx_ip_stack[NX_IP_STACK_SIZE];
 static UCHAR nx_ip_pool[NX_PACKET_POOL_SIZE];
 
 static ULONG nx_arp_cache[NX_ARP_CACHE_SIZE];
 
-/* Variables to keep track of time. */ 
-static ULONG sntp_last_time = 0;
-static ULONG tx_last_ticks  = 0;
+/* Keeps the endpoint resolved during the bring-up for the hub / DPS connect. */
+static ULONG nx_dns_cache[NX_DNS_CACHE_SIZE / sizeof(ULONG)];
+
+static UINT                      dhcp_started;
+static func_ptr_dhcp_lease_read  dhcp_lease_read;
+static func_ptr_dhcp_lease_write dhcp_lease_write;
+
+static NX_UDP_SOCKET sntp_socket;
+static ULONG         sntp_server[SNTP_SERVER_MAX];
+static UINT          sntp_server_count;
+static ULONG         sntp_nonce[SNTP_REQUEST_MAX];
+static ULONG         sntp_request_tick[SNTP_REQUEST_MAX];
+static UINT          sntp_request_count;
+static UINT          sntp_pending;
+static ULONG         sntp_send_tick;
+static ULONG         sntp_source;
+
+static TX_EVENT_FLAGS_GROUP sntp_events;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -87,190 +121,392 @@ static ULONG tx_last_ticks  = 0;
 /* USER CODE END PFP */
 
 /* USER CODE BEGIN 1 */
-static VOID time_update_callback(NX_SNTP_TIME_MESSAGE* time_update_ptr, NX_SNTP_TIME* local_time)
+static ULONG ntp_read_ulong(const UCHAR* data)
 {
-  // Set the update flag so we pick up the new time in the SNTP thread
-  tx_event_flags_set(&sntp_flags, SNTP_UPDATE_EVENT, TX_OR);
+  return ((ULONG)data[0] << 24) | ((ULONG)data[1] << 16) | ((ULONG)data[2] << 8) | (ULONG)data[3];
 }
 
-static VOID set_sntp_time()
+static VOID ntp_write_ulong(UCHAR* data, ULONG value)
+{
+  data[0] = (UCHAR)(value >> 24);
+  data[1] = (UCHAR)(value >> 16);
+  data[2] = (UCHAR)(value >> 8);
+  data[3] = (UCHAR)value;
+}
+
+/* Collect up to SNTP_SERVER_MAX addresses, one pool name usually returns all of them */
+static UINT sntp_resolve()
 {
   UINT  status;
-  ULONG seconds;
-  ULONG milliseconds;
-  CHAR  time_buffer[64];
+  UINT  index;
+  UINT  record;
+  UINT  record_count;
+  ULONG records[SNTP_SERVER_MAX];
 
-  status = nx_sntp_client_get_local_time(&SntpClient, &seconds, &milliseconds, NX_NULL);
-  if (status != NX_SUCCESS)
-  {
-    printf("ERROR: Internal error with getting local time (0x%08x)\n", status);
-    return;
-  }
+  sntp_server_count = 0;
 
-  // Stash the Unix and ThreadX times
-  sntp_last_time = seconds - UNIX_TO_NTP_EPOCH_SECS;
-  tx_last_ticks  = tx_time_get();
+  for (index = 0; index < sizeof(SNTP_SERVER) / sizeof(SNTP_SERVER[0]) && sntp_server_count < SNTP_SERVER_MAX;
+       index++)
+  {
+    record_count = 0;
+    if ((status = nx_dns_ipv4_address_by_name_get(&DnsClient,
+             (UCHAR*)SNTP_SERVER[index],
+             records,
+             sizeof(records),
+             &record_count,
+             DEFAULT_TIMEOUT)))
+    {
+      printf("ERROR: Unable to resolve SNTP IP %s (0x%08x)\r\n", SNTP_SERVER[index], status);
+      continue;
+    }
 
-  nx_sntp_client_utility_display_date_time(&SntpClient, time_buffer, sizeof(time_buffer));
+    for (record = 0; record < record_count && sntp_server_count < SNTP_SERVER_MAX; record++)
+    {
+      sntp_server[sntp_server_count++] = records[record];
+    }
+  }
 
-  printf("\tSNTP time update: %s\r\n", time_buffer);
-  printf("SUCCESS: SNTP initialized\r\n");
+  return (sntp_server_count > 0) ? NX_SUCCESS : NX_SNTP_SERVER_NOT_AVAILABLE;
 }
 
-static UINT sntp_client_run()
+/* Send a client request to every server, the transmit timestamp carries a nonce the answer must echo.
+   The nonce and the send tick of the last SNTP_REQUEST_MAX requests are kept, so a reply to an earlier
+   retry is still accepted and its round trip measured from its own request. */
+static VOID sntp_request_send()
 {
-  UINT        status;
-  NXD_ADDRESS sntp_address;
-
-  if (sntp_server_count > (sizeof(SNTP_SERVER) / sizeof(&SNTP_SERVER)))
+  UINT       status;
+  UINT       index;
+  UINT       request_index = sntp_request_count % SNTP_REQUEST_MAX;
+  UCHAR      request[SNTP_PACKET_SIZE];
+  NX_PACKET* packet;
+
+  sntp_send_tick                   = tx_time_get();
+  sntp_nonce[request_index]        = sntp_send_tick ^ (ULONG)NX_RAND();
+  sntp_request_tick[request_index] = sntp_send_tick;
+  sntp_request_count++;
+  sntp_pending = NX_TRUE;
+
+  memset(request, 0, sizeof(request));
+  request[0] = (4 << 3) | 3; // version 4, client mode
+  ntp_write_ulong(&request[44], sntp_nonce[request_index]);
+
+  for (index = 0; index < sntp_server_count; index++)
   {
-    // We rotated through all the servers, fail out.
-    return NX_SNTP_SERVER_NOT_AVAILABLE;
+    if ((status = nx_packet_allocate(&AppPool, &packet, NX_UDP_PACKET, NX_NO_WAIT)))
+    {
+      printf("ERROR: SNTP packet allocate (0x%08x)\r\n", status);
+      return;
+    }
+
+    if ((status = nx_packet_data_append(packet, request, sizeof(request), &AppPool, NX_NO_WAIT)) ||
+        (status = nx_udp_socket_send(&sntp_socket, packet, sntp_server[index], SNTP_PORT)))
+    {
+      printf("ERROR: SNTP request send (0x%08x)\r\n", status);
+      nx_packet_release(packet);
+    }
   }
+}
 
-  printf("\tSNTP server %s\r\n", SNTP_SERVER[sntp_server_count]);
+/* Signed difference of two NTP timestamps (seconds and 32 bit fraction), in microseconds */
+static int64_t ntp_diff_us(const UCHAR* later, const UCHAR* earlier)
+{
+  int64_t seconds  = (int32_t)(ntp_read_ulong(later) - ntp_read_ulong(earlier));
+  int64_t fraction = (int64_t)ntp_read_ulong(later + 4) - (int64_t)ntp_read_ulong(earlier + 4);
 
-  // Stop the server in case it's already running
-  nx_sntp_client_stop(&SntpClient);
+  return seconds * 1000000 + ((fraction * 1000000) >> 32);
+}
 
-#ifndef SAMPLE_SNTP_SERVER_ADDRESS
-  // Resolve DNS
-  if ((status = nxd_dns_host_by_name_get(&DnsClient,
-           (UCHAR*)SNTP_SERVER[sntp_server_count],
-           &sntp_address,
-           5 * NX_IP_PERIODIC_RATE,
-           NX_IP_VERSION_V4)))
+/* Runs in the IP thread as answers arrive, so the arrival tick is not delayed by the application */
+static VOID sntp_receive_notify(NX_UDP_SOCKET* socket_ptr)
+{
+  UINT       index;
+  UINT       request_index;
+  UINT       request_kept = (sntp_request_count < SNTP_REQUEST_MAX) ? sntp_request_count : SNTP_REQUEST_MAX;
+  UINT       port;
+  ULONG      source;
+  ULONG      bytes;
+  ULONG      arrival_tick;
+  int64_t    delay_us;
+  ULONG64    unix_us;
+  UCHAR      response[SNTP_PACKET_SIZE];
+  NX_PACKET* packet;
+
+  while (nx_udp_socket_receive(socket_ptr, &packet, NX_NO_WAIT) == NX_SUCCESS)
   {
-    printf("ERROR: Unable to resolve SNTP IP %s (0x%08x)\r\n", SNTP_SERVER[sntp_server_count], status);
-  }
-#endif /* SAMPLE_SNTP_SERVER_ADDRESS */
+    arrival_tick = tx_time_get();
 
-  // Initialize the service
-  // if ((status = nx_sntp_client_initialize_unicast(&SntpClient, SAMPLE_SNTP_SERVER_ADDRESS)))
-  if ((status = nxd_sntp_client_initialize_unicast(&SntpClient, &sntp_address)))
-  {
-    printf("ERROR: Unable to initialize unicast SNTP client (0x%08x)\r\n", status);
-  }
+    bytes = 0;
+    nx_udp_source_extract(packet, &source, &port);
+    nx_packet_data_extract_offset(packet, 0, response, sizeof(response), &bytes);
+    nx_packet_release(packet);
 
-  // Run Unicast client
-  else if ((status = nx_sntp_client_run_unicast(&SntpClient)))
-  {
-    printf("ERROR: Unable to start unicast SNTP client (0x%08x)\r\n", status);
-  }
+    for (index = 0; index < sntp_server_count && sntp_server[index] != source; index++)
+    {
+    }
 
-  // rotate to the next SNTP service
-  sntp_server_count++;
+    // The request the reply echoes, among the ones still outstanding
+    for (request_index = 0;
+         request_index < request_kept && sntp_nonce[request_index] != ntp_read_ulong(&response[28]);
+         request_index++)
+    {
+    }
 
-  return status;
-}
+    // Drop stray packets, replies to a request no longer kept or from a slower server, kiss-o'-death and
+    // unsynchronized servers
+    if (!sntp_pending || index == sntp_server_count || port != SNTP_PORT || bytes < SNTP_PACKET_SIZE ||
+        (response[0] & 0x07) != 4 || (response[0] >> 6) == 3 || response[1] == 0 || response[1] > 15 ||
+        request_index == request_kept || ntp_read_ulong(&response[40]) == 0)
+    {
+      continue;
+    }
 
-ULONG sntp_time_get()
-{
-  // Calculate how many seconds have elapsed since the last sync
-  ULONG tx_time_delta = (tx_time_get() - tx_last_ticks) / TX_TIMER_TICKS_PER_SECOND;
+    // Round trip less the time the server held the request, half of it is the transmit delay
+    delay_us = (int64_t)(arrival_tick - sntp_request_tick[request_index]) * 1000000 / TX_TIMER_TICKS_PER_SECOND -
+               ntp_diff_us(&response[40], &response[32]);
+    if (delay_us < 0)
+    {
+      delay_us = 0;
+    }
 
-  // Add this to the last sync time to get the current time
-  ULONG sntp_time = sntp_last_time + tx_time_delta;
+    unix_us = (ULONG64)(ntp_read_ulong(&response[40]) - UNIX_TO_NTP_EPOCH_SECS) * 1000000 +
+              (((ULONG64)ntp_read_ulong(&response[44]) * 1000000) >> 32) + (ULONG64)(delay_us / 2);
 
-  return sntp_time;
+    nx_azure_iot_clock_update(unix_us, arrival_tick);
+
+    sntp_pending = NX_FALSE;
+    sntp_source  = source;
+    tx_event_flags_set(&sntp_events, SNTP_SYNC_EVENT, TX_OR);
+  }
 }
 
 UINT sntp_time(ULONG* unix_time)
 {
-  *unix_time = sntp_time_get();
+  return nx_azure_iot_clock_get(unix_time);
+}
 
-  return NX_SUCCESS;
+UINT sntp_time_ms(ULONG64* unix_ms)
+{
+  return nx_azure_iot_clock_get_ms(unix_ms);
 }
 
 UINT sntp_init()
 {
   UINT status;
 
-  if ((status = tx_event_flags_create(&sntp_flags, "SNTP")))
+  if ((status = tx_event_flags_create(&sntp_events, "SNTP events")))
   {
-    printf("ERROR: Create SNTP event flags (0x%08x)\r\n", status);
+    printf("ERROR: SNTP events create failed (0x%08x)\r\n", status);
   }
 
-  else if ((status = nx_sntp_client_create(
-                &SntpClient, &IpInstance, 0, IpInstance.nx_ip_default_packet_pool, NX_NULL, NX_NULL, NULL)))
+  else if ((status = nx_udp_socket_create(
+           &IpInstance, &sntp_socket, "SNTP", NX_IP_NORMAL, NX_FRAGMENT_OKAY, NX_IP_TIME_TO_LIVE, SNTP_SERVER_MAX)))
   {
-    printf("ERROR: SNTP client create failed (0x%08x)\r\n", status);
+    printf("ERROR: SNTP socket create failed (0x%08x)\r\n", status);
   }
 
-  else if ((status = nx_sntp_client_set_local_time(&SntpClient, 0, 0)))
+  else if ((status = nx_udp_socket_bind(&sntp_socket, NX_ANY_PORT, NX_NO_WAIT)))
   {
-    printf("ERROR: Unable to set local time for SNTP client (0x%08x)\r\n", status);
-    nx_sntp_client_delete(&SntpClient);
+    printf("ERROR: SNTP socket bind failed (0x%08x)\r\n", status);
+    nx_udp_socket_delete(&sntp_socket);
   }
 
-  // Setup time update callback function
-  else if ((status = nx_sntp_client_set_time_update_notify(&SntpClient, time_update_callback)))
+  else if ((status = nx_udp_socket_receive_notify(&sntp_socket, sntp_receive_notify)))
   {
-    printf("ERROR: nx_sntp_client_set_time_update_notify (0x%08x)\r\n", status);
-    nx_sntp_client_delete(&SntpClient);
+    printf("ERROR: SNTP socket notify failed (0x%08x)\r\n", status);
+    nx_udp_socket_unbind(&sntp_socket);
+    nx_udp_socket_delete(&sntp_socket);
   }
 
   return status;
 }
 
 /* Connect functions. */
-UINT sntp_sync()
+UINT sntp_start()
 {
   UINT  status;
-  UINT  server_status;
-  ULONG events = 0;
+  ULONG events;
 
   printf("\r\nInitializing SNTP time sync\r\n");
 
-  // Reset the server index so we start from the beginning
-  sntp_server_count = 0;
+  NX_PHASE_TRACE_BEGIN(NX_PHASE_SNTP_SYNC);
 
-  while (NX_TRUE)
+  if ((status = sntp_resolve()))
   {
-    // Run the client
-    sntp_client_run();
+    printf("ERROR: No SNTP server available (0x%08x)\r\n", status);
+    return status;
+  }
+
+  // Forget a sync signalled by a previous request, and the requests of the previous sync
+  tx_event_flags_get(&sntp_events, SNTP_SYNC_EVENT, TX_OR_CLEAR, &events, NX_NO_WAIT);
+  sntp_request_count = 0;
+
+  printf("\tSNTP querying %u servers\r\n", sntp_server_count);
+  sntp_request_send();
 
-    // Wait for new events
-    events = 0;
-    tx_event_flags_get(&sntp_flags, SNTP_UPDATE_EVENT, TX_OR_CLEAR, &events, SNTP_WAIT_TIME);
+  return NX_SUCCESS;
+}
+
+UINT sntp_sync()
+{
+  UINT    status;
+  ULONG   events;
+  ULONG   start_tick = tx_time_get();
+  ULONG64 unix_ms;
 
-    if (events & SNTP_UPDATE_EVENT)
+  while (NX_TRUE)
+  {
+    if ((status = tx_event_flags_get(&sntp_events, SNTP_SYNC_EVENT, TX_OR_CLEAR, &events, SNTP_RETRY_TIME)) ==
+        TX_SUCCESS)
     {
-      // Get time updates
-      nx_sntp_client_receiving_updates(&SntpClient, &server_status);
+      // The clock was updated by the first valid answer
+      sntp_time_ms(&unix_ms);
 
-      // New time, update our local time and we are done
-      set_sntp_time();
-      status = NX_SUCCESS;
+      PRINT_IP_ADDRESS(sntp_source);
+      printf("\tSNTP time update: %lu.%03lu\r\n", (ULONG)(unix_ms / 1000), (ULONG)(unix_ms % 1000));
+      printf("SUCCESS: SNTP initialized\r\n");
+      break;
+    }
+
+    if (tx_time_get() - start_tick >= SNTP_SYNC_TIME)
+    {
+      status = NX_SNTP_SERVER_NOT_AVAILABLE;
       break;
     }
 
-    // Otherwise we rotate around to the next server
+    // No answer yet, the requests or the replies may have been lost
+    sntp_request_send();
   }
 
-  nx_sntp_client_stop(&SntpClient);
+  NX_PHASE_TRACE_END(NX_PHASE_SNTP_SYNC);
 
   return status;
 }
 
+/* Call periodically from a thread, sends a request to the servers resolved at the last connect once per
+   SNTP_RESYNC_TIME. The answer is handled in the background, successive answers let the clock estimate its drift. */
+VOID sntp_poll()
+{
+  if (sntp_server_count == 0 || tx_time_get() - sntp_send_tick < SNTP_RESYNC_TIME)
+  {
+    return;
+  }
+
+  sntp_request_send();
+}
+
+static ULONG dhcp_lease_checksum(const DHCP_LEASE* lease)
+{
+  const ULONG* word     = (const ULONG*)lease;
+  ULONG        checksum = 2166136261UL;
+  UINT         index;
+
+  for (index = 0; index < offsetof(DHCP_LEASE, checksum) / sizeof(ULONG); index++)
+  {
+    checksum = (checksum ^ word[index]) * 16777619UL;
+  }
+
+  return checksum;
+}
+
+static UINT dhcp_lease_load(DHCP_LEASE* lease)
+{
+  if (dhcp_lease_read == NX_NULL || dhcp_lease_read(lease) != NX_SUCCESS)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  if (lease->magic != DHCP_LEASE_MAGIC || lease->checksum != dhcp_lease_checksum(lease) || lease->ip_address == 0)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_SUCCESS;
+}
+
+/* Keep the bound lease, the storage is only written when the lease differs from the stored one */
+static VOID dhcp_lease_store()
+{
+  NX_DHCP_CLIENT_RECORD record;
+  DHCP_LEASE            lease;
+  DHCP_LEASE            stored;
+
+  if (dhcp_lease_write == NX_NULL || nx_dhcp_client_get_record(&DhcpClient, &record) != NX_SUCCESS)
+  {
+    return;
+  }
+
+  memset(&lease, 0, sizeof(lease));
+  lease.magic           = DHCP_LEASE_MAGIC;
+  lease.ip_address      = record.nx_dhcp_ip_address;
+  lease.network_mask    = record.nx_dhcp_network_mask;
+  lease.gateway_address = record.nx_dhcp_gateway_address;
+  lease.server_address  = record.nx_dhcp_server_ip;
+  lease.lease_time      = record.nx_dhcp_lease_time;
+  lease.checksum        = dhcp_lease_checksum(&lease);
+
+  // Read back on every connect, a reconnect or a renewal gets the same lease and writes nothing
+  if (dhcp_lease_load(&stored) == NX_SUCCESS && memcmp(&lease, &stored, sizeof(lease)) == 0)
+  {
+    return;
+  }
+
+  if (dhcp_lease_write(&lease) != NX_SUCCESS)
+  {
+    printf("WARNING: failed to store the DHCP lease\r\n");
+  }
+}
+
 UINT dhcp_connect()
 {
-  UINT  status;
-  ULONG ip_status;
-  ULONG ip_address      = 0;
-  ULONG ip_mask         = 0;
-  ULONG gateway_address = 0;
+  UINT       status;
+  ULONG      ip_status;
+  ULONG      ip_address      = 0;
+  ULONG      ip_mask         = 0;
+  ULONG      gateway_address = 0;
+  ULONG      start_tick;
+  DHCP_LEASE lease;
+  UINT       init_reboot = NX_FALSE;
 
   printf("\r\nInitializing DHCP\r\n");
 
-  // Create DHCP client
-  nx_dhcp_create(&DhcpClient, &IpInstance, "DHCP Client");
+  NX_PHASE_TRACE_BEGIN(NX_PHASE_DHCP_BOUND);
+  start_tick = tx_time_get();
 
-  // Start DHCP client
-  nx_dhcp_start(&DhcpClient);
+  // The client keeps running across reconnects, it renews the lease on its own
+  if (!dhcp_started)
+  {
+    // Create DHCP client
+    nx_dhcp_create(&DhcpClient, &IpInstance, "DHCP Client");
+
+    // Ask for the previous address straight away, skipping DISCOVER / OFFER
+    if (dhcp_lease_load(&lease) == NX_SUCCESS &&
+        nx_dhcp_request_client_ip(&DhcpClient, lease.ip_address, NX_TRUE) == NX_SUCCESS)
+    {
+      printf("\tRequesting the previous lease\r\n");
+      init_reboot = NX_TRUE;
+    }
+
+    // Start DHCP client
+    nx_dhcp_start(&DhcpClient);
+    dhcp_started = NX_TRUE;
+  }
 
   // Wait until IP address is resolved
-  nx_ip_status_check(&IpInstance, NX_IP_ADDRESS_RESOLVED, &ip_status, NX_WAIT_FOREVER);
+  status = nx_ip_status_check(
+      &IpInstance, NX_IP_ADDRESS_RESOLVED, &ip_status, init_reboot ? DHCP_INIT_REBOOT_WAIT : NX_WAIT_FOREVER);
+
+  if (status != NX_SUCCESS)
+  {
+    // No answer to the INIT-REBOOT request, the lease is unknown on this network
+    printf("\tPrevious lease not confirmed, discovering\r\n");
+    nx_dhcp_stop(&DhcpClient);
+    nx_dhcp_reinitialize(&DhcpClient);
+    nx_dhcp_start(&DhcpClient);
+    init_reboot = NX_FALSE;
+
+    nx_ip_status_check(&IpInstance, NX_IP_ADDRESS_RESOLVED, &ip_status, NX_WAIT_FOREVER);
+  }
+  NX_PHASE_TRACE_END(NX_PHASE_DHCP_BOUND);
 
   // Get IP address
   if ((status = nx_ip_address_get(&IpInstance, &ip_address, &ip_mask)))
@@ -291,6 +527,13 @@ UINT dhcp_connect()
   PRINT_IP_ADDRESS(ip_mask);
   PRINT_IP_ADDRESS(gateway_address);
 
+  // A NAK restarts discovery inside the client, only a matching address was an INIT-REBOOT
+  printf("\tAddress in %lu ms (%s)\r\n",
+      TICKS_TO_MS(tx_time_get() - start_tick),
+      (init_reboot && ip_address == lease.ip_address) ? "INIT-REBOOT" : "DISCOVER");
+
+  dhcp_lease_store();
+
   printf("SUCCESS: DHCP initialized\r\n");
 
   return NX_SUCCESS;
@@ -334,6 +577,40 @@ UINT dns_connect()
   return NX_SUCCESS;
 }
 
+/* Resolve the endpoint into the DNS cache so the hub / DPS connect does not wait for it */
+VOID dns_prefetch(CHAR* hostname)
+{
+  UINT  status;
+  ULONG host_address;
+
+  if (hostname == NX_NULL || hostname[0] == 0)
+  {
+    return;
+  }
+
+  if ((status = nx_dns_host_by_name_get(&DnsClient, (UCHAR*)hostname, &host_address, DEFAULT_TIMEOUT)))
+  {
+    // Not fatal, the connect resolves it again
+    printf("WARNING: Unable to resolve %s (0x%08x)\r\n", hostname, status);
+    return;
+  }
+
+  printf("\tResolved %s\r\n", hostname);
+}
+
+UINT MX_NetXDuo_Register_Lease_Storage(func_ptr_dhcp_lease_read read, func_ptr_dhcp_lease_write write)
+{
+  if (read == NX_NULL || write == NX_NULL)
+  {
+    return NX_PTR_ERROR;
+  }
+
+  dhcp_lease_read  = read;
+  dhcp_lease_write = write;
+
+  return NX_SUCCESS;
+}
+
 /**
  * @brief  Application NetXDuo Initialization.
  * @param memory_ptr: memory pointer
@@ -444,6 +721,14 @@ UINT MX_NetXDuo_Init()
   }
 #endif
 
+  /* Keep DNS answers, the bring-up resolves the endpoint ahead of the connect. */
+  status = nx_dns_cache_initialize(&DnsClient, nx_dns_cache, sizeof(nx_dns_cache));
+
+  if (status != NX_SUCCESS)
+  {
+    printf("ERROR: nx_dns_cache_initialize (0x%08x)\r\n", status);
+  }
+
   /* Initialize the SNTP client. */
   status = sntp_init();
 
@@ -460,29 +745,58 @@ UINT MX_NetXDuo_Init()
   return status;
 }
 
-UINT MX_NetXDuo_Connect()
+UINT MX_NetXDuo_Connect(CHAR* hostname)
 {
-  UINT status;
+  UINT  status;
+  ULONG ip_status;
+  ULONG start_tick = tx_time_get();
+  ULONG link_tick;
+  ULONG dhcp_tick;
+
+  // Wait for the link, the phase trace is reset just before the network connect
+  NX_PHASE_TRACE_BEGIN(NX_PHASE_LINK_UP);
+  nx_ip_interface_status_check(&IpInstance, 0, NX_IP_LINK_ENABLED, &ip_status, NX_WAIT_FOREVER);
+  NX_PHASE_TRACE_END(NX_PHASE_LINK_UP);
+  link_tick = tx_time_get();
 
   // Fetch IP details
   if ((status = dhcp_connect()))
   {
     printf("ERROR: dhcp_connect\r\n");
+    return status;
   }
+  dhcp_tick = tx_time_get();
 
   // Create DNS
-  else if ((status = dns_connect()))
+  if ((status = dns_connect()))
   {
     printf("ERROR: dns_connect\r\n");
+    return status;
+  }
+
+  // Query the SNTP servers, then resolve the endpoint while their answers are in flight
+  if ((status = sntp_start()))
+  {
+    printf("ERROR: Failed to start SNTP (0x%08x)\r\n", status);
+    return status;
   }
 
+  dns_prefetch(hostname);
+
   // Wait for an SNTP sync
-  else if ((status = sntp_sync()))
+  if ((status = sntp_sync()))
   {
     printf("ERROR: Failed to sync SNTP time (0x%08x)\r\n", status);
+    return status;
   }
 
-  return status;
+  printf("\r\nNetwork ready in %lu ms: link %lu ms, DHCP %lu ms, DNS and SNTP %lu ms\r\n",
+      TICKS_TO_MS(tx_time_get() - start_tick),
+      TICKS_TO_MS(link_tick - start_tick),
+      TICKS_TO_MS(dhcp_tick - link_tick),
+      TICKS_TO_MS(tx_time_get() - dhcp_tick));
+
+  return NX_SUCCESS;
 }
 
 /* USER CODE END 1 */
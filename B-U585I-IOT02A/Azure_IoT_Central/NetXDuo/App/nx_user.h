@@ -51,6 +51,40 @@
 
 #define NX_AZURE_DISABLE_IOT_SECURITY_MODULE
 
+/* Enable the AEAD (AES-GCM) TLS ciphersuites and compute GHASH with a 4-bit
+   table per key (256 bytes per GCM context) instead of bit by bit. */
+#define NX_SECURE_ENABLE_AEAD_CIPHER
+#define NX_CRYPTO_GCM_GHASH_TABLE_BITS          4
+
+/* Resume the previous TLS 1.2 session with IoT Hub and DPS by session ID on
+   reconnect, skipping the certificate chain and the key exchange. */
+#define NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+
+/* Timestamp each phase of bringing up the IoT Hub connection (DNS, TCP, TLS,
+   MQTT...) in the Azure IoT helper, see nx_azure_iot_trace.c. */
+void nx_azure_iot_trace_phase(unsigned int phase, unsigned int end);
+#define NX_PHASE_TRACE(phase, end)              nx_azure_iot_trace_phase(phase, end)
+
+/* Run the fast TCP timer only while a TCP timeout is pending, expiring at the
+   earliest one, instead of waking the IP thread 10 times per second. */
+#define NX_TCP_FAST_TIMER_ON_DEMAND
+
+/* Negotiate selective acknowledgment, so that a burst of Wi-Fi losses is
+   repaired in one round trip instead of one segment per round trip. */
+#define NX_ENABLE_TCP_SACK
+
+/* Run the TLS record ciphers, the one shot SHA-256 digests and the ECDHE and
+   ECDSA scalar multiplications on the AES, HASH and PKA peripherals. */
+#define NX_AZURE_IOT_CRYPTO_HW
+
+/* Decrypt IoT Hub records in the packets they arrived in and hand those up to
+   MQTT, rather than copying each record into a second chain from the pool. */
+#define NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT
+
+/* Remember the IoT Hub and DPS certificates whose signature was checked, so a
+   reconnect presenting the same chain skips the RSA and ECDSA verifications. */
+#define NX_SECURE_X509_VERIFY_CACHE_SIZE        4
+
 /* Define various build options for the NetX Duo port. The application should
    either make changes here by commenting or un-commenting the conditional
    compilation defined OR supply the defines though the compiler's equivalent
@@ -913,9 +947,7 @@
    license �state� including time remaining on the lease, and restore this
    state between DHCP Client application reboots.
    The default value is disabled. */
-/*
 #define NX_DHCP_CLIENT_RESTORE_STATE
-*/
 
 /* If set, the DHCP Client will not create its own packet pool. The host
    application must use the nx_dhcp_packet_pool_set service to set the DHCP
@@ -1493,9 +1525,7 @@
 */
 
 /* This enables the DNS Client to store the answer records into DNS cache. */
-/*
 #define NX_DNS_CACHE_ENABLE
-*/
 
 /* This sets the timeout option for allocating a packet from the DNS client
    packet pool. The default value is 1 second (1*NX_IP_PERIODIC_RATE). */
@@ -1584,6 +1614,11 @@
 #define NXD_MQTT_CLIENT_THREAD_TIME_SLICE       2
 */
 
+/* Track QoS 1 publishes of clean sessions by packet identifier instead of
+   keeping a copy in AppPool until the PUBACK. The hub and DPS clients connect
+   with a clean session, so telemetry is never copied. */
+#define NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE       16
+
 /*****************************************************************************/
 /********************* Configuration options for HTTP ************************/
 /*****************************************************************************/
@@ -0,0 +1,391 @@
+/**
+ ******************************************************************************
+ * @file    pnp_model.c
+ * @author  Microsoft
+ * @brief   Device model serializers and writable property parser
+ ******************************************************************************
+ * @attention
+ *
+ * Generated from stm32-b-u585i-iot02a.json by
+ *   python3 dtdl_codegen.py stm32-b-u585i-iot02a.json ../NetXDuo/App --integer-digits 7
+ * Do not edit, change the model and run the generator again.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "pnp_model.h"
+
+#include <string.h>
+
+#include "nx_azure_iot.h"
+
+/* Private define ------------------------------------------------------------*/
+#define WRITABLE_HASH_SEED 0x811C9DC6U
+#define WRITABLE_HASH_BITS 2
+
+/* Formatted objects, for any value the JSON writer prints */
+#define FRACTIONAL_DIGITS        2
+#define DOUBLE_MAX_SIZE          20
+#define ACCELERATION_FORMAT_SIZE 82
+#define VIBRATION_FORMAT_SIZE    628
+#define GYROSCOPE_FORMAT_SIZE    82
+#define MAGNETOMETER_FORMAT_SIZE 82
+
+/* Copy a fragment, the text between two values of an object */
+#define FRAGMENT_COPY(json, fragment) fragment_copy((json), (fragment), sizeof(fragment) - 1)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct WRITABLE_ENTRY_STRUCT
+{
+  const UCHAR* name;
+  UINT         name_length;
+  UINT (*parse)(NX_AZURE_IOT_JSON_READER* json_reader, PNP_MODEL_WRITABLE_PROPERTIES* properties);
+  PNP_MODEL_WRITABLE property;
+} WRITABLE_ENTRY;
+
+/* Private variables ---------------------------------------------------------*/
+static const UCHAR name_temperature[]        = "temperature";
+static const UCHAR name_humidity[]           = "humidity";
+static const UCHAR name_pressure[]           = "pressure";
+static const UCHAR name_acceleration[]       = "acceleration";
+static const UCHAR name_vibration[]          = "vibration";
+static const UCHAR name_gyroscope[]          = "gyroscope";
+static const UCHAR name_magnetometer[]       = "magnetometer";
+static const UCHAR name_telemetry_interval[] = "telemetry_interval";
+static const UCHAR name_led_state[]          = "led_state";
+static const UCHAR name_acc_fullscale[]      = "acc_fullscale";
+static const UCHAR name_gyro_fullscale[]     = "gyro_fullscale";
+
+/* A null json is a value that could not be formatted, it stays null to the end of the object */
+static UCHAR* fragment_copy(UCHAR* json, const CHAR* fragment, UINT length)
+{
+  if (json == NX_NULL)
+  {
+    return NX_NULL;
+  }
+
+  memcpy(json, fragment, length);
+  return json + length;
+}
+
+/* The value as the JSON writer prints it */
+static UCHAR* double_format(UCHAR* json, double value)
+{
+  az_span remainder;
+
+  if ((json == NX_NULL) ||
+      az_result_failed(az_span_dtoa(az_span_create(json, DOUBLE_MAX_SIZE), value, FRACTIONAL_DIGITS, &remainder)))
+  {
+    return NX_NULL;
+  }
+
+  return az_span_ptr(remainder);
+}
+
+static UCHAR* format_acceleration(UCHAR* json, const PNP_MODEL_ACCELERATION* value)
+{
+  json = FRAGMENT_COPY(json, "{\"a_x\":");
+  json = double_format(json, value->a_x);
+  json = FRAGMENT_COPY(json, ",\"a_y\":");
+  json = double_format(json, value->a_y);
+  json = FRAGMENT_COPY(json, ",\"a_z\":");
+  json = double_format(json, value->a_z);
+  return FRAGMENT_COPY(json, "}");
+}
+
+static UINT append_acceleration(
+    NX_AZURE_IOT_JSON_WRITER* json_writer, const UCHAR* name, UINT name_length, const PNP_MODEL_ACCELERATION* value)
+{
+  UCHAR  json[ACCELERATION_FORMAT_SIZE];
+  UCHAR* end = format_acceleration(json, value);
+
+  if ((end == NX_NULL) || nx_azure_iot_json_writer_append_property_name(json_writer, name, name_length) ||
+      nx_azure_iot_json_writer_append_json_text_trusted(
+          json_writer, json, (UINT)(end - json), AZ_JSON_TOKEN_END_OBJECT))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+static UCHAR* format_vibration(UCHAR* json, const PNP_MODEL_VIBRATION* value)
+{
+  json = FRAGMENT_COPY(json, "{\"x\":{\"rms\":");
+  json = double_format(json, value->x.rms);
+  json = FRAGMENT_COPY(json, ",\"p2p\":");
+  json = double_format(json, value->x.p2p);
+  json = FRAGMENT_COPY(json, ",\"crest\":");
+  json = double_format(json, value->x.crest);
+  json = FRAGMENT_COPY(json, ",\"band_1\":");
+  json = double_format(json, value->x.band_1);
+  json = FRAGMENT_COPY(json, ",\"band_2\":");
+  json = double_format(json, value->x.band_2);
+  json = FRAGMENT_COPY(json, ",\"band_3\":");
+  json = double_format(json, value->x.band_3);
+  json = FRAGMENT_COPY(json, ",\"band_4\":");
+  json = double_format(json, value->x.band_4);
+  json = FRAGMENT_COPY(json, "},\"y\":{\"rms\":");
+  json = double_format(json, value->y.rms);
+  json = FRAGMENT_COPY(json, ",\"p2p\":");
+  json = double_format(json, value->y.p2p);
+  json = FRAGMENT_COPY(json, ",\"crest\":");
+  json = double_format(json, value->y.crest);
+  json = FRAGMENT_COPY(json, ",\"band_1\":");
+  json = double_format(json, value->y.band_1);
+  json = FRAGMENT_COPY(json, ",\"band_2\":");
+  json = double_format(json, value->y.band_2);
+  json = FRAGMENT_COPY(json, ",\"band_3\":");
+  json = double_format(json, value->y.band_3);
+  json = FRAGMENT_COPY(json, ",\"band_4\":");
+  json = double_format(json, value->y.band_4);
+  json = FRAGMENT_COPY(json, "},\"z\":{\"rms\":");
+  json = double_format(json, value->z.rms);
+  json = FRAGMENT_COPY(json, ",\"p2p\":");
+  json = double_format(json, value->z.p2p);
+  json = FRAGMENT_COPY(json, ",\"crest\":");
+  json = double_format(json, value->z.crest);
+  json = FRAGMENT_COPY(json, ",\"band_1\":");
+  json = double_format(json, value->z.band_1);
+  json = FRAGMENT_COPY(json, ",\"band_2\":");
+  json = double_format(json, value->z.band_2);
+  json = FRAGMENT_COPY(json, ",\"band_3\":");
+  json = double_format(json, value->z.band_3);
+  json = FRAGMENT_COPY(json, ",\"band_4\":");
+  json = double_format(json, value->z.band_4);
+  return FRAGMENT_COPY(json, "}}");
+}
+
+static UINT append_vibration(
+    NX_AZURE_IOT_JSON_WRITER* json_writer, const UCHAR* name, UINT name_length, const PNP_MODEL_VIBRATION* value)
+{
+  UCHAR  json[VIBRATION_FORMAT_SIZE];
+  UCHAR* end = format_vibration(json, value);
+
+  if ((end == NX_NULL) || nx_azure_iot_json_writer_append_property_name(json_writer, name, name_length) ||
+      nx_azure_iot_json_writer_append_json_text_trusted(
+          json_writer, json, (UINT)(end - json), AZ_JSON_TOKEN_END_OBJECT))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+static UCHAR* format_gyroscope(UCHAR* json, const PNP_MODEL_GYROSCOPE* value)
+{
+  json = FRAGMENT_COPY(json, "{\"g_x\":");
+  json = double_format(json, value->g_x);
+  json = FRAGMENT_COPY(json, ",\"g_y\":");
+  json = double_format(json, value->g_y);
+  json = FRAGMENT_COPY(json, ",\"g_z\":");
+  json = double_format(json, value->g_z);
+  return FRAGMENT_COPY(json, "}");
+}
+
+static UINT append_gyroscope(
+    NX_AZURE_IOT_JSON_WRITER* json_writer, const UCHAR* name, UINT name_length, const PNP_MODEL_GYROSCOPE* value)
+{
+  UCHAR  json[GYROSCOPE_FORMAT_SIZE];
+  UCHAR* end = format_gyroscope(json, value);
+
+  if ((end == NX_NULL) || nx_azure_iot_json_writer_append_property_name(json_writer, name, name_length) ||
+      nx_azure_iot_json_writer_append_json_text_trusted(
+          json_writer, json, (UINT)(end - json), AZ_JSON_TOKEN_END_OBJECT))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+static UCHAR* format_magnetometer(UCHAR* json, const PNP_MODEL_MAGNETOMETER* value)
+{
+  json = FRAGMENT_COPY(json, "{\"m_x\":");
+  json = double_format(json, value->m_x);
+  json = FRAGMENT_COPY(json, ",\"m_y\":");
+  json = double_format(json, value->m_y);
+  json = FRAGMENT_COPY(json, ",\"m_z\":");
+  json = double_format(json, value->m_z);
+  return FRAGMENT_COPY(json, "}");
+}
+
+static UINT append_magnetometer(
+    NX_AZURE_IOT_JSON_WRITER* json_writer, const UCHAR* name, UINT name_length, const PNP_MODEL_MAGNETOMETER* value)
+{
+  UCHAR  json[MAGNETOMETER_FORMAT_SIZE];
+  UCHAR* end = format_magnetometer(json, value);
+
+  if ((end == NX_NULL) || nx_azure_iot_json_writer_append_property_name(json_writer, name, name_length) ||
+      nx_azure_iot_json_writer_append_json_text_trusted(
+          json_writer, json, (UINT)(end - json), AZ_JSON_TOKEN_END_OBJECT))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+static UINT parse_telemetry_interval(NX_AZURE_IOT_JSON_READER* json_reader, PNP_MODEL_WRITABLE_PROPERTIES* properties)
+{
+  return nx_azure_iot_json_reader_token_double_get(json_reader, &properties->telemetry_interval);
+}
+
+static UINT parse_acc_fullscale(NX_AZURE_IOT_JSON_READER* json_reader, PNP_MODEL_WRITABLE_PROPERTIES* properties)
+{
+  int32_t value;
+
+  if (nx_azure_iot_json_reader_token_int32_get(json_reader, &value))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  if (value < 0 || value > 3)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  properties->acc_fullscale = (PNP_MODEL_ACC_FULLSCALE)value;
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+static UINT parse_gyro_fullscale(NX_AZURE_IOT_JSON_READER* json_reader, PNP_MODEL_WRITABLE_PROPERTIES* properties)
+{
+  int32_t value;
+
+  if (nx_azure_iot_json_reader_token_int32_get(json_reader, &value))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  if (value < 0 || value > 4)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  properties->gyro_fullscale = (PNP_MODEL_GYRO_FULLSCALE)value;
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+/* Writable properties by hash, empty slots have no name */
+static const WRITABLE_ENTRY writable_table[1 << WRITABLE_HASH_BITS] = {
+    {NX_NULL, 0, NX_NULL, PNP_MODEL_WRITABLE_COUNT},
+    {name_gyro_fullscale,
+        sizeof(name_gyro_fullscale) - 1,
+        parse_gyro_fullscale,
+        PNP_MODEL_WRITABLE_GYRO_FULLSCALE},
+    {name_telemetry_interval,
+        sizeof(name_telemetry_interval) - 1,
+        parse_telemetry_interval,
+        PNP_MODEL_WRITABLE_TELEMETRY_INTERVAL},
+    {name_acc_fullscale,
+        sizeof(name_acc_fullscale) - 1,
+        parse_acc_fullscale,
+        PNP_MODEL_WRITABLE_ACC_FULLSCALE},
+};
+
+/* FNV-1a of the length, first and last bytes, which tell the writable properties apart. The
+   seed was searched by the generator for a hash without collisions. */
+static UINT writable_hash(const UCHAR* name, UINT name_length)
+{
+  uint32_t hash = (WRITABLE_HASH_SEED ^ name_length) * 16777619U;
+
+  hash = (hash ^ name[0]) * 16777619U;
+  hash = (hash ^ name[name_length - 1]) * 16777619U;
+
+  return hash >> (32 - WRITABLE_HASH_BITS);
+}
+
+UINT pnp_model_append_temperature(NX_AZURE_IOT_JSON_WRITER* json_writer, double temperature)
+{
+  return nx_azure_iot_json_writer_append_property_with_double_value(
+      json_writer, name_temperature, sizeof(name_temperature) - 1, temperature, 2);
+}
+
+UINT pnp_model_append_humidity(NX_AZURE_IOT_JSON_WRITER* json_writer, double humidity)
+{
+  return nx_azure_iot_json_writer_append_property_with_double_value(
+      json_writer, name_humidity, sizeof(name_humidity) - 1, humidity, 2);
+}
+
+UINT pnp_model_append_pressure(NX_AZURE_IOT_JSON_WRITER* json_writer, double pressure)
+{
+  return nx_azure_iot_json_writer_append_property_with_double_value(
+      json_writer, name_pressure, sizeof(name_pressure) - 1, pressure, 2);
+}
+
+UINT pnp_model_append_acceleration(NX_AZURE_IOT_JSON_WRITER* json_writer, const PNP_MODEL_ACCELERATION* acceleration)
+{
+  return append_acceleration(json_writer, name_acceleration, sizeof(name_acceleration) - 1, acceleration);
+}
+
+UINT pnp_model_append_vibration(NX_AZURE_IOT_JSON_WRITER* json_writer, const PNP_MODEL_VIBRATION* vibration)
+{
+  return append_vibration(json_writer, name_vibration, sizeof(name_vibration) - 1, vibration);
+}
+
+UINT pnp_model_append_gyroscope(NX_AZURE_IOT_JSON_WRITER* json_writer, const PNP_MODEL_GYROSCOPE* gyroscope)
+{
+  return append_gyroscope(json_writer, name_gyroscope, sizeof(name_gyroscope) - 1, gyroscope);
+}
+
+UINT pnp_model_append_magnetometer(NX_AZURE_IOT_JSON_WRITER* json_writer, const PNP_MODEL_MAGNETOMETER* magnetometer)
+{
+  return append_magnetometer(json_writer, name_magnetometer, sizeof(name_magnetometer) - 1, magnetometer);
+}
+
+UINT pnp_model_append_telemetry_interval(NX_AZURE_IOT_JSON_WRITER* json_writer, double telemetry_interval)
+{
+  return nx_azure_iot_json_writer_append_property_with_double_value(
+      json_writer, name_telemetry_interval, sizeof(name_telemetry_interval) - 1, telemetry_interval, 2);
+}
+
+UINT pnp_model_append_led_state(NX_AZURE_IOT_JSON_WRITER* json_writer, bool led_state)
+{
+  return nx_azure_iot_json_writer_append_property_with_bool_value(
+      json_writer, name_led_state, sizeof(name_led_state) - 1, led_state);
+}
+
+UINT pnp_model_append_acc_fullscale(NX_AZURE_IOT_JSON_WRITER* json_writer, PNP_MODEL_ACC_FULLSCALE acc_fullscale)
+{
+  return nx_azure_iot_json_writer_append_property_with_int32_value(
+      json_writer, name_acc_fullscale, sizeof(name_acc_fullscale) - 1, acc_fullscale);
+}
+
+UINT pnp_model_append_gyro_fullscale(NX_AZURE_IOT_JSON_WRITER* json_writer, PNP_MODEL_GYRO_FULLSCALE gyro_fullscale)
+{
+  return nx_azure_iot_json_writer_append_property_with_int32_value(
+      json_writer, name_gyro_fullscale, sizeof(name_gyro_fullscale) - 1, gyro_fullscale);
+}
+
+UINT pnp_model_writable_property_parse(const UCHAR* name,
+    UINT                                            name_length,
+    NX_AZURE_IOT_JSON_READER*                       json_reader,
+    PNP_MODEL_WRITABLE_PROPERTIES*                  properties,
+    PNP_MODEL_WRITABLE*                             property)
+{
+  const WRITABLE_ENTRY* entry;
+
+  // Empty slots have no name, an empty name would match them
+  if (name_length == 0)
+  {
+    return NX_AZURE_IOT_NOT_FOUND;
+  }
+
+  entry = &writable_table[writable_hash(name, name_length)];
+
+  if (entry->name_length != name_length || memcmp(entry->name, name, name_length) != 0)
+  {
+    return NX_AZURE_IOT_NOT_FOUND;
+  }
+
+  *property = entry->property;
+
+  if (entry->parse(json_reader, properties))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_AZURE_IOT_SUCCESS;
+}
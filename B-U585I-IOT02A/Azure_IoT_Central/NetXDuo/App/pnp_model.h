@@ -0,0 +1,151 @@
+/**
+ ******************************************************************************
+ * @file    pnp_model.h
+ * @author  Microsoft
+ * @brief   Device model serializers and writable property parser header file
+ ******************************************************************************
+ * @attention
+ *
+ * Generated from stm32-b-u585i-iot02a.json by
+ *   python3 dtdl_codegen.py stm32-b-u585i-iot02a.json ../NetXDuo/App --integer-digits 7
+ * Do not edit, change the model and run the generator again.
+ *
+ ******************************************************************************
+ */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PNP_MODEL_H__
+#define __PNP_MODEL_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nx_azure_iot_json_reader.h"
+#include "nx_azure_iot_json_writer.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define PNP_MODEL_ID "dtmi:stmicroelectronics:b_u585i_iot02a:2"
+
+/* Worst case bytes appended by each serializer, separating comma included.
+   Doubles are bounded to 7 integer and 2 fractional digits. */
+#define PNP_MODEL_TEMPERATURE_MAX_SIZE        26
+#define PNP_MODEL_HUMIDITY_MAX_SIZE           23
+#define PNP_MODEL_PRESSURE_MAX_SIZE           23
+#define PNP_MODEL_ACCELERATION_MAX_SIZE       71
+#define PNP_MODEL_VIBRATION_MAX_SIZE          452
+#define PNP_MODEL_GYROSCOPE_MAX_SIZE          68
+#define PNP_MODEL_MAGNETOMETER_MAX_SIZE       71
+#define PNP_MODEL_TELEMETRY_INTERVAL_MAX_SIZE 33
+#define PNP_MODEL_LED_STATE_MAX_SIZE          18
+#define PNP_MODEL_ACC_FULLSCALE_MAX_SIZE      18
+#define PNP_MODEL_GYRO_FULLSCALE_MAX_SIZE     19
+
+/* Every telemetry above in one object */
+#define PNP_MODEL_TELEMETRY_MAX_SIZE 735
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum PNP_MODEL_ACC_FULLSCALE_ENUM
+{
+  PNP_MODEL_ACC_FULLSCALE_G2  = 0,
+  PNP_MODEL_ACC_FULLSCALE_G4  = 1,
+  PNP_MODEL_ACC_FULLSCALE_G8  = 2,
+  PNP_MODEL_ACC_FULLSCALE_G16 = 3,
+} PNP_MODEL_ACC_FULLSCALE;
+
+typedef enum PNP_MODEL_GYRO_FULLSCALE_ENUM
+{
+  PNP_MODEL_GYRO_FULLSCALE_DPS125  = 0,
+  PNP_MODEL_GYRO_FULLSCALE_DPS250  = 1,
+  PNP_MODEL_GYRO_FULLSCALE_DPS500  = 2,
+  PNP_MODEL_GYRO_FULLSCALE_DPS1000 = 3,
+  PNP_MODEL_GYRO_FULLSCALE_DPS2000 = 4,
+} PNP_MODEL_GYRO_FULLSCALE;
+
+typedef struct PNP_MODEL_ACCELERATION_STRUCT
+{
+  double a_x;
+  double a_y;
+  double a_z;
+} PNP_MODEL_ACCELERATION;
+
+typedef struct PNP_MODEL_VIBRATION_X_STRUCT
+{
+  double rms;
+  double p2p;
+  double crest;
+  double band_1;
+  double band_2;
+  double band_3;
+  double band_4;
+} PNP_MODEL_VIBRATION_X;
+
+typedef struct PNP_MODEL_VIBRATION_STRUCT
+{
+  PNP_MODEL_VIBRATION_X x;
+  PNP_MODEL_VIBRATION_X y;
+  PNP_MODEL_VIBRATION_X z;
+} PNP_MODEL_VIBRATION;
+
+typedef struct PNP_MODEL_GYROSCOPE_STRUCT
+{
+  double g_x;
+  double g_y;
+  double g_z;
+} PNP_MODEL_GYROSCOPE;
+
+typedef struct PNP_MODEL_MAGNETOMETER_STRUCT
+{
+  double m_x;
+  double m_y;
+  double m_z;
+} PNP_MODEL_MAGNETOMETER;
+
+typedef enum PNP_MODEL_WRITABLE_ENUM
+{
+  PNP_MODEL_WRITABLE_TELEMETRY_INTERVAL,
+  PNP_MODEL_WRITABLE_ACC_FULLSCALE,
+  PNP_MODEL_WRITABLE_GYRO_FULLSCALE,
+  PNP_MODEL_WRITABLE_COUNT
+} PNP_MODEL_WRITABLE;
+
+/* Last value received for each writable property */
+typedef struct PNP_MODEL_WRITABLE_PROPERTIES_STRUCT
+{
+  double                   telemetry_interval;
+  PNP_MODEL_ACC_FULLSCALE  acc_fullscale;
+  PNP_MODEL_GYRO_FULLSCALE gyro_fullscale;
+} PNP_MODEL_WRITABLE_PROPERTIES;
+
+/* Exported functions prototypes ---------------------------------------------*/
+
+/* Append "name":value to an open object, for telemetry and reported properties */
+UINT pnp_model_append_temperature(NX_AZURE_IOT_JSON_WRITER* json_writer, double temperature);
+UINT pnp_model_append_humidity(NX_AZURE_IOT_JSON_WRITER* json_writer, double humidity);
+UINT pnp_model_append_pressure(NX_AZURE_IOT_JSON_WRITER* json_writer, double pressure);
+UINT pnp_model_append_acceleration(NX_AZURE_IOT_JSON_WRITER* json_writer, const PNP_MODEL_ACCELERATION* acceleration);
+UINT pnp_model_append_vibration(NX_AZURE_IOT_JSON_WRITER* json_writer, const PNP_MODEL_VIBRATION* vibration);
+UINT pnp_model_append_gyroscope(NX_AZURE_IOT_JSON_WRITER* json_writer, const PNP_MODEL_GYROSCOPE* gyroscope);
+UINT pnp_model_append_magnetometer(NX_AZURE_IOT_JSON_WRITER* json_writer, const PNP_MODEL_MAGNETOMETER* magnetometer);
+UINT pnp_model_append_telemetry_interval(NX_AZURE_IOT_JSON_WRITER* json_writer, double telemetry_interval);
+UINT pnp_model_append_led_state(NX_AZURE_IOT_JSON_WRITER* json_writer, bool led_state);
+UINT pnp_model_append_acc_fullscale(NX_AZURE_IOT_JSON_WRITER* json_writer, PNP_MODEL_ACC_FULLSCALE acc_fullscale);
+UINT pnp_model_append_gyro_fullscale(NX_AZURE_IOT_JSON_WRITER* json_writer, PNP_MODEL_GYRO_FULLSCALE gyro_fullscale);
+
+/* Store the value of the writable property name, the reader is on the value. Returns
+   NX_AZURE_IOT_NOT_FOUND for a name outside the model and NX_NOT_SUCCESSFUL for a value
+   outside its schema. */
+UINT pnp_model_writable_property_parse(const UCHAR* name,
+    UINT                                            name_length,
+    NX_AZURE_IOT_JSON_READER*                       json_reader,
+    PNP_MODEL_WRITABLE_PROPERTIES*                  properties,
+    PNP_MODEL_WRITABLE*                             property);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __PNP_MODEL_H__ */
@@ -11,6 +11,10 @@
 
 #include "nx_azure_iot_ciphersuites.h"
 
+#ifdef NX_AZURE_IOT_CRYPTO_HW
+#include "nx_azure_iot_crypto_hw.h"
+#endif /* NX_AZURE_IOT_CRYPTO_HW */
+
 #if (!NX_SECURE_TLS_TLS_1_2_ENABLED)
 #error "TLS 1.2 must be enabled."
 #endif /* (!NX_SECURE_TLS_TLS_1_2_ENABLED) */
@@ -26,6 +30,10 @@ extern NX_CRYPTO_METHOD crypto_method_tls_prf_sha256;
 extern NX_CRYPTO_METHOD crypto_method_sha256;
 extern NX_CRYPTO_METHOD crypto_method_sha384;
 extern NX_CRYPTO_METHOD crypto_method_aes_cbc_128;
+#ifdef NX_SECURE_ENABLE_AEAD_CIPHER
+extern NX_CRYPTO_METHOD crypto_method_none;
+extern NX_CRYPTO_METHOD crypto_method_aes_128_gcm_16;
+#endif /* NX_SECURE_ENABLE_AEAD_CIPHER */
 extern NX_CRYPTO_METHOD crypto_method_rsa;
 #ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
 extern NX_CRYPTO_METHOD crypto_method_ecdhe;
@@ -33,19 +41,48 @@ extern NX_CRYPTO_METHOD crypto_method_ecdsa;
 extern NX_CRYPTO_METHOD crypto_method_ec_secp384;
 #endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE */ 
 
+/* NX Secure looks methods up by algorithm, so the hardware methods replace the software ones in place.
+   The curves are listed in order of preference, P-256 first when its multiplication is offloaded.  */
 const NX_CRYPTO_METHOD *_nx_azure_iot_tls_supported_crypto[] =
 {
     &crypto_method_hmac,
+#ifdef NX_AZURE_IOT_CRYPTO_HW
+    &crypto_method_hmac_sha256_hw,
+#else
     &crypto_method_hmac_sha256,
+#endif /* NX_AZURE_IOT_CRYPTO_HW */
     &crypto_method_tls_prf_sha256,
+#ifdef NX_AZURE_IOT_CRYPTO_HW
+    &crypto_method_sha256_hw,
+#else
     &crypto_method_sha256,
+#endif /* NX_AZURE_IOT_CRYPTO_HW */
     &crypto_method_sha384,
+#ifdef NX_AZURE_IOT_CRYPTO_HW
+    &crypto_method_aes_cbc_128_hw,
+#else
     &crypto_method_aes_cbc_128,
+#endif /* NX_AZURE_IOT_CRYPTO_HW */
+#ifdef NX_SECURE_ENABLE_AEAD_CIPHER
+
+    /* AEAD ciphersuites have no MAC, their MAC role is the none method.  */
+    &crypto_method_none,
+#ifdef NX_AZURE_IOT_CRYPTO_HW
+    &crypto_method_aes_128_gcm_16_hw,
+#else
+    &crypto_method_aes_128_gcm_16,
+#endif /* NX_AZURE_IOT_CRYPTO_HW */
+#endif /* NX_SECURE_ENABLE_AEAD_CIPHER */
     &crypto_method_rsa,
 #ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
     &crypto_method_ecdhe,
     &crypto_method_ecdsa,
+#ifdef NX_AZURE_IOT_CRYPTO_HW
+    &crypto_method_ec_secp256_hw,
+    &crypto_method_ec_secp384_hw,
+#else
     &crypto_method_ec_secp384,
+#endif /* NX_AZURE_IOT_CRYPTO_HW */
 #endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE */
 };
 
@@ -54,6 +91,10 @@ const UINT _nx_azure_iot_tls_supported_crypto_size = sizeof(_nx_azure_iot_tls_su
 
 /* Define supported TLS ciphersuites.  */
 #ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
+#ifdef NX_SECURE_ENABLE_AEAD_CIPHER
+extern const NX_CRYPTO_CIPHERSUITE nx_crypto_tls_ecdhe_ecdsa_with_aes_128_gcm_sha256;
+extern const NX_CRYPTO_CIPHERSUITE nx_crypto_tls_ecdhe_rsa_with_aes_128_gcm_sha256;
+#endif /* NX_SECURE_ENABLE_AEAD_CIPHER */
 extern const NX_CRYPTO_CIPHERSUITE nx_crypto_tls_ecdhe_rsa_with_aes_128_cbc_sha256;
 #else
 extern const NX_CRYPTO_CIPHERSUITE nx_crypto_tls_rsa_with_aes_128_cbc_sha256;
@@ -69,8 +110,12 @@ extern const NX_CRYPTO_CIPHERSUITE nx_crypto_x509_ecdsa_sha_256;
 const NX_CRYPTO_CIPHERSUITE *_nx_azure_iot_tls_ciphersuite_map[] =
 {
 
-    /* TLS ciphersuites. */
+    /* TLS ciphersuites, in order of preference. */
 #ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
+#ifdef NX_SECURE_ENABLE_AEAD_CIPHER
+    &nx_crypto_tls_ecdhe_ecdsa_with_aes_128_gcm_sha256,
+    &nx_crypto_tls_ecdhe_rsa_with_aes_128_gcm_sha256,
+#endif /* NX_SECURE_ENABLE_AEAD_CIPHER */
     &nx_crypto_tls_ecdhe_rsa_with_aes_128_cbc_sha256,
 #else
     &nx_crypto_tls_rsa_with_aes_128_cbc_sha256,
@@ -21,9 +21,10 @@ extern const UINT _nx_azure_iot_tls_supported_crypto_size;
 extern const NX_CRYPTO_CIPHERSUITE *_nx_azure_iot_tls_ciphersuite_map[];
 extern const UINT _nx_azure_iot_tls_ciphersuite_map_size;
 
-/* Define the metadata size for _nx_azure_iot_tls_ciphers.  */
+/* Define the metadata size for _nx_azure_iot_tls_ciphers. This includes room for the GHASH
+   tables of the two AES-GCM session contexts (see NX_CRYPTO_GCM_GHASH_TABLE_BITS).  */
 #ifndef NX_AZURE_IOT_TLS_METADATA_BUFFER_SIZE
-#define NX_AZURE_IOT_TLS_METADATA_BUFFER_SIZE                     (10 * 1024)
+#define NX_AZURE_IOT_TLS_METADATA_BUFFER_SIZE                     (11 * 1024)
 #endif /* NX_AZURE_IOT_TLS_METADATA_BUFFER_SIZE  */
 
 #endif /* NX_AZURE_IOT_CIPHERSUITES_H */
@@ -26,8 +26,10 @@
 
 #include "nx_azure_iot_cert.h"
 #include "nx_azure_iot_ciphersuites.h"
+#include "nx_azure_iot_clock.h"
 
 #include "nx_azure_iot_connect.h"
+#include "nx_azure_iot_trace.h"
 
 #include "nx_azure_iot_hub_client_properties.h"
 /* USER CODE END Includes */
@@ -51,6 +53,19 @@
 #define HUB_WRITABLE_PROPERTIES_RECEIVE_EVENT 0x10
 #define HUB_PROPERTIES_COMPLETE_EVENT         0x20
 #define HUB_PERIODIC_TIMER_EVENT              0x40
+#define HUB_TELEMETRY_BATCH_EVENT             0x80
+
+/* Messages taken from a receive queue before the other events get a turn. */
+#define HUB_RECEIVE_BATCH_SIZE 8
+
+#define PROPERTY_NAME_MAX_LENGTH 64
+
+/* Batched samples carry the Unix time in milliseconds they were queued at. */
+#define TELEMETRY_TIMESTAMP "timestamp"
+
+/* Command status codes. */
+#define COMMAND_PAYLOAD_TOO_LARGE 413
+#define COMMAND_NOT_IMPLEMENTED   501
 
 #define DPS_ENDPOINT "global.azure-devices-provisioning.net"
 #define DPS_PAYLOAD  "{\"modelId\":\"%s\"}"
@@ -62,8 +77,6 @@
 #define DPS_REGISTER_TIMEOUT_TICKS (30 * TX_TIMER_TICKS_PER_SECOND)
 
 #define DPS_PAYLOAD_SIZE       (15 + 128)
-#define TELEMETRY_BUFFER_SIZE  256
-#define PROPERTIES_BUFFER_SIZE 128
 
 /* USER CODE END PD */
 
@@ -74,8 +87,7 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN PV */
-static UCHAR telemetry_buffer[TELEMETRY_BUFFER_SIZE];
-static UCHAR properties_buffer[PROPERTIES_BUFFER_SIZE];
+
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -99,6 +111,32 @@ static VOID printf_packet(CHAR* prepend, NX_PACKET* packet_ptr)
   printf("\r\n");
 }
 
+/* Print the last payload_length bytes of a packet chain, skipping the MQTT header */
+static VOID printf_packet_payload(CHAR* prepend, NX_PACKET* packet_ptr, ULONG payload_length)
+{
+  ULONG skip = packet_ptr->nx_packet_length - payload_length;
+  ULONG chunk;
+
+  printf("%s", prepend);
+
+  while (packet_ptr != NX_NULL)
+  {
+    chunk = (ULONG)(packet_ptr->nx_packet_append_ptr - packet_ptr->nx_packet_prepend_ptr);
+    if (skip < chunk)
+    {
+      printf("%.*s", (INT)(chunk - skip), (CHAR*)packet_ptr->nx_packet_prepend_ptr + skip);
+      skip = 0;
+    }
+    else
+    {
+      skip -= chunk;
+    }
+    packet_ptr = packet_ptr->nx_packet_next;
+  }
+
+  printf("\r\n");
+}
+
 static VOID connection_status_callback(NX_AZURE_IOT_HUB_CLIENT* hub_client_ptr, UINT status)
 {
   // :HACK: This callback doesn't allow us to provide context, pinch it from the command message callback args
@@ -120,6 +158,7 @@ static VOID connection_status_callback(NX_AZURE_IOT_HUB_CLIENT* hub_client_ptr,
 static VOID message_receive_command(NX_AZURE_IOT_HUB_CLIENT* hub_client_ptr, VOID* context)
 {
   AZURE_IOT_CONTEXT* nx_context = (AZURE_IOT_CONTEXT*)context;
+  nx_context->command_receive_tick = tx_time_get();
   tx_event_flags_set(&nx_context->events, HUB_COMMAND_RECEIVE_EVENT, TX_OR);
 }
 
@@ -266,6 +305,81 @@ static UINT iot_hub_initialize(AZURE_IOT_CONTEXT* context)
   return status;
 }
 
+/* FNV-1a, only used to detect a stale or torn DPS cache record */
+static ULONG dps_cache_hash(ULONG hash, const VOID* data, UINT length)
+{
+  const UCHAR* bytes = (const UCHAR*)data;
+
+  while (length--)
+  {
+    hash = (hash ^ *bytes++) * 16777619UL;
+  }
+
+  return hash;
+}
+
+static ULONG dps_cache_config_hash(AZURE_IOT_CONTEXT* context)
+{
+  ULONG hash = 2166136261UL;
+
+  hash = dps_cache_hash(hash, context->azure_iot_dps_id_scope, context->azure_iot_dps_id_scope_length);
+  hash = dps_cache_hash(hash, "/", 1);
+  hash = dps_cache_hash(hash, context->azure_iot_dps_registration_id, context->azure_iot_dps_registration_id_length);
+
+  return hash;
+}
+
+/* Load the hub config from the DPS cache, fails if there is no valid record for this registration */
+static UINT dps_cache_load(AZURE_IOT_CONTEXT* context)
+{
+  AZURE_IOT_DPS_CACHE cache;
+
+  if (context->dps_cache_read == NULL || context->dps_cache_read(&cache) != NX_SUCCESS)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  if (cache.magic != AZURE_IOT_DPS_CACHE_MAGIC ||
+      cache.checksum != dps_cache_hash(2166136261UL, &cache, offsetof(AZURE_IOT_DPS_CACHE, checksum)) ||
+      cache.config_hash != dps_cache_config_hash(context) || cache.hub_hostname_length == 0 ||
+      cache.hub_hostname_length > sizeof(cache.hub_hostname) || cache.hub_device_id_length == 0 ||
+      cache.hub_device_id_length > sizeof(cache.hub_device_id))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  memcpy(context->azure_iot_hub_hostname, cache.hub_hostname, cache.hub_hostname_length);
+  memcpy(context->azure_iot_hub_device_id, cache.hub_device_id, cache.hub_device_id_length);
+  context->azure_iot_hub_hostname_length  = cache.hub_hostname_length;
+  context->azure_iot_hub_device_id_length = cache.hub_device_id_length;
+
+  return NX_SUCCESS;
+}
+
+static VOID dps_cache_store(AZURE_IOT_CONTEXT* context)
+{
+  AZURE_IOT_DPS_CACHE cache;
+
+  if (context->dps_cache_write == NULL)
+  {
+    return;
+  }
+
+  memset(&cache, 0, sizeof(cache));
+  cache.magic       = AZURE_IOT_DPS_CACHE_MAGIC;
+  cache.config_hash = dps_cache_config_hash(context);
+  memcpy(cache.hub_hostname, context->azure_iot_hub_hostname, context->azure_iot_hub_hostname_length);
+  memcpy(cache.hub_device_id, context->azure_iot_hub_device_id, context->azure_iot_hub_device_id_length);
+  cache.hub_hostname_length  = context->azure_iot_hub_hostname_length;
+  cache.hub_device_id_length = context->azure_iot_hub_device_id_length;
+  cache.checksum             = dps_cache_hash(2166136261UL, &cache, offsetof(AZURE_IOT_DPS_CACHE, checksum));
+
+  if (context->dps_cache_write(&cache) != NX_SUCCESS)
+  {
+    printf("WARNING: failed to store the DPS result\r\n");
+  }
+}
+
 /**
  * @brief  Initialize DPS client.
  * @param context: AZURE_IOT_CONTEXT
@@ -273,8 +387,9 @@ static UINT iot_hub_initialize(AZURE_IOT_CONTEXT* context)
  */
 static UINT dps_initialize(AZURE_IOT_CONTEXT* context)
 {
-  UINT status;
-  CHAR payload[DPS_PAYLOAD_SIZE];
+  UINT  status;
+  CHAR  payload[DPS_PAYLOAD_SIZE];
+  ULONG start_tick;
 
   if (context == NULL)
   {
@@ -289,6 +404,14 @@ static UINT dps_initialize(AZURE_IOT_CONTEXT* context)
     return NX_PTR_ERROR;
   }
 
+  // Connect straight to the hub assigned on a previous boot
+  context->dps_cache_used = (dps_cache_load(context) == NX_SUCCESS);
+  if (context->dps_cache_used)
+  {
+    printf("\r\nUsing the IoT Hub assignment cached from DPS\r\n");
+    return iot_hub_initialize(context);
+  }
+
   printf("\r\nInitializing Azure IoT DPS client\r\n");
   printf("\tDPS endpoint: %s\r\n", DPS_ENDPOINT);
   printf("\tDPS ID scope: %.*s\r\n", context->azure_iot_dps_id_scope_length, context->azure_iot_dps_id_scope);
@@ -306,6 +429,8 @@ static UINT dps_initialize(AZURE_IOT_CONTEXT* context)
     return NX_SIZE_ERROR;
   }
 
+  start_tick = tx_time_get();
+
   // Initialize IoT provisioning client
   if ((status = nx_azure_iot_provisioning_client_initialize(&context->dps_client,
            &context->nx_azure_iot,
@@ -400,6 +525,9 @@ static UINT dps_initialize(AZURE_IOT_CONTEXT* context)
   }
 
   printf("SUCCESS: Azure IoT DPS client initialized\r\n");
+  printf("\tDPS provisioning: %lu ms\r\n", (tx_time_get() - start_tick) * 1000 / TX_TIMER_TICKS_PER_SECOND);
+
+  dps_cache_store(context);
 
   return iot_hub_initialize(context);
 }
@@ -407,18 +535,36 @@ static UINT dps_initialize(AZURE_IOT_CONTEXT* context)
 static VOID process_connect(AZURE_IOT_CONTEXT* context)
 {
   UINT status;
+  UINT active;
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+  ULONG tls_resumed;
+  ULONG tls_full;
+
+  if (nx_azure_iot_tls_session_statistics_get(&context->nx_azure_iot, &tls_resumed, &tls_full) == NX_AZURE_IOT_SUCCESS)
+  {
+    printf("TLS handshakes: %lu resumed, %lu full\r\n", tls_resumed, tls_full);
+  }
+#endif
 
   // Request the client properties
+  NX_PHASE_TRACE_BEGIN(NX_PHASE_TWIN_GET);
   if ((status = nx_azure_iot_hub_client_properties_request(&context->iothub_client, NX_WAIT_FOREVER)))
   {
     printf("ERROR: failed to request properties (0x%08x)\r\n", status);
   }
 
-  // Start the periodic timer
-  if ((status = tx_timer_activate(&context->periodic_timer)))
+  // Start the periodic timer, it is left running across a disconnect when telemetry is batched
+  if ((status = tx_timer_info_get(&context->periodic_timer, NX_NULL, &active, NX_NULL, NX_NULL, NX_NULL)) ||
+      (active == TX_FALSE && (status = tx_timer_activate(&context->periodic_timer))))
   {
     printf("ERROR: tx_timer_activate (0x%08x)\r\n", status);
   }
+
+  // Send the samples batched while disconnected
+  if (context->telemetry_batch.count > 0)
+  {
+    nx_azure_iot_client_flush_telemetry(context);
+  }
 }
 
 static VOID process_disconnect(AZURE_IOT_CONTEXT* context)
@@ -427,8 +573,8 @@ static VOID process_disconnect(AZURE_IOT_CONTEXT* context)
 
   printf("Disconnected from IoT Hub\r\n");
 
-  // Stop the periodic timer
-  if ((status = tx_timer_deactivate(&context->periodic_timer)))
+  // Stop the periodic timer, unless telemetry is batched and can keep sampling while disconnected
+  if (context->telemetry_batch.max_samples == 0 && (status = tx_timer_deactivate(&context->periodic_timer)))
   {
     printf("ERROR: tx_timer_deactivate (0x%08x)\r\n", status);
   }
@@ -442,6 +588,268 @@ static VOID process_timer_event(AZURE_IOT_CONTEXT* context)
   }
 }
 
+static VOID process_command(AZURE_IOT_CONTEXT* context)
+{
+  UINT         status;
+  UINT         count;
+  NX_PACKET*   packet_ptr;
+  VOID*        context_ptr;
+  USHORT       context_length;
+  const UCHAR* component_name_ptr;
+  USHORT       component_name_length;
+  const UCHAR* command_name_ptr;
+  USHORT       command_name_length;
+
+  for (count = 0; count < HUB_RECEIVE_BATCH_SIZE; count++)
+  {
+    if ((status = nx_azure_iot_hub_client_command_message_receive(&context->iothub_client,
+             &component_name_ptr,
+             &component_name_length,
+             &command_name_ptr,
+             &command_name_length,
+             &context_ptr,
+             &context_length,
+             &packet_ptr,
+             NX_NO_WAIT)))
+    {
+      if (status != NX_AZURE_IOT_NO_PACKET)
+      {
+        printf("Error: command receive failed (0x%08x)\r\n", status);
+      }
+      return;
+    }
+
+    printf("Receive command: %.*s (%lu ms)\r\n",
+        command_name_length,
+        command_name_ptr,
+        (tx_time_get() - context->command_receive_tick) * 1000 / TX_TIMER_TICKS_PER_SECOND);
+
+    if (context->command_received_cb == NX_NULL)
+    {
+      printf("Warning: No command callback set\r\n");
+      status = nx_azure_iot_hub_client_command_message_response(
+          &context->iothub_client, COMMAND_NOT_IMPLEMENTED, context_ptr, context_length, NX_NULL, 0, NX_WAIT_FOREVER);
+    }
+
+    else if (packet_ptr->nx_packet_next != NX_NULL)
+    {
+      printf("Error: command payload does not fit in a single packet\r\n");
+      status = nx_azure_iot_hub_client_command_message_response(
+          &context->iothub_client, COMMAND_PAYLOAD_TOO_LARGE, context_ptr, context_length, NX_NULL, 0, NX_WAIT_FOREVER);
+    }
+
+    else
+    {
+      context->command_received_cb(context,
+          component_name_ptr,
+          component_name_length,
+          command_name_ptr,
+          command_name_length,
+          packet_ptr->nx_packet_prepend_ptr,
+          packet_ptr->nx_packet_length,
+          context_ptr,
+          context_length);
+    }
+
+    if (status)
+    {
+      printf("Error: command response failed (0x%08x)\r\n", status);
+    }
+
+    nx_packet_release(packet_ptr);
+  }
+
+  // More may be queued, come back after the other events have been handled
+  tx_event_flags_set(&context->events, HUB_COMMAND_RECEIVE_EVENT, TX_OR);
+}
+
+static VOID process_properties_shared(AZURE_IOT_CONTEXT* context,
+    NX_PACKET*                                           packet_ptr,
+    UINT                                                 message_type,
+    UINT                                                 property_type,
+    func_ptr_writable_property_received                  callback)
+{
+  UINT                     status;
+  ULONG                    properties_version;
+  NX_AZURE_IOT_JSON_READER json_reader;
+  const UCHAR*             component_name_ptr    = NX_NULL;
+  USHORT                   component_name_length = 0;
+  UCHAR                    property_name[PROPERTY_NAME_MAX_LENGTH];
+  UINT                     property_name_length;
+
+  if ((status = nx_azure_iot_json_reader_init(&json_reader, packet_ptr)))
+  {
+    printf("Error: failed to initialize json reader (0x%08x)\r\n", status);
+    return;
+  }
+
+  if ((status = nx_azure_iot_hub_client_properties_version_get(
+           &context->iothub_client, &json_reader, message_type, &properties_version)))
+  {
+    printf("Error: failed to get properties version (0x%08x)\r\n", status);
+    return;
+  }
+
+  // The version lookup moved the reader, start again from the top of the document
+  if ((status = nx_azure_iot_json_reader_init(&json_reader, packet_ptr)))
+  {
+    printf("Error: failed to initialize json reader (0x%08x)\r\n", status);
+    return;
+  }
+
+  while ((status = nx_azure_iot_hub_client_properties_component_property_next_get(&context->iothub_client,
+              &json_reader,
+              message_type,
+              property_type,
+              &component_name_ptr,
+              &component_name_length)) == NX_AZURE_IOT_SUCCESS)
+  {
+    if ((status = nx_azure_iot_json_reader_token_string_get(
+             &json_reader, property_name, sizeof(property_name), &property_name_length)))
+    {
+      printf("Error: failed to get property name (0x%08x)\r\n", status);
+      break;
+    }
+
+    nx_azure_iot_json_reader_next_token(&json_reader);
+
+    callback(context,
+        component_name_ptr,
+        component_name_length,
+        property_name,
+        property_name_length,
+        &json_reader,
+        properties_version);
+
+    // Move past the value whether or not the callback read it
+    nx_azure_iot_json_reader_skip_children(&json_reader);
+    nx_azure_iot_json_reader_next_token(&json_reader);
+  }
+
+  if (status != NX_AZURE_IOT_SUCCESS && status != NX_AZURE_IOT_NOT_FOUND)
+  {
+    printf("Error: failed to parse properties (0x%08x)\r\n", status);
+  }
+
+  nx_azure_iot_json_reader_deinit(&json_reader);
+}
+
+static VOID process_properties(AZURE_IOT_CONTEXT* context)
+{
+  UINT       status;
+  UINT       count;
+  NX_PACKET* packet_ptr;
+
+  for (count = 0; count < HUB_RECEIVE_BATCH_SIZE; count++)
+  {
+    if ((status = nx_azure_iot_hub_client_properties_receive(&context->iothub_client, &packet_ptr, NX_NO_WAIT)))
+    {
+      if (status != NX_AZURE_IOT_NO_PACKET)
+      {
+        printf("Error: properties receive failed (0x%08x)\r\n", status);
+      }
+      return;
+    }
+
+    NX_PHASE_TRACE_END(NX_PHASE_TWIN_GET);
+
+    printf_packet("Receive properties: ", packet_ptr);
+
+    // Full document, desired properties first then the ones reported by the device
+    if (context->writable_property_received_cb)
+    {
+      process_properties_shared(context,
+          packet_ptr,
+          NX_AZURE_IOT_HUB_PROPERTIES,
+          NX_AZURE_IOT_HUB_CLIENT_PROPERTY_WRITABLE,
+          context->writable_property_received_cb);
+    }
+
+    if (context->property_received_cb)
+    {
+      process_properties_shared(context,
+          packet_ptr,
+          NX_AZURE_IOT_HUB_PROPERTIES,
+          NX_AZURE_IOT_HUB_CLIENT_PROPERTY_REPORTED_FROM_DEVICE,
+          context->property_received_cb);
+    }
+
+    nx_packet_release(packet_ptr);
+
+    tx_event_flags_set(&context->events, HUB_PROPERTIES_COMPLETE_EVENT, TX_OR);
+  }
+
+  tx_event_flags_set(&context->events, HUB_PROPERTIES_RECEIVE_EVENT, TX_OR);
+}
+
+static VOID process_writable_properties(AZURE_IOT_CONTEXT* context)
+{
+  UINT       status;
+  UINT       count;
+  NX_PACKET* packet_ptr;
+
+  for (count = 0; count < HUB_RECEIVE_BATCH_SIZE; count++)
+  {
+    if ((status = nx_azure_iot_hub_client_writable_properties_receive(
+             &context->iothub_client, &packet_ptr, NX_NO_WAIT)))
+    {
+      if (status != NX_AZURE_IOT_NO_PACKET)
+      {
+        printf("Error: writable properties receive failed (0x%08x)\r\n", status);
+      }
+      return;
+    }
+
+    printf_packet("Receive writable property: ", packet_ptr);
+
+    if (context->writable_property_received_cb)
+    {
+      process_properties_shared(context,
+          packet_ptr,
+          NX_AZURE_IOT_HUB_WRITABLE_PROPERTIES,
+          NX_AZURE_IOT_HUB_CLIENT_PROPERTY_WRITABLE,
+          context->writable_property_received_cb);
+    }
+
+    nx_packet_release(packet_ptr);
+  }
+
+  tx_event_flags_set(&context->events, HUB_WRITABLE_PROPERTIES_RECEIVE_EVENT, TX_OR);
+}
+
+static VOID process_properties_complete(AZURE_IOT_CONTEXT* context)
+{
+  if (context->properties_complete_cb)
+  {
+    context->properties_complete_cb(context);
+  }
+}
+
+/* Send a telemetry message, the MQTT client ends the PUBACK phase when the hub acknowledges it. The connection
+   trace is printed on the send following the first PUBACK */
+static UINT telemetry_send(AZURE_IOT_CONTEXT* context, NX_AZURE_IOT_JSON_WRITER* json_writer_ptr)
+{
+  if (nx_azure_iot_trace_get()->phase[NX_PHASE_MQTT_PUBACK].count == 1)
+  {
+    nx_azure_iot_trace_print();
+  }
+
+  NX_PHASE_TRACE_BEGIN(NX_PHASE_MQTT_PUBACK);
+
+  return nx_azure_iot_hub_client_telemetry_json_writer_send(&context->iothub_client, json_writer_ptr, NX_WAIT_FOREVER);
+}
+
+static VOID process_telemetry_batch(AZURE_IOT_CONTEXT* context)
+{
+  AZURE_IOT_TELEMETRY_BATCH* batch = &context->telemetry_batch;
+
+  // Flush on age, the count and byte thresholds are checked as samples are queued
+  if (batch->count > 0 && batch->max_age_ticks > 0 && (tx_time_get() - batch->oldest_tick) >= batch->max_age_ticks)
+  {
+    nx_azure_iot_client_flush_telemetry(context);
+  }
+}
+
 UINT nx_azure_iot_client_publish_telemetry(
   AZURE_IOT_CONTEXT* context, CHAR* component_name_ptr, 
   UINT (*append_properties)(NX_AZURE_IOT_JSON_WRITER* json_writer_ptr))
@@ -455,9 +863,22 @@ UINT nx_azure_iot_client_publish_telemetry(
            &context->iothub_client, &packet_ptr, NX_WAIT_FOREVER)))
   {
     printf("Error: nx_azure_iot_hub_client_telemetry_message_create failed (0x%08x)\r\n", status);
+    return status;
   }
 
-  if ((status = nx_azure_iot_json_writer_with_buffer_init(&json_writer, telemetry_buffer, sizeof(telemetry_buffer))))
+  // A component is carried by the $.sub message property, the payload stays flat
+  if (component_name_ptr != NX_NULL &&
+      (status = nx_azure_iot_hub_client_telemetry_component_set(
+           packet_ptr, (UCHAR*)component_name_ptr, strlen(component_name_ptr), NX_WAIT_FOREVER)))
+  {
+    printf("Error: nx_azure_iot_hub_client_telemetry_component_set failed (0x%08x)\r\n", status);
+    nx_azure_iot_hub_client_telemetry_message_delete(packet_ptr);
+    return status;
+  }
+
+  /* Build the payload in the publish packet, chaining packets from the pool as needed */
+  if ((status = nx_azure_iot_hub_client_telemetry_json_writer_init(
+           &context->iothub_client, packet_ptr, &json_writer, NX_WAIT_FOREVER)))
   {
     printf("Error: Failed to initialize json writer (0x%08x)\r\n", status);
     nx_azure_iot_hub_client_telemetry_message_delete(packet_ptr);
@@ -465,12 +886,7 @@ UINT nx_azure_iot_client_publish_telemetry(
   }
 
   if ((status = nx_azure_iot_json_writer_append_begin_object(&json_writer)) ||
-      (component_name_ptr != NX_NULL &&
-          (status = nx_azure_iot_hub_client_reported_properties_component_begin(
-               &context->iothub_client, &json_writer, (UCHAR*)component_name_ptr, strlen(component_name_ptr)))) ||
       (status = append_properties(&json_writer)) ||
-      (component_name_ptr != NX_NULL && (status = nx_azure_iot_hub_client_reported_properties_component_end(
-                                             &context->iothub_client, &json_writer))) ||
       (status = nx_azure_iot_json_writer_append_end_object(&json_writer)))
   {
     printf("Error: Failed to build telemetry (0x%08x)\r\n", status);
@@ -479,19 +895,257 @@ UINT nx_azure_iot_client_publish_telemetry(
   }
 
   telemetry_length = nx_azure_iot_json_writer_get_bytes_used(&json_writer);
-  if ((status = nx_azure_iot_hub_client_telemetry_send(
-           &context->iothub_client, packet_ptr, telemetry_buffer, telemetry_length, NX_WAIT_FOREVER)))
+  printf_packet_payload("Sending telemetry: ", packet_ptr, telemetry_length);
+
+  if ((status = telemetry_send(context, &json_writer)))
   {
     printf("Error: Telemetry message send failed (0x%08x)\r\n", status);
     nx_azure_iot_hub_client_telemetry_message_delete(packet_ptr);
     return status;
   }
 
-  printf("Telemetry message sent: %.*s.\r\n", telemetry_length, telemetry_buffer);
-
   return status;
 }
 
+/* Copy to and from the telemetry batch ring, wrapping at the end of the buffer */
+static VOID telemetry_batch_write(AZURE_IOT_TELEMETRY_BATCH* batch, UINT offset, const UCHAR* data, UINT length)
+{
+  UINT index = offset % AZURE_IOT_TELEMETRY_BATCH_SIZE;
+  UINT chunk = AZURE_IOT_TELEMETRY_BATCH_SIZE - index;
+
+  if (chunk > length)
+  {
+    chunk = length;
+  }
+
+  memcpy(&batch->buffer[index], data, chunk);
+  memcpy(batch->buffer, data + chunk, length - chunk);
+}
+
+static VOID telemetry_batch_read(AZURE_IOT_TELEMETRY_BATCH* batch, UINT offset, UCHAR* data, UINT length)
+{
+  UINT index = offset % AZURE_IOT_TELEMETRY_BATCH_SIZE;
+  UINT chunk = AZURE_IOT_TELEMETRY_BATCH_SIZE - index;
+
+  if (chunk > length)
+  {
+    chunk = length;
+  }
+
+  memcpy(data, &batch->buffer[index], chunk);
+  memcpy(data + chunk, batch->buffer, length - chunk);
+}
+
+static UINT telemetry_batch_sample_length(AZURE_IOT_TELEMETRY_BATCH* batch, UINT offset)
+{
+  UCHAR header[sizeof(USHORT)];
+
+  telemetry_batch_read(batch, offset, header, sizeof(header));
+
+  return (UINT)(header[0] | (header[1] << 8));
+}
+
+static VOID telemetry_batch_drop_oldest(AZURE_IOT_TELEMETRY_BATCH* batch)
+{
+  UINT length = telemetry_batch_sample_length(batch, batch->head);
+
+  batch->head = (batch->head + sizeof(USHORT) + length) % AZURE_IOT_TELEMETRY_BATCH_SIZE;
+  batch->used -= sizeof(USHORT) + length;
+  batch->payload_length -= length;
+  batch->count--;
+  batch->dropped++;
+}
+
+/* Size of the JSON array holding every queued sample */
+static UINT telemetry_batch_array_length(AZURE_IOT_TELEMETRY_BATCH* batch)
+{
+  return batch->payload_length + batch->count + 1;
+}
+
+UINT nx_azure_iot_client_telemetry_batch_set(
+    AZURE_IOT_CONTEXT* context, UINT max_samples, UINT max_bytes, UINT max_age)
+{
+  AZURE_IOT_TELEMETRY_BATCH* batch;
+
+  if (context == NULL)
+  {
+    return NX_PTR_ERROR;
+  }
+
+  batch = &context->telemetry_batch;
+
+  tx_mutex_get(&batch->lock, TX_WAIT_FOREVER);
+  batch->max_samples   = max_samples;
+  batch->max_bytes     = max_bytes;
+  batch->max_age_ticks = max_age * TX_TIMER_TICKS_PER_SECOND;
+  tx_mutex_put(&batch->lock);
+
+  return NX_SUCCESS;
+}
+
+UINT nx_azure_iot_client_queue_telemetry(AZURE_IOT_CONTEXT* context,
+    CHAR*                                                   component_name_ptr,
+    UINT (*append_properties)(NX_AZURE_IOT_JSON_WRITER* json_writer_ptr))
+{
+  UINT                       status;
+  UINT                       sample_length;
+  UCHAR                      header[sizeof(USHORT)];
+  UINT                       flush;
+  ULONG64                    timestamp;
+  NX_AZURE_IOT_JSON_WRITER   json_writer;
+  AZURE_IOT_TELEMETRY_BATCH* batch = &context->telemetry_batch;
+
+  // A batch message has a single component, component telemetry is sent on its own
+  if (batch->max_samples == 0 || component_name_ptr != NX_NULL)
+  {
+    return nx_azure_iot_client_publish_telemetry(context, component_name_ptr, append_properties);
+  }
+
+  tx_mutex_get(&batch->lock, TX_WAIT_FOREVER);
+
+  // The sample leaves later, stamp it now. Left out until the clock had its first SNTP update.
+  if ((status = nx_azure_iot_json_writer_with_buffer_init(&json_writer, batch->sample, sizeof(batch->sample))) ||
+      (status = nx_azure_iot_json_writer_append_begin_object(&json_writer)) ||
+      (nx_azure_iot_clock_get_ms(&timestamp) == NX_SUCCESS &&
+          (status = nx_azure_iot_json_writer_append_property_with_double_value(&json_writer,
+               (UCHAR*)TELEMETRY_TIMESTAMP,
+               sizeof(TELEMETRY_TIMESTAMP) - 1,
+               (double)timestamp,
+               0))) ||
+      (status = append_properties(&json_writer)) ||
+      (status = nx_azure_iot_json_writer_append_end_object(&json_writer)))
+  {
+    printf("Error: Failed to build telemetry sample (0x%08x)\r\n", status);
+    tx_mutex_put(&batch->lock);
+    return status;
+  }
+
+  sample_length = nx_azure_iot_json_writer_get_bytes_used(&json_writer);
+
+  // Make room by discarding the oldest samples, only happens after a long disconnect
+  while (batch->used + sizeof(header) + sample_length > AZURE_IOT_TELEMETRY_BATCH_SIZE)
+  {
+    telemetry_batch_drop_oldest(batch);
+  }
+
+  if (batch->count == 0)
+  {
+    batch->oldest_tick = tx_time_get();
+    tx_event_flags_set(&context->events, HUB_TELEMETRY_BATCH_EVENT, TX_OR);
+  }
+
+  header[0] = (UCHAR)(sample_length & 0xFF);
+  header[1] = (UCHAR)(sample_length >> 8);
+  telemetry_batch_write(batch, batch->head + batch->used, header, sizeof(header));
+  telemetry_batch_write(batch, batch->head + batch->used + sizeof(header), batch->sample, sample_length);
+
+  batch->used += sizeof(header) + sample_length;
+  batch->payload_length += sample_length;
+  batch->count++;
+
+  flush = (batch->count >= batch->max_samples) ||
+          (batch->max_bytes > 0 && telemetry_batch_array_length(batch) >= batch->max_bytes);
+
+  tx_mutex_put(&batch->lock);
+
+  if (flush)
+  {
+    nx_azure_iot_client_flush_telemetry(context);
+  }
+
+  return NX_SUCCESS;
+}
+
+UINT nx_azure_iot_client_flush_telemetry(AZURE_IOT_CONTEXT* context)
+{
+  UINT                       status;
+  UINT                       index;
+  UINT                       offset;
+  UINT                       sample_length;
+  NX_PACKET*                 packet_ptr;
+  NX_AZURE_IOT_JSON_WRITER   json_writer;
+  AZURE_IOT_TELEMETRY_BATCH* batch = &context->telemetry_batch;
+
+  tx_mutex_get(&batch->lock, TX_WAIT_FOREVER);
+
+  if (batch->count == 0)
+  {
+    tx_mutex_put(&batch->lock);
+    return NX_SUCCESS;
+  }
+
+  // Hold on to the samples until the hub is connected again
+  if (context->azure_iot_connection_status != NX_SUCCESS)
+  {
+    tx_mutex_put(&batch->lock);
+    return NX_AZURE_IOT_DISCONNECTED;
+  }
+
+  if ((status = nx_azure_iot_hub_client_telemetry_message_create(
+           &context->iothub_client, &packet_ptr, NX_WAIT_FOREVER)))
+  {
+    printf("Error: nx_azure_iot_hub_client_telemetry_message_create failed (0x%08x)\r\n", status);
+    tx_mutex_put(&batch->lock);
+    return status;
+  }
+
+  if ((status = nx_azure_iot_hub_client_telemetry_json_writer_init(
+           &context->iothub_client, packet_ptr, &json_writer, NX_WAIT_FOREVER)))
+  {
+    printf("Error: Failed to initialize json writer (0x%08x)\r\n", status);
+    nx_azure_iot_hub_client_telemetry_message_delete(packet_ptr);
+    tx_mutex_put(&batch->lock);
+    return status;
+  }
+
+  status = nx_azure_iot_json_writer_append_begin_array(&json_writer);
+
+  for (index = 0, offset = batch->head; status == NX_AZURE_IOT_SUCCESS && index < batch->count; index++)
+  {
+    sample_length = telemetry_batch_sample_length(batch, offset);
+    telemetry_batch_read(batch, offset + sizeof(USHORT), batch->sample, sample_length);
+    status = nx_azure_iot_json_writer_append_json_text(&json_writer, batch->sample, sample_length);
+    offset += sizeof(USHORT) + sample_length;
+  }
+
+  if (status == NX_AZURE_IOT_SUCCESS)
+  {
+    status = nx_azure_iot_json_writer_append_end_array(&json_writer);
+  }
+
+  if (status)
+  {
+    printf("Error: Failed to build telemetry batch (0x%08x)\r\n", status);
+    nx_azure_iot_hub_client_telemetry_message_delete(packet_ptr);
+    tx_mutex_put(&batch->lock);
+    return status;
+  }
+
+  printf("Sending telemetry batch: %u samples, %u bytes, %lu dropped\r\n",
+      batch->count,
+      nx_azure_iot_json_writer_get_bytes_used(&json_writer),
+      batch->dropped);
+
+  // Samples stay queued on failure and go out with the next flush
+  if ((status = telemetry_send(context, &json_writer)))
+  {
+    printf("Error: Telemetry batch send failed (0x%08x)\r\n", status);
+    nx_azure_iot_hub_client_telemetry_message_delete(packet_ptr);
+    tx_mutex_put(&batch->lock);
+    return status;
+  }
+
+  batch->head           = 0;
+  batch->used           = 0;
+  batch->count          = 0;
+  batch->payload_length = 0;
+  batch->dropped        = 0;
+
+  tx_mutex_put(&batch->lock);
+
+  return NX_SUCCESS;
+}
+
 UINT nx_azure_iot_client_periodic_interval_set(AZURE_IOT_CONTEXT* context, INT interval)
 {
   UINT status;
@@ -637,6 +1291,40 @@ UINT nx_azure_iot_client_publish_bool_property(
   return status;
 }
 
+UINT nx_azure_iot_client_register_command_callback(AZURE_IOT_CONTEXT* context, func_ptr_command_received callback)
+{
+  if (context == NULL || context->command_received_cb != NULL)
+  {
+    return NX_PTR_ERROR;
+  }
+
+  context->command_received_cb = callback;
+  return NX_SUCCESS;
+}
+
+UINT nx_azure_iot_client_register_writable_property_callback(
+    AZURE_IOT_CONTEXT* context, func_ptr_writable_property_received callback)
+{
+  if (context == NULL || context->writable_property_received_cb != NULL)
+  {
+    return NX_PTR_ERROR;
+  }
+
+  context->writable_property_received_cb = callback;
+  return NX_SUCCESS;
+}
+
+UINT nx_azure_iot_client_register_property_callback(AZURE_IOT_CONTEXT* context, func_ptr_property_received callback)
+{
+  if (context == NULL || context->property_received_cb != NULL)
+  {
+    return NX_PTR_ERROR;
+  }
+
+  context->property_received_cb = callback;
+  return NX_SUCCESS;
+}
+
 UINT nx_azure_iot_client_register_properties_complete_callback(
     AZURE_IOT_CONTEXT* context, func_ptr_properties_complete callback)
 {
@@ -664,6 +1352,67 @@ UINT nx_azure_iot_client_register_timer_callback(
   return NX_SUCCESS;
 }
 
+UINT nx_azure_iot_client_register_dps_cache(
+    AZURE_IOT_CONTEXT* context, func_ptr_dps_cache_read read, func_ptr_dps_cache_write write)
+{
+  if (context == NULL || read == NULL || write == NULL)
+  {
+    return NX_PTR_ERROR;
+  }
+
+  context->dps_cache_read  = read;
+  context->dps_cache_write = write;
+
+  return NX_SUCCESS;
+}
+
+VOID nx_azure_iot_client_dps_cache_invalidate(AZURE_IOT_CONTEXT* context)
+{
+  AZURE_IOT_DPS_CACHE cache;
+
+  if (!context->dps_cache_used)
+  {
+    return;
+  }
+
+  printf("Cached IoT Hub assignment rejected, provisioning again\r\n");
+
+  context->dps_cache_used = NX_FALSE;
+
+  memset(&cache, 0, sizeof(cache));
+  context->dps_cache_write(&cache);
+}
+
+UINT nx_azure_iot_client_endpoint_get(AZURE_IOT_CONTEXT* context, CHAR* hostname, UINT hostname_size)
+{
+  const CHAR* endpoint;
+  UINT        endpoint_length;
+
+  // With DPS the hub is only known from a previous assignment, otherwise the DPS endpoint comes first
+  if (context->azure_iot_dps_id_scope != NULL && dps_cache_load(context) != NX_SUCCESS)
+  {
+    endpoint        = DPS_ENDPOINT;
+    endpoint_length = sizeof(DPS_ENDPOINT) - 1;
+  }
+
+  // The cache load fills in the hub config, read it afterwards
+  else
+  {
+    endpoint        = context->azure_iot_hub_hostname;
+    endpoint_length = context->azure_iot_hub_hostname_length;
+  }
+
+  if (endpoint_length == 0 || endpoint_length >= hostname_size)
+  {
+    return NX_SIZE_ERROR;
+  }
+
+  memcpy(hostname, endpoint, endpoint_length);
+  hostname[endpoint_length] = 0;
+
+  return NX_SUCCESS;
+}
+
 UINT nx_azure_iot_client_sas_set(AZURE_IOT_CONTEXT* context, CHAR* device_sas_key)
 {
   if (device_sas_key[0] == 0)
@@ -758,6 +1507,15 @@ UINT nx_azure_iot_client_create(AZURE_IOT_CONTEXT* context,
     Error_Handler();
   }
 
+  ret = tx_mutex_create(&context->telemetry_batch.lock, "telemetry_batch", TX_INHERIT);
+
+  if (ret != NX_SUCCESS)
+  {
+    printf("ERROR: tx_mutex_create (0x%08x)\r\n", ret);
+    tx_event_flags_delete(&context->events);
+    Error_Handler();
+  }
+
   ret = tx_timer_create(&context->periodic_timer,
       "periodic_timer",
       periodic_timer_entry,
@@ -770,6 +1528,7 @@ UINT nx_azure_iot_client_create(AZURE_IOT_CONTEXT* context,
   {
     printf("ERROR: tx_timer_create (0x%08x)\r\n", ret);
     tx_event_flags_delete(&context->events);
+    tx_mutex_delete(&context->telemetry_batch.lock);
     Error_Handler();
   }
 
@@ -788,6 +1547,7 @@ UINT nx_azure_iot_client_create(AZURE_IOT_CONTEXT* context,
   {
     printf("ERROR: failed on nx_azure_iot_create (0x%08x)\r\n", ret);
     tx_event_flags_delete(&context->events);
+    tx_mutex_delete(&context->telemetry_batch.lock);
     tx_timer_delete(&context->periodic_timer);
     Error_Handler();
   }
@@ -795,6 +1555,26 @@ UINT nx_azure_iot_client_create(AZURE_IOT_CONTEXT* context,
   return ret;
  }
 
+ /* Block until the next event, waking early only for the telemetry batch age or a reconnect */
+ static ULONG client_wait_ticks(AZURE_IOT_CONTEXT* context)
+ {
+   AZURE_IOT_TELEMETRY_BATCH* batch = &context->telemetry_batch;
+   ULONG                      age;
+
+   if (context->azure_iot_connection_status != NX_SUCCESS)
+   {
+     return NX_NO_WAIT;
+   }
+
+   if (batch->count > 0 && batch->max_age_ticks > 0)
+   {
+     age = tx_time_get() - batch->oldest_tick;
+     return (age >= batch->max_age_ticks) ? NX_NO_WAIT : (batch->max_age_ticks - age);
+   }
+
+   return NX_WAIT_FOREVER;
+ }
+
  static UINT client_run(
      AZURE_IOT_CONTEXT* context, UINT (*iot_initialize)(AZURE_IOT_CONTEXT*), UINT (*network_connect)())
  {
@@ -803,7 +1583,7 @@ UINT nx_azure_iot_client_create(AZURE_IOT_CONTEXT* context,
    while (true)
    {
      app_events = 0;
-     tx_event_flags_get(&context->events, HUB_ALL_EVENTS, TX_OR_CLEAR, &app_events, NX_IP_PERIODIC_RATE);
+     tx_event_flags_get(&context->events, HUB_ALL_EVENTS, TX_OR_CLEAR, &app_events, client_wait_ticks(context));
 
      if (app_events & HUB_DISCONNECT_EVENT)
      {
@@ -820,25 +1600,27 @@ UINT nx_azure_iot_client_create(AZURE_IOT_CONTEXT* context,
        process_timer_event(context);
      }
 
-     //if (app_events & HUB_PROPERTIES_COMPLETE_EVENT)
-     //{
-     //  process_properties_complete(context);
-     //}
-
-     //if (app_events & HUB_COMMAND_RECEIVE_EVENT)
-     //{
-     //  process_command(context);
-     //}
-
-     //if (app_events & HUB_PROPERTIES_RECEIVE_EVENT)
-     //{
-     //  process_properties(context);
-     //}
-
-     //if (app_events & HUB_WRITABLE_PROPERTIES_RECEIVE_EVENT)
-     //{
-     //  process_writable_properties(context);
-     //}
+     process_telemetry_batch(context);
+
+     if (app_events & HUB_PROPERTIES_COMPLETE_EVENT)
+     {
+       process_properties_complete(context);
+     }
+
+     if (app_events & HUB_COMMAND_RECEIVE_EVENT)
+     {
+       process_command(context);
+     }
+
+     if (app_events & HUB_PROPERTIES_RECEIVE_EVENT)
+     {
+       process_properties(context);
+     }
+
+     if (app_events & HUB_WRITABLE_PROPERTIES_RECEIVE_EVENT)
+     {
+       process_writable_properties(context);
+     }
 
      /* Mainain monitor and reconnect state */
      connection_monitor(context, iot_initialize, network_connect);
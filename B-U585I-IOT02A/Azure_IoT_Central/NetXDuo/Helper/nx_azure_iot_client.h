@@ -52,11 +52,35 @@ extern "C"
 #define AZURE_IOT_AUTH_MODE_SAS     1
 #define AZURE_IOT_AUTH_MODE_CERT    2
 
+/* Telemetry batching: ring of serialized samples and the largest single sample */
+#define AZURE_IOT_TELEMETRY_BATCH_SIZE  2048
+#define AZURE_IOT_TELEMETRY_SAMPLE_SIZE 512
+
+/* Marks a valid DPS cache record */
+#define AZURE_IOT_DPS_CACHE_MAGIC 0x31535044
+
 /* The Azure IoT context used for the client app */
 typedef struct AZURE_IOT_CONTEXT_STRUCT AZURE_IOT_CONTEXT;
 
+/* Hub assignment returned by DPS, kept in non-volatile storage so a warm boot can skip provisioning */
+typedef struct AZURE_IOT_DPS_CACHE_STRUCT
+{
+  ULONG magic;
+  ULONG config_hash; // hash of the DPS id scope and registration id the assignment belongs to
+  CHAR  hub_hostname[AZURE_IOT_HOST_NAME_SIZE];
+  ULONG hub_hostname_length;
+  CHAR  hub_device_id[AZURE_IOT_DEVICE_ID_SIZE];
+  ULONG hub_device_id_length;
+  ULONG checksum;
+} AZURE_IOT_DPS_CACHE;
+
+/* Storage backend for the DPS cache, returns NX_SUCCESS once the whole record is read or written */
+typedef UINT (*func_ptr_dps_cache_read)(AZURE_IOT_DPS_CACHE*);
+typedef UINT (*func_ptr_dps_cache_write)(const AZURE_IOT_DPS_CACHE*);
+
 typedef void (*func_ptr_command_received)(
     AZURE_IOT_CONTEXT*, const UCHAR*, USHORT, const UCHAR*, USHORT, UCHAR*, USHORT, VOID*, USHORT);
+/* Property callbacks get the reader positioned on the value, the client moves past it afterwards */
 typedef void (*func_ptr_writable_property_received)(
     AZURE_IOT_CONTEXT*, const UCHAR*, UINT, UCHAR*, UINT, NX_AZURE_IOT_JSON_READER*, UINT);
 typedef void (*func_ptr_property_received)(
@@ -64,6 +88,26 @@ typedef void (*func_ptr_property_received)(
 typedef void (*func_ptr_properties_complete)(AZURE_IOT_CONTEXT*);
 typedef void (*func_ptr_timer)(AZURE_IOT_CONTEXT*);
 
+/* Telemetry batch, samples are stored as a 2 byte length followed by the JSON object */
+typedef struct AZURE_IOT_TELEMETRY_BATCH_STRUCT
+{
+  TX_MUTEX lock;
+
+  UCHAR buffer[AZURE_IOT_TELEMETRY_BATCH_SIZE];
+  UCHAR sample[AZURE_IOT_TELEMETRY_SAMPLE_SIZE];
+  UINT  head;
+  UINT  used;
+  UINT  count;
+  UINT  payload_length;
+  ULONG oldest_tick;
+  ULONG dropped;
+
+  // Flush thresholds, max_samples == 0 disables batching
+  UINT  max_samples;
+  UINT  max_bytes;
+  ULONG max_age_ticks;
+} AZURE_IOT_TELEMETRY_BATCH;
+
 /* Azure IoT context struct */
 struct AZURE_IOT_CONTEXT_STRUCT
 {
@@ -100,10 +144,17 @@ struct AZURE_IOT_CONTEXT_STRUCT
   CHAR* azure_iot_dps_registration_id;
   UINT  azure_iot_dps_registration_id_length;
 
+  // DPS cache storage, the hub config came from the cache when dps_cache_used is set
+  func_ptr_dps_cache_read  dps_cache_read;
+  func_ptr_dps_cache_write dps_cache_write;
+  UINT                     dps_cache_used;
+
   TX_THREAD            azure_iot_thread;
   TX_EVENT_FLAGS_GROUP events;
   TX_TIMER             periodic_timer;
 
+  AZURE_IOT_TELEMETRY_BATCH telemetry_batch;
+
   NX_AZURE_IOT nx_azure_iot;
 
   UINT azure_iot_connection_status;
@@ -122,6 +173,9 @@ struct AZURE_IOT_CONTEXT_STRUCT
   func_ptr_property_received          property_received_cb;
   func_ptr_properties_complete        properties_complete_cb;
   func_ptr_timer                      timer_cb;
+
+  // Tick of the last command receive notification, used to report dispatch latency
+  ULONG command_receive_tick;
 };
 
 /* USER CODE END ET */
@@ -142,17 +196,44 @@ struct AZURE_IOT_CONTEXT_STRUCT
 /* Periodic telemetry sending. */
 UINT nx_azure_iot_client_periodic_interval_set(AZURE_IOT_CONTEXT* context, INT interval);
 
+UINT nx_azure_iot_client_register_command_callback(AZURE_IOT_CONTEXT* context, func_ptr_command_received callback);
+
+UINT nx_azure_iot_client_register_writable_property_callback(
+    AZURE_IOT_CONTEXT* context, func_ptr_writable_property_received callback);
+
+UINT nx_azure_iot_client_register_property_callback(AZURE_IOT_CONTEXT* context, func_ptr_property_received callback);
+
 UINT nx_azure_iot_client_register_properties_complete_callback(
     AZURE_IOT_CONTEXT* context, func_ptr_properties_complete callback);
 
 UINT nx_azure_iot_client_register_timer_callback(
     AZURE_IOT_CONTEXT* context, func_ptr_timer callback, int32_t interval);
 
+/* Persist the DPS result so the next boot connects straight to the assigned hub. */
+UINT nx_azure_iot_client_register_dps_cache(
+    AZURE_IOT_CONTEXT* context, func_ptr_dps_cache_read read, func_ptr_dps_cache_write write);
+
+VOID nx_azure_iot_client_dps_cache_invalidate(AZURE_IOT_CONTEXT* context);
+
+/* Host name the next connection goes to, lets the network bring-up resolve it early. */
+UINT nx_azure_iot_client_endpoint_get(AZURE_IOT_CONTEXT* context, CHAR* hostname, UINT hostname_size);
+
 /* Actual PnP parsing functions. */
 UINT nx_azure_iot_client_publish_telemetry(AZURE_IOT_CONTEXT* context,
     CHAR*                                                     component_name_ptr,
     UINT (*append_properties)(NX_AZURE_IOT_JSON_WRITER* json_writer_ptr));
 
+/* Batched telemetry, samples are kept while disconnected and sent as one JSON array.
+   Component telemetry is published right away. */
+UINT nx_azure_iot_client_telemetry_batch_set(
+    AZURE_IOT_CONTEXT* context, UINT max_samples, UINT max_bytes, UINT max_age);
+
+UINT nx_azure_iot_client_queue_telemetry(AZURE_IOT_CONTEXT* context,
+    CHAR*                                                   component_name_ptr,
+    UINT (*append_properties)(NX_AZURE_IOT_JSON_WRITER* json_writer_ptr));
+
+UINT nx_azure_iot_client_flush_telemetry(AZURE_IOT_CONTEXT* context);
+
 UINT nx_azure_iot_client_publish_properties(AZURE_IOT_CONTEXT* context,
     CHAR*                                                      component_name_ptr,
     UINT (*append_properties)(NX_AZURE_IOT_JSON_WRITER* json_writer_ptr));
@@ -20,6 +20,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "nx_azure_iot_client.h"
+#include "nx_azure_iot_trace.h"
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
@@ -96,9 +97,15 @@ static void exponential_backoff_reset()
     exponential_retry_count = 0;
 }
 
+static ULONG elapsed_ms(ULONG start_tick)
+{
+  return (tx_time_get() - start_tick) * 1000 / TX_TIMER_TICKS_PER_SECOND;
+}
+
 static void iothub_connect(AZURE_IOT_CONTEXT* context)
 {
-  UINT status;
+  UINT  status;
+  ULONG start_tick;
 
   // Connect to IoT hub
   printf("\r\nInitializing Azure IoT Hub client\r\n");
@@ -106,10 +113,15 @@ static void iothub_connect(AZURE_IOT_CONTEXT* context)
   printf("\tDevice id: %.*s\r\n", context->azure_iot_hub_device_id_length, context->azure_iot_hub_device_id);
   printf("\tModel id: %.*s\r\n", context->azure_iot_model_id_length, context->azure_iot_model_id);
 
-  if ((status = nx_azure_iot_hub_client_connect(&context->iothub_client, NX_FALSE, NX_WAIT_FOREVER)))
+  // Clean session: a communication failure recreates the client, so nothing is ever published
+  // again with DUP, and the subscriptions are made again on connect. QoS 1 telemetry then waits
+  // for its PUBACK in the packet identifier table instead of as a copy in AppPool.
+  start_tick = tx_time_get();
+  if ((status = nx_azure_iot_hub_client_connect(&context->iothub_client, NX_TRUE, NX_WAIT_FOREVER)))
   {
     printf("ERROR: nx_azure_iot_hub_client_connect (0x%08x)\r\n", status);
   }
+  printf("\tIoT Hub connect: %lu ms\r\n", elapsed_ms(start_tick));
 
   // stash the connection status to be used by the monitor loop
   context->azure_iot_connection_status = status;
@@ -163,7 +175,8 @@ VOID connection_status_set(AZURE_IOT_CONTEXT* context, UINT connection_status)
 VOID connection_monitor(
     AZURE_IOT_CONTEXT* context, UINT (*iothub_init)(AZURE_IOT_CONTEXT* context), UINT (*network_connect)())
 {
-  UINT loop = NX_TRUE;
+  UINT  loop = NX_TRUE;
+  ULONG start_tick;
 
   /* Check parameters. */
   if ((context == NX_NULL) || (iothub_init == NX_NULL))
@@ -196,6 +209,12 @@ VOID connection_monitor(
       case NXD_MQTT_ERROR_BAD_USERNAME_PASSWORD:
       case NXD_MQTT_ERROR_NOT_AUTHORIZED:
       {
+        /* The hub is gone or rejects the device, a cached DPS assignment is stale. */
+        if (context->azure_iot_connection_status != NXD_MQTT_COMMUNICATION_FAILURE)
+        {
+          nx_azure_iot_client_dps_cache_invalidate(context);
+        }
+
         /* Deinitialize iot hub client. */
         nx_azure_iot_hub_client_deinitialize(&context->iothub_client);
       }
@@ -206,17 +225,22 @@ VOID connection_monitor(
         /* Set the state to not initialized. */
         context->azure_iot_connection_status = NX_AZURE_IOT_NOT_INITIALIZED;
 
-        /* Connect the network. */
+        /* Connect the network, the phase trace covers everything up to the first telemetry. */
+        nx_azure_iot_trace_reset();
+        start_tick = tx_time_get();
         if (network_connect() != NX_SUCCESS)
         {
           /* Failed, break out to try again next time. */
           break;
         }
+        printf("\tNetwork connect: %lu ms\r\n", elapsed_ms(start_tick));
 
         /* Initiliaze connection to IoT Hub. */
         exponential_backoff_with_jitter();
+        start_tick = tx_time_get();
         if (iothub_init(context) == NX_SUCCESS)
         {
+          printf("\tClient initialize: %lu ms\r\n", elapsed_ms(start_tick));
           iothub_connect(context);
         }
       }
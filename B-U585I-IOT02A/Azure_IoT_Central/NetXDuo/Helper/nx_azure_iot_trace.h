@@ -0,0 +1,99 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    nx_azure_iot_trace.h
+ * @author  Microsoft
+ * @brief   Azure IoT connection phase trace header file
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2022 Microsoft.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __NX_AZURE_IOT_TRACE_H__
+#define __NX_AZURE_IOT_TRACE_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include "nx_api.h"
+
+#include "nx_azure_iot_json_writer.h"
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+
+/* Timing of one connection phase, in threadx ticks and in core cycles for the phases shorter than a tick */
+typedef struct AZURE_IOT_PHASE_STRUCT
+{
+  ULONG begin_tick;   // start of the last occurrence
+  ULONG last_ticks;   // duration of the last completed occurrence
+  ULONG total_ticks;  // time spent in the phase since the trace was reset, DPS and hub connects add up
+  ULONG begin_cycles; // DWT cycle counter at the start of the last occurrence
+  ULONG last_cycles;  // duration of the last completed occurrence, wraps past 2^32 cycles
+  ULONG count;
+  UINT  active;
+} AZURE_IOT_PHASE;
+
+/* Connection phase trace, indexed by the NX_PHASE_* ids the stack reports through NX_PHASE_TRACE */
+typedef struct AZURE_IOT_PHASE_TRACE_STRUCT
+{
+  ULONG           reset_tick;
+  ULONG           first_puback_tick; // 0 until the first telemetry is acknowledged
+  AZURE_IOT_PHASE phase[NX_PHASE_COUNT];
+} AZURE_IOT_PHASE_TRACE;
+
+/* USER CODE END ET */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+
+/* USER CODE END EC */
+
+/* Exported macro ------------------------------------------------------------*/
+/* USER CODE BEGIN EM */
+
+/* USER CODE END EM */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/* Target of the NX_PHASE_TRACE hook, see nx_user.h. */
+VOID nx_azure_iot_trace_phase(UINT phase, UINT end);
+
+VOID nx_azure_iot_trace_reset(VOID);
+
+const AZURE_IOT_PHASE_TRACE* nx_azure_iot_trace_get(VOID);
+
+VOID nx_azure_iot_trace_print(VOID);
+
+/* Append the last duration of each phase in ms, usable as the append_properties of a telemetry publish. */
+UINT nx_azure_iot_trace_append_properties(NX_AZURE_IOT_JSON_WRITER* json_writer_ptr);
+/* USER CODE END EFP */
+
+/* Private defines -----------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+/* USER CODE END PD */
+
+/* USER CODE BEGIN 1 */
+
+/* USER CODE END 1 */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NX_AZURE_IOT_TRACE_H__ */
@@ -78,6 +78,12 @@ void mx_net_buffer_free(NX_PACKET *nx_packet);
 
 #define MX_ASSERT(a)                                    do {} while(!(a))
 
+/* The driver gives its timeouts in ms, ThreadX waits in ticks. A timeout is
+   rounded up so that a short one still waits. */
+#define MX_WIFI_MS_TO_TICKS(ms)                         \
+  (((ms) == TX_WAIT_FOREVER) ? TX_WAIT_FOREVER :        \
+   (ULONG)(((ULONG64)(ms) * TX_TIMER_TICKS_PER_SECOND + 999) / 1000))
+
 #define LOCK_DECLARE(A)                                 TX_MUTEX A
 #define LOCK_INIT(A)                                    tx_mutex_create(&A, #A, TX_NO_INHERIT)
 #define LOCK_DEINIT(A)                                  tx_mutex_delete(&A)
@@ -88,7 +94,7 @@ void mx_net_buffer_free(NX_PACKET *nx_packet);
 #define SEM_INIT(A,COUNT)                               tx_semaphore_create(&A, #A, 0)
 #define SEM_DEINIT(A)                                   tx_semaphore_delete(&A)
 #define SEM_SIGNAL(A)                                   tx_semaphore_put(&A)
-#define SEM_WAIT(A,TIMEOUT,IDLE_FUNC)                   tx_semaphore_get(&A, TIMEOUT)
+#define SEM_WAIT(A,TIMEOUT,IDLE_FUNC)                   tx_semaphore_get(&A, MX_WIFI_MS_TO_TICKS(TIMEOUT))
 
 UINT mx_wifi_thread_init(TX_THREAD * thread_ptr, CHAR *name_ptr, VOID (*entry_function)(ULONG), ULONG entry_input, ULONG stack_size, UINT priority);
 UINT mx_wifi_thread_deinit(TX_THREAD * thread_ptr);
@@ -114,8 +120,8 @@ void * mx_wifi_fifo_pop(TX_QUEUE * queue_ptr, ULONG wait_option);
 #define FIFO_DECLARE(QUEUE)                             TX_QUEUE QUEUE
 #define FIFO_INIT(QUEUE,QSIZE)                          mx_wifi_fifo_init(&QUEUE, #QUEUE, QSIZE)
 #define FIFO_DEINIT(QUEUE)                              mx_wifi_fifo_deinit(&QUEUE)
-#define FIFO_PUSH(QUEUE,VALUE,TIMEOUT,IDLE_FUNC)        mx_wifi_fifo_push(&QUEUE,&VALUE,TIMEOUT)
-#define FIFO_POP(QUEUE,TIMEOUT,IDLE_FUNC)               mx_wifi_fifo_pop(&QUEUE,TIMEOUT)
+#define FIFO_PUSH(QUEUE,VALUE,TIMEOUT,IDLE_FUNC)        mx_wifi_fifo_push(&QUEUE,&VALUE,MX_WIFI_MS_TO_TICKS(TIMEOUT))
+#define FIFO_POP(QUEUE,TIMEOUT,IDLE_FUNC)               mx_wifi_fifo_pop(&QUEUE,MX_WIFI_MS_TO_TICKS(TIMEOUT))
 
 #define WAIT_FOREVER                                    TX_WAIT_FOREVER
 #define SEM_OK                                          TX_SUCCESS
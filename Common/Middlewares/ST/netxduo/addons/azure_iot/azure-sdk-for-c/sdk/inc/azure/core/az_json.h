@@ -433,6 +433,30 @@ AZ_NODISCARD az_result az_json_writer_append_string(az_json_writer* ref_json_wri
 AZ_NODISCARD az_result
 az_json_writer_append_json_text(az_json_writer* ref_json_writer, az_span json_text);
 
+/**
+ * @brief Appends an existing UTF-8 encoded JSON text into the buffer without validating it, for
+ * JSON built from known fragments.
+ *
+ * @param[in,out] ref_json_writer A pointer to an #az_json_writer instance containing the buffer to
+ * append the JSON text to.
+ * @param[in] json_text A single, possibly nested, valid, UTF-8 encoded, JSON value to be written as
+ * is, as for #az_json_writer_append_json_text().
+ * @param[in] last_token_kind The kind of the last token of \p json_text.
+ *
+ * @remarks The caller guarantees \p json_text is valid and properly escaped, it is not read back.
+ * Only the state of \p ref_json_writer is checked.
+ *
+ * @return An #az_result value indicating the result of the operation.
+ * @retval #AZ_OK The provided \p json_text was appended successfully.
+ * @retval #AZ_ERROR_NOT_ENOUGH_SPACE The destination is too small for the provided \p json_text.
+ * @retval #AZ_ERROR_JSON_INVALID_STATE The \p ref_json_writer is in a state where the \p json_text
+ * cannot be appended because it would result in invalid JSON.
+ */
+AZ_NODISCARD az_result az_json_writer_append_json_text_trusted(
+    az_json_writer* ref_json_writer,
+    az_span json_text,
+    az_json_token_kind last_token_kind);
+
 /**
  * @brief Appends the UTF-8 property name (as a JSON string) which is the first part of a name/value
  * pair of a JSON object.
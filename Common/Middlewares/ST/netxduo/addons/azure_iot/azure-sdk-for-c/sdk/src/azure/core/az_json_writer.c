@@ -770,6 +770,21 @@ az_json_writer_append_json_text(az_json_writer* ref_json_writer, az_span json_te
   // AZ_JSON_TOKEN_NONE, AZ_JSON_TOKEN_START_ARRAY, AZ_JSON_TOKEN_START_OBJECT,
   // AZ_JSON_TOKEN_PROPERTY_NAME
 
+  return az_json_writer_append_json_text_trusted(ref_json_writer, json_text, last_token_kind);
+}
+
+AZ_NODISCARD az_result az_json_writer_append_json_text_trusted(
+    az_json_writer* ref_json_writer,
+    az_span json_text,
+    az_json_token_kind last_token_kind)
+{
+  _az_PRECONDITION_NOT_NULL(ref_json_writer);
+  _az_PRECONDITION_VALID_SPAN(json_text, 1, false);
+  _az_PRECONDITION(
+      last_token_kind != AZ_JSON_TOKEN_NONE && last_token_kind != AZ_JSON_TOKEN_BEGIN_ARRAY
+      && last_token_kind != AZ_JSON_TOKEN_BEGIN_OBJECT
+      && last_token_kind != AZ_JSON_TOKEN_PROPERTY_NAME);
+
   // The JSON text is valid, but appending it to the the JSON writer at the current state still may
   // not be valid.
   if (!_az_is_appending_value_valid(ref_json_writer))
@@ -251,6 +251,14 @@ UINT status;
     nx_azure_iot_ptr -> nx_azure_iot_pool_ptr = pool_ptr;
     nx_azure_iot_ptr -> nx_azure_iot_unix_time_get = unix_time_callback;
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+    /* Start with an empty TLS session cache.  */
+    memset(nx_azure_iot_ptr -> nx_azure_iot_tls_session_cache, 0, sizeof(nx_azure_iot_ptr -> nx_azure_iot_tls_session_cache));
+    nx_azure_iot_ptr -> nx_azure_iot_tls_session_cache_next = 0;
+    nx_azure_iot_ptr -> nx_azure_iot_tls_session_resumed_count = 0;
+    nx_azure_iot_ptr -> nx_azure_iot_tls_session_full_count = 0;
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
     status = nx_cloud_create(&nx_azure_iot_ptr -> nx_azure_iot_cloud, (CHAR *)name_ptr, stack_memory_ptr,
                              stack_memory_size, priority);
     if (status)
@@ -580,6 +588,104 @@ UINT status = NX_AZURE_IOT_SUCCESS;
     return(status);
 }
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+static NX_AZURE_IOT_TLS_SESSION_CACHE *nx_azure_iot_tls_session_cache_search(NX_AZURE_IOT *nx_azure_iot_ptr,
+                                                                             const UCHAR *hostname,
+                                                                             UINT hostname_length)
+{
+UINT i;
+NX_AZURE_IOT_TLS_SESSION_CACHE *cache_ptr;
+
+    for (i = 0; i < NX_AZURE_IOT_ARRAY_SIZE(nx_azure_iot_ptr -> nx_azure_iot_tls_session_cache); i++)
+    {
+        cache_ptr = &(nx_azure_iot_ptr -> nx_azure_iot_tls_session_cache[i]);
+
+        if ((cache_ptr -> tls_session_cache_hostname_length == hostname_length) &&
+            (memcmp(cache_ptr -> tls_session_cache_hostname, hostname, hostname_length) == 0))
+        {
+            return(cache_ptr);
+        }
+    }
+
+    return(NX_NULL);
+}
+
+VOID nx_azure_iot_tls_session_cache_update(NX_AZURE_IOT *nx_azure_iot_ptr, NX_AZURE_IOT_RESOURCE *resource_ptr, UINT status)
+{
+UINT resumed = NX_FALSE;
+NX_AZURE_IOT_TLS_SESSION_CACHE *cache_ptr;
+NX_SECURE_TLS_RESUMPTION resumption;
+
+    if ((resource_ptr -> resource_hostname == NX_NULL) ||
+        (resource_ptr -> resource_hostname_length == 0) ||
+        (resource_ptr -> resource_hostname_length > NX_AZURE_IOT_TLS_SESSION_CACHE_HOSTNAME_SIZE))
+    {
+        return;
+    }
+
+    cache_ptr = nx_azure_iot_tls_session_cache_search(nx_azure_iot_ptr,
+                                                      resource_ptr -> resource_hostname,
+                                                      resource_ptr -> resource_hostname_length);
+
+    if (status == NX_AZURE_IOT_SUCCESS)
+    {
+        status = nx_secure_tls_session_resumption_get(&(resource_ptr -> resource_mqtt.nxd_mqtt_tls_session),
+                                                      &resumption, &resumed);
+        if (status == NX_SUCCESS)
+        {
+
+            /* Reuse the entry of this host or replace the oldest one.  */
+            if (cache_ptr == NX_NULL)
+            {
+                cache_ptr = &(nx_azure_iot_ptr -> nx_azure_iot_tls_session_cache[nx_azure_iot_ptr -> nx_azure_iot_tls_session_cache_next]);
+                nx_azure_iot_ptr -> nx_azure_iot_tls_session_cache_next =
+                    (nx_azure_iot_ptr -> nx_azure_iot_tls_session_cache_next + 1) % NX_AZURE_IOT_TLS_SESSION_CACHE_SIZE;
+            }
+
+            memcpy(cache_ptr -> tls_session_cache_hostname, resource_ptr -> resource_hostname,
+                   resource_ptr -> resource_hostname_length); /* Use case of memcpy is verified. */
+            cache_ptr -> tls_session_cache_hostname_length = resource_ptr -> resource_hostname_length;
+            cache_ptr -> tls_session_cache_resumption = resumption;
+            memset(&resumption, 0, sizeof(resumption));
+
+            if (resumed)
+            {
+                nx_azure_iot_ptr -> nx_azure_iot_tls_session_resumed_count++;
+            }
+            else
+            {
+                nx_azure_iot_ptr -> nx_azure_iot_tls_session_full_count++;
+            }
+
+            return;
+        }
+    }
+
+    /* Connection failed or the session can not be resumed, do not offer it again.  */
+    if (cache_ptr)
+    {
+        memset(cache_ptr, 0, sizeof(NX_AZURE_IOT_TLS_SESSION_CACHE));
+    }
+}
+
+UINT nx_azure_iot_tls_session_statistics_get(NX_AZURE_IOT *nx_azure_iot_ptr, ULONG *resumed_count, ULONG *full_count)
+{
+
+    if ((nx_azure_iot_ptr == NX_NULL) || (resumed_count == NX_NULL) || (full_count == NX_NULL))
+    {
+        LogError(LogLiteralArgs("IoT TLS session statistics get fail: INVALID POINTER"));
+        return(NX_AZURE_IOT_INVALID_PARAMETER);
+    }
+
+    tx_mutex_get(nx_azure_iot_ptr -> nx_azure_iot_mutex_ptr, TX_WAIT_FOREVER);
+    *resumed_count = nx_azure_iot_ptr -> nx_azure_iot_tls_session_resumed_count;
+    *full_count = nx_azure_iot_ptr -> nx_azure_iot_tls_session_full_count;
+    tx_mutex_put(nx_azure_iot_ptr -> nx_azure_iot_mutex_ptr);
+
+    return(NX_AZURE_IOT_SUCCESS);
+}
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
 #ifndef NX_AZURE_IOT_DISABLE_CERTIFICATE_DATE
 static ULONG nx_azure_iot_tls_time_function(VOID)
 {
@@ -610,6 +716,9 @@ UINT nx_azure_iot_mqtt_tls_setup(NXD_MQTT_CLIENT *client_ptr, NX_SECURE_TLS_SESS
 UINT status;
 UINT i;
 NX_AZURE_IOT_RESOURCE *resource_ptr;
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+NX_AZURE_IOT_TLS_SESSION_CACHE *cache_ptr;
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
 
     NX_PARAMETER_NOT_USED(certificate);
     NX_PARAMETER_NOT_USED(trusted_certificate);
@@ -692,6 +801,25 @@ NX_AZURE_IOT_RESOURCE *resource_ptr;
     nx_secure_tls_session_time_function_set(tls_session, nx_azure_iot_tls_time_function);
 #endif /* NX_AZURE_IOT_DISABLE_CERTIFICATE_DATE */
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+    /* Offer the last session negotiated with this host so the handshake can skip the key exchange.  */
+    tx_mutex_get(_nx_azure_iot_created_ptr -> nx_azure_iot_mutex_ptr, TX_WAIT_FOREVER);
+
+    cache_ptr = nx_azure_iot_tls_session_cache_search(_nx_azure_iot_created_ptr,
+                                                      resource_ptr -> resource_hostname,
+                                                      resource_ptr -> resource_hostname_length);
+    if (cache_ptr)
+    {
+        status = nx_secure_tls_session_resumption_set(tls_session, &(cache_ptr -> tls_session_cache_resumption));
+        if (status)
+        {
+            LogError(LogLiteralArgs("Failed to set the session resumption state: status: %d"), status);
+        }
+    }
+
+    tx_mutex_put(_nx_azure_iot_created_ptr -> nx_azure_iot_mutex_ptr);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
     return(NX_AZURE_IOT_SUCCESS);
 }
 
@@ -147,6 +147,18 @@ UINT nx_azure_iot_log(UCHAR *type_ptr, UINT type_len, UCHAR *msg_ptr, UINT msg_l
 #define NX_AZURE_IOT_RESOURCE_IOT_HUB                     0x1
 #define NX_AZURE_IOT_RESOURCE_IOT_PROVISIONING            0x2
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+/* Define the number of hosts a TLS session is kept for, e.g. DPS and IoT Hub.  */
+#ifndef NX_AZURE_IOT_TLS_SESSION_CACHE_SIZE
+#define NX_AZURE_IOT_TLS_SESSION_CACHE_SIZE               2
+#endif /* NX_AZURE_IOT_TLS_SESSION_CACHE_SIZE */
+
+/* Define the maximum host name length of a TLS session cache entry.  */
+#ifndef NX_AZURE_IOT_TLS_SESSION_CACHE_HOSTNAME_SIZE
+#define NX_AZURE_IOT_TLS_SESSION_CACHE_HOSTNAME_SIZE      128
+#endif /* NX_AZURE_IOT_TLS_SESSION_CACHE_HOSTNAME_SIZE */
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
 /* Define the packet buffer for THREADX TLS.  */
 #ifndef NX_AZURE_IOT_TLS_PACKET_BUFFER_SIZE
 #define NX_AZURE_IOT_TLS_PACKET_BUFFER_SIZE               (1024 * 7)
@@ -196,6 +208,19 @@ typedef struct NX_AZURE_IOT_RESOURCE_STRUCT
 
 } NX_AZURE_IOT_RESOURCE;
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+/**
+ * @brief TLS session cache entry, the last session negotiated with a host
+ *
+ */
+typedef struct NX_AZURE_IOT_TLS_SESSION_CACHE_STRUCT
+{
+    UCHAR                                  tls_session_cache_hostname[NX_AZURE_IOT_TLS_SESSION_CACHE_HOSTNAME_SIZE];
+    UINT                                   tls_session_cache_hostname_length;
+    NX_SECURE_TLS_RESUMPTION               tls_session_cache_resumption;
+} NX_AZURE_IOT_TLS_SESSION_CACHE;
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
 /**
  * @brief Azure IoT Struct
  *
@@ -214,6 +239,12 @@ typedef struct NX_AZURE_IOT_STRUCT
                                           ULONG common_events, ULONG module_own_events);
     struct NX_AZURE_IOT_RESOURCE_STRUCT   *nx_azure_iot_resource_list_header;
     UINT                                 (*nx_azure_iot_unix_time_get)(ULONG *unix_time);
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+    NX_AZURE_IOT_TLS_SESSION_CACHE         nx_azure_iot_tls_session_cache[NX_AZURE_IOT_TLS_SESSION_CACHE_SIZE];
+    UINT                                   nx_azure_iot_tls_session_cache_next;
+    ULONG                                  nx_azure_iot_tls_session_resumed_count;
+    ULONG                                  nx_azure_iot_tls_session_full_count;
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
 } NX_AZURE_IOT;
 
 typedef struct NX_AZURE_IOT_THREAD_STRUCT
@@ -303,6 +334,23 @@ UINT nx_azure_iot_unix_time_get(NX_AZURE_IOT *nx_azure_iot_ptr, ULONG *unix_time
  */
 VOID nx_azure_iot_log_init(VOID(*log_callback)(az_log_classification classification, UCHAR *msg, UINT msg_len));
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+/**
+ * @brief Get TLS session resumption statistics
+ *
+ * @details This routine returns how many TLS handshakes resumed a cached session and how many
+ *          negotiated a full handshake since the Azure IoT instance was created.
+ *
+ * @param[in] nx_azure_iot_ptr A pointer to a #NX_AZURE_IOT.
+ * @param[out] resumed_count Pointer to `ULONG` where the resumed handshake count is returned.
+ * @param[out] full_count Pointer to `ULONG` where the full handshake count is returned.
+ * @return A `UINT` with the result of the API.
+ *   @retval #NX_AZURE_IOT_SUCCESS Successfully return the statistics.
+ *   @retval #NX_AZURE_IOT_INVALID_PARAMETER Fail to get the statistics due to invalid parameter.
+ */
+UINT nx_azure_iot_tls_session_statistics_get(NX_AZURE_IOT *nx_azure_iot_ptr, ULONG *resumed_count, ULONG *full_count);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
 /* Internal APIs. */
 UINT nx_azure_iot_buffer_allocate(NX_AZURE_IOT *nx_azure_iot_ptr, UCHAR **buffer_pptr,
                                   UINT *buffer_size, VOID **buffer_context);
@@ -319,6 +367,9 @@ VOID nx_azure_iot_mqtt_packet_adjust(NX_PACKET *packet_ptr);
 UINT nx_azure_iot_mqtt_tls_setup(NXD_MQTT_CLIENT *client_ptr, NX_SECURE_TLS_SESSION *tls_session,
                                  NX_SECURE_X509_CERT *certificate,
                                  NX_SECURE_X509_CERT *trusted_certificate);
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+VOID nx_azure_iot_tls_session_cache_update(NX_AZURE_IOT *nx_azure_iot_ptr, NX_AZURE_IOT_RESOURCE *resource_ptr, UINT status);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
 UINT nx_azure_iot_base64_hmac_sha256_calculate(NX_AZURE_IOT_RESOURCE *resource_ptr,
                                                const UCHAR *key_ptr, UINT key_size,
                                                const UCHAR *message_ptr, UINT message_size,
@@ -361,7 +361,7 @@ NXD_MQTT_CLIENT *mqtt_client_ptr;
 UCHAR           *buffer_ptr;
 UINT            buffer_size;
 VOID            *buffer_context;
-UINT            buffer_length;
+size_t          buffer_length;
 ULONG           expiry_time_secs;
 az_result       core_result;
 
@@ -386,9 +386,11 @@ az_result       core_result;
 
     /* Resolve the host name.  */
     /* Note: always using default dns timeout.  */
+    NX_PHASE_TRACE_BEGIN(NX_PHASE_DNS_RESOLVE);
     status = nxd_dns_host_by_name_get(hub_client_ptr -> nx_azure_iot_ptr -> nx_azure_iot_dns_ptr,
                                       (UCHAR *)hub_client_ptr -> nx_azure_iot_hub_client_resource.resource_hostname,
                                       &server_address, NX_AZURE_IOT_HUB_CLIENT_DNS_TIMEOUT, NX_IP_VERSION_V4);
+    NX_PHASE_TRACE_END(NX_PHASE_DNS_RESOLVE);
     if (status)
     {
         LogError(LogLiteralArgs("IoTHub client connect fail: DNS RESOLVE FAIL status: %d"), status);
@@ -418,7 +420,7 @@ az_result       core_result;
     /* Build client id.  */
     buffer_length = buffer_size;
     core_result = az_iot_hub_client_get_client_id(&(hub_client_ptr -> iot_hub_client_core),
-                                                  (CHAR *)buffer_ptr, buffer_length, (size_t *)&buffer_length);
+                                                  (CHAR *)buffer_ptr, buffer_length, &buffer_length);
     if (az_result_failed(core_result))
     {
 
@@ -438,7 +440,7 @@ az_result       core_result;
     /* Build user name.  */
     buffer_length = buffer_size;
     core_result = az_iot_hub_client_get_user_name(&hub_client_ptr -> iot_hub_client_core,
-                                                  (CHAR *)buffer_ptr, buffer_length, (size_t *)&buffer_length);
+                                                  (CHAR *)buffer_ptr, buffer_length, &buffer_length);
     if (az_result_failed(core_result))
     {
 
@@ -557,6 +559,11 @@ az_result       core_result;
         resource_ptr -> resource_mqtt_buffer_context = NX_NULL;
     }
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+    /* Remember the TLS session for the next connect.  */
+    nx_azure_iot_tls_session_cache_update(hub_client_ptr -> nx_azure_iot_ptr, resource_ptr, status);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
     /* Check status.  */
     if (status != NX_AZURE_IOT_SUCCESS)
     {
@@ -616,6 +623,12 @@ NX_AZURE_IOT_HUB_CLIENT *iot_hub_client = (NX_AZURE_IOT_HUB_CLIENT*)context;
         iot_hub_client -> nx_azure_iot_hub_client_resource.resource_mqtt_buffer_context = NX_NULL;
     }
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+    /* Remember the TLS session for the next connect.  */
+    nx_azure_iot_tls_session_cache_update(iot_hub_client -> nx_azure_iot_ptr,
+                                          &(iot_hub_client -> nx_azure_iot_hub_client_resource), status);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
     /* Update hub client status.  */
     if (status == NXD_MQTT_SUCCESS)
     {
@@ -1028,7 +1041,7 @@ UINT nx_azure_iot_hub_client_telemetry_message_create(NX_AZURE_IOT_HUB_CLIENT *h
                                                       NX_PACKET **packet_pptr, UINT wait_option)
 {
 NX_PACKET *packet_ptr;
-UINT topic_length;
+size_t topic_length;
 UINT status;
 az_result core_result;
 
@@ -1052,7 +1065,7 @@ az_result core_result;
     topic_length = (UINT)(packet_ptr -> nx_packet_data_end - packet_ptr -> nx_packet_prepend_ptr);
     core_result = az_iot_hub_client_telemetry_get_publish_topic(&(hub_client_ptr -> iot_hub_client_core),
                                                                 NULL, (CHAR *)packet_ptr -> nx_packet_prepend_ptr,
-                                                                topic_length, (size_t *)&topic_length);
+                                                                topic_length, &topic_length);
     if (az_result_failed(core_result))
     {
         LogError(LogLiteralArgs("IoTHub client telemetry message create fail with error status: %d"), core_result);
@@ -1215,6 +1228,87 @@ UCHAR packet_id[2];
     return(NX_AZURE_IOT_SUCCESS);
 }
 
+UINT nx_azure_iot_hub_client_telemetry_json_writer_init(NX_AZURE_IOT_HUB_CLIENT *hub_client_ptr,
+                                                        NX_PACKET *packet_ptr,
+                                                        NX_AZURE_IOT_JSON_WRITER *json_writer_ptr,
+                                                        UINT wait_option)
+{
+UINT status;
+UCHAR packet_id[2];
+
+    if ((hub_client_ptr == NX_NULL) || (packet_ptr == NX_NULL) || (json_writer_ptr == NX_NULL))
+    {
+        LogError(LogLiteralArgs("IoTHub telemetry json writer init fail: INVALID POINTER"));
+        return(NX_AZURE_IOT_INVALID_PARAMETER);
+    }
+
+    status = nx_azure_iot_mqtt_packet_id_get(&(hub_client_ptr -> nx_azure_iot_hub_client_resource.resource_mqtt),
+                                             packet_id, wait_option);
+    if (status)
+    {
+        LogError(LogLiteralArgs("Failed to get packet id"));
+        return(status);
+    }
+
+    /* Append packet identifier, the payload is then written right after it.  */
+    status = nx_packet_data_append(packet_ptr, packet_id, sizeof(packet_id),
+                                   packet_ptr -> nx_packet_pool_owner,
+                                   wait_option);
+    if (status)
+    {
+        LogError(LogLiteralArgs("Telemetry append fail"));
+        return(status);
+    }
+
+    return(nx_azure_iot_json_writer_init(json_writer_ptr, packet_ptr, wait_option));
+}
+
+UINT nx_azure_iot_hub_client_telemetry_json_writer_send(NX_AZURE_IOT_HUB_CLIENT *hub_client_ptr,
+                                                        NX_AZURE_IOT_JSON_WRITER *json_writer_ptr,
+                                                        UINT wait_option)
+{
+UINT status;
+UINT topic_len;
+UCHAR packet_id[2];
+ULONG bytes_copied;
+NX_PACKET *packet_ptr;
+
+    if ((hub_client_ptr == NX_NULL) || (json_writer_ptr == NX_NULL) ||
+        (json_writer_ptr -> packet_ptr == NX_NULL))
+    {
+        LogError(LogLiteralArgs("IoTHub telemetry send fail: INVALID POINTER"));
+        return(NX_AZURE_IOT_INVALID_PARAMETER);
+    }
+
+    packet_ptr = json_writer_ptr -> packet_ptr;
+
+    /* The packet identifier was the last thing appended before the writer took over.  */
+    if (json_writer_ptr -> nx_packet_init_length < sizeof(packet_id))
+    {
+        LogError(LogLiteralArgs("IoTHub telemetry send fail: INVALID PACKET"));
+        return(NX_AZURE_IOT_INVALID_PACKET);
+    }
+
+    topic_len = (UINT)(json_writer_ptr -> nx_packet_init_length - sizeof(packet_id));
+    if (nx_packet_data_extract_offset(packet_ptr, topic_len, packet_id, sizeof(packet_id), &bytes_copied) ||
+        (bytes_copied != sizeof(packet_id)))
+    {
+        LogError(LogLiteralArgs("IoTHub telemetry send fail: INVALID PACKET"));
+        return(NX_AZURE_IOT_INVALID_PACKET);
+    }
+
+    status = nx_azure_iot_publish_mqtt_packet(&(hub_client_ptr -> nx_azure_iot_hub_client_resource.resource_mqtt),
+                                              packet_ptr, topic_len, packet_id, NX_AZURE_IOT_HUB_CLIENT_TELEMETRY_QOS,
+                                              wait_option);
+    if (status)
+    {
+        LogError(LogLiteralArgs("IoTHub client send fail: PUBLISH FAIL status: %d"), status);
+        return(status);
+    }
+
+    return(NX_AZURE_IOT_SUCCESS);
+}
+
 UINT nx_azure_iot_hub_client_receive_callback_set(NX_AZURE_IOT_HUB_CLIENT *hub_client_ptr,
                                                   UINT message_type,
                                                   VOID (*callback_ptr)(
@@ -1888,7 +1982,7 @@ UCHAR *buffer_ptr;
 ULONG buffer_size;
 az_span request_id_span;
 az_result core_result;
-UINT topic_length;
+size_t topic_length;
 
     if ((hub_client_ptr == NX_NULL) ||
         (packet_pptr == NX_NULL))
@@ -2063,7 +2157,7 @@ UINT nx_azure_iot_hub_client_properties_request(NX_AZURE_IOT_HUB_CLIENT *hub_cli
                                                 UINT wait_option)
 {
 UINT status;
-UINT topic_length;
+size_t topic_length;
 UINT buffer_size;
 NX_PACKET *packet_ptr;
 az_span request_id_span;
@@ -2126,7 +2220,7 @@ az_result core_result;
 
     core_result = az_iot_hub_client_properties_document_get_publish_topic(&(hub_client_ptr -> iot_hub_client_core),
                                                                           request_id_span, (CHAR *)packet_ptr -> nx_packet_prepend_ptr,
-                                                                          buffer_size, (size_t *)&topic_length);
+                                                                          buffer_size, &topic_length);
     if (az_result_failed(core_result))
     {
         LogError(LogLiteralArgs("IoTHub client device twin get topic fail."));
@@ -2291,7 +2385,7 @@ UINT nx_azure_iot_hub_client_device_twin_reported_properties_send(NX_AZURE_IOT_H
 UINT status;
 UINT buffer_size;
 NX_PACKET *packet_ptr;
-UINT topic_length;
+size_t topic_length;
 UINT request_id;
 az_span request_id_span;
 az_result core_result;
@@ -2364,7 +2458,7 @@ NX_PACKET *response_packet_ptr;
 
     core_result = az_iot_hub_client_twin_patch_get_publish_topic(&(hub_client_ptr -> iot_hub_client_core),
                                                                  request_id_span, (CHAR *)packet_ptr -> nx_packet_prepend_ptr,
-                                                                 buffer_size, (size_t *)&topic_length);
+                                                                 buffer_size, &topic_length);
     if (az_result_failed(core_result))
     {
         LogError(LogLiteralArgs("IoTHub client reported state send fail: NX_AZURE_IOT_HUB_CLIENT_TOPIC_SIZE is too small."));
@@ -3010,6 +3104,7 @@ az_span buffer_span;
 UINT status;
 UCHAR *output_ptr;
 UINT output_len;
+size_t sas_length_core;
 az_result core_result;
 
     status = nx_azure_iot_buffer_allocate(hub_client_ptr -> nx_azure_iot_ptr, &buffer_ptr, &buffer_size, &buffer_context);
@@ -3041,7 +3136,7 @@ az_result core_result;
     buffer_span = az_span_create(output_ptr, (INT)output_len);
     core_result= az_iot_hub_client_sas_get_password(&(hub_client_ptr -> iot_hub_client_core),
                                                     expiry_time_secs, buffer_span, AZ_SPAN_EMPTY,
-                                                    (CHAR *)sas_buffer, sas_buffer_len, (size_t *)&sas_buffer_len);
+                                                    (CHAR *)sas_buffer, sas_buffer_len, &sas_length_core);
     if (az_result_failed(core_result))
     {
         LogError(LogLiteralArgs("IoTHub failed to generate token with error status: %d"), core_result);
@@ -3049,7 +3144,7 @@ az_result core_result;
         return(NX_AZURE_IOT_SDK_CORE_ERROR);
     }
 
-    *sas_length = sas_buffer_len;
+    *sas_length = (UINT)sas_length_core;
     nx_azure_iot_buffer_free(buffer_context);
 
     return(NX_AZURE_IOT_SUCCESS);
@@ -3193,7 +3288,7 @@ UINT nx_azure_iot_hub_client_command_message_response(NX_AZURE_IOT_HUB_CLIENT *h
                                                       UINT payload_length, UINT wait_option)
 {
 NX_PACKET *packet_ptr;
-UINT topic_length;
+size_t topic_length;
 az_span request_id_span;
 UINT status;
 az_result core_result;
@@ -3222,7 +3317,7 @@ az_result core_result;
     core_result = az_iot_hub_client_commands_response_get_publish_topic(&(hub_client_ptr -> iot_hub_client_core),
                                                                         request_id_span, (USHORT)status_code,
                                                                         (CHAR *)packet_ptr -> nx_packet_prepend_ptr,
-                                                                        topic_length, (size_t *)&topic_length);
+                                                                        topic_length, &topic_length);
     if (az_result_failed(core_result))
     {
         LogError(LogLiteralArgs("Failed to create the command response topic"));
@@ -28,6 +28,7 @@ extern   "C" {
 #endif
 
 #include "nx_azure_iot.h"
+#include "nx_azure_iot_json_writer.h"
 #include "azure/iot/az_iot_hub_client.h"
 
 /**< Value denoting a message is of "None" type */
@@ -462,6 +463,48 @@ UINT nx_azure_iot_hub_client_telemetry_property_add(NX_PACKET *packet_ptr,
 UINT nx_azure_iot_hub_client_telemetry_send(NX_AZURE_IOT_HUB_CLIENT *hub_client_ptr, NX_PACKET *packet_ptr,
                                             const UCHAR *telemetry_data, UINT data_size, UINT wait_option);
 
+/**
+ * @brief Initializes a JSON writer on the telemetry message packet.
+ * @details This routine lets an application build the telemetry payload in place, instead of formatting it
+ *          into a buffer that #nx_azure_iot_hub_client_telemetry_send copies into the packet. The payload
+ *          spills into packets chained from the pool of `packet_ptr` when it does not fit, so its size is only
+ *          bounded by the pool. All the user-defined properties must be added before calling this routine.
+ *          The message is sent with #nx_azure_iot_hub_client_telemetry_json_writer_send.
+ *
+ * @param[in] hub_client_ptr A pointer to a #NX_AZURE_IOT_HUB_CLIENT.
+ * @param[in] packet_ptr A pointer to telemetry property packet.
+ * @param[out] json_writer_ptr A pointer to a #NX_AZURE_IOT_JSON_WRITER writing into `packet_ptr`.
+ * @param[in] wait_option Ticks to wait if packet needs to be expanded.
+ * @return A `UINT` with the result of the API.
+ *   @retval #NX_AZURE_IOT_SUCCESS Successful if the JSON writer is initialized.
+ *   @retval #NX_AZURE_IOT_INVALID_PARAMETER Fail to initialize JSON writer due to invalid parameter.
+ *   @retval #NX_AZURE_IOT_DISCONNECTED Fail to initialize JSON writer due to hub client not connected.
+ *   @retval #NX_AZURE_IOT_SDK_CORE_ERROR Fail to initialize JSON writer due to SDK core error.
+ *   @retval NX_NO_PACKET Fail to initialize JSON writer due to no available packet in pool.
+ */
+UINT nx_azure_iot_hub_client_telemetry_json_writer_init(NX_AZURE_IOT_HUB_CLIENT *hub_client_ptr,
+                                                        NX_PACKET *packet_ptr,
+                                                        NX_AZURE_IOT_JSON_WRITER *json_writer_ptr,
+                                                        UINT wait_option);
+
+/**
+ * @brief Sends telemetry message built with #nx_azure_iot_hub_client_telemetry_json_writer_init to IoTHub.
+ * @details On successful return of this function, ownership of the `NX_PACKET` of the JSON writer is released.
+ *
+ * @param[in] hub_client_ptr A pointer to a #NX_AZURE_IOT_HUB_CLIENT.
+ * @param[in] json_writer_ptr A pointer to the #NX_AZURE_IOT_JSON_WRITER holding the telemetry payload.
+ * @param[in] wait_option Ticks to wait for message to be sent.
+ * @return A `UINT` with the result of the API.
+ *   @retval #NX_AZURE_IOT_SUCCESS Successful if telemetry message is sent out.
+ *   @retval #NX_AZURE_IOT_INVALID_PARAMETER Fail to send telemetry message due to invalid parameter.
+ *   @retval #NX_AZURE_IOT_INVALID_PACKET Fail to send telemetry message due to packet is invalid.
+ *   @retval NXD_MQTT_PACKET_POOL_FAILURE Fail to send telemetry message due to no available packet in pool.
+ *   @retval NXD_MQTT_COMMUNICATION_FAILURE Fail to send telemetry message due to TCP/TLS error.
+ */
+UINT nx_azure_iot_hub_client_telemetry_json_writer_send(NX_AZURE_IOT_HUB_CLIENT *hub_client_ptr,
+                                                        NX_AZURE_IOT_JSON_WRITER *json_writer_ptr,
+                                                        UINT wait_option);
+
 /**
  * @brief Enable receiving C2D message from IoTHub.
  *
@@ -236,6 +236,29 @@ az_span span = az_span_create((UCHAR *)json, (INT)json_len);
     return(NX_AZURE_IOT_SUCCESS);
 }
 
+UINT nx_azure_iot_json_writer_append_json_text_trusted(NX_AZURE_IOT_JSON_WRITER *json_writer_ptr,
+                                                       const UCHAR *json, UINT json_len,
+                                                       az_json_token_kind last_token_kind)
+{
+az_span span = az_span_create((UCHAR *)json, (INT)json_len);
+
+    if (json_writer_ptr == NX_NULL)
+    {
+        LogError(LogLiteralArgs("Json writer append trusted text fail: INVALID POINTER"));
+        return(NX_AZURE_IOT_INVALID_PARAMETER);
+    }
+
+    if (az_result_failed(az_json_writer_append_json_text_trusted(&(json_writer_ptr -> json_writer),
+                                                                 span, last_token_kind)))
+    {
+        return(NX_AZURE_IOT_SDK_CORE_ERROR);
+    }
+
+    nx_azure_iot_json_writer_packet_update(json_writer_ptr);
+
+    return(NX_AZURE_IOT_SUCCESS);
+}
+
 UINT nx_azure_iot_json_writer_append_property_name(NX_AZURE_IOT_JSON_WRITER *json_writer_ptr,
                                                    const UCHAR *value, UINT value_len)
 {
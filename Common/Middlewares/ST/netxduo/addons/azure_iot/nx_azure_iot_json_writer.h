@@ -192,6 +192,26 @@ UINT nx_azure_iot_json_writer_append_string(NX_AZURE_IOT_JSON_WRITER *json_write
 UINT nx_azure_iot_json_writer_append_json_text(NX_AZURE_IOT_JSON_WRITER *json_writer_ptr,
                                                const UCHAR *json, UINT json_len);
 
+/**
+ * @brief Appends an existing UTF-8 encoded JSON text into the buffer without validating it, for
+ * JSON built from known fragments.
+ *
+ * @param[in] json_writer_ptr A pointer to an #NX_AZURE_IOT_JSON_WRITER.
+ * @param[in] json A pointer to single, possibly nested, valid, UTF-8 encoded, JSON value to be written as
+ * is, as for nx_azure_iot_json_writer_append_json_text().
+ * @param[in] json_len Length of json
+ * @param[in] last_token_kind The kind of the last token of json, #AZ_JSON_TOKEN_END_OBJECT for an object.
+ *
+ * @remarks The caller guarantees json is valid and properly escaped, it is not read back. Only the
+ * state of the writer is checked.
+ *
+ * @return An `UINT` value indicating the result of the operation.
+ * @retval #NX_AZURE_IOT_SUCCESS The provided json_text was appended successfully.
+ */
+UINT nx_azure_iot_json_writer_append_json_text_trusted(NX_AZURE_IOT_JSON_WRITER *json_writer_ptr,
+                                                       const UCHAR *json, UINT json_len,
+                                                       az_json_token_kind last_token_kind);
+
 /**
  * @brief Appends the UTF-8 property name (as a JSON string) which is the first part of a name/value
  * pair of a JSON object.
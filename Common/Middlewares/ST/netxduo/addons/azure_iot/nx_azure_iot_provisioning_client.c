@@ -136,10 +136,12 @@ NXD_MQTT_CLIENT *mqtt_client_ptr;
 NX_AZURE_IOT_RESOURCE *resource_ptr;
 
     /* Resolve the host name.  */
+    NX_PHASE_TRACE_BEGIN(NX_PHASE_DNS_RESOLVE);
     status = nxd_dns_host_by_name_get(prov_client_ptr -> nx_azure_iot_ptr -> nx_azure_iot_dns_ptr,
                                       (UCHAR *)prov_client_ptr -> nx_azure_iot_provisioning_client_endpoint,
                                       &server_address, NX_AZURE_IOT_PROVISIONING_CLIENT_DNS_TIMEOUT,
                                       NX_IP_VERSION_V4);
+    NX_PHASE_TRACE_END(NX_PHASE_DNS_RESOLVE);
     if (status)
     {
         LogError(LogLiteralArgs("IoTProvisioning client connect fail: DNS RESOLVE FAIL status: %d"), status);
@@ -161,10 +163,11 @@ NX_AZURE_IOT_RESOURCE *resource_ptr;
         return(status);
     }
 
-    /* Start MQTT connection.  */
+    /* Start MQTT connection, with a clean session: the registration is started again from the
+       beginning after a failure, nothing of the previous session is published again.  */
     status = nxd_mqtt_client_secure_connect(mqtt_client_ptr, &server_address, NXD_MQTT_TLS_PORT,
                                             nx_azure_iot_mqtt_tls_setup, NX_AZURE_IOT_MQTT_KEEP_ALIVE,
-                                            NX_FALSE, wait_option);
+                                            NX_TRUE, wait_option);
 
     if ((wait_option == NX_NO_WAIT) && (status == NX_IN_PROGRESS))
     {
@@ -336,6 +339,12 @@ NX_AZURE_IOT_PROVISIONING_CLIENT *prov_client_ptr = (NX_AZURE_IOT_PROVISIONING_C
         return;
     }
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+    /* Remember the TLS session for the next connect.  */
+    nx_azure_iot_tls_session_cache_update(prov_client_ptr -> nx_azure_iot_ptr,
+                                          &(prov_client_ptr -> nx_azure_iot_provisioning_client_resource), status);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
     /* Update hub client status.  */
     if (status == NXD_MQTT_SUCCESS)
     {
@@ -605,7 +614,7 @@ UCHAR *buffer_ptr;
 UINT buffer_size;
 UCHAR packet_id[2];
 UINT status;
-UINT mqtt_topic_length;
+size_t mqtt_topic_length;
 az_result core_result;
 
     status = nx_azure_iot_publish_packet_get(prov_client_ptr -> nx_azure_iot_ptr,
@@ -636,14 +645,14 @@ az_result core_result;
     {
         core_result = az_iot_provisioning_client_register_get_publish_topic(&(prov_client_ptr -> nx_azure_iot_provisioning_client_core),
                                                                             (CHAR *)buffer_ptr, buffer_size,
-                                                                            (size_t *)&mqtt_topic_length);
+                                                                            &mqtt_topic_length);
     }
     else
     {
         core_result = az_iot_provisioning_client_query_status_get_publish_topic(&(prov_client_ptr -> nx_azure_iot_provisioning_client_core),
                                                                                 register_response -> operation_id, (CHAR *)buffer_ptr,
                                                                                 buffer_size,
-                                                                                (size_t *)&mqtt_topic_length);
+                                                                                &mqtt_topic_length);
     }
 
     if (az_result_failed(core_result))
@@ -726,6 +735,7 @@ UINT status;
 NX_AZURE_IOT_RESOURCE *resource_ptr;
 UCHAR *output_ptr;
 UINT output_len;
+size_t sas_token_length;
 az_span span;
 az_result core_result;
 az_span buffer_span;
@@ -771,7 +781,7 @@ az_span policy_name = AZ_SPAN_LITERAL_FROM_STR(NX_AZURE_IOT_PROVISIONING_CLIENT_
                                                               buffer_span, expiry_time_secs, policy_name,
                                                               (CHAR *)resource_ptr -> resource_mqtt_sas_token,
                                                               prov_client_ptr -> nx_azure_iot_provisioning_client_sas_token_buff_size,
-                                                              (size_t *)&(resource_ptr -> resource_mqtt_sas_token_length));
+                                                              &sas_token_length);
     if (az_result_failed(core_result))
     {
         LogError(LogLiteralArgs("IoTProvisioning failed to generate token with error : %d"), core_result);
@@ -779,6 +789,8 @@ az_span policy_name = AZ_SPAN_LITERAL_FROM_STR(NX_AZURE_IOT_PROVISIONING_CLIENT_
         return(NX_AZURE_IOT_SDK_CORE_ERROR);
     }
 
+    resource_ptr -> resource_mqtt_sas_token_length = (UINT)sas_token_length;
+
     nx_azure_iot_buffer_free(buffer_context);
 
     return(NX_AZURE_IOT_SUCCESS);
@@ -796,7 +808,7 @@ UINT nx_azure_iot_provisioning_client_initialize(NX_AZURE_IOT_PROVISIONING_CLIEN
                                                  NX_SECURE_X509_CERT *trusted_certificate)
 {
 UINT status;
-UINT mqtt_user_name_length;
+size_t mqtt_user_name_length;
 NXD_MQTT_CLIENT *mqtt_client_ptr;
 NX_AZURE_IOT_RESOURCE *resource_ptr;
 UCHAR *buffer_ptr;
@@ -892,7 +904,7 @@ az_span registration_id_span = az_span_create((UCHAR *)registration_id, (INT)reg
     /* Build user name.  */
     if (az_result_failed(az_iot_provisioning_client_get_user_name(&(prov_client_ptr -> nx_azure_iot_provisioning_client_core),
                                                                   (CHAR *)buffer_ptr, buffer_size,
-                                                                  (size_t *)&mqtt_user_name_length)))
+                                                                  &mqtt_user_name_length)))
     {
         LogError(LogLiteralArgs("IoTProvisioning client connect fail: NX_AZURE_IOT_Provisioning_CLIENT_USERNAME_SIZE is too small."));
         nx_azure_iot_buffer_free(buffer_context);
@@ -59,6 +59,10 @@ static VOID _nxd_mqtt_release_transmit_packet(NXD_MQTT_CLIENT *client_ptr, NX_PA
 static VOID _nxd_mqtt_release_receive_packet(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, NX_PACKET *previous_packet_ptr);
 static UINT _nxd_mqtt_client_retransmit_message(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option);
 static UINT _nxd_mqtt_client_connect_packet_send(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option);
+#ifdef NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE
+static UINT _nxd_mqtt_qos1_inflight_insert(NXD_MQTT_CLIENT *client_ptr, USHORT packet_id);
+static UINT _nxd_mqtt_qos1_inflight_remove(NXD_MQTT_CLIENT *client_ptr, USHORT packet_id);
+#endif /* NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE */
 
 /**************************************************************************/
 /*                                                                        */
@@ -871,6 +875,187 @@ static VOID _nxd_mqtt_release_transmit_packet(NXD_MQTT_CLIENT *client_ptr, NX_PA
 #endif /* NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH */
 }
 
+#ifdef NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_qos1_inflight_insert                      PORTABLE C      */
+/*                                                           6.1.8        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function records the packet identifier of a QoS 1     */
+/*    PUBLISH sent without keeping a copy of the packet.  The table is    */
+/*    open addressed, starting at the slot given by the low bits of the   */
+/*    identifier.  Identifiers waiting longer than                        */
+/*    NXD_MQTT_QOS1_INFLIGHT_TIMEOUT are dropped first, their PUBACK is   */
+/*    considered lost.  Caller must hold the client mutex.                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_id                             Packet ID of the PUBLISH      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                                              */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_qos1_inflight_remove        Remove a packet identifier    */
+/*    tx_time_get                           Get the system time           */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_packet_send                                */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_qos1_inflight_insert(NXD_MQTT_CLIENT *client_ptr, USHORT packet_id)
+{
+UINT  slot;
+UINT  first_free = NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE;
+ULONG current_time = tx_time_get();
+
+    if (packet_id == 0)
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    /* Drop the identifiers whose PUBACK did not come in time.  Removal moves
+       later entries back, so the slot is checked again after a removal. */
+    slot = 0;
+    while ((slot < NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE) && (client_ptr -> message_qos1_inflight_count))
+    {
+        if ((client_ptr -> message_qos1_inflight_table[slot] != 0) &&
+            ((ULONG)(current_time - client_ptr -> message_qos1_inflight_time[slot]) >= NXD_MQTT_QOS1_INFLIGHT_TIMEOUT))
+        {
+            _nxd_mqtt_qos1_inflight_remove(client_ptr, client_ptr -> message_qos1_inflight_table[slot]);
+            continue;
+        }
+        slot++;
+    }
+
+    /* Walk the run from the home slot: an identifier already in it is still
+       waiting for its PUBACK and cannot be reused. */
+    slot = packet_id & (NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE - 1);
+    while (client_ptr -> message_qos1_inflight_count < NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE)
+    {
+        if (client_ptr -> message_qos1_inflight_table[slot] == 0)
+        {
+            first_free = slot;
+            break;
+        }
+
+        if (client_ptr -> message_qos1_inflight_table[slot] == packet_id)
+        {
+            return(NXD_MQTT_INVALID_STATE);
+        }
+        slot = (slot + 1) & (NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE - 1);
+    }
+
+    if (first_free == NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE)
+    {
+
+        /* Every slot is awaiting a PUBACK. */
+        return(NXD_MQTT_PACKET_POOL_FAILURE);
+    }
+
+    client_ptr -> message_qos1_inflight_table[first_free] = packet_id;
+    client_ptr -> message_qos1_inflight_time[first_free] = current_time;
+    client_ptr -> message_qos1_inflight_count++;
+
+    return(NXD_MQTT_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_qos1_inflight_remove                      PORTABLE C      */
+/*                                                           6.1.8        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function removes the packet identifier of an          */
+/*    acknowledged QoS 1 PUBLISH.  The entries following it in the same   */
+/*    run are moved back so that every lookup still ends at a free slot.  */
+/*    Caller must hold the client mutex.                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_id                             Packet ID of the PUBACK       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                NXD_MQTT_SUCCESS if found     */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_qos1_inflight_insert                                      */
+/*    _nxd_mqtt_process_publish_response                                  */
+/*    _nxd_mqtt_client_publish_packet_send                                */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_qos1_inflight_remove(NXD_MQTT_CLIENT *client_ptr, USHORT packet_id)
+{
+UINT   slot;
+UINT   next;
+UINT   home;
+UINT   count;
+USHORT entry;
+
+    if (packet_id == 0)
+    {
+        return(NX_NOT_FOUND);
+    }
+
+    slot = packet_id & (NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE - 1);
+    for (count = 0; client_ptr -> message_qos1_inflight_table[slot] != packet_id; count++)
+    {
+        if ((client_ptr -> message_qos1_inflight_table[slot] == 0) || (count == NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE))
+        {
+
+            /* Not sent by this client, or sent with a copy kept on the transmit queue. */
+            return(NX_NOT_FOUND);
+        }
+        slot = (slot + 1) & (NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE - 1);
+    }
+
+    /* Close the gap: move back each later entry of the run whose home slot
+       is not between the gap and the entry. */
+    next = slot;
+    for (count = 1; count < NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE; count++)
+    {
+        next = (next + 1) & (NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE - 1);
+        entry = client_ptr -> message_qos1_inflight_table[next];
+        if (entry == 0)
+        {
+            break;
+        }
+
+        home = entry & (NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE - 1);
+        if (((next - home) & (NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE - 1)) >=
+            ((next - slot) & (NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE - 1)))
+        {
+            client_ptr -> message_qos1_inflight_table[slot] = entry;
+            client_ptr -> message_qos1_inflight_time[slot] = client_ptr -> message_qos1_inflight_time[next];
+            slot = next;
+        }
+    }
+
+    client_ptr -> message_qos1_inflight_table[slot] = 0;
+    client_ptr -> message_qos1_inflight_count--;
+
+    return(NXD_MQTT_SUCCESS);
+}
+#endif /* NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE */
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -1029,6 +1214,8 @@ MQTT_PACKET_CONNACK *connack_packet_ptr = (MQTT_PACKET_CONNACK *)(packet_ptr ->
         else
         {
             ret = NXD_MQTT_SUCCESS;
+
+            NX_PHASE_TRACE_END(NX_PHASE_MQTT_CONNACK);
             
             /* Obtain mutex before we modify client control block. */
             tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
@@ -1525,6 +1712,25 @@ USHORT                        transmit_packet_id;
     packet_id = (USHORT)((response_ptr -> mqtt_publish_response_packet_packet_identifier_msb << 8) |
                          (response_ptr -> mqtt_publish_response_packet_packet_identifier_lsb));
 
+#ifdef NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE
+    /* A QoS 1 PUBLISH sent without a copy is only known by its packet identifier. */
+    if ((((response_ptr -> mqtt_publish_response_packet_header) >> 4) == MQTT_CONTROL_PACKET_TYPE_PUBACK) &&
+        (_nxd_mqtt_qos1_inflight_remove(client_ptr, packet_id) == NXD_MQTT_SUCCESS))
+    {
+
+        NX_PHASE_TRACE_END(NX_PHASE_MQTT_PUBACK);
+
+        /* Check ack notify function, there is no transmit packet to pass.  */
+        if (client_ptr -> nxd_mqtt_ack_receive_notify)
+        {
+            client_ptr -> nxd_mqtt_ack_receive_notify(client_ptr, MQTT_CONTROL_PACKET_TYPE_PUBACK, packet_id, NX_NULL, client_ptr -> nxd_mqtt_ack_receive_context);
+        }
+
+        /* Return with value 1, so the caller will release packet_ptr */
+        return(1);
+    }
+#endif /* NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE */
+
     /* Search all the outstanding transmitted packets for a match. */
     previous_packet_ptr = NX_NULL;
     transmit_packet_ptr = client_ptr -> message_transmit_queue_head;
@@ -1544,6 +1750,8 @@ USHORT                        transmit_packet_id;
                 if ((fixed_header & 0xF6) == ((MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4) | MQTT_PUBLISH_QOS_LEVEL_1))
                 {
 
+                    NX_PHASE_TRACE_END(NX_PHASE_MQTT_PUBACK);
+
                     /* Check ack notify function.  */
                     if (client_ptr -> nxd_mqtt_ack_receive_notify)
                     {
@@ -2328,6 +2536,7 @@ UINT       status;
 
 
     /* TCP connection is established.  */
+    NX_PHASE_TRACE_END(NX_PHASE_TCP_CONNECT);
 
     /* If TLS is enabled, start TLS */
 #ifdef NX_SECURE_ENABLE
@@ -3921,6 +4130,7 @@ UINT                 old_priority;
     tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
 
     /* Connect to the MQTT server */
+    NX_PHASE_TRACE_BEGIN(NX_PHASE_TCP_CONNECT);
     status = nxd_tcp_client_socket_connect(&(client_ptr -> nxd_mqtt_client_socket), server_ip, server_port, wait_option);
     if ((status != NX_SUCCESS) && (status != NX_IN_PROGRESS))
     {
@@ -3951,6 +4161,8 @@ UINT                 old_priority;
         return(NX_IN_PROGRESS);
     }
 
+    NX_PHASE_TRACE_END(NX_PHASE_TCP_CONNECT);
+
     /* Increase priority to the same of internal thread to avoid out of order packet process. */
 #ifndef NXD_MQTT_CLOUD_ENABLE
     thread_ptr = &(client_ptr -> nxd_mqtt_thread);
@@ -4103,6 +4315,9 @@ UCHAR                temp_data[4];
 UINT                 keepalive = (client_ptr -> nxd_mqtt_keepalive/NX_IP_PERIODIC_RATE);
 
 
+    /* The connection is established once the CONNACK is processed. */
+    NX_PHASE_TRACE_BEGIN(NX_PHASE_MQTT_CONNACK);
+
     /* Construct connect flags by taking the connect flag user supplies, or'ing the username and
        password bits, if they are supplied. */
     if (client_ptr -> nxd_mqtt_client_username)
@@ -4140,6 +4355,14 @@ UINT                 keepalive = (client_ptr -> nxd_mqtt_keepalive/NX_IP_PERIODI
         }
     }
 
+#ifdef NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE
+    /* QoS 1 messages kept by packet identifier only were sent on a clean
+       session and are not published again, a PUBACK for them can no longer
+       be expected. */
+    NXD_MQTT_SECURE_MEMSET(client_ptr -> message_qos1_inflight_table, 0, sizeof(client_ptr -> message_qos1_inflight_table));
+    client_ptr -> message_qos1_inflight_count = 0;
+#endif /* NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE */
+
     /* Set the length of the packet. */
     length = 10;
 
@@ -4514,7 +4737,32 @@ UINT _nxd_mqtt_client_publish_packet_send(NXD_MQTT_CLIENT *client_ptr, NX_PACKET
 
 UINT       status;
 UINT       ret = NXD_MQTT_SUCCESS;
+#ifdef NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE
+UINT       inflight = NX_FALSE;
+
+    /* Only a clean session never publishes the message again. */
+    if ((QoS == 1) && (client_ptr -> nxd_mqtt_clean_session == NX_TRUE))
+    {
+
+        /* Obtain the mutex. */
+        status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
 
+        if (status != TX_SUCCESS)
+        {
+            return(NXD_MQTT_MUTEX_FAILURE);
+        }
+
+        /* Keep the packet identifier only, the packet goes to the transport as is. */
+        status = _nxd_mqtt_qos1_inflight_insert(client_ptr, packet_id);
+        if (status)
+        {
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+            return(status);
+        }
+        inflight = NX_TRUE;
+    }
+    else
+#endif /* NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE */
     if (QoS != 0)
     {
     /* This packet needs to be stored locally for possible retransmission. */
@@ -4588,6 +4836,16 @@ UINT       ret = NXD_MQTT_SUCCESS;
     if (status)
     {
         ret = NXD_MQTT_COMMUNICATION_FAILURE;
+
+#ifdef NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE
+        if (inflight && (tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER) == TX_SUCCESS))
+        {
+
+            /* Not sent, no PUBACK will come for it. */
+            _nxd_mqtt_qos1_inflight_remove(client_ptr, packet_id);
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        }
+#endif /* NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE */
     }
 
     return(ret);
@@ -92,6 +92,25 @@ extern   "C" {
 #define NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH                          20
 */
 
+/* Defined, a QoS 1 PUBLISH on a clean session is not copied for retransmission. Only its packet
+   identifier is kept, in a table indexed by identifier, until the PUBACK arrives. A clean session
+   never publishes these messages again, and the ack receive notify gets a NULL transmit packet
+   for their PUBACK. A session connected with clean_session NX_FALSE keeps the copy, published
+   again with the DUP flag after a reconnect. The value is the table size, a power of 2, and
+   bounds the QoS 1 messages in flight.  */
+/*
+#define NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE                              32
+*/
+
+/* Set the time, in ticks, after which a QoS 1 packet identifier still waiting for its PUBACK is
+   dropped from the table, so that lost PUBACKs do not keep the table full. The default is
+   one minute. */
+#ifdef NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE
+#ifndef NXD_MQTT_QOS1_INFLIGHT_TIMEOUT
+#define NXD_MQTT_QOS1_INFLIGHT_TIMEOUT                                 (60 * NX_IP_PERIODIC_RATE)
+#endif
+#endif /* NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE */
+
 /* Define memcpy, memset and memcmp functions used internal. */
 #ifndef NXD_MQTT_SECURE_MEMCPY
 #define NXD_MQTT_SECURE_MEMCPY                                         memcpy
@@ -348,6 +367,11 @@ typedef struct NXD_MQTT_CLIENT_STRUCT
 #ifdef NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH
     UINT                           message_transmit_queue_depth;
 #endif /* NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH */
+#ifdef NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE
+    USHORT                         message_qos1_inflight_table[NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE]; /* Packet identifiers awaiting PUBACK, 0 is free. */
+    ULONG                          message_qos1_inflight_time[NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE];  /* Tick at which each identifier was sent. */
+    UINT                           message_qos1_inflight_count;
+#endif /* NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE */
     NX_PACKET                     *message_receive_queue_head;
     NX_PACKET                     *message_receive_queue_tail;
     UINT                           message_receive_queue_depth;
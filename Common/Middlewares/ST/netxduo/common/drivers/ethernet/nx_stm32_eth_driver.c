@@ -94,6 +94,9 @@ static UINT         _nx_driver_hardware_multicast_leave(NX_IP_DRIVER *driver_req
 static UINT         _nx_driver_hardware_get_status(NX_IP_DRIVER *driver_req_ptr);
 static VOID         _nx_driver_hardware_packet_transmitted(ETH_HandleTypeDef *heth);
 static VOID         _nx_driver_hardware_packet_received(VOID);
+#if defined(STM32_ETH_HAL_LEGACY) && (NX_DRIVER_TX_INTERRUPT_COALESCE > 1)
+static VOID         _nx_driver_hardware_transmit_reclaim_timeout(ULONG timer_input);
+#endif
 #ifdef NX_ENABLE_INTERFACE_CAPABILITY
 static UINT         _nx_driver_hardware_capability_set(NX_IP_DRIVER *driver_req_ptr);
 #endif /* NX_ENABLE_INTERFACE_CAPABILITY */
@@ -1182,7 +1185,12 @@ static VOID  _nx_driver_deferred_processing(NX_IP_DRIVER *driver_req_ptr)
   /* Restore interrupts.  */
   TX_RESTORE
     /* Check for a transmit complete event.  */
+#if defined(STM32_ETH_HAL_LEGACY) && (NX_DRIVER_TX_INTERRUPT_COALESCE > 1)
+    /* Frames sent without a completion interrupt are also reclaimed on receive events.  */
+    if(deferred_events & (NX_DRIVER_DEFERRED_PACKET_TRANSMITTED | NX_DRIVER_DEFERRED_PACKET_RECEIVED))
+#else
     if(deferred_events & NX_DRIVER_DEFERRED_PACKET_TRANSMITTED)
+#endif
     {
 
       /* Process transmitted packet(s).  */
@@ -1555,6 +1563,9 @@ static UINT  _nx_driver_hardware_initialize(NX_IP_DRIVER *driver_req_ptr)
   nx_driver_information.nx_driver_information_receive_current_index = 0;
   nx_driver_information.nx_driver_information_transmit_current_index = 0;
   nx_driver_information.nx_driver_information_transmit_release_index = 0;
+#ifdef STM32_ETH_HAL_LEGACY
+  nx_driver_information.nx_driver_information_transmit_frames_without_interrupt = 0;
+#endif
 
   /* Clear the number of buffers in use counter.  */
   nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use = 0;
@@ -1567,6 +1578,13 @@ static UINT  _nx_driver_hardware_initialize(NX_IP_DRIVER *driver_req_ptr)
     return(NX_DRIVER_ERROR);
   }
 
+#if defined(STM32_ETH_HAL_LEGACY) && (NX_DRIVER_TX_INTERRUPT_COALESCE > 1)
+  /* Create the timer reclaiming the frames sent without a completion interrupt, it runs only while there are some.  */
+  tx_timer_create(&nx_driver_information.nx_driver_information_transmit_reclaim_timer, "Ethernet TX Reclaim",
+                  _nx_driver_hardware_transmit_reclaim_timeout, 0,
+                  NX_DRIVER_TX_RECLAIM_TICKS, NX_DRIVER_TX_RECLAIM_TICKS, TX_NO_ACTIVATE);
+#endif
+
   nx_eth_init();
 
 #ifndef STM32_ETH_HAL_LEGACY
@@ -1716,6 +1734,12 @@ static UINT  _nx_driver_hardware_initialize(NX_IP_DRIVER *driver_req_ptr)
 #ifdef STM32_ETH_HAL_LEGACY
       DMARxDesc[i].Buffer1Addr = (uint32_t) packet_ptr -> nx_packet_prepend_ptr;
       DMARxDesc[i].ControlBufferSize = ETH_DMARXDESC_RCH | (packet_ptr -> nx_packet_data_end - packet_ptr -> nx_packet_data_start);
+
+      /* Only every NX_DRIVER_RX_INTERRUPT_COALESCE-th descriptor interrupts on completion.  */
+      if ((i + 1) % NX_DRIVER_RX_INTERRUPT_COALESCE)
+      {
+        DMARxDesc[i].ControlBufferSize |= ETH_DMARXDESC_DIC;
+      }
 #else
       DMARxDscrTab[i].DESC0 = (uint32_t) packet_ptr -> nx_packet_prepend_ptr;
       DMARxDscrTab[i].BackupAddr0 = (uint32_t) packet_ptr -> nx_packet_prepend_ptr;
@@ -1730,9 +1754,7 @@ static UINT  _nx_driver_hardware_initialize(NX_IP_DRIVER *driver_req_ptr)
       DMARxDscrTab[i].DESC3 = ETH_DMARXNDESCRF_OWN | ETH_DMARXNDESCRF_BUF1V|ETH_DMARXNDESCRF_IOC;
 #endif
 
-#if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
-      SCB_InvalidateDCache_by_Addr((uint32_t*)packet_ptr -> nx_packet_data_start, packet_ptr -> nx_packet_data_end - packet_ptr -> nx_packet_data_start);
-#endif
+      NX_DRIVER_DCACHE_INVALIDATE(packet_ptr -> nx_packet_data_start, packet_ptr -> nx_packet_data_end);
 
     }
     else
@@ -1818,6 +1840,10 @@ static UINT  _nx_driver_hardware_enable(NX_IP_DRIVER *driver_req_ptr)
   /* Call STM32 library to start Ethernet operation.  */
 #ifdef STM32_ETH_HAL_LEGACY
   HAL_ETH_Start(&eth_handle);
+#if NX_DRIVER_RX_INTERRUPT_COALESCE > 1
+  /* Raise the receive interrupt for frames landing in descriptors without one.  */
+  ETH -> DMARSWTR = NX_DRIVER_RX_INTERRUPT_WATCHDOG;
+#endif
   __HAL_ETH_DMA_ENABLE_IT((&eth_handle), ETH_DMA_IT_NIS | ETH_DMA_IT_R | ETH_DMA_IT_T);
 #else
   HAL_ETH_Start_IT(&eth_handle);
@@ -1876,6 +1902,10 @@ static UINT  _nx_driver_hardware_disable(NX_IP_DRIVER *driver_req_ptr)
 
   HAL_ETH_Stop(&eth_handle);
 
+#if defined(STM32_ETH_HAL_LEGACY) && (NX_DRIVER_TX_INTERRUPT_COALESCE > 1)
+  tx_timer_deactivate(&nx_driver_information.nx_driver_information_transmit_reclaim_timer);
+#endif
+
   /* Return success!  */
   return(NX_SUCCESS);
 }
@@ -1907,6 +1937,11 @@ static UINT  _nx_driver_hardware_disable(NX_IP_DRIVER *driver_req_ptr)
 /*                                                                        */
 /*    [_nx_driver_transmit_packet_enqueue]  Optional internal transmit    */
 /*                                            packet queue routine        */
+/*    [_nx_driver_hardware_packet_transmitted]                            */
+/*                                          Reclaim transmitted packets   */
+/*                                            when interrupts coalesce    */
+/*    [tx_timer_activate]                   Start the reclaim timer of    */
+/*                                            frames without interrupt    */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -1928,9 +1963,18 @@ static UINT  _nx_driver_hardware_packet_send(NX_PACKET *packet_ptr)
 ULONG           curIdx;
 NX_PACKET       *pktIdx;
 ULONG            bd_count = 0;
+ULONG            interrupt_on_completion = 0;
 TX_INTERRUPT_SAVE_AREA
 
 
+#if NX_DRIVER_TX_INTERRUPT_COALESCE > 1
+    /* Reclaim the BDs of frames sent without a completion interrupt.  */
+    if (nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use)
+    {
+        _nx_driver_hardware_packet_transmitted(&eth_handle);
+    }
+#endif
+
     /* Pick up the first BD. */
     curIdx = nx_driver_information.nx_driver_information_transmit_current_index;
 
@@ -1954,9 +1998,8 @@ TX_INTERRUPT_SAVE_AREA
     /* Clear the first Descriptor's LS bit.  */
     nx_driver_information.nx_driver_information_dma_tx_descriptors[curIdx].Status &= ~ETH_DMATXDESC_LS;
 
-#if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
-    SCB_CleanDCache_by_Addr((uint32_t*)(packet_ptr -> nx_packet_data_start), packet_ptr -> nx_packet_data_end - packet_ptr -> nx_packet_data_start);
-#endif
+    /* Write back the frame bytes only, the DMA does not read the rest of the buffer.  */
+    NX_DRIVER_DCACHE_CLEAN(packet_ptr -> nx_packet_prepend_ptr, packet_ptr -> nx_packet_append_ptr);
 
     /* Find next packet.  */
     for (pktIdx = packet_ptr -> nx_packet_next;
@@ -1987,13 +2030,28 @@ TX_INTERRUPT_SAVE_AREA
         /* Increment the BD count.  */
         bd_count++;
 
-#if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
-    SCB_CleanDCache_by_Addr((uint32_t*)(pktIdx -> nx_packet_data_start), pktIdx -> nx_packet_data_end - pktIdx -> nx_packet_data_start);
-#endif
+        NX_DRIVER_DCACHE_CLEAN(pktIdx -> nx_packet_prepend_ptr, pktIdx -> nx_packet_append_ptr);
     }
 
-    /* Set the last Descriptor's LS & IC & OWN bit.  */
-    nx_driver_information.nx_driver_information_dma_tx_descriptors[curIdx].Status |= (ETH_DMATXDESC_LS | ETH_DMATXDESC_IC | ETH_DMATXDESC_OWN);
+    /* Interrupt on completion every NX_DRIVER_TX_INTERRUPT_COALESCE frames, or when this frame takes the last free BDs.  */
+    if ((++nx_driver_information.nx_driver_information_transmit_frames_without_interrupt >= NX_DRIVER_TX_INTERRUPT_COALESCE) ||
+        (nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use + bd_count + 1 >= NX_DRIVER_TX_DESCRIPTORS))
+    {
+        interrupt_on_completion = ETH_DMATXDESC_IC;
+        nx_driver_information.nx_driver_information_transmit_frames_without_interrupt = 0;
+    }
+#if NX_DRIVER_TX_INTERRUPT_COALESCE > 1
+    else
+    {
+
+        /* Nothing may come to reclaim this frame on an idle link, start the reclaim timer if it is not running.  */
+        tx_timer_activate(&nx_driver_information.nx_driver_information_transmit_reclaim_timer);
+    }
+#endif
+
+    /* Set the last Descriptor's LS & IC bit.  */
+    nx_driver_information.nx_driver_information_dma_tx_descriptors[curIdx].Status &= ~ETH_DMATXDESC_IC;
+    nx_driver_information.nx_driver_information_dma_tx_descriptors[curIdx].Status |= (ETH_DMATXDESC_LS | interrupt_on_completion);
 
 #ifdef NX_ENABLE_INTERFACE_CAPABILITY
     /* Set HW checksum offload options according to the flags in NX_PACKET.  */
@@ -2014,6 +2072,9 @@ TX_INTERRUPT_SAVE_AREA
     }
 #endif /* NX_ENABLE_INTERFACE_CAPABILITY */
 
+    /* Set the last Descriptor's OWN bit, once its control bits are final.  */
+    nx_driver_information.nx_driver_information_dma_tx_descriptors[curIdx].Status |= ETH_DMATXDESC_OWN;
+
     /* Save the pkt pointer to release.  */
     nx_driver_information.nx_driver_information_transmit_packets[curIdx] = packet_ptr;
 
@@ -2084,9 +2145,7 @@ static UINT  _nx_driver_hardware_packet_send(NX_PACKET *packet_ptr)
     }
 
     i++;
-#if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
-    SCB_CleanDCache_by_Addr((uint32_t*)(pktIdx -> nx_packet_data_start), pktIdx -> nx_packet_data_end - pktIdx -> nx_packet_data_start);
-#endif
+    NX_DRIVER_DCACHE_CLEAN(pktIdx -> nx_packet_prepend_ptr, pktIdx -> nx_packet_append_ptr);
   }
 
 #ifdef NX_ENABLE_INTERFACE_CAPABILITY
@@ -2269,7 +2328,7 @@ static UINT  _nx_driver_hardware_multicast_leave(NX_IP_DRIVER *driver_req_ptr)
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    nx_eth_phy_get_link_state             Get the PHY link state        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -2287,6 +2346,16 @@ static UINT  _nx_driver_hardware_multicast_leave(NX_IP_DRIVER *driver_req_ptr)
 static UINT  _nx_driver_hardware_get_status(NX_IP_DRIVER *driver_req_ptr)
 {
 
+  /* Report the link state of the PHY, NetX reads it from the return pointer.  */
+  if (nx_eth_phy_get_link_state() <= ETH_PHY_STATUS_LINK_DOWN)
+  {
+    *(driver_req_ptr -> nx_ip_driver_return_ptr) = NX_FALSE;
+  }
+  else
+  {
+    *(driver_req_ptr -> nx_ip_driver_return_ptr) = NX_TRUE;
+  }
+
   /* Return success.  */
   return(NX_SUCCESS);
 }
@@ -2324,6 +2393,8 @@ static UINT  _nx_driver_hardware_get_status(NX_IP_DRIVER *driver_req_ptr)
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    _nx_driver_deferred_processing        Deferred driver processing    */
+/*    [_nx_driver_hardware_packet_send]     Driver packet send, when      */
+/*                                            interrupts coalesce         */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -2408,6 +2479,81 @@ static VOID  _nx_driver_hardware_packet_transmitted(ETH_HandleTypeDef *heth)
 }
 
 
+#if defined(STM32_ETH_HAL_LEGACY) && (NX_DRIVER_TX_INTERRUPT_COALESCE > 1)
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_reclaim_timeout                        */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is the expiration of the transmit reclaim timer. The  */
+/*    frames sent without a completion interrupt are otherwise reclaimed  */
+/*    on the next driver event only, and TCP does not retransmit a packet */
+/*    until the driver releases it. The timer stops itself once all the   */
+/*    transmit buffers are released.                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    timer_input                           Not used                      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_timer_deactivate                   Stop the reclaim timer        */
+/*    _nx_ip_driver_deferred_processing     IP receive packet processing  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    ThreadX timer                                                       */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  xx-xx-xxxx     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _nx_driver_hardware_transmit_reclaim_timeout(ULONG timer_input)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  ULONG deferred_events;
+
+  NX_PARAMETER_NOT_USED(timer_input);
+
+  if (nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use == 0)
+  {
+
+    /* All the frames are reclaimed.  */
+    tx_timer_deactivate(&nx_driver_information.nx_driver_information_transmit_reclaim_timer);
+    return;
+  }
+
+  TX_DISABLE
+  deferred_events = nx_driver_information.nx_driver_information_deferred_events;
+  nx_driver_information.nx_driver_information_deferred_events |= NX_DRIVER_DEFERRED_PACKET_TRANSMITTED;
+  TX_RESTORE
+
+  if (!deferred_events)
+  {
+    /* Call NetX deferred driver processing.  */
+    _nx_ip_driver_deferred_processing(nx_driver_information.nx_driver_information_ip_ptr);
+  }
+}
+#endif
+
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -2423,6 +2569,11 @@ static VOID  _nx_driver_hardware_packet_transmitted(ETH_HandleTypeDef *heth)
 /*    This function processes packets received by the ethernet            */
 /*    controller. This driver assumes NX_PACKET to be MTU size            */
 /*                                                                        */
+/*    The BDs of the received frames are posted again in one pass, before */
+/*    the frames are transferred to NetX. When the pool is empty, the     */
+/*    oldest frames are dropped and their packets posted again, so the    */
+/*    DMA always has a buffer for each BD.                                */
+/*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    None                                                                */
@@ -2454,105 +2605,89 @@ static VOID  _nx_driver_hardware_packet_transmitted(ETH_HandleTypeDef *heth)
 static VOID  _nx_driver_hardware_packet_received(VOID)
 {
 
-  NX_PACKET     *packet_ptr;
-  NX_PACKET  *received_packet_ptr;
-  INT            i;
-ULONG          bd_count = 0;
-ULONG          idx;
-ULONG          temp_idx;
-ULONG          first_idx = nx_driver_information.nx_driver_information_receive_current_index;
-  received_packet_ptr = nx_driver_information.nx_driver_information_receive_packets[first_idx];
-
-
-    /* Find out the BDs that owned by CPU.  */
-    for (first_idx = idx = nx_driver_information.nx_driver_information_receive_current_index;
-        (nx_driver_information.nx_driver_information_dma_rx_descriptors[idx].Status & ETH_DMARXDESC_OWN) == 0;
+NX_PACKET           *packet_ptr;
+NX_PACKET           *received_packet_ptr;
+NX_PACKET           *received_head_ptr = NX_NULL;
+NX_PACKET           *received_tail_ptr = NX_NULL;
+NX_PACKET           *recycle_ptr = NX_NULL;
+ETH_DMADescTypeDef  *dmarxdescs = nx_driver_information.nx_driver_information_dma_rx_descriptors;
+NX_PACKET           **nx_packets = nx_driver_information.nx_driver_information_receive_packets;
+ULONG               bd_count = 0;
+ULONG               frame_length;
+ULONG               idx;
+ULONG               temp_idx;
+ULONG               first_idx;
+ULONG               refill_idx = nx_driver_information.nx_driver_information_receive_current_index;
+ULONG               refill_count = 0;
+
+
+    /* Find out the BDs that owned by CPU. The BDs of complete frames are emptied here and refilled below.  */
+    for (first_idx = idx = refill_idx;
+         (nx_packets[idx] != NX_NULL) && ((dmarxdescs[idx].Status & ETH_DMARXDESC_OWN) == 0);
          idx = (idx + 1) & (NX_DRIVER_RX_DESCRIPTORS - 1))
     {
 
         /* Is the BD marked as the end of a frame?  */
-        if (nx_driver_information.nx_driver_information_dma_rx_descriptors[idx].Status & ETH_DMARXDESC_LS)
+        if (dmarxdescs[idx].Status & ETH_DMARXDESC_LS)
         {
 
+            /* Discard the cached lines of the frame bytes in this BD, before the CPU reads them.  */
+            frame_length = (dmarxdescs[idx].Status & ETH_DMARXDESC_FL) >> ETH_DMARXDESC_FRAME_LENGTHSHIFT;
+            NX_DRIVER_DCACHE_INVALIDATE(nx_packets[idx] -> nx_packet_prepend_ptr,
+                                        nx_packets[idx] -> nx_packet_prepend_ptr + frame_length - bd_count * nx_driver_information.nx_driver_information_rx_buffer_size);
+
             /* Yes, this BD is the last BD in the frame, set the last NX_PACKET's nx_packet_next to NULL.  */
-            nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_next = NX_NULL;
+            nx_packets[idx] -> nx_packet_next = NX_NULL;
 
             /* Store the length of the packet in the first NX_PACKET.  */
-            nx_driver_information.nx_driver_information_receive_packets[first_idx] -> nx_packet_length = ((nx_driver_information.nx_driver_information_dma_rx_descriptors[idx].Status & ETH_DMARXDESC_FL) >> ETH_DMARXDESC_FRAME_LENGTHSHIFT) - 4;
+            nx_packets[first_idx] -> nx_packet_length = frame_length - 4;
 
             /* Adjust nx_packet_append_ptr with the size of the data in this buffer.  */
-            nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_append_ptr = nx_driver_information.nx_driver_information_receive_packets[idx]->nx_packet_prepend_ptr
-                                                                                                     + nx_driver_information.nx_driver_information_receive_packets[first_idx]->nx_packet_length
-                                                                                                     - bd_count * nx_driver_information.nx_driver_information_rx_buffer_size;
+            nx_packets[idx] -> nx_packet_append_ptr = nx_packets[idx] -> nx_packet_prepend_ptr
+                                                    + nx_packets[first_idx] -> nx_packet_length
+                                                    - bd_count * nx_driver_information.nx_driver_information_rx_buffer_size;
+
             /* Is there only one BD for the current frame?  */
             if (idx != first_idx)
             {
 
                 /* No, this BD is not the first BD of the frame, frame data starts at the aligned address.  */
-                nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_prepend_ptr -= 2;
+                nx_packets[idx] -> nx_packet_prepend_ptr -= 2;
 
-                if (nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_prepend_ptr >= nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_append_ptr)
+                if (nx_packets[idx] -> nx_packet_prepend_ptr >= nx_packets[idx] -> nx_packet_append_ptr)
                 {
 
+                    /* This BD holds nothing but the CRC, leave its packet in place to be posted again below.  */
                     temp_idx = (idx - 1) & (NX_DRIVER_RX_DESCRIPTORS - 1);
-                    nx_driver_information.nx_driver_information_receive_packets[temp_idx] -> nx_packet_next = NX_NULL;
-                    nx_driver_information.nx_driver_information_receive_packets[temp_idx] -> nx_packet_append_ptr -= nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_prepend_ptr >= nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_append_ptr;
-                    nx_driver_information.nx_driver_information_dma_rx_descriptors[idx].Status = ETH_DMARXDESC_OWN;
-                    nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_prepend_ptr = nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_data_start + 2;
+                    nx_packets[temp_idx] -> nx_packet_next = NX_NULL;
+                    nx_packets[temp_idx] -> nx_packet_append_ptr -= nx_packets[idx] -> nx_packet_prepend_ptr >= nx_packets[idx] -> nx_packet_append_ptr;
                     bd_count--;
                 }
             }
 
-            /* Allocate new NX_PACKETs for BDs.  */
-            for (i = bd_count; i >= 0; i--)
+            /* Take the packets of the frame out of the ring.  */
+            received_packet_ptr = nx_packets[first_idx];
+            temp_idx = first_idx;
+            do
             {
+                nx_packets[temp_idx] = NX_NULL;
+                temp_idx = (temp_idx + 1) & (NX_DRIVER_RX_DESCRIPTORS - 1);
+            } while (bd_count--);
 
-                temp_idx = (first_idx + i) & (NX_DRIVER_RX_DESCRIPTORS - 1);
-
-                /* Allocate a new packet from the packet pool.  */
-                if (nx_packet_allocate(nx_driver_information.nx_driver_information_packet_pool_ptr, &packet_ptr,
-                                          NX_RECEIVE_PACKET, NX_NO_WAIT) == NX_SUCCESS)
-                {
-
-                    /* Adjust the new packet and assign it to the BD.  */
-                    packet_ptr -> nx_packet_prepend_ptr += 2;
-                    nx_driver_information.nx_driver_information_dma_rx_descriptors[temp_idx].Buffer1Addr = (ULONG)packet_ptr->nx_packet_prepend_ptr;
-                    nx_driver_information.nx_driver_information_dma_rx_descriptors[temp_idx].Status = ETH_DMARXDESC_OWN;
-                    nx_driver_information.nx_driver_information_receive_packets[temp_idx] = packet_ptr;
-#if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
-      SCB_InvalidateDCache_by_Addr((uint32_t*)packet_ptr -> nx_packet_data_start, packet_ptr -> nx_packet_data_end - packet_ptr -> nx_packet_data_start);
-#endif
-
-                }
-                else
-                {
-
-                    /* Allocation failed, get out of the loop.  */
-                    break;
-                }
-            }
-
-            if (i >= 0)
+            /* Queue the frame, it is transferred to NetX once the ring is refilled.  */
+            received_packet_ptr -> nx_packet_queue_next = NX_NULL;
+            if (received_tail_ptr)
             {
-
-                /* At least one packet allocation was failed, release the received packet.  */
-                nx_packet_release(nx_driver_information.nx_driver_information_receive_packets[temp_idx] -> nx_packet_next);
-
-                for (; i >= 0; i--)
-                {
-
-                    /* Free up the BD to ready state. */
-                    temp_idx = (first_idx + i) & (NX_DRIVER_RX_DESCRIPTORS - 1);
-                    nx_driver_information.nx_driver_information_dma_rx_descriptors[temp_idx].Status = ETH_DMARXDESC_OWN;
-                    nx_driver_information.nx_driver_information_receive_packets[temp_idx] -> nx_packet_prepend_ptr = nx_driver_information.nx_driver_information_receive_packets[temp_idx] -> nx_packet_data_start + 2;
-                }
+                received_tail_ptr -> nx_packet_queue_next = received_packet_ptr;
             }
             else
             {
-
-                /* Everything is OK, transfer the packet to NetX.  */
-                _nx_driver_transfer_to_netx(nx_driver_information.nx_driver_information_ip_ptr, received_packet_ptr);
+                received_head_ptr = received_packet_ptr;
             }
+            received_tail_ptr = received_packet_ptr;
+
+            /* Count the BDs of the frame, the ring is emptied whole when every BD held a frame.  */
+            refill_count += ((idx - first_idx) & (NX_DRIVER_RX_DESCRIPTORS - 1)) + 1;
 
             /* Set the first BD index for the next packet.  */
             first_idx = (idx + 1) & (NX_DRIVER_RX_DESCRIPTORS - 1);
@@ -2560,30 +2695,71 @@ ULONG          first_idx = nx_driver_information.nx_driver_information_receive_c
             /* Update the current receive index.  */
             nx_driver_information.nx_driver_information_receive_current_index = first_idx;
 
-            received_packet_ptr = nx_driver_information.nx_driver_information_receive_packets[first_idx];
-
             bd_count = 0;
-
         }
         else
         {
 
             /* This BD is not the last BD of a frame. It is a intermediate descriptor.  */
+            NX_DRIVER_DCACHE_INVALIDATE(nx_packets[idx] -> nx_packet_data_start, nx_packets[idx] -> nx_packet_data_end);
 
-            nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_next = nx_driver_information.nx_driver_information_receive_packets[(idx + 1) & (NX_DRIVER_RX_DESCRIPTORS - 1)];
+            nx_packets[idx] -> nx_packet_next = nx_packets[(idx + 1) & (NX_DRIVER_RX_DESCRIPTORS - 1)];
 
-            nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_append_ptr = nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_data_end;
+            nx_packets[idx] -> nx_packet_append_ptr = nx_packets[idx] -> nx_packet_data_end;
 
             if (idx != first_idx)
             {
 
-                nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_prepend_ptr = nx_driver_information.nx_driver_information_receive_packets[idx] -> nx_packet_data_start;
+                nx_packets[idx] -> nx_packet_prepend_ptr = nx_packets[idx] -> nx_packet_data_start;
             }
 
             bd_count++;
         }
     }
 
+    /* Post a buffer to each BD emptied above, in ring order, so that the DMA never runs out of them.  */
+    for (; refill_count; refill_count--, refill_idx = (refill_idx + 1) & (NX_DRIVER_RX_DESCRIPTORS - 1))
+    {
+
+        packet_ptr = nx_packets[refill_idx];
+        if (packet_ptr == NX_NULL)
+        {
+
+            /* Allocate a new packet from the packet pool.  */
+            if (nx_packet_allocate(nx_driver_information.nx_driver_information_packet_pool_ptr, &packet_ptr,
+                                   NX_RECEIVE_PACKET, NX_NO_WAIT) == NX_SUCCESS)
+            {
+
+                /* Discard the lines the packet has in the cache, a dirty one would be written over the DMA data.  */
+                NX_DRIVER_DCACHE_INVALIDATE(packet_ptr -> nx_packet_data_start, packet_ptr -> nx_packet_data_end);
+            }
+            else
+            {
+
+                /* Allocation failed, drop the oldest received frame and post its packets again.  */
+                if (recycle_ptr == NX_NULL)
+                {
+                    recycle_ptr = received_head_ptr;
+                    received_head_ptr = received_head_ptr -> nx_packet_queue_next;
+                }
+                packet_ptr = recycle_ptr;
+                recycle_ptr = recycle_ptr -> nx_packet_next;
+            }
+        }
+
+        /* Adjust the packet and assign it to the BD.  */
+        packet_ptr -> nx_packet_prepend_ptr = packet_ptr -> nx_packet_data_start + 2;
+        dmarxdescs[refill_idx].Buffer1Addr = (ULONG)packet_ptr -> nx_packet_prepend_ptr;
+        nx_packets[refill_idx] = packet_ptr;
+        dmarxdescs[refill_idx].Status = ETH_DMARXDESC_OWN;
+    }
+
+    /* Release what is left of a dropped frame.  */
+    if (recycle_ptr)
+    {
+        nx_packet_release(recycle_ptr);
+    }
+
     /* If Rx DMA is in suspended state, resume it.  */
     if ((ETH->DMASR & ETH_DMASR_RBUS) != (ULONG)RESET)
     {
@@ -2594,6 +2770,13 @@ ULONG          first_idx = nx_driver_information.nx_driver_information_receive_c
         ETH->DMARPDR = 0;
     }
 
+    /* Transfer the received frames to NetX.  */
+    while (received_head_ptr)
+    {
+        received_packet_ptr = received_head_ptr;
+        received_head_ptr = received_head_ptr -> nx_packet_queue_next;
+        _nx_driver_transfer_to_netx(nx_driver_information.nx_driver_information_ip_ptr, received_packet_ptr);
+    }
 }
 
 #else
@@ -2628,9 +2811,7 @@ static VOID  _nx_driver_hardware_packet_received(VOID)
     {
       /* Adjust the packet.  */
       packet_ptr -> nx_packet_prepend_ptr += 2;
-#if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
-      SCB_InvalidateDCache_by_Addr((uint32_t*)packet_ptr -> nx_packet_data_start, packet_ptr -> nx_packet_data_end - packet_ptr -> nx_packet_data_start);
-#endif
+      NX_DRIVER_DCACHE_INVALIDATE(packet_ptr -> nx_packet_data_start, packet_ptr -> nx_packet_data_end);
       HAL_ETH_DescAssignMemory(&eth_handle, FirstAppDesc, packet_ptr -> nx_packet_prepend_ptr, NULL);
       nx_driver_information.nx_driver_information_receive_packets[FirstAppDesc] = packet_ptr;
 
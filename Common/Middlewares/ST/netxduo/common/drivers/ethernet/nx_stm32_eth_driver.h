@@ -100,6 +100,44 @@ extern   "C" {
 #endif
 #endif
 
+#ifdef STM32_ETH_HAL_LEGACY
+/* Define the number of frames sent per transmit complete interrupt. The descriptors of the other frames are
+   reclaimed on the next deferred event, or before sending when the ring is short of descriptors.  */
+#ifndef NX_DRIVER_TX_INTERRUPT_COALESCE
+#define NX_DRIVER_TX_INTERRUPT_COALESCE    1
+#endif
+
+/* Define the period in ticks of the reclaim of frames sent without a completion interrupt while no other
+   event comes, so TCP can retransmit them on an idle link.  */
+#ifndef NX_DRIVER_TX_RECLAIM_TICKS
+#define NX_DRIVER_TX_RECLAIM_TICKS         1
+#endif
+
+/* Define the number of receive descriptors per receive interrupt. Frames landing in the other descriptors are
+   signaled by the receive watchdog, NX_DRIVER_RX_INTERRUPT_WATCHDOG x 256 HCLK cycles after the last one.  */
+#ifndef NX_DRIVER_RX_INTERRUPT_COALESCE
+#define NX_DRIVER_RX_INTERRUPT_COALESCE    1
+#endif
+
+#ifndef NX_DRIVER_RX_INTERRUPT_WATCHDOG
+#define NX_DRIVER_RX_INTERRUPT_WATCHDOG    0xFF
+#endif
+#endif
+
+/* Define the cache maintenance of the bytes from start to end that the DMA reads or writes. Cortex-M7 operates
+   on whole 32 bytes lines from an aligned address, packet payloads should be aligned too (NX_PACKET_ALIGNMENT).  */
+#if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+#define NX_DRIVER_DCACHE_LINE_SIZE              32
+#define NX_DRIVER_DCACHE_LINE_START(a)          ((ULONG)(a) & ~(ULONG)(NX_DRIVER_DCACHE_LINE_SIZE - 1))
+#define NX_DRIVER_DCACHE_CLEAN(start, end)      SCB_CleanDCache_by_Addr((uint32_t *)NX_DRIVER_DCACHE_LINE_START(start), \
+                                                                        (int32_t)((ULONG)(end) - NX_DRIVER_DCACHE_LINE_START(start)))
+#define NX_DRIVER_DCACHE_INVALIDATE(start, end) SCB_InvalidateDCache_by_Addr((uint32_t *)NX_DRIVER_DCACHE_LINE_START(start), \
+                                                                             (int32_t)((ULONG)(end) - NX_DRIVER_DCACHE_LINE_START(start)))
+#else
+#define NX_DRIVER_DCACHE_CLEAN(start, end)
+#define NX_DRIVER_DCACHE_INVALIDATE(start, end)
+#endif
+
 /****** DRIVER SPECIFIC ****** End of part/vendor specific constant area!  */
 
 #define NX_DRIVER_CAPABILITY ( NX_INTERFACE_CAPABILITY_IPV4_TX_CHECKSUM   | \
@@ -156,6 +194,14 @@ typedef struct NX_DRIVER_INFORMATION_STRUCT
 #ifdef STM32_ETH_HAL_LEGACY
     ETH_DMADescTypeDef  nx_driver_information_dma_rx_descriptors[NX_DRIVER_RX_DESCRIPTORS];
     ETH_DMADescTypeDef  nx_driver_information_dma_tx_descriptors[NX_DRIVER_TX_DESCRIPTORS];
+
+    /* Number of frames sent since the last one with a transmit complete interrupt.  */
+    UINT                nx_driver_information_transmit_frames_without_interrupt;
+
+#if NX_DRIVER_TX_INTERRUPT_COALESCE > 1
+    /* Timer reclaiming the frames sent without a transmit complete interrupt.  */
+    TX_TIMER            nx_driver_information_transmit_reclaim_timer;
+#endif
 #endif
 
     /* Define the association between buffer descriptors and NetX packets.  */
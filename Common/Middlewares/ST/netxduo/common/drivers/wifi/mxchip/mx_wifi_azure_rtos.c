@@ -8,7 +8,9 @@ extern TX_THREAD * _tx_thread_current_ptr;
 extern NX_DRIVER_INFORMATION nx_driver_information;
 
 
+#ifndef mx_wifi_byte_pool_size
 #define mx_wifi_byte_pool_size (1024 * 4) /* less than 3k is actually used */
+#endif
 static ULONG mx_wifi_byte_pool_buffer[mx_wifi_byte_pool_size / sizeof (ULONG)];
 static TX_BYTE_POOL mx_wifi_byte_pool;
 
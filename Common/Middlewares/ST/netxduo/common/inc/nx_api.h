@@ -128,12 +128,39 @@ extern   "C" {
 
 #include "tx_trace.h"
 
+/* Define the connection phase trace hook. nx_user.h may map NX_PHASE_TRACE(phase, end) to an
+   application function to timestamp each phase of bringing up a secure connection. By default
+   the hook compiles away.  */
+#ifndef NX_PHASE_TRACE
+#define NX_PHASE_TRACE(phase, end)
+#endif /* NX_PHASE_TRACE */
+
+#define NX_PHASE_TRACE_BEGIN(phase)                         NX_PHASE_TRACE(phase, NX_FALSE)
+#define NX_PHASE_TRACE_END(phase)                           NX_PHASE_TRACE(phase, NX_TRUE)
+
+/* Define the connection phases reported to the trace hook.  */
+#define NX_PHASE_LINK_UP                                    0
+#define NX_PHASE_DHCP_BOUND                                 1
+#define NX_PHASE_SNTP_SYNC                                  2
+#define NX_PHASE_DNS_RESOLVE                                3
+#define NX_PHASE_TCP_CONNECT                                4
+#define NX_PHASE_TLS_HANDSHAKE                              5
+#define NX_PHASE_TLS_CERT_VERIFY                            6
+#define NX_PHASE_MQTT_CONNACK                               7
+#define NX_PHASE_TWIN_GET                                   8
+#define NX_PHASE_MQTT_PUBACK                                9
+#define NX_PHASE_COUNT                                      10
+
 #ifdef NX_ENABLE_TCPIP_OFFLOAD
 #ifndef NX_ENABLE_INTERFACE_CAPABILITY
 #error "NX_ENABLE_INTERFACE_CAPABILITY must be defined to enable TCP/IP offload"
 #endif /* NX_ENABLE_INTERFACE_CAPABILITY */
 #endif /* NX_ENABLE_TCPIP_OFFLOAD */
 
+#if defined(NX_TCP_FAST_TIMER_ON_DEMAND) && defined(FEATURE_NX_IPV6)
+#error "NX_TCP_FAST_TIMER_ON_DEMAND requires NX_DISABLE_IPV6, IPv6 needs the periodic fast timer"
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND && FEATURE_NX_IPV6 */
+
 /* Define symbols for compatibility before and after ThreadX 5.8. */
 #if (((THREADX_MAJOR_VERSION << 8) | THREADX_MINOR_VERSION) >= 0x0508)
 #define NX_CLEANUP_PARAMETER , ULONG suspension_sequence
@@ -1840,6 +1867,27 @@ typedef struct NX_UDP_SOCKET_STRUCT
 #endif
 
 
+#ifdef NX_ENABLE_TCP_SACK
+/* Define the number of SACK blocks a socket remembers from its peer.  */
+#ifndef NX_TCP_SACK_SCOREBOARD_SIZE
+#define NX_TCP_SACK_SCOREBOARD_SIZE 4
+#endif /* NX_TCP_SACK_SCOREBOARD_SIZE */
+
+/* Define the maximum number of SACK blocks reported in one ACK, at most 4 fit in the
+   option area.  */
+#ifndef NX_TCP_SACK_MAX_BLOCKS
+#define NX_TCP_SACK_MAX_BLOCKS      3
+#endif /* NX_TCP_SACK_MAX_BLOCKS */
+
+/* Define the sequence range [start, end) the peer has selectively acknowledged.  */
+typedef struct NX_TCP_SACK_BLOCK_STRUCT
+{
+    ULONG       nx_tcp_sack_block_start;
+    ULONG       nx_tcp_sack_block_end;
+} NX_TCP_SACK_BLOCK;
+#endif /* NX_ENABLE_TCP_SACK */
+
+
 /* Define the basic TCP socket structure.  This structure is used to manage all information
    necessary to manage TCP transmission and reception.  */
 
@@ -1886,6 +1934,10 @@ typedef struct NX_TCP_SOCKET_STRUCT
     ULONG       nx_tcp_socket_rx_sequence;
     ULONG       nx_tcp_socket_rx_sequence_acked;
     ULONG       nx_tcp_socket_delayed_ack_timeout;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+    /* Set once the pending delayed ACK is counted by the fast timer.  */
+    UINT        nx_tcp_socket_delayed_ack_armed;
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
     ULONG       nx_tcp_socket_fin_sequence;
     USHORT      nx_tcp_socket_fin_received;
     USHORT      nx_tcp_socket_fin_acked;
@@ -1986,6 +2038,28 @@ typedef struct NX_TCP_SOCKET_STRUCT
     ULONG       nx_tcp_snd_win_scale_value;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
 
+#ifdef NX_ENABLE_TCP_SACK
+    /* Set when both sides offered selective acknowledgment on the SYN.  */
+    UINT        nx_tcp_socket_sack_permitted;
+
+    /* Scoreboard of the data above the cumulative ACK the peer has reported, sorted by
+       sequence and without overlap.  */
+    UINT        nx_tcp_socket_sack_count;
+    NX_TCP_SACK_BLOCK
+                nx_tcp_socket_sack_scoreboard[NX_TCP_SACK_SCOREBOARD_SIZE];
+
+    /* Highest sequence retransmitted during the current fast recovery.  */
+    ULONG       nx_tcp_socket_sack_high_rxt;
+
+    /* Start of the last data segment received, its block is reported first.  */
+    ULONG       nx_tcp_socket_sack_received_sequence;
+
+    /* Blocks of the last SACK option sent, most recent first, reported again after it.  */
+    UINT        nx_tcp_socket_sack_reported_count;
+    NX_TCP_SACK_BLOCK
+                nx_tcp_socket_sack_reported[NX_TCP_SACK_MAX_BLOCKS];
+#endif /* NX_ENABLE_TCP_SACK */
+
     /* Define the TCP keepalive timer parameters.  If enabled with NX_ENABLE_TCP_KEEPALIVE,
        these parameters are used to implement the keepalive timer.  */
 #ifdef NX_ENABLE_TCP_KEEPALIVE
@@ -2802,6 +2876,14 @@ typedef struct NX_IP_STRUCT
        this IP instance.  */
     TX_TIMER    nx_ip_fast_periodic_timer;
 
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+    /* Define the state of the on demand fast timer.  The pending TCP timeouts count down from
+       the base time, and the timer is active only while one of them is running.  */
+    ULONG       nx_ip_tcp_fast_timer_base;
+    ULONG       nx_ip_tcp_fast_timer_expiry;
+    UINT        nx_ip_tcp_fast_timer_active;
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
+
 #ifndef NX_DISABLE_IPV4
     /* Define the destination routing information associated with this IP
        instance.  */
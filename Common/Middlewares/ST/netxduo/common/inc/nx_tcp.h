@@ -98,6 +98,12 @@
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
 #define NX_TCP_RWIN_KIND                0x03                /* RWIN option kind             */
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
+#ifdef NX_ENABLE_TCP_SACK
+#define NX_TCP_SACK_PERMITTED_OPTION    ((ULONG)0x01010402) /* NOP, NOP, SACK permitted     */
+#define NX_TCP_SACK_PERMITTED_KIND      0x04                /* SACK permitted option kind   */
+#define NX_TCP_SACK_KIND                0x05                /* SACK option kind             */
+#define NX_TCP_SACK_RETRANSMIT          2                   /* Retransmit the next hole     */
+#endif /* NX_ENABLE_TCP_SACK */
 
 
 /* Define constants for the optional TCP keepalive Timer.  To enable this
@@ -300,6 +306,15 @@ VOID _nx_tcp_cleanup_deferred(TX_THREAD *thread_ptr NX_CLEANUP_PARAMETER);
 VOID _nx_tcp_client_bind_cleanup(TX_THREAD *thread_ptr NX_CLEANUP_PARAMETER);
 VOID _nx_tcp_deferred_cleanup_check(NX_IP *ip_ptr);
 VOID _nx_tcp_fast_periodic_processing(NX_IP *ip_ptr);
+#ifdef NX_ENABLE_TCP_SACK
+UCHAR *_nx_tcp_sack_option_get(UCHAR *option_ptr, ULONG option_area_size, UINT option_kind);
+ULONG _nx_tcp_sack_option_build(NX_TCP_SOCKET *socket_ptr, UCHAR *option_ptr, ULONG option_area_size);
+VOID _nx_tcp_socket_sack_process(NX_TCP_SOCKET *socket_ptr, UCHAR *option_ptr, ULONG option_area_size, ULONG ack_number);
+#endif /* NX_ENABLE_TCP_SACK */
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+VOID _nx_tcp_fast_timer_schedule(NX_IP *ip_ptr, ULONG deadline);
+VOID _nx_tcp_socket_fast_timer_arm(NX_TCP_SOCKET *socket_ptr, ULONG *timeout_ptr);
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 VOID _nx_tcp_socket_retransmit(NX_IP *ip_ptr, NX_TCP_SOCKET *socket_ptr, UINT need_fast_retransmit);
 VOID _nx_tcp_connect_cleanup(TX_THREAD *thread_ptr NX_CLEANUP_PARAMETER);
 VOID _nx_tcp_disconnect_cleanup(TX_THREAD *thread_ptr NX_CLEANUP_PARAMETER);
@@ -386,6 +386,14 @@
 #define NX_TCP_FAST_TIMER_RATE      10
 */
 
+/* Defined, the fast TCP timer only runs while a TCP socket has a retransmit, delayed ACK, FIN or
+   TIME_WAIT timeout pending, and is set to expire at the earliest of them instead of waking the
+   IP thread every fast period. Deadlines falling in the same fast period share one expiry.
+   Requires NX_DISABLE_IPV6. By default this option is not defined.  */
+/*
+#define NX_TCP_FAST_TIMER_ON_DEMAND
+*/
+
 /* This define specifies how the number of system ticks (NX_IP_PERIODIC_RATE) is divided to calculate the
    timer rate for the TCP transmit retry processing. The default value is 1, which represents 1 second.  */
 /*
@@ -468,6 +476,21 @@
 #define NX_ENABLE_TCP_WINDOW_SCALING
 */
 
+/* Defined, this option enables TCP selective acknowledgment (RFC 2018). The receiver reports the
+   out of order data it holds, and during fast recovery the sender retransmits the holes only
+   (RFC 6675). With fewer than four segments in flight, early retransmit (RFC 5827) lowers the
+   duplicate ACK threshold. Default disabled. */
+/*
+#define NX_ENABLE_TCP_SACK
+*/
+
+/* This define specifies the number of SACK blocks reported in one ACK, at most 4. The number of
+   blocks remembered from the peer is NX_TCP_SACK_SCOREBOARD_SIZE. The defaults are 3 and 4.  */
+/*
+#define NX_TCP_SACK_MAX_BLOCKS          3
+#define NX_TCP_SACK_SCOREBOARD_SIZE     4
+*/
+
 /* Defined, this option disables the reset processing during disconnect when the timeout value is
    specified as NX_NO_WAIT.  */
 /*
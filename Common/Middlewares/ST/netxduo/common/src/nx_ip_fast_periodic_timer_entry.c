@@ -141,11 +141,20 @@ ULONG _nx_ip_fast_timer_rate;
 
     _nx_ip_fast_timer_rate =  (NX_IP_PERIODIC_RATE + (NX_IP_FAST_TIMER_RATE - 1)) / NX_IP_FAST_TIMER_RATE;
 
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+    /* Create the fast TCP timer stopped, the first TCP timeout started sets it.  */
+    /*lint -e{923} suppress cast of pointer to ULONG.  */
+    tx_timer_create(&(ip_ptr -> nx_ip_fast_periodic_timer), ip_ptr -> nx_ip_name,
+                    _nx_ip_fast_periodic_timer_entry, (ULONG)(ALIGN_TYPE)ip_ptr,
+                    _nx_ip_fast_timer_rate, 0, TX_NO_ACTIVATE);
+    ip_ptr -> nx_ip_tcp_fast_timer_active =  NX_FALSE;
+#else
     /* Create the fast TCP timer.  */
     /*lint -e{923} suppress cast of pointer to ULONG.  */
     tx_timer_create(&(ip_ptr -> nx_ip_fast_periodic_timer), ip_ptr -> nx_ip_name,
                     _nx_ip_fast_periodic_timer_entry, (ULONG)(ALIGN_TYPE)ip_ptr,
                     _nx_ip_fast_timer_rate, _nx_ip_fast_timer_rate, TX_AUTO_ACTIVATE);
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
     NX_TIMER_EXTENSION_PTR_SET(&(ip_ptr -> nx_ip_fast_periodic_timer), ip_ptr)
 
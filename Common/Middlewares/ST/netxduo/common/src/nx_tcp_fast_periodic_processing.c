@@ -66,6 +66,7 @@
 /*    _nx_tcp_socket_connection_reset       Reset connection on timeout   */
 /*    _nx_tcp_socket_block_cleanup          Cleanup the socket block      */
 /*    _nx_tcp_socket_retransmit             Retransmit packet             */
+/*    _nx_tcp_fast_timer_schedule           Set the fast timer expiry     */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -86,10 +87,29 @@ VOID  _nx_tcp_fast_periodic_processing(NX_IP *ip_ptr)
 NX_TCP_SOCKET *socket_ptr;
 ULONG          sockets;
 ULONG          timer_rate;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+ULONG          current_time;
+ULONG          next_timeout;
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
 
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+
+    /* The fast timer is a one-shot timer set to the earliest pending timeout, charge
+       all the time elapsed since the last processing.  */
+    current_time =  tx_time_get();
+    timer_rate =  current_time - ip_ptr -> nx_ip_tcp_fast_timer_base;
+    ip_ptr -> nx_ip_tcp_fast_timer_base =  current_time;
+
+    /* Stop the timer, it is set again below if a timeout is still pending.  */
+    tx_timer_deactivate(&(ip_ptr -> nx_ip_fast_periodic_timer));
+    ip_ptr -> nx_ip_tcp_fast_timer_active =  NX_FALSE;
+    next_timeout =  0xFFFFFFFF;
+#else
+
     /* Pickup this timer's periodic rate.  */
     timer_rate =  _nx_tcp_fast_timer_rate;
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
     /* Pickup the number of created TCP sockets.  */
     sockets =  ip_ptr -> nx_ip_tcp_created_sockets_count;
@@ -122,6 +142,14 @@ ULONG          timer_rate;
                 socket_ptr -> nx_tcp_socket_delayed_ack_timeout -= timer_rate;
             }
         }
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+        else
+        {
+
+            /* No ACK is owed, the next one owed starts a new delayed ACK timeout.  */
+            socket_ptr -> nx_tcp_socket_delayed_ack_armed =  NX_FALSE;
+        }
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
         /* Determine if a timeout is active.  */
         if (socket_ptr -> nx_tcp_socket_timeout)
@@ -173,6 +201,12 @@ ULONG          timer_rate;
                 /* Update the transmit sequence that entered fast transmit. */
                 socket_ptr -> nx_tcp_socket_tx_sequence_recover = socket_ptr -> nx_tcp_socket_tx_sequence - 1;
 
+#ifdef NX_ENABLE_TCP_SACK
+                /* The peer may have discarded the data it selectively acknowledged, RFC 2018
+                   section 8.  Start over from the cumulative ACK.  */
+                socket_ptr -> nx_tcp_socket_sack_count = 0;
+#endif /* NX_ENABLE_TCP_SACK */
+
                 /* Retransmit the packet. */
                 _nx_tcp_socket_retransmit(ip_ptr, socket_ptr, NX_FALSE);
 
@@ -206,8 +240,38 @@ ULONG          timer_rate;
             }
         }
 
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+
+        /* Keep the earliest timeout still pending on this socket.  */
+        if ((socket_ptr -> nx_tcp_socket_state >= NX_TCP_ESTABLISHED) &&
+            ((socket_ptr -> nx_tcp_socket_rx_sequence != socket_ptr -> nx_tcp_socket_rx_sequence_acked) ||
+             (socket_ptr -> nx_tcp_socket_rx_window_last_sent < socket_ptr -> nx_tcp_socket_rx_window_current)))
+        {
+
+            socket_ptr -> nx_tcp_socket_delayed_ack_armed =  NX_TRUE;
+            if (socket_ptr -> nx_tcp_socket_delayed_ack_timeout < next_timeout)
+            {
+                next_timeout =  socket_ptr -> nx_tcp_socket_delayed_ack_timeout;
+            }
+        }
+
+        if ((socket_ptr -> nx_tcp_socket_timeout) && (socket_ptr -> nx_tcp_socket_timeout < next_timeout))
+        {
+            next_timeout =  socket_ptr -> nx_tcp_socket_timeout;
+        }
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
+
         /* Move to the next TCP socket.  */
         socket_ptr =  socket_ptr -> nx_tcp_socket_created_next;
     }
+
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+
+    /* Wake up again for the earliest pending timeout, if any.  */
+    if (next_timeout != 0xFFFFFFFF)
+    {
+        _nx_tcp_fast_timer_schedule(ip_ptr, current_time + next_timeout);
+    }
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 }
 
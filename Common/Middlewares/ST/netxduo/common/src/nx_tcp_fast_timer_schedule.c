@@ -0,0 +1,111 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_ip.h"
+#include "nx_tcp.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_fast_timer_schedule                         PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function makes sure the on demand fast timer expires no later  */
+/*    than the specified deadline.  The deadline is rounded up to the     */
+/*    next multiple of the fast timer period, so that the TCP timeouts    */
+/*    falling in the same period are all processed on one wakeup of the   */
+/*    IP helper thread.  An active timer set to expire by then is left    */
+/*    alone.                                                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ip_ptr                                Pointer to IP control block   */
+/*    deadline                              Time the earliest TCP timeout */
+/*                                            expires, in timer ticks     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_time_get                           Get current time              */
+/*    tx_timer_deactivate                   Deactivate the fast timer     */
+/*    tx_timer_change                       Change the fast timer expiry  */
+/*    tx_timer_activate                     Activate the fast timer       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_fast_periodic_processing      Fast periodic processing      */
+/*    _nx_tcp_socket_fast_timer_arm         Arm a socket timeout          */
+/*                                                                        */
+/**************************************************************************/
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+VOID  _nx_tcp_fast_timer_schedule(NX_IP *ip_ptr, ULONG deadline)
+{
+
+ULONG current_time;
+ULONG period;
+ULONG ticks;
+
+
+    /* Pickup the fast timer period, see _nx_ip_fast_periodic_timer_create.  */
+    period =  (NX_IP_PERIODIC_RATE + (NX_IP_FAST_TIMER_RATE - 1)) / NX_IP_FAST_TIMER_RATE;
+
+    /* Round the deadline up to the fast timer period.  */
+    deadline =  deadline + (period - 1);
+    deadline =  deadline - (deadline % period);
+
+    /* Determine if the timer already expires by the deadline.  */
+    if ((ip_ptr -> nx_ip_tcp_fast_timer_active) &&
+        ((LONG)(deadline - ip_ptr -> nx_ip_tcp_fast_timer_expiry) >= 0))
+    {
+        return;
+    }
+
+    /* Compute the ticks left, a deadline already passed expires on the next tick.  */
+    current_time =  tx_time_get();
+    ticks =  deadline - current_time;
+    if ((LONG)ticks <= 0)
+    {
+        ticks =  1;
+    }
+
+    /* Reprogram the fast timer as a one-shot timer.  */
+    tx_timer_deactivate(&(ip_ptr -> nx_ip_fast_periodic_timer));
+    tx_timer_change(&(ip_ptr -> nx_ip_fast_periodic_timer), ticks, 0);
+    tx_timer_activate(&(ip_ptr -> nx_ip_fast_periodic_timer));
+
+    ip_ptr -> nx_ip_tcp_fast_timer_expiry =  current_time + ticks;
+    ip_ptr -> nx_ip_tcp_fast_timer_active =  NX_TRUE;
+}
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
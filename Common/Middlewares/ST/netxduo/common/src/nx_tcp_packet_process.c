@@ -73,6 +73,7 @@
 /*    _nx_packet_release                    Packet release function       */
 /*    _nx_ip_checksum_compute               Calculate TCP packet checksum */
 /*    _nx_tcp_mss_option_get                Get peer MSS option           */
+/*    _nx_tcp_sack_option_get               Get peer SACK option          */
 /*    _nx_tcp_no_connection_reset           Reset on no connection        */
 /*    _nx_tcp_packet_send_syn               Send SYN message              */
 /*    _nx_tcp_socket_packet_process         Socket specific packet        */
@@ -124,6 +125,9 @@ UINT                         status;
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
 ULONG                        rwin_scale = 0xFF;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
+#ifdef NX_ENABLE_TCP_SACK
+UINT                         sack_permitted = NX_FALSE;
+#endif /* NX_ENABLE_TCP_SACK */
 
 #ifdef NX_DISABLE_TCP_RX_CHECKSUM
     compute_checksum = 0;
@@ -295,6 +299,15 @@ ULONG                        rwin_scale = 0xFF;
             is_valid_option_flag = NX_FALSE;
         }
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
+
+#ifdef NX_ENABLE_TCP_SACK
+        /* Determine if the peer offers selective acknowledgment.  */
+        if (_nx_tcp_sack_option_get((packet_ptr -> nx_packet_prepend_ptr + sizeof(NX_TCP_HEADER)),
+                                    option_words * (ULONG)sizeof(ULONG), NX_TCP_SACK_PERMITTED_KIND))
+        {
+            sack_permitted = NX_TRUE;
+        }
+#endif /* NX_ENABLE_TCP_SACK */
     }
 
     /* Pickup the destination TCP port.  */
@@ -393,6 +406,14 @@ ULONG                        rwin_scale = 0xFF;
                          */
                         socket_ptr -> nx_tcp_snd_win_scale_value = rwin_scale;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
+
+#ifdef NX_ENABLE_TCP_SACK
+                        /* Use selective acknowledgment only if the peer accepts our offer.  */
+                        if (socket_ptr -> nx_tcp_socket_state == NX_TCP_SYN_SENT)
+                        {
+                            socket_ptr -> nx_tcp_socket_sack_permitted = sack_permitted;
+                        }
+#endif /* NX_ENABLE_TCP_SACK */
                     }
 
                     /* Process the packet within an existing TCP connection.  */
@@ -686,6 +707,11 @@ ULONG                        rwin_scale = 0xFF;
                     socket_ptr -> nx_tcp_snd_win_scale_value = rwin_scale;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
 
+#ifdef NX_ENABLE_TCP_SACK
+                    /* Answer the SYN with SACK permitted if the peer offered it.  */
+                    socket_ptr -> nx_tcp_socket_sack_permitted = sack_permitted;
+#endif /* NX_ENABLE_TCP_SACK */
+
                     /* Set the initial slow start threshold to be the advertised window size. */
                     socket_ptr -> nx_tcp_socket_tx_slow_start_threshold = socket_ptr -> nx_tcp_socket_tx_window_advertised;
 
@@ -752,6 +778,9 @@ ULONG                        rwin_scale = 0xFF;
                         /* Setup a timeout so the connection attempt can be sent again.  */
                         socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
                         socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+                        _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
                         /* Send the SYN+ACK message.  */
                         _nx_tcp_packet_send_syn(socket_ptr, (socket_ptr -> nx_tcp_socket_tx_sequence - 1));
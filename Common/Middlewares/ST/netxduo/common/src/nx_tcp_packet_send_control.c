@@ -69,6 +69,7 @@
 /*    _nx_ip_checksum_compute               Calculate TCP checksum        */
 /*    _nx_ip_packet_send                    Send IPv4 packet              */
 /*    _nx_ipv6_packet_send                  Send IPv6 packet              */
+/*    _nx_tcp_sack_option_build             Build SACK option             */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -102,6 +103,9 @@ UINT           compute_checksum = 1;
 #endif /* defined(NX_DISABLE_TCP_TX_CHECKSUM) || defined(NX_ENABLE_INTERFACE_CAPABILITY) || defined(NX_IPSEC_ENABLE) */
 ULONG          header_size;
 ULONG          window_size;
+#ifdef NX_ENABLE_TCP_SACK
+ULONG          sack_size = 0;
+#endif /* NX_ENABLE_TCP_SACK */
 
 #ifdef NX_DISABLE_TCP_TX_CHECKSUM
     compute_checksum = 0;
@@ -206,6 +210,43 @@ ULONG          window_size;
     /* Setup the packet length.  */
     packet_ptr -> nx_packet_length =  sizeof(NX_TCP_HEADER);
 
+#ifdef NX_ENABLE_TCP_SACK
+    if (socket_ptr -> nx_tcp_socket_sack_permitted)
+    {
+        if (control_bits & NX_TCP_SYN_BIT)
+        {
+
+            /* Offer selective acknowledgment after the MSS and window scale options.  */
+            if (option_word_2 == NX_TCP_OPTION_END)
+            {
+
+                /* No window scale option, use its padding word.  */
+                option_word_2 =  NX_TCP_SACK_PERMITTED_OPTION;
+            }
+            else
+            {
+                sack_size =  sizeof(ULONG);
+                header_size += ((ULONG)1 << NX_TCP_HEADER_SHIFT);
+            }
+        }
+        else if ((control_bits == NX_TCP_ACK_BIT) && (data == NX_NULL))
+        {
+
+            /* Report the out of order data received on a pure ACK.  */
+            sack_size =  (ULONG)(packet_ptr -> nx_packet_data_end - packet_ptr -> nx_packet_append_ptr);
+            if (sack_size > 40)
+            {
+                sack_size =  40;
+            }
+            sack_size =  _nx_tcp_sack_option_build(socket_ptr, packet_ptr -> nx_packet_append_ptr, sack_size);
+
+            header_size += ((sack_size / sizeof(ULONG)) << NX_TCP_HEADER_SHIFT);
+            packet_ptr -> nx_packet_append_ptr += sack_size;
+            packet_ptr -> nx_packet_length += sack_size;
+        }
+    }
+#endif /* NX_ENABLE_TCP_SACK */
+
     /* Pickup the pointer to the head of the TCP packet.  */
     /*lint -e{927} -e{826} suppress cast of pointer to pointer, since it is necessary  */
     tcp_header_ptr =  (NX_TCP_HEADER *)packet_ptr -> nx_packet_prepend_ptr;
@@ -255,6 +296,19 @@ ULONG          window_size;
         /* Adjust packet information. */
         packet_ptr -> nx_packet_append_ptr += (sizeof(ULONG) << 1);
         packet_ptr -> nx_packet_length += (ULONG)(sizeof(ULONG) << 1);
+
+#ifdef NX_ENABLE_TCP_SACK
+        if (sack_size)
+        {
+
+            /* Add the SACK permitted option, counted in the header size above.  */
+            option_word_1 =  NX_TCP_SACK_PERMITTED_OPTION;
+            NX_CHANGE_ULONG_ENDIAN(option_word_1);
+            *((ULONG *)packet_ptr -> nx_packet_append_ptr) = option_word_1;
+            packet_ptr -> nx_packet_append_ptr += sizeof(ULONG);
+            packet_ptr -> nx_packet_length += (ULONG)sizeof(ULONG);
+        }
+#endif /* NX_ENABLE_TCP_SACK */
     }
 
 #ifdef NX_ENABLE_INTERFACE_CAPABILITY
@@ -79,5 +79,8 @@ VOID  _nx_tcp_packet_send_probe(NX_TCP_SOCKET *socket_ptr, ULONG tx_sequence, UC
 
     /* Setup a new delayed ACK timeout.  */
     socket_ptr -> nx_tcp_socket_delayed_ack_timeout =  _nx_tcp_ack_timer_rate;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+    socket_ptr -> nx_tcp_socket_delayed_ack_armed =  NX_FALSE;
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 }
 
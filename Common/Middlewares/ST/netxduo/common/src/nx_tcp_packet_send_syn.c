@@ -318,6 +318,19 @@ ULONG        mss = 0;
     }
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
 
+#ifdef NX_ENABLE_TCP_SACK
+    /* Offer selective acknowledgment if we initiate the SYN.  On a SYN+ACK it is
+       only included when the peer offered it, see _nx_tcp_packet_process.  */
+    if (socket_ptr -> nx_tcp_socket_state == NX_TCP_SYN_SENT)
+    {
+        socket_ptr -> nx_tcp_socket_sack_permitted =  NX_TRUE;
+    }
+
+    /* Forget the scoreboard and the blocks reported on a previous connection.  */
+    socket_ptr -> nx_tcp_socket_sack_count =  0;
+    socket_ptr -> nx_tcp_socket_sack_reported_count =  0;
+#endif /* NX_ENABLE_TCP_SACK */
+
     /* Send SYN or SYN+ACK packet according to socket state. */
     if (socket_ptr -> nx_tcp_socket_state == NX_TCP_SYN_SENT)
     {
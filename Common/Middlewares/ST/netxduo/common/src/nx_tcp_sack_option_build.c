@@ -0,0 +1,314 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+#include "nx_ip.h"
+#include "nx_tcp.h"
+#ifdef FEATURE_NX_IPV6
+#include "nx_ipv6.h"
+#endif /* FEATURE_NX_IPV6 */
+
+
+#ifdef NX_ENABLE_TCP_SACK
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_sack_block_add                              PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function ranks a block of out of order data and inserts it in  */
+/*    the blocks to report, sorted by rank.  The block holding the last   */
+/*    segment received ranks first, then the blocks overlapping those of  */
+/*    the last option sent, in their order, then the others by sequence.  */
+/*    Once max_blocks are kept, a block ranking after all of them is      */
+/*    dropped, otherwise it pushes out the last one.                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to owning socket      */
+/*    blocks                                Blocks to report              */
+/*    ranks                                 Rank of each block            */
+/*    count_ptr                             Number of blocks kept         */
+/*    max_blocks                            Blocks that fit the option    */
+/*    block_start                           First sequence of the block   */
+/*    block_end                             Sequence after the block      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_sack_option_build             Build SACK option             */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _nx_tcp_sack_block_add(NX_TCP_SOCKET *socket_ptr, NX_TCP_SACK_BLOCK *blocks, UINT *ranks,
+                                    UINT *count_ptr, UINT max_blocks, ULONG block_start, ULONG block_end)
+{
+
+NX_TCP_SACK_BLOCK *reported;
+UINT               rank;
+UINT               i;
+
+
+    /* The block holding the segment just received.  */
+    if (((INT)(socket_ptr -> nx_tcp_socket_sack_received_sequence - block_start) >= 0) &&
+        ((INT)(socket_ptr -> nx_tcp_socket_sack_received_sequence - block_end) < 0))
+    {
+        rank =  0;
+    }
+    else
+    {
+
+        /* A block reported last time, it may have grown or been merged since.  */
+        rank =  NX_TCP_SACK_MAX_BLOCKS + 1;
+        reported =  socket_ptr -> nx_tcp_socket_sack_reported;
+        for (i = 0; i < socket_ptr -> nx_tcp_socket_sack_reported_count; i++)
+        {
+            if (((INT)(reported[i].nx_tcp_sack_block_start - block_end) < 0) &&
+                ((INT)(block_start - reported[i].nx_tcp_sack_block_end) < 0))
+            {
+                rank =  i + 1;
+                break;
+            }
+        }
+    }
+
+    /* Find the place of the block, after those of the same rank.  */
+    i =  *count_ptr;
+    while ((i > 0) && (ranks[i - 1] > rank))
+    {
+        i--;
+    }
+    if (i == max_blocks)
+    {
+        return;
+    }
+
+    if (*count_ptr < max_blocks)
+    {
+        (*count_ptr)++;
+    }
+
+    /* Move the blocks ranking after it, the last one falls off when full.  */
+    memmove(&blocks[i + 1], &blocks[i], (*count_ptr - 1 - i) * sizeof(NX_TCP_SACK_BLOCK)); /* Use case of memmove is verified.  */
+    memmove(&ranks[i + 1], &ranks[i], (*count_ptr - 1 - i) * sizeof(UINT)); /* Use case of memmove is verified.  */
+    blocks[i].nx_tcp_sack_block_start =  block_start;
+    blocks[i].nx_tcp_sack_block_end =  block_end;
+    ranks[i] =  rank;
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_sack_option_build                           PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function builds the SACK option of an outgoing ACK from the    */
+/*    out of order data held in the receive queue of the socket.  Each    */
+/*    run of contiguous segments above the receive sequence becomes one   */
+/*    block.  As RFC 2018 section 4 requires, the first block holds the   */
+/*    segment just received, and the blocks of the last option sent come  */
+/*    next so each is repeated in several ACKs.  Any room left goes to    */
+/*    the lowest other blocks, the peer learns about the first holes.     */
+/*    The blocks sent are kept for the next option.  The option is padded */
+/*    with two NOPs to keep the header aligned.                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to owning socket      */
+/*    option_ptr                            Pointer to option area        */
+/*    option_area_size                      Room left in option area      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    ULONG                                 Size of the option built, a   */
+/*                                            multiple of four or zero    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_tcp_sack_block_add                Rank and keep a block         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_packet_send_control           Send TCP control packet       */
+/*                                                                        */
+/**************************************************************************/
+ULONG  _nx_tcp_sack_option_build(NX_TCP_SOCKET *socket_ptr, UCHAR *option_ptr, ULONG option_area_size)
+{
+
+NX_PACKET        *search_ptr;
+NX_TCP_HEADER    *search_header_ptr;
+ULONG             header_length;
+ULONG             search_sequence;
+ULONG             ending_sequence;
+ULONG             block_start =  0;
+ULONG             block_end =  0;
+UINT              block_open =  NX_FALSE;
+UINT              blocks =  0;
+UINT              max_blocks;
+UINT              i;
+UCHAR            *block_ptr;
+NX_TCP_SACK_BLOCK sack_blocks[NX_TCP_SACK_MAX_BLOCKS];
+UINT              ranks[NX_TCP_SACK_MAX_BLOCKS];
+
+
+    /* Determine how many blocks fit after the two NOPs, kind and length.  */
+    if (option_area_size < 12)
+    {
+        return(0);
+    }
+    max_blocks =  (UINT)((option_area_size - 4) >> 3);
+    if (max_blocks > NX_TCP_SACK_MAX_BLOCKS)
+    {
+        max_blocks =  NX_TCP_SACK_MAX_BLOCKS;
+    }
+
+    /* Walk the receive queue, it is sorted by sequence.  */
+    search_ptr =  socket_ptr -> nx_tcp_socket_receive_queue_head;
+    while (search_ptr)
+    {
+
+        /* Setup a pointer to header of this packet in the receive queue.  */
+#ifndef NX_DISABLE_IPV4
+        if (search_ptr -> nx_packet_ip_version == NX_IP_VERSION_V4)
+        {
+
+            /*lint -e{927} -e{826} suppress cast of pointer to pointer, since it is necessary  */
+            search_header_ptr =  (NX_TCP_HEADER *)(search_ptr -> nx_packet_ip_header +
+                                                   sizeof(NX_IPV4_HEADER));
+        }
+        else
+#endif /* NX_DISABLE_IPV4 */
+#ifdef FEATURE_NX_IPV6
+        if (search_ptr -> nx_packet_ip_version == NX_IP_VERSION_V6)
+        {
+
+            /*lint -e{927} -e{826} suppress cast of pointer to pointer, since it is necessary  */
+            search_header_ptr =  (NX_TCP_HEADER *)(search_ptr -> nx_packet_ip_header +
+                                                   sizeof(NX_IPV6_HEADER));
+        }
+        else
+#endif /* FEATURE_NX_IPV6 */
+        {
+            break;
+        }
+
+        /* Compute the sequence range of the segment, the header is in host byte order.  */
+        header_length =  (search_header_ptr -> nx_tcp_header_word_3 >> NX_TCP_HEADER_SHIFT) * (ULONG)sizeof(ULONG);
+        search_sequence =  search_header_ptr -> nx_tcp_sequence_number;
+        ending_sequence =  search_sequence +
+                           (search_ptr -> nx_packet_length -
+                            (header_length +
+                             (ULONG)((ALIGN_TYPE)search_header_ptr -
+                                     (ALIGN_TYPE)search_ptr -> nx_packet_prepend_ptr)));
+
+        /* Only data above the receive sequence is out of order.  */
+        if ((INT)(search_sequence - socket_ptr -> nx_tcp_socket_rx_sequence) > 0)
+        {
+
+            /* Extend the current block with contiguous data.  */
+            if ((block_open) && ((INT)(search_sequence - block_end) <= 0))
+            {
+                if ((INT)(ending_sequence - block_end) > 0)
+                {
+                    block_end =  ending_sequence;
+                }
+            }
+            else
+            {
+
+                /* Close the current block.  */
+                if (block_open)
+                {
+                    _nx_tcp_sack_block_add(socket_ptr, sack_blocks, ranks, &blocks, max_blocks, block_start, block_end);
+                }
+
+                block_start =  search_sequence;
+                block_end =  ending_sequence;
+                block_open =  NX_TRUE;
+            }
+        }
+
+        /* Move to the next packet.  */
+        search_ptr =  search_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next;
+
+        /*lint -e{923} suppress cast of ULONG to pointer.  */
+        if (search_ptr == ((NX_PACKET *)NX_PACKET_ENQUEUED))
+        {
+            search_ptr =  NX_NULL;
+        }
+    }
+
+    /* Close the last block.  */
+    if (block_open)
+    {
+        _nx_tcp_sack_block_add(socket_ptr, sack_blocks, ranks, &blocks, max_blocks, block_start, block_end);
+    }
+
+    /* Keep the blocks for the next option, in the order sent.  */
+    memcpy(socket_ptr -> nx_tcp_socket_sack_reported, sack_blocks, blocks * sizeof(NX_TCP_SACK_BLOCK)); /* Use case of memcpy is verified.  */
+    socket_ptr -> nx_tcp_socket_sack_reported_count =  blocks;
+
+    if (blocks == 0)
+    {
+        return(0);
+    }
+
+    /* Fill in the NOPs, kind and length, then the blocks.  */
+    option_ptr[0] =  NX_TCP_NOP_KIND;
+    option_ptr[1] =  NX_TCP_NOP_KIND;
+    option_ptr[2] =  NX_TCP_SACK_KIND;
+    option_ptr[3] =  (UCHAR)(2 + (blocks << 3));
+
+    block_ptr =  option_ptr + 4;
+    for (i = 0; i < blocks; i++)
+    {
+        block_start =  sack_blocks[i].nx_tcp_sack_block_start;
+        block_end =  sack_blocks[i].nx_tcp_sack_block_end;
+        NX_CHANGE_ULONG_ENDIAN(block_start);
+        NX_CHANGE_ULONG_ENDIAN(block_end);
+        memcpy(block_ptr, &block_start, sizeof(ULONG)); /* Use case of memcpy is verified.  */
+        memcpy(block_ptr + 4, &block_end, sizeof(ULONG)); /* Use case of memcpy is verified.  */
+        block_ptr =  block_ptr + 8;
+    }
+
+    return(4 + ((ULONG)blocks << 3));
+}
+#endif /* NX_ENABLE_TCP_SACK */
@@ -0,0 +1,120 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_ip.h"
+#include "nx_tcp.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_sack_option_get                             PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function searches the option area for the specified option     */
+/*    kind, either SACK permitted or SACK.  If found and its length fits  */
+/*    in the option area, a pointer to the option kind is returned.       */
+/*    Otherwise, NX_NULL is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    option_ptr                            Pointer to option area        */
+/*    option_area_size                      Size of option area           */
+/*    option_kind                           Option kind to search for     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    UCHAR *                               Pointer to the option, or     */
+/*                                            NX_NULL if not found        */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_packet_process                TCP packet processing         */
+/*    _nx_tcp_server_socket_relisten        Socket relisten processing    */
+/*    _nx_tcp_socket_sack_process           Process SACK option           */
+/*                                                                        */
+/**************************************************************************/
+#ifdef NX_ENABLE_TCP_SACK
+UCHAR  *_nx_tcp_sack_option_get(UCHAR *option_ptr, ULONG option_area_size, UINT option_kind)
+{
+
+ULONG option_length;
+
+
+    /* Loop through the option area looking for the option.  */
+    while (option_area_size >= 2)
+    {
+
+        /* Check for end of list.  */
+        if (*option_ptr == NX_TCP_EOL_KIND)
+        {
+            break;
+        }
+
+        /* Check for NOP.  */
+        if (*option_ptr == NX_TCP_NOP_KIND)
+        {
+
+            /* One character option!  */
+            option_ptr++;
+            option_area_size--;
+            continue;
+        }
+
+        /* Derive the option length.  */
+        option_length =  (ULONG)option_ptr[1];
+
+        /* Return when option length is invalid.  */
+        if ((option_length < 2) || (option_length > option_area_size))
+        {
+            break;
+        }
+
+        /* Is this the option we are looking for?  */
+        if (*option_ptr == (UCHAR)option_kind)
+        {
+            return(option_ptr);
+        }
+
+        /* Move to the next option.  */
+        option_ptr =  option_ptr + option_length;
+        option_area_size =  option_area_size - option_length;
+    }
+
+    /* Not found.  */
+    return(NX_NULL);
+}
+#endif /* NX_ENABLE_TCP_SACK */
+
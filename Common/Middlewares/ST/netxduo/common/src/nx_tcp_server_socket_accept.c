@@ -152,6 +152,9 @@ NX_IP *ip_ptr;
 
             socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
             socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+            _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
             /* CLEANUP: Clean up any existing socket data before making a new connection. */
             socket_ptr -> nx_tcp_socket_tx_window_congestion = 0;
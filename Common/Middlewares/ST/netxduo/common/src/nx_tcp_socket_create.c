@@ -129,6 +129,9 @@ NX_TCP_SOCKET *tail_ptr;
 
     /* Setup the delayed ACK timeout periodic rate.  */
     socket_ptr -> nx_tcp_socket_delayed_ack_timeout =  _nx_tcp_ack_timer_rate;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+    socket_ptr -> nx_tcp_socket_delayed_ack_armed =  NX_FALSE;
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
     /* Setup the default transmit timeout.  */
     socket_ptr -> nx_tcp_socket_timeout_rate =         _nx_tcp_transmit_timer_rate;
@@ -172,6 +172,9 @@ NX_IP        *ip_ptr;
                 /* Setup FIN timeout.  */
                 socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate;
                 socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+                _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
                 /* Increment the sequence number.  */
                 socket_ptr -> nx_tcp_socket_tx_sequence++;
@@ -196,6 +199,9 @@ NX_IP        *ip_ptr;
                 /* Setup FIN timeout.  */
                 socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate;
                 socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+                _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
                 /* Increment the sequence number.  */
                 socket_ptr -> nx_tcp_socket_tx_sequence++;
@@ -264,6 +270,9 @@ NX_IP        *ip_ptr;
             /* No transmit packets queue, setup FIN timeout.  */
             socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
             socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+            _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
         }
 
         /* Increment the sequence number.  */
@@ -297,6 +306,9 @@ NX_IP        *ip_ptr;
             /* No transmit packets queue, setup FIN timeout.  */
             socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
             socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+            _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
         }
 
         /* Increment the sequence number.  */
@@ -0,0 +1,102 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_ip.h"
+#include "nx_tcp.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_fast_timer_arm                       PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function registers a TCP timeout just started on the socket,   */
+/*    either its retransmit timeout or its delayed ACK timeout, with the  */
+/*    on demand fast timer.  The timeout is given relative to the current */
+/*    time.  While the fast timer is running, it is converted to count    */
+/*    from the time of the last fast periodic processing like the other   */
+/*    pending timeouts.  Otherwise the current time becomes that base.    */
+/*    The fast timer is then set to expire no later than the timeout.     */
+/*                                                                        */
+/*    The caller holds the IP protection mutex or runs on the IP helper   */
+/*    thread.                                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to owning socket      */
+/*    timeout_ptr                           Pointer to the timeout just   */
+/*                                            started                     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_time_get                           Get current time              */
+/*    _nx_tcp_fast_timer_schedule           Set the fast timer expiry     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    NetX Duo TCP source code                                            */
+/*                                                                        */
+/**************************************************************************/
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+VOID  _nx_tcp_socket_fast_timer_arm(NX_TCP_SOCKET *socket_ptr, ULONG *timeout_ptr)
+{
+
+NX_IP *ip_ptr;
+ULONG  current_time;
+
+
+    /* Setup the IP pointer.  */
+    ip_ptr =  socket_ptr -> nx_tcp_socket_ip_ptr;
+
+    current_time =  tx_time_get();
+
+    if (ip_ptr -> nx_ip_tcp_fast_timer_active)
+    {
+
+        /* Count the time elapsed since the last processing, it is charged to every
+           pending timeout on the next one.  */
+        *timeout_ptr +=  current_time - ip_ptr -> nx_ip_tcp_fast_timer_base;
+    }
+    else
+    {
+
+        /* No other timeout is pending, start counting from now.  */
+        ip_ptr -> nx_ip_tcp_fast_timer_base =  current_time;
+    }
+
+    _nx_tcp_fast_timer_schedule(ip_ptr, ip_ptr -> nx_ip_tcp_fast_timer_base + *timeout_ptr);
+}
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
@@ -60,6 +60,7 @@
 /*    _nx_packet_release                    Packet release function       */
 /*    _nx_tcp_socket_connection_reset       Reset connection              */
 /*    _nx_tcp_socket_state_ack_check        Process received ACKs         */
+/*    _nx_tcp_socket_sack_process           Process received SACK blocks  */
 /*    _nx_tcp_socket_state_closing          Process CLOSING state         */
 /*    _nx_tcp_socket_state_data_check       Process received data         */
 /*    _nx_tcp_socket_state_established      Process ESTABLISHED state     */
@@ -277,6 +278,19 @@ ULONG         tcpip_offload;
         if (socket_ptr -> nx_tcp_socket_state != NX_TCP_SYN_RECEIVED)
         {
 
+#ifdef NX_ENABLE_TCP_SACK
+            /* Record the data the peer selectively acknowledged before the ACK is processed,
+               the header copy does not carry the options.  */
+            if ((socket_ptr -> nx_tcp_socket_sack_permitted) &&
+                (tcp_header_copy.nx_tcp_header_word_3 & NX_TCP_ACK_BIT) &&
+                (header_length > sizeof(NX_TCP_HEADER)))
+            {
+                _nx_tcp_socket_sack_process(socket_ptr, packet_ptr -> nx_packet_prepend_ptr + sizeof(NX_TCP_HEADER),
+                                            header_length - (ULONG)sizeof(NX_TCP_HEADER),
+                                            tcp_header_copy.nx_tcp_acknowledgment_number);
+            }
+#endif /* NX_ENABLE_TCP_SACK */
+
             /* Check the ACK field.  */
             if (_nx_tcp_socket_state_ack_check(socket_ptr, &tcp_header_copy) == NX_FALSE)
             {
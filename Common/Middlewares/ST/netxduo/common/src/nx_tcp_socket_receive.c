@@ -224,6 +224,18 @@ ULONG                  trace_timestamp;
             /* Send a Window Update.  */
             _nx_tcp_packet_send_ack(socket_ptr, socket_ptr -> nx_tcp_socket_tx_sequence);
         }
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+
+        /* Start the delayed ACK timeout if an ACK is now owed.  */
+        if ((socket_ptr -> nx_tcp_socket_delayed_ack_armed == NX_FALSE) &&
+            (socket_ptr -> nx_tcp_socket_state >= NX_TCP_ESTABLISHED) &&
+            ((socket_ptr -> nx_tcp_socket_rx_sequence != socket_ptr -> nx_tcp_socket_rx_sequence_acked) ||
+             (socket_ptr -> nx_tcp_socket_rx_window_last_sent < socket_ptr -> nx_tcp_socket_rx_window_current)))
+        {
+            socket_ptr -> nx_tcp_socket_delayed_ack_armed =  NX_TRUE;
+            _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_delayed_ack_timeout));
+        }
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
 #ifdef TX_ENABLE_EVENT_TRACE
         /* Update the trace event with the status.  */
@@ -54,7 +54,9 @@
 /*                                                                        */
 /*    ip_ptr                                IP instance pointer           */
 /*    socket_ptr                            Pointer to owning socket      */
-/*    need_fast_retransmit                  Need fast retransmit or not   */
+/*    need_fast_retransmit                  Need fast retransmit or not,  */
+/*                                            or NX_TCP_SACK_RETRANSMIT   */
+/*                                            to repair the next hole     */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -90,6 +92,24 @@ ULONG      original_header_word_3;
 ULONG      original_header_word_4;
 ULONG      available;
 ULONG      window_size;
+#ifdef NX_ENABLE_TCP_SACK
+NX_TCP_HEADER     *sack_header_ptr;
+NX_TCP_SACK_BLOCK *sack_block_ptr;
+ULONG              sack_sequence;
+ULONG              sack_end = 0;
+ULONG              sack_high;
+ULONG              temp;
+UINT               sack_hole = NX_FALSE;
+UINT               i;
+
+    /* A SACK driven retransmission repairs a hole during fast recovery, it is not a timeout.  */
+    if ((need_fast_retransmit == NX_TCP_SACK_RETRANSMIT) &&
+        ((socket_ptr -> nx_tcp_socket_fast_recovery == NX_FALSE) ||
+         (socket_ptr -> nx_tcp_socket_tx_window_advertised == 0)))
+    {
+        return;
+    }
+#endif /* NX_ENABLE_TCP_SACK */
 
     /* If the receiver winodw is zero, we enter the zero window probe phase
        RFC 793 Sec 3.7, p42: keep send new data.
@@ -140,6 +160,9 @@ ULONG      window_size;
         /* Setup the next timeout.  */
         socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate <<
             (socket_ptr -> nx_tcp_socket_timeout_retries * socket_ptr -> nx_tcp_socket_timeout_shift);
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+        _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
         /* Send the zero window probe.  */
         _nx_tcp_packet_send_probe(socket_ptr, socket_ptr -> nx_tcp_socket_zero_window_probe_sequence,
@@ -156,7 +179,12 @@ ULONG      window_size;
 
     /* Increment the retry counter only if the receiver window is open. */
     /* Increment the retry counter.  */
-    socket_ptr -> nx_tcp_socket_timeout_retries++;
+#ifdef NX_ENABLE_TCP_SACK
+    if (need_fast_retransmit != NX_TCP_SACK_RETRANSMIT)
+#endif /* NX_ENABLE_TCP_SACK */
+    {
+        socket_ptr -> nx_tcp_socket_timeout_retries++;
+    }
 
     if ((need_fast_retransmit == NX_TRUE) || (socket_ptr -> nx_tcp_socket_fast_recovery == NX_FALSE))
     {
@@ -189,12 +217,27 @@ ULONG      window_size;
 
             /* Update the transmit sequence that enters fast transmit. */
             socket_ptr -> nx_tcp_socket_tx_sequence_recover = socket_ptr -> nx_tcp_socket_tx_sequence - 1;
+
+#ifdef NX_ENABLE_TCP_SACK
+            /* Nothing is retransmitted yet in this recovery.  */
+            socket_ptr -> nx_tcp_socket_sack_high_rxt = socket_ptr -> nx_tcp_socket_tx_sequence -
+                socket_ptr -> nx_tcp_socket_tx_outstanding_bytes;
+#endif /* NX_ENABLE_TCP_SACK */
         }
     }
 
-    /* Setup the next timeout.  */
-    socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate <<
-        (socket_ptr -> nx_tcp_socket_timeout_retries * socket_ptr -> nx_tcp_socket_timeout_shift);
+#ifdef NX_ENABLE_TCP_SACK
+    if (need_fast_retransmit != NX_TCP_SACK_RETRANSMIT)
+#endif /* NX_ENABLE_TCP_SACK */
+    {
+
+        /* Setup the next timeout.  */
+        socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate <<
+            (socket_ptr -> nx_tcp_socket_timeout_retries * socket_ptr -> nx_tcp_socket_timeout_shift);
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+        _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
+    }
 
     /* Get available size of packet that can be sent. */
     available = socket_ptr -> nx_tcp_socket_tx_window_congestion;
@@ -202,6 +245,73 @@ ULONG      window_size;
     /* Pickup the head of the transmit queue.  */
     packet_ptr =  socket_ptr -> nx_tcp_socket_transmit_sent_head;
 
+#ifdef NX_ENABLE_TCP_SACK
+    /* During fast recovery, retransmit the first segment that is neither retransmitted yet
+       nor selectively acknowledged, below the highest data the peer reported, RFC 6675.  */
+    if ((socket_ptr -> nx_tcp_socket_fast_recovery == NX_TRUE) && (socket_ptr -> nx_tcp_socket_sack_count))
+    {
+
+        sack_high = socket_ptr -> nx_tcp_socket_sack_scoreboard[socket_ptr -> nx_tcp_socket_sack_count - 1].nx_tcp_sack_block_end;
+
+        /*lint -e{923} suppress cast of ULONG to pointer.  */
+        while (packet_ptr && (packet_ptr -> nx_packet_queue_next == (NX_PACKET *)NX_DRIVER_TX_DONE))
+        {
+
+            /* Compute the sequence range of the segment, the header is in network byte order.  */
+            /*lint -e{927} -e{826} suppress cast of pointer to pointer, since it is necessary  */
+            sack_header_ptr = (NX_TCP_HEADER *)packet_ptr -> nx_packet_prepend_ptr;
+            sack_sequence = sack_header_ptr -> nx_tcp_sequence_number;
+            NX_CHANGE_ULONG_ENDIAN(sack_sequence);
+            temp = sack_header_ptr -> nx_tcp_header_word_3;
+            NX_CHANGE_ULONG_ENDIAN(temp);
+            sack_end = sack_sequence + packet_ptr -> nx_packet_length -
+                ((temp >> NX_TCP_HEADER_SHIFT) * (ULONG)sizeof(ULONG));
+
+            /* No hole is left below the highest SACKed data.  */
+            if ((INT)(sack_sequence - sack_high) >= 0)
+            {
+                break;
+            }
+
+            /* Is the segment beyond the last retransmission and not SACKed?  */
+            if ((INT)(sack_end - socket_ptr -> nx_tcp_socket_sack_high_rxt) > 0)
+            {
+                sack_hole = NX_TRUE;
+                sack_block_ptr = socket_ptr -> nx_tcp_socket_sack_scoreboard;
+                for (i = 0; i < socket_ptr -> nx_tcp_socket_sack_count; i++, sack_block_ptr++)
+                {
+                    if (((INT)(sack_sequence - sack_block_ptr -> nx_tcp_sack_block_start) >= 0) &&
+                        ((INT)(sack_end - sack_block_ptr -> nx_tcp_sack_block_end) <= 0))
+                    {
+                        sack_hole = NX_FALSE;
+                        break;
+                    }
+                }
+
+                if (sack_hole)
+                {
+                    break;
+                }
+            }
+
+            packet_ptr = packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next;
+
+            /*lint -e{923} suppress cast of ULONG to pointer.  */
+            if (packet_ptr == (NX_PACKET *)NX_PACKET_ENQUEUED)
+            {
+                packet_ptr = NX_NULL;
+            }
+        }
+
+        if (sack_hole == NX_FALSE)
+        {
+
+            /* Every hole has been retransmitted once, wait for the ACKs.  */
+            return;
+        }
+    }
+#endif /* NX_ENABLE_TCP_SACK */
+
     /* Determine if the packet has been released by the
        application I/O driver.  */
     /*lint -e{923} suppress cast of ULONG to pointer.  */
@@ -405,6 +515,15 @@ ULONG      window_size;
         }
 #endif /* FEATURE_NX_IPV6 */
 
+#ifdef NX_ENABLE_TCP_SACK
+        if (sack_hole)
+        {
+
+            /* Record the retransmission of the hole.  */
+            socket_ptr -> nx_tcp_socket_sack_high_rxt = sack_end;
+        }
+#endif /* NX_ENABLE_TCP_SACK */
+
         /* Move to next packet. */
         /* During fast recovery, only one packet is retransmitted at once. */
         /* After a timeout, the sending data can be at most one SMSS. */
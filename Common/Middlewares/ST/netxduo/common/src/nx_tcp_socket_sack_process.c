@@ -0,0 +1,189 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_ip.h"
+#include "nx_tcp.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_sack_process                         PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function updates the SACK scoreboard of the socket from an     */
+/*    incoming ACK.  Blocks now covered by the cumulative ACK are removed */
+/*    first, then each SACK block of the segment that lies between the    */
+/*    cumulative ACK and the transmit sequence is merged in.  When the    */
+/*    scoreboard is full, the block with the highest sequence is dropped, */
+/*    which only makes the retransmission more conservative.              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to owning socket      */
+/*    option_ptr                            Pointer to option area        */
+/*    option_area_size                      Size of option area           */
+/*    ack_number                            Cumulative ACK of the segment */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_tcp_sack_option_get               Find the SACK option          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_socket_packet_process         Process socket's TCP packet   */
+/*                                                                        */
+/**************************************************************************/
+#ifdef NX_ENABLE_TCP_SACK
+VOID  _nx_tcp_socket_sack_process(NX_TCP_SOCKET *socket_ptr, UCHAR *option_ptr, ULONG option_area_size, ULONG ack_number)
+{
+
+NX_TCP_SACK_BLOCK *scoreboard;
+UINT               count;
+UINT               i;
+UINT               j;
+UINT               blocks;
+ULONG              block_start;
+ULONG              block_end;
+
+
+    /* Setup the scoreboard pointer.  */
+    scoreboard =  socket_ptr -> nx_tcp_socket_sack_scoreboard;
+    count =  socket_ptr -> nx_tcp_socket_sack_count;
+
+    /* Remove the data now covered by the cumulative ACK.  */
+    i =  0;
+    while ((i < count) && ((INT)(scoreboard[i].nx_tcp_sack_block_end - ack_number) <= 0))
+    {
+        i++;
+    }
+    if (i)
+    {
+        for (j = i; j < count; j++)
+        {
+            scoreboard[j - i] =  scoreboard[j];
+        }
+        count =  count - i;
+    }
+    if ((count) && ((INT)(scoreboard[0].nx_tcp_sack_block_start - ack_number) < 0))
+    {
+        scoreboard[0].nx_tcp_sack_block_start =  ack_number;
+    }
+
+    /* Find the SACK option, a kind and length followed by up to four blocks of two sequences.  */
+    option_ptr =  _nx_tcp_sack_option_get(option_ptr, option_area_size, NX_TCP_SACK_KIND);
+    if ((option_ptr) && (option_ptr[1] >= 10) && (((option_ptr[1] - 2) & 7) == 0))
+    {
+
+        blocks =  (UINT)(option_ptr[1] - 2) >> 3;
+        option_ptr =  option_ptr + 2;
+
+        for (; blocks; blocks--)
+        {
+
+            /* Pickup the block, in network byte order.  */
+            block_start =  ((ULONG)option_ptr[0] << 24) | ((ULONG)option_ptr[1] << 16) |
+                           ((ULONG)option_ptr[2] << 8) | (ULONG)option_ptr[3];
+            block_end =    ((ULONG)option_ptr[4] << 24) | ((ULONG)option_ptr[5] << 16) |
+                           ((ULONG)option_ptr[6] << 8) | (ULONG)option_ptr[7];
+            option_ptr =  option_ptr + 8;
+
+            /* Ignore blocks that are empty, already acknowledged (D-SACK) or beyond the data sent.  */
+            if (((INT)(block_end - block_start) <= 0) ||
+                ((INT)(block_start - ack_number) <= 0) ||
+                ((INT)(block_end - socket_ptr -> nx_tcp_socket_tx_sequence) > 0))
+            {
+                continue;
+            }
+
+            /* Absorb the blocks overlapping or adjacent to the new one.  */
+            i =  0;
+            while (i < count)
+            {
+                if (((INT)(scoreboard[i].nx_tcp_sack_block_end - block_start) >= 0) &&
+                    ((INT)(block_end - scoreboard[i].nx_tcp_sack_block_start) >= 0))
+                {
+                    if ((INT)(scoreboard[i].nx_tcp_sack_block_start - block_start) < 0)
+                    {
+                        block_start =  scoreboard[i].nx_tcp_sack_block_start;
+                    }
+                    if ((INT)(scoreboard[i].nx_tcp_sack_block_end - block_end) > 0)
+                    {
+                        block_end =  scoreboard[i].nx_tcp_sack_block_end;
+                    }
+
+                    for (j = i + 1; j < count; j++)
+                    {
+                        scoreboard[j - 1] =  scoreboard[j];
+                    }
+                    count--;
+                }
+                else
+                {
+                    i++;
+                }
+            }
+
+            /* Find where the block goes to keep the scoreboard sorted.  */
+            i =  0;
+            while ((i < count) && ((INT)(scoreboard[i].nx_tcp_sack_block_start - block_start) < 0))
+            {
+                i++;
+            }
+
+            /* When full, keep the lowest blocks, they describe the holes retransmitted first.  */
+            if (count == NX_TCP_SACK_SCOREBOARD_SIZE)
+            {
+                if (i == count)
+                {
+                    continue;
+                }
+                count--;
+            }
+
+            for (j = count; j > i; j--)
+            {
+                scoreboard[j] =  scoreboard[j - 1];
+            }
+            scoreboard[i].nx_tcp_sack_block_start =  block_start;
+            scoreboard[i].nx_tcp_sack_block_end =    block_end;
+            count++;
+        }
+    }
+
+    socket_ptr -> nx_tcp_socket_sack_count =  count;
+}
+#endif /* NX_ENABLE_TCP_SACK */
+
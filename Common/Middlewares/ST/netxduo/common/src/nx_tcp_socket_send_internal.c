@@ -759,6 +759,9 @@ UINT            compute_checksum = 1;
 
             /* Setup a new delayed ACK timeout.  */
             socket_ptr -> nx_tcp_socket_delayed_ack_timeout =  _nx_tcp_ack_timer_rate;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+            socket_ptr -> nx_tcp_socket_delayed_ack_armed =  NX_FALSE;
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
             /* Endian swapping logic.  If NX_LITTLE_ENDIAN is specified, these macros will
                swap the endian of the TCP header.  */
@@ -895,6 +898,9 @@ UINT            compute_checksum = 1;
                 /* Setup a timeout for the packet at the head of the list.  */
                 socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
                 socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+                _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
                 socket_ptr -> nx_tcp_socket_tx_outstanding_bytes = 0;
             }
 
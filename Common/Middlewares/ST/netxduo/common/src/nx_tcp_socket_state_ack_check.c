@@ -114,6 +114,7 @@ ULONG          ending_rx_sequence;
 ULONG          acked_bytes;
 ULONG          tcp_payload_length;
 UINT           wrapped_flag = NX_FALSE;
+UINT           dup_ack_threshold = 3;
 
 
     /* Determine if the header has an ACK bit set.  This is an
@@ -249,35 +250,64 @@ UINT           wrapped_flag = NX_FALSE;
                     /* Handle duplicated ACK packet.  */
                     socket_ptr -> nx_tcp_socket_duplicated_ack_received++;
 
-                    if (socket_ptr -> nx_tcp_socket_duplicated_ack_received == 3)
+#ifdef NX_ENABLE_TCP_SACK
+                    /* Early retransmit, RFC 5827.  With fewer than four segments in flight and
+                       nothing more to send, three duplicate ACKs never arrive.  Once the peer
+                       reports data above the hole, lower the threshold to one less than the
+                       number of segments outstanding.  */
+                    if ((socket_ptr -> nx_tcp_socket_sack_count) &&
+                        (socket_ptr -> nx_tcp_socket_transmit_sent_count < 4) &&
+                        (socket_ptr -> nx_tcp_socket_transmit_suspended_count == 0))
                     {
-                        if ((INT)((tcp_header_ptr -> nx_tcp_acknowledgment_number - 1) -
-                                  socket_ptr -> nx_tcp_socket_tx_sequence_recover) > 0)
+                        dup_ack_threshold =  (UINT)socket_ptr -> nx_tcp_socket_transmit_sent_count - 1;
+                        if (dup_ack_threshold == 0)
                         {
-
-                            /* Cumulative acknowledge covers more than recover. */
-                            /* Section 3.2, Page 5, RFC6582. */
-                            /* Retransmit packet immediately. */
-                            _nx_tcp_socket_retransmit(socket_ptr -> nx_tcp_socket_ip_ptr, socket_ptr, NX_TRUE);
+                            dup_ack_threshold =  1;
                         }
-                        else if ((socket_ptr -> nx_tcp_socket_tx_window_congestion > socket_ptr -> nx_tcp_socket_connect_mss) &&
-                                 ((INT)(tcp_header_ptr -> nx_tcp_acknowledgment_number - (socket_ptr -> nx_tcp_socket_previous_highest_ack +
-                                                                                          (socket_ptr -> nx_tcp_socket_connect_mss << 2))) < 0))
+                    }
+#endif /* NX_ENABLE_TCP_SACK */
+
+                    /* Compare with >=, the early retransmit threshold drops as segments are acknowledged.
+                       The fast recovery flag latches the entry, once per loss event.  */
+                    if (socket_ptr -> nx_tcp_socket_fast_recovery == NX_FALSE)
+                    {
+                        if (socket_ptr -> nx_tcp_socket_duplicated_ack_received >= dup_ack_threshold)
                         {
+                            if ((INT)((tcp_header_ptr -> nx_tcp_acknowledgment_number - 1) -
+                                      socket_ptr -> nx_tcp_socket_tx_sequence_recover) > 0)
+                            {
 
-                            /* Congestion window is greater than SMSS bytes and
-                               the difference between highest_ack and prev_highest_ack is at most 4*SMSS bytes.*/
-                            /* Section 4.1, Page 5, RFC6582. */
-                            /* Retransmit packet immediately. */
-                            _nx_tcp_socket_retransmit(socket_ptr -> nx_tcp_socket_ip_ptr, socket_ptr, NX_TRUE);
+                                /* Cumulative acknowledge covers more than recover. */
+                                /* Section 3.2, Page 5, RFC6582. */
+                                /* Retransmit packet immediately. */
+                                _nx_tcp_socket_retransmit(socket_ptr -> nx_tcp_socket_ip_ptr, socket_ptr, NX_TRUE);
+                            }
+                            else if ((socket_ptr -> nx_tcp_socket_tx_window_congestion > socket_ptr -> nx_tcp_socket_connect_mss) &&
+                                     ((INT)(tcp_header_ptr -> nx_tcp_acknowledgment_number - (socket_ptr -> nx_tcp_socket_previous_highest_ack +
+                                                                                              (socket_ptr -> nx_tcp_socket_connect_mss << 2))) < 0))
+                            {
+
+                                /* Congestion window is greater than SMSS bytes and
+                                   the difference between highest_ack and prev_highest_ack is at most 4*SMSS bytes.*/
+                                /* Section 4.1, Page 5, RFC6582. */
+                                /* Retransmit packet immediately. */
+                                _nx_tcp_socket_retransmit(socket_ptr -> nx_tcp_socket_ip_ptr, socket_ptr, NX_TRUE);
+                            }
                         }
                     }
-                    else if ((socket_ptr -> nx_tcp_socket_duplicated_ack_received > 3) &&
-                             (socket_ptr -> nx_tcp_socket_fast_recovery == NX_TRUE))
+                    else
                     {
 
-                        /* CWND += MSS  */
+                        /* Further duplicate ACK in fast recovery, RFC 6582 Section 3.2 step 4. CWND += MSS  */
                         socket_ptr -> nx_tcp_socket_tx_window_congestion += socket_ptr -> nx_tcp_socket_connect_mss;
+
+#ifdef NX_ENABLE_TCP_SACK
+                        /* Repair the next hole the scoreboard shows, if any.  */
+                        if (socket_ptr -> nx_tcp_socket_sack_count)
+                        {
+                            _nx_tcp_socket_retransmit(socket_ptr -> nx_tcp_socket_ip_ptr, socket_ptr, NX_TCP_SACK_RETRANSMIT);
+                        }
+#endif /* NX_ENABLE_TCP_SACK */
                     }
                 }
 
@@ -621,6 +651,9 @@ UINT           wrapped_flag = NX_FALSE;
             /* Setup a new transmit timeout.  */
             socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
             socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+            _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
         }
         else
         {
@@ -642,6 +675,9 @@ UINT           wrapped_flag = NX_FALSE;
                 /* Yes, setup timeout such that the FIN can be retried if it is lost.  */
                 socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
                 socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+                _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
             }
             else if (socket_ptr -> nx_tcp_socket_tx_window_advertised != 0)
             {
@@ -97,6 +97,9 @@ VOID  _nx_tcp_socket_state_closing(NX_TCP_SOCKET *socket_ptr, NX_TCP_HEADER *tcp
 
             /* Set the timeout as 2MSL (Maximum Segment Lifetime). */
             socket_ptr -> nx_tcp_socket_timeout = _nx_tcp_2MSL_timer_rate;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+            _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
             /* Determine if we need to wake a thread suspended on the connection.  */
             if (socket_ptr -> nx_tcp_socket_disconnect_suspended_thread)
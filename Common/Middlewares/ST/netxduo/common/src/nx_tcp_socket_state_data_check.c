@@ -466,6 +466,11 @@ NX_IP         *ip_ptr;
     /* If trace is enabled, insert this event into the trace buffer.  */
     NX_TRACE_IN_LINE_INSERT(NX_TRACE_INTERNAL_TCP_DATA_RECEIVE, ip_ptr, socket_ptr, packet_ptr, tcp_header_ptr -> nx_tcp_sequence_number, NX_TRACE_INTERNAL_EVENTS, 0, 0);
 
+#ifdef NX_ENABLE_TCP_SACK
+    /* The block holding this segment is reported first, RFC 2018 section 4.  */
+    socket_ptr -> nx_tcp_socket_sack_received_sequence =  packet_begin_sequence;
+#endif /* NX_ENABLE_TCP_SACK */
+
     /* Ensure the next pointer in the packet is set to NULL, which will indicate to the
        receive logic that it is not yet part of a contiguous stream.  */
     packet_ptr -> nx_packet_queue_next =  (NX_PACKET *)NX_NULL;
@@ -565,6 +570,9 @@ NX_IP         *ip_ptr;
 #endif /* NX_ENABLE_TCPIP_OFFLOAD */
                 {
                     socket_ptr -> nx_tcp_socket_delayed_ack_timeout =  _nx_tcp_ack_timer_rate;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+                    socket_ptr -> nx_tcp_socket_delayed_ack_armed =  NX_FALSE;
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
                 }
             }
 
@@ -612,8 +620,9 @@ NX_IP         *ip_ptr;
         {
 #endif /* NX_ENABLE_LOW_WATERMARK */
 
-            /* Packet data begins to the right of the expected sequence (out of sequence data). Force an ACK. */
-            _nx_tcp_packet_send_ack(socket_ptr, socket_ptr -> nx_tcp_socket_tx_sequence);
+            /* Packet data begins to the right of the expected sequence (out of sequence data). Force an ACK,
+               sent once the packet is queued so its SACK option reports it.  */
+            need_ack = NX_TRUE;
 
             /* Add debug information. */
             NX_PACKET_DEBUG(NX_PACKET_TCP_RECEIVE_QUEUE, __LINE__, packet_ptr);
@@ -628,6 +637,9 @@ NX_IP         *ip_ptr;
 
             /* Setup a new delayed ACK timeout.  */
             socket_ptr -> nx_tcp_socket_delayed_ack_timeout =  _nx_tcp_ack_timer_rate;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+            socket_ptr -> nx_tcp_socket_delayed_ack_armed =  NX_FALSE;
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
             /* Mark the packet as being part of a TCP queue.  */
             /*lint -e{923} suppress cast of ULONG to pointer.  */
@@ -661,10 +673,11 @@ NX_IP         *ip_ptr;
         /* Go through the received packet chain, and locate the first packet that the
            packet_begin_sequence is to the right of the end of it. */
 
-        /* Packet data begins to the right of the expected sequence (out of sequence data). Force an ACK. */
+        /* Packet data begins to the right of the expected sequence (out of sequence data). Force an ACK,
+           sent once the packet is queued so its SACK option reports it.  */
         if (((INT)(packet_begin_sequence - socket_ptr -> nx_tcp_socket_rx_sequence)) > 0)
         {
-            _nx_tcp_packet_send_ack(socket_ptr, socket_ptr -> nx_tcp_socket_tx_sequence);
+            need_ack = NX_TRUE;
         }
 
         /* At this point, it is guaranteed that the receive queue contains packets. */
@@ -1210,6 +1223,19 @@ NX_IP         *ip_ptr;
         _nx_tcp_packet_send_ack(socket_ptr, socket_ptr -> nx_tcp_socket_tx_sequence);
     }
 
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+
+    /* Start the delayed ACK timeout if an ACK is now owed.  */
+    if ((socket_ptr -> nx_tcp_socket_delayed_ack_armed == NX_FALSE) &&
+        (socket_ptr -> nx_tcp_socket_state >= NX_TCP_ESTABLISHED) &&
+        ((socket_ptr -> nx_tcp_socket_rx_sequence != socket_ptr -> nx_tcp_socket_rx_sequence_acked) ||
+         (socket_ptr -> nx_tcp_socket_rx_window_last_sent < socket_ptr -> nx_tcp_socket_rx_window_current)))
+    {
+        socket_ptr -> nx_tcp_socket_delayed_ack_armed =  NX_TRUE;
+        _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_delayed_ack_timeout));
+    }
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
+
     /* Return true since the packet was queued.  */
     return(NX_TRUE);
 }
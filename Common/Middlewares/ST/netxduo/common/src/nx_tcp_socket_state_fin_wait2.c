@@ -94,6 +94,9 @@ VOID  _nx_tcp_socket_state_fin_wait2(NX_TCP_SOCKET *socket_ptr)
 
         /* Set the timeout as 2MSL (Maximum Segment Lifetime).  */
         socket_ptr -> nx_tcp_socket_timeout = _nx_tcp_2MSL_timer_rate;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+        _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
         /* Send ACK back to the other side of the connection.  */
 
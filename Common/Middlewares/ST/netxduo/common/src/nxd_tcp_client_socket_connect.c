@@ -436,6 +436,9 @@ ULONG         ip_address_log = 0;
     /* Setup a timeout so the connection attempt can be sent again.  */
     socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
     socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+    _nx_tcp_socket_fast_timer_arm(socket_ptr, &(socket_ptr -> nx_tcp_socket_timeout));
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
 
     /* CLEANUP: In case any existing packets on socket's receive queue.  */
     if (socket_ptr -> nx_tcp_socket_receive_queue_count)
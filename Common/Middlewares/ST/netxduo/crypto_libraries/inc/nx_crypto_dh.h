@@ -65,9 +65,11 @@ extern   "C" {
 #define NX_CRYPTO_DIFFIE_HELLMAN_GROUP_2_KEY_SIZE (128)         /* 1024 bits/8. */
 #define NX_CRYPTO_DIFFIE_HELLMAN_MAX_KEY_SIZE     (NX_CRYPTO_DIFFIE_HELLMAN_GROUP_2_KEY_SIZE)
 
-/* Buffer and scratch buffer sizes are calculated from the maximum key size. */
+/* Buffer and scratch buffer sizes are calculated from the maximum key size.
+   A sliding window larger than one bit adds the table of NX_CRYPTO_HUGE_NUMBER_WINDOW_SCRATCH_SIZE. */
 #define NX_CRYPTO_DIFFIE_HELLMAN_BUFFER_SIZE      (NX_CRYPTO_DIFFIE_HELLMAN_MAX_KEY_SIZE * 4)
-#define NX_CRYPTO_DIFFIE_HELLMAN_SCRATCH_SIZE     (NX_CRYPTO_DIFFIE_HELLMAN_BUFFER_SIZE * 8)
+#define NX_CRYPTO_DIFFIE_HELLMAN_SCRATCH_SIZE     ((NX_CRYPTO_DIFFIE_HELLMAN_BUFFER_SIZE * 8) + \
+                                                   NX_CRYPTO_HUGE_NUMBER_WINDOW_SCRATCH_SIZE(NX_CRYPTO_DIFFIE_HELLMAN_MAX_KEY_SIZE))
 
 /* Diffie-Hellman groups and key constants. */
 #define NX_CRYPTO_DH_GROUP_2_GENERATOR            (0x2)  /* Generator constant for Diffie-Hellman group 2. */
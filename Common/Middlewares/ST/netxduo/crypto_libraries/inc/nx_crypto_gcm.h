@@ -68,6 +68,20 @@ extern   "C" {
 #define NX_CRYPTO_GCM_BLOCK_SIZE_INT 4
 #define NX_CRYPTO_GCM_BLOCK_SIZE_SHIFT 4
 
+/* Define the width in bits of the table used by GHASH multiplication.
+   0 selects the bit-serial multiplication which needs no per-key storage.
+   4 or 8 selects Shoup's method, where a table of 16 or 256 multiples of
+   the hash key is computed once per key and the multiplication processes
+   4 or 8 bits per step on 32-bit words. The table costs 256 bytes or
+   4096 bytes of metadata per GCM context.  */
+#ifndef NX_CRYPTO_GCM_GHASH_TABLE_BITS
+#define NX_CRYPTO_GCM_GHASH_TABLE_BITS 0
+#endif /* NX_CRYPTO_GCM_GHASH_TABLE_BITS */
+
+#if (NX_CRYPTO_GCM_GHASH_TABLE_BITS != 0) && (NX_CRYPTO_GCM_GHASH_TABLE_BITS != 4) && (NX_CRYPTO_GCM_GHASH_TABLE_BITS != 8)
+#error "NX_CRYPTO_GCM_GHASH_TABLE_BITS must be 0, 4 or 8."
+#endif
+
 typedef struct NX_CRYPTO_GCM_STRUCT
 {
 
@@ -80,6 +94,11 @@ typedef struct NX_CRYPTO_GCM_STRUCT
     UCHAR nx_crypto_gcm_s[NX_CRYPTO_GCM_BLOCK_SIZE];
     UCHAR nx_crypto_gcm_counter[NX_CRYPTO_GCM_BLOCK_SIZE];
 
+#if NX_CRYPTO_GCM_GHASH_TABLE_BITS
+    /* Multiples of the hash key, stored as big endian 32-bit words. */
+    UINT nx_crypto_gcm_htable[1 << NX_CRYPTO_GCM_GHASH_TABLE_BITS][NX_CRYPTO_GCM_BLOCK_SIZE_INT];
+#endif /* NX_CRYPTO_GCM_GHASH_TABLE_BITS */
+
     /* Pointer of additional data. */
     VOID *nx_crypto_gcm_additional_data;
 
@@ -110,6 +110,27 @@ extern   "C" {
 #error "NX_CRYPTO_HUGE_NUMBER_BITS supports 16 and 32 only!"
 #endif
 
+/* Montgomery multiplication fuses the multiply and reduce passes over the
+ * digits of y and m into a single loop, and squaring uses its own kernel that
+ * computes each cross product once. Define NX_CRYPTO_HUGE_NUMBER_DISABLE_FIOS
+ * to use the original separated loops for both. */
+
+/* Define the window size, in bits, of the sliding window exponentiation used by
+ * _nx_crypto_huge_number_mont_power_modulus. 1 is the plain binary method. Each
+ * extra bit doubles the table of odd powers kept in the scratch buffer, see
+ * NX_CRYPTO_HUGE_NUMBER_WINDOW_SCRATCH_SIZE. */
+#ifndef NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS
+#define NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS 1
+#endif /* NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS */
+
+#if (NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS < 1) || (NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS > 6)
+#error "NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS supports 1 to 6 only!"
+#endif
+
+/* Scratch needed by the window table on top of the binary method, in bytes, for a modulus of m bytes. */
+#define NX_CRYPTO_HUGE_NUMBER_WINDOW_SCRATCH_SIZE(m) \
+    (((1 << (NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS - 1)) - 1) * ((m) + sizeof(HN_UBASE)))
+
 
 /* Huge number structure - contains data pointer and size. */
 typedef struct NX_CRYPTO_HUGE_NUMBER_STRUCT
@@ -208,6 +229,9 @@ VOID _nx_crypto_huge_number_mont(NX_CRYPTO_HUGE_NUMBER *m, UINT mi,
                                  NX_CRYPTO_HUGE_NUMBER *x,
                                  NX_CRYPTO_HUGE_NUMBER *y,
                                  NX_CRYPTO_HUGE_NUMBER *result);
+VOID _nx_crypto_huge_number_mont_square(NX_CRYPTO_HUGE_NUMBER *m, UINT mi,
+                                        NX_CRYPTO_HUGE_NUMBER *x,
+                                        NX_CRYPTO_HUGE_NUMBER *result);
 VOID _nx_crypto_huge_number_power_modulus(NX_CRYPTO_HUGE_NUMBER *number,
                                           NX_CRYPTO_HUGE_NUMBER *exponent,
                                           NX_CRYPTO_HUGE_NUMBER *modulus,
@@ -0,0 +1,165 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Crypto Component                                                 */
+/**                                                                       */
+/**   Crypto Method Benchmark                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  APPLICATION INTERFACE DEFINITION                       RELEASE        */
+/*                                                                        */
+/*    nx_crypto_method_benchmark.h                        PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This file defines the interface of the NetX Crypto method           */
+/*    benchmark. Each benchmark drives a crypto method through its        */
+/*    NX_CRYPTO_METHOD table entry with the same init, operation and      */
+/*    cleanup sequence NetX Secure uses, and reports operations and bytes */
+/*    per second, ticks per operation, metadata size and stack depth.     */
+/*                                                                        */
+/*    The benchmark is built when NX_CRYPTO_ENABLE_BENCHMARK is defined.  */
+/*    It needs no operating system services: the caller supplies a free   */
+/*    running clock and a report callback, so the same code runs on the   */
+/*    target (for example with the DWT cycle counter) and on a host with  */
+/*    NX_CRYPTO_STANDALONE_ENABLE defined (for example with               */
+/*    clock_gettime). Like the rest of the library, a host build needs a  */
+/*    port header where ULONG is 32 bits.                                 */
+/*                                                                        */
+/**************************************************************************/
+
+#ifndef NX_CRYPTO_METHOD_BENCHMARK_H
+#define NX_CRYPTO_METHOD_BENCHMARK_H
+
+/* Determine if a C++ compiler is being used.  If so, ensure that standard
+   C is used to process the API information.  */
+#ifdef __cplusplus
+
+/* Yes, C++ compiler is present.  Use standard C.  */
+extern   "C" {
+
+#endif
+
+#include "nx_crypto.h"
+
+#ifdef NX_CRYPTO_ENABLE_BENCHMARK
+
+/* Define the largest data size of a single operation, in bytes. The default
+   covers the largest TLS record.  */
+#ifndef NX_CRYPTO_BENCHMARK_MAX_DATA_SIZE
+#define NX_CRYPTO_BENCHMARK_MAX_DATA_SIZE           16384
+#endif /* NX_CRYPTO_BENCHMARK_MAX_DATA_SIZE */
+
+/* Define the depth of stack below the caller that is painted to measure the
+   peak stack usage of an operation. The calling thread must have this much
+   free stack. The default 0 disables stack measurement.  */
+#ifndef NX_CRYPTO_BENCHMARK_STACK_PROBE_SIZE
+#define NX_CRYPTO_BENCHMARK_STACK_PROBE_SIZE        0
+#endif /* NX_CRYPTO_BENCHMARK_STACK_PROBE_SIZE */
+
+/* Define the operations that can be measured.  */
+#define NX_CRYPTO_BENCHMARK_ENCRYPT                 1
+#define NX_CRYPTO_BENCHMARK_DECRYPT                 2
+#define NX_CRYPTO_BENCHMARK_HASH                    3
+#define NX_CRYPTO_BENCHMARK_SIGN                    4
+#define NX_CRYPTO_BENCHMARK_VERIFY                  5
+#define NX_CRYPTO_BENCHMARK_KEY_EXCHANGE            6
+#define NX_CRYPTO_BENCHMARK_PUBLIC                  7
+#define NX_CRYPTO_BENCHMARK_PRIVATE                 8
+
+/* Define the result of one measurement.  */
+typedef struct NX_CRYPTO_BENCHMARK_RESULT_STRUCT
+{
+
+    /* Name of the crypto method, for example "aes_128_gcm_16". */
+    const CHAR *nx_crypto_benchmark_result_name;
+
+    /* One of NX_CRYPTO_BENCHMARK_ENCRYPT ... NX_CRYPTO_BENCHMARK_PRIVATE. */
+    UINT  nx_crypto_benchmark_result_operation;
+
+    /* Key size in bits, or curve size for elliptic curve methods. */
+    UINT  nx_crypto_benchmark_result_key_size;
+
+    /* Bytes processed by one operation, 0 for public key operations. */
+    UINT  nx_crypto_benchmark_result_data_size;
+
+    /* Status of the last operation, NX_CRYPTO_SUCCESS if all passed. */
+    UINT  nx_crypto_benchmark_result_status;
+
+    /* Number of operations and clock ticks they took. */
+    ULONG nx_crypto_benchmark_result_count;
+    ULONG nx_crypto_benchmark_result_ticks;
+
+    /* Derived rates. */
+    ULONG nx_crypto_benchmark_result_ops_per_second;
+    ULONG nx_crypto_benchmark_result_bytes_per_second;
+    ULONG nx_crypto_benchmark_result_ticks_per_operation;
+
+    /* Metadata the method requires (nx_crypto_metadata_area_size). */
+    ULONG nx_crypto_benchmark_result_metadata_size;
+
+    /* Peak stack used by one operation, 0 if not measured. */
+    ULONG nx_crypto_benchmark_result_stack_size;
+} NX_CRYPTO_BENCHMARK_RESULT;
+
+/* Define the benchmark control block.  */
+typedef struct NX_CRYPTO_BENCHMARK_STRUCT
+{
+
+    /* Free running clock, and its rate in ticks per second. */
+    ULONG (*nx_crypto_benchmark_clock)(VOID);
+    ULONG nx_crypto_benchmark_clock_rate;
+
+    /* Minimum number of ticks spent in each measurement. */
+    ULONG nx_crypto_benchmark_duration;
+
+    /* Called once for each measurement. */
+    VOID (*nx_crypto_benchmark_report)(NX_CRYPTO_BENCHMARK_RESULT *result, VOID *context);
+    VOID *nx_crypto_benchmark_report_context;
+
+    /* Metadata area handed to the crypto methods. */
+    VOID *nx_crypto_benchmark_metadata;
+    ULONG nx_crypto_benchmark_metadata_size;
+} NX_CRYPTO_BENCHMARK;
+
+UINT _nx_crypto_method_benchmark_cipher(NX_CRYPTO_BENCHMARK *benchmark, const CHAR *name,
+                                        NX_CRYPTO_METHOD *crypto_method, UINT data_size);
+UINT _nx_crypto_method_benchmark_hash(NX_CRYPTO_BENCHMARK *benchmark, const CHAR *name,
+                                      NX_CRYPTO_METHOD *crypto_method, UINT key_size, UINT data_size);
+UINT _nx_crypto_method_benchmark_ecdsa(NX_CRYPTO_BENCHMARK *benchmark, const CHAR *name,
+                                       NX_CRYPTO_METHOD *crypto_method_ecdsa,
+                                       NX_CRYPTO_METHOD *curve_method, NX_CRYPTO_METHOD *hash_method);
+UINT _nx_crypto_method_benchmark_ecdh(NX_CRYPTO_BENCHMARK *benchmark, const CHAR *name,
+                                      NX_CRYPTO_METHOD *crypto_method_ecdh, NX_CRYPTO_METHOD *curve_method);
+UINT _nx_crypto_method_benchmark_rsa(NX_CRYPTO_BENCHMARK *benchmark, const CHAR *name,
+                                     NX_CRYPTO_METHOD *crypto_method_rsa, UINT key_size);
+UINT _nx_crypto_method_benchmark_run(NX_CRYPTO_BENCHMARK *benchmark);
+UINT _nx_crypto_method_benchmark_result_format(NX_CRYPTO_BENCHMARK_RESULT *result,
+                                               CHAR *buffer, UINT buffer_size, UINT *length);
+
+#endif /* NX_CRYPTO_ENABLE_BENCHMARK */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NX_CRYPTO_METHOD_BENCHMARK_H */
+
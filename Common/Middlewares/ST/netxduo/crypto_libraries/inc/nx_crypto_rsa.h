@@ -61,6 +61,7 @@ extern   "C" {
 /* Include the ThreadX and port-specific data type file.  */
 
 #include "nx_crypto.h"
+#include "nx_crypto_huge_number.h"
 
 /* Define the maximum size of an RSA modulus supported in bits. */
 #ifndef NX_CRYPTO_MAX_RSA_MODULUS_SIZE
@@ -70,8 +71,11 @@ extern   "C" {
 
 /* Scratch buffer for RSA calculations.
     Size must be no less than 10 * sizeof(modulus) + 24. 2584 bytes for 2048 bits cryption.
-    If CRT algorithm is not used, size must be no less than (7 * sizeof(modulus) + 8). 1800 bytes for 2048 bits cryption. */
-#define NX_CRYPTO_RSA_SCRATCH_BUFFER_SIZE (((10 * (NX_CRYPTO_MAX_RSA_MODULUS_SIZE / 8)) + 24) / sizeof(USHORT))
+    If CRT algorithm is not used, size must be no less than (7 * sizeof(modulus) + 8). 1800 bytes for 2048 bits cryption.
+    A sliding window larger than one bit adds the table of NX_CRYPTO_HUGE_NUMBER_WINDOW_SCRATCH_SIZE, of sizeof(modulus)
+    without CRT and of sizeof(modulus) / 2 with CRT. */
+#define NX_CRYPTO_RSA_SCRATCH_BUFFER_SIZE (((10 * (NX_CRYPTO_MAX_RSA_MODULUS_SIZE / 8)) + 24 + \
+                                            NX_CRYPTO_HUGE_NUMBER_WINDOW_SCRATCH_SIZE(NX_CRYPTO_MAX_RSA_MODULUS_SIZE / 8)) / sizeof(USHORT))
 
 /* Control block for RSA cryptographic operations. */
 typedef struct NX_CRYPTO_RSA_STRUCT
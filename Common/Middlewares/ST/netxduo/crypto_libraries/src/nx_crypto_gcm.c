@@ -157,6 +157,7 @@ USHORT result;
     counter_block[12] = (UCHAR)(result & 0xFF);
 }
 
+#if !NX_CRYPTO_GCM_GHASH_TABLE_BITS
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -246,6 +247,243 @@ UCHAR mask;
     }
 }
 
+#endif /* !NX_CRYPTO_GCM_GHASH_TABLE_BITS */
+
+#if NX_CRYPTO_GCM_GHASH_TABLE_BITS
+
+/* Reduction of the bits shifted out of the low end of a GF(2^128) element.
+   The value is XOR'ed into the upper 16 bits of the most significant word. */
+static NX_CRYPTO_CONST USHORT _nx_crypto_gcm_reduction_table[1 << NX_CRYPTO_GCM_GHASH_TABLE_BITS] =
+{
+#if (NX_CRYPTO_GCM_GHASH_TABLE_BITS == 4)
+    0x0000, 0x1C20, 0x3840, 0x2460, 0x7080, 0x6CA0, 0x48C0, 0x54E0,
+    0xE100, 0xFD20, 0xD940, 0xC560, 0x9180, 0x8DA0, 0xA9C0, 0xB5E0
+#else
+    0x0000, 0x01C2, 0x0384, 0x0246, 0x0708, 0x06CA, 0x048C, 0x054E,
+    0x0E10, 0x0FD2, 0x0D94, 0x0C56, 0x0918, 0x08DA, 0x0A9C, 0x0B5E,
+    0x1C20, 0x1DE2, 0x1FA4, 0x1E66, 0x1B28, 0x1AEA, 0x18AC, 0x196E,
+    0x1230, 0x13F2, 0x11B4, 0x1076, 0x1538, 0x14FA, 0x16BC, 0x177E,
+    0x3840, 0x3982, 0x3BC4, 0x3A06, 0x3F48, 0x3E8A, 0x3CCC, 0x3D0E,
+    0x3650, 0x3792, 0x35D4, 0x3416, 0x3158, 0x309A, 0x32DC, 0x331E,
+    0x2460, 0x25A2, 0x27E4, 0x2626, 0x2368, 0x22AA, 0x20EC, 0x212E,
+    0x2A70, 0x2BB2, 0x29F4, 0x2836, 0x2D78, 0x2CBA, 0x2EFC, 0x2F3E,
+    0x7080, 0x7142, 0x7304, 0x72C6, 0x7788, 0x764A, 0x740C, 0x75CE,
+    0x7E90, 0x7F52, 0x7D14, 0x7CD6, 0x7998, 0x785A, 0x7A1C, 0x7BDE,
+    0x6CA0, 0x6D62, 0x6F24, 0x6EE6, 0x6BA8, 0x6A6A, 0x682C, 0x69EE,
+    0x62B0, 0x6372, 0x6134, 0x60F6, 0x65B8, 0x647A, 0x663C, 0x67FE,
+    0x48C0, 0x4902, 0x4B44, 0x4A86, 0x4FC8, 0x4E0A, 0x4C4C, 0x4D8E,
+    0x46D0, 0x4712, 0x4554, 0x4496, 0x41D8, 0x401A, 0x425C, 0x439E,
+    0x54E0, 0x5522, 0x5764, 0x56A6, 0x53E8, 0x522A, 0x506C, 0x51AE,
+    0x5AF0, 0x5B32, 0x5974, 0x58B6, 0x5DF8, 0x5C3A, 0x5E7C, 0x5FBE,
+    0xE100, 0xE0C2, 0xE284, 0xE346, 0xE608, 0xE7CA, 0xE58C, 0xE44E,
+    0xEF10, 0xEED2, 0xEC94, 0xED56, 0xE818, 0xE9DA, 0xEB9C, 0xEA5E,
+    0xFD20, 0xFCE2, 0xFEA4, 0xFF66, 0xFA28, 0xFBEA, 0xF9AC, 0xF86E,
+    0xF330, 0xF2F2, 0xF0B4, 0xF176, 0xF438, 0xF5FA, 0xF7BC, 0xF67E,
+    0xD940, 0xD882, 0xDAC4, 0xDB06, 0xDE48, 0xDF8A, 0xDDCC, 0xDC0E,
+    0xD750, 0xD692, 0xD4D4, 0xD516, 0xD058, 0xD19A, 0xD3DC, 0xD21E,
+    0xC560, 0xC4A2, 0xC6E4, 0xC726, 0xC268, 0xC3AA, 0xC1EC, 0xC02E,
+    0xCB70, 0xCAB2, 0xC8F4, 0xC936, 0xCC78, 0xCDBA, 0xCFFC, 0xCE3E,
+    0x9180, 0x9042, 0x9204, 0x93C6, 0x9688, 0x974A, 0x950C, 0x94CE,
+    0x9F90, 0x9E52, 0x9C14, 0x9DD6, 0x9898, 0x995A, 0x9B1C, 0x9ADE,
+    0x8DA0, 0x8C62, 0x8E24, 0x8FE6, 0x8AA8, 0x8B6A, 0x892C, 0x88EE,
+    0x83B0, 0x8272, 0x8034, 0x81F6, 0x84B8, 0x857A, 0x873C, 0x86FE,
+    0xA9C0, 0xA802, 0xAA44, 0xAB86, 0xAEC8, 0xAF0A, 0xAD4C, 0xAC8E,
+    0xA7D0, 0xA612, 0xA454, 0xA596, 0xA0D8, 0xA11A, 0xA35C, 0xA29E,
+    0xB5E0, 0xB422, 0xB664, 0xB7A6, 0xB2E8, 0xB32A, 0xB16C, 0xB0AE,
+    0xBBF0, 0xBA32, 0xB874, 0xB9B6, 0xBCF8, 0xBD3A, 0xBF7C, 0xBEBE
+#endif /* NX_CRYPTO_GCM_GHASH_TABLE_BITS == 4 */
+};
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_gcm_table_init                           PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function precomputes the multiples of the hash key used by     */
+/*    the table driven multiplication in GF(2^128). Entry i holds the     */
+/*    product of the hash key and the field element whose leading bits    */
+/*    are the bits of i.                                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    hkey                                  Pointer to hash key           */
+/*    htable                                Pointer to output table       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_gcm_encrypt_init           Initialize GCM mode           */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_gcm_table_init(UCHAR *hkey,
+                                                     UINT htable[][NX_CRYPTO_GCM_BLOCK_SIZE_INT])
+{
+UINT i, j;
+UINT *v;
+UINT *w;
+
+    /* The most significant index bit is the coefficient of x^0, so this entry is H. */
+    v = htable[1 << (NX_CRYPTO_GCM_GHASH_TABLE_BITS - 1)];
+    for (i = 0; i < NX_CRYPTO_GCM_BLOCK_SIZE_INT; i++)
+    {
+        v[i] = ((UINT)hkey[(i << 2)] << 24) |
+               ((UINT)hkey[(i << 2) + 1] << 16) |
+               ((UINT)hkey[(i << 2) + 2] << 8) |
+               (UINT)hkey[(i << 2) + 3];
+    }
+
+    /* Each lower power of two index is the previous entry multiplied by x. */
+    for (i = (1 << (NX_CRYPTO_GCM_GHASH_TABLE_BITS - 2)); i > 0; i >>= 1)
+    {
+        v = htable[i << 1];
+        w = htable[i];
+        w[3] = (v[3] >> 1) | (v[2] << 31);
+        w[2] = (v[2] >> 1) | (v[1] << 31);
+        w[1] = (v[1] >> 1) | (v[0] << 31);
+        w[0] = (v[0] >> 1) ^ ((0 - (v[3] & 1)) & 0xE1000000);
+    }
+
+    /* Multiplication distributes over XOR, so the remaining entries are sums of the powers. */
+    NX_CRYPTO_MEMSET(htable[0], 0, sizeof(htable[0]));
+    for (i = 2; i < (1 << NX_CRYPTO_GCM_GHASH_TABLE_BITS); i <<= 1)
+    {
+        v = htable[i];
+        for (j = 1; j < i; j++)
+        {
+            w = htable[i + j];
+            w[0] = v[0] ^ htable[j][0];
+            w[1] = v[1] ^ htable[j][1];
+            w[2] = v[2] ^ htable[j][2];
+            w[3] = v[3] ^ htable[j][3];
+        }
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_gcm_table_step                           PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function performs one step of the table driven multiplication. */
+/*    The accumulator is multiplied by x^NX_CRYPTO_GCM_GHASH_TABLE_BITS,  */
+/*    the coefficients shifted out are reduced through the reduction      */
+/*    table, and the table entry for the next chunk is added.             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    z                                     Pointer to accumulator words  */
+/*    entry                                 Pointer to table entry        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_gcm_multi_table            Compute multiplication in GF  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_gcm_table_step(UINT *z, UINT *entry)
+{
+UINT rem;
+
+    rem = z[3] & ((1 << NX_CRYPTO_GCM_GHASH_TABLE_BITS) - 1);
+    z[3] = ((z[3] >> NX_CRYPTO_GCM_GHASH_TABLE_BITS) | (z[2] << (32 - NX_CRYPTO_GCM_GHASH_TABLE_BITS))) ^ entry[3];
+    z[2] = ((z[2] >> NX_CRYPTO_GCM_GHASH_TABLE_BITS) | (z[1] << (32 - NX_CRYPTO_GCM_GHASH_TABLE_BITS))) ^ entry[2];
+    z[1] = ((z[1] >> NX_CRYPTO_GCM_GHASH_TABLE_BITS) | (z[0] << (32 - NX_CRYPTO_GCM_GHASH_TABLE_BITS))) ^ entry[1];
+    z[0] = (z[0] >> NX_CRYPTO_GCM_GHASH_TABLE_BITS) ^
+           ((UINT)_nx_crypto_gcm_reduction_table[rem] << 16) ^ entry[0];
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_gcm_multi_table                          PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function performs multiplication in GF(2^128) by the hash key  */
+/*    using the precomputed table. The input is consumed in chunks of     */
+/*    NX_CRYPTO_GCM_GHASH_TABLE_BITS bits from the highest degree down,   */
+/*    with one table lookup and one reduction lookup for each chunk.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    x                                     Pointer to X block            */
+/*    htable                                Pointer to hash key table     */
+/*    output                                Pointer to result block       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_gcm_table_step             Process one chunk of X        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_gcm_ghash_update           Compute GHASH                 */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_gcm_multi_table(UCHAR *x, UINT htable[][NX_CRYPTO_GCM_BLOCK_SIZE_INT],
+                                                      UCHAR *output)
+{
+UINT z[NX_CRYPTO_GCM_BLOCK_SIZE_INT];
+INT i;
+
+    z[0] = 0;
+    z[1] = 0;
+    z[2] = 0;
+    z[3] = 0;
+
+    for (i = NX_CRYPTO_GCM_BLOCK_SIZE - 1; i >= 0; i--)
+    {
+#if (NX_CRYPTO_GCM_GHASH_TABLE_BITS == 4)
+
+        /* The low nibble holds the higher degree coefficients. */
+        _nx_crypto_gcm_table_step(z, htable[x[i] & 0x0F]);
+        _nx_crypto_gcm_table_step(z, htable[x[i] >> 4]);
+#else
+        _nx_crypto_gcm_table_step(z, htable[x[i]]);
+#endif /* NX_CRYPTO_GCM_GHASH_TABLE_BITS == 4 */
+    }
+
+    for (i = 0; i < NX_CRYPTO_GCM_BLOCK_SIZE_INT; i++)
+    {
+        output[(i << 2)] = (UCHAR)(z[i] >> 24);
+        output[(i << 2) + 1] = (UCHAR)(z[i] >> 16);
+        output[(i << 2) + 2] = (UCHAR)(z[i] >> 8);
+        output[(i << 2) + 3] = (UCHAR)(z[i]);
+    }
+}
+#endif /* NX_CRYPTO_GCM_GHASH_TABLE_BITS */
+
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -263,7 +501,7 @@ UCHAR mask;
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    hkey                                  Pointer to hash key           */
+/*    gcm_metadata                          Pointer to GCM metadata       */
 /*    input                                 Pointer to bytes of input     */
 /*    input_length                          Length of bytes of input      */
 /*    output                                Pointer to updated hash       */
@@ -276,6 +514,8 @@ UCHAR mask;
 /*                                                                        */
 /*    _nx_crypto_gcm_xor                    Perform XOR operation         */
 /*    _nx_crypto_gcm_multi                  Perform multiplication in GF  */
+/*    _nx_crypto_gcm_multi_table            Perform multiplication in GF  */
+/*                                            with precomputed table      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -291,7 +531,8 @@ UCHAR mask;
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-NX_CRYPTO_KEEP static VOID _nx_crypto_gcm_ghash_update(UCHAR *hkey, UCHAR *input, UINT input_length, UCHAR *output)
+NX_CRYPTO_KEEP static VOID _nx_crypto_gcm_ghash_update(NX_CRYPTO_GCM *gcm_metadata, UCHAR *input, UINT input_length,
+                                                       UCHAR *output)
 {
 UCHAR tmp_block[NX_CRYPTO_GCM_BLOCK_SIZE];
 UINT i, n;
@@ -302,7 +543,11 @@ UINT i, n;
 
         /* output = (output xor input) multi hkey */
         _nx_crypto_gcm_xor(output, input, tmp_block);
-        _nx_crypto_gcm_multi(tmp_block, hkey, output);
+#if NX_CRYPTO_GCM_GHASH_TABLE_BITS
+        _nx_crypto_gcm_multi_table(tmp_block, gcm_metadata -> nx_crypto_gcm_htable, output);
+#else
+        _nx_crypto_gcm_multi(tmp_block, gcm_metadata -> nx_crypto_gcm_hkey, output);
+#endif /* NX_CRYPTO_GCM_GHASH_TABLE_BITS */
         input += NX_CRYPTO_GCM_BLOCK_SIZE;
     }
 
@@ -315,7 +560,11 @@ UINT i, n;
         NX_CRYPTO_MEMCPY(tmp_block, input, input_length); /* Use case of memcpy is verified. */
         NX_CRYPTO_MEMSET(&tmp_block[input_length], 0, sizeof(tmp_block) - input_length);
         _nx_crypto_gcm_xor(output, tmp_block, tmp_block);
-        _nx_crypto_gcm_multi(tmp_block, hkey, output);
+#if NX_CRYPTO_GCM_GHASH_TABLE_BITS
+        _nx_crypto_gcm_multi_table(tmp_block, gcm_metadata -> nx_crypto_gcm_htable, output);
+#else
+        _nx_crypto_gcm_multi(tmp_block, gcm_metadata -> nx_crypto_gcm_hkey, output);
+#endif /* NX_CRYPTO_GCM_GHASH_TABLE_BITS */
     }
 }
 
@@ -477,6 +726,11 @@ UCHAR iv_len;
     NX_CRYPTO_MEMSET(hkey, 0, NX_CRYPTO_GCM_BLOCK_SIZE);
     crypto_function(crypto_metadata, hkey, hkey, NX_CRYPTO_GCM_BLOCK_SIZE);
 
+#if NX_CRYPTO_GCM_GHASH_TABLE_BITS
+    /* Precompute the multiples of the hash key once for this key. */
+    _nx_crypto_gcm_table_init(hkey, gcm_metadata -> nx_crypto_gcm_htable);
+#endif /* NX_CRYPTO_GCM_GHASH_TABLE_BITS */
+
     /* Generate the pre-counter block j0. */
     iv_len = iv[0];
     iv = iv + 1;
@@ -496,18 +750,18 @@ UCHAR iv_len;
 
         /* When the length of IV is not 12 then apply GHASH to the IV. */
         NX_CRYPTO_MEMSET(j0, 0, NX_CRYPTO_GCM_BLOCK_SIZE);
-        _nx_crypto_gcm_ghash_update(hkey, iv, iv_len, j0);
+        _nx_crypto_gcm_ghash_update(gcm_metadata, iv, iv_len, j0);
 
         /* Apply GHASH to the length of IV to form j0.*/
         NX_CRYPTO_MEMSET(tmp_block, 0, NX_CRYPTO_GCM_BLOCK_SIZE);
         tmp_block[NX_CRYPTO_GCM_BLOCK_SIZE - 2] = (UCHAR)(((iv_len << 3) & 0xFF00) >> 8);
         tmp_block[NX_CRYPTO_GCM_BLOCK_SIZE - 1] = (UCHAR)((iv_len << 3) & 0x00FF);
-        _nx_crypto_gcm_ghash_update(hkey, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, j0);
+        _nx_crypto_gcm_ghash_update(gcm_metadata, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, j0);
     }
 
     /* Apply GHASH to the additional authenticated data. */
     NX_CRYPTO_MEMSET(s, 0, NX_CRYPTO_GCM_BLOCK_SIZE);
-    _nx_crypto_gcm_ghash_update(hkey, additional_data, additional_len, s);
+    _nx_crypto_gcm_ghash_update(gcm_metadata, additional_data, additional_len, s);
 
     /* Initial counter block for GCTR is j0 + 1. */
     NX_CRYPTO_MEMCPY(counter, j0, NX_CRYPTO_GCM_BLOCK_SIZE); /* Use case of memcpy is verified. */
@@ -574,7 +828,6 @@ NX_CRYPTO_KEEP UINT _nx_crypto_gcm_encrypt_update(VOID *crypto_metadata, NX_CRYP
                                                   UCHAR *input, UCHAR *output, UINT length,
                                                   UINT block_size)
 {
-UCHAR *hkey = gcm_metadata -> nx_crypto_gcm_hkey;
 UCHAR *s = gcm_metadata -> nx_crypto_gcm_s;
 UCHAR *counter = gcm_metadata -> nx_crypto_gcm_counter;
 
@@ -588,7 +841,7 @@ UCHAR *counter = gcm_metadata -> nx_crypto_gcm_counter;
     _nx_crypto_gcm_gctr(crypto_metadata, crypto_function, input, output, length, counter);
 
     /* Apply GHASH to the cipher text. */
-    _nx_crypto_gcm_ghash_update(hkey, output, length, s);
+    _nx_crypto_gcm_ghash_update(gcm_metadata, output, length, s);
 
     gcm_metadata -> nx_crypto_gcm_input_total_length += length;
 
@@ -645,7 +898,6 @@ NX_CRYPTO_KEEP UINT _nx_crypto_gcm_encrypt_calculate(VOID *crypto_metadata, NX_C
                                                      UINT (*crypto_function)(VOID *, UCHAR *, UCHAR *, UINT),
                                                      UCHAR *output, UINT icv_len, UINT block_size)
 {
-UCHAR *hkey = gcm_metadata -> nx_crypto_gcm_hkey;
 UCHAR *j0 = gcm_metadata -> nx_crypto_gcm_j0;
 UCHAR *s = gcm_metadata -> nx_crypto_gcm_s;
 UCHAR tmp_block[NX_CRYPTO_GCM_BLOCK_SIZE];
@@ -676,7 +928,7 @@ UINT length;
     tmp_block[13] = (UCHAR)(((length << 3) & 0x00FF0000) >> 16);
     tmp_block[14] = (UCHAR)(((length << 3) & 0x0000FF00) >> 8);
     tmp_block[15] = (UCHAR)((length << 3) & 0x000000FF);
-    _nx_crypto_gcm_ghash_update(hkey, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, s);
+    _nx_crypto_gcm_ghash_update(gcm_metadata, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, s);
 
     /* Encrypt the GHASH result using GCTR with j0 as initial counter block.
         The result is the authentication tag. */
@@ -743,7 +995,6 @@ NX_CRYPTO_KEEP UINT _nx_crypto_gcm_decrypt_update(VOID *crypto_metadata, NX_CRYP
                                                   UCHAR *input, UCHAR *output, UINT length,
                                                   UINT block_size)
 {
-UCHAR *hkey = gcm_metadata -> nx_crypto_gcm_hkey;
 UCHAR *s = gcm_metadata -> nx_crypto_gcm_s;
 UCHAR *counter = gcm_metadata -> nx_crypto_gcm_counter;
 
@@ -754,7 +1005,7 @@ UCHAR *counter = gcm_metadata -> nx_crypto_gcm_counter;
     }
 
     /* Apply GHASH to the cipher text. */
-    _nx_crypto_gcm_ghash_update(hkey, input, length, s);
+    _nx_crypto_gcm_ghash_update(gcm_metadata, input, length, s);
 
     /* Invoke GCTR function to encrypt or decrypt the input message. */
     _nx_crypto_gcm_gctr(crypto_metadata, crypto_function, input, output, length, counter);
@@ -813,7 +1064,6 @@ NX_CRYPTO_KEEP UINT _nx_crypto_gcm_decrypt_calculate(VOID *crypto_metadata, NX_C
                                                      UINT (*crypto_function)(VOID *, UCHAR *, UCHAR *, UINT),
                                                      UCHAR *input, UINT icv_len, UINT block_size)
 {
-UCHAR *hkey = gcm_metadata -> nx_crypto_gcm_hkey;
 UCHAR *j0 = gcm_metadata -> nx_crypto_gcm_j0;
 UCHAR *s = gcm_metadata -> nx_crypto_gcm_s;
 UCHAR tmp_block[NX_CRYPTO_GCM_BLOCK_SIZE];
@@ -845,7 +1095,7 @@ UINT i;
     tmp_block[13] = (UCHAR)(((length << 3) & 0x00FF0000) >> 16);
     tmp_block[14] = (UCHAR)(((length << 3) & 0x0000FF00) >> 8);
     tmp_block[15] = (UCHAR)((length << 3) & 0x000000FF);
-    _nx_crypto_gcm_ghash_update(hkey, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, s);
+    _nx_crypto_gcm_ghash_update(gcm_metadata, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, s);
 
 #ifdef NX_SECURE_KEY_CLEAR
     NX_CRYPTO_MEMSET(tmp_block, 0, sizeof(tmp_block));
@@ -2277,9 +2277,8 @@ UINT                  buffer_size;
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nx_crypto_huge_number_mont_power_modulus                           */
-/*                                          Raise a huge number for       */
-/*                                            montgomery reduction        */
+/*    _nx_crypto_ecdsa_sign                 Sign hash data using ECDSA    */
+/*    _nx_crypto_ecdsa_verify               Verify hash data using ECDSA  */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -2450,6 +2449,85 @@ UINT                  buffer_size;
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
+#ifndef NX_CRYPTO_HUGE_NUMBER_DISABLE_FIOS
+NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_mont(NX_CRYPTO_HUGE_NUMBER *m, UINT mi,
+                                                NX_CRYPTO_HUGE_NUMBER *x,
+                                                NX_CRYPTO_HUGE_NUMBER *y,
+                                                NX_CRYPTO_HUGE_NUMBER *result)
+{
+UINT      i, j;
+HN_UBASE  u;
+HN_UBASE  xi;
+HN_UBASE2 product;
+HN_UBASE2 reduce;
+UINT      m_len = m -> nx_crypto_huge_number_size;
+UINT      x_len = x -> nx_crypto_huge_number_size;
+UINT      y_len = y -> nx_crypto_huge_number_size;
+HN_UBASE *m_buffer = m -> nx_crypto_huge_number_data;
+HN_UBASE *x_buffer = x -> nx_crypto_huge_number_data;
+HN_UBASE *y_buffer = y -> nx_crypto_huge_number_data;
+HN_UBASE *result_buffer = result -> nx_crypto_huge_number_data;
+
+    NX_CRYPTO_MEMSET(result -> nx_crypto_huge_number_data, 0, (m_len + 1) * sizeof(HN_UBASE));
+
+    for (i = 0; i < x_len; i++)
+    {
+
+        xi = x_buffer[i];
+
+        /* u = (r[0] + x[i] * y[0]) * mi mod radix */
+        product = result_buffer[0] + (HN_UBASE2)xi * y_buffer[0];
+        u = (HN_UBASE)((HN_UBASE)product * mi);
+        reduce = (HN_UBASE)product + (HN_UBASE2)u * m_buffer[0];
+
+        /* r = (r + x[i] * y + u * m) / radix, both products are accumulated in one pass. */
+        for (j = 1; j < y_len; j++)
+        {
+            product = (product >> HN_SHIFT) + result_buffer[j] + (HN_UBASE2)xi * y_buffer[j];
+            reduce = (reduce >> HN_SHIFT) + (HN_UBASE)product + (HN_UBASE2)u * m_buffer[j];
+            result_buffer[j - 1] = (HN_UBASE)reduce;
+        }
+        for (; j < m_len; j++)
+        {
+            product = (product >> HN_SHIFT) + result_buffer[j];
+            reduce = (reduce >> HN_SHIFT) + (HN_UBASE)product + (HN_UBASE2)u * m_buffer[j];
+            result_buffer[j - 1] = (HN_UBASE)reduce;
+        }
+        product = (product >> HN_SHIFT) + (reduce >> HN_SHIFT) + result_buffer[j];
+        result_buffer[j - 1] = (HN_UBASE)product;
+        result_buffer[j] = (HN_UBASE)(product >> HN_SHIFT);
+    }
+
+    for (; i < m_len; i++)
+    {
+
+        /* u = r[0] * mi mod radix */
+        u = (HN_UBASE)(result_buffer[0] * mi);
+
+        /* r = (r + u * m) / radix */
+        reduce = result_buffer[0] + (HN_UBASE2)u * m_buffer[0];
+        for (j = 1; j < m_len; j++)
+        {
+            reduce = (reduce >> HN_SHIFT) + result_buffer[j] + (HN_UBASE2)u * m_buffer[j];
+            result_buffer[j - 1] = (HN_UBASE)reduce;
+        }
+        reduce = (reduce >> HN_SHIFT) + result_buffer[j];
+        result_buffer[j - 1] = (HN_UBASE)reduce;
+        result_buffer[j] = (HN_UBASE)(reduce >> HN_SHIFT);
+    }
+
+    /* Set result size. */
+    result -> nx_crypto_huge_number_size = m_len + 1;
+    _nx_crypto_huge_number_adjust_size(result);
+
+    if (_nx_crypto_huge_number_compare(result, m) != NX_CRYPTO_HUGE_NUMBER_LESS)
+    {
+
+        /* r = r - m. */
+        _nx_crypto_huge_number_subtract(result, m);
+    }
+}
+#else
 NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_mont(NX_CRYPTO_HUGE_NUMBER *m, UINT mi,
                                                 NX_CRYPTO_HUGE_NUMBER *x,
                                                 NX_CRYPTO_HUGE_NUMBER *y,
@@ -2536,6 +2614,140 @@ HN_UBASE *result_buffer = result -> nx_crypto_huge_number_data;
         _nx_crypto_huge_number_subtract(result, m);
     }
 }
+#endif /* NX_CRYPTO_HUGE_NUMBER_DISABLE_FIOS */
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_huge_number_mont_square                  PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function performs Montgomery reduction for squaring.           */
+/*                  r = (x * x) * R ^ (-1) mod m                          */
+/*                                                                        */
+/*    The full square is computed first, adding each cross product        */
+/*    x[i] * x[j] once and doubling, then reduced in place. The buffer of */
+/*    result must hold twice the digits of m. x must be less than m.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    m                                     Huge number m                 */
+/*    mi                                    mi = -m ^ (-1) mod radix      */
+/*    x                                     Huge number x                 */
+/*    result                                Huge number r                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_huge_number_mont           Perform Montgomery reduction  */
+/*                                            for multiplication          */
+/*    _nx_crypto_huge_number_subtract       Calculate subtraction for     */
+/*                                             huge numbers               */
+/*    _nx_crypto_huge_number_adjust_size    Adjust the size of a huge     */
+/*                                            number to remove leading    */
+/*                                            zeroes                      */
+/*    _nx_crypto_huge_number_compare        Compare two huge numbers      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_huge_number_mont_power_modulus                           */
+/*                                          Raise a huge number for       */
+/*                                            montgomery reduction        */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_mont_square(NX_CRYPTO_HUGE_NUMBER *m, UINT mi,
+                                                       NX_CRYPTO_HUGE_NUMBER *x,
+                                                       NX_CRYPTO_HUGE_NUMBER *result)
+{
+#ifndef NX_CRYPTO_HUGE_NUMBER_DISABLE_FIOS
+UINT      i, j;
+HN_UBASE  u;
+HN_UBASE  xi;
+HN_UBASE  carry;
+HN_UBASE  word;
+HN_UBASE2 product;
+UINT      m_len = m -> nx_crypto_huge_number_size;
+UINT      x_len = x -> nx_crypto_huge_number_size;
+HN_UBASE *m_buffer = m -> nx_crypto_huge_number_data;
+HN_UBASE *x_buffer = x -> nx_crypto_huge_number_data;
+HN_UBASE *result_buffer = result -> nx_crypto_huge_number_data;
+
+    NX_CRYPTO_MEMSET(result_buffer, 0, (m_len << 1) * sizeof(HN_UBASE));
+
+    /* t = sum of x[i] * x[j] for i < j. */
+    for (i = 0; i < x_len; i++)
+    {
+        xi = x_buffer[i];
+        product = 0;
+        for (j = i + 1; j < x_len; j++)
+        {
+            product = (product >> HN_SHIFT) + result_buffer[i + j] + (HN_UBASE2)xi * x_buffer[j];
+            result_buffer[i + j] = (HN_UBASE)product;
+        }
+        result_buffer[i + x_len] = (HN_UBASE)(product >> HN_SHIFT);
+    }
+
+    /* t = 2 * t + sum of x[i] * x[i] * radix ^ (2 * i) */
+    carry = 0;
+    product = 0;
+    for (i = 0; i < x_len; i++)
+    {
+        xi = x_buffer[i];
+        word = result_buffer[i << 1];
+        product = (product >> HN_SHIFT) + (HN_UBASE)((word << 1) | carry) + (HN_UBASE2)xi * xi;
+        carry = (HN_UBASE)(word >> (HN_SHIFT - 1));
+        result_buffer[i << 1] = (HN_UBASE)product;
+
+        word = result_buffer[(i << 1) + 1];
+        product = (product >> HN_SHIFT) + (HN_UBASE)((word << 1) | carry);
+        carry = (HN_UBASE)(word >> (HN_SHIFT - 1));
+        result_buffer[(i << 1) + 1] = (HN_UBASE)product;
+    }
+
+    /* Reduce in place: t = (t + u * m) / radix for each digit of m. The carry out of
+       row i belongs to digit i + m_len + 1, which is where row i + 1 ends. */
+    carry = 0;
+    for (i = 0; i < m_len; i++)
+    {
+        u = (HN_UBASE)(result_buffer[i] * mi);
+        product = 0;
+        for (j = 0; j < m_len; j++)
+        {
+            product = (product >> HN_SHIFT) + result_buffer[i + j] + (HN_UBASE2)u * m_buffer[j];
+            result_buffer[i + j] = (HN_UBASE)product;
+        }
+        product = (product >> HN_SHIFT) + result_buffer[i + m_len] + carry;
+        result_buffer[i + m_len] = (HN_UBASE)product;
+        carry = (HN_UBASE)(product >> HN_SHIFT);
+    }
+
+    /* r = t / radix ^ m_len */
+    for (i = 0; i < m_len; i++)
+    {
+        result_buffer[i] = result_buffer[i + m_len];
+    }
+    result_buffer[m_len] = carry;
+
+    /* Set result size. */
+    result -> nx_crypto_huge_number_size = m_len + 1;
+    _nx_crypto_huge_number_adjust_size(result);
+
+    if (_nx_crypto_huge_number_compare(result, m) != NX_CRYPTO_HUGE_NUMBER_LESS)
+    {
+
+        /* r = r - m. */
+        _nx_crypto_huge_number_subtract(result, m);
+    }
+#else
+    _nx_crypto_huge_number_mont(m, mi, x, x, result);
+#endif /* NX_CRYPTO_HUGE_NUMBER_DISABLE_FIOS */
+}
 
 /**************************************************************************/
 /*                                                                        */
@@ -2552,8 +2764,12 @@ HN_UBASE *result_buffer = result -> nx_crypto_huge_number_data;
 /*    This function raises a huge number to the power of a second huge    */
 /*    number using a third huge number as a modulus. The result is placed */
 /*    in a fourth huge number. Montgomery reduction is used.              */
+/*    The exponent is scanned left to right in windows of up to           */
+/*    NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS bits, each ending in a set bit.   */
+/*    Exponents of 64 bits or less use single bit windows.                */
 /*    scratch is required to be larger than twice of buffer size of m     */
-/*    plus 8 bytes.                                                       */
+/*    plus 8 bytes, plus NX_CRYPTO_HUGE_NUMBER_WINDOW_SCRATCH_SIZE of the */
+/*    buffer size of m. result must hold twice the digits of m.           */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -2579,11 +2795,10 @@ HN_UBASE *result_buffer = result -> nx_crypto_huge_number_data;
 /*                                            number to remove leading    */
 /*                                            zeroes                      */
 /*    _nx_crypto_huge_number_modulus        Perform a modulus operation   */
-/*    _nx_crypto_huge_number_inverse_modulus                              */
-/*                                          Perform an inverse modulus    */
-/*                                            operation                   */
 /*    _nx_crypto_huge_number_mont           Perform Montgomery reduction  */
 /*                                            for multiplication          */
+/*    _nx_crypto_huge_number_mont_square    Perform Montgomery reduction  */
+/*                                            for squaring                */
 /*    _nx_crypto_huge_number_square         Compute the square of a value */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -2606,6 +2821,10 @@ HN_UBASE *result_buffer = result -> nx_crypto_huge_number_data;
 /*                                            resulting in version 6.1.9  */
 /*                                                                        */
 /**************************************************************************/
+/* Bit i of the exponent e. */
+#define HN_EXPONENT_BIT(e, i) \
+    (((e) -> nx_crypto_huge_number_data[(i) / HN_SHIFT] >> ((i) % HN_SHIFT)) & 1)
+
 NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_mont_power_modulus(NX_CRYPTO_HUGE_NUMBER *x,
                                                               NX_CRYPTO_HUGE_NUMBER *e,
                                                               NX_CRYPTO_HUGE_NUMBER *m,
@@ -2613,45 +2832,37 @@ NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_mont_power_modulus(NX_CRYPTO_HUGE_NUM
                                                               HN_UBASE *scratch)
 {
 UINT                   m_len;
-NX_CRYPTO_HUGE_NUMBER  xx;
+NX_CRYPTO_HUGE_NUMBER  table[1 << (NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS - 1)];
 NX_CRYPTO_HUGE_NUMBER  temp;
 NX_CRYPTO_HUGE_NUMBER  digit;
-NX_CRYPTO_HUGE_NUMBER  radix;
-NX_CRYPTO_HUGE_NUMBER  mi;
-NX_CRYPTO_HUGE_NUMBER  m0;
 HN_UBASE               digit_value;
 HN_UBASE              *val;
-HN_UBASE               radix_buffer[2] = {0, 1};
-HN_UBASE               mm_buffer[2];
-HN_UBASE               cur_block;
-UINT                   bit, exp_size;
-NX_CRYPTO_HUGE_NUMBER *operand, *temp_result, *temp_swap;
+ULONG                  m0, mi;
+UINT                   i, bit, window, window_bits, window_limit;
+UINT                   started = NX_CRYPTO_FALSE;
 
     /* Adjust sizes before performing the calculation. */
     _nx_crypto_huge_number_adjust_size(x);
     _nx_crypto_huge_number_adjust_size(e);
     _nx_crypto_huge_number_adjust_size(m);
 
-    /* Initialize const huge numbers. */
-    radix.nx_crypto_huge_number_data = radix_buffer;
-    radix.nx_crypto_huge_number_size = 2;
-    radix.nx_crypto_huge_number_is_negative = NX_CRYPTO_FALSE;
-    radix.nx_crypto_huge_buffer_size = sizeof(radix_buffer);
-    m0.nx_crypto_huge_number_data = m -> nx_crypto_huge_number_data;
-    m0.nx_crypto_huge_number_size = 1;
-    m0.nx_crypto_huge_buffer_size = 4;
-    m0.nx_crypto_huge_number_is_negative = NX_CRYPTO_FALSE;
-    mi.nx_crypto_huge_number_data = mm_buffer;
-    mi.nx_crypto_huge_buffer_size = sizeof(mm_buffer);
-
-    /* mi = -m^(-1) mod radix */
-    _nx_crypto_huge_number_inverse_modulus(&m0, &radix, &mi, scratch);
-    mm_buffer[0] = (HN_UBASE)(HN_RADIX - mm_buffer[0]);
+    /* mi = -m^(-1) mod radix. m is odd so m * m = 1 mod 8, and each Newton
+       step doubles the number of correct low bits. */
+    m0 = m -> nx_crypto_huge_number_data[0];
+    mi = m0;
+    for (i = 0; i < 4; i++)
+    {
+        mi = mi * (2 - m0 * mi);
+    }
+    mi = (HN_UBASE)(0 - mi);
 
     /* Set buffers. */
-    /* Buffer usage: 2 * buffer_size of m + 8 */
-    NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&xx, scratch, m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+    /* Buffer usage: (1 + window table entries) * (buffer_size of m + 4) */
     NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&temp, scratch, m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+    for (i = 0; i < (1u << (NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS - 1)); i++)
+    {
+        NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&table[i], scratch, m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+    }
     NX_CRYPTO_HUGE_NUMBER_INITIALIZE_DIGIT(&digit, &digit_value, 1);
 
 
@@ -2663,60 +2874,85 @@ NX_CRYPTO_HUGE_NUMBER *operand, *temp_result, *temp_swap;
     val[m_len] = 1;
     _nx_crypto_huge_number_modulus(&temp, m);
 
-    /* xx = mont(x, radix ^ (2 * m_len) mod m)*/
+    /* table[0] = mont(x, radix ^ (2 * m_len) mod m)*/
     _nx_crypto_huge_number_square(&temp, result);
     _nx_crypto_huge_number_modulus(result, m);
-    _nx_crypto_huge_number_mont(m, mm_buffer[0], x, result, &xx);
-
-    /* result = x' */
-    NX_CRYPTO_HUGE_NUMBER_COPY(result, &temp);
+    _nx_crypto_huge_number_mont(m, mi, x, result, &table[0]);
 
-    /* Clear out the result since we need it to start with a simple value. */
-
-    operand = result;
-    temp_result = &temp;
+    /* Find the most significant set bit of the exponent. */
+    bit = e -> nx_crypto_huge_number_size * HN_SHIFT;
+    while ((bit > 0) && !HN_EXPONENT_BIT(e, bit - 1))
+    {
+        bit--;
+    }
 
-    exp_size = e -> nx_crypto_huge_number_size;
-    val = e -> nx_crypto_huge_number_data + (exp_size - 1);
+    /* Short exponents, such as public RSA exponents, do not pay back the table. */
+    window_limit = (bit > 64) ? NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS : 1;
 
-    /* Loop through the bits of the exponent. For each bit set, multiply the result by the running square. */
-    for (; (ULONG)val >= (ULONG)(e -> nx_crypto_huge_number_data); val--)
+    /* table[i] = table[0] ^ (2 * i + 1), the odd powers a window can select. */
+    if (window_limit > 1)
     {
-        /* Current byte in the exponent determines whether we multiply or not. */
-        cur_block = *val;
+        _nx_crypto_huge_number_mont_square(m, mi, &table[0], result);
+        for (i = 1; i < (1u << (window_limit - 1)); i++)
+        {
+            _nx_crypto_huge_number_mont(m, mi, &table[i - 1], result, &table[i]);
+        }
+    }
 
-        /* Loop over the bits in the current byte to see whether we add or not. */
-        for (bit = 0; bit < HN_SHIFT; bit++)
+    /* temp holds the running result. It starts as x', which is 1, and is
+       replaced by the first window rather than squared while it is 1. */
+    while (bit > 0)
+    {
+        if (!HN_EXPONENT_BIT(e, bit - 1))
+        {
+            window_bits = 1;
+            window = 0;
+        }
+        else
         {
 
-            /* A non-zero bit means we need to multiply. */
-            if (cur_block & (1u << (NX_CRYPTO_HUGE_NUMBER_BITS - (1 + bit))))
+            /* Take the longest window that ends in a set bit. */
+            window_bits = (bit < window_limit) ? bit : window_limit;
+            while (!HN_EXPONENT_BIT(e, bit - window_bits))
             {
-
-                /* result = mont(result, result) */
-                _nx_crypto_huge_number_mont(m, mm_buffer[0], operand, operand, temp_result);
-
-                /* result = mont(result, xx) */
-                _nx_crypto_huge_number_mont(m, mm_buffer[0], temp_result, &xx, operand);
+                window_bits--;
             }
-            else
+
+            window = 0;
+            for (i = 1; i <= window_bits; i++)
             {
+                window = (window << 1) | HN_EXPONENT_BIT(e, bit - i);
+            }
+        }
+        bit -= window_bits;
 
-                /* result = mont(result, result) */
-                _nx_crypto_huge_number_mont(m, mm_buffer[0], operand, operand, temp_result);
-                temp_swap = temp_result;
-                temp_result = operand;
-                operand = temp_swap;
+        if (!started)
+        {
+            if (window)
+            {
+                NX_CRYPTO_HUGE_NUMBER_COPY(&temp, &table[window >> 1]);
+                started = NX_CRYPTO_TRUE;
             }
+            continue;
+        }
+
+        /* temp = temp ^ (2 ^ window_bits) */
+        for (i = 0; i < window_bits; i++)
+        {
+            _nx_crypto_huge_number_mont_square(m, mi, &temp, result);
+            NX_CRYPTO_HUGE_NUMBER_COPY(&temp, result);
+        }
+
+        /* temp = temp * x ^ window */
+        if (window)
+        {
+            _nx_crypto_huge_number_mont(m, mi, &temp, &table[window >> 1], result);
+            NX_CRYPTO_HUGE_NUMBER_COPY(&temp, result);
         }
     }
 
     /* result = mont(result, 1) */
-    _nx_crypto_huge_number_mont(m, mm_buffer[0], &digit, operand, temp_result);
-    if (temp_result != result)
-    {
-        NX_CRYPTO_HUGE_NUMBER_COPY(result, &temp);
-    }
+    _nx_crypto_huge_number_mont(m, mi, &digit, &temp, result);
 }
 
 /**************************************************************************/
@@ -2740,7 +2976,9 @@ NX_CRYPTO_HUGE_NUMBER *operand, *temp_result, *temp_swap;
 /*      1. m = p * q                                                      */
 /*      2. p and q are primes                                             */
 /*      3. scratch is required to be no less than 4 times of buffer size  */
-/*    of m plus 24 bytes.                                                 */
+/*    of m plus 24 bytes, plus NX_CRYPTO_HUGE_NUMBER_WINDOW_SCRATCH_SIZE  */
+/*    of the buffer size of p for the window table of the exponentiation */
+/*    modulo p and q.                                                     */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -2852,7 +3090,7 @@ HN_UBASE               digit_value;
     /* m1 = xp ^ ep mod p */
     m1 = &temp1;
 
-    /* Buffer usage: 1 * buffer_size of m + 8 bytes */
+    /* Buffer usage: 1 * buffer_size of m + 8 bytes, plus the window table of p */
     _nx_crypto_huge_number_mont_power_modulus(xp, ep, p, m1, scratch);
 
     /* m1 * qi * q */
@@ -2876,7 +3114,7 @@ HN_UBASE               digit_value;
     /* m2 = xq ^ eq mod q */
     m2 = &temp1;
 
-    /* Buffer usage: 1 * buffer_size of m + 8 bytes */
+    /* Buffer usage: 1 * buffer_size of m + 8 bytes, plus the window table of q */
     _nx_crypto_huge_number_mont_power_modulus(xq, eq, q, m2, scratch);
 
     /* pi * p * m2 */
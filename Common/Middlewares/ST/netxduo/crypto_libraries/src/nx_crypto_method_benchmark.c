@@ -0,0 +1,1683 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Crypto Component                                                 */
+/**                                                                       */
+/**   Crypto Method Benchmark                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_CRYPTO_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+#include "nx_crypto_method_benchmark.h"
+#include "nx_crypto_ecdsa.h"
+#include "nx_crypto_ecdh.h"
+#include "nx_crypto_rsa.h"
+
+#ifdef NX_CRYPTO_ENABLE_BENCHMARK
+
+extern NX_CRYPTO_METHOD crypto_method_aes_cbc_128;
+extern NX_CRYPTO_METHOD crypto_method_aes_128_gcm_16;
+extern NX_CRYPTO_METHOD crypto_method_aes_256_gcm_16;
+extern NX_CRYPTO_METHOD crypto_method_sha256;
+extern NX_CRYPTO_METHOD crypto_method_hmac_sha256;
+extern NX_CRYPTO_METHOD crypto_method_ecdsa;
+extern NX_CRYPTO_METHOD crypto_method_ecdh;
+extern NX_CRYPTO_METHOD crypto_method_ec_secp256;
+extern NX_CRYPTO_METHOD crypto_method_ec_secp384;
+extern NX_CRYPTO_METHOD crypto_method_rsa;
+
+/* Size of the TLS record header authenticated as additional data.  */
+#define NX_CRYPTO_BENCHMARK_ADDITIONAL_DATA_SIZE    13
+
+/* Pattern used to paint the stack.  */
+#define NX_CRYPTO_BENCHMARK_STACK_PATTERN           0xA5
+
+/* Stack right below the caller that is left alone, it holds the frame of the
+   measurement itself.  */
+#define NX_CRYPTO_BENCHMARK_STACK_GUARD_SIZE        256
+
+/* Define one measurement: the crypto method, its handler and the buffers
+   each operation works on.  */
+typedef struct NX_CRYPTO_BENCHMARK_CASE_STRUCT
+{
+    NX_CRYPTO_METHOD *nx_crypto_benchmark_case_method;
+    NX_CRYPTO_METHOD *nx_crypto_benchmark_case_curve;
+    VOID             *nx_crypto_benchmark_case_handler;
+    UINT              nx_crypto_benchmark_case_operation;
+    UCHAR            *nx_crypto_benchmark_case_key;
+    UINT              nx_crypto_benchmark_case_key_size;
+    UCHAR            *nx_crypto_benchmark_case_input;
+    UINT              nx_crypto_benchmark_case_input_length;
+    UCHAR            *nx_crypto_benchmark_case_output;
+    UINT              nx_crypto_benchmark_case_output_length;
+    VOID             *nx_crypto_benchmark_case_metadata;
+    ULONG             nx_crypto_benchmark_case_metadata_size;
+} NX_CRYPTO_BENCHMARK_CASE;
+
+/* Data sizes of the cipher and hash measurements, from a small MQTT publish
+   to a full TLS record.  */
+static const UINT _nx_crypto_method_benchmark_data_size[] = {64, 256, 1024, 4096, 16384};
+
+static const CHAR *_nx_crypto_method_benchmark_operation_name[] =
+{
+    "unknown", "encrypt", "decrypt", "hash", "sign", "verify", "key_exchange", "public", "private"
+};
+
+static UCHAR _nx_crypto_method_benchmark_key[32] =
+{
+0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+};
+
+/* IV of the CBC methods.  */
+static UCHAR _nx_crypto_method_benchmark_iv[16] =
+{
+0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,
+};
+
+/* Nonce of the AEAD methods, the first byte is the length as NetX Secure
+   passes it.  */
+static UCHAR _nx_crypto_method_benchmark_nonce[13] =
+{
+0x0c, 0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88,
+};
+
+static UCHAR _nx_crypto_method_benchmark_additional_data[NX_CRYPTO_BENCHMARK_ADDITIONAL_DATA_SIZE];
+static UCHAR _nx_crypto_method_benchmark_tag[16];
+static UCHAR _nx_crypto_method_benchmark_input[NX_CRYPTO_BENCHMARK_MAX_DATA_SIZE];
+static UCHAR _nx_crypto_method_benchmark_output[NX_CRYPTO_BENCHMARK_MAX_DATA_SIZE];
+
+/* Key pair of a curve, as ECDH generates it: the private key and the
+   scratch of the generation have buffers of their own, sized like those of
+   NX_CRYPTO_ECDH, and the keys are extracted into the key pair buffer,
+   the private key then the uncompressed public key.  */
+static HN_UBASE _nx_crypto_method_benchmark_private_key[NX_CRYPTO_ECDH_MAX_KEY_SIZE >> HN_SIZE_SHIFT];
+static HN_UBASE _nx_crypto_method_benchmark_ec_scratch[NX_CRYPTO_ECDH_SCRATCH_BUFFER_SIZE >> HN_SIZE_SHIFT];
+static UCHAR _nx_crypto_method_benchmark_key_pair_buffer[3 * NX_CRYPTO_ECDH_MAX_KEY_SIZE + 4];
+
+/* RSA keys, the public exponent is 65537.  */
+static const UCHAR pub_e[] = {
+0x00, 0x01, 0x00, 0x01,
+};
+
+static const UCHAR m_2048[] = {
+0x91, 0xB5, 0x0F, 0x65, 0x53, 0x7E, 0xE7, 0x1B, 0xEC, 0x8A, 0x09, 0x30, 0xF9, 0x98, 0xA2, 0x3E,
+0xE7, 0x9C, 0xEF, 0xB9, 0xDD, 0x7A, 0x18, 0x99, 0xE6, 0x03, 0xC3, 0xD1, 0xA5, 0xA7, 0xC4, 0x36,
+0xEA, 0x5F, 0x8B, 0x61, 0x6B, 0xAD, 0x26, 0xC4, 0x1F, 0x0D, 0x49, 0x29, 0x6D, 0xE3, 0x17, 0x30,
+0x34, 0x61, 0x68, 0x46, 0xC5, 0x6A, 0xA7, 0xF6, 0x63, 0xF6, 0xBF, 0x9F, 0x64, 0x29, 0x7D, 0x08,
+0xBA, 0x54, 0xA0, 0x4A, 0x17, 0x16, 0x7C, 0x7C, 0xB0, 0xC5, 0x16, 0xD7, 0xAE, 0xAD, 0x5B, 0x10,
+0x8F, 0x1E, 0x3C, 0xD0, 0x10, 0x0B, 0x14, 0x6C, 0xB6, 0xE0, 0xD8, 0xFF, 0x1C, 0x31, 0x0D, 0x64,
+0x43, 0x57, 0xE7, 0x98, 0x16, 0xC2, 0x7D, 0x40, 0x03, 0x73, 0xDB, 0x3D, 0xE1, 0xFD, 0x53, 0x2A,
+0x55, 0xE0, 0xD3, 0x96, 0x3C, 0xAC, 0x61, 0x9A, 0xE9, 0xD1, 0x63, 0xA3, 0x7D, 0x6A, 0x3D, 0x78,
+0xC1, 0x56, 0x11, 0xF5, 0xA7, 0x70, 0x79, 0x83, 0xCD, 0xD1, 0x36, 0x0E, 0xBB, 0x98, 0xC9, 0x05,
+0xF0, 0xA2, 0xBE, 0x97, 0x33, 0x22, 0xA7, 0xC7, 0x54, 0xEA, 0x05, 0x70, 0x93, 0xD9, 0x4E, 0x95,
+0x41, 0x11, 0xBD, 0xDA, 0x2F, 0x67, 0x93, 0x0A, 0xE1, 0x23, 0x46, 0xA3, 0x26, 0x60, 0xF6, 0x71,
+0xC0, 0xA6, 0x35, 0xEA, 0x18, 0xA4, 0x4D, 0x7F, 0x68, 0xEA, 0x16, 0xBF, 0x10, 0xAA, 0xF7, 0xF5,
+0x16, 0xA5, 0x33, 0x12, 0xBF, 0x47, 0x06, 0x75, 0xFB, 0xCD, 0xDE, 0xAD, 0x13, 0x41, 0xF4, 0x36,
+0x46, 0x6E, 0x16, 0xA9, 0x97, 0xEB, 0x5C, 0x2D, 0x15, 0x7D, 0xA5, 0xA3, 0x40, 0x19, 0x0B, 0xBC,
+0x47, 0x3F, 0x84, 0xDC, 0xBE, 0xC6, 0x69, 0xFD, 0xA1, 0x7B, 0x33, 0xB4, 0xE5, 0xB5, 0x95, 0xD0,
+0x75, 0xDF, 0x3C, 0x29, 0xE9, 0x25, 0x81, 0xB8, 0xE1, 0x05, 0x97, 0x46, 0x5E, 0xB5, 0x31, 0x5B,
+};
+
+static const UCHAR pri_e_2048[] = {
+0x2D, 0xEA, 0x03, 0xB1, 0x76, 0xC7, 0xA0, 0xF4, 0xEC, 0x2B, 0x2D, 0x2D, 0x49, 0x21, 0x9F, 0x52,
+0xBA, 0x32, 0x7A, 0x5A, 0x33, 0xDF, 0xD3, 0x1B, 0xBF, 0xDF, 0x04, 0xD8, 0x2D, 0xDE, 0xB9, 0x56,
+0x62, 0xB1, 0x7B, 0xDE, 0xD5, 0x8A, 0xE9, 0x11, 0xD9, 0x05, 0x1B, 0x3E, 0x5A, 0x59, 0xBA, 0x87,
+0x5E, 0xA2, 0x29, 0x35, 0x4F, 0xE5, 0x45, 0x8B, 0x3F, 0x41, 0xD4, 0x6D, 0x5A, 0x27, 0x36, 0xB6,
+0xC6, 0xDC, 0x7E, 0xEC, 0x09, 0xED, 0x74, 0x89, 0xE8, 0x3C, 0x1A, 0xF0, 0x19, 0x23, 0x98, 0x74,
+0x15, 0xDD, 0x3D, 0xE5, 0x84, 0x80, 0xB1, 0x4D, 0x76, 0xAD, 0x50, 0xC3, 0xC6, 0xF2, 0xF0, 0x18,
+0xDD, 0x9D, 0xB8, 0x25, 0x75, 0x5A, 0x91, 0x14, 0x58, 0x62, 0x2C, 0x3E, 0x8A, 0x55, 0x84, 0xDC,
+0xEC, 0xD5, 0xDD, 0x66, 0xD4, 0xB4, 0xAF, 0x47, 0x1D, 0x11, 0xF5, 0xD7, 0x61, 0x60, 0x56, 0x81,
+0x1A, 0x74, 0xDF, 0x1E, 0x89, 0x46, 0xCE, 0xAD, 0xF9, 0x1F, 0x69, 0xB0, 0x91, 0x59, 0xEF, 0x3F,
+0xB5, 0x76, 0x69, 0xDA, 0x62, 0xA6, 0x73, 0x70, 0xD3, 0x05, 0xCA, 0xAF, 0x3A, 0xFD, 0x68, 0x52,
+0xBF, 0xBE, 0xD7, 0x07, 0x76, 0x84, 0x96, 0xCC, 0x94, 0x0E, 0xA9, 0xE5, 0x66, 0xFE, 0x5A, 0x74,
+0x35, 0xD6, 0xEE, 0x51, 0x3A, 0xA5, 0xB2, 0x41, 0xE4, 0xA6, 0x33, 0x94, 0x9F, 0xCE, 0x83, 0xFA,
+0x43, 0x3F, 0x10, 0xCF, 0x40, 0x20, 0x03, 0xD5, 0x98, 0x8E, 0x98, 0x2F, 0xBA, 0x4E, 0x42, 0x9D,
+0xFD, 0x29, 0xA7, 0xE4, 0xC5, 0xEB, 0x21, 0x6D, 0x1F, 0x78, 0xEC, 0xD1, 0x10, 0x21, 0x24, 0x39,
+0x57, 0xF9, 0x3A, 0xC2, 0x87, 0xEE, 0x0D, 0xEC, 0x1E, 0x57, 0x54, 0xB4, 0xD9, 0x1B, 0xFA, 0x09,
+0x48, 0xD9, 0x25, 0x71, 0xFC, 0x2F, 0x3E, 0x1A, 0x58, 0x8E, 0x14, 0x7A, 0x0D, 0x19, 0x5A, 0x69,
+};
+
+static const UCHAR p_2048[] = {
+0xCA, 0x62, 0x55, 0xF9, 0xEA, 0x3A, 0x15, 0xDF, 0x1A, 0xD6, 0xEA, 0x48, 0x00, 0x14, 0x2B, 0x06,
+0x47, 0xD1, 0x61, 0xDD, 0x86, 0x78, 0x1B, 0x7B, 0x52, 0x86, 0x6D, 0xC2, 0x32, 0xB4, 0x0F, 0x02,
+0xE5, 0x54, 0x65, 0xFE, 0x95, 0xCF, 0xBB, 0x38, 0x2E, 0xF0, 0x20, 0xEB, 0xA9, 0x6A, 0x1F, 0xB5,
+0x85, 0x9B, 0x7B, 0x72, 0x1E, 0x00, 0xA8, 0x94, 0x1F, 0x9A, 0x9F, 0xB6, 0x18, 0xED, 0xD4, 0x04,
+0x29, 0x69, 0xDA, 0x67, 0xE9, 0xDB, 0xF2, 0x0F, 0x30, 0xEB, 0x11, 0x7D, 0xA2, 0x7C, 0xD3, 0xF0,
+0x46, 0x67, 0x31, 0xD1, 0xD4, 0x01, 0x94, 0xD2, 0x85, 0x2D, 0x27, 0xD4, 0xB3, 0xEC, 0x3D, 0xA7,
+0x42, 0x1D, 0x0A, 0xFB, 0xAE, 0x73, 0xFE, 0x7A, 0x4E, 0xA8, 0x56, 0xB7, 0x39, 0xB6, 0xE8, 0xE3,
+0x9F, 0xBB, 0x91, 0x55, 0x8E, 0x27, 0xC7, 0xB5, 0xFD, 0x69, 0x93, 0x3B, 0xAA, 0x90, 0x61, 0x19,
+};
+
+static const UCHAR q_2048[] = {
+0xB8, 0x4E, 0xE8, 0x49, 0xDA, 0xE2, 0x7A, 0xDD, 0x38, 0xD6, 0xE5, 0x11, 0x60, 0x2B, 0xA2, 0xD4,
+0xD7, 0x22, 0x7A, 0x9F, 0x07, 0x60, 0x9C, 0x1C, 0x6D, 0x4F, 0x9B, 0x76, 0x34, 0x36, 0xBA, 0xB1,
+0xE9, 0x7A, 0x02, 0x86, 0x5C, 0xF8, 0x0A, 0x2F, 0xCB, 0x15, 0x08, 0x06, 0xEC, 0xA0, 0x3E, 0xEF,
+0xD8, 0x41, 0x40, 0x48, 0x99, 0xEB, 0x3A, 0x2B, 0x0C, 0x1F, 0x22, 0xB4, 0xB4, 0xBC, 0x54, 0xC4,
+0x2A, 0xDE, 0x29, 0xD9, 0x63, 0x6D, 0x00, 0x69, 0x4A, 0xAD, 0x0A, 0xDA, 0x35, 0xE8, 0x27, 0x08,
+0x50, 0x2C, 0x37, 0xD9, 0x3F, 0xBB, 0xD8, 0xB7, 0xBA, 0x84, 0x44, 0x49, 0xE3, 0xEE, 0x6C, 0x48,
+0x53, 0x51, 0x0A, 0x1C, 0xA1, 0x9D, 0xDF, 0x09, 0x83, 0xE8, 0x33, 0xE4, 0x67, 0x8D, 0x29, 0x67,
+0x8C, 0x3F, 0x18, 0xB0, 0x6C, 0x67, 0xAA, 0xC8, 0x0E, 0x07, 0xB6, 0xA9, 0xC3, 0xB6, 0xF0, 0x93,
+};
+
+static const UCHAR m_4096[] = {
+0xE4, 0xB7, 0x4D, 0xA9, 0x35, 0x5B, 0x92, 0xF3, 0x64, 0x25, 0x28, 0xD3, 0x02, 0x66, 0x92, 0x0C,
+0xD5, 0x86, 0x4D, 0x76, 0xD5, 0x1D, 0xDC, 0x08, 0xE6, 0x4B, 0xFD, 0x55, 0x68, 0x24, 0x09, 0x3E,
+0x5A, 0xB6, 0xAF, 0xC0, 0x34, 0x28, 0x35, 0xA3, 0x42, 0x40, 0x79, 0xA3, 0xF8, 0x4D, 0x49, 0x64,
+0x31, 0x2F, 0xCA, 0x04, 0xC8, 0x0C, 0x8F, 0xCE, 0x07, 0xA2, 0x24, 0xFC, 0x66, 0xD2, 0x57, 0x04,
+0xF1, 0x96, 0xEF, 0x39, 0x9C, 0x3E, 0x81, 0x04, 0x58, 0x41, 0xE2, 0x0E, 0xDD, 0xB8, 0x2B, 0x4D,
+0x56, 0xA4, 0x18, 0x5B, 0x1C, 0x36, 0x3B, 0x43, 0x40, 0xCC, 0x24, 0x27, 0x13, 0x8A, 0x9C, 0xC8,
+0xD5, 0x5F, 0xFA, 0x66, 0xAA, 0x89, 0x60, 0x67, 0xB1, 0xB3, 0xFE, 0x74, 0x00, 0xCD, 0x1F, 0x69,
+0xC7, 0xEE, 0x4B, 0xB1, 0xA9, 0x12, 0x0C, 0xE0, 0xC4, 0xF7, 0x7B, 0xAF, 0x70, 0x08, 0x34, 0x45,
+0x46, 0x56, 0xF3, 0xB4, 0xAB, 0xEE, 0x0F, 0x0F, 0x8E, 0x64, 0xBC, 0x1D, 0x4C, 0x57, 0xFA, 0xC3,
+0x29, 0x0D, 0x5D, 0x34, 0x76, 0x2B, 0xA7, 0xFF, 0xC3, 0x94, 0xBE, 0x02, 0x06, 0x8E, 0x34, 0x7E,
+0x0A, 0x41, 0x62, 0x91, 0x9C, 0x5A, 0x11, 0xDB, 0xBD, 0x40, 0x10, 0x14, 0xF9, 0xA2, 0x15, 0x12,
+0x6F, 0xD8, 0xB4, 0xFC, 0x3D, 0x98, 0x2D, 0xE9, 0x40, 0xCD, 0x11, 0x48, 0x35, 0x7D, 0xBA, 0x43,
+0x32, 0xB6, 0x82, 0xC5, 0x65, 0x41, 0x81, 0x88, 0xF5, 0x8C, 0x0B, 0xFD, 0x9C, 0xA0, 0xDE, 0x42,
+0xC0, 0x3A, 0x40, 0x9A, 0xFC, 0x1C, 0x70, 0xB0, 0x1A, 0x9B, 0xBE, 0xCB, 0x4C, 0xF1, 0x2D, 0x70,
+0xAE, 0xAE, 0x70, 0x03, 0xA9, 0xCA, 0x93, 0xE7, 0xBF, 0xBF, 0x71, 0x95, 0x2E, 0x89, 0x26, 0x17,
+0xAE, 0xF3, 0xA3, 0x0B, 0xB0, 0x14, 0xE8, 0x45, 0xE9, 0x21, 0x55, 0xEB, 0xBC, 0x65, 0x12, 0xB3,
+0x04, 0x75, 0xEC, 0x8D, 0xC5, 0xEC, 0x64, 0xC3, 0x55, 0x0F, 0x50, 0xEC, 0xFC, 0xBF, 0xFC, 0x0A,
+0x51, 0x94, 0x7E, 0xC2, 0xD2, 0x11, 0x27, 0x94, 0xCC, 0x03, 0xCB, 0x38, 0xDF, 0x24, 0x37, 0xB7,
+0x93, 0x76, 0x56, 0x16, 0xEA, 0x2C, 0x5D, 0x70, 0xFF, 0x73, 0x05, 0x94, 0x59, 0x24, 0x71, 0x4C,
+0x49, 0xF4, 0x32, 0x55, 0x85, 0x28, 0x92, 0xB0, 0xA5, 0x81, 0x59, 0x03, 0x3D, 0x54, 0x12, 0x3F,
+0x60, 0xE6, 0x7B, 0x51, 0x32, 0x9D, 0x69, 0x6A, 0xEE, 0x7A, 0x2B, 0xEF, 0x28, 0x45, 0x8A, 0x70,
+0x0C, 0xAB, 0xA0, 0xA3, 0x7A, 0x02, 0xEB, 0x94, 0x31, 0x84, 0x54, 0xBB, 0x9C, 0x6A, 0x3A, 0x7A,
+0x21, 0x39, 0xBA, 0xA9, 0xA6, 0x09, 0xB1, 0x94, 0x13, 0x3D, 0x4E, 0xED, 0xDE, 0x23, 0xBB, 0x4C,
+0x83, 0x30, 0x74, 0x6F, 0x54, 0xF6, 0xEE, 0x8B, 0x35, 0x31, 0xA6, 0x3B, 0x3F, 0xCE, 0xE2, 0xB0,
+0x34, 0x30, 0xBC, 0x7A, 0x04, 0x7F, 0xA6, 0x66, 0xFE, 0xFB, 0xB3, 0xE0, 0x50, 0x6A, 0xCA, 0xB6,
+0x29, 0xAC, 0xF6, 0x4A, 0x14, 0xF1, 0x05, 0xF6, 0x1E, 0xB4, 0xBE, 0x72, 0xC3, 0x0F, 0xE1, 0xFA,
+0xAB, 0x92, 0x5F, 0xED, 0x9D, 0x07, 0xB0, 0x34, 0x45, 0x4E, 0xF0, 0xDE, 0xBB, 0x2D, 0xC1, 0x61,
+0xC8, 0x8C, 0xD9, 0xCC, 0x18, 0x4E, 0xA0, 0x78, 0x81, 0xFA, 0x76, 0x52, 0x0D, 0x75, 0x4A, 0xDC,
+0x51, 0xCA, 0x9E, 0x71, 0xAF, 0x8E, 0x00, 0x37, 0x28, 0xF7, 0xF9, 0x12, 0x9E, 0xC8, 0x1E, 0xB2,
+0xAF, 0x40, 0x42, 0xE4, 0x16, 0x59, 0xA0, 0xA6, 0xE2, 0x5D, 0x10, 0xA2, 0x82, 0x8C, 0x59, 0xA4,
+0xD7, 0x51, 0x27, 0xC1, 0x96, 0x59, 0xFF, 0x7C, 0xDC, 0x6C, 0x48, 0x64, 0xF0, 0x4D, 0x5C, 0xB9,
+0x3A, 0xF8, 0xA0, 0x91, 0x5C, 0xEB, 0x1E, 0x4F, 0x39, 0xCC, 0xE9, 0x2A, 0x58, 0xD2, 0xE4, 0x1B,
+};
+
+static const UCHAR pri_e_4096[] = {
+0x1C, 0x54, 0xB0, 0x64, 0x03, 0x5E, 0x02, 0x87, 0xEF, 0xA1, 0xC2, 0xBA, 0xD0, 0x93, 0x50, 0x08,
+0x12, 0xF2, 0xFD, 0xE9, 0x78, 0x60, 0xA8, 0x7E, 0xD9, 0xB8, 0x13, 0xFB, 0x5E, 0x59, 0x08, 0x64,
+0x16, 0xEC, 0x86, 0x3C, 0xB2, 0xB9, 0x40, 0x5B, 0xA6, 0xBB, 0x41, 0xD6, 0x13, 0xCD, 0xCF, 0x07,
+0x80, 0x28, 0x41, 0x47, 0xF2, 0x57, 0xCC, 0x00, 0x63, 0x65, 0xAC, 0x5B, 0x2F, 0x89, 0x62, 0x8A,
+0x14, 0x3A, 0xF4, 0x0B, 0x18, 0xD5, 0x8D, 0x39, 0xB2, 0x8D, 0x06, 0xA9, 0x7C, 0xC1, 0x71, 0x6B,
+0xB5, 0x0D, 0xC2, 0x8E, 0x96, 0xA2, 0x09, 0x19, 0x3D, 0x8F, 0x8B, 0xF2, 0xE3, 0x32, 0xCA, 0x54,
+0xFE, 0x49, 0x53, 0x45, 0x20, 0x5E, 0xBF, 0xF8, 0x58, 0x44, 0xC9, 0x82, 0x29, 0x0F, 0x3F, 0x92,
+0xE4, 0xD7, 0x19, 0xBD, 0x3A, 0x0A, 0x28, 0x5A, 0x37, 0x4B, 0xC8, 0xA0, 0x64, 0xAA, 0x3F, 0x7F,
+0x4D, 0x45, 0x3C, 0x0E, 0xE7, 0x35, 0x27, 0xDC, 0x6F, 0x70, 0xFE, 0xF4, 0x4A, 0x1E, 0xA3, 0xCB,
+0x44, 0xEC, 0x88, 0xDD, 0x14, 0xBE, 0x37, 0xA3, 0x30, 0xE0, 0xDD, 0xE0, 0x76, 0x5B, 0x6B, 0x19,
+0x29, 0xC0, 0x0B, 0xAB, 0xA9, 0xC8, 0x66, 0x69, 0xE7, 0xB9, 0x65, 0xC4, 0x93, 0x5F, 0x86, 0x68,
+0xB0, 0x3E, 0x11, 0xBD, 0x25, 0x0C, 0x12, 0xB3, 0xCF, 0xF9, 0x16, 0xE8, 0xF0, 0xE7, 0x50, 0x09,
+0x3E, 0xE0, 0xE8, 0xB5, 0xF6, 0xE2, 0xF4, 0x5E, 0xB8, 0xBB, 0xCE, 0x48, 0x6D, 0xFC, 0x67, 0x4B,
+0xB1, 0x70, 0x05, 0xCC, 0xAC, 0xEA, 0x00, 0xF3, 0x6F, 0x78, 0x57, 0x5B, 0xEB, 0x7D, 0xFC, 0x78,
+0xF6, 0xCA, 0x58, 0xC9, 0xBB, 0x60, 0x82, 0x8D, 0xB4, 0x6C, 0xCC, 0x6F, 0x04, 0x42, 0xAC, 0xDB,
+0x46, 0x2A, 0x9B, 0xC9, 0xB8, 0xD7, 0xFE, 0x25, 0x9A, 0xC9, 0x2C, 0x51, 0x75, 0x16, 0xB8, 0x08,
+0x04, 0xD3, 0x5D, 0x76, 0x81, 0x46, 0x8C, 0xB7, 0x8C, 0x20, 0x88, 0x8C, 0xC6, 0x3D, 0x2C, 0x24,
+0xCF, 0xBC, 0x95, 0xB4, 0x67, 0xAC, 0x5F, 0xFD, 0x3F, 0x63, 0x28, 0xA1, 0xDF, 0xE9, 0xE1, 0xEE,
+0x84, 0x3F, 0x57, 0xB0, 0xC7, 0xDD, 0xE4, 0x4F, 0xC9, 0x68, 0x6F, 0x83, 0x46, 0x2A, 0x00, 0x3B,
+0x01, 0x2E, 0x1B, 0x47, 0xA0, 0x3F, 0xA7, 0x47, 0x02, 0xCF, 0xEB, 0xAA, 0x9B, 0x88, 0x25, 0xCE,
+0x15, 0xCD, 0xE0, 0xE6, 0x65, 0x9B, 0xA3, 0xDB, 0xE9, 0x1C, 0x34, 0xE2, 0xE5, 0x5A, 0xD3, 0x82,
+0xA7, 0x33, 0x33, 0x0C, 0x02, 0x5D, 0x09, 0x28, 0xBB, 0xEA, 0x6A, 0xB9, 0x98, 0x94, 0xBF, 0x8D,
+0xFF, 0x15, 0x74, 0xD4, 0x07, 0xBE, 0xAA, 0xA1, 0x58, 0x3A, 0xD1, 0x40, 0x17, 0xE7, 0x47, 0x2E,
+0x69, 0xA3, 0x4F, 0xC3, 0x4D, 0x9C, 0x54, 0x9F, 0x51, 0x19, 0xD7, 0xE9, 0x13, 0x77, 0x1A, 0xCB,
+0x66, 0xC1, 0xA2, 0x93, 0x05, 0xBC, 0x20, 0x68, 0x14, 0x3B, 0xBF, 0x8F, 0x7A, 0x24, 0xA8, 0x77,
+0xDC, 0x22, 0x62, 0xD5, 0x09, 0x52, 0xB9, 0xBB, 0xE4, 0x30, 0xBD, 0xB7, 0xC4, 0xFE, 0x03, 0xBF,
+0x56, 0xFB, 0xA8, 0xCA, 0x04, 0x00, 0x48, 0x4E, 0xC6, 0x6A, 0xDB, 0x58, 0x18, 0x56, 0xC2, 0x61,
+0xF4, 0x6A, 0xC3, 0xFA, 0xA0, 0x9F, 0x9C, 0xE5, 0x29, 0x04, 0xE5, 0xBF, 0xA8, 0x8A, 0xB5, 0x61,
+0xF5, 0x81, 0xBE, 0xB0, 0xEB, 0xF8, 0x38, 0x29, 0xDB, 0xF4, 0xCD, 0xB3, 0xDF, 0xE1, 0xB8, 0xE7,
+0x30, 0x5B, 0x65, 0xD0, 0xEA, 0x82, 0x6D, 0x14, 0xA6, 0x8B, 0xBA, 0xF8, 0xD6, 0x42, 0x32, 0x7B,
+0x2D, 0xDB, 0x7B, 0x06, 0x27, 0x4C, 0x5C, 0x16, 0xC6, 0xE8, 0x08, 0x88, 0x6D, 0x60, 0x40, 0x32,
+0x6E, 0x0C, 0xFF, 0xA9, 0xD9, 0xB2, 0xAB, 0x04, 0xB0, 0x7A, 0x67, 0x78, 0x5C, 0x36, 0x6F, 0xC1,
+};
+
+static const UCHAR p_4096[] = {
+0xF5, 0x88, 0xC3, 0x1E, 0x18, 0x87, 0x55, 0x05, 0x96, 0xD2, 0x16, 0x7A, 0xB0, 0xDA, 0xCE, 0x71,
+0xE9, 0x9E, 0xA8, 0x73, 0xD8, 0xD1, 0xBC, 0xD2, 0x7F, 0x12, 0xE2, 0x40, 0x3F, 0x41, 0x85, 0x94,
+0x6D, 0x58, 0x1C, 0x9C, 0x79, 0x72, 0x3F, 0x29, 0x97, 0xBD, 0x74, 0x23, 0xBC, 0x21, 0xC8, 0x78,
+0x51, 0xF5, 0x20, 0x8D, 0x5B, 0x31, 0x34, 0xAF, 0xA1, 0x85, 0xE5, 0xDE, 0x4B, 0x73, 0x27, 0xA4,
+0x9D, 0xEB, 0xF6, 0x7B, 0xED, 0x94, 0xB3, 0x9F, 0x79, 0xCE, 0xB6, 0x18, 0x98, 0x67, 0xB6, 0xF2,
+0x0D, 0x1D, 0x46, 0x5C, 0x2A, 0xE1, 0x08, 0x48, 0x70, 0x04, 0x35, 0x0C, 0x3B, 0xEB, 0x8A, 0xF3,
+0x83, 0xEF, 0xD9, 0x06, 0xE8, 0x6E, 0xEA, 0x90, 0x54, 0xB0, 0x44, 0x81, 0x32, 0x59, 0xFD, 0x86,
+0xCF, 0xC4, 0x8A, 0xED, 0x57, 0x23, 0x43, 0xD7, 0xD0, 0xA0, 0x51, 0xC9, 0x5E, 0x6B, 0x4F, 0x27,
+0xBA, 0x45, 0x77, 0x3C, 0x9E, 0x93, 0xD5, 0xBE, 0x87, 0x7B, 0x99, 0xD0, 0xD2, 0xDE, 0xCE, 0xAD,
+0x90, 0x87, 0xAE, 0x5F, 0x0F, 0x89, 0x39, 0xD3, 0xAD, 0xD7, 0xE6, 0xC1, 0x75, 0x6C, 0x4C, 0xBF,
+0xFE, 0xBA, 0x29, 0x7D, 0x4C, 0x06, 0x6D, 0x5B, 0x4A, 0xDB, 0x80, 0xE1, 0xAA, 0xAA, 0x8F, 0x72,
+0xA8, 0x12, 0x2B, 0x62, 0x01, 0x96, 0x9F, 0x4D, 0xC5, 0xC9, 0x32, 0x3D, 0xEB, 0xF2, 0x96, 0x5A,
+0xC7, 0x15, 0x2E, 0x4A, 0xEA, 0x52, 0xFB, 0xA4, 0x92, 0xC3, 0xED, 0xBE, 0xE0, 0x62, 0x82, 0x3E,
+0x56, 0x8C, 0xEA, 0xE2, 0xB3, 0xF1, 0x1F, 0x91, 0x8A, 0xDC, 0xDF, 0x3E, 0x2B, 0xCE, 0x57, 0x36,
+0xCD, 0x18, 0x4D, 0x63, 0x24, 0x34, 0xD2, 0xD7, 0x87, 0xFB, 0x08, 0x1C, 0x8A, 0xB8, 0xC1, 0xD5,
+0xE3, 0xF3, 0x61, 0xE4, 0xA7, 0x3C, 0x96, 0x74, 0xC6, 0x97, 0x21, 0x9B, 0xEF, 0xFD, 0xAC, 0xEB,
+};
+
+static const UCHAR q_4096[] = {
+0xEE, 0x77, 0x05, 0xEE, 0x9D, 0x06, 0xC5, 0xC1, 0xE1, 0x0D, 0x15, 0xB2, 0xDA, 0xE0, 0x3F, 0x21,
+0x14, 0xFA, 0xC6, 0x31, 0xCA, 0xBD, 0xA1, 0x53, 0x81, 0xB7, 0xB4, 0x87, 0x14, 0xF3, 0x59, 0xE3,
+0xE2, 0x62, 0xB8, 0x5E, 0xE4, 0x90, 0x9C, 0xDE, 0xB7, 0xDD, 0x25, 0x99, 0x8E, 0x46, 0x62, 0x48,
+0xCA, 0xDD, 0xD1, 0x34, 0xF9, 0x5C, 0xBC, 0x35, 0x8C, 0xC0, 0x46, 0x79, 0x6B, 0xA4, 0x74, 0x16,
+0xD5, 0x04, 0x86, 0x56, 0x8B, 0xEC, 0x58, 0x77, 0x3A, 0x23, 0x2A, 0xAF, 0xF4, 0xA9, 0x22, 0xB9,
+0x63, 0x35, 0xFB, 0xF3, 0x82, 0x0F, 0x4C, 0x20, 0x03, 0xC0, 0x1E, 0x8C, 0xA5, 0xBC, 0x0C, 0x57,
+0x4A, 0xBF, 0x62, 0x0F, 0xD5, 0x4B, 0xFD, 0xD2, 0x65, 0x8D, 0xF0, 0xA9, 0xCF, 0xF2, 0x63, 0x16,
+0x77, 0xA3, 0xDF, 0xB6, 0x6C, 0x15, 0x91, 0x3B, 0x51, 0x1B, 0x0A, 0xD0, 0x40, 0x9E, 0x59, 0x5D,
+0xEB, 0x18, 0xB3, 0xA7, 0x78, 0xBE, 0x25, 0xEB, 0xFE, 0x89, 0xC2, 0x0A, 0x23, 0x8A, 0xC4, 0x53,
+0xA1, 0xD7, 0x6C, 0x23, 0x66, 0x8A, 0x53, 0x86, 0x99, 0x14, 0xC9, 0xCD, 0x18, 0x39, 0xCA, 0xAB,
+0x6B, 0xB9, 0xA1, 0x8A, 0x97, 0x71, 0xC4, 0x8C, 0x73, 0xAE, 0xBB, 0x02, 0xF0, 0xA2, 0xA4, 0xE3,
+0x3E, 0x9A, 0x95, 0x04, 0x36, 0x4F, 0x22, 0x81, 0xA5, 0xDD, 0x2B, 0x76, 0xC3, 0x45, 0xD8, 0x5F,
+0x24, 0x0A, 0x63, 0x03, 0x0D, 0x58, 0xA8, 0x0B, 0xFD, 0xFE, 0xC2, 0xD6, 0xB0, 0x88, 0xC7, 0x80,
+0x9A, 0xF7, 0xE5, 0x25, 0x42, 0xC4, 0x99, 0x54, 0xCD, 0x3D, 0x6A, 0xD4, 0xA0, 0x90, 0x73, 0x27,
+0xB4, 0xDE, 0x31, 0xAB, 0x41, 0x2F, 0xDA, 0x3D, 0xAC, 0xC7, 0x0B, 0x29, 0xDF, 0xB9, 0xA3, 0xF2,
+0xD8, 0xE6, 0x29, 0x13, 0xF9, 0x97, 0x6C, 0xB0, 0xC6, 0xDE, 0x7E, 0x1E, 0x78, 0x83, 0x19, 0x91,
+};
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_measure                 PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function repeats one operation until the benchmark duration    */
+/*    has elapsed, measures the stack used by the first operation and     */
+/*    reports the result.                                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    benchmark                             Pointer to benchmark control  */
+/*    test_case                             Pointer to measurement        */
+/*    operation                             Operation to measure          */
+/*    result                                Pointer to result             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_method_benchmark_measure(NX_CRYPTO_BENCHMARK *benchmark,
+                                                NX_CRYPTO_BENCHMARK_CASE *test_case,
+                                                UINT (*operation)(NX_CRYPTO_BENCHMARK_CASE *),
+                                                NX_CRYPTO_BENCHMARK_RESULT *result)
+{
+UINT            status;
+ULONG           start;
+ULONG           ticks;
+ULONG           count;
+#if NX_CRYPTO_BENCHMARK_STACK_PROBE_SIZE
+volatile UCHAR *volatile stack_top;
+volatile UCHAR *stack_ptr;
+#endif /* NX_CRYPTO_BENCHMARK_STACK_PROBE_SIZE */
+
+    result -> nx_crypto_benchmark_result_operation = test_case -> nx_crypto_benchmark_case_operation;
+    result -> nx_crypto_benchmark_result_metadata_size = test_case -> nx_crypto_benchmark_case_method -> nx_crypto_metadata_area_size;
+    result -> nx_crypto_benchmark_result_count = 0;
+    result -> nx_crypto_benchmark_result_ticks = 0;
+    result -> nx_crypto_benchmark_result_ops_per_second = 0;
+    result -> nx_crypto_benchmark_result_bytes_per_second = 0;
+    result -> nx_crypto_benchmark_result_ticks_per_operation = 0;
+    result -> nx_crypto_benchmark_result_stack_size = 0;
+
+#if NX_CRYPTO_BENCHMARK_STACK_PROBE_SIZE
+
+    /* Paint the free stack below this frame.  */
+    stack_top = (volatile UCHAR *)&status;
+    stack_top -= NX_CRYPTO_BENCHMARK_STACK_GUARD_SIZE;
+    for (stack_ptr = stack_top - NX_CRYPTO_BENCHMARK_STACK_PROBE_SIZE; stack_ptr < stack_top; stack_ptr++)
+    {
+        *stack_ptr = NX_CRYPTO_BENCHMARK_STACK_PATTERN;
+    }
+#endif /* NX_CRYPTO_BENCHMARK_STACK_PROBE_SIZE */
+
+    /* The first operation warms up the method and is not timed.  */
+    status = operation(test_case);
+
+#if NX_CRYPTO_BENCHMARK_STACK_PROBE_SIZE
+
+    /* Find the deepest byte the operation has written.  */
+    for (stack_ptr = stack_top - NX_CRYPTO_BENCHMARK_STACK_PROBE_SIZE; stack_ptr < stack_top; stack_ptr++)
+    {
+        if (*stack_ptr != NX_CRYPTO_BENCHMARK_STACK_PATTERN)
+        {
+            break;
+        }
+    }
+    result -> nx_crypto_benchmark_result_stack_size = (ULONG)(stack_top - stack_ptr) + NX_CRYPTO_BENCHMARK_STACK_GUARD_SIZE;
+#endif /* NX_CRYPTO_BENCHMARK_STACK_PROBE_SIZE */
+
+    count = 0;
+    ticks = 0;
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        start = benchmark -> nx_crypto_benchmark_clock();
+        do
+        {
+            status = operation(test_case);
+            count++;
+
+            /* Unsigned subtraction handles a wrap of the clock.  */
+            ticks = benchmark -> nx_crypto_benchmark_clock() - start;
+        } while ((status == NX_CRYPTO_SUCCESS) && (ticks < benchmark -> nx_crypto_benchmark_duration));
+    }
+
+    result -> nx_crypto_benchmark_result_status = status;
+    result -> nx_crypto_benchmark_result_count = count;
+    result -> nx_crypto_benchmark_result_ticks = ticks;
+    if ((status == NX_CRYPTO_SUCCESS) && (ticks != 0))
+    {
+        result -> nx_crypto_benchmark_result_ops_per_second =
+            (ULONG)(((ULONG64)count * benchmark -> nx_crypto_benchmark_clock_rate) / ticks);
+        result -> nx_crypto_benchmark_result_bytes_per_second =
+            (ULONG)(((ULONG64)count * result -> nx_crypto_benchmark_result_data_size *
+                     benchmark -> nx_crypto_benchmark_clock_rate) / ticks);
+        result -> nx_crypto_benchmark_result_ticks_per_operation = ticks / count;
+    }
+
+    if (benchmark -> nx_crypto_benchmark_report)
+    {
+        benchmark -> nx_crypto_benchmark_report(result, benchmark -> nx_crypto_benchmark_report_context);
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_cipher_operation        PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts or decrypts one record with the initialize,  */
+/*    update and calculate operations NetX Secure uses for TLS records.   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    test_case                             Pointer to measurement        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_method_benchmark_cipher_operation(NX_CRYPTO_BENCHMARK_CASE *test_case)
+{
+UINT              status;
+NX_CRYPTO_METHOD *method = test_case -> nx_crypto_benchmark_case_method;
+UINT              aead = (method -> nx_crypto_ICV_size_in_bits != 0);
+UINT              encrypt = (test_case -> nx_crypto_benchmark_case_operation == NX_CRYPTO_BENCHMARK_ENCRYPT);
+
+    status = method -> nx_crypto_operation(encrypt ? NX_CRYPTO_ENCRYPT_INITIALIZE : NX_CRYPTO_DECRYPT_INITIALIZE,
+                                           test_case -> nx_crypto_benchmark_case_handler,
+                                           method,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           aead ? _nx_crypto_method_benchmark_additional_data : NX_CRYPTO_NULL,
+                                           aead ? NX_CRYPTO_BENCHMARK_ADDITIONAL_DATA_SIZE : 0,
+                                           aead ? _nx_crypto_method_benchmark_nonce : _nx_crypto_method_benchmark_iv,
+                                           NX_CRYPTO_NULL,
+                                           test_case -> nx_crypto_benchmark_case_input_length,
+                                           test_case -> nx_crypto_benchmark_case_metadata,
+                                           test_case -> nx_crypto_benchmark_case_metadata_size,
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    if (status)
+    {
+        return(status);
+    }
+
+    status = method -> nx_crypto_operation(encrypt ? NX_CRYPTO_ENCRYPT_UPDATE : NX_CRYPTO_DECRYPT_UPDATE,
+                                           test_case -> nx_crypto_benchmark_case_handler,
+                                           method,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           test_case -> nx_crypto_benchmark_case_input,
+                                           test_case -> nx_crypto_benchmark_case_input_length,
+                                           NX_CRYPTO_NULL,
+                                           test_case -> nx_crypto_benchmark_case_output,
+                                           test_case -> nx_crypto_benchmark_case_output_length,
+                                           test_case -> nx_crypto_benchmark_case_metadata,
+                                           test_case -> nx_crypto_benchmark_case_metadata_size,
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    if (status)
+    {
+        return(status);
+    }
+
+    /* Generate or check the tag of AEAD methods.  */
+    status = method -> nx_crypto_operation(encrypt ? NX_CRYPTO_ENCRYPT_CALCULATE : NX_CRYPTO_DECRYPT_CALCULATE,
+                                           test_case -> nx_crypto_benchmark_case_handler,
+                                           method,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           encrypt ? NX_CRYPTO_NULL : _nx_crypto_method_benchmark_tag,
+                                           encrypt ? 0 : sizeof(_nx_crypto_method_benchmark_tag),
+                                           NX_CRYPTO_NULL,
+                                           encrypt ? _nx_crypto_method_benchmark_tag : NX_CRYPTO_NULL,
+                                           encrypt ? sizeof(_nx_crypto_method_benchmark_tag) : 0,
+                                           test_case -> nx_crypto_benchmark_case_metadata,
+                                           test_case -> nx_crypto_benchmark_case_metadata_size,
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_hash_operation          PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes one digest or HMAC of the input.             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    test_case                             Pointer to measurement        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_method_benchmark_hash_operation(NX_CRYPTO_BENCHMARK_CASE *test_case)
+{
+UINT              status;
+NX_CRYPTO_METHOD *method = test_case -> nx_crypto_benchmark_case_method;
+
+    status = method -> nx_crypto_operation(NX_CRYPTO_HASH_INITIALIZE,
+                                           test_case -> nx_crypto_benchmark_case_handler,
+                                           method,
+                                           test_case -> nx_crypto_benchmark_case_key,
+                                           test_case -> nx_crypto_benchmark_case_key_size,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           NX_CRYPTO_NULL,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           test_case -> nx_crypto_benchmark_case_metadata,
+                                           test_case -> nx_crypto_benchmark_case_metadata_size,
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    if (status)
+    {
+        return(status);
+    }
+
+    status = method -> nx_crypto_operation(NX_CRYPTO_HASH_UPDATE,
+                                           test_case -> nx_crypto_benchmark_case_handler,
+                                           method,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           test_case -> nx_crypto_benchmark_case_input,
+                                           test_case -> nx_crypto_benchmark_case_input_length,
+                                           NX_CRYPTO_NULL,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           test_case -> nx_crypto_benchmark_case_metadata,
+                                           test_case -> nx_crypto_benchmark_case_metadata_size,
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    if (status)
+    {
+        return(status);
+    }
+
+    status = method -> nx_crypto_operation(NX_CRYPTO_HASH_CALCULATE,
+                                           test_case -> nx_crypto_benchmark_case_handler,
+                                           method,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           NX_CRYPTO_NULL,
+                                           test_case -> nx_crypto_benchmark_case_output,
+                                           test_case -> nx_crypto_benchmark_case_output_length,
+                                           test_case -> nx_crypto_benchmark_case_metadata,
+                                           test_case -> nx_crypto_benchmark_case_metadata_size,
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_ecdsa_operation         PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function signs the input, or verifies the signature in the     */
+/*    output buffer.                                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    test_case                             Pointer to measurement        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_method_benchmark_ecdsa_operation(NX_CRYPTO_BENCHMARK_CASE *test_case)
+{
+UINT                      status;
+NX_CRYPTO_METHOD         *method = test_case -> nx_crypto_benchmark_case_method;
+NX_CRYPTO_EXTENDED_OUTPUT extended_output;
+
+    if (test_case -> nx_crypto_benchmark_case_operation == NX_CRYPTO_BENCHMARK_VERIFY)
+    {
+        status = method -> nx_crypto_operation(NX_CRYPTO_SIGNATURE_VERIFY,
+                                               test_case -> nx_crypto_benchmark_case_handler,
+                                               method,
+                                               test_case -> nx_crypto_benchmark_case_key,
+                                               test_case -> nx_crypto_benchmark_case_key_size,
+                                               test_case -> nx_crypto_benchmark_case_input,
+                                               test_case -> nx_crypto_benchmark_case_input_length,
+                                               NX_CRYPTO_NULL,
+                                               test_case -> nx_crypto_benchmark_case_output,
+                                               test_case -> nx_crypto_benchmark_case_output_length,
+                                               test_case -> nx_crypto_benchmark_case_metadata,
+                                               test_case -> nx_crypto_benchmark_case_metadata_size,
+                                               NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+        return(status);
+    }
+
+    extended_output.nx_crypto_extended_output_data = test_case -> nx_crypto_benchmark_case_output;
+    extended_output.nx_crypto_extended_output_length_in_byte = test_case -> nx_crypto_benchmark_case_output_length;
+    status = method -> nx_crypto_operation(NX_CRYPTO_SIGNATURE_GENERATE,
+                                           test_case -> nx_crypto_benchmark_case_handler,
+                                           method,
+                                           test_case -> nx_crypto_benchmark_case_key,
+                                           test_case -> nx_crypto_benchmark_case_key_size,
+                                           test_case -> nx_crypto_benchmark_case_input,
+                                           test_case -> nx_crypto_benchmark_case_input_length,
+                                           NX_CRYPTO_NULL,
+                                           (UCHAR *)&extended_output,
+                                           sizeof(extended_output),
+                                           test_case -> nx_crypto_benchmark_case_metadata,
+                                           test_case -> nx_crypto_benchmark_case_metadata_size,
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_ecdh_operation          PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function performs one ephemeral key exchange the way a TLS     */
+/*    handshake does: a new context and key pair, then the shared secret  */
+/*    with the peer public key in the input buffer.                       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    test_case                             Pointer to measurement        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_method_benchmark_ecdh_operation(NX_CRYPTO_BENCHMARK_CASE *test_case)
+{
+UINT                      status;
+NX_CRYPTO_METHOD         *method = test_case -> nx_crypto_benchmark_case_method;
+VOID                     *handler = NX_CRYPTO_NULL;
+NX_CRYPTO_EXTENDED_OUTPUT extended_output;
+
+    if (method -> nx_crypto_init)
+    {
+        status = method -> nx_crypto_init(method, NX_CRYPTO_NULL, 0, &handler,
+                                          test_case -> nx_crypto_benchmark_case_metadata,
+                                          test_case -> nx_crypto_benchmark_case_metadata_size);
+        if (status)
+        {
+            return(status);
+        }
+    }
+
+    status = method -> nx_crypto_operation(NX_CRYPTO_EC_CURVE_SET,
+                                           handler,
+                                           method,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           (UCHAR *)test_case -> nx_crypto_benchmark_case_curve,
+                                           sizeof(NX_CRYPTO_METHOD *),
+                                           NX_CRYPTO_NULL,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           test_case -> nx_crypto_benchmark_case_metadata,
+                                           test_case -> nx_crypto_benchmark_case_metadata_size,
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    if (status)
+    {
+        return(status);
+    }
+
+    extended_output.nx_crypto_extended_output_data = test_case -> nx_crypto_benchmark_case_output;
+    extended_output.nx_crypto_extended_output_length_in_byte = test_case -> nx_crypto_benchmark_case_output_length;
+    status = method -> nx_crypto_operation(NX_CRYPTO_DH_SETUP,
+                                           handler,
+                                           method,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           NX_CRYPTO_NULL,
+                                           (UCHAR *)&extended_output,
+                                           sizeof(extended_output),
+                                           test_case -> nx_crypto_benchmark_case_metadata,
+                                           test_case -> nx_crypto_benchmark_case_metadata_size,
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    if (status)
+    {
+        return(status);
+    }
+
+    extended_output.nx_crypto_extended_output_data = test_case -> nx_crypto_benchmark_case_output;
+    extended_output.nx_crypto_extended_output_length_in_byte = test_case -> nx_crypto_benchmark_case_output_length;
+    status = method -> nx_crypto_operation(NX_CRYPTO_DH_CALCULATE,
+                                           handler,
+                                           method,
+                                           NX_CRYPTO_NULL,
+                                           0,
+                                           test_case -> nx_crypto_benchmark_case_input,
+                                           test_case -> nx_crypto_benchmark_case_input_length,
+                                           NX_CRYPTO_NULL,
+                                           (UCHAR *)&extended_output,
+                                           sizeof(extended_output),
+                                           test_case -> nx_crypto_benchmark_case_metadata,
+                                           test_case -> nx_crypto_benchmark_case_metadata_size,
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    if (status)
+    {
+        return(status);
+    }
+
+    if (method -> nx_crypto_cleanup)
+    {
+        status = method -> nx_crypto_cleanup(test_case -> nx_crypto_benchmark_case_metadata);
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_rsa_operation           PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function performs one modular exponentiation with the public   */
+/*    or private exponent.                                                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    test_case                             Pointer to measurement        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_method_benchmark_rsa_operation(NX_CRYPTO_BENCHMARK_CASE *test_case)
+{
+NX_CRYPTO_METHOD *method = test_case -> nx_crypto_benchmark_case_method;
+
+    return(method -> nx_crypto_operation(NX_CRYPTO_ENCRYPT,
+                                         test_case -> nx_crypto_benchmark_case_handler,
+                                         method,
+                                         test_case -> nx_crypto_benchmark_case_key,
+                                         test_case -> nx_crypto_benchmark_case_key_size,
+                                         test_case -> nx_crypto_benchmark_case_input,
+                                         test_case -> nx_crypto_benchmark_case_input_length,
+                                         NX_CRYPTO_NULL,
+                                         test_case -> nx_crypto_benchmark_case_output,
+                                         test_case -> nx_crypto_benchmark_case_output_length,
+                                         test_case -> nx_crypto_benchmark_case_metadata,
+                                         test_case -> nx_crypto_benchmark_case_metadata_size,
+                                         NX_CRYPTO_NULL, NX_CRYPTO_NULL));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_cipher                  PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function measures encryption and decryption of records of the  */
+/*    specified size with a block cipher or AEAD method.                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    benchmark                             Pointer to benchmark control  */
+/*    name                                  Name of the crypto method     */
+/*    crypto_method                         Pointer to the crypto method  */
+/*    data_size                             Size of a record in bytes     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_method_benchmark_cipher(NX_CRYPTO_BENCHMARK *benchmark, const CHAR *name,
+                                                       NX_CRYPTO_METHOD *crypto_method, UINT data_size)
+{
+UINT                       status;
+NX_CRYPTO_BENCHMARK_CASE   test_case;
+NX_CRYPTO_BENCHMARK_RESULT result;
+
+    if ((crypto_method == NX_CRYPTO_NULL) || (crypto_method -> nx_crypto_operation == NX_CRYPTO_NULL))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    if (data_size > NX_CRYPTO_BENCHMARK_MAX_DATA_SIZE)
+    {
+        return(NX_CRYPTO_INVALID_BUFFER_SIZE);
+    }
+
+    NX_CRYPTO_MEMSET(&test_case, 0, sizeof(test_case));
+    test_case.nx_crypto_benchmark_case_method = crypto_method;
+    test_case.nx_crypto_benchmark_case_metadata = benchmark -> nx_crypto_benchmark_metadata;
+    test_case.nx_crypto_benchmark_case_metadata_size = benchmark -> nx_crypto_benchmark_metadata_size;
+
+    if (crypto_method -> nx_crypto_init)
+    {
+        status = crypto_method -> nx_crypto_init(crypto_method,
+                                                 _nx_crypto_method_benchmark_key,
+                                                 crypto_method -> nx_crypto_key_size_in_bits,
+                                                 &test_case.nx_crypto_benchmark_case_handler,
+                                                 test_case.nx_crypto_benchmark_case_metadata,
+                                                 test_case.nx_crypto_benchmark_case_metadata_size);
+        if (status)
+        {
+            return(status);
+        }
+    }
+
+    result.nx_crypto_benchmark_result_name = name;
+    result.nx_crypto_benchmark_result_key_size = crypto_method -> nx_crypto_key_size_in_bits;
+    result.nx_crypto_benchmark_result_data_size = data_size;
+
+    /* Encrypt the input buffer into the output buffer.  */
+    test_case.nx_crypto_benchmark_case_operation = NX_CRYPTO_BENCHMARK_ENCRYPT;
+    test_case.nx_crypto_benchmark_case_input = _nx_crypto_method_benchmark_input;
+    test_case.nx_crypto_benchmark_case_input_length = data_size;
+    test_case.nx_crypto_benchmark_case_output = _nx_crypto_method_benchmark_output;
+    test_case.nx_crypto_benchmark_case_output_length = data_size;
+    status = _nx_crypto_method_benchmark_measure(benchmark, &test_case,
+                                                 _nx_crypto_method_benchmark_cipher_operation, &result);
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+
+        /* Encrypt once more so the output buffer and the tag match, then
+           decrypt the output buffer back into the input buffer.  */
+        status = _nx_crypto_method_benchmark_cipher_operation(&test_case);
+    }
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        test_case.nx_crypto_benchmark_case_operation = NX_CRYPTO_BENCHMARK_DECRYPT;
+        test_case.nx_crypto_benchmark_case_input = _nx_crypto_method_benchmark_output;
+        test_case.nx_crypto_benchmark_case_output = _nx_crypto_method_benchmark_input;
+        status = _nx_crypto_method_benchmark_measure(benchmark, &test_case,
+                                                     _nx_crypto_method_benchmark_cipher_operation, &result);
+    }
+
+    if (crypto_method -> nx_crypto_cleanup)
+    {
+        crypto_method -> nx_crypto_cleanup(test_case.nx_crypto_benchmark_case_metadata);
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_hash                    PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function measures a hash or HMAC method over data of the       */
+/*    specified size.                                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    benchmark                             Pointer to benchmark control  */
+/*    name                                  Name of the crypto method     */
+/*    crypto_method                         Pointer to the crypto method  */
+/*    key_size                              HMAC key size in bits, 0 for  */
+/*                                            a plain hash                */
+/*    data_size                             Size of the data in bytes     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_method_benchmark_hash(NX_CRYPTO_BENCHMARK *benchmark, const CHAR *name,
+                                                     NX_CRYPTO_METHOD *crypto_method, UINT key_size, UINT data_size)
+{
+UINT                       status;
+NX_CRYPTO_BENCHMARK_CASE   test_case;
+NX_CRYPTO_BENCHMARK_RESULT result;
+
+    if ((crypto_method == NX_CRYPTO_NULL) || (crypto_method -> nx_crypto_operation == NX_CRYPTO_NULL))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    if ((data_size > NX_CRYPTO_BENCHMARK_MAX_DATA_SIZE) || (key_size > (sizeof(_nx_crypto_method_benchmark_key) << 3)))
+    {
+        return(NX_CRYPTO_INVALID_BUFFER_SIZE);
+    }
+
+    NX_CRYPTO_MEMSET(&test_case, 0, sizeof(test_case));
+    test_case.nx_crypto_benchmark_case_method = crypto_method;
+    test_case.nx_crypto_benchmark_case_operation = NX_CRYPTO_BENCHMARK_HASH;
+    test_case.nx_crypto_benchmark_case_key = key_size ? _nx_crypto_method_benchmark_key : NX_CRYPTO_NULL;
+    test_case.nx_crypto_benchmark_case_key_size = key_size;
+    test_case.nx_crypto_benchmark_case_input = _nx_crypto_method_benchmark_input;
+    test_case.nx_crypto_benchmark_case_input_length = data_size;
+    test_case.nx_crypto_benchmark_case_output = _nx_crypto_method_benchmark_output;
+    test_case.nx_crypto_benchmark_case_output_length = crypto_method -> nx_crypto_ICV_size_in_bits >> 3;
+    test_case.nx_crypto_benchmark_case_metadata = benchmark -> nx_crypto_benchmark_metadata;
+    test_case.nx_crypto_benchmark_case_metadata_size = benchmark -> nx_crypto_benchmark_metadata_size;
+
+    if (crypto_method -> nx_crypto_init)
+    {
+        status = crypto_method -> nx_crypto_init(crypto_method,
+                                                 test_case.nx_crypto_benchmark_case_key,
+                                                 key_size,
+                                                 &test_case.nx_crypto_benchmark_case_handler,
+                                                 test_case.nx_crypto_benchmark_case_metadata,
+                                                 test_case.nx_crypto_benchmark_case_metadata_size);
+        if (status)
+        {
+            return(status);
+        }
+    }
+
+    result.nx_crypto_benchmark_result_name = name;
+    result.nx_crypto_benchmark_result_key_size = key_size;
+    result.nx_crypto_benchmark_result_data_size = data_size;
+    status = _nx_crypto_method_benchmark_measure(benchmark, &test_case,
+                                                 _nx_crypto_method_benchmark_hash_operation, &result);
+
+    if (crypto_method -> nx_crypto_cleanup)
+    {
+        crypto_method -> nx_crypto_cleanup(test_case.nx_crypto_benchmark_case_metadata);
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_key_pair                PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function generates a key pair on the curve into the key pair   */
+/*    buffer: the private key at the start, then the uncompressed public  */
+/*    key.                                                                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    curve_method                          Pointer to the curve method   */
+/*    privkey                               Pointer to private key        */
+/*    privkey_length                        Length of private key         */
+/*    pubkey                                Pointer to public key         */
+/*    pubkey_length                         Length of public key          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_method_benchmark_key_pair(NX_CRYPTO_METHOD *curve_method,
+                                                 UCHAR **privkey, UINT *privkey_length,
+                                                 UCHAR **pubkey, UINT *pubkey_length)
+{
+UINT                  status;
+NX_CRYPTO_EC         *curve = NX_CRYPTO_NULL;
+NX_CRYPTO_HUGE_NUMBER private_key;
+NX_CRYPTO_EC_POINT    public_key;
+HN_UBASE             *scratch;
+UINT                  buffer_size;
+
+    status = curve_method -> nx_crypto_operation(NX_CRYPTO_EC_CURVE_GET,
+                                                 NX_CRYPTO_NULL,
+                                                 curve_method,
+                                                 NX_CRYPTO_NULL,
+                                                 0,
+                                                 NX_CRYPTO_NULL,
+                                                 0,
+                                                 NX_CRYPTO_NULL,
+                                                 (UCHAR *)&curve,
+                                                 0,
+                                                 NX_CRYPTO_NULL,
+                                                 0,
+                                                 NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    if (status)
+    {
+        return(status);
+    }
+
+    buffer_size = curve -> nx_crypto_ec_n.nx_crypto_huge_buffer_size;
+    if (buffer_size > NX_CRYPTO_ECDH_MAX_KEY_SIZE)
+    {
+        return(NX_CRYPTO_SIZE_ERROR);
+    }
+
+    *privkey = _nx_crypto_method_benchmark_key_pair_buffer;
+    *pubkey = &_nx_crypto_method_benchmark_key_pair_buffer[buffer_size];
+
+    /* Public key buffer (and scratch).  */
+    scratch = _nx_crypto_method_benchmark_ec_scratch;
+    NX_CRYPTO_EC_POINT_INITIALIZE(&public_key, NX_CRYPTO_EC_POINT_AFFINE, scratch, buffer_size);
+
+    /* Private key buffer, no scratch is required for it.  */
+    private_key.nx_crypto_huge_number_data = _nx_crypto_method_benchmark_private_key;
+    private_key.nx_crypto_huge_number_size = buffer_size >> HN_SIZE_SHIFT;
+    private_key.nx_crypto_huge_buffer_size = sizeof(_nx_crypto_method_benchmark_private_key);
+    private_key.nx_crypto_huge_number_is_negative = NX_CRYPTO_FALSE;
+    NX_CRYPTO_MEMSET(_nx_crypto_method_benchmark_private_key, 0, sizeof(_nx_crypto_method_benchmark_private_key));
+
+    status = _nx_crypto_ec_key_pair_generation_extra(curve, &curve -> nx_crypto_ec_g, &private_key,
+                                                     &public_key, scratch);
+    if (status)
+    {
+        return(status);
+    }
+
+    status = _nx_crypto_huge_number_extract_fixed_size(&private_key, *privkey, buffer_size);
+    if (status)
+    {
+        return(status);
+    }
+    *privkey_length = buffer_size;
+
+    *pubkey_length = 0;
+    _nx_crypto_ec_point_extract_uncompressed(curve, &public_key, *pubkey,
+                                             sizeof(_nx_crypto_method_benchmark_key_pair_buffer) - buffer_size,
+                                             pubkey_length);
+    if (*pubkey_length == 0)
+    {
+        return(NX_CRYPTO_SIZE_ERROR);
+    }
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_ecdsa                   PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function measures ECDSA signature generation and verification  */
+/*    of a digest on the specified curve.                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    benchmark                             Pointer to benchmark control  */
+/*    name                                  Name of the crypto method     */
+/*    crypto_method_ecdsa                   Pointer to ECDSA method       */
+/*    curve_method                          Pointer to the curve method   */
+/*    hash_method                           Pointer to the hash method    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_method_benchmark_ecdsa(NX_CRYPTO_BENCHMARK *benchmark, const CHAR *name,
+                                                      NX_CRYPTO_METHOD *crypto_method_ecdsa,
+                                                      NX_CRYPTO_METHOD *curve_method, NX_CRYPTO_METHOD *hash_method)
+{
+UINT                       status;
+NX_CRYPTO_BENCHMARK_CASE   test_case;
+NX_CRYPTO_BENCHMARK_RESULT result;
+UCHAR                     *privkey;
+UINT                       privkey_length;
+UCHAR                     *pubkey;
+UINT                       pubkey_length;
+NX_CRYPTO_EXTENDED_OUTPUT  extended_output;
+
+    if ((crypto_method_ecdsa == NX_CRYPTO_NULL) || (crypto_method_ecdsa -> nx_crypto_operation == NX_CRYPTO_NULL) ||
+        (curve_method == NX_CRYPTO_NULL) || (hash_method == NX_CRYPTO_NULL))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    NX_CRYPTO_MEMSET(&test_case, 0, sizeof(test_case));
+    test_case.nx_crypto_benchmark_case_method = crypto_method_ecdsa;
+    test_case.nx_crypto_benchmark_case_metadata = benchmark -> nx_crypto_benchmark_metadata;
+    test_case.nx_crypto_benchmark_case_metadata_size = benchmark -> nx_crypto_benchmark_metadata_size;
+
+    status = _nx_crypto_method_benchmark_key_pair(curve_method, &privkey, &privkey_length, &pubkey, &pubkey_length);
+    if (status)
+    {
+        return(status);
+    }
+
+    if (crypto_method_ecdsa -> nx_crypto_init)
+    {
+        status = crypto_method_ecdsa -> nx_crypto_init(crypto_method_ecdsa,
+                                                       NX_CRYPTO_NULL,
+                                                       0,
+                                                       &test_case.nx_crypto_benchmark_case_handler,
+                                                       test_case.nx_crypto_benchmark_case_metadata,
+                                                       test_case.nx_crypto_benchmark_case_metadata_size);
+        if (status)
+        {
+            return(status);
+        }
+    }
+
+    status = crypto_method_ecdsa -> nx_crypto_operation(NX_CRYPTO_HASH_METHOD_SET,
+                                                        test_case.nx_crypto_benchmark_case_handler,
+                                                        crypto_method_ecdsa,
+                                                        NX_CRYPTO_NULL,
+                                                        0,
+                                                        (UCHAR *)hash_method,
+                                                        sizeof(NX_CRYPTO_METHOD *),
+                                                        NX_CRYPTO_NULL,
+                                                        NX_CRYPTO_NULL,
+                                                        0,
+                                                        test_case.nx_crypto_benchmark_case_metadata,
+                                                        test_case.nx_crypto_benchmark_case_metadata_size,
+                                                        NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        status = crypto_method_ecdsa -> nx_crypto_operation(NX_CRYPTO_EC_CURVE_SET,
+                                                            test_case.nx_crypto_benchmark_case_handler,
+                                                            crypto_method_ecdsa,
+                                                            NX_CRYPTO_NULL,
+                                                            0,
+                                                            (UCHAR *)curve_method,
+                                                            sizeof(NX_CRYPTO_METHOD *),
+                                                            NX_CRYPTO_NULL,
+                                                            NX_CRYPTO_NULL,
+                                                            0,
+                                                            test_case.nx_crypto_benchmark_case_metadata,
+                                                            test_case.nx_crypto_benchmark_case_metadata_size,
+                                                            NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    }
+
+    result.nx_crypto_benchmark_result_name = name;
+    result.nx_crypto_benchmark_result_key_size = curve_method -> nx_crypto_key_size_in_bits;
+    result.nx_crypto_benchmark_result_data_size = 0;
+
+    /* Sign a digest of the hash size, as TLS does for the handshake.  */
+    test_case.nx_crypto_benchmark_case_key = privkey;
+    test_case.nx_crypto_benchmark_case_key_size = privkey_length << 3;
+    test_case.nx_crypto_benchmark_case_input = _nx_crypto_method_benchmark_input;
+    test_case.nx_crypto_benchmark_case_input_length = hash_method -> nx_crypto_ICV_size_in_bits >> 3;
+    test_case.nx_crypto_benchmark_case_output = _nx_crypto_method_benchmark_output;
+    test_case.nx_crypto_benchmark_case_output_length = NX_CRYPTO_BENCHMARK_MAX_DATA_SIZE;
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        test_case.nx_crypto_benchmark_case_operation = NX_CRYPTO_BENCHMARK_SIGN;
+        status = _nx_crypto_method_benchmark_measure(benchmark, &test_case,
+                                                     _nx_crypto_method_benchmark_ecdsa_operation, &result);
+    }
+
+    /* Keep the last signature for verification.  */
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        extended_output.nx_crypto_extended_output_data = _nx_crypto_method_benchmark_output;
+        extended_output.nx_crypto_extended_output_length_in_byte = NX_CRYPTO_BENCHMARK_MAX_DATA_SIZE;
+        status = crypto_method_ecdsa -> nx_crypto_operation(NX_CRYPTO_SIGNATURE_GENERATE,
+                                                            test_case.nx_crypto_benchmark_case_handler,
+                                                            crypto_method_ecdsa,
+                                                            privkey,
+                                                            privkey_length << 3,
+                                                            test_case.nx_crypto_benchmark_case_input,
+                                                            test_case.nx_crypto_benchmark_case_input_length,
+                                                            NX_CRYPTO_NULL,
+                                                            (UCHAR *)&extended_output,
+                                                            sizeof(extended_output),
+                                                            test_case.nx_crypto_benchmark_case_metadata,
+                                                            test_case.nx_crypto_benchmark_case_metadata_size,
+                                                            NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+        test_case.nx_crypto_benchmark_case_output_length = extended_output.nx_crypto_extended_output_actual_size;
+    }
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        test_case.nx_crypto_benchmark_case_operation = NX_CRYPTO_BENCHMARK_VERIFY;
+        test_case.nx_crypto_benchmark_case_key = pubkey;
+        test_case.nx_crypto_benchmark_case_key_size = pubkey_length << 3;
+        status = _nx_crypto_method_benchmark_measure(benchmark, &test_case,
+                                                     _nx_crypto_method_benchmark_ecdsa_operation, &result);
+    }
+
+    if (crypto_method_ecdsa -> nx_crypto_cleanup)
+    {
+        crypto_method_ecdsa -> nx_crypto_cleanup(test_case.nx_crypto_benchmark_case_metadata);
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_ecdh                    PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function measures an ephemeral ECDH key exchange on the        */
+/*    specified curve, including the key pair generation.                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    benchmark                             Pointer to benchmark control  */
+/*    name                                  Name of the crypto method     */
+/*    crypto_method_ecdh                    Pointer to ECDH method        */
+/*    curve_method                          Pointer to the curve method   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_method_benchmark_ecdh(NX_CRYPTO_BENCHMARK *benchmark, const CHAR *name,
+                                                     NX_CRYPTO_METHOD *crypto_method_ecdh, NX_CRYPTO_METHOD *curve_method)
+{
+UINT                       status;
+NX_CRYPTO_BENCHMARK_CASE   test_case;
+NX_CRYPTO_BENCHMARK_RESULT result;
+UCHAR                     *privkey;
+UINT                       privkey_length;
+UCHAR                     *pubkey;
+UINT                       pubkey_length;
+
+    if ((crypto_method_ecdh == NX_CRYPTO_NULL) || (crypto_method_ecdh -> nx_crypto_operation == NX_CRYPTO_NULL) ||
+        (curve_method == NX_CRYPTO_NULL))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    /* Generate the public key of the peer.  */
+    status = _nx_crypto_method_benchmark_key_pair(curve_method, &privkey, &privkey_length, &pubkey, &pubkey_length);
+    if (status)
+    {
+        return(status);
+    }
+
+    NX_CRYPTO_MEMSET(&test_case, 0, sizeof(test_case));
+    test_case.nx_crypto_benchmark_case_method = crypto_method_ecdh;
+    test_case.nx_crypto_benchmark_case_curve = curve_method;
+    test_case.nx_crypto_benchmark_case_operation = NX_CRYPTO_BENCHMARK_KEY_EXCHANGE;
+    test_case.nx_crypto_benchmark_case_input = pubkey;
+    test_case.nx_crypto_benchmark_case_input_length = pubkey_length;
+    test_case.nx_crypto_benchmark_case_output = _nx_crypto_method_benchmark_output;
+    test_case.nx_crypto_benchmark_case_output_length = NX_CRYPTO_BENCHMARK_MAX_DATA_SIZE;
+    test_case.nx_crypto_benchmark_case_metadata = benchmark -> nx_crypto_benchmark_metadata;
+    test_case.nx_crypto_benchmark_case_metadata_size = benchmark -> nx_crypto_benchmark_metadata_size;
+
+    result.nx_crypto_benchmark_result_name = name;
+    result.nx_crypto_benchmark_result_key_size = curve_method -> nx_crypto_key_size_in_bits;
+    result.nx_crypto_benchmark_result_data_size = 0;
+    status = _nx_crypto_method_benchmark_measure(benchmark, &test_case,
+                                                 _nx_crypto_method_benchmark_ecdh_operation, &result);
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_rsa                     PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function measures the RSA public operation (signature          */
+/*    verification, key transport) and the private operation with the     */
+/*    Chinese Remainder Theorem (signature generation).                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    benchmark                             Pointer to benchmark control  */
+/*    name                                  Name of the crypto method     */
+/*    crypto_method_rsa                     Pointer to RSA method         */
+/*    key_size                              Modulus size, 2048 or 4096    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_method_benchmark_rsa(NX_CRYPTO_BENCHMARK *benchmark, const CHAR *name,
+                                                    NX_CRYPTO_METHOD *crypto_method_rsa, UINT key_size)
+{
+UINT                       status;
+NX_CRYPTO_BENCHMARK_CASE   test_case;
+NX_CRYPTO_BENCHMARK_RESULT result;
+const UCHAR               *modulus;
+const UCHAR               *pri_e;
+const UCHAR               *prime_p;
+const UCHAR               *prime_q;
+UINT                       modulus_length;
+UINT                       i;
+
+    if ((crypto_method_rsa == NX_CRYPTO_NULL) || (crypto_method_rsa -> nx_crypto_init == NX_CRYPTO_NULL) ||
+        (crypto_method_rsa -> nx_crypto_operation == NX_CRYPTO_NULL))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    if (key_size == 2048)
+    {
+        modulus = m_2048;
+        pri_e = pri_e_2048;
+        prime_p = p_2048;
+        prime_q = q_2048;
+    }
+    else if (key_size == 4096)
+    {
+        modulus = m_4096;
+        pri_e = pri_e_4096;
+        prime_p = p_4096;
+        prime_q = q_4096;
+    }
+    else
+    {
+        return(NX_CRYPTO_INVALID_KEY);
+    }
+    modulus_length = key_size >> 3;
+
+    NX_CRYPTO_MEMSET(&test_case, 0, sizeof(test_case));
+    test_case.nx_crypto_benchmark_case_method = crypto_method_rsa;
+    test_case.nx_crypto_benchmark_case_input = _nx_crypto_method_benchmark_input;
+    test_case.nx_crypto_benchmark_case_input_length = modulus_length;
+    test_case.nx_crypto_benchmark_case_output = _nx_crypto_method_benchmark_output;
+    test_case.nx_crypto_benchmark_case_output_length = modulus_length;
+    test_case.nx_crypto_benchmark_case_metadata = benchmark -> nx_crypto_benchmark_metadata;
+    test_case.nx_crypto_benchmark_case_metadata_size = benchmark -> nx_crypto_benchmark_metadata_size;
+
+    /* The input must be smaller than the modulus.  */
+    for (i = 0; i < modulus_length; i++)
+    {
+        _nx_crypto_method_benchmark_input[i] = (UCHAR)(i + 1);
+    }
+    _nx_crypto_method_benchmark_input[0] = 0;
+
+    result.nx_crypto_benchmark_result_name = name;
+    result.nx_crypto_benchmark_result_key_size = key_size;
+    result.nx_crypto_benchmark_result_data_size = 0;
+
+    status = crypto_method_rsa -> nx_crypto_init(crypto_method_rsa,
+                                                 (UCHAR *)modulus,
+                                                 (NX_CRYPTO_KEY_SIZE)key_size,
+                                                 &test_case.nx_crypto_benchmark_case_handler,
+                                                 test_case.nx_crypto_benchmark_case_metadata,
+                                                 test_case.nx_crypto_benchmark_case_metadata_size);
+    if (status)
+    {
+        return(status);
+    }
+
+    test_case.nx_crypto_benchmark_case_operation = NX_CRYPTO_BENCHMARK_PUBLIC;
+    test_case.nx_crypto_benchmark_case_key = (UCHAR *)pub_e;
+    test_case.nx_crypto_benchmark_case_key_size = 32;
+    status = _nx_crypto_method_benchmark_measure(benchmark, &test_case,
+                                                 _nx_crypto_method_benchmark_rsa_operation, &result);
+
+    if (crypto_method_rsa -> nx_crypto_cleanup)
+    {
+        crypto_method_rsa -> nx_crypto_cleanup(test_case.nx_crypto_benchmark_case_metadata);
+    }
+
+    if (status)
+    {
+        return(status);
+    }
+
+    /* Set the primes so the private operation uses CRT.  */
+    status = crypto_method_rsa -> nx_crypto_init(crypto_method_rsa,
+                                                 (UCHAR *)modulus,
+                                                 (NX_CRYPTO_KEY_SIZE)key_size,
+                                                 &test_case.nx_crypto_benchmark_case_handler,
+                                                 test_case.nx_crypto_benchmark_case_metadata,
+                                                 test_case.nx_crypto_benchmark_case_metadata_size);
+    if (status)
+    {
+        return(status);
+    }
+
+    status = crypto_method_rsa -> nx_crypto_operation(NX_CRYPTO_SET_PRIME_P,
+                                                      test_case.nx_crypto_benchmark_case_handler,
+                                                      crypto_method_rsa,
+                                                      NX_CRYPTO_NULL,
+                                                      0,
+                                                      (UCHAR *)prime_p,
+                                                      modulus_length >> 1,
+                                                      NX_CRYPTO_NULL,
+                                                      NX_CRYPTO_NULL,
+                                                      0,
+                                                      test_case.nx_crypto_benchmark_case_metadata,
+                                                      test_case.nx_crypto_benchmark_case_metadata_size,
+                                                      NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        status = crypto_method_rsa -> nx_crypto_operation(NX_CRYPTO_SET_PRIME_Q,
+                                                          test_case.nx_crypto_benchmark_case_handler,
+                                                          crypto_method_rsa,
+                                                          NX_CRYPTO_NULL,
+                                                          0,
+                                                          (UCHAR *)prime_q,
+                                                          modulus_length >> 1,
+                                                          NX_CRYPTO_NULL,
+                                                          NX_CRYPTO_NULL,
+                                                          0,
+                                                          test_case.nx_crypto_benchmark_case_metadata,
+                                                          test_case.nx_crypto_benchmark_case_metadata_size,
+                                                          NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    }
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        test_case.nx_crypto_benchmark_case_operation = NX_CRYPTO_BENCHMARK_PRIVATE;
+        test_case.nx_crypto_benchmark_case_key = (UCHAR *)pri_e;
+        test_case.nx_crypto_benchmark_case_key_size = key_size;
+        status = _nx_crypto_method_benchmark_measure(benchmark, &test_case,
+                                                     _nx_crypto_method_benchmark_rsa_operation, &result);
+    }
+
+    if (crypto_method_rsa -> nx_crypto_cleanup)
+    {
+        crypto_method_rsa -> nx_crypto_cleanup(test_case.nx_crypto_benchmark_case_metadata);
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_run                     PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function runs the benchmark suite over the methods used by the */
+/*    TLS connection to Azure IoT: AES-CBC and AES-GCM record protection, */
+/*    SHA-256 and HMAC-SHA256, ECDSA and ECDH on P-256 and P-384, and RSA */
+/*    2048 and 4096. Each measurement is reported as it completes. The    */
+/*    metadata area must be large enough for the largest method.          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    benchmark                             Pointer to benchmark control  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                NX_CRYPTO_SUCCESS, or status  */
+/*                                            of the last measurement     */
+/*                                            that failed                 */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_method_benchmark_run(NX_CRYPTO_BENCHMARK *benchmark)
+{
+UINT status;
+UINT result = NX_CRYPTO_SUCCESS;
+UINT i;
+
+    if ((benchmark == NX_CRYPTO_NULL) || (benchmark -> nx_crypto_benchmark_clock == NX_CRYPTO_NULL) ||
+        (benchmark -> nx_crypto_benchmark_metadata == NX_CRYPTO_NULL))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    for (i = 0; i < sizeof(_nx_crypto_method_benchmark_data_size) / sizeof(UINT); i++)
+    {
+        if (_nx_crypto_method_benchmark_data_size[i] > NX_CRYPTO_BENCHMARK_MAX_DATA_SIZE)
+        {
+            break;
+        }
+
+        status = _nx_crypto_method_benchmark_cipher(benchmark, "aes_cbc_128", &crypto_method_aes_cbc_128,
+                                                    _nx_crypto_method_benchmark_data_size[i]);
+        result = status ? status : result;
+        status = _nx_crypto_method_benchmark_cipher(benchmark, "aes_128_gcm_16", &crypto_method_aes_128_gcm_16,
+                                                    _nx_crypto_method_benchmark_data_size[i]);
+        result = status ? status : result;
+        status = _nx_crypto_method_benchmark_cipher(benchmark, "aes_256_gcm_16", &crypto_method_aes_256_gcm_16,
+                                                    _nx_crypto_method_benchmark_data_size[i]);
+        result = status ? status : result;
+        status = _nx_crypto_method_benchmark_hash(benchmark, "sha256", &crypto_method_sha256,
+                                                  0, _nx_crypto_method_benchmark_data_size[i]);
+        result = status ? status : result;
+        status = _nx_crypto_method_benchmark_hash(benchmark, "hmac_sha256", &crypto_method_hmac_sha256,
+                                                  256, _nx_crypto_method_benchmark_data_size[i]);
+        result = status ? status : result;
+    }
+
+    status = _nx_crypto_method_benchmark_ecdsa(benchmark, "ecdsa_secp256r1_sha256", &crypto_method_ecdsa,
+                                               &crypto_method_ec_secp256, &crypto_method_sha256);
+    result = status ? status : result;
+    status = _nx_crypto_method_benchmark_ecdsa(benchmark, "ecdsa_secp384r1_sha256", &crypto_method_ecdsa,
+                                               &crypto_method_ec_secp384, &crypto_method_sha256);
+    result = status ? status : result;
+    status = _nx_crypto_method_benchmark_ecdh(benchmark, "ecdh_secp256r1", &crypto_method_ecdh,
+                                              &crypto_method_ec_secp256);
+    result = status ? status : result;
+    status = _nx_crypto_method_benchmark_ecdh(benchmark, "ecdh_secp384r1", &crypto_method_ecdh,
+                                              &crypto_method_ec_secp384);
+    result = status ? status : result;
+    status = _nx_crypto_method_benchmark_rsa(benchmark, "rsa_2048", &crypto_method_rsa, 2048);
+    result = status ? status : result;
+    status = _nx_crypto_method_benchmark_rsa(benchmark, "rsa_4096", &crypto_method_rsa, 4096);
+    result = status ? status : result;
+
+    return(result);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_append                  PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function appends a string, or the decimal representation of a */
+/*    number when the string is NULL, to the buffer.                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    buffer                                Pointer to output buffer      */
+/*    buffer_size                           Size of output buffer         */
+/*    offset                                Pointer to write offset       */
+/*    string                                String to append, or NULL     */
+/*    value                                 Number to append              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_method_benchmark_append(CHAR *buffer, UINT buffer_size, UINT *offset,
+                                               const CHAR *string, ULONG value)
+{
+CHAR digits[20];
+UINT count = 0;
+
+    if (string == NX_CRYPTO_NULL)
+    {
+
+        /* Convert the number, least significant digit first.  */
+        do
+        {
+            digits[count++] = (CHAR)('0' + (value % 10));
+            value /= 10;
+        } while (value);
+
+        if (*offset + count >= buffer_size)
+        {
+            return(NX_CRYPTO_INVALID_BUFFER_SIZE);
+        }
+
+        while (count)
+        {
+            buffer[(*offset)++] = digits[--count];
+        }
+    }
+    else
+    {
+        while (*string)
+        {
+            if (*offset + 1 >= buffer_size)
+            {
+                return(NX_CRYPTO_INVALID_BUFFER_SIZE);
+            }
+            buffer[(*offset)++] = *string++;
+        }
+    }
+
+    buffer[*offset] = 0;
+    return(NX_CRYPTO_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_benchmark_result_format           PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function formats a result as one line of JSON, ended by a      */
+/*    newline, so the output of runs with different configurations can    */
+/*    be compared by scripts.                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    result                                Pointer to result             */
+/*    buffer                                Pointer to output buffer      */
+/*    buffer_size                           Size of output buffer         */
+/*    length                                Length of the line with its   */
+/*                                            newline, without the NUL    */
+/*                                            terminator                  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_method_benchmark_result_format(NX_CRYPTO_BENCHMARK_RESULT *result,
+                                                              CHAR *buffer, UINT buffer_size, UINT *length)
+{
+UINT        status;
+UINT        offset = 0;
+UINT        operation;
+
+    if ((result == NX_CRYPTO_NULL) || (buffer == NX_CRYPTO_NULL) || (length == NX_CRYPTO_NULL))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    operation = result -> nx_crypto_benchmark_result_operation;
+    if (operation >= sizeof(_nx_crypto_method_benchmark_operation_name) / sizeof(CHAR *))
+    {
+        operation = 0;
+    }
+
+    status = _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, "{\"name\":\"", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, result -> nx_crypto_benchmark_result_name, 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, "\",\"operation\":\"", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, _nx_crypto_method_benchmark_operation_name[operation], 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, "\",\"key_size\":", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, NX_CRYPTO_NULL, result -> nx_crypto_benchmark_result_key_size);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, ",\"data_size\":", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, NX_CRYPTO_NULL, result -> nx_crypto_benchmark_result_data_size);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, ",\"status\":", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, NX_CRYPTO_NULL, result -> nx_crypto_benchmark_result_status);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, ",\"count\":", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, NX_CRYPTO_NULL, result -> nx_crypto_benchmark_result_count);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, ",\"ticks\":", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, NX_CRYPTO_NULL, result -> nx_crypto_benchmark_result_ticks);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, ",\"ops_per_second\":", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, NX_CRYPTO_NULL, result -> nx_crypto_benchmark_result_ops_per_second);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, ",\"bytes_per_second\":", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, NX_CRYPTO_NULL, result -> nx_crypto_benchmark_result_bytes_per_second);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, ",\"ticks_per_operation\":", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, NX_CRYPTO_NULL, result -> nx_crypto_benchmark_result_ticks_per_operation);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, ",\"metadata_size\":", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, NX_CRYPTO_NULL, result -> nx_crypto_benchmark_result_metadata_size);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, ",\"stack_size\":", 0);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, NX_CRYPTO_NULL, result -> nx_crypto_benchmark_result_stack_size);
+    status |= _nx_crypto_method_benchmark_append(buffer, buffer_size, &offset, "}\n", 0);
+
+    *length = offset;
+
+    return(status ? NX_CRYPTO_INVALID_BUFFER_SIZE : NX_CRYPTO_SUCCESS);
+}
+#endif /* NX_CRYPTO_ENABLE_BENCHMARK */
@@ -198,6 +198,13 @@ extern   "C" {
    #define NX_SECURE_TLS_REQUIRE_RENEGOTIATION_EXT
  */
 
+/* Configuration macro: let a TLS 1.2 client resume an earlier session by offering its session ID
+   in the ClientHello (RFC 5246, Section 7.3). If the server accepts, the certificate exchange and
+   key exchange are skipped. The application saves the session state with
+   nx_secure_tls_session_resumption_get and offers it with nx_secure_tls_session_resumption_set.
+   #define NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+ */
+
 /* API return values.  */
 
 #define NX_SECURE_TLS_SUCCESS                           0x00        /* Function returned successfully. */
@@ -667,6 +674,7 @@ typedef struct NX_SECURE_VERSIONS_LIST_STRUCT
 #define NX_SECURE_TLS_MAX_CIPHER_BLOCK_SIZE                (128) /* Size of the largest block used by session ciphers (in block mode). */
 
 #define NX_SECURE_TLS_MAX_SESSION_TICKET_AGE               (604800) /* Maximum lifetime of a NewSessionTicket (in milliseconds). */
+#define NX_SECURE_TLS_RESUMPTION_SESSION_ID_SIZE           (32)  /* Largest session ID a TLS 1.2 server may assign. */
 
 #define NX_SECURE_TLS_MAX_CIPHERTEXT_LENGTH                (18432) /* Maximum TLSCiphertext record length. */
 #define NX_SECURE_TLS_MAX_CIPHERTEXT_LENGTH_1_3            (16640) /* Maximum TLSCiphertext record length of TLS 1.3. */
@@ -1094,6 +1102,23 @@ typedef struct NX_SECURE_TLS_HELLO_EXTENSION_STRUCT
 } NX_SECURE_TLS_HELLO_EXTENSION;
 
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+/* State of an established TLS 1.2 session that a client can offer to resume it later. */
+typedef struct NX_SECURE_TLS_RESUMPTION_STRUCT
+{
+    /* Session ID assigned by the server. A length of zero means there is nothing to resume. */
+    UCHAR  nx_secure_tls_resumption_session_id[NX_SECURE_TLS_RESUMPTION_SESSION_ID_SIZE];
+    UCHAR  nx_secure_tls_resumption_session_id_length;
+
+    /* The resumed session must use the same protocol version and ciphersuite. */
+    USHORT nx_secure_tls_resumption_protocol_version;
+    USHORT nx_secure_tls_resumption_ciphersuite;
+
+    /* Master secret of the session, the new keys are derived from it and the new randoms. */
+    UCHAR  nx_secure_tls_resumption_master_secret[NX_SECURE_TLS_MASTER_SIZE];
+} NX_SECURE_TLS_RESUMPTION;
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
 /* Definition of the top-level TLS session control block used by the application. */
 typedef struct NX_SECURE_TLS_SESSION_STRUCT
 {
@@ -1175,6 +1200,12 @@ typedef struct NX_SECURE_TLS_SESSION_STRUCT
     /* Session ID used for session re-negotiation. */
     UCHAR nx_secure_tls_session_id[NX_SECURE_TLS_SESSION_ID_SIZE];
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+    /* Session offered in the ClientHello, and whether the server resumed it. */
+    NX_SECURE_TLS_RESUMPTION nx_secure_tls_resumption;
+    USHORT nx_secure_tls_session_resumed;
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
 #ifndef NX_SECURE_TLS_DISABLE_SECURE_RENEGOTIATION
     /* This flag indicates whether the remote host supports secure renegotiation
        as indicated in the initial Hello messages (SCSV or the renegotiation
@@ -1613,6 +1644,12 @@ UINT _nx_secure_tls_session_renegotiate(NX_SECURE_TLS_SESSION *tls_session,
 UINT _nx_secure_tls_session_renegotiate_callback_set(NX_SECURE_TLS_SESSION *tls_session,
                                                      ULONG (*func_ptr)(NX_SECURE_TLS_SESSION *session));
 UINT _nx_secure_tls_session_reset(NX_SECURE_TLS_SESSION *tls_session);
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+UINT _nx_secure_tls_session_resumption_get(NX_SECURE_TLS_SESSION *tls_session,
+                                           NX_SECURE_TLS_RESUMPTION *resumption, UINT *resumed);
+UINT _nx_secure_tls_session_resumption_set(NX_SECURE_TLS_SESSION *tls_session,
+                                           const NX_SECURE_TLS_RESUMPTION *resumption);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
 UINT _nx_secure_tls_session_send(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET *packet_ptr,
                                  ULONG wait_option);
 UINT _nx_secure_tls_session_server_callback_set(NX_SECURE_TLS_SESSION *tls_session,
@@ -1705,6 +1742,12 @@ UINT _nxe_secure_tls_session_renegotiate(NX_SECURE_TLS_SESSION *tls_session,
 UINT _nxe_secure_tls_session_renegotiate_callback_set(NX_SECURE_TLS_SESSION *tls_session,
                                                       ULONG (*func_ptr)(NX_SECURE_TLS_SESSION *session));
 UINT _nxe_secure_tls_session_reset(NX_SECURE_TLS_SESSION *tls_session);
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+UINT _nxe_secure_tls_session_resumption_get(NX_SECURE_TLS_SESSION *tls_session,
+                                            NX_SECURE_TLS_RESUMPTION *resumption, UINT *resumed);
+UINT _nxe_secure_tls_session_resumption_set(NX_SECURE_TLS_SESSION *tls_session,
+                                            const NX_SECURE_TLS_RESUMPTION *resumption);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
 UINT _nxe_secure_tls_session_send(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET *packet_ptr,
                                   ULONG wait_option);
 UINT _nxe_secure_tls_session_server_callback_set(NX_SECURE_TLS_SESSION *tls_session,
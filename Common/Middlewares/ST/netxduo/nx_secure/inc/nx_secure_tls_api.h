@@ -99,6 +99,8 @@ extern   "C" {
 #define nx_secure_tls_session_renegotiate                  _nx_secure_tls_session_renegotiate
 #define nx_secure_tls_session_renegotiate_callback_set     _nx_secure_tls_session_renegotiate_callback_set
 #define nx_secure_tls_session_reset                        _nx_secure_tls_session_reset
+#define nx_secure_tls_session_resumption_get               _nx_secure_tls_session_resumption_get
+#define nx_secure_tls_session_resumption_set               _nx_secure_tls_session_resumption_set
 #define nx_secure_tls_session_send                         _nx_secure_tls_session_send
 #define nx_secure_tls_session_server_callback_set          _nx_secure_tls_session_server_callback_set
 #define nx_secure_tls_session_sni_extension_parse          _nx_secure_tls_session_sni_extension_parse
@@ -141,6 +143,8 @@ extern   "C" {
 #define nx_secure_tls_session_renegotiate                  _nxe_secure_tls_session_renegotiate
 #define nx_secure_tls_session_renegotiate_callback_set     _nxe_secure_tls_session_renegotiate_callback_set
 #define nx_secure_tls_session_reset                        _nxe_secure_tls_session_reset
+#define nx_secure_tls_session_resumption_get               _nxe_secure_tls_session_resumption_get
+#define nx_secure_tls_session_resumption_set               _nxe_secure_tls_session_resumption_set
 #define nx_secure_tls_session_send                         _nxe_secure_tls_session_send
 #define nx_secure_tls_session_server_callback_set          _nxe_secure_tls_session_server_callback_set
 #define nx_secure_tls_session_sni_extension_parse          _nxe_secure_tls_session_sni_extension_parse
@@ -226,6 +230,12 @@ UINT nx_secure_tls_session_renegotiate(NX_SECURE_TLS_SESSION *tls_session, UINT
 UINT nx_secure_tls_session_renegotiate_callback_set(NX_SECURE_TLS_SESSION *tls_session,
                                                     ULONG (*func_ptr)(NX_SECURE_TLS_SESSION *session));
 UINT nx_secure_tls_session_reset(NX_SECURE_TLS_SESSION *tls_session);
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+UINT nx_secure_tls_session_resumption_get(NX_SECURE_TLS_SESSION *tls_session,
+                                          NX_SECURE_TLS_RESUMPTION *resumption, UINT *resumed);
+UINT nx_secure_tls_session_resumption_set(NX_SECURE_TLS_SESSION *tls_session,
+                                          const NX_SECURE_TLS_RESUMPTION *resumption);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
 UINT nx_secure_tls_session_send(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET *packet_ptr,
                                 ULONG wait_option);
 UINT nx_secure_tls_session_server_callback_set(NX_SECURE_TLS_SESSION *tls_session,
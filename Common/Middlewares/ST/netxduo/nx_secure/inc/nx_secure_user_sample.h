@@ -157,6 +157,14 @@
    #define NX_SECURE_ENABLE_AEAD_CIPHER
 */
 
+/* NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT decrypts a TLS 1.2 AEAD application data record in the
+   received packets when it is the last record queued, and returns those packets to the application
+   instead of a copy. It works only when NX_SECURE_ENABLE_AEAD_CIPHER is defined.
+   By default this feature is not enabled. */
+/*
+   #define NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT
+*/
+
 /* NX_SECURE_ENABLE_CLIENT_CERTIFICATE_VERIFY enables client certificate verification.
    By default this feature is not enabled. */
 /*
@@ -174,6 +182,21 @@
    #define NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE
 */
 
+/* NX_SECURE_X509_VERIFY_CACHE_SIZE defines the number of certificates whose signature check is
+   remembered by certificate chain verification. A certificate is found in the cache by a digest of
+   its signed data and of the signed data of its issuer, so only the signature check is skipped,
+   expiration is still checked by the caller. By default this feature is not enabled. */
+/*
+   #define NX_SECURE_X509_VERIFY_CACHE_SIZE 4
+*/
+
+/* NX_SECURE_X509_VERIFY_CACHE_DIGEST_SIZE defines the bytes of digest kept per certificate in the
+   verified certificate cache. Certificates signed with a shorter hash are not cached.
+   The default value is 32. */
+/*
+   #define NX_SECURE_X509_VERIFY_CACHE_DIGEST_SIZE 32
+*/
+
 /* NX_SECURE_KEY_CLEAR enables key related materials cleanup when they are not used anymore.
    By default this feature is not enabled. */
 /*
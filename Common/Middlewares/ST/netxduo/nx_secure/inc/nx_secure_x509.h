@@ -129,6 +129,13 @@ extern   "C" {
 #define NX_SECURE_X509_CRL_VERIFY_EXTENSION
 #endif /* NX_SECURE_X509_CRL_VERIFY_EXTENSION */
 
+/* Size of the digest kept per certificate in the verified certificate cache. */
+#ifdef NX_SECURE_X509_VERIFY_CACHE_SIZE
+#ifndef NX_SECURE_X509_VERIFY_CACHE_DIGEST_SIZE
+#define NX_SECURE_X509_VERIFY_CACHE_DIGEST_SIZE         32
+#endif /* NX_SECURE_X509_VERIFY_CACHE_DIGEST_SIZE */
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
+
 #ifndef NX_SECURE_X509_CERTIFICATE_INITIALIZE_EXTENSION
 #define NX_SECURE_X509_CERTIFICATE_INITIALIZE_EXTENSION
 #endif /* NX_SECURE_X509_CERTIFICATE_INITIALIZE_EXTENSION */
@@ -938,6 +945,15 @@ UINT _nx_secure_x509_certificate_verify(NX_SECURE_X509_CERTIFICATE_STORE *store,
 UINT _nx_secure_x509_certificate_chain_verify(NX_SECURE_X509_CERTIFICATE_STORE *store,
                                               NX_SECURE_X509_CERT *certificate);
 
+#ifdef NX_SECURE_X509_VERIFY_CACHE_SIZE
+/* Signature checks skipped (hits) and performed (misses) by _nx_secure_x509_certificate_chain_verify. */
+extern ULONG _nx_secure_x509_verify_cache_hits;
+extern ULONG _nx_secure_x509_verify_cache_misses;
+
+/* Forget every verified certificate. */
+VOID _nx_secure_x509_verify_cache_clear(VOID);
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
+
 /* Parse an OID string, returning an internally-used constant (defined above) for use in other parsing. */
 VOID _nx_secure_x509_oid_parse(const UCHAR *oid, ULONG length, UINT *oid_value);
 
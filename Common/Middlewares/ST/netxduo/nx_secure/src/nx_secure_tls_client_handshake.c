@@ -222,6 +222,16 @@ const NX_CRYPTO_METHOD
             /* Final handshake message from the server, process it (verify the server handshake hash). */
             status = _nx_secure_tls_process_finished(tls_session, packet_buffer, message_length);
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+            if (tls_session -> nx_secure_tls_session_resumed)
+            {
+                /* On an abbreviated handshake our own Finished comes last and covers the server Finished,
+                   so hash it and keep the hash handler until our Finished has been sent. */
+                _nx_secure_tls_handshake_hash_update(tls_session, packet_start, message_length + header_bytes);
+                break;
+            }
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
             /* For client, cleanup hash handler after received the finished message from server. */
             /* NOTE: we want to run all of the nx_crypto_cleanup calls regardless of the status of the finished processing above
                      so use a secondary status to track their return status values. */
@@ -417,6 +427,16 @@ const NX_CRYPTO_METHOD
 
                 _nx_secure_tls_handshake_hash_update(tls_session, packet_start, message_length + header_bytes);
             }
+
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+            if (tls_session -> nx_secure_tls_session_resumed)
+            {
+                /* The server accepted our session ID. The master secret was restored while processing
+                   the ServerHello, so derive the session keys now; the server ChangeCipherSpec and
+                   Finished follow directly. */
+                status = _nx_secure_tls_generate_keys(tls_session);
+            }
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
             break;
         case NX_SECURE_TLS_CLIENT_STATE_SERVER_CERTIFICATE:
             /* Processed a server certificate above. Here, we extract the public key and do any verification
@@ -587,6 +607,70 @@ const NX_CRYPTO_METHOD
         case NX_SECURE_TLS_CLIENT_STATE_HANDSHAKE_FINISHED:
             /* We processed a server finished message, completing the handshake. Verify all is good and if so,
                continue to the encrypted session. */
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+            if (tls_session -> nx_secure_tls_session_resumed)
+            {
+                /* Abbreviated handshake: the server has sent its ChangeCipherSpec and Finished, now
+                   respond with our own ChangeCipherSpec and Finished. */
+
+                /* Release the protection before suspending on nx_packet_allocate. */
+                tx_mutex_put(&_nx_secure_tls_protection);
+
+                status = _nx_secure_tls_packet_allocate(tls_session, packet_pool, &send_packet, wait_option);
+
+                /* Get the protection after nx_packet_allocate. */
+                tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
+
+                if (status == NX_SUCCESS)
+                {
+                    /* ChangeCipherSpec is NOT a handshake message, so send as a normal TLS record. */
+                    _nx_secure_tls_send_changecipherspec(tls_session, send_packet);
+
+                    status = _nx_secure_tls_send_record(tls_session, send_packet, NX_SECURE_TLS_CHANGE_CIPHER_SPEC, wait_option);
+
+                    if (status != NX_SUCCESS)
+                    {
+                        /* Release packet on send error. */
+                        nx_secure_tls_packet_release(send_packet);
+                    }
+                }
+
+                if (status == NX_SUCCESS)
+                {
+                    /* Reset the sequence number and switch to the new keys for our Finished. */
+                    NX_SECURE_MEMSET(tls_session -> nx_secure_tls_local_sequence_number, 0, sizeof(tls_session -> nx_secure_tls_local_sequence_number));
+
+                    _nx_secure_tls_session_keys_set(tls_session, NX_SECURE_TLS_KEY_SET_LOCAL);
+
+                    status = _nx_secure_tls_allocate_handshake_packet(tls_session, packet_pool, &send_packet, wait_option);
+                }
+
+                if (status == NX_SUCCESS)
+                {
+                    /* Generate and send the finished message, which completes the handshake. */
+                    _nx_secure_tls_send_finished(tls_session, send_packet);
+
+                    status = _nx_secure_tls_send_handshake_record(tls_session, send_packet, NX_SECURE_TLS_FINISHED, wait_option);
+                }
+
+#if (NX_SECURE_TLS_TLS_1_2_ENABLED)
+                /* Our Finished has been generated, cleanup the hash handler now. */
+                method_ptr = tls_session -> nx_secure_tls_crypto_table -> nx_secure_tls_handshake_hash_sha256_method;
+
+                if (method_ptr -> nx_crypto_cleanup != NX_NULL)
+                {
+                    temp_status = method_ptr -> nx_crypto_cleanup(tls_session -> nx_secure_tls_handshake_hash.nx_secure_tls_handshake_hash_sha256_metadata);
+                    if(temp_status != NX_CRYPTO_SUCCESS && status == NX_SUCCESS)
+                    {
+                        status = temp_status;
+                    }
+                }
+#endif /* (NX_SECURE_TLS_TLS_1_2_ENABLED) */
+            }
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
+            /* The server Finished has been verified, the handshake is complete. */
+            NX_PHASE_TRACE_END(NX_PHASE_TLS_HANDSHAKE);
             break;
         case NX_SECURE_TLS_CLIENT_STATE_HELLO_VERIFY: /* DTLS ONLY! */
         default:
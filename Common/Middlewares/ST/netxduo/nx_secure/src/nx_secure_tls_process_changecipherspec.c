@@ -101,8 +101,22 @@ UINT status = NX_SUCCESS;
         }
 #endif
 #ifndef NX_SECURE_TLS_CLIENT_DISABLED
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+        /* When resuming a session, the server sends its ChangeCipherSpec right after the ServerHello. */
+        if (tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_CLIENT &&
+            tls_session -> nx_secure_tls_session_resumed &&
+            tls_session -> nx_secure_tls_client_state != NX_SECURE_TLS_CLIENT_STATE_SERVERHELLO)
+        {
+            return(NX_SECURE_TLS_UNEXPECTED_MESSAGE);
+        }
+
+        if (tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_CLIENT &&
+            !tls_session -> nx_secure_tls_session_resumed &&
+            tls_session -> nx_secure_tls_client_state != NX_SECURE_TLS_CLIENT_STATE_SERVERHELLO_DONE)
+#else
         if (tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_CLIENT &&
             tls_session -> nx_secure_tls_client_state != NX_SECURE_TLS_CLIENT_STATE_SERVERHELLO_DONE)
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
         {
             return(NX_SECURE_TLS_UNEXPECTED_MESSAGE);
         }
@@ -305,7 +305,9 @@ ULONG                cert_buf_size;
         
     /* =============================== CERTIFICATE CHAIN VERIFICATION ======================================== */
     /* Verify the certificates we received are valid against the trusted store. */
+    NX_PHASE_TRACE_BEGIN(NX_PHASE_TLS_CERT_VERIFY);
     status = _nx_secure_tls_remote_certificate_verify(tls_session);
+    NX_PHASE_TRACE_END(NX_PHASE_TLS_CERT_VERIFY);
 
     if(status != NX_SUCCESS)
     {
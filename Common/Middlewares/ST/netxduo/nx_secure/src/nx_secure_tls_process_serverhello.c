@@ -167,6 +167,20 @@ NX_SECURE_TLS_SERVER_STATE            old_client_state = tls_session -> nx_secur
     }
     length += NX_SECURE_TLS_RANDOM_SIZE;
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+    /* The ClientHello carried a session ID only if it offered a saved session. The server
+       resumes that session by echoing the ID (RFC 5246, Section 7.4.1.3). */
+    if ((tls_session -> nx_secure_tls_session_id_length > 0) &&
+        (tls_session -> nx_secure_tls_resumption.nx_secure_tls_resumption_session_id_length > 0) &&
+        (packet_buffer[length] == tls_session -> nx_secure_tls_session_id_length) &&
+        ((length + 1 + packet_buffer[length]) <= message_length) &&
+        (NX_SECURE_MEMCMP(tls_session -> nx_secure_tls_session_id, &packet_buffer[length + 1],
+                          tls_session -> nx_secure_tls_session_id_length) == 0))
+    {
+        tls_session -> nx_secure_tls_session_resumed = NX_TRUE;
+    }
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
     /* Session ID length is one byte. */
     tls_session -> nx_secure_tls_session_id_length = packet_buffer[length];
     length++;
@@ -201,6 +215,26 @@ NX_SECURE_TLS_SERVER_STATE            old_client_state = tls_session -> nx_secur
         return(NX_SECURE_TLS_UNKNOWN_CIPHERSUITE);
     }
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+    if (tls_session -> nx_secure_tls_session_resumed)
+    {
+
+        /* A resumed session keeps the protocol version and ciphersuite it was established with. */
+        if ((version != tls_session -> nx_secure_tls_resumption.nx_secure_tls_resumption_protocol_version) ||
+            (ciphersuite != tls_session -> nx_secure_tls_resumption.nx_secure_tls_resumption_ciphersuite))
+        {
+            return(NX_SECURE_TLS_HANDSHAKE_FAILURE);
+        }
+
+        /* Restore the master secret, the session keys are derived from it and the new randoms. The
+           server proved its identity in the handshake that established the session. */
+        NX_SECURE_MEMCPY(tls_session -> nx_secure_tls_key_material.nx_secure_tls_master_secret,
+                         tls_session -> nx_secure_tls_resumption.nx_secure_tls_resumption_master_secret,
+                         NX_SECURE_TLS_MASTER_SIZE); /* Use case of memcpy is verified. */
+        tls_session -> nx_secure_tls_received_remote_credentials = NX_TRUE;
+    }
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
     /* Compression method - for now this should be NULL. */
     compression_method = packet_buffer[length];
 
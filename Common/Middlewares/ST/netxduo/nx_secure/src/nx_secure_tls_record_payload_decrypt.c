@@ -40,6 +40,13 @@ static UINT _nx_secure_tls_record_packet_decrypt(NX_SECURE_TLS_SESSION *tls_sess
                                                  UINT wait_option);
 static UINT _nx_secure_tls_data_decrypt(NX_SECURE_TLS_SESSION *tls_session,
                                         UCHAR *input, UCHAR *output, UINT length);
+#if defined(NX_SECURE_ENABLE_AEAD_CIPHER) && defined(NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT)
+static UINT _nx_secure_tls_record_in_place_decrypt(NX_SECURE_TLS_SESSION *tls_session,
+                                                   NX_PACKET *encrypted_packet, UINT offset,
+                                                   UINT message_length, NX_PACKET **decrypted_packet,
+                                                   UCHAR *additional_data, UINT additional_data_size,
+                                                   UCHAR *iv);
+#endif /* NX_SECURE_ENABLE_AEAD_CIPHER && NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT */
 
 /* Defined in nx_secure_tls_record_payload_encrypt.c */
 extern UCHAR _nx_secure_tls_record_block_buffer[NX_SECURE_TLS_MAX_CIPHER_BLOCK_SIZE];
@@ -85,6 +92,8 @@ extern UCHAR _nx_secure_tls_record_block_buffer[NX_SECURE_TLS_MAX_CIPHER_BLOCK_S
 /*    nx_secure_tls_packet_release          Release packet                */
 /*    _nx_secure_tls_record_chained_packet_decrypt                        */
 /*                                          Decrypt chained packet        */
+/*    _nx_secure_tls_record_in_place_decrypt                              */
+/*                                          Decrypt record in place       */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -121,6 +130,9 @@ UINT                                  icv_size;
 UCHAR                                 additional_data[13];
 UINT                                  additional_data_size;
 UCHAR                                 nonce[13];
+#ifdef NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT
+UINT                                  in_place = NX_FALSE;
+#endif /* NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT */
 #else
     NX_PARAMETER_NOT_USED(sequence_num);
     NX_PARAMETER_NOT_USED(record_type);
@@ -298,6 +310,18 @@ UCHAR                                 nonce[13];
 
             /* Decrypt data following the nonce_explicit. */
             offset += 8;
+
+#ifdef NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT
+            /* An application data record that ends the TLS record queue can be decrypted where
+               it was received, the queue then hands its packets over as the decrypted packet. */
+            if ((record_type == NX_SECURE_TLS_APPLICATION_DATA) &&
+                (message_length > icv_size) &&
+                (encrypted_packet == tls_session -> nx_secure_record_queue_header) &&
+                ((offset + message_length) == encrypted_packet -> nx_packet_length))
+            {
+                in_place = NX_TRUE;
+            }
+#endif /* NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT */
         }
 
         if (message_length < icv_size)
@@ -309,13 +333,29 @@ UCHAR                                 nonce[13];
         if (session_cipher_method -> nx_crypto_operation)
         {
 
-            /* Decrypt the message payload using the session crypto method, and move the decrypted data to the beginning of the buffer. */
-            status = _nx_secure_tls_record_chained_packet_decrypt(tls_session, encrypted_packet, offset,
-                                                                  message_length, decrypted_packet,
-                                                                  additional_data,
-                                                                  additional_data_size,
-                                                                  nonce,
-                                                                  wait_option);
+#ifdef NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT
+            if (in_place)
+            {
+
+                /* Decrypt the message payload in the received packets. */
+                status = _nx_secure_tls_record_in_place_decrypt(tls_session, encrypted_packet, offset,
+                                                                message_length, decrypted_packet,
+                                                                additional_data,
+                                                                additional_data_size,
+                                                                nonce);
+            }
+            else
+#endif /* NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT */
+            {
+
+                /* Decrypt the message payload using the session crypto method, and move the decrypted data to the beginning of the buffer. */
+                status = _nx_secure_tls_record_chained_packet_decrypt(tls_session, encrypted_packet, offset,
+                                                                      message_length, decrypted_packet,
+                                                                      additional_data,
+                                                                      additional_data_size,
+                                                                      nonce,
+                                                                      wait_option);
+            }
 #ifdef NX_SECURE_KEY_CLEAR
             NX_SECURE_MEMSET(additional_data, 0, sizeof(additional_data));
             NX_SECURE_MEMSET(nonce, 0, sizeof(nonce));
@@ -685,6 +725,296 @@ const NX_CRYPTO_METHOD *session_cipher_method;
     return(NX_SECURE_TLS_SUCCESS);
 }
 
+#if defined(NX_SECURE_ENABLE_AEAD_CIPHER) && defined(NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT)
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_record_in_place_decrypt              PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function authenticates and decrypts the payload of an incoming */
+/*    AEAD record in the received packet chain, without copying it to     */
+/*    another packet. The record must end the TLS record queue, whose     */
+/*    packets are handed over as the decrypted packet: the packets ahead  */
+/*    of the payload are released and the prepend pointer is moved past   */
+/*    the header and explicit nonce. The chain is ended at the last byte  */
+/*    of payload and the packets holding only ICV bytes are released.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    encrypted_packet                      Head of the TLS record queue  */
+/*    offset                                Offset of message data in     */
+/*                                            encrypted_packet            */
+/*    message_length                        Length of message data and    */
+/*                                            ICV in encrypted_packet     */
+/*    decrypted_packet                      Pointer to packet containing  */
+/*                                            decrypted_packet            */
+/*    additional_data                       Pointer to additional data    */
+/*    additional_data_size                  Size of additional data       */
+/*    iv                                    Pointer to IV                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    [nx_crypto_operation]                 Crypto operation              */
+/*    _nx_secure_tls_data_decrypt           Decrypt data                  */
+/*    nx_packet_data_extract_offset         Extract data from packet      */
+/*    nx_secure_tls_packet_release          Release packet                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_record_payload_decrypt Decrypt TLS record payload    */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_secure_tls_record_in_place_decrypt(NX_SECURE_TLS_SESSION *tls_session,
+                                                   NX_PACKET *encrypted_packet, UINT offset,
+                                                   UINT message_length, NX_PACKET **decrypted_packet,
+                                                   UCHAR *additional_data, UINT additional_data_size,
+                                                   UCHAR *iv)
+{
+UINT status;
+UCHAR *icv_ptr;
+UINT icv_size;
+UINT block_size;
+UINT length;
+UINT fragment_length;
+UINT copied_length;
+UINT remaining_length;
+UINT data_offset = offset;
+ULONG bytes_copied;
+NX_PACKET *packet_ptr = encrypted_packet;
+NX_PACKET *previous_packet = NX_NULL;
+NX_PACKET *first_packet;
+UINT first_offset;
+VOID *handler = NX_NULL;
+VOID *crypto_method_metadata;
+const NX_CRYPTO_METHOD *session_cipher_method;
+
+    /* Get ICV size and the block size the cipher updates must be rounded to. */
+    session_cipher_method = tls_session -> nx_secure_tls_session_ciphersuite -> nx_secure_tls_session_cipher;
+    icv_size = session_cipher_method -> nx_crypto_ICV_size_in_bits >> 3;
+    block_size = session_cipher_method -> nx_crypto_block_size_in_bytes;
+    if ((icv_size >= message_length) || (icv_size > sizeof(_nx_secure_tls_record_block_buffer)) ||
+        (block_size > sizeof(_nx_secure_tls_record_block_buffer)))
+    {
+
+        /* Invalid packet. */
+        return(NX_SECURE_TLS_INVALID_PACKET);
+    }
+    message_length -= icv_size;
+
+    /* Select our proper data structures. */
+    if (tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_SERVER)
+    {
+
+        /* The socket is a TLS server, so use the *CLIENT* cipher to decrypt. */
+        crypto_method_metadata = tls_session -> nx_secure_session_cipher_metadata_area_client;
+        handler = tls_session -> nx_secure_session_cipher_handler_client;
+    }
+    else
+    {
+
+        /* The socket is a TLS client, so use the *SERVER* cipher to decrypt. */
+        crypto_method_metadata = tls_session -> nx_secure_session_cipher_metadata_area_server;
+        handler = tls_session -> nx_secure_session_cipher_handler_server;
+    }
+
+    /* Set additional data pointer and length.  */
+    status = session_cipher_method -> nx_crypto_operation(NX_CRYPTO_DECRYPT_INITIALIZE,
+                                                          handler,
+                                                          (NX_CRYPTO_METHOD*)session_cipher_method,
+                                                          NX_NULL, 0,
+                                                          additional_data,
+                                                          additional_data_size,
+                                                          iv,
+                                                          NX_NULL,
+                                                          message_length,
+                                                          crypto_method_metadata,
+                                                          tls_session -> nx_secure_session_cipher_metadata_size,
+                                                          NX_NULL, NX_NULL);
+
+    if(status != NX_CRYPTO_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* Locate the packet holding the first byte of payload. */
+    fragment_length = (UINT)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr);
+    while (offset >= fragment_length)
+    {
+        offset -= fragment_length;
+        previous_packet = packet_ptr;
+        packet_ptr = packet_ptr -> nx_packet_next;
+        fragment_length = (UINT)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr);
+    }
+    first_packet = packet_ptr;
+    first_offset = offset;
+
+    /* Loop to decrypt data in the chained packet, overwriting the cipher text. */
+    remaining_length = message_length;
+    while (remaining_length > 0)
+    {
+
+        /* Skip to the packet holding the next byte. */
+        while (offset == (UINT)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr))
+        {
+            packet_ptr = packet_ptr -> nx_packet_next;
+            offset = 0;
+        }
+        fragment_length = (UINT)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr) - offset;
+
+        if ((fragment_length >= block_size) || (fragment_length >= remaining_length))
+        {
+
+            /* Decrypt the whole blocks in this packet, or the rest of the payload. */
+            length = fragment_length;
+            if (length >= remaining_length)
+            {
+                length = remaining_length;
+            }
+            else if (block_size)
+            {
+                length -= length % block_size;
+            }
+
+            status = _nx_secure_tls_data_decrypt(tls_session, packet_ptr -> nx_packet_prepend_ptr + offset,
+                                                 packet_ptr -> nx_packet_prepend_ptr + offset, length);
+            if (status)
+            {
+                return(status);
+            }
+
+            offset += length;
+        }
+        else
+        {
+
+            /* The block spans two packets. Decrypt it in _nx_secure_tls_record_block_buffer and write it back. */
+            length = block_size;
+            if (length > remaining_length)
+            {
+                length = remaining_length;
+            }
+
+            status = nx_packet_data_extract_offset(encrypted_packet, data_offset,
+                                                   _nx_secure_tls_record_block_buffer, length, &bytes_copied);
+            if (status || (bytes_copied != length))
+            {
+                return(NX_SECURE_TLS_INVALID_PACKET);
+            }
+
+            status = _nx_secure_tls_data_decrypt(tls_session, _nx_secure_tls_record_block_buffer,
+                                                 _nx_secure_tls_record_block_buffer, length);
+            if (status)
+            {
+                return(status);
+            }
+
+            for (copied_length = 0; copied_length < length; copied_length += fragment_length)
+            {
+                while (offset == (UINT)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr))
+                {
+                    packet_ptr = packet_ptr -> nx_packet_next;
+                    offset = 0;
+                }
+                fragment_length = (UINT)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr) - offset;
+                if (fragment_length > (length - copied_length))
+                {
+                    fragment_length = length - copied_length;
+                }
+
+                NX_SECURE_MEMCPY(packet_ptr -> nx_packet_prepend_ptr + offset,
+                                 &_nx_secure_tls_record_block_buffer[copied_length], fragment_length); /* Use case of memcpy is verified. */
+                offset += fragment_length;
+            }
+        }
+
+        data_offset += length;
+        remaining_length -= length;
+    }
+
+    /* Extract ICV, which follows the payload. */
+    icv_ptr = _nx_secure_tls_record_block_buffer;
+    status = nx_packet_data_extract_offset(encrypted_packet, data_offset,
+                                           icv_ptr, icv_size, &bytes_copied);
+    if (status || (bytes_copied != icv_size))
+    {
+        return(NX_SECURE_TLS_INVALID_PACKET);
+    }
+
+    status = session_cipher_method -> nx_crypto_operation(NX_CRYPTO_DECRYPT_CALCULATE,
+                                                          handler,
+                                                          (NX_CRYPTO_METHOD*)session_cipher_method,
+                                                          NX_NULL, 0,
+                                                          icv_ptr,
+                                                          icv_size,
+                                                          NX_NULL,
+                                                          NX_NULL,
+                                                          0,
+                                                          crypto_method_metadata,
+                                                          tls_session -> nx_secure_session_cipher_metadata_size,
+                                                          NX_NULL, NX_NULL);
+
+    if (status)
+    {
+        if (status == NX_CRYPTO_AUTHENTICATION_FAILED)
+        {
+            return(NX_SECURE_TLS_AEAD_DECRYPT_FAIL);
+        }
+        else
+        {
+            return(status);
+        }
+    }
+
+    /* Release the packets ahead of the payload, which hold processed records or this record header. */
+    if (previous_packet)
+    {
+        first_packet -> nx_packet_last = encrypted_packet -> nx_packet_last;
+        encrypted_packet -> nx_packet_last = previous_packet;
+        previous_packet -> nx_packet_next = NX_NULL;
+        nx_secure_tls_packet_release(encrypted_packet);
+    }
+
+    /* Start the packet at the payload. */
+    first_packet -> nx_packet_prepend_ptr += first_offset;
+    first_packet -> nx_packet_length = message_length;
+
+    /* End the chain at the last payload byte, so the ICV is trimmed from the fragments as well as the length. */
+    packet_ptr = first_packet;
+    remaining_length = message_length;
+    fragment_length = (UINT)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr);
+    while (remaining_length > fragment_length)
+    {
+        remaining_length -= fragment_length;
+        packet_ptr = packet_ptr -> nx_packet_next;
+        fragment_length = (UINT)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr);
+    }
+    packet_ptr -> nx_packet_append_ptr = packet_ptr -> nx_packet_prepend_ptr + remaining_length;
+
+    /* Release the packets holding only ICV bytes. */
+    if (packet_ptr -> nx_packet_next)
+    {
+        nx_secure_tls_packet_release(packet_ptr -> nx_packet_next);
+        packet_ptr -> nx_packet_next = NX_NULL;
+    }
+    first_packet -> nx_packet_last = (first_packet == packet_ptr) ? NX_NULL : packet_ptr;
+
+    /* The packets now belong to the decrypted packet. */
+    tls_session -> nx_secure_record_queue_header = NX_NULL;
+
+    *decrypted_packet = first_packet;
+    return(NX_SECURE_TLS_SUCCESS);
+}
+#endif /* NX_SECURE_ENABLE_AEAD_CIPHER && NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT */
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -946,6 +1276,8 @@ UINT original_offset = offset;
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    _nx_secure_tls_record_packet_decrypt  Decrypt data in packet        */
+/*    _nx_secure_tls_record_in_place_decrypt                              */
+/*                                          Decrypt record in place       */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
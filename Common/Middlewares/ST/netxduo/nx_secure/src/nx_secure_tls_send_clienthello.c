@@ -204,6 +204,22 @@ ULONG                      extension_length, total_extensions_length;
 
     /* Session ID length is one byte. */
     tls_session -> nx_secure_tls_session_id_length  = 0;
+
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+    /* Offer the session saved by the application so the server can resume it. Renegotiation
+       always uses a full handshake, and TLS 1.3 only resumes with PSKs. */
+    tls_session -> nx_secure_tls_session_resumed = NX_FALSE;
+    if ((tls_session -> nx_secure_tls_resumption.nx_secure_tls_resumption_session_id_length > 0) &&
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+        (!tls_session -> nx_secure_tls_1_3) &&
+#endif
+        (!tls_session -> nx_secure_tls_local_session_active))
+    {
+        tls_session -> nx_secure_tls_session_id_length = tls_session -> nx_secure_tls_resumption.nx_secure_tls_resumption_session_id_length;
+        NX_SECURE_MEMCPY(tls_session -> nx_secure_tls_session_id, tls_session -> nx_secure_tls_resumption.nx_secure_tls_resumption_session_id,
+                         tls_session -> nx_secure_tls_session_id_length); /* Use case of memcpy is verified. */
+    }
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
     packet_buffer[length] = tls_session -> nx_secure_tls_session_id_length;
     length++;
 
@@ -148,6 +148,12 @@ UINT temp_status;
     /* Clear out Session ID used for session re-negotiation. */
     NX_SECURE_MEMSET(session_ptr -> nx_secure_tls_session_id, 0, NX_SECURE_TLS_SESSION_ID_SIZE);
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+    /* Clear out the saved session state, it holds a master secret. */
+    NX_SECURE_MEMSET(&session_ptr -> nx_secure_tls_resumption, 0, sizeof(NX_SECURE_TLS_RESUMPTION));
+    session_ptr -> nx_secure_tls_session_resumed = NX_FALSE;
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
     /* Clear out sequence numbers for the current TLS session. */
     NX_SECURE_MEMSET(session_ptr -> nx_secure_tls_local_sequence_number, 0, sizeof(session_ptr -> nx_secure_tls_local_sequence_number));
     NX_SECURE_MEMSET(session_ptr -> nx_secure_tls_remote_sequence_number, 0, sizeof(session_ptr -> nx_secure_tls_remote_sequence_number));
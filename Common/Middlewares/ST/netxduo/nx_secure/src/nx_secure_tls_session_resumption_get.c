@@ -0,0 +1,113 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_tls.h"
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_session_resumption_get               PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function gets the state of an established TLS 1.2 client       */
+/*    session so the application can offer it again with                  */
+/*    nx_secure_tls_session_resumption_set on a later connection to the   */
+/*    same server. It also reports whether the handshake of this session  */
+/*    resumed an earlier one. The state holds the master secret and must  */
+/*    be kept as private as the session keys.                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    resumption                            Returned session state        */
+/*    resumed                               Returned NX_TRUE if the       */
+/*                                            handshake was resumed,      */
+/*                                            optional                    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                          Get protection mutex          */
+/*    tx_mutex_put                          Put protection mutex          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+UINT _nx_secure_tls_session_resumption_get(NX_SECURE_TLS_SESSION *tls_session,
+                                           NX_SECURE_TLS_RESUMPTION *resumption, UINT *resumed)
+{
+UINT status = NX_SUCCESS;
+
+    /* Get the protection. */
+    tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
+
+    if (!tls_session -> nx_secure_tls_local_session_active || !tls_session -> nx_secure_tls_remote_session_active ||
+        (tls_session -> nx_secure_tls_session_ciphersuite == NX_NULL))
+    {
+
+        /* The handshake has not completed. */
+        status = NX_SECURE_TLS_INVALID_STATE;
+    }
+    else if ((tls_session -> nx_secure_tls_protocol_version != NX_SECURE_TLS_VERSION_TLS_1_2) ||
+             (tls_session -> nx_secure_tls_session_id_length == 0) ||
+             (tls_session -> nx_secure_tls_session_id_length > NX_SECURE_TLS_RESUMPTION_SESSION_ID_SIZE))
+    {
+
+        /* Only TLS 1.2 sessions the server assigned an ID to can be resumed. */
+        status = NX_SECURE_TLS_UNSUPPORTED_FEATURE;
+    }
+    else
+    {
+        NX_SECURE_MEMCPY(resumption -> nx_secure_tls_resumption_session_id, tls_session -> nx_secure_tls_session_id,
+                         tls_session -> nx_secure_tls_session_id_length); /* Use case of memcpy is verified. */
+        resumption -> nx_secure_tls_resumption_session_id_length = tls_session -> nx_secure_tls_session_id_length;
+        resumption -> nx_secure_tls_resumption_protocol_version = tls_session -> nx_secure_tls_protocol_version;
+        resumption -> nx_secure_tls_resumption_ciphersuite =
+            tls_session -> nx_secure_tls_session_ciphersuite -> nx_secure_tls_ciphersuite;
+        NX_SECURE_MEMCPY(resumption -> nx_secure_tls_resumption_master_secret,
+                         tls_session -> nx_secure_tls_key_material.nx_secure_tls_master_secret,
+                         NX_SECURE_TLS_MASTER_SIZE); /* Use case of memcpy is verified. */
+    }
+
+    if (resumed != NX_NULL)
+    {
+        *resumed = tls_session -> nx_secure_tls_session_resumed;
+    }
+
+    /* Release the protection. */
+    tx_mutex_put(&_nx_secure_tls_protection);
+
+    return(status);
+}
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
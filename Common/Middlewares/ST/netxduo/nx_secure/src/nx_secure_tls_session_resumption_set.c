@@ -0,0 +1,80 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_tls.h"
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_session_resumption_set               PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the state of an earlier TLS 1.2 session, saved   */
+/*    with nx_secure_tls_session_resumption_get, for a TLS client to      */
+/*    offer in its next ClientHello. If the server resumes the session,   */
+/*    the certificate and key exchange messages are skipped and new keys  */
+/*    are derived from the saved master secret. Otherwise the handshake   */
+/*    falls back to a full handshake. A session ID length of zero clears  */
+/*    the offer.                                                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    resumption                            Saved session state           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                          Get protection mutex          */
+/*    tx_mutex_put                          Put protection mutex          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+UINT _nx_secure_tls_session_resumption_set(NX_SECURE_TLS_SESSION *tls_session,
+                                           const NX_SECURE_TLS_RESUMPTION *resumption)
+{
+
+    /* Get the protection. */
+    tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
+
+    /* Save the session state, the ClientHello offers it on the next handshake. */
+    NX_SECURE_MEMCPY(&tls_session -> nx_secure_tls_resumption, resumption, sizeof(NX_SECURE_TLS_RESUMPTION)); /* Use case of memcpy is verified. */
+
+    /* Release the protection. */
+    tx_mutex_put(&_nx_secure_tls_protection);
+
+    return(NX_SUCCESS);
+}
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
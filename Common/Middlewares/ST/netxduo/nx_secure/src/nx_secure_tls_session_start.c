@@ -156,6 +156,7 @@ NX_PACKET *send_packet;
         }
 
         /* Populate our packet with clienthello data. */
+        NX_PHASE_TRACE_BEGIN(NX_PHASE_TLS_HANDSHAKE);
         status = _nx_secure_tls_send_clienthello(tls_session, send_packet);
 
         if (status == NX_SUCCESS)
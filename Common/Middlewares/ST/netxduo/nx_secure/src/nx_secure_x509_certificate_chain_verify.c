@@ -24,6 +24,21 @@
 
 #include "nx_secure_x509.h"
 
+#ifdef NX_SECURE_X509_VERIFY_CACHE_SIZE
+/* Digests of the certificates whose signature was verified, see _nx_secure_x509_verify_cache_digest. */
+static UCHAR _nx_secure_x509_verify_cache[NX_SECURE_X509_VERIFY_CACHE_SIZE][NX_SECURE_X509_VERIFY_CACHE_DIGEST_SIZE];
+static UINT  _nx_secure_x509_verify_cache_count;
+static UINT  _nx_secure_x509_verify_cache_next;
+static UCHAR _nx_secure_x509_verify_cache_hash[64]; /* Large enough for SHA-512. */
+
+ULONG _nx_secure_x509_verify_cache_hits;
+ULONG _nx_secure_x509_verify_cache_misses;
+
+static UINT _nx_secure_x509_verify_cache_digest(NX_SECURE_X509_CERT *certificate,
+                                                NX_SECURE_X509_CERT *issuer_certificate,
+                                                UCHAR *digest);
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -56,6 +71,7 @@
 /*                                          Find a cert in a store        */
 /*    _nx_secure_x509_distinguished_name_compare                          */
 /*                                          Compare distinguished name    */
+/*    _nx_secure_x509_verify_cache_digest   Digest cert and issuer        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -83,6 +99,11 @@ NX_SECURE_X509_CERT *current_certificate;
 NX_SECURE_X509_CERT *issuer_certificate;
 UINT                 issuer_location = NX_SECURE_X509_CERT_LOCATION_NONE;
 INT                  compare_result;
+#ifdef NX_SECURE_X509_VERIFY_CACHE_SIZE
+UINT                 cache_status;
+UINT                 i;
+UCHAR                digest[NX_SECURE_X509_VERIFY_CACHE_DIGEST_SIZE];
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
 
     /* Process, following X509 basic certificate authentication (RFC 5280):
      *    1. Last certificate in chain is the end entity - start with it.
@@ -134,8 +155,49 @@ INT                  compare_result;
 #endif
         }
 
+#ifdef NX_SECURE_X509_VERIFY_CACHE_SIZE
+        /* A certificate verified before against the same issuer certificate does not need its signature checked again. */
+        cache_status = _nx_secure_x509_verify_cache_digest(current_certificate, issuer_certificate, digest);
+        status = NX_SECURE_X509_CERTIFICATE_NOT_FOUND;
+        if (cache_status == NX_SECURE_X509_SUCCESS)
+        {
+            for (i = 0; i < _nx_secure_x509_verify_cache_count; i++)
+            {
+                if (NX_SECURE_MEMCMP(_nx_secure_x509_verify_cache[i], digest, sizeof(digest)) == 0)
+                {
+                    _nx_secure_x509_verify_cache_hits++;
+                    status = NX_SECURE_X509_SUCCESS;
+                    break;
+                }
+            }
+        }
+
+        if (status != NX_SECURE_X509_SUCCESS)
+        {
+            if (cache_status == NX_SECURE_X509_SUCCESS)
+            {
+                _nx_secure_x509_verify_cache_misses++;
+            }
+
+            /* Verify the current certificate against its issuer certificate. */
+            status = _nx_secure_x509_certificate_verify(store, current_certificate, issuer_certificate);
+
+            if ((status == NX_SECURE_X509_SUCCESS) && (cache_status == NX_SECURE_X509_SUCCESS))
+            {
+
+                /* Remember the certificate, replacing the oldest entry once the cache is full. */
+                NX_SECURE_MEMCPY(_nx_secure_x509_verify_cache[_nx_secure_x509_verify_cache_next], digest, sizeof(digest)); /* Use case of memcpy is verified. */
+                _nx_secure_x509_verify_cache_next = (_nx_secure_x509_verify_cache_next + 1) % NX_SECURE_X509_VERIFY_CACHE_SIZE;
+                if (_nx_secure_x509_verify_cache_count < NX_SECURE_X509_VERIFY_CACHE_SIZE)
+                {
+                    _nx_secure_x509_verify_cache_count++;
+                }
+            }
+        }
+#else
         /* Verify the current certificate against its issuer certificate. */
         status = _nx_secure_x509_certificate_verify(store, current_certificate, issuer_certificate);
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
 
         if (status != 0)
         {
@@ -176,3 +238,194 @@ INT                  compare_result;
     return(NX_SECURE_X509_CHAIN_VERIFY_FAILURE);
 }
 
+#ifdef NX_SECURE_X509_VERIFY_CACHE_SIZE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_x509_verify_cache_digest                 PORTABLE C      */
+/*                                                           6.1.6        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the key of the verified certificate cache,   */
+/*    a digest over the signed data of the certificate and the signed     */
+/*    data of its issuer certificate, which holds the issuer public key   */
+/*    and KeyUsage. The hash of the certificate signature algorithm is    */
+/*    used, certificates signed with a hash shorter than the cache digest */
+/*    are not cached.                                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    certificate                           Pointer to certificate        */
+/*    issuer_certificate                    Pointer to issuer certificate */
+/*    digest                                Output digest                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_x509_find_certificate_methods                            */
+/*                                          Find certificate methods      */
+/*    [nx_crypto_init]                      Initialize crypto             */
+/*    [nx_crypto_operation]                 Crypto operation              */
+/*    [nx_crypto_cleanup]                   Cleanup crypto                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_x509_certificate_chain_verify                            */
+/*                                          Verify cert against stores    */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_secure_x509_verify_cache_digest(NX_SECURE_X509_CERT *certificate,
+                                                NX_SECURE_X509_CERT *issuer_certificate,
+                                                UCHAR *digest)
+{
+UINT                    status;
+UINT                    i;
+const NX_CRYPTO_METHOD *hash_method;
+NX_SECURE_X509_CRYPTO  *crypto_methods;
+VOID                   *handler = NX_CRYPTO_NULL;
+const UCHAR            *data[2];
+UINT                    data_length[2];
+
+    /* Find certificate crypto methods for this certificate. */
+    status = _nx_secure_x509_find_certificate_methods(certificate, (USHORT)certificate -> nx_secure_x509_signature_algorithm, &crypto_methods);
+    if (status != NX_SECURE_X509_SUCCESS)
+    {
+        return(status);
+    }
+    hash_method = crypto_methods -> nx_secure_x509_hash_method;
+
+    if (((hash_method -> nx_crypto_ICV_size_in_bits >> 3) < NX_SECURE_X509_VERIFY_CACHE_DIGEST_SIZE) ||
+        ((hash_method -> nx_crypto_ICV_size_in_bits >> 3) > sizeof(_nx_secure_x509_verify_cache_hash)) ||
+        (hash_method -> nx_crypto_operation == NX_CRYPTO_NULL))
+    {
+        return(NX_SECURE_X509_UNKNOWN_CERT_SIG_ALGORITHM);
+    }
+
+    if (hash_method -> nx_crypto_init)
+    {
+        status = hash_method -> nx_crypto_init((NX_CRYPTO_METHOD*)hash_method,
+                                               NX_CRYPTO_NULL,
+                                               0,
+                                               &handler,
+                                               certificate -> nx_secure_x509_hash_metadata_area,
+                                               certificate -> nx_secure_x509_hash_metadata_size);
+
+        if(status != NX_CRYPTO_SUCCESS)
+        {
+            return(status);
+        }
+    }
+
+    status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_INITIALIZE,
+                                                handler,
+                                                (NX_CRYPTO_METHOD*)hash_method,
+                                                NX_CRYPTO_NULL,
+                                                0,
+                                                NX_CRYPTO_NULL,
+                                                0,
+                                                NX_CRYPTO_NULL,
+                                                NX_CRYPTO_NULL,
+                                                0,
+                                                certificate -> nx_secure_x509_hash_metadata_area,
+                                                certificate -> nx_secure_x509_hash_metadata_size,
+                                                NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+
+    /* Hash the signed data of the certificate, then of its issuer. */
+    data[0] = certificate -> nx_secure_x509_certificate_data;
+    data_length[0] = certificate -> nx_secure_x509_certificate_data_length;
+    data[1] = issuer_certificate -> nx_secure_x509_certificate_data;
+    data_length[1] = issuer_certificate -> nx_secure_x509_certificate_data_length;
+    for (i = 0; (i < 2) && (status == NX_CRYPTO_SUCCESS); i++)
+    {
+        status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_UPDATE,
+                                                    handler,
+                                                    (NX_CRYPTO_METHOD*)hash_method,
+                                                    NX_CRYPTO_NULL,
+                                                    0,
+                                                    (UCHAR *)data[i],
+                                                    data_length[i],
+                                                    NX_CRYPTO_NULL,
+                                                    NX_CRYPTO_NULL,
+                                                    0,
+                                                    certificate -> nx_secure_x509_hash_metadata_area,
+                                                    certificate -> nx_secure_x509_hash_metadata_size,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    }
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_CALCULATE,
+                                                    handler,
+                                                    (NX_CRYPTO_METHOD*)hash_method,
+                                                    NX_CRYPTO_NULL,
+                                                    0,
+                                                    NX_CRYPTO_NULL,
+                                                    0,
+                                                    NX_CRYPTO_NULL,
+                                                    _nx_secure_x509_verify_cache_hash,
+                                                    sizeof(_nx_secure_x509_verify_cache_hash),
+                                                    certificate -> nx_secure_x509_hash_metadata_area,
+                                                    certificate -> nx_secure_x509_hash_metadata_size,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    }
+
+    if (hash_method -> nx_crypto_cleanup)
+    {
+        hash_method -> nx_crypto_cleanup(certificate -> nx_secure_x509_hash_metadata_area);
+    }
+
+    if (status != NX_CRYPTO_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* Longer digests are truncated to the cache digest size. */
+    NX_SECURE_MEMCPY(digest, _nx_secure_x509_verify_cache_hash, NX_SECURE_X509_VERIFY_CACHE_DIGEST_SIZE); /* Use case of memcpy is verified. */
+    NX_SECURE_MEMSET(_nx_secure_x509_verify_cache_hash, 0, sizeof(_nx_secure_x509_verify_cache_hash));
+
+    return(NX_SECURE_X509_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_x509_verify_cache_clear                  PORTABLE C      */
+/*                                                           6.1.6        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function empties the verified certificate cache, the next      */
+/*    chain verification checks every signature again. The application   */
+/*    calls it when it stops trusting a certificate it trusted before,    */
+/*    such as a revoked intermediate. The hit and miss counters are kept. */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+VOID _nx_secure_x509_verify_cache_clear(VOID)
+{
+    NX_SECURE_MEMSET(_nx_secure_x509_verify_cache, 0, sizeof(_nx_secure_x509_verify_cache));
+    _nx_secure_x509_verify_cache_count = 0;
+    _nx_secure_x509_verify_cache_next = 0;
+}
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
@@ -0,0 +1,96 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_tls.h"
+
+/* Bring in externs for caller checking code.  */
+
+NX_SECURE_CALLER_CHECKING_EXTERNS
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxe_secure_tls_session_resumption_get              PORTABLE C      */
+/*                                                           6.1          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors when getting the state of a TLS     */
+/*    client session for later resumption.                                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    resumption                            Returned session state        */
+/*    resumed                               Returned NX_TRUE if the       */
+/*                                            handshake was resumed,      */
+/*                                            optional                    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_tls_session_resumption_get Actual get function           */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION
+UINT _nxe_secure_tls_session_resumption_get(NX_SECURE_TLS_SESSION *tls_session,
+                                            NX_SECURE_TLS_RESUMPTION *resumption, UINT *resumed)
+{
+UINT status;
+
+    if ((tls_session == NX_NULL) || (resumption == NX_NULL))
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Make sure the session is initialized. */
+    if(tls_session -> nx_secure_tls_id != NX_SECURE_TLS_ID)
+    {
+        return(NX_SECURE_TLS_SESSION_UNINITIALIZED);
+    }
+
+    /* Only a TLS client can resume a session. */
+    if (tls_session -> nx_secure_tls_socket_type != NX_SECURE_TLS_SESSION_TYPE_CLIENT)
+    {
+        return(NX_SECURE_TLS_INVALID_STATE);
+    }
+
+    /* Check for appropriate caller.  */
+    NX_THREADS_ONLY_CALLER_CHECKING
+
+    status = _nx_secure_tls_session_resumption_get(tls_session, resumption, resumed);
+
+    /* Return completion status.  */
+    return(status);
+}
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_RESUMPTION */
+
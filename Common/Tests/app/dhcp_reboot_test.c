@@ -0,0 +1,303 @@
+/**
+  ******************************************************************************
+  * @file    dhcp_reboot_test.c
+  * @brief   DHCP INIT-REBOOT with the lease of the previous boot
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* dhcp_connect of the board against the DHCP server of NetX Duo on a router
+   of the segment, with the lease storage in RAM standing for the EEPROM. The
+   source of the board is included to reboot its DHCP client: the client is
+   stopped and deleted, the address and the ARP cache of the device cleared,
+   and dhcp_started set back as at power up. The storage and the server keep
+   their state, as across a reboot.
+
+   Each boot reports the time to address, the messages the server answered
+   and the writes to the storage:
+   - first: an empty storage, DISCOVER / OFFER / REQUEST / ACK, the lease is
+     stored;
+   - reboot: one REQUEST for the stored lease, no DISCOVER, no write;
+   - reconnect: dhcp_connect again with the client still bound, as
+     MX_NetXDuo_Connect after a lost connection, no message and no write;
+   - moved: the stored address is not the one the server has for the device,
+     it answers NAK and the client discovers, the new lease is stored;
+   - silent: the server does not answer the INIT-REBOOT request, the device
+     discovers after DHCP_INIT_REBOOT_WAIT and gets the stored lease again,
+     no write;
+   - corrupt: the record fails its checksum, the device discovers straight
+     away.
+
+   The link has a 120 ms round trip, virtual time only moves while every
+   thread waits. The bound address is probed with ARP before it is used, the
+   probes are part of every time. */
+
+#include "app_netxduo.c"
+
+#include "nx_azure_iot_trace.h"
+#include "nx_host_link.h"
+#include "test_common.h"
+#include "test_dhcp.h"
+
+#define TEST_PRIORITY       12
+#define ROUTER_PACKETS      32
+
+/* The link: 50 ms one way, 2 Mbit/s. */
+#define LINK_DELAY          5
+#define LINK_RATE           2500
+#define LINK_QUEUE          (64 * 1024)
+#define ROUND_TRIP          (2 * (LINK_DELAY + 1))
+
+#define ROUTER_ADDRESS      TEST_NET_ADDRESS(1)
+#define LEASE_FIRST         TEST_NET_ADDRESS(100)
+#define LEASE_LAST          TEST_NET_ADDRESS(120)
+#define MOVED_ADDRESS       TEST_NET_ADDRESS(110)
+
+/* Offsets in a DHCP frame from the device, with an IP header without options. */
+#define FRAME_UDP_DESTINATION   (14 + 20 + 2)
+#define FRAME_DHCP_OPTIONS      (14 + 20 + 8 + 240)
+#define DHCP_OPTION_PAD         0
+#define DHCP_OPTION_MESSAGE     53
+#define DHCP_OPTION_END         255
+#define DHCP_MESSAGE_DISCOVER   1
+#define DHCP_MESSAGE_REQUEST    3
+
+static TEST_NET_HOST router;
+static TX_THREAD     test_thread;
+static ULONG64       test_stack[16384 / sizeof(ULONG64)];
+
+/* The EEPROM of the lease, erased at power up. */
+static DHCP_LEASE lease_storage;
+static ULONG      lease_writes;
+
+/* The server ignores the INIT-REBOOT request, until the device discovers. */
+static UINT server_silent;
+
+static UINT lease_read(DHCP_LEASE* lease)
+{
+  *lease = lease_storage;
+  return NX_SUCCESS;
+}
+
+static UINT lease_write(const DHCP_LEASE* lease)
+{
+  lease_storage = *lease;
+  lease_writes++;
+  return NX_SUCCESS;
+}
+
+/* The DHCP message type of a frame sent to the server, 0 for other frames. */
+static UINT dhcp_message_type(UCHAR* frame, UINT length)
+{
+  UINT offset = FRAME_DHCP_OPTIONS;
+
+  if ((length <= offset) || (frame[12] != 0x08) || (frame[13] != 0x00) || (frame[23] != NX_PROTOCOL_UDP) ||
+      (((frame[FRAME_UDP_DESTINATION] << 8) | frame[FRAME_UDP_DESTINATION + 1]) != NX_DHCP_SERVER_UDP_PORT))
+  {
+    return 0;
+  }
+
+  while ((offset + 2 < length) && (frame[offset] != DHCP_OPTION_END))
+  {
+    if (frame[offset] == DHCP_OPTION_PAD)
+    {
+      offset++;
+      continue;
+    }
+    if (frame[offset] == DHCP_OPTION_MESSAGE)
+    {
+      return frame[offset + 2];
+    }
+    offset += 2 + frame[offset + 1];
+  }
+
+  return 0;
+}
+
+static UINT silent_filter(UINT from, UINT to, UCHAR* frame, UINT length)
+{
+  (void)to;
+
+  if (!server_silent || (from != nx_host_link_station_get(&IpInstance)))
+  {
+    return NX_FALSE;
+  }
+
+  switch (dhcp_message_type(frame, length))
+  {
+    case DHCP_MESSAGE_DISCOVER:
+      server_silent = NX_FALSE;
+      return NX_FALSE;
+
+    case DHCP_MESSAGE_REQUEST:
+      return NX_TRUE;
+
+    default:
+      return NX_FALSE;
+  }
+}
+
+/* Power the DHCP side of the device down and up, the storage stays. */
+static VOID device_reboot(VOID)
+{
+  nx_dhcp_stop(&DhcpClient);
+  nx_dhcp_reinitialize(&DhcpClient);
+  nx_dhcp_delete(&DhcpClient);
+  nx_arp_dynamic_entries_invalidate(&IpInstance);
+  dhcp_started = NX_FALSE;
+}
+
+/* One boot up to a bound address, return the ticks it took. */
+static ULONG boot_run(const CHAR* name, ULONG* address_ptr, TEST_DHCP_STATS* stats_ptr, ULONG* writes_ptr)
+{
+  TEST_DHCP_STATS before;
+  ULONG           start;
+  ULONG           ticks;
+  ULONG           writes = lease_writes;
+  ULONG           mask;
+
+  test_dhcp_stats_get(&before);
+  nx_azure_iot_trace_reset();
+
+  start = tx_time_get();
+  TEST_ASSERT(dhcp_connect() == NX_SUCCESS);
+  ticks = tx_time_get() - start;
+
+  /* The time to address the board records. */
+  TEST_ASSERT(nx_azure_iot_trace_get()->phase[NX_PHASE_DHCP_BOUND].last_ticks == ticks);
+
+  TEST_ASSERT(nx_ip_address_get(&IpInstance, address_ptr, &mask) == NX_SUCCESS);
+  TEST_ASSERT((*address_ptr >= LEASE_FIRST) && (*address_ptr <= LEASE_LAST));
+  TEST_ASSERT(mask == TEST_NET_MASK);
+
+  /* The stored lease is the bound one. */
+  TEST_ASSERT(lease_storage.magic == DHCP_LEASE_MAGIC);
+  TEST_ASSERT(lease_storage.ip_address == *address_ptr);
+  TEST_ASSERT(lease_storage.gateway_address == ROUTER_ADDRESS);
+
+  test_dhcp_stats_get(stats_ptr);
+  stats_ptr->discovers -= before.discovers;
+  stats_ptr->requests -= before.requests;
+  stats_ptr->declines -= before.declines;
+  stats_ptr->releases -= before.releases;
+  *writes_ptr = lease_writes - writes;
+
+  test_result("dhcp_reboot",
+      "\"boot\":\"%s\",\"address_ms\":%lu,\"discovers\":%lu,\"requests\":%lu,\"lease_writes\":%lu",
+      name,
+      ticks * (1000 / TX_TIMER_TICKS_PER_SECOND),
+      stats_ptr->discovers,
+      stats_ptr->requests,
+      *writes_ptr);
+
+  return ticks;
+}
+
+static VOID test_entry(ULONG input)
+{
+  TEST_DHCP_STATS stats;
+  ULONG           first;
+  ULONG           ticks;
+  ULONG           address;
+  ULONG           bound;
+  ULONG           writes;
+
+  (void)input;
+
+  test_log_mute();
+  nx_host_link_configure(LINK_DELAY, LINK_RATE, LINK_QUEUE);
+  nx_host_link_filter_set(silent_filter);
+
+  memset(&lease_storage, 0xFF, sizeof(lease_storage));
+
+  TEST_ASSERT(MX_NetXDuo_Init() == NX_SUCCESS);
+  TEST_ASSERT(MX_NetXDuo_Register_Lease_Storage(lease_read, lease_write) == NX_SUCCESS);
+
+  TEST_ASSERT(test_net_host_create(&router, "Router", ROUTER_ADDRESS, ROUTER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dhcp_create(&router, LEASE_FIRST, LEASE_LAST, ROUTER_ADDRESS) == NX_SUCCESS);
+
+  /* Full exchange, the lease is stored. */
+  first = boot_run("first", &bound, &stats, &writes);
+  TEST_ASSERT(stats.discovers == 1);
+  TEST_ASSERT(stats.requests == 1);
+  TEST_ASSERT(writes == 1);
+
+  /* The same lease, without DISCOVER / OFFER, and without a write. */
+  device_reboot();
+  ticks = boot_run("reboot", &address, &stats, &writes);
+  TEST_ASSERT(address == bound);
+  TEST_ASSERT(stats.discovers == 0);
+  TEST_ASSERT(stats.requests == 1);
+  TEST_ASSERT(writes == 0);
+  TEST_ASSERT(ticks + ROUND_TRIP <= first);
+
+  /* The client is still bound, the stored lease is read back and not written. */
+  boot_run("reconnect", &address, &stats, &writes);
+  TEST_ASSERT(address == bound);
+  TEST_ASSERT(stats.discovers == 0);
+  TEST_ASSERT(stats.requests == 0);
+  TEST_ASSERT(writes == 0);
+
+  /* Another address than the server has for the device, NAK then discovery.
+     The NAKed request is not counted. */
+  device_reboot();
+  lease_storage.ip_address = MOVED_ADDRESS;
+  lease_storage.checksum = dhcp_lease_checksum(&lease_storage);
+  boot_run("moved", &bound, &stats, &writes);
+  TEST_ASSERT(bound != MOVED_ADDRESS);
+  TEST_ASSERT(stats.discovers == 1);
+  TEST_ASSERT(stats.requests == 1);
+  TEST_ASSERT(writes == 1);
+
+  /* No answer to the INIT-REBOOT request, discovery after the bounded wait. */
+  device_reboot();
+  server_silent = NX_TRUE;
+  ticks = boot_run("silent", &address, &stats, &writes);
+  TEST_ASSERT(!server_silent);
+  TEST_ASSERT(address == bound);
+  TEST_ASSERT(stats.discovers == 1);
+  TEST_ASSERT(writes == 0);
+  TEST_ASSERT(ticks >= DHCP_INIT_REBOOT_WAIT);
+  TEST_ASSERT(ticks < DHCP_INIT_REBOOT_WAIT + first + ROUND_TRIP);
+
+  /* A record that fails its checksum is not requested. */
+  device_reboot();
+  lease_storage.lease_time ^= 1;
+  ticks = boot_run("corrupt", &address, &stats, &writes);
+  TEST_ASSERT(stats.discovers == 1);
+  TEST_ASSERT(stats.requests == 1);
+  TEST_ASSERT(writes == 1);
+  TEST_ASSERT(ticks < DHCP_INIT_REBOOT_WAIT);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100000);
+}
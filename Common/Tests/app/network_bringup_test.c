@@ -0,0 +1,344 @@
+/**
+  ******************************************************************************
+  * @file    network_bringup_test.c
+  * @brief   Network bring-up time, concurrent against sequential
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* app_netxduo.c of the board brings the device up on the simulated segment:
+   a router leases the address with the DHCP server of NetX Duo and answers
+   the DNS queries, four NTP responders stand for the pool servers. The first
+   connect reports the time of each stage, link, DHCP, and DNS with SNTP.
+   Then, for each script of server delays, the test runs the two bring-ups
+   from a bound address and an empty DNS cache, up to the endpoint address
+   the hub connect needs:
+   - concurrent, MX_NetXDuo_Connect of the board: the SNTP request goes to
+     every pool address at once and the endpoint is resolved while the
+     answers are in flight, the connect then finds it in the cache;
+   - sequential, the bring-up before it, with the NetX SNTP client: each pool
+     name is resolved and queried on its own for up to 10 s, the endpoint is
+     resolved after the sync.
+   It reports both times and the saving, and checks the concurrent one is
+   never slower, that it does not wait for a silent or slow first server,
+   that it takes a reply coming after its retries were sent, and that the
+   clock it sets is the time of the servers.
+
+   The link has a 120 ms round trip. Virtual time only moves while every
+   thread waits, the times hold the network and server delays. */
+
+#include "app_netxduo.h"
+#include "nx_azure_iot_trace.h"
+#include "test_common.h"
+#include "test_dhcp.h"
+#include "test_dns.h"
+#include "test_ntp.h"
+
+#define TEST_PRIORITY       12
+#define ROUTER_PACKETS      32
+#define NTP_PACKETS         16
+#define NTP_SERVERS         4
+
+/* The link: 50 ms one way, 2 Mbit/s. */
+#define LINK_DELAY          5
+#define LINK_RATE           2500
+#define LINK_QUEUE          (64 * 1024)
+#define ROUND_TRIP          (2 * (LINK_DELAY + 1))
+
+#define ROUTER_ADDRESS      TEST_NET_ADDRESS(1)
+#define NTP_ADDRESS(i)      TEST_NET_ADDRESS(11 + (i))
+#define LEASE_FIRST         TEST_NET_ADDRESS(100)
+#define LEASE_LAST          TEST_NET_ADDRESS(120)
+#define ENDPOINT_HOSTNAME   "bringup-hub.azure-devices.net"
+#define ENDPOINT_ADDRESS    TEST_NET_ADDRESS(50)
+
+/* The sequential bring-up waits this long for each server, SNTP_WAIT_TIME
+   before the concurrent one. */
+#define SNTP_WAIT_TIME      (10 * NX_IP_PERIODIC_RATE)
+#define SNTP_UPDATE_EVENT   1
+
+/* The clock set by the bring-up is within this of the servers. */
+#define CLOCK_TOLERANCE_MS  30
+
+/* SNTP_SERVER of app_netxduo.c. The first pool name returns every server,
+   as the pool does, the others one each. */
+static const CHAR* sntp_names[NTP_SERVERS] = {
+    "0.pool.ntp.org",
+    "1.pool.ntp.org",
+    "2.pool.ntp.org",
+    "3.pool.ntp.org",
+};
+
+/* Delays in ticks, silent is a mask of the NTP servers that do not answer. */
+typedef struct BRINGUP_SCRIPT_STRUCT
+{
+  const CHAR* name;
+  ULONG       dns_delay;
+  ULONG       ntp_delay[NTP_SERVERS];
+  UINT        silent;
+} BRINGUP_SCRIPT;
+
+static const BRINGUP_SCRIPT scripts[] = {
+    {"baseline", 0, {0, 0, 0, 0}, 0},
+    {"first_silent", 0, {0, 0, 0, 0}, 1 << 0},
+    {"first_slow", 0, {300, 0, 0, 0}, 0},
+    {"slow_servers", 0, {20, 10, 40, 30}, 0},
+    {"slow_dns", 30, {0, 0, 0, 0}, 0},
+    {"all_slow", 0, {150, 150, 150, 150}, 0},
+};
+
+static TEST_DNS             dns;
+static TEST_NTP             ntp[NTP_SERVERS];
+static TX_THREAD            test_thread;
+static ULONG64              test_stack[16384 / sizeof(ULONG64)];
+static NX_SNTP_CLIENT       sntp_client;
+static TX_EVENT_FLAGS_GROUP sntp_events;
+
+static VOID sntp_update_notify(NX_SNTP_TIME_MESSAGE* time_update_ptr, NX_SNTP_TIME* local_time)
+{
+  (void)time_update_ptr;
+  (void)local_time;
+
+  tx_event_flags_set(&sntp_events, SNTP_UPDATE_EVENT, TX_OR);
+}
+
+static VOID dns_cache_flush(VOID)
+{
+  TEST_ASSERT(nx_dns_cache_initialize(&DnsClient, DnsClient.nx_dns_cache, DnsClient.nx_dns_cache_size) == NX_SUCCESS);
+}
+
+/* Resolve the endpoint as the hub connect does, return the ticks it took. */
+static ULONG endpoint_resolve(VOID)
+{
+  ULONG start = tx_time_get();
+  ULONG address;
+
+  TEST_ASSERT(nx_dns_host_by_name_get(&DnsClient, (UCHAR*)ENDPOINT_HOSTNAME, &address, DEFAULT_TIMEOUT) ==
+              NX_SUCCESS);
+  TEST_ASSERT(address == ENDPOINT_ADDRESS);
+
+  return tx_time_get() - start;
+}
+
+/* The clock of the device is the clock of the servers. */
+static VOID clock_check(VOID)
+{
+  ULONG64 unix_ms;
+  ULONG64 server_ms = TEST_NTP_UNIX_TIME * 1000ULL + tx_time_get() * (1000 / TX_TIMER_TICKS_PER_SECOND);
+
+  TEST_ASSERT(sntp_time_ms(&unix_ms) == NX_SUCCESS);
+  TEST_ASSERT((unix_ms + CLOCK_TOLERANCE_MS >= server_ms) && (unix_ms <= server_ms + CLOCK_TOLERANCE_MS));
+}
+
+/* The bring-up before the concurrent one, from the DNS server on. Return the
+   ticks it took and the server that answered. */
+static ULONG sequential_run(UINT* server_ptr)
+{
+  ULONG       start = tx_time_get();
+  ULONG       events;
+  NXD_ADDRESS address;
+  UINT        server;
+
+  tx_event_flags_get(&sntp_events, SNTP_UPDATE_EVENT, TX_OR_CLEAR, &events, TX_NO_WAIT);
+
+  for (server = 0; server < NTP_SERVERS; server++)
+  {
+    nx_sntp_client_stop(&sntp_client);
+
+    TEST_ASSERT(nxd_dns_host_by_name_get(&DnsClient, (UCHAR*)sntp_names[server], &address, DEFAULT_TIMEOUT,
+                    NX_IP_VERSION_V4) == NX_SUCCESS);
+    TEST_ASSERT(nxd_sntp_client_initialize_unicast(&sntp_client, &address) == NX_SUCCESS);
+    TEST_ASSERT(nx_sntp_client_run_unicast(&sntp_client) == NX_SUCCESS);
+
+    if (tx_event_flags_get(&sntp_events, SNTP_UPDATE_EVENT, TX_OR_CLEAR, &events, SNTP_WAIT_TIME) == TX_SUCCESS)
+    {
+      break;
+    }
+  }
+  nx_sntp_client_stop(&sntp_client);
+
+  TEST_ASSERT(server < NTP_SERVERS);
+  *server_ptr = server;
+
+  endpoint_resolve();
+
+  return tx_time_get() - start;
+}
+
+/* MX_NetXDuo_Connect from a bound address, then the endpoint. */
+static ULONG concurrent_run(ULONG* endpoint_ticks)
+{
+  ULONG start = tx_time_get();
+
+  TEST_ASSERT(MX_NetXDuo_Connect(ENDPOINT_HOSTNAME) == NX_SUCCESS);
+  clock_check();
+  *endpoint_ticks = endpoint_resolve();
+
+  return tx_time_get() - start;
+}
+
+/* The first connect, with the phase trace of each stage. */
+static VOID cold_run(VOID)
+{
+  const AZURE_IOT_PHASE_TRACE* trace_ptr = nx_azure_iot_trace_get();
+  TEST_DHCP_STATS              stats;
+  ULONG                        start = tx_time_get();
+
+  nx_azure_iot_trace_reset();
+  TEST_ASSERT(MX_NetXDuo_Connect(ENDPOINT_HOSTNAME) == NX_SUCCESS);
+  clock_check();
+  TEST_ASSERT(endpoint_resolve() == 0);
+
+  test_dhcp_stats_get(&stats);
+  TEST_ASSERT(stats.discovers >= 1);
+
+  test_result("network_bringup",
+      "\"phase\":\"cold\",\"total_ms\":%lu,\"link_ms\":%lu,\"dhcp_ms\":%lu,\"sntp_ms\":%lu",
+      (tx_time_get() - start) * (1000 / TX_TIMER_TICKS_PER_SECOND),
+      trace_ptr->phase[NX_PHASE_LINK_UP].last_ticks * (1000 / TX_TIMER_TICKS_PER_SECOND),
+      trace_ptr->phase[NX_PHASE_DHCP_BOUND].last_ticks * (1000 / TX_TIMER_TICKS_PER_SECOND),
+      trace_ptr->phase[NX_PHASE_SNTP_SYNC].last_ticks * (1000 / TX_TIMER_TICKS_PER_SECOND));
+}
+
+static VOID script_run(const BRINGUP_SCRIPT* script_ptr)
+{
+  ULONG concurrent;
+  ULONG sequential;
+  ULONG endpoint_ticks;
+  ULONG fastest = ~(ULONG)0;
+  UINT  server;
+  UINT  i;
+
+  test_dns_delay_set(&dns, script_ptr->dns_delay);
+  for (i = 0; i < NTP_SERVERS; i++)
+  {
+    if (!((script_ptr->silent >> i) & 1) && (script_ptr->ntp_delay[i] < fastest))
+    {
+      fastest = script_ptr->ntp_delay[i];
+    }
+    test_ntp_delay_set(&ntp[i], script_ptr->ntp_delay[i]);
+    test_ntp_silent_set(&ntp[i], (script_ptr->silent >> i) & 1);
+  }
+
+  dns_cache_flush();
+  concurrent = concurrent_run(&endpoint_ticks);
+
+  /* Let the late answers of the concurrent requests go. */
+  tx_thread_sleep(SNTP_WAIT_TIME);
+
+  dns_cache_flush();
+  sequential = sequential_run(&server);
+
+  test_result("network_bringup",
+      "\"script\":\"%s\",\"concurrent_ms\":%lu,\"sequential_ms\":%lu,\"saving_ms\":%ld,"
+      "\"endpoint_ms\":%lu,\"sequential_server\":%u",
+      script_ptr->name,
+      concurrent * (1000 / TX_TIMER_TICKS_PER_SECOND),
+      sequential * (1000 / TX_TIMER_TICKS_PER_SECOND),
+      ((LONG)sequential - (LONG)concurrent) * (1000 / TX_TIMER_TICKS_PER_SECOND),
+      endpoint_ticks * (1000 / TX_TIMER_TICKS_PER_SECOND),
+      server);
+
+  /* The endpoint comes from the cache, and no server is waited for past the fastest. */
+  TEST_ASSERT(endpoint_ticks == 0);
+  TEST_ASSERT(concurrent <= sequential);
+  if (script_ptr == &scripts[0])
+  {
+    /* One round trip to the DNS server, one to the time servers. */
+    TEST_ASSERT(concurrent == 2 * ROUND_TRIP);
+  }
+  if (script_ptr->silent & 1)
+  {
+    TEST_ASSERT(sequential >= SNTP_WAIT_TIME);
+    TEST_ASSERT(concurrent < SNTP_WAIT_TIME / 2);
+  }
+  if ((script_ptr->ntp_delay[0] > NX_IP_PERIODIC_RATE) && (fastest < NX_IP_PERIODIC_RATE))
+  {
+    TEST_ASSERT(concurrent < script_ptr->ntp_delay[0]);
+  }
+  if (fastest > NX_IP_PERIODIC_RATE)
+  {
+    /* Every reply comes after the first retry, the reply to the first
+       request is taken. */
+    TEST_ASSERT(concurrent <= 2 * ROUND_TRIP + fastest);
+  }
+}
+
+static VOID test_entry(ULONG input)
+{
+  UINT i;
+
+  (void)input;
+
+  test_log_mute();
+  nx_host_link_configure(LINK_DELAY, LINK_RATE, LINK_QUEUE);
+
+  TEST_ASSERT(MX_NetXDuo_Init() == NX_SUCCESS);
+
+  TEST_ASSERT(test_dns_create(&dns, ROUTER_ADDRESS, ROUTER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dhcp_create(&dns.host, LEASE_FIRST, LEASE_LAST, ROUTER_ADDRESS) == NX_SUCCESS);
+  for (i = 0; i < NTP_SERVERS; i++)
+  {
+    TEST_ASSERT(test_ntp_create(&ntp[i], NTP_ADDRESS(i), NTP_PACKETS) == NX_SUCCESS);
+    TEST_ASSERT(test_dns_record_add(&dns, sntp_names[0], NTP_ADDRESS(i)) == NX_SUCCESS);
+
+    /* The pool servers are behind the router, whose address is resolved by the
+       time of the first request. Here they are on the segment, the static
+       entries keep an ARP round trip out of the first request. */
+    TEST_ASSERT(nx_arp_static_entry_create(&IpInstance,
+                    NTP_ADDRESS(i),
+                    ntp[i].host.ip.nx_ip_interface[0].nx_interface_physical_address_msw,
+                    ntp[i].host.ip.nx_ip_interface[0].nx_interface_physical_address_lsw) == NX_SUCCESS);
+    if (i > 0)
+    {
+      TEST_ASSERT(test_dns_record_add(&dns, sntp_names[i], NTP_ADDRESS(i)) == NX_SUCCESS);
+    }
+  }
+  TEST_ASSERT(test_dns_record_add(&dns, ENDPOINT_HOSTNAME, ENDPOINT_ADDRESS) == NX_SUCCESS);
+
+  /* The NetX SNTP client of the sequential bring-up, set up as it was. */
+  TEST_ASSERT(tx_event_flags_create(&sntp_events, "SNTP events") == TX_SUCCESS);
+  TEST_ASSERT(nx_sntp_client_create(&sntp_client, &IpInstance, 0, &AppPool, NX_NULL, NX_NULL, NX_NULL) ==
+              NX_SUCCESS);
+  TEST_ASSERT(nx_sntp_client_set_local_time(&sntp_client, 0, 0) == NX_SUCCESS);
+  TEST_ASSERT(nx_sntp_client_set_time_update_notify(&sntp_client, sntp_update_notify) == NX_SUCCESS);
+
+  cold_run();
+
+  for (i = 0; i < sizeof(scripts) / sizeof(scripts[0]); i++)
+  {
+    script_run(&scripts[i]);
+  }
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100000);
+}
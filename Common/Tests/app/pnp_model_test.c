@@ -0,0 +1,636 @@
+/**
+  ******************************************************************************
+  * @file    pnp_model_test.c
+  * @brief   Generated model serializers and parser against the hand-written ones
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* pnp_model.c of the board, as dtdl_codegen.py generates it, against the code
+   app_azure_iot.c had before: the serializers with the names as string
+   literals and their strlen, and a strcmp chain over the writable property
+   names. The test checks:
+   - the telemetry object of the board, temperature, vibration, gyroscope and
+     led_state, is the same bytes either way, on several sets of values;
+   - each serializer stays within its PNP_MODEL_*_MAX_SIZE on the worst case
+     values, 7 integer digits and a sign, after a first property as the
+     separating comma is counted;
+   - an object with a double the JSON writer cannot print, or too large for
+     the rest of the buffer, fails and leaves the writer as it was, as the
+     objects are formatted from their fragments before one append;
+   - the parser finds each writable property of a desired document, as the
+     strcmp chain does, and stores the same values; a name outside the model,
+     of another length or of the same length, is NX_AZURE_IOT_NOT_FOUND, an
+     enum out of range or a value of another type is NX_NOT_SUCCESSFUL, and
+     both leave the stored values alone.
+
+   The benchmark reports the host time, generated and hand-written, of one
+   telemetry object, of one desired document with the JSON reader walking it
+   as the client does, and of one property from a reader already on its
+   value, which leaves the lookup and the value. The generated telemetry
+   object must be faster to write than the hand-written one. */
+
+#include <string.h>
+#include <time.h>
+
+#include "nx_azure_iot.h"
+#include "pnp_model.h"
+#include "test_common.h"
+
+#define TEST_PRIORITY       4
+#define JSON_SIZE           1024
+#define BENCH_RUNS          20000
+
+/* The names of app_azure_iot.c before the model was generated. */
+#define TELEMETRY_TEMPERATURE       "temperature"
+#define TELEMETRY_GYROSCOPE         "gyroscope"
+#define TELEMETRY_VIBRATION         "vibration"
+#define PROPERTY_LED_STATE          "led_state"
+#define PROPERTY_TELEMETRY_INTERVAL "telemetry_interval"
+#define PROPERTY_ACC_FULLSCALE      "acc_fullscale"
+#define PROPERTY_GYRO_FULLSCALE     "gyro_fullscale"
+
+/* The largest double of the model, 7 integer digits. */
+#define WORST_DOUBLE        -9999999.99
+
+/* Above 2^53, the JSON writer does not print it. */
+#define UNPRINTABLE_DOUBLE  1e17
+
+typedef UINT (*TELEMETRY_APPEND)(NX_AZURE_IOT_JSON_WRITER* json_writer, const PNP_MODEL_VIBRATION* vibration,
+    const PNP_MODEL_GYROSCOPE* gyroscope, double temperature);
+
+typedef UINT (*PROPERTY_PARSE)(const UCHAR* name, UINT name_length, NX_AZURE_IOT_JSON_READER* json_reader,
+    PNP_MODEL_WRITABLE_PROPERTIES* properties, PNP_MODEL_WRITABLE* property);
+
+/* A desired document of the hub, its version and every writable property. */
+static const CHAR desired[] =
+    "{\"telemetry_interval\":5,\"acc_fullscale\":2,\"gyro_fullscale\":3,\"$version\":7}";
+
+static TX_THREAD test_thread;
+static ULONG64   test_stack[8192 / sizeof(ULONG64)];
+
+static UINT reference_vector_append(NX_AZURE_IOT_JSON_WRITER* json_writer,
+    const CHAR*                                               name,
+    const CHAR*                                               axis_names[3],
+    const double                                              axis_values[3])
+{
+  UINT index;
+
+  if (nx_azure_iot_json_writer_append_property_name(json_writer, (UCHAR*)name, strlen(name)) ||
+      nx_azure_iot_json_writer_append_begin_object(json_writer))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  for (index = 0; index < 3; index++)
+  {
+    if (nx_azure_iot_json_writer_append_property_with_double_value(
+            json_writer, (UCHAR*)axis_names[index], strlen(axis_names[index]), axis_values[index], 2))
+    {
+      return NX_NOT_SUCCESSFUL;
+    }
+  }
+
+  if (nx_azure_iot_json_writer_append_end_object(json_writer))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+static UINT reference_vibration_axis_append(
+    NX_AZURE_IOT_JSON_WRITER* json_writer, const CHAR* name, const PNP_MODEL_VIBRATION_X* axis)
+{
+  static const CHAR* band_names[4] = {"band_1", "band_2", "band_3", "band_4"};
+  const double       band_values[4] = {axis->band_1, axis->band_2, axis->band_3, axis->band_4};
+  UINT               band;
+
+  if (nx_azure_iot_json_writer_append_property_name(json_writer, (UCHAR*)name, strlen(name)) ||
+      nx_azure_iot_json_writer_append_begin_object(json_writer) ||
+      nx_azure_iot_json_writer_append_property_with_double_value(
+          json_writer, (UCHAR*)"rms", sizeof("rms") - 1, axis->rms, 2) ||
+      nx_azure_iot_json_writer_append_property_with_double_value(
+          json_writer, (UCHAR*)"p2p", sizeof("p2p") - 1, axis->p2p, 2) ||
+      nx_azure_iot_json_writer_append_property_with_double_value(
+          json_writer, (UCHAR*)"crest", sizeof("crest") - 1, axis->crest, 2))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  for (band = 0; band < 4; band++)
+  {
+    if (nx_azure_iot_json_writer_append_property_with_double_value(
+            json_writer, (UCHAR*)band_names[band], strlen(band_names[band]), band_values[band], 2))
+    {
+      return NX_NOT_SUCCESSFUL;
+    }
+  }
+
+  if (nx_azure_iot_json_writer_append_end_object(json_writer))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+/* The telemetry of the board as app_azure_iot.c wrote it by hand. */
+static UINT reference_telemetry_append(NX_AZURE_IOT_JSON_WRITER* json_writer,
+    const PNP_MODEL_VIBRATION*                                  vibration,
+    const PNP_MODEL_GYROSCOPE*                                  gyroscope,
+    double                                                      temperature)
+{
+  static const CHAR* axis_names[3] = {"x", "y", "z"};
+  static const CHAR* gyro_names[3] = {"g_x", "g_y", "g_z"};
+  const PNP_MODEL_VIBRATION_X* axes[3] = {&vibration->x, &vibration->y, &vibration->z};
+  const double       gyro_values[3] = {gyroscope->g_x, gyroscope->g_y, gyroscope->g_z};
+  UINT               axis;
+
+  if (nx_azure_iot_json_writer_append_property_with_double_value(
+          json_writer, (UCHAR*)TELEMETRY_TEMPERATURE, sizeof(TELEMETRY_TEMPERATURE) - 1, temperature, 2) ||
+      nx_azure_iot_json_writer_append_property_name(
+          json_writer, (UCHAR*)TELEMETRY_VIBRATION, sizeof(TELEMETRY_VIBRATION) - 1) ||
+      nx_azure_iot_json_writer_append_begin_object(json_writer))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  for (axis = 0; axis < 3; axis++)
+  {
+    if (reference_vibration_axis_append(json_writer, axis_names[axis], axes[axis]))
+    {
+      return NX_NOT_SUCCESSFUL;
+    }
+  }
+
+  if (nx_azure_iot_json_writer_append_end_object(json_writer) ||
+      reference_vector_append(json_writer, TELEMETRY_GYROSCOPE, gyro_names, gyro_values) ||
+      nx_azure_iot_json_writer_append_property_with_bool_value(
+          json_writer, (UCHAR*)PROPERTY_LED_STATE, sizeof(PROPERTY_LED_STATE) - 1, false))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+static UINT generated_telemetry_append(NX_AZURE_IOT_JSON_WRITER* json_writer,
+    const PNP_MODEL_VIBRATION*                                  vibration,
+    const PNP_MODEL_GYROSCOPE*                                  gyroscope,
+    double                                                      temperature)
+{
+  if (pnp_model_append_temperature(json_writer, temperature) || pnp_model_append_vibration(json_writer, vibration) ||
+      pnp_model_append_gyroscope(json_writer, gyroscope) || pnp_model_append_led_state(json_writer, false))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+static UINT reference_enum_get(NX_AZURE_IOT_JSON_READER* json_reader, int32_t max, int32_t* value)
+{
+  if (nx_azure_iot_json_reader_token_int32_get(json_reader, value) || (*value < 0) || (*value > max))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+/* The writable properties as a strcmp chain, with the checks of the model. */
+static UINT reference_property_parse(const UCHAR* name,
+    UINT                                          name_length,
+    NX_AZURE_IOT_JSON_READER*                     json_reader,
+    PNP_MODEL_WRITABLE_PROPERTIES*                properties,
+    PNP_MODEL_WRITABLE*                           property)
+{
+  int32_t value;
+
+  if ((name_length == strlen(PROPERTY_TELEMETRY_INTERVAL)) &&
+      (strncmp((const CHAR*)name, PROPERTY_TELEMETRY_INTERVAL, name_length) == 0))
+  {
+    *property = PNP_MODEL_WRITABLE_TELEMETRY_INTERVAL;
+    return nx_azure_iot_json_reader_token_double_get(json_reader, &properties->telemetry_interval)
+               ? NX_NOT_SUCCESSFUL
+               : NX_AZURE_IOT_SUCCESS;
+  }
+
+  if ((name_length == strlen(PROPERTY_ACC_FULLSCALE)) &&
+      (strncmp((const CHAR*)name, PROPERTY_ACC_FULLSCALE, name_length) == 0))
+  {
+    *property = PNP_MODEL_WRITABLE_ACC_FULLSCALE;
+    if (reference_enum_get(json_reader, PNP_MODEL_ACC_FULLSCALE_G16, &value))
+    {
+      return NX_NOT_SUCCESSFUL;
+    }
+    properties->acc_fullscale = (PNP_MODEL_ACC_FULLSCALE)value;
+    return NX_AZURE_IOT_SUCCESS;
+  }
+
+  if ((name_length == strlen(PROPERTY_GYRO_FULLSCALE)) &&
+      (strncmp((const CHAR*)name, PROPERTY_GYRO_FULLSCALE, name_length) == 0))
+  {
+    *property = PNP_MODEL_WRITABLE_GYRO_FULLSCALE;
+    if (reference_enum_get(json_reader, PNP_MODEL_GYRO_FULLSCALE_DPS2000, &value))
+    {
+      return NX_NOT_SUCCESSFUL;
+    }
+    properties->gyro_fullscale = (PNP_MODEL_GYRO_FULLSCALE)value;
+    return NX_AZURE_IOT_SUCCESS;
+  }
+
+  return NX_AZURE_IOT_NOT_FOUND;
+}
+
+static VOID model_fill(PNP_MODEL_VIBRATION* vibration, PNP_MODEL_GYROSCOPE* gyroscope, double base)
+{
+  double* values = (double*)vibration;
+  UINT    index;
+
+  for (index = 0; index < sizeof(*vibration) / sizeof(double); index++)
+  {
+    values[index] = base * (index + 1) / 7.0 - index;
+  }
+
+  gyroscope->g_x = base * 1000.0;
+  gyroscope->g_y = -base * 350.25;
+  gyroscope->g_z = base / 3.0;
+}
+
+/* The telemetry object one way, returns its length. */
+static UINT telemetry_write(TELEMETRY_APPEND append, UCHAR* json, const PNP_MODEL_VIBRATION* vibration,
+    const PNP_MODEL_GYROSCOPE* gyroscope, double temperature)
+{
+  NX_AZURE_IOT_JSON_WRITER json_writer;
+
+  TEST_ASSERT(nx_azure_iot_json_writer_with_buffer_init(&json_writer, json, JSON_SIZE) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_json_writer_append_begin_object(&json_writer) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(append(&json_writer, vibration, gyroscope, temperature) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_json_writer_append_end_object(&json_writer) == NX_AZURE_IOT_SUCCESS);
+
+  return nx_azure_iot_json_writer_get_bytes_used(&json_writer);
+}
+
+static VOID encode_check(VOID)
+{
+  static const double bases[] = {0.0, 1.0, -2.5, 23.456, 1234.5678};
+  PNP_MODEL_VIBRATION vibration;
+  PNP_MODEL_GYROSCOPE gyroscope;
+  UCHAR               reference[JSON_SIZE];
+  UCHAR               generated[JSON_SIZE];
+  UINT                reference_length;
+  UINT                generated_length;
+  UINT                index;
+
+  for (index = 0; index < sizeof(bases) / sizeof(bases[0]); index++)
+  {
+    model_fill(&vibration, &gyroscope, bases[index]);
+    reference_length =
+        telemetry_write(reference_telemetry_append, reference, &vibration, &gyroscope, bases[index] + 20.0);
+    generated_length =
+        telemetry_write(generated_telemetry_append, generated, &vibration, &gyroscope, bases[index] + 20.0);
+
+    TEST_ASSERT(generated_length == reference_length);
+    TEST_ASSERT(memcmp(generated, reference, reference_length) == 0);
+  }
+}
+
+/* Bytes one serializer adds after a first property, with the comma. */
+#define SIZE_CHECK(call, max_size)                                                                               \
+  do                                                                                                             \
+  {                                                                                                              \
+    TEST_ASSERT(nx_azure_iot_json_writer_with_buffer_init(&json_writer, json, sizeof(json)) ==                   \
+                NX_AZURE_IOT_SUCCESS);                                                                           \
+    TEST_ASSERT(nx_azure_iot_json_writer_append_begin_object(&json_writer) == NX_AZURE_IOT_SUCCESS);             \
+    TEST_ASSERT(pnp_model_append_led_state(&json_writer, true) == NX_AZURE_IOT_SUCCESS);                         \
+    start_length = nx_azure_iot_json_writer_get_bytes_used(&json_writer);                                        \
+    TEST_ASSERT((call) == NX_AZURE_IOT_SUCCESS);                                                                 \
+    TEST_ASSERT(nx_azure_iot_json_writer_get_bytes_used(&json_writer) - start_length <= (max_size));             \
+  } while (0)
+
+static VOID size_check(VOID)
+{
+  PNP_MODEL_VIBRATION      vibration;
+  PNP_MODEL_GYROSCOPE      gyroscope      = {WORST_DOUBLE, WORST_DOUBLE, WORST_DOUBLE};
+  PNP_MODEL_ACCELERATION   acceleration   = {WORST_DOUBLE, WORST_DOUBLE, WORST_DOUBLE};
+  PNP_MODEL_MAGNETOMETER   magnetometer   = {WORST_DOUBLE, WORST_DOUBLE, WORST_DOUBLE};
+  double*                  values         = (double*)&vibration;
+  UCHAR                    json[JSON_SIZE];
+  NX_AZURE_IOT_JSON_WRITER json_writer;
+  UINT                     start_length;
+  UINT                     index;
+
+  for (index = 0; index < sizeof(vibration) / sizeof(double); index++)
+  {
+    values[index] = WORST_DOUBLE;
+  }
+
+  SIZE_CHECK(pnp_model_append_temperature(&json_writer, WORST_DOUBLE), PNP_MODEL_TEMPERATURE_MAX_SIZE);
+  SIZE_CHECK(pnp_model_append_humidity(&json_writer, WORST_DOUBLE), PNP_MODEL_HUMIDITY_MAX_SIZE);
+  SIZE_CHECK(pnp_model_append_pressure(&json_writer, WORST_DOUBLE), PNP_MODEL_PRESSURE_MAX_SIZE);
+  SIZE_CHECK(pnp_model_append_acceleration(&json_writer, &acceleration), PNP_MODEL_ACCELERATION_MAX_SIZE);
+  SIZE_CHECK(pnp_model_append_vibration(&json_writer, &vibration), PNP_MODEL_VIBRATION_MAX_SIZE);
+  SIZE_CHECK(pnp_model_append_gyroscope(&json_writer, &gyroscope), PNP_MODEL_GYROSCOPE_MAX_SIZE);
+  SIZE_CHECK(pnp_model_append_magnetometer(&json_writer, &magnetometer), PNP_MODEL_MAGNETOMETER_MAX_SIZE);
+  SIZE_CHECK(pnp_model_append_telemetry_interval(&json_writer, WORST_DOUBLE), PNP_MODEL_TELEMETRY_INTERVAL_MAX_SIZE);
+  SIZE_CHECK(pnp_model_append_led_state(&json_writer, false), PNP_MODEL_LED_STATE_MAX_SIZE);
+  SIZE_CHECK(pnp_model_append_acc_fullscale(&json_writer, PNP_MODEL_ACC_FULLSCALE_G16),
+      PNP_MODEL_ACC_FULLSCALE_MAX_SIZE);
+  SIZE_CHECK(pnp_model_append_gyro_fullscale(&json_writer, PNP_MODEL_GYRO_FULLSCALE_DPS2000),
+      PNP_MODEL_GYRO_FULLSCALE_MAX_SIZE);
+
+  // The whole telemetry object, with the led_state property first
+  SIZE_CHECK(pnp_model_append_temperature(&json_writer, WORST_DOUBLE) ||
+                 pnp_model_append_humidity(&json_writer, WORST_DOUBLE) ||
+                 pnp_model_append_pressure(&json_writer, WORST_DOUBLE) ||
+                 pnp_model_append_acceleration(&json_writer, &acceleration) ||
+                 pnp_model_append_vibration(&json_writer, &vibration) ||
+                 pnp_model_append_gyroscope(&json_writer, &gyroscope) ||
+                 pnp_model_append_magnetometer(&json_writer, &magnetometer),
+      PNP_MODEL_TELEMETRY_MAX_SIZE);
+}
+
+static VOID failure_check(VOID)
+{
+  static const CHAR        next[] = "{\"led_state\":true,\"gyroscope\":{";
+  PNP_MODEL_VIBRATION      vibration;
+  PNP_MODEL_GYROSCOPE      gyroscope;
+  UCHAR                    json[JSON_SIZE];
+  NX_AZURE_IOT_JSON_WRITER json_writer;
+  UINT                     start_length;
+
+  model_fill(&vibration, &gyroscope, 1.0);
+  vibration.z.band_4 = UNPRINTABLE_DOUBLE;
+
+  TEST_ASSERT(nx_azure_iot_json_writer_with_buffer_init(&json_writer, json, sizeof(json)) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_json_writer_append_begin_object(&json_writer) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(pnp_model_append_led_state(&json_writer, true) == NX_AZURE_IOT_SUCCESS);
+  start_length = nx_azure_iot_json_writer_get_bytes_used(&json_writer);
+  TEST_ASSERT(pnp_model_append_vibration(&json_writer, &vibration) == NX_NOT_SUCCESSFUL);
+  TEST_ASSERT(nx_azure_iot_json_writer_get_bytes_used(&json_writer) == start_length);
+
+  // The writer is still usable, the next property follows the first one
+  TEST_ASSERT(pnp_model_append_gyroscope(&json_writer, &gyroscope) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_json_writer_append_end_object(&json_writer) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(memcmp(json, next, sizeof(next) - 1) == 0);
+
+  // The name fits and the object does not
+  model_fill(&vibration, &gyroscope, 1.0);
+  TEST_ASSERT(nx_azure_iot_json_writer_with_buffer_init(&json_writer, json, 64) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_json_writer_append_begin_object(&json_writer) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(pnp_model_append_vibration(&json_writer, &vibration) == NX_NOT_SUCCESSFUL);
+  TEST_ASSERT(nx_azure_iot_json_writer_get_bytes_used(&json_writer) <= 64);
+}
+
+/* Walk a desired document as the client does, count the properties found. */
+static UINT document_parse(PROPERTY_PARSE parse, const CHAR* document, PNP_MODEL_WRITABLE_PROPERTIES* properties,
+    UINT* found_mask)
+{
+  NX_AZURE_IOT_JSON_READER json_reader;
+  PNP_MODEL_WRITABLE       property;
+  UCHAR                    name[32];
+  UINT                     name_length;
+  UINT                     found = 0;
+
+  TEST_ASSERT(nx_azure_iot_json_reader_with_buffer_init(&json_reader, (const UCHAR*)document, strlen(document)) ==
+              NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_json_reader_next_token(&json_reader) == NX_AZURE_IOT_SUCCESS);
+  *found_mask = 0;
+
+  while ((nx_azure_iot_json_reader_next_token(&json_reader) == NX_AZURE_IOT_SUCCESS) &&
+         (nx_azure_iot_json_reader_token_type(&json_reader) == NX_AZURE_IOT_READER_TOKEN_PROPERTY_NAME))
+  {
+    TEST_ASSERT(nx_azure_iot_json_reader_token_string_get(&json_reader, name, sizeof(name), &name_length) ==
+                NX_AZURE_IOT_SUCCESS);
+    TEST_ASSERT(nx_azure_iot_json_reader_next_token(&json_reader) == NX_AZURE_IOT_SUCCESS);
+
+    if (parse(name, name_length, &json_reader, properties, &property) == NX_AZURE_IOT_SUCCESS)
+    {
+      *found_mask |= 1u << property;
+      found++;
+    }
+
+    nx_azure_iot_json_reader_skip_children(&json_reader);
+  }
+
+  return found;
+}
+
+/* One property in a document of its own, the status of the parser. */
+static UINT property_parse(
+    PROPERTY_PARSE parse, const CHAR* name, const CHAR* value, PNP_MODEL_WRITABLE_PROPERTIES* properties)
+{
+  NX_AZURE_IOT_JSON_READER json_reader;
+  PNP_MODEL_WRITABLE       property;
+
+  TEST_ASSERT(nx_azure_iot_json_reader_with_buffer_init(&json_reader, (const UCHAR*)value, strlen(value)) ==
+              NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_json_reader_next_token(&json_reader) == NX_AZURE_IOT_SUCCESS);
+
+  return parse((const UCHAR*)name, strlen(name), &json_reader, properties, &property);
+}
+
+static VOID decode_check(VOID)
+{
+  static const CHAR* unknown_names[] = {"", "led_state", "acc_fullscalf", "gyro_fullscal", "telemetry_intervals",
+      "$version", "temperature"};
+  static const struct
+  {
+    const CHAR* name;
+    const CHAR* value;
+  } invalid[] = {{PROPERTY_ACC_FULLSCALE, "4"}, {PROPERTY_ACC_FULLSCALE, "-1"}, {PROPERTY_GYRO_FULLSCALE, "5"},
+      {PROPERTY_GYRO_FULLSCALE, "\"2\""}, {PROPERTY_TELEMETRY_INTERVAL, "true"}};
+  const PNP_MODEL_WRITABLE_PROPERTIES boot = {10, PNP_MODEL_ACC_FULLSCALE_G4, PNP_MODEL_GYRO_FULLSCALE_DPS2000};
+  PNP_MODEL_WRITABLE_PROPERTIES       reference = boot;
+  PNP_MODEL_WRITABLE_PROPERTIES       generated = boot;
+  UINT                                reference_mask;
+  UINT                                generated_mask;
+  UINT                                index;
+
+  TEST_ASSERT(document_parse(reference_property_parse, desired, &reference, &reference_mask) ==
+              PNP_MODEL_WRITABLE_COUNT);
+  TEST_ASSERT(document_parse(pnp_model_writable_property_parse, desired, &generated, &generated_mask) ==
+              PNP_MODEL_WRITABLE_COUNT);
+  TEST_ASSERT(generated_mask == reference_mask);
+  TEST_ASSERT(generated_mask == (1u << PNP_MODEL_WRITABLE_COUNT) - 1);
+  TEST_ASSERT(memcmp(&generated, &reference, sizeof(generated)) == 0);
+  TEST_ASSERT(generated.telemetry_interval == 5);
+  TEST_ASSERT(generated.acc_fullscale == PNP_MODEL_ACC_FULLSCALE_G8);
+  TEST_ASSERT(generated.gyro_fullscale == PNP_MODEL_GYRO_FULLSCALE_DPS1000);
+
+  // Names outside the model, the values stay
+  for (index = 0; index < sizeof(unknown_names) / sizeof(unknown_names[0]); index++)
+  {
+    TEST_ASSERT(property_parse(reference_property_parse, unknown_names[index], "1", &reference) ==
+                NX_AZURE_IOT_NOT_FOUND);
+    TEST_ASSERT(property_parse(pnp_model_writable_property_parse, unknown_names[index], "1", &generated) ==
+                NX_AZURE_IOT_NOT_FOUND);
+  }
+
+  // Values outside the schema
+  for (index = 0; index < sizeof(invalid) / sizeof(invalid[0]); index++)
+  {
+    TEST_ASSERT(property_parse(reference_property_parse, invalid[index].name, invalid[index].value, &reference) ==
+                NX_NOT_SUCCESSFUL);
+    TEST_ASSERT(property_parse(pnp_model_writable_property_parse, invalid[index].name, invalid[index].value,
+                    &generated) == NX_NOT_SUCCESSFUL);
+  }
+
+  TEST_ASSERT(memcmp(&generated, &reference, sizeof(generated)) == 0);
+  TEST_ASSERT(generated.acc_fullscale == PNP_MODEL_ACC_FULLSCALE_G8);
+  TEST_ASSERT(generated.gyro_fullscale == PNP_MODEL_GYRO_FULLSCALE_DPS1000);
+}
+
+static ULONG64 host_ns(VOID)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (ULONG64)now.tv_sec * 1000000000u + (ULONG64)now.tv_nsec;
+}
+
+static double encode_bench(TELEMETRY_APPEND append, UINT* length_ptr)
+{
+  PNP_MODEL_VIBRATION vibration;
+  PNP_MODEL_GYROSCOPE gyroscope;
+  UCHAR               json[JSON_SIZE];
+  ULONG64             start;
+  UINT                run;
+
+  model_fill(&vibration, &gyroscope, 23.456);
+
+  start = host_ns();
+  for (run = 0; run < BENCH_RUNS; run++)
+  {
+    *length_ptr = telemetry_write(append, json, &vibration, &gyroscope, 21.5);
+  }
+
+  return (double)(host_ns() - start) / BENCH_RUNS;
+}
+
+static double decode_bench(PROPERTY_PARSE parse)
+{
+  PNP_MODEL_WRITABLE_PROPERTIES properties;
+  ULONG64                       start;
+  UINT                          found_mask;
+  UINT                          run;
+
+  start = host_ns();
+  for (run = 0; run < BENCH_RUNS; run++)
+  {
+    TEST_ASSERT(document_parse(parse, desired, &properties, &found_mask) == PNP_MODEL_WRITABLE_COUNT);
+  }
+
+  return (double)(host_ns() - start) / BENCH_RUNS;
+}
+
+/* The properties of the desired document, each from a reader already on its
+   value, as the callback gets them: the lookup and the value, without the walk. */
+static double property_bench(PROPERTY_PARSE parse)
+{
+  static const CHAR* names[] = {
+      PROPERTY_TELEMETRY_INTERVAL, PROPERTY_ACC_FULLSCALE, PROPERTY_GYRO_FULLSCALE, "$version"};
+  static const CHAR*            values[] = {"5", "2", "3", "7"};
+  NX_AZURE_IOT_JSON_READER      readers[4];
+  NX_AZURE_IOT_JSON_READER      json_reader;
+  PNP_MODEL_WRITABLE_PROPERTIES properties;
+  PNP_MODEL_WRITABLE            property;
+  ULONG64                       start;
+  UINT                          found = 0;
+  UINT                          index;
+  UINT                          run;
+
+  for (index = 0; index < 4; index++)
+  {
+    TEST_ASSERT(nx_azure_iot_json_reader_with_buffer_init(
+                    &readers[index], (const UCHAR*)values[index], strlen(values[index])) == NX_AZURE_IOT_SUCCESS);
+    TEST_ASSERT(nx_azure_iot_json_reader_next_token(&readers[index]) == NX_AZURE_IOT_SUCCESS);
+  }
+
+  start = host_ns();
+  for (run = 0; run < BENCH_RUNS; run++)
+  {
+    for (index = 0; index < 4; index++)
+    {
+      json_reader = readers[index];
+      found += (parse((const UCHAR*)names[index], strlen(names[index]), &json_reader, &properties, &property) ==
+                NX_AZURE_IOT_SUCCESS);
+    }
+  }
+
+  TEST_ASSERT(found == BENCH_RUNS * PNP_MODEL_WRITABLE_COUNT);
+
+  return (double)(host_ns() - start) / BENCH_RUNS / 4;
+}
+
+static double bench_report(const CHAR* code, TELEMETRY_APPEND append, PROPERTY_PARSE parse)
+{
+  UINT   json_bytes;
+  double encode_ns   = encode_bench(append, &json_bytes);
+  double decode_ns   = decode_bench(parse);
+  double property_ns = property_bench(parse);
+
+  test_result("pnp_model",
+      "\"code\":\"%s\",\"telemetry_bytes\":%u,\"encode_ns\":%.0f,\"encode_mb_s\":%.1f,\"document_bytes\":%u,"
+      "\"decode_ns\":%.0f,\"property_ns\":%.1f",
+      code,
+      json_bytes,
+      encode_ns,
+      json_bytes * 1000.0 / encode_ns,
+      (UINT)(sizeof(desired) - 1),
+      decode_ns,
+      property_ns);
+
+  return encode_ns;
+}
+
+static VOID test_entry(ULONG input)
+{
+  double reference_ns;
+  double generated_ns;
+
+  (void)input;
+
+  encode_check();
+  size_check();
+  failure_check();
+  decode_check();
+
+  reference_ns = bench_report("hand-written", reference_telemetry_append, reference_property_parse);
+  generated_ns = bench_report("generated", generated_telemetry_append, pnp_model_writable_property_parse);
+  TEST_ASSERT(generated_ns < reference_ns);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100);
+}
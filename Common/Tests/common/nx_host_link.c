@@ -0,0 +1,437 @@
+/**
+  ******************************************************************************
+  * @file    nx_host_link.c
+  * @brief   Simulated Ethernet segment connecting NetX instances of a test
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Frames are built as by nx_stm32_eth_driver.c: a 14 bytes Ethernet header is
+   prepended to the IP packet. The frame is copied into the transmit queue of
+   the station and the NetX packet released at once, as a DMA driver would do
+   on the transmit complete interrupt. A timer with a period of one tick takes
+   the frames whose transmission and propagation ended, and copies each of
+   them into the default pool of the receiving IP instance, starting 2 bytes
+   into the payload to align the IP header as the board driver does. */
+
+#include <string.h>
+
+#include "nx_api.h"
+#include "nx_arp.h"
+#include "nx_ip.h"
+#include "nx_packet.h"
+#include "nx_host_link.h"
+
+#define NX_HOST_LINK_HEADER_SIZE    14
+#define NX_HOST_LINK_FRAME_MAX      1514
+#define NX_HOST_LINK_MTU            (NX_HOST_LINK_FRAME_MAX - NX_HOST_LINK_HEADER_SIZE)
+
+#define NX_DRIVER_ERROR             90
+
+#define NX_HOST_LINK_TYPE_IP        0x0800
+#define NX_HOST_LINK_TYPE_ARP       0x0806
+#define NX_HOST_LINK_TYPE_RARP      0x8035
+
+/* Time is counted in millionths of a tick, for the transmission of frames at rates
+   of less than one frame per tick. */
+#define NX_HOST_LINK_UTICKS         1000000ULL
+
+typedef struct NX_HOST_LINK_FRAME_STRUCT
+{
+  ULONG64 arrival;  // end of propagation, in microticks
+  UINT    length;
+  UCHAR   data[NX_HOST_LINK_FRAME_MAX];
+} NX_HOST_LINK_FRAME;
+
+typedef struct NX_HOST_LINK_STATION_STRUCT
+{
+  NX_IP*             ip_ptr;
+  NX_INTERFACE*      interface_ptr;
+  UCHAR              mac[6];
+  UINT               enabled;
+  ULONG64            busy_until;
+  ULONG              loss_ppm;
+  ULONG              random;
+  UINT               head;
+  UINT               count;
+  NX_HOST_LINK_STATS stats;
+  NX_HOST_LINK_FRAME queue[NX_HOST_LINK_QUEUE_DEPTH];
+} NX_HOST_LINK_STATION;
+
+static NX_HOST_LINK_STATION nx_host_link_stations[NX_HOST_LINK_STATIONS];
+static UINT                 nx_host_link_started;
+static ULONG                nx_host_link_delay = 1;
+static ULONG                nx_host_link_rate;
+static ULONG                nx_host_link_queue_bytes = NX_HOST_LINK_QUEUE_DEPTH * NX_HOST_LINK_FRAME_MAX;
+static NX_HOST_LINK_FILTER  nx_host_link_filter;
+static TX_TIMER             nx_host_link_timer;
+
+static VOID nx_host_link_send(NX_IP_DRIVER* driver_req_ptr, NX_HOST_LINK_STATION* station_ptr);
+static VOID nx_host_link_deliver(ULONG input);
+static VOID nx_host_link_receive(NX_HOST_LINK_STATION* from_ptr, UINT to, NX_HOST_LINK_FRAME* frame_ptr);
+
+VOID nx_host_link_configure(ULONG delay_ticks, ULONG bytes_per_tick, ULONG queue_bytes)
+{
+  nx_host_link_delay = delay_ticks;
+  nx_host_link_rate = bytes_per_tick;
+  nx_host_link_queue_bytes = queue_bytes;
+}
+
+VOID nx_host_link_loss_set(UINT station, ULONG loss_ppm, ULONG seed)
+{
+  nx_host_link_stations[station].loss_ppm = loss_ppm;
+  nx_host_link_stations[station].random = seed ? seed : 1;
+}
+
+VOID nx_host_link_filter_set(NX_HOST_LINK_FILTER filter)
+{
+  nx_host_link_filter = filter;
+}
+
+UINT nx_host_link_station_get(NX_IP* ip_ptr)
+{
+  UINT i;
+
+  for (i = 0; i < NX_HOST_LINK_STATIONS; i++)
+  {
+    if (nx_host_link_stations[i].ip_ptr == ip_ptr)
+    {
+      return i;
+    }
+  }
+
+  return NX_HOST_LINK_STATIONS;
+}
+
+NX_HOST_LINK_STATS* nx_host_link_stats_get(UINT station)
+{
+  return &nx_host_link_stations[station].stats;
+}
+
+static NX_HOST_LINK_STATION* nx_host_link_station_find(NX_INTERFACE* interface_ptr)
+{
+  UINT i;
+
+  for (i = 0; i < NX_HOST_LINK_STATIONS; i++)
+  {
+    if ((interface_ptr != NX_NULL) && (nx_host_link_stations[i].interface_ptr == interface_ptr))
+    {
+      return &nx_host_link_stations[i];
+    }
+  }
+
+  return NX_NULL;
+}
+
+VOID nx_host_link_driver(NX_IP_DRIVER* driver_req_ptr)
+{
+  NX_INTERFACE*         interface_ptr = driver_req_ptr->nx_ip_driver_interface;
+  NX_HOST_LINK_STATION* station_ptr;
+  UINT                  i;
+
+  driver_req_ptr->nx_ip_driver_status = NX_SUCCESS;
+
+  switch (driver_req_ptr->nx_ip_driver_command)
+  {
+    case NX_LINK_INTERFACE_ATTACH:
+      break;
+
+    case NX_LINK_INITIALIZE:
+      for (i = 0; i < NX_HOST_LINK_STATIONS; i++)
+      {
+        if (nx_host_link_stations[i].ip_ptr == NX_NULL)
+        {
+          break;
+        }
+      }
+      if (i == NX_HOST_LINK_STATIONS)
+      {
+        driver_req_ptr->nx_ip_driver_status = NX_DRIVER_ERROR;
+        break;
+      }
+
+      if (!nx_host_link_started)
+      {
+        tx_timer_create(&nx_host_link_timer, "Host link", nx_host_link_deliver, 0, 1, 1, TX_AUTO_ACTIVATE);
+        nx_host_link_started = NX_TRUE;
+      }
+
+      station_ptr = &nx_host_link_stations[i];
+      memset(station_ptr, 0, sizeof(NX_HOST_LINK_STATION) - sizeof(station_ptr->queue));
+      station_ptr->ip_ptr = driver_req_ptr->nx_ip_driver_ptr;
+      station_ptr->interface_ptr = interface_ptr;
+      station_ptr->mac[0] = 0x02;
+      station_ptr->mac[5] = (UCHAR)(i + 1);
+      station_ptr->random = i + 1;
+
+      interface_ptr->nx_interface_ip_mtu_size = NX_HOST_LINK_MTU;
+      interface_ptr->nx_interface_physical_address_msw = ((ULONG)station_ptr->mac[0] << 8) | station_ptr->mac[1];
+      interface_ptr->nx_interface_physical_address_lsw = ((ULONG)station_ptr->mac[2] << 24) |
+                                                         ((ULONG)station_ptr->mac[3] << 16) |
+                                                         ((ULONG)station_ptr->mac[4] << 8) |
+                                                         station_ptr->mac[5];
+      interface_ptr->nx_interface_address_mapping_needed = NX_TRUE;
+      break;
+
+    case NX_LINK_UNINITIALIZE:
+      station_ptr = nx_host_link_station_find(interface_ptr);
+      if (station_ptr != NX_NULL)
+      {
+        station_ptr->ip_ptr = NX_NULL;
+        station_ptr->interface_ptr = NX_NULL;
+        station_ptr->enabled = NX_FALSE;
+        station_ptr->count = 0;
+      }
+      break;
+
+    case NX_LINK_ENABLE:
+    case NX_LINK_DISABLE:
+      station_ptr = nx_host_link_station_find(interface_ptr);
+      if (station_ptr == NX_NULL)
+      {
+        driver_req_ptr->nx_ip_driver_status = NX_DRIVER_ERROR;
+        break;
+      }
+      station_ptr->enabled = (driver_req_ptr->nx_ip_driver_command == NX_LINK_ENABLE);
+      interface_ptr->nx_interface_link_up = (UCHAR)station_ptr->enabled;
+      break;
+
+    case NX_LINK_ARP_SEND:
+    case NX_LINK_ARP_RESPONSE_SEND:
+    case NX_LINK_PACKET_BROADCAST:
+    case NX_LINK_RARP_SEND:
+    case NX_LINK_PACKET_SEND:
+      station_ptr = nx_host_link_station_find(interface_ptr);
+      if ((station_ptr == NX_NULL) || !station_ptr->enabled)
+      {
+        driver_req_ptr->nx_ip_driver_status = NX_DRIVER_ERROR;
+        nx_packet_transmit_release(driver_req_ptr->nx_ip_driver_packet);
+        break;
+      }
+      nx_host_link_send(driver_req_ptr, station_ptr);
+      break;
+
+    case NX_LINK_MULTICAST_JOIN:
+    case NX_LINK_MULTICAST_LEAVE:
+      break;
+
+    case NX_LINK_GET_STATUS:
+      *(driver_req_ptr->nx_ip_driver_return_ptr) = interface_ptr->nx_interface_link_up;
+      break;
+
+    default:
+      driver_req_ptr->nx_ip_driver_status = NX_UNHANDLED_COMMAND;
+      break;
+  }
+}
+
+static ULONG nx_host_link_random(NX_HOST_LINK_STATION* station_ptr)
+{
+  ULONG x = station_ptr->random;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  station_ptr->random = x;
+
+  return x;
+}
+
+static VOID nx_host_link_send(NX_IP_DRIVER* driver_req_ptr, NX_HOST_LINK_STATION* station_ptr)
+{
+  NX_PACKET*          packet_ptr = driver_req_ptr->nx_ip_driver_packet;
+  NX_HOST_LINK_FRAME* frame_ptr;
+  UCHAR*              header;
+  USHORT              type;
+  ULONG               bytes_copied;
+  ULONG64             now = (ULONG64)tx_time_get() * NX_HOST_LINK_UTICKS;
+  ULONG64             start;
+  ULONG64             backlog = 0;
+
+  station_ptr->stats.frames_sent++;
+
+  if (packet_ptr->nx_packet_length > NX_HOST_LINK_MTU)
+  {
+    driver_req_ptr->nx_ip_driver_status = NX_DRIVER_ERROR;
+    nx_packet_transmit_release(packet_ptr);
+    return;
+  }
+
+  /* Tail drop when the bytes waiting for transmission exceed the queue. */
+  start = (station_ptr->busy_until > now) ? station_ptr->busy_until : now;
+  if (nx_host_link_rate)
+  {
+    backlog = (start - now) * nx_host_link_rate / NX_HOST_LINK_UTICKS;
+  }
+  if ((station_ptr->count == NX_HOST_LINK_QUEUE_DEPTH) ||
+      (backlog + packet_ptr->nx_packet_length + NX_HOST_LINK_HEADER_SIZE > nx_host_link_queue_bytes))
+  {
+    station_ptr->stats.frames_dropped++;
+    nx_packet_transmit_release(packet_ptr);
+    return;
+  }
+
+  if ((driver_req_ptr->nx_ip_driver_command == NX_LINK_ARP_SEND) ||
+      (driver_req_ptr->nx_ip_driver_command == NX_LINK_ARP_RESPONSE_SEND))
+  {
+    type = NX_HOST_LINK_TYPE_ARP;
+  }
+  else if (driver_req_ptr->nx_ip_driver_command == NX_LINK_RARP_SEND)
+  {
+    type = NX_HOST_LINK_TYPE_RARP;
+  }
+  else
+  {
+    type = NX_HOST_LINK_TYPE_IP;
+  }
+
+  frame_ptr = &station_ptr->queue[(station_ptr->head + station_ptr->count) % NX_HOST_LINK_QUEUE_DEPTH];
+  header = frame_ptr->data;
+  if ((driver_req_ptr->nx_ip_driver_command == NX_LINK_PACKET_SEND) ||
+      (driver_req_ptr->nx_ip_driver_command == NX_LINK_ARP_RESPONSE_SEND))
+  {
+    header[0] = (UCHAR)(driver_req_ptr->nx_ip_driver_physical_address_msw >> 8);
+    header[1] = (UCHAR)(driver_req_ptr->nx_ip_driver_physical_address_msw);
+    header[2] = (UCHAR)(driver_req_ptr->nx_ip_driver_physical_address_lsw >> 24);
+    header[3] = (UCHAR)(driver_req_ptr->nx_ip_driver_physical_address_lsw >> 16);
+    header[4] = (UCHAR)(driver_req_ptr->nx_ip_driver_physical_address_lsw >> 8);
+    header[5] = (UCHAR)(driver_req_ptr->nx_ip_driver_physical_address_lsw);
+  }
+  else
+  {
+    memset(header, 0xFF, 6);
+  }
+  memcpy(&header[6], station_ptr->mac, 6);
+  header[12] = (UCHAR)(type >> 8);
+  header[13] = (UCHAR)type;
+
+  nx_packet_data_extract_offset(packet_ptr, 0, &header[NX_HOST_LINK_HEADER_SIZE],
+                                NX_HOST_LINK_MTU, &bytes_copied);
+  frame_ptr->length = NX_HOST_LINK_HEADER_SIZE + (UINT)bytes_copied;
+  nx_packet_transmit_release(packet_ptr);
+
+  /* The frame takes the link for its transmission time even when it is lost. */
+  if (nx_host_link_rate)
+  {
+    start += frame_ptr->length * NX_HOST_LINK_UTICKS / nx_host_link_rate;
+  }
+  station_ptr->busy_until = start;
+
+  if (station_ptr->loss_ppm && ((nx_host_link_random(station_ptr) % 1000000) < station_ptr->loss_ppm))
+  {
+    station_ptr->stats.frames_lost++;
+    return;
+  }
+
+  frame_ptr->arrival = start + nx_host_link_delay * NX_HOST_LINK_UTICKS;
+  station_ptr->count++;
+}
+
+static VOID nx_host_link_deliver(ULONG input)
+{
+  NX_HOST_LINK_STATION* station_ptr;
+  NX_HOST_LINK_FRAME*   frame_ptr;
+  ULONG64               now = (ULONG64)tx_time_get() * NX_HOST_LINK_UTICKS;
+  UINT                  i;
+  UINT                  j;
+
+  NX_PARAMETER_NOT_USED(input);
+
+  for (i = 0; i < NX_HOST_LINK_STATIONS; i++)
+  {
+    station_ptr = &nx_host_link_stations[i];
+    while (station_ptr->count)
+    {
+      frame_ptr = &station_ptr->queue[station_ptr->head];
+      if (frame_ptr->arrival > now)
+      {
+        break;
+      }
+
+      for (j = 0; j < NX_HOST_LINK_STATIONS; j++)
+      {
+        if ((j == i) || !nx_host_link_stations[j].enabled)
+        {
+          continue;
+        }
+
+        /* Group addresses go to every station, others to the matching one. */
+        if ((frame_ptr->data[0] & 1) || (memcmp(frame_ptr->data, nx_host_link_stations[j].mac, 6) == 0))
+        {
+          nx_host_link_receive(station_ptr, j, frame_ptr);
+        }
+      }
+
+      station_ptr->head = (station_ptr->head + 1) % NX_HOST_LINK_QUEUE_DEPTH;
+      station_ptr->count--;
+    }
+  }
+}
+
+static VOID nx_host_link_receive(NX_HOST_LINK_STATION* from_ptr, UINT to, NX_HOST_LINK_FRAME* frame_ptr)
+{
+  NX_HOST_LINK_STATION* to_ptr = &nx_host_link_stations[to];
+  NX_PACKET*            packet_ptr;
+  USHORT                type;
+
+  type = (USHORT)((frame_ptr->data[12] << 8) | frame_ptr->data[13]);
+
+  if (nx_host_link_filter &&
+      nx_host_link_filter((UINT)(from_ptr - nx_host_link_stations), to, frame_ptr->data, frame_ptr->length))
+  {
+    from_ptr->stats.frames_lost++;
+    return;
+  }
+
+  if (_nx_packet_allocate(to_ptr->ip_ptr->nx_ip_default_packet_pool, &packet_ptr, NX_RECEIVE_PACKET, NX_NO_WAIT))
+  {
+    from_ptr->stats.frames_overrun++;
+    return;
+  }
+
+  /* Keep the IP header 4 bytes aligned, as the board driver does. */
+  packet_ptr->nx_packet_prepend_ptr += 2;
+  packet_ptr->nx_packet_append_ptr = packet_ptr->nx_packet_prepend_ptr;
+  if (_nx_packet_data_append(packet_ptr, frame_ptr->data, frame_ptr->length,
+                             to_ptr->ip_ptr->nx_ip_default_packet_pool, NX_NO_WAIT))
+  {
+    _nx_packet_release(packet_ptr);
+    from_ptr->stats.frames_overrun++;
+    return;
+  }
+
+  packet_ptr->nx_packet_prepend_ptr += NX_HOST_LINK_HEADER_SIZE;
+  packet_ptr->nx_packet_length -= NX_HOST_LINK_HEADER_SIZE;
+  packet_ptr->nx_packet_ip_interface = to_ptr->interface_ptr;
+
+  from_ptr->stats.frames_delivered++;
+  from_ptr->stats.bytes_delivered += packet_ptr->nx_packet_length;
+
+  switch (type)
+  {
+    case NX_HOST_LINK_TYPE_IP:
+      _nx_ip_packet_deferred_receive(to_ptr->ip_ptr, packet_ptr);
+      break;
+
+    case NX_HOST_LINK_TYPE_ARP:
+      _nx_arp_packet_deferred_receive(to_ptr->ip_ptr, packet_ptr);
+      break;
+
+    case NX_HOST_LINK_TYPE_RARP:
+      _nx_rarp_packet_deferred_receive(to_ptr->ip_ptr, packet_ptr);
+      break;
+
+    default:
+      _nx_packet_release(packet_ptr);
+      break;
+  }
+}
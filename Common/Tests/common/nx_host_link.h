@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+  * @file    nx_host_link.h
+  * @brief   Simulated Ethernet segment connecting NetX instances of a test
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef NX_HOST_LINK_H
+#define NX_HOST_LINK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "nx_api.h"
+
+/* Number of interfaces the segment can connect, called stations. An interface
+   takes the first free station when initialized and leaves it when its IP
+   instance is deleted. Station n has the MAC address 02:00:00:00:00:0n+1.
+   The bring-up tests put the device, a router and four time servers on it. */
+#define NX_HOST_LINK_STATIONS       8
+
+/* Frames queued for transmission on each station. */
+#define NX_HOST_LINK_QUEUE_DEPTH    256
+
+/* Counters of the frames sent by a station. */
+typedef struct NX_HOST_LINK_STATS_STRUCT
+{
+  ULONG frames_sent;      // handed to the driver
+  ULONG frames_lost;      // dropped by the loss model
+  ULONG frames_dropped;   // tail drop, the transmit queue was full
+  ULONG frames_delivered; // copied to a receiver
+  ULONG frames_overrun;   // the receiver had no packet left in its pool
+  ULONG bytes_delivered;  // IP bytes delivered
+} NX_HOST_LINK_STATS;
+
+/* Decide whether the frame from one station to another is dropped, on top of the
+   loss rate. The frame starts at the Ethernet header. */
+typedef UINT (*NX_HOST_LINK_FILTER)(UINT from, UINT to, UCHAR* frame, UINT length);
+
+/* The NetX driver entry of the segment, to pass to nx_ip_create. */
+VOID nx_host_link_driver(NX_IP_DRIVER* driver_req_ptr);
+
+/* Set the one way delay in ticks, the rate of each station in bytes per tick
+   (0 for no limit) and the bytes a station can queue before tail drop. */
+VOID nx_host_link_configure(ULONG delay_ticks, ULONG bytes_per_tick, ULONG queue_bytes);
+
+/* Set the probability, in parts per million, that a frame sent by the station
+   is lost. Losses come from a pseudo random sequence started from seed. The
+   station must be taken. */
+VOID nx_host_link_loss_set(UINT station, ULONG loss_ppm, ULONG seed);
+
+/* Install a frame filter, NX_NULL to remove it. */
+VOID nx_host_link_filter_set(NX_HOST_LINK_FILTER filter);
+
+/* Station of the primary interface of an IP instance, NX_HOST_LINK_STATIONS
+   when it has none. */
+UINT nx_host_link_station_get(NX_IP* ip_ptr);
+
+/* Counters of one station, cleared when an interface takes the station. */
+NX_HOST_LINK_STATS* nx_host_link_stats_get(UINT station);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NX_HOST_LINK_H */
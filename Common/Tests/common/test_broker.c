@@ -0,0 +1,657 @@
+/**
+  ******************************************************************************
+  * @file    test_broker.c
+  * @brief   MQTT over TLS broker of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The broker thread waits for TCP data and feeds it to OpenSSL through memory
+   BIOs; whatever OpenSSL has to send is taken from the write BIO and sent on
+   the NetX socket. Once the handshake is done, the decrypted bytes are parsed
+   as MQTT packets: CONNECT, SUBSCRIBE, UNSUBSCRIBE and PINGREQ are answered,
+   the CONNECT with connack_code, QoS 1 PUBLISH acknowledged unless the PUBACKs
+   are held, and a twin GET answered with TEST_BROKER_TWIN_DOCUMENT. The broker
+   does not route: test_broker_publish sends to the client, publishes received
+   are only counted and passed to publish_notify. The delays of the script are
+   slept on the broker thread before the answer is written. */
+
+#include <limits.h>
+
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+#include "test_broker.h"
+#include "test_tls.h"
+
+#define TEST_BROKER_PRIORITY        4
+#define TEST_BROKER_SEND_TIMEOUT    (10 * NX_IP_PERIODIC_RATE)
+#define TEST_BROKER_WINDOW          (16 * 1024)
+
+#define MQTT_CONNECT                0x10
+#define MQTT_CONNACK                0x20
+#define MQTT_PUBLISH                0x30
+#define MQTT_PUBACK                 0x40
+#define MQTT_SUBSCRIBE              0x80
+#define MQTT_SUBACK                 0x90
+#define MQTT_UNSUBSCRIBE            0xA0
+#define MQTT_UNSUBACK               0xB0
+#define MQTT_PINGREQ                0xC0
+#define MQTT_PINGRESP               0xD0
+#define MQTT_DISCONNECT             0xE0
+
+#define MQTT_PUBLISH_DUP            0x08
+
+/* The twin GET of the Azure IoT SDK and its response, the request id follows. */
+#define TWIN_GET_TOPIC              "$iothub/twin/GET/?$rid="
+#define TWIN_RESPONSE_TOPIC         "$iothub/twin/res/200/?$rid="
+#define TEST_BROKER_TWIN_DOCUMENT   "{\"desired\":{\"$version\":1},\"reported\":{\"$version\":1}}"
+
+static VOID test_broker_entry(ULONG input);
+static VOID test_broker_session(TEST_BROKER* broker_ptr);
+static UINT test_broker_flush(TEST_BROKER* broker_ptr);
+static UINT test_broker_process(TEST_BROKER* broker_ptr);
+static UINT test_broker_handle(TEST_BROKER* broker_ptr, UCHAR type, UCHAR* data, UINT length);
+
+UINT test_broker_create(TEST_BROKER* broker_ptr, ULONG address, UINT packet_count)
+{
+  SSL_CTX* ctx;
+  UINT     status;
+
+  memset(&broker_ptr->stats, 0, sizeof(broker_ptr->stats));
+  broker_ptr->ssl = NX_NULL;
+  broker_ptr->connected = NX_FALSE;
+  broker_ptr->puback_hold = NX_FALSE;
+  broker_ptr->puback_count = 0;
+  broker_ptr->publish_notify = NX_NULL;
+  broker_ptr->connack_code = 0;
+  memset(&broker_ptr->script, 0, sizeof(broker_ptr->script));
+
+  ctx = SSL_CTX_new(TLS_server_method());
+  if (ctx == NX_NULL)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  /* TLS 1.2 with session IDs only, what the NX Secure client resumes. */
+  SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+  SSL_CTX_set_max_proto_version(ctx, TLS1_2_VERSION);
+  SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+  SSL_CTX_set_session_id_context(ctx, (const unsigned char*)"test_broker", 11);
+  if ((SSL_CTX_use_certificate_ASN1(ctx, (int)test_tls_broker_cert_size, test_tls_broker_cert) != 1) ||
+      (SSL_CTX_use_PrivateKey_ASN1(EVP_PKEY_EC, ctx, test_tls_broker_key, (long)test_tls_broker_key_size) != 1))
+  {
+    SSL_CTX_free(ctx);
+    return NX_NOT_SUCCESSFUL;
+  }
+  broker_ptr->ssl_ctx = ctx;
+
+  if ((status = test_net_host_create(&broker_ptr->host, "Broker", address, packet_count)))
+  {
+    SSL_CTX_free(ctx);
+    return status;
+  }
+
+  if ((status = nx_tcp_socket_create(&broker_ptr->host.ip,
+           &broker_ptr->socket,
+           "Broker",
+           NX_IP_NORMAL,
+           NX_FRAGMENT_OKAY,
+           NX_IP_TIME_TO_LIVE,
+           TEST_BROKER_WINDOW,
+           NX_NULL,
+           NX_NULL)) ||
+      (status = nx_tcp_server_socket_listen(&broker_ptr->host.ip, TEST_BROKER_PORT, &broker_ptr->socket, 1, NX_NULL)))
+  {
+    test_net_host_delete(&broker_ptr->host);
+    SSL_CTX_free(ctx);
+    return status;
+  }
+
+  tx_mutex_create(&broker_ptr->mutex, "Broker", TX_INHERIT);
+
+  return tx_thread_create(&broker_ptr->thread,
+      "Broker",
+      test_broker_entry,
+      (ULONG)broker_ptr,
+      broker_ptr->stack,
+      sizeof(broker_ptr->stack),
+      TEST_BROKER_PRIORITY,
+      TEST_BROKER_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+UINT test_broker_delete(TEST_BROKER* broker_ptr)
+{
+  tx_thread_terminate(&broker_ptr->thread);
+  tx_thread_delete(&broker_ptr->thread);
+  tx_mutex_delete(&broker_ptr->mutex);
+
+  if (broker_ptr->ssl)
+  {
+    SSL_free(broker_ptr->ssl);
+    broker_ptr->ssl = NX_NULL;
+  }
+  broker_ptr->connected = NX_FALSE;
+
+  nx_tcp_socket_disconnect(&broker_ptr->socket, NX_NO_WAIT);
+  nx_tcp_server_socket_unaccept(&broker_ptr->socket);
+  nx_tcp_server_socket_unlisten(&broker_ptr->host.ip, TEST_BROKER_PORT);
+  nx_tcp_socket_delete(&broker_ptr->socket);
+  SSL_CTX_free(broker_ptr->ssl_ctx);
+
+  return test_net_host_delete(&broker_ptr->host);
+}
+
+static UINT test_broker_puback_send(TEST_BROKER* broker_ptr, USHORT packet_id)
+{
+  UCHAR puback[4] = {MQTT_PUBACK, 2, (UCHAR)(packet_id >> 8), (UCHAR)packet_id};
+
+  return (SSL_write(broker_ptr->ssl, puback, sizeof(puback)) == sizeof(puback)) ? NX_SUCCESS : NX_NOT_SUCCESSFUL;
+}
+
+VOID test_broker_puback_hold(TEST_BROKER* broker_ptr, UINT hold)
+{
+  UINT i;
+
+  tx_mutex_get(&broker_ptr->mutex, TX_WAIT_FOREVER);
+
+  broker_ptr->puback_hold = hold;
+  if (!hold)
+  {
+    if (broker_ptr->connected)
+    {
+      for (i = 0; i < broker_ptr->puback_count; i++)
+      {
+        test_broker_puback_send(broker_ptr, broker_ptr->puback_ids[i]);
+      }
+      test_broker_flush(broker_ptr);
+    }
+    broker_ptr->puback_count = 0;
+  }
+
+  tx_mutex_put(&broker_ptr->mutex);
+}
+
+UINT test_broker_publish(TEST_BROKER* broker_ptr, const CHAR* topic, const UCHAR* payload, UINT payload_length)
+{
+  static UCHAR packet[TEST_BROKER_PACKET_MAX];
+  UINT         topic_length = (UINT)strlen(topic);
+  UINT         remaining = 2 + topic_length + payload_length;
+  UINT         offset = 0;
+  UINT         status;
+
+  /* Type, remaining length of one byte per 7 bits, and the variable part. */
+  if (1 + ((remaining >= 16384) ? 3 : (remaining >= 128) ? 2 : 1) + remaining > sizeof(packet))
+  {
+    return NX_SIZE_ERROR;
+  }
+
+  packet[offset++] = MQTT_PUBLISH;
+  do
+  {
+    packet[offset] = (UCHAR)(remaining & 0x7F);
+    remaining >>= 7;
+    if (remaining)
+    {
+      packet[offset] |= 0x80;
+    }
+    offset++;
+  } while (remaining);
+  packet[offset++] = (UCHAR)(topic_length >> 8);
+  packet[offset++] = (UCHAR)topic_length;
+  memcpy(&packet[offset], topic, topic_length);
+  offset += topic_length;
+  memcpy(&packet[offset], payload, payload_length);
+  offset += payload_length;
+
+  tx_mutex_get(&broker_ptr->mutex, TX_WAIT_FOREVER);
+
+  if (!broker_ptr->connected)
+  {
+    status = NX_NOT_CONNECTED;
+  }
+  else if (SSL_write(broker_ptr->ssl, packet, (int)offset) != (int)offset)
+  {
+    status = NX_NOT_SUCCESSFUL;
+  }
+  else
+  {
+    status = test_broker_flush(broker_ptr);
+  }
+
+  tx_mutex_put(&broker_ptr->mutex);
+
+  return status;
+}
+
+VOID test_broker_script_set(TEST_BROKER* broker_ptr, const TEST_BROKER_SCRIPT* script_ptr)
+{
+  tx_mutex_get(&broker_ptr->mutex, TX_WAIT_FOREVER);
+  broker_ptr->script = *script_ptr;
+  tx_mutex_put(&broker_ptr->mutex);
+}
+
+VOID test_broker_sessions_flush(TEST_BROKER* broker_ptr)
+{
+  tx_mutex_get(&broker_ptr->mutex, TX_WAIT_FOREVER);
+
+  /* Every session has expired at the largest time. */
+  SSL_CTX_flush_sessions(broker_ptr->ssl_ctx, LONG_MAX);
+
+  tx_mutex_put(&broker_ptr->mutex);
+}
+
+UINT test_broker_chain_use(TEST_BROKER* broker_ptr)
+{
+  const UCHAR* der = test_tls_chain_intermediate_cert;
+  X509*        intermediate;
+  UINT         status = NX_SUCCESS;
+
+  tx_mutex_get(&broker_ptr->mutex, TX_WAIT_FOREVER);
+
+  intermediate = d2i_X509(NX_NULL, &der, (long)test_tls_chain_intermediate_cert_size);
+  if ((intermediate == NX_NULL) ||
+      (SSL_CTX_use_certificate_ASN1(broker_ptr->ssl_ctx,
+           (int)test_tls_chain_broker_cert_size,
+           test_tls_chain_broker_cert) != 1) ||
+      (SSL_CTX_use_PrivateKey_ASN1(EVP_PKEY_EC,
+           broker_ptr->ssl_ctx,
+           test_tls_chain_broker_key,
+           (long)test_tls_chain_broker_key_size) != 1) ||
+      (SSL_CTX_add0_chain_cert(broker_ptr->ssl_ctx, intermediate) != 1))
+  {
+    X509_free(intermediate);
+    status = NX_NOT_SUCCESSFUL;
+  }
+
+  /* The sessions were made with the other certificate. */
+  SSL_CTX_flush_sessions(broker_ptr->ssl_ctx, LONG_MAX);
+
+  tx_mutex_put(&broker_ptr->mutex);
+
+  return status;
+}
+
+VOID test_broker_drop(TEST_BROKER* broker_ptr)
+{
+  tx_mutex_get(&broker_ptr->mutex, TX_WAIT_FOREVER);
+
+  if (broker_ptr->connected)
+  {
+    broker_ptr->connected = NX_FALSE;
+    nx_tcp_socket_disconnect(&broker_ptr->socket, NX_NO_WAIT);
+  }
+
+  tx_mutex_put(&broker_ptr->mutex);
+}
+
+static VOID test_broker_entry(ULONG input)
+{
+  TEST_BROKER* broker_ptr = (TEST_BROKER*)input;
+
+  for (;;)
+  {
+    if (nx_tcp_server_socket_accept(&broker_ptr->socket, NX_WAIT_FOREVER) == NX_SUCCESS)
+    {
+      test_broker_session(broker_ptr);
+    }
+
+    nx_tcp_socket_disconnect(&broker_ptr->socket, NX_NO_WAIT);
+    nx_tcp_server_socket_unaccept(&broker_ptr->socket);
+    nx_tcp_server_socket_relisten(&broker_ptr->host.ip, TEST_BROKER_PORT, &broker_ptr->socket);
+  }
+}
+
+static VOID test_broker_delay(ULONG ticks)
+{
+  if (ticks)
+  {
+    tx_thread_sleep(ticks);
+  }
+}
+
+static VOID test_broker_session(TEST_BROKER* broker_ptr)
+{
+  NX_PACKET* packet_ptr;
+  NX_PACKET* current_ptr;
+  SSL*       ssl;
+  int        result;
+  UINT       done = NX_FALSE;
+
+  tx_mutex_get(&broker_ptr->mutex, TX_WAIT_FOREVER);
+  ssl = SSL_new(broker_ptr->ssl_ctx);
+  SSL_set_bio(ssl, BIO_new(BIO_s_mem()), BIO_new(BIO_s_mem()));
+  SSL_set_accept_state(ssl);
+  broker_ptr->ssl = ssl;
+  broker_ptr->connected = NX_TRUE;
+  broker_ptr->input_length = 0;
+  broker_ptr->puback_count = 0;
+  broker_ptr->stats.connects++;
+  tx_mutex_put(&broker_ptr->mutex);
+
+  while (!done)
+  {
+    if (nx_tcp_socket_receive(&broker_ptr->socket, &packet_ptr, NX_WAIT_FOREVER))
+    {
+      break;
+    }
+
+    tx_mutex_get(&broker_ptr->mutex, TX_WAIT_FOREVER);
+
+    if (!broker_ptr->connected)
+    {
+      nx_packet_release(packet_ptr);
+      tx_mutex_put(&broker_ptr->mutex);
+      break;
+    }
+
+    for (current_ptr = packet_ptr; current_ptr; current_ptr = current_ptr->nx_packet_next)
+    {
+      BIO_write(SSL_get_rbio(ssl),
+          current_ptr->nx_packet_prepend_ptr,
+          (int)(current_ptr->nx_packet_append_ptr - current_ptr->nx_packet_prepend_ptr));
+    }
+    broker_ptr->stats.bytes_received += packet_ptr->nx_packet_length;
+    nx_packet_release(packet_ptr);
+
+    if (!SSL_is_init_finished(ssl))
+    {
+      result = SSL_do_handshake(ssl);
+      if (result == 1)
+      {
+        broker_ptr->stats.handshakes++;
+        if (SSL_session_reused(ssl))
+        {
+          broker_ptr->stats.handshakes_resumed++;
+        }
+      }
+      else if (SSL_get_error(ssl, result) != SSL_ERROR_WANT_READ)
+      {
+        ERR_print_errors_fp(stdout);
+        done = NX_TRUE;
+      }
+
+      /* The flight of the broker, if this input completed the one of the client. */
+      if (!done && BIO_pending(SSL_get_wbio(ssl)))
+      {
+        test_broker_delay(broker_ptr->script.handshake_delay);
+      }
+    }
+
+    if (!done && SSL_is_init_finished(ssl))
+    {
+      while ((result = SSL_read(ssl,
+                  &broker_ptr->input[broker_ptr->input_length],
+                  (int)(sizeof(broker_ptr->input) - broker_ptr->input_length))) > 0)
+      {
+        broker_ptr->input_length += (UINT)result;
+        if (test_broker_process(broker_ptr))
+        {
+          done = NX_TRUE;
+          break;
+        }
+      }
+    }
+
+    if (test_broker_flush(broker_ptr))
+    {
+      done = NX_TRUE;
+    }
+
+    tx_mutex_put(&broker_ptr->mutex);
+  }
+
+  tx_mutex_get(&broker_ptr->mutex, TX_WAIT_FOREVER);
+
+  /* Unless dropped, send close_notify: OpenSSL forgets the session of a
+     connection freed without it. */
+  if (broker_ptr->connected && SSL_is_init_finished(ssl) && (SSL_shutdown(ssl) >= 0))
+  {
+    test_broker_flush(broker_ptr);
+  }
+  broker_ptr->connected = NX_FALSE;
+  broker_ptr->ssl = NX_NULL;
+  SSL_free(ssl);
+  tx_mutex_put(&broker_ptr->mutex);
+}
+
+/* Send what OpenSSL wrote, by segments of one MSS. */
+static UINT test_broker_flush(TEST_BROKER* broker_ptr)
+{
+  UCHAR      chunk[1460];
+  NX_PACKET* packet_ptr;
+  BIO*       wbio = SSL_get_wbio(broker_ptr->ssl);
+  int        length;
+
+  while ((length = BIO_read(wbio, chunk, sizeof(chunk))) > 0)
+  {
+    if (nx_packet_allocate(&broker_ptr->host.pool, &packet_ptr, NX_TCP_PACKET, TEST_BROKER_SEND_TIMEOUT))
+    {
+      return NX_NO_PACKET;
+    }
+
+    if (nx_packet_data_append(packet_ptr, chunk, (ULONG)length, &broker_ptr->host.pool, TEST_BROKER_SEND_TIMEOUT) ||
+        nx_tcp_socket_send(&broker_ptr->socket, packet_ptr, TEST_BROKER_SEND_TIMEOUT))
+    {
+      nx_packet_release(packet_ptr);
+      return NX_NOT_SUCCESSFUL;
+    }
+
+    broker_ptr->stats.bytes_sent += (ULONG)length;
+  }
+
+  return NX_SUCCESS;
+}
+
+/* Handle the complete MQTT packets at the start of the input. */
+static UINT test_broker_process(TEST_BROKER* broker_ptr)
+{
+  UCHAR* input = broker_ptr->input;
+  UINT   offset = 0;
+  UINT   header;
+  UINT   remaining;
+  UINT   shift;
+  UINT   complete;
+  UCHAR  byte;
+  UINT   status = NX_SUCCESS;
+
+  while (status == NX_SUCCESS)
+  {
+    /* Fixed header: type and flags, then the remaining length on up to 4 bytes. */
+    header = 1;
+    remaining = 0;
+    shift = 0;
+    complete = NX_FALSE;
+    while ((offset + header < broker_ptr->input_length) && (header <= 4))
+    {
+      byte = input[offset + header++];
+      remaining |= (UINT)(byte & 0x7F) << shift;
+      shift += 7;
+      if (!(byte & 0x80))
+      {
+        complete = NX_TRUE;
+        break;
+      }
+    }
+
+    if (!complete)
+    {
+      if (header > 4)
+      {
+        status = NX_INVALID_PACKET;
+      }
+      break;
+    }
+
+    if (offset + header + remaining > broker_ptr->input_length)
+    {
+      if (header + remaining > sizeof(broker_ptr->input))
+      {
+        status = NX_SIZE_ERROR;
+      }
+      break;
+    }
+
+    status = test_broker_handle(broker_ptr, input[offset], &input[offset + header], remaining);
+    offset += header + remaining;
+  }
+
+  broker_ptr->input_length -= offset;
+  memmove(input, &input[offset], broker_ptr->input_length);
+
+  return status;
+}
+
+/* Answer the twin GET of request_id with the twin document. */
+static UINT test_broker_twin_send(TEST_BROKER* broker_ptr, const UCHAR* request_id, UINT request_id_length)
+{
+  CHAR topic[sizeof(TWIN_RESPONSE_TOPIC) + 32];
+
+  if (request_id_length >= sizeof(topic) - sizeof(TWIN_RESPONSE_TOPIC))
+  {
+    return NX_INVALID_PACKET;
+  }
+
+  memcpy(topic, TWIN_RESPONSE_TOPIC, sizeof(TWIN_RESPONSE_TOPIC) - 1);
+  memcpy(&topic[sizeof(TWIN_RESPONSE_TOPIC) - 1], request_id, request_id_length);
+  topic[sizeof(TWIN_RESPONSE_TOPIC) - 1 + request_id_length] = 0;
+
+  test_broker_delay(broker_ptr->script.twin_delay);
+
+  return test_broker_publish(
+      broker_ptr, topic, (const UCHAR*)TEST_BROKER_TWIN_DOCUMENT, sizeof(TEST_BROKER_TWIN_DOCUMENT) - 1);
+}
+
+static UINT test_broker_handle(TEST_BROKER* broker_ptr, UCHAR type, UCHAR* data, UINT length)
+{
+  UCHAR  reply[4 + TEST_BROKER_PUBACK_MAX];
+  UINT   reply_length = 0;
+  UINT   topic_length;
+  UINT   offset;
+  USHORT packet_id;
+  UINT   status;
+
+  switch (type & 0xF0)
+  {
+    case MQTT_CONNECT:
+      test_broker_delay(broker_ptr->script.connack_delay);
+      reply[0] = MQTT_CONNACK;
+      reply[1] = 2;
+      reply[2] = 0;
+      reply[3] = broker_ptr->connack_code;
+      reply_length = 4;
+      break;
+
+    case MQTT_PUBLISH:
+      if (length < 2)
+      {
+        return NX_INVALID_PACKET;
+      }
+      topic_length = ((UINT)data[0] << 8) | data[1];
+      offset = 2 + topic_length;
+      packet_id = 0;
+      if (type & 0x06)
+      {
+        packet_id = (USHORT)((data[offset] << 8) | data[offset + 1]);
+        offset += 2;
+      }
+      if (offset > length)
+      {
+        return NX_INVALID_PACKET;
+      }
+
+      broker_ptr->stats.publishes++;
+      broker_ptr->stats.publish_bytes += length - offset;
+      if (type & MQTT_PUBLISH_DUP)
+      {
+        broker_ptr->stats.publishes_dup++;
+      }
+      if (broker_ptr->publish_notify)
+      {
+        broker_ptr->publish_notify(broker_ptr, &data[2], topic_length, &data[offset], length - offset);
+      }
+
+      if (type & 0x06)
+      {
+        if (!broker_ptr->puback_hold)
+        {
+          test_broker_delay(broker_ptr->script.puback_delay);
+          if ((status = test_broker_puback_send(broker_ptr, packet_id)))
+          {
+            return status;
+          }
+        }
+        else if (broker_ptr->puback_count < TEST_BROKER_PUBACK_MAX)
+        {
+          broker_ptr->puback_ids[broker_ptr->puback_count++] = packet_id;
+        }
+      }
+
+      if ((topic_length > sizeof(TWIN_GET_TOPIC) - 1) && !memcmp(&data[2], TWIN_GET_TOPIC, sizeof(TWIN_GET_TOPIC) - 1))
+      {
+        return test_broker_twin_send(
+            broker_ptr, &data[2 + sizeof(TWIN_GET_TOPIC) - 1], topic_length - (sizeof(TWIN_GET_TOPIC) - 1));
+      }
+      break;
+
+    case MQTT_SUBSCRIBE:
+    case MQTT_UNSUBSCRIBE:
+      if (length < 2)
+      {
+        return NX_INVALID_PACKET;
+      }
+      reply[0] = ((type & 0xF0) == MQTT_SUBSCRIBE) ? MQTT_SUBACK : MQTT_UNSUBACK;
+      reply[2] = data[0];
+      reply[3] = data[1];
+      reply_length = 4;
+
+      /* Grant each topic filter the QoS asked for. */
+      if ((type & 0xF0) == MQTT_SUBSCRIBE)
+      {
+        broker_ptr->stats.subscribes++;
+        for (offset = 2; (offset + 2 <= length) && (reply_length < sizeof(reply));)
+        {
+          topic_length = ((UINT)data[offset] << 8) | data[offset + 1];
+          offset += 2 + topic_length;
+          if (offset >= length)
+          {
+            return NX_INVALID_PACKET;
+          }
+          reply[reply_length++] = data[offset++] & 0x03;
+        }
+      }
+      reply[1] = (UCHAR)(reply_length - 2);
+      break;
+
+    case MQTT_PINGREQ:
+      reply[0] = MQTT_PINGRESP;
+      reply[1] = 0;
+      reply_length = 2;
+      break;
+
+    case MQTT_DISCONNECT:
+      broker_ptr->stats.disconnects++;
+      return NX_NOT_CONNECTED;
+
+    default:
+      break;
+  }
+
+  if (reply_length && (SSL_write(broker_ptr->ssl, reply, (int)reply_length) != (int)reply_length))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  return NX_SUCCESS;
+}
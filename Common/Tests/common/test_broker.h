@@ -0,0 +1,128 @@
+/**
+  ******************************************************************************
+  * @file    test_broker.h
+  * @brief   MQTT over TLS broker of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_BROKER_H
+#define TEST_BROKER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "test_net.h"
+
+#define TEST_BROKER_PORT            8883
+
+/* PUBACKs the broker can hold back. */
+#define TEST_BROKER_PUBACK_MAX      256
+
+/* Largest MQTT packet the broker takes. */
+#define TEST_BROKER_PACKET_MAX      (16 * 1024)
+
+/* Counters of the broker, cleared by test_broker_create. */
+typedef struct TEST_BROKER_STATS_STRUCT
+{
+  ULONG connects;
+  ULONG handshakes;
+  ULONG handshakes_resumed;
+  ULONG publishes;         // PUBLISH received
+  ULONG publishes_dup;     // of which with the DUP flag
+  ULONG publish_bytes;     // payload bytes received
+  ULONG subscribes;
+  ULONG disconnects;       // DISCONNECT received
+  ULONG bytes_received;    // TLS bytes, records and handshake
+  ULONG bytes_sent;
+} TEST_BROKER_STATS;
+
+/* Server time spent before each answer, in ticks, as a scripted server would
+   replay the cost of a phase. Every delay is 0 after test_broker_create. */
+typedef struct TEST_BROKER_SCRIPT_STRUCT
+{
+  ULONG handshake_delay; // before each TLS handshake flight
+  ULONG connack_delay;
+  ULONG twin_delay;      // before the twin document answering a twin GET
+  ULONG puback_delay;
+} TEST_BROKER_SCRIPT;
+
+struct TEST_BROKER_STRUCT;
+
+/* Called for each PUBLISH received, from the broker thread. */
+typedef VOID (*TEST_BROKER_PUBLISH_NOTIFY)(struct TEST_BROKER_STRUCT* broker_ptr,
+    const UCHAR* topic,
+    UINT topic_length,
+    const UCHAR* payload,
+    UINT payload_length);
+
+/* The broker takes one connection at a time. TLS is done by OpenSSL, as a peer
+   independent from NX Secure, with its session cache on for session ID resumption.
+   A twin GET is answered with a twin document holding no property. */
+typedef struct TEST_BROKER_STRUCT
+{
+  TEST_NET_HOST              host;
+  NX_TCP_SOCKET              socket;
+  TX_THREAD                  thread;
+  TX_MUTEX                   mutex;
+  ULONG64                    stack[16384 / sizeof(ULONG64)];
+  VOID*                      ssl_ctx;
+  VOID*                      ssl;
+  UINT                       connected;
+  UINT                       puback_hold;
+  UINT                       puback_count;
+  USHORT                     puback_ids[TEST_BROKER_PUBACK_MAX];
+  TEST_BROKER_PUBLISH_NOTIFY publish_notify;
+  UCHAR                      connack_code; // return code of the CONNACK, 0 accepts the connection
+  TEST_BROKER_SCRIPT         script;
+  TEST_BROKER_STATS          stats;
+  UINT                       input_length;
+  UCHAR                      input[TEST_BROKER_PACKET_MAX];
+} TEST_BROKER;
+
+/* Create the broker host at address with a pool of packet_count packets, and start
+   listening on TEST_BROKER_PORT. */
+UINT test_broker_create(TEST_BROKER* broker_ptr, ULONG address, UINT packet_count);
+
+/* Close any connection, stop the broker and delete its host. */
+UINT test_broker_delete(TEST_BROKER* broker_ptr);
+
+/* Hold back the PUBACKs while hold is set. Clearing it sends the held PUBACKs. */
+VOID test_broker_puback_hold(TEST_BROKER* broker_ptr, UINT hold);
+
+/* Send a QoS 0 PUBLISH to the connected client. */
+UINT test_broker_publish(TEST_BROKER* broker_ptr,
+    const CHAR* topic,
+    const UCHAR* payload,
+    UINT payload_length);
+
+/* Set the delays of the answers, taking effect with the next packet received. */
+VOID test_broker_script_set(TEST_BROKER* broker_ptr, const TEST_BROKER_SCRIPT* script_ptr);
+
+/* Forget the TLS sessions, as a server that restarted: the next session
+   offered is not resumed. */
+VOID test_broker_sessions_flush(TEST_BROKER* broker_ptr);
+
+/* Present the broker certificate of the chain authority, with its intermediate,
+   from the next handshake. */
+UINT test_broker_chain_use(TEST_BROKER* broker_ptr);
+
+/* Drop the connection as a server going away would: the TCP connection is reset
+   without a TLS close_notify. */
+VOID test_broker_drop(TEST_BROKER* broker_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_BROKER_H */
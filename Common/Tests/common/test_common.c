@@ -0,0 +1,119 @@
+/**
+  ******************************************************************************
+  * @file    test_common.c
+  * @brief   Assertions and result reporting shared by the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include <fcntl.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "test_common.h"
+
+static UINT  test_passed;
+static FILE* test_output;
+
+/* The verdict and the results go to the standard output of the program, even
+   after test_log_mute. */
+static FILE* test_output_get(VOID)
+{
+  return test_output ? test_output : stdout;
+}
+
+VOID test_log_mute(VOID)
+{
+  int null_fd;
+
+  if (test_output)
+  {
+    return;
+  }
+
+  fflush(stdout);
+  test_output = fdopen(dup(STDOUT_FILENO), "w");
+  null_fd = open("/dev/null", O_WRONLY);
+  dup2(null_fd, STDOUT_FILENO);
+  close(null_fd);
+}
+
+int test_run(ULONG max_ticks)
+{
+  UINT status = tx_host_run(max_ticks);
+
+  if (test_passed)
+  {
+    fprintf(test_output_get(), "PASS\n");
+    return 0;
+  }
+
+  if (status == TX_HOST_TIMED_OUT)
+  {
+    fprintf(test_output_get(), "FAIL: timed out after %lu ticks\n", (unsigned long)max_ticks);
+  }
+  else if (status == TX_HOST_DEADLOCK)
+  {
+    fprintf(test_output_get(), "FAIL: no thread ready and no timer active\n");
+  }
+  return 1;
+}
+
+VOID test_pass(VOID)
+{
+  test_passed = TX_TRUE;
+  tx_host_stop();
+}
+
+VOID test_fail(const CHAR* file, int line, const CHAR* condition)
+{
+  fprintf(test_output_get(), "FAIL: %s:%d: %s\n", file, line, condition);
+  tx_host_stop();
+}
+
+VOID test_result(const CHAR* name, const CHAR* format, ...)
+{
+  va_list args;
+  FILE*   output = test_output_get();
+
+  fprintf(output, "{\"test\":\"%s\",", name);
+  va_start(args, format);
+  vfprintf(output, format, args);
+  va_end(args);
+  fprintf(output, "}\n");
+  fflush(output);
+}
+
+TX_THREAD* test_thread_find(const CHAR* name)
+{
+  TX_THREAD* thread_ptr = tx_thread_identify();
+  TX_THREAD* first_ptr  = thread_ptr;
+  TX_THREAD* next_ptr;
+  CHAR*      thread_name;
+
+  do
+  {
+    if (tx_thread_info_get(thread_ptr, &thread_name, TX_NULL, TX_NULL, TX_NULL, TX_NULL, TX_NULL, &next_ptr,
+             TX_NULL) != TX_SUCCESS)
+    {
+      return TX_NULL;
+    }
+    if (strcmp(thread_name, name) == 0)
+    {
+      return thread_ptr;
+    }
+    thread_ptr = next_ptr;
+  } while (thread_ptr != first_ptr);
+
+  return TX_NULL;
+}
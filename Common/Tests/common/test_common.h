@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    test_common.h
+  * @brief   Assertions and result reporting shared by the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+
+#include "tx_api.h"
+#include "tx_host.h"
+
+/* Fail the test and stop ThreadX when the condition does not hold. */
+#define TEST_ASSERT(condition)                                                                                         \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (!(condition))                                                                                                  \
+    {                                                                                                                  \
+      test_fail(__FILE__, __LINE__, #condition);                                                                       \
+    }                                                                                                                  \
+  } while (0)
+
+/* Run ThreadX for at most max_ticks of virtual time, returns the exit status
+   of the test program: 0 when test_pass was called. */
+int test_run(ULONG max_ticks);
+
+/* End the test from a thread. */
+VOID test_pass(VOID);
+VOID test_fail(const CHAR* file, int line, const CHAR* condition);
+
+/* Print one benchmark result as a JSON line. format gives the fields after
+   the test name, such as "\"bytes\":%u,\"mbps\":%.1f". */
+VOID test_result(const CHAR* name, const CHAR* format, ...) __attribute__((format(printf, 2, 3)));
+
+/* Discard what the code under test prints from now on, such as the log of
+   each message of the board helper. The results and the verdict still print. */
+VOID test_log_mute(VOID);
+
+/* The thread created with name, such as a thread of the application code, to
+   read its CPU time. Called from a thread, TX_NULL when there is none. */
+TX_THREAD* test_thread_find(const CHAR* name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_COMMON_H */
@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file    test_dhcp.c
+  * @brief   DHCP server of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include "test_dhcp.h"
+
+#include "nxd_dhcp_server.h"
+
+static NX_DHCP_SERVER test_dhcp_server;
+static ULONG64        test_dhcp_stack[8192 / sizeof(ULONG64)];
+
+UINT test_dhcp_create(TEST_NET_HOST* host_ptr, ULONG first, ULONG last, ULONG dns_address)
+{
+  UINT status;
+  UINT added;
+
+  if ((status = nx_dhcp_server_create(&test_dhcp_server,
+           &host_ptr->ip,
+           test_dhcp_stack,
+           sizeof(test_dhcp_stack),
+           "DHCP Server",
+           &host_ptr->pool)))
+  {
+    return status;
+  }
+
+  if ((status = nx_dhcp_create_server_ip_address_list(&test_dhcp_server, 0, first, last, &added)) ||
+      (status = nx_dhcp_set_interface_network_parameters(&test_dhcp_server,
+           0,
+           TEST_NET_MASK,
+           host_ptr->ip.nx_ip_interface[0].nx_interface_ip_address,
+           dns_address)) ||
+      (status = nx_dhcp_server_start(&test_dhcp_server)))
+  {
+    nx_dhcp_server_delete(&test_dhcp_server);
+    return status;
+  }
+
+  return NX_SUCCESS;
+}
+
+UINT test_dhcp_delete(VOID)
+{
+  nx_dhcp_server_stop(&test_dhcp_server);
+
+  return nx_dhcp_server_delete(&test_dhcp_server);
+}
+
+VOID test_dhcp_stats_get(TEST_DHCP_STATS* stats_ptr)
+{
+  stats_ptr->discovers = test_dhcp_server.nx_dhcp_discoveries_received;
+  stats_ptr->requests = test_dhcp_server.nx_dhcp_requests_received;
+  stats_ptr->declines = test_dhcp_server.nx_dhcp_declines_received;
+  stats_ptr->releases = test_dhcp_server.nx_dhcp_releases_received;
+}
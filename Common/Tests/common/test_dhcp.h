@@ -0,0 +1,53 @@
+/**
+  ******************************************************************************
+  * @file    test_dhcp.h
+  * @brief   DHCP server of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_DHCP_H
+#define TEST_DHCP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "test_net.h"
+
+/* Messages the server answered with an OFFER or an ACK, the NetX server does
+   not count the ones it answers with a NAK. */
+typedef struct TEST_DHCP_STATS_STRUCT
+{
+  ULONG discovers;
+  ULONG requests;
+  ULONG declines;
+  ULONG releases;
+} TEST_DHCP_STATS;
+
+/* Start the DHCP server of NetX Duo on a host of the segment, there is one per
+   test. It leases the addresses from first to last of TEST_NET_MASK, the host
+   as router and dns_address as DNS server. The NetX DHCP server and client
+   headers do not go together, the client side of a test does not see the
+   server. */
+UINT test_dhcp_create(TEST_NET_HOST* host_ptr, ULONG first, ULONG last, ULONG dns_address);
+
+/* Stop the server and delete it, the host stays. */
+UINT test_dhcp_delete(VOID);
+
+VOID test_dhcp_stats_get(TEST_DHCP_STATS* stats_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_DHCP_H */
@@ -0,0 +1,263 @@
+/**
+  ******************************************************************************
+  * @file    test_dns.c
+  * @brief   DNS responder of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The responder thread takes the queries from its UDP socket and answers each
+   with the question copied back and, for the A query of a known name, an
+   address record per address. Only queries with one question are answered. */
+
+#include <strings.h>
+
+#include "test_dns.h"
+
+#define TEST_DNS_PRIORITY           4
+#define TEST_DNS_QUEUE              8
+#define TEST_DNS_TTL                300
+
+#define DNS_HEADER_SIZE             12
+#define DNS_MESSAGE_MAX             512
+#define DNS_FLAG_RESPONSE           0x8000
+#define DNS_FLAG_RECURSION          0x0180
+#define DNS_RCODE_NAME_ERROR        3
+#define DNS_TYPE_A                  1
+#define DNS_CLASS_IN                1
+#define DNS_A_RECORD_SIZE           16
+
+static VOID test_dns_entry(ULONG input);
+
+UINT test_dns_create(TEST_DNS* dns_ptr, ULONG address, UINT packet_count)
+{
+  UINT status;
+
+  dns_ptr->record_count = 0;
+  dns_ptr->delay = 0;
+  dns_ptr->queries = 0;
+
+  if ((status = test_net_host_create(&dns_ptr->host, "DNS", address, packet_count)))
+  {
+    return status;
+  }
+
+  if ((status = nx_udp_socket_create(&dns_ptr->host.ip,
+           &dns_ptr->socket,
+           "DNS",
+           NX_IP_NORMAL,
+           NX_FRAGMENT_OKAY,
+           NX_IP_TIME_TO_LIVE,
+           TEST_DNS_QUEUE)) ||
+      (status = nx_udp_socket_bind(&dns_ptr->socket, TEST_DNS_PORT, NX_NO_WAIT)))
+  {
+    test_net_host_delete(&dns_ptr->host);
+    return status;
+  }
+
+  return tx_thread_create(&dns_ptr->thread,
+      "DNS",
+      test_dns_entry,
+      (ULONG)dns_ptr,
+      dns_ptr->stack,
+      sizeof(dns_ptr->stack),
+      TEST_DNS_PRIORITY,
+      TEST_DNS_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+UINT test_dns_delete(TEST_DNS* dns_ptr)
+{
+  tx_thread_terminate(&dns_ptr->thread);
+  tx_thread_delete(&dns_ptr->thread);
+
+  nx_udp_socket_unbind(&dns_ptr->socket);
+  nx_udp_socket_delete(&dns_ptr->socket);
+
+  return test_net_host_delete(&dns_ptr->host);
+}
+
+UINT test_dns_record_add(TEST_DNS* dns_ptr, const CHAR* name, ULONG address)
+{
+  TEST_DNS_RECORD* record_ptr;
+
+  if ((dns_ptr->record_count == TEST_DNS_RECORD_MAX) || (strlen(name) >= TEST_DNS_NAME_SIZE))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  record_ptr = &dns_ptr->records[dns_ptr->record_count++];
+  strcpy(record_ptr->name, name);
+  record_ptr->address = address;
+
+  return NX_SUCCESS;
+}
+
+VOID test_dns_delay_set(TEST_DNS* dns_ptr, ULONG ticks)
+{
+  dns_ptr->delay = ticks;
+}
+
+/* Read the name of the question at offset as dotted text, return the offset
+   after it or 0 when it does not fit. */
+static UINT test_dns_name_get(const UCHAR* message, UINT length, UINT offset, CHAR* name)
+{
+  UINT name_length = 0;
+  UINT label_length;
+
+  while ((offset < length) && (message[offset] != 0))
+  {
+    label_length = message[offset++];
+    if ((label_length > 63) || (offset + label_length > length) ||
+        (name_length + label_length + 1 >= TEST_DNS_NAME_SIZE))
+    {
+      return 0;
+    }
+
+    if (name_length)
+    {
+      name[name_length++] = '.';
+    }
+    memcpy(&name[name_length], &message[offset], label_length);
+    name_length += label_length;
+    offset += label_length;
+  }
+  name[name_length] = 0;
+
+  return (offset < length) ? offset + 1 : 0;
+}
+
+/* The first record of name from index first on. */
+static TEST_DNS_RECORD* test_dns_record_find(TEST_DNS* dns_ptr, const CHAR* name, UINT first)
+{
+  UINT i;
+
+  for (i = first; i < dns_ptr->record_count; i++)
+  {
+    if (strcasecmp(dns_ptr->records[i].name, name) == 0)
+    {
+      return &dns_ptr->records[i];
+    }
+  }
+
+  return NX_NULL;
+}
+
+/* Build the response to the query in message, return its length or 0 when
+   the query is not answered. */
+static UINT test_dns_answer(TEST_DNS* dns_ptr, UCHAR* message, UINT length)
+{
+  CHAR             name[TEST_DNS_NAME_SIZE];
+  TEST_DNS_RECORD* record_ptr;
+  UINT             offset;
+  USHORT           flags;
+  USHORT           type;
+  UINT             answers = 0;
+
+  if ((length < DNS_HEADER_SIZE) || (message[2] & 0x80) || (message[4] != 0) || (message[5] != 1))
+  {
+    return 0;
+  }
+
+  offset = test_dns_name_get(message, length, DNS_HEADER_SIZE, name);
+  if ((offset == 0) || (offset + 4 > length))
+  {
+    return 0;
+  }
+  type = (USHORT)((message[offset] << 8) | message[offset + 1]);
+  offset += 4;
+
+  /* The response keeps the identifier, the question and the recursion desired flag. */
+  record_ptr = test_dns_record_find(dns_ptr, name, 0);
+  flags = DNS_FLAG_RESPONSE | DNS_FLAG_RECURSION | (record_ptr ? 0 : DNS_RCODE_NAME_ERROR);
+  message[2] = (UCHAR)(flags >> 8);
+  message[3] = (UCHAR)flags;
+  memset(&message[6], 0, 6);
+
+  while (record_ptr && (type == DNS_TYPE_A) && (offset + DNS_A_RECORD_SIZE <= DNS_MESSAGE_MAX))
+  {
+    /* The name points to the question. */
+    message[offset++] = 0xC0;
+    message[offset++] = DNS_HEADER_SIZE;
+    message[offset++] = 0;
+    message[offset++] = DNS_TYPE_A;
+    message[offset++] = 0;
+    message[offset++] = DNS_CLASS_IN;
+    message[offset++] = (UCHAR)(TEST_DNS_TTL >> 24);
+    message[offset++] = (UCHAR)(TEST_DNS_TTL >> 16);
+    message[offset++] = (UCHAR)(TEST_DNS_TTL >> 8);
+    message[offset++] = (UCHAR)TEST_DNS_TTL;
+    message[offset++] = 0;
+    message[offset++] = 4;
+    message[offset++] = (UCHAR)(record_ptr->address >> 24);
+    message[offset++] = (UCHAR)(record_ptr->address >> 16);
+    message[offset++] = (UCHAR)(record_ptr->address >> 8);
+    message[offset++] = (UCHAR)record_ptr->address;
+    answers++;
+
+    record_ptr = test_dns_record_find(dns_ptr, name, (UINT)(record_ptr - dns_ptr->records) + 1);
+  }
+  message[7] = (UCHAR)answers;
+
+  return offset;
+}
+
+static VOID test_dns_entry(ULONG input)
+{
+  TEST_DNS*  dns_ptr = (TEST_DNS*)input;
+  NX_PACKET* packet_ptr;
+  NX_PACKET* response_ptr;
+  UCHAR      message[DNS_MESSAGE_MAX];
+  ULONG      length;
+  ULONG      address;
+  UINT       port;
+
+  for (;;)
+  {
+    if (nx_udp_socket_receive(&dns_ptr->socket, &packet_ptr, NX_WAIT_FOREVER))
+    {
+      continue;
+    }
+
+    if ((packet_ptr->nx_packet_length > DNS_MESSAGE_MAX) ||
+        nx_packet_data_retrieve(packet_ptr, message, &length) ||
+        nx_udp_source_extract(packet_ptr, &address, &port))
+    {
+      nx_packet_release(packet_ptr);
+      continue;
+    }
+    nx_packet_release(packet_ptr);
+
+    dns_ptr->queries++;
+    length = test_dns_answer(dns_ptr, message, (UINT)length);
+    if (length == 0)
+    {
+      continue;
+    }
+
+    if (dns_ptr->delay)
+    {
+      tx_thread_sleep(dns_ptr->delay);
+    }
+
+    if (nx_packet_allocate(&dns_ptr->host.pool, &response_ptr, NX_UDP_PACKET, NX_WAIT_FOREVER))
+    {
+      continue;
+    }
+    if (nx_packet_data_append(response_ptr, message, length, &dns_ptr->host.pool, NX_WAIT_FOREVER) ||
+        nx_udp_socket_send(&dns_ptr->socket, response_ptr, address, port))
+    {
+      nx_packet_release(response_ptr);
+    }
+  }
+}
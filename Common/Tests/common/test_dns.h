@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file    test_dns.h
+  * @brief   DNS responder of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_DNS_H
+#define TEST_DNS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "test_net.h"
+
+#define TEST_DNS_PORT               53
+
+/* Names the responder knows. */
+#define TEST_DNS_RECORD_MAX         16
+#define TEST_DNS_NAME_SIZE          64
+
+typedef struct TEST_DNS_RECORD_STRUCT
+{
+  CHAR  name[TEST_DNS_NAME_SIZE];
+  ULONG address;
+} TEST_DNS_RECORD;
+
+/* The responder answers the A queries of its records, one query at a time,
+   after delay ticks, with every address of the name in the order they were
+   added. Other names get a name error, other types of a known name an empty
+   answer. */
+typedef struct TEST_DNS_STRUCT
+{
+  TEST_NET_HOST   host;
+  NX_UDP_SOCKET   socket;
+  TX_THREAD       thread;
+  ULONG64         stack[4096 / sizeof(ULONG64)];
+  TEST_DNS_RECORD records[TEST_DNS_RECORD_MAX];
+  UINT            record_count;
+  ULONG           delay;
+  ULONG           queries;
+} TEST_DNS;
+
+/* Create the responder host at address with a pool of packet_count packets,
+   and start answering on TEST_DNS_PORT. */
+UINT test_dns_create(TEST_DNS* dns_ptr, ULONG address, UINT packet_count);
+
+/* Stop the responder and delete its host. */
+UINT test_dns_delete(TEST_DNS* dns_ptr);
+
+/* Answer the A queries of name with address, and the addresses added before
+   for name. */
+UINT test_dns_record_add(TEST_DNS* dns_ptr, const CHAR* name, ULONG address);
+
+/* Hold each answer back for ticks, the time of the resolver. */
+VOID test_dns_delay_set(TEST_DNS* dns_ptr, ULONG ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_DNS_H */
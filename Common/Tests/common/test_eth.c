@@ -0,0 +1,281 @@
+/**
+  ******************************************************************************
+  * @file    test_eth.c
+  * @brief   Fake Ethernet DMA of the F746 for the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The fake works the chained descriptors of the legacy HAL as the DMA of the
+   F746 does: it starts from the lists of DMARDLAR and DMATDLAR and follows
+   Buffer2NextDescAddr, takes only the descriptors whose OWN bit is set, and
+   hands them back by clearing it. Descriptor and buffer addresses are 32 bit,
+   the tests link without PIE so the static pools and descriptors fit. The
+   interrupt is HAL_ETH_IRQHandler, run from the calling thread: it calls the
+   receive and transmit complete callbacks of the driver. The PHY always has
+   its link up at 100 Mbit/s full duplex. */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "test_eth.h"
+
+#include "nx_stm32_phy_driver.h"
+
+ETH_TypeDef       test_eth_registers;
+ETH_HandleTypeDef heth;
+TEST_ETH_STATS    test_eth_stats;
+
+static uint8_t             test_eth_mac[6] = TEST_ETH_MAC;
+static ETH_DMADescTypeDef* test_eth_rx_next;
+static ETH_DMADescTypeDef* test_eth_tx_next;
+static UINT                test_eth_started;
+static UINT                test_eth_rx_pending; // a frame came without interrupt
+static TEST_ETH_SINK       test_eth_sink;
+static UCHAR               test_eth_frame[TEST_ETH_FRAME_MAX];
+
+static ETH_DMADescTypeDef* test_eth_descriptor(uint32_t address)
+{
+  return (ETH_DMADescTypeDef*)(uintptr_t)address;
+}
+
+/* HAL_ETH_IRQHandler of the legacy HAL. */
+static VOID test_eth_interrupt(VOID)
+{
+  if ((ETH->DMASR & ETH_DMASR_RS) && (ETH->DMAIER & ETH_DMA_IT_R))
+  {
+    ETH->DMASR &= ~(ETH_DMASR_RS | ETH_DMASR_NIS);
+    test_eth_stats.rx_interrupts++;
+    HAL_ETH_RxCpltCallback(&heth);
+  }
+
+  if ((ETH->DMASR & ETH_DMASR_TS) && (ETH->DMAIER & ETH_DMA_IT_T))
+  {
+    ETH->DMASR &= ~(ETH_DMASR_TS | ETH_DMASR_NIS);
+    test_eth_stats.tx_interrupts++;
+    HAL_ETH_TxCpltCallback(&heth);
+  }
+}
+
+UINT test_eth_receive(const UCHAR* frame, ULONG length)
+{
+  ETH_DMADescTypeDef* descriptor = test_eth_rx_next;
+  ETH_DMADescTypeDef* first      = descriptor;
+  ULONG               total      = length + 4;
+  ULONG               offset     = 0;
+  ULONG               size;
+  UINT                count = 0;
+
+  if (!test_eth_started || (length + 4 > TEST_ETH_FRAME_MAX))
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  memcpy(test_eth_frame, frame, length);
+  memset(test_eth_frame + length, 0, 4);
+
+  // The frame needs descriptors enough, all of them owned by the DMA
+  for (size = 0; size < total; size += descriptor->ControlBufferSize & ETH_DMARXDESC_RBS1)
+  {
+    if (!(descriptor->Status & ETH_DMARXDESC_OWN) || (count && (descriptor == first)))
+    {
+      ETH->DMASR |= ETH_DMASR_RBUS;
+      test_eth_stats.rx_missed++;
+      return NX_NOT_SUCCESSFUL;
+    }
+    descriptor = test_eth_descriptor(descriptor->Buffer2NextDescAddr);
+    count++;
+  }
+
+  for (descriptor = first; count--; descriptor = test_eth_descriptor(descriptor->Buffer2NextDescAddr))
+  {
+    size = descriptor->ControlBufferSize & ETH_DMARXDESC_RBS1;
+    if (size > total - offset)
+    {
+      size = total - offset;
+    }
+    memcpy((VOID*)(uintptr_t)descriptor->Buffer1Addr, test_eth_frame + offset, size);
+
+    descriptor->Status = (offset == 0) ? ETH_DMARXDESC_FS : 0;
+    offset += size;
+    if (count == 0)
+    {
+      descriptor->Status |= ETH_DMARXDESC_LS | (total << ETH_DMARXDESC_FRAME_LENGTHSHIFT);
+      test_eth_rx_next = test_eth_descriptor(descriptor->Buffer2NextDescAddr);
+
+      if (descriptor->ControlBufferSize & ETH_DMARXDESC_DIC)
+      {
+        test_eth_rx_pending = 1;
+      }
+      else
+      {
+        test_eth_rx_pending = 0;
+        ETH->DMASR |= ETH_DMASR_RS | ETH_DMASR_NIS;
+      }
+    }
+  }
+
+  test_eth_stats.rx_frames++;
+  test_eth_interrupt();
+
+  return NX_SUCCESS;
+}
+
+VOID test_eth_receive_watchdog(VOID)
+{
+  if (test_eth_rx_pending && ETH->DMARSWTR)
+  {
+    test_eth_rx_pending = 0;
+    test_eth_stats.rx_watchdogs++;
+    ETH->DMASR |= ETH_DMASR_RS | ETH_DMASR_NIS;
+    test_eth_interrupt();
+  }
+}
+
+ULONG test_eth_transmit(VOID)
+{
+  ETH_DMADescTypeDef* descriptor;
+  ULONG               length = 0;
+  ULONG               size;
+  ULONG               frames = 0;
+
+  if (!test_eth_started)
+  {
+    return 0;
+  }
+
+  for (descriptor = test_eth_tx_next; descriptor->Status & ETH_DMATXDESC_OWN;
+       descriptor = test_eth_descriptor(descriptor->Buffer2NextDescAddr))
+  {
+    if (descriptor->Status & ETH_DMATXDESC_FS)
+    {
+      length = 0;
+    }
+
+    size = descriptor->ControlBufferSize & ETH_DMATXDESC_TBS1;
+    if (length + size <= sizeof(test_eth_frame))
+    {
+      memcpy(test_eth_frame + length, (VOID*)(uintptr_t)descriptor->Buffer1Addr, size);
+    }
+    length += size;
+
+    descriptor->Status &= ~ETH_DMATXDESC_OWN;
+    test_eth_stats.tx_descriptors++;
+
+    if (descriptor->Status & ETH_DMATXDESC_LS)
+    {
+      frames++;
+      test_eth_stats.tx_frames++;
+      if (test_eth_sink && (length <= sizeof(test_eth_frame)))
+      {
+        test_eth_sink(test_eth_frame, length);
+      }
+
+      if (descriptor->Status & ETH_DMATXDESC_IC)
+      {
+        ETH->DMASR |= ETH_DMASR_TS | ETH_DMASR_NIS;
+      }
+    }
+  }
+
+  test_eth_tx_next = descriptor;
+
+  test_eth_interrupt();
+
+  return frames;
+}
+
+VOID test_eth_sink_set(TEST_ETH_SINK sink)
+{
+  test_eth_sink = sink;
+}
+
+UINT test_eth_rx_owned(VOID)
+{
+  ETH_DMADescTypeDef* first = test_eth_descriptor(ETH->DMARDLAR);
+  ETH_DMADescTypeDef* descriptor;
+  UINT                count = 0;
+
+  descriptor = first;
+  do
+  {
+    count += (descriptor->Status & ETH_DMARXDESC_OWN) ? 1 : 0;
+    descriptor = test_eth_descriptor(descriptor->Buffer2NextDescAddr);
+  } while (descriptor != first);
+
+  return count;
+}
+
+void MX_ETH_Init(void)
+{
+  memset(&test_eth_registers, 0, sizeof(test_eth_registers));
+
+  heth.Instance          = ETH;
+  heth.Init.MACAddr      = test_eth_mac;
+  heth.Init.ChecksumMode = ETH_CHECKSUM_BY_HARDWARE;
+  heth.Init.Speed        = ETH_SPEED_100M;
+  heth.Init.DuplexMode   = ETH_MODE_FULLDUPLEX;
+}
+
+HAL_StatusTypeDef HAL_ETH_Start(ETH_HandleTypeDef* handle)
+{
+  (void)handle;
+
+  test_eth_rx_next = test_eth_descriptor(ETH->DMARDLAR);
+  test_eth_tx_next = test_eth_descriptor(ETH->DMATDLAR);
+  test_eth_started = 1;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ETH_Stop(ETH_HandleTypeDef* handle)
+{
+  (void)handle;
+
+  test_eth_started = 0;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ETH_ConfigMAC(ETH_HandleTypeDef* handle, ETH_MACInitTypeDef* macconf)
+{
+  (void)handle;
+  (void)macconf;
+
+  return HAL_OK;
+}
+
+void SCB_CleanDCache_by_Addr(uint32_t* addr, int32_t dsize)
+{
+  (void)addr;
+
+  test_eth_stats.clean_calls++;
+  test_eth_stats.clean_bytes += (ULONG64)dsize;
+}
+
+void SCB_InvalidateDCache_by_Addr(uint32_t* addr, int32_t dsize)
+{
+  (void)addr;
+
+  test_eth_stats.invalidate_calls++;
+  test_eth_stats.invalidate_bytes += (ULONG64)dsize;
+}
+
+int32_t nx_eth_phy_init(void)
+{
+  return ETH_PHY_STATUS_OK;
+}
+
+int32_t nx_eth_phy_get_link_state(void)
+{
+  return ETH_PHY_STATUS_100MBITS_FULLDUPLEX;
+}
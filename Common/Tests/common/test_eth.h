@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file    test_eth.h
+  * @brief   Fake Ethernet DMA of the F746 for the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_ETH_H
+#define TEST_ETH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f7xx_hal.h"
+#include "nx_api.h"
+
+/* The MAC address MX_ETH_Init gives the board. */
+#define TEST_ETH_MAC                {0x00, 0x80, 0xE1, 0x00, 0x00, 0x00}
+
+/* Largest frame the fake receives or sends, with its CRC. */
+#define TEST_ETH_FRAME_MAX          1522
+
+/* Frame sent by the DMA, without its CRC. */
+typedef VOID (*TEST_ETH_SINK)(const UCHAR* frame, ULONG length);
+
+typedef struct TEST_ETH_STATS_STRUCT
+{
+  ULONG   rx_frames;        // written to the descriptors
+  ULONG   rx_missed;        // dropped, no descriptor owned by the DMA
+  ULONG   rx_interrupts;
+  ULONG   rx_watchdogs;     // receive interrupts raised by the watchdog
+  ULONG   tx_frames;
+  ULONG   tx_descriptors;
+  ULONG   tx_interrupts;
+  ULONG   clean_calls;
+  ULONG64 clean_bytes;
+  ULONG   invalidate_calls;
+  ULONG64 invalidate_bytes;
+} TEST_ETH_STATS;
+
+extern ETH_HandleTypeDef heth;
+extern TEST_ETH_STATS    test_eth_stats;
+
+/* The DMA writes frame and a CRC to the receive descriptors it owns, from the
+   one after the last it used, and clears their OWN bit. The receive interrupt
+   is raised at once when the last descriptor of the frame interrupts on
+   completion, else when the watchdog expires. Returns NX_NOT_SUCCESSFUL when
+   the frame is missed for want of descriptors. */
+UINT test_eth_receive(const UCHAR* frame, ULONG length);
+
+/* The receive watchdog expires, DMARSWTR x 256 HCLK cycles after the last
+   frame: it raises the receive interrupt if a frame came without one. */
+VOID test_eth_receive_watchdog(VOID);
+
+/* The DMA sends every frame of the transmit descriptors it owns, from the one
+   after the last it sent, passes them to the sink and clears their OWN bit.
+   It raises the transmit interrupt once if one of them interrupts on
+   completion. Returns the number of frames sent. */
+ULONG test_eth_transmit(VOID);
+
+/* Receive the frames sent from now on, TX_NULL drops them. */
+VOID test_eth_sink_set(TEST_ETH_SINK sink);
+
+/* Receive descriptors the DMA owns. */
+UINT test_eth_rx_owned(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_ETH_H */
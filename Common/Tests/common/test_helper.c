@@ -0,0 +1,152 @@
+/**
+  ******************************************************************************
+  * @file    test_helper.c
+  * @brief   Board helper client of the host tests, connected to the test broker
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include <time.h>
+
+#include "nx_azure_iot_clock.h"
+#include "test_helper.h"
+#include "test_tls.h"
+#include "tx_host.h"
+
+static UINT test_helper_unix_time_get(ULONG* unix_time)
+{
+  *unix_time = (ULONG)time(NX_NULL);
+
+  return NX_SUCCESS;
+}
+
+/* The link is up and the DNS client has its server, there is nothing to bring up. */
+static UINT test_helper_network_connect(VOID)
+{
+  return NX_SUCCESS;
+}
+
+static VOID test_helper_entry(ULONG input)
+{
+  TEST_HELPER* helper_ptr = (TEST_HELPER*)input;
+
+  nx_azure_iot_client_hub_run(
+      &helper_ptr->context, (CHAR*)TEST_HUB_HOSTNAME, (CHAR*)TEST_HUB_DEVICE_ID, test_helper_network_connect);
+}
+
+static VOID test_helper_dps_entry(ULONG input)
+{
+  TEST_HELPER* helper_ptr = (TEST_HELPER*)input;
+
+  nx_azure_iot_client_dps_run(&helper_ptr->context,
+      (CHAR*)TEST_HELPER_DPS_ID_SCOPE,
+      (CHAR*)TEST_HELPER_DPS_REGISTRATION_ID,
+      test_helper_network_connect);
+}
+
+static UINT test_helper_thread_start(TEST_HELPER* helper_ptr, UINT priority, VOID (*entry)(ULONG))
+{
+  return tx_thread_create(&helper_ptr->thread,
+      "Helper",
+      entry,
+      (ULONG)helper_ptr,
+      helper_ptr->stack,
+      sizeof(helper_ptr->stack),
+      priority,
+      priority,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+UINT test_helper_create(TEST_HELPER* helper_ptr, TEST_NET_HOST* host_ptr, ULONG dns_address)
+{
+  UINT status;
+
+  if ((status = nx_dns_create(&helper_ptr->dns, &host_ptr->ip, (UCHAR*)"DNS Client")))
+  {
+    return status;
+  }
+
+#ifdef NX_DNS_CLIENT_USER_CREATE_PACKET_POOL
+  if ((status = nx_dns_packet_pool_set(&helper_ptr->dns, &host_ptr->pool)))
+  {
+    nx_dns_delete(&helper_ptr->dns);
+    return status;
+  }
+#endif /* NX_DNS_CLIENT_USER_CREATE_PACKET_POOL */
+
+  if ((status = nx_dns_cache_initialize(&helper_ptr->dns, helper_ptr->dns_cache, sizeof(helper_ptr->dns_cache))) ||
+      (status = nx_dns_server_add(&helper_ptr->dns, dns_address)))
+  {
+    nx_dns_delete(&helper_ptr->dns);
+    return status;
+  }
+
+  nx_azure_iot_clock_update((ULONG64)time(NX_NULL) * 1000000, tx_time_get());
+
+  if ((status = nx_azure_iot_client_create(&helper_ptr->context,
+           &host_ptr->ip,
+           &host_ptr->pool,
+           &helper_ptr->dns,
+           test_helper_unix_time_get,
+           (CHAR*)TEST_HELPER_MODEL_ID,
+           sizeof(TEST_HELPER_MODEL_ID) - 1)))
+  {
+    nx_dns_delete(&helper_ptr->dns);
+    return status;
+  }
+
+  /* The hub is the broker: the test authority replaces the first Azure root.
+     The other two stay, the trusted store refuses two of the same name. */
+  if ((status = nx_secure_x509_certificate_initialize(&helper_ptr->context.root_ca_cert,
+           (UCHAR*)test_tls_ca_cert,
+           (USHORT)test_tls_ca_cert_size,
+           NX_NULL,
+           0,
+           NX_NULL,
+           0,
+           NX_SECURE_X509_KEY_TYPE_NONE)))
+  {
+    return status;
+  }
+
+  return nx_azure_iot_client_sas_set(&helper_ptr->context, (CHAR*)TEST_HUB_DEVICE_KEY);
+}
+
+UINT test_helper_start(TEST_HELPER* helper_ptr, UINT priority)
+{
+  return test_helper_thread_start(helper_ptr, priority, test_helper_entry);
+}
+
+UINT test_helper_dps_start(TEST_HELPER* helper_ptr, UINT priority)
+{
+  return test_helper_thread_start(helper_ptr, priority, test_helper_dps_entry);
+}
+
+VOID test_helper_connected_wait(TEST_HELPER* helper_ptr)
+{
+  while (helper_ptr->context.azure_iot_connection_status != NX_SUCCESS)
+  {
+    tx_thread_sleep(1);
+  }
+}
+
+UINT test_helper_dns_flush(TEST_HELPER* helper_ptr)
+{
+  return nx_dns_cache_initialize(&helper_ptr->dns, helper_ptr->dns_cache, sizeof(helper_ptr->dns_cache));
+}
+
+ULONG64 test_helper_cpu_ns(TEST_HELPER* helper_ptr, TEST_NET_HOST* host_ptr)
+{
+  return tx_host_thread_cpu_ns(&helper_ptr->thread) + tx_host_thread_cpu_ns(&host_ptr->ip.nx_ip_thread) +
+         tx_host_thread_cpu_ns(&helper_ptr->context.nx_azure_iot.nx_azure_iot_cloud.nx_cloud_thread);
+}
@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file    test_helper.h
+  * @brief   Board helper client of the host tests, connected to the test broker
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_HELPER_H
+#define TEST_HELPER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "nx_azure_iot_client.h"
+#include "test_hub.h"
+
+#define TEST_HELPER_MODEL_ID        "dtmi:test:device;1"
+
+/* DPS registration of the device. No DPS answers in the tests, the helper only
+   reaches the hub through an assignment found in its DPS cache. */
+#define TEST_HELPER_DPS_ID_SCOPE    "0ne00000000"
+#define TEST_HELPER_DPS_REGISTRATION_ID TEST_HUB_DEVICE_ID
+
+/* NX_DNS_CACHE_SIZE of app_netxduo.h. */
+#define TEST_HELPER_DNS_CACHE_SIZE  1024
+
+/* The client of nx_azure_iot_client.c and the thread running its loop, as the
+   application thread of the board does. */
+typedef struct TEST_HELPER_STRUCT
+{
+  NX_DNS            dns;
+  ULONG             dns_cache[TEST_HELPER_DNS_CACHE_SIZE / sizeof(ULONG)];
+  AZURE_IOT_CONTEXT context;
+  TX_THREAD         thread;
+  ULONG64           stack[16384 / sizeof(ULONG64)];
+} TEST_HELPER;
+
+/* Create the DNS client of host with dns_address as server and the helper
+   client of TEST_HUB_DEVICE_ID with the device key, trusting the test
+   authority. The clock of the helper is set, as after SNTP. Callbacks and
+   settings of the context are then set before test_helper_start. */
+UINT test_helper_create(TEST_HELPER* helper_ptr, TEST_NET_HOST* host_ptr, ULONG dns_address);
+
+/* Start the thread running nx_azure_iot_client_hub_run on TEST_HUB_HOSTNAME. */
+UINT test_helper_start(TEST_HELPER* helper_ptr, UINT priority);
+
+/* Start the thread running nx_azure_iot_client_dps_run with the DPS
+   registration of the device. */
+UINT test_helper_dps_start(TEST_HELPER* helper_ptr, UINT priority);
+
+/* Wait until the client is connected to the hub. */
+VOID test_helper_connected_wait(TEST_HELPER* helper_ptr);
+
+/* Empty the DNS cache, the next connect resolves the hub name again. */
+UINT test_helper_dns_flush(TEST_HELPER* helper_ptr);
+
+/* CPU time of the device for the client: its thread, the IP thread of the
+   host, where the records are received, and the cloud thread running MQTT. */
+ULONG64 test_helper_cpu_ns(TEST_HELPER* helper_ptr, TEST_NET_HOST* host_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_HELPER_H */
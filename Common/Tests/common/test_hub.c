@@ -0,0 +1,124 @@
+/**
+  ******************************************************************************
+  * @file    test_hub.c
+  * @brief   IoT Hub client of the host tests, set up as the board helper does
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include <time.h>
+
+#include "test_hub.h"
+#include "test_tls.h"
+
+/* NX_DNS_CACHE_SIZE of app_netxduo.h. */
+#define TEST_HUB_DNS_CACHE_SIZE     1024
+
+static ULONG test_hub_dns_cache[TEST_HUB_DNS_CACHE_SIZE / sizeof(ULONG)];
+
+LONG test_hub_time_offset;
+
+/* The certificates are checked against the time of the host. */
+static UINT test_hub_unix_time_get(ULONG* unix_time)
+{
+  *unix_time = (ULONG)time(NX_NULL) + (ULONG)test_hub_time_offset;
+
+  return NX_SUCCESS;
+}
+
+UINT test_hub_client_create(TEST_HUB_CLIENT* client_ptr, TEST_NET_HOST* host_ptr, ULONG dns_address)
+{
+  UINT status;
+
+  if ((status = nx_dns_create(&client_ptr->dns, &host_ptr->ip, (UCHAR*)"DNS Client")))
+  {
+    return status;
+  }
+
+#ifdef NX_DNS_CLIENT_USER_CREATE_PACKET_POOL
+  if ((status = nx_dns_packet_pool_set(&client_ptr->dns, &host_ptr->pool)))
+  {
+    nx_dns_delete(&client_ptr->dns);
+    return status;
+  }
+#endif /* NX_DNS_CLIENT_USER_CREATE_PACKET_POOL */
+
+  if ((status = nx_dns_cache_initialize(&client_ptr->dns, test_hub_dns_cache, sizeof(test_hub_dns_cache))) ||
+      (status = nx_dns_server_add(&client_ptr->dns, dns_address)))
+  {
+    nx_dns_delete(&client_ptr->dns);
+    return status;
+  }
+
+  if ((status = nx_azure_iot_create(&client_ptr->nx_azure_iot,
+           (UCHAR*)"Azure IoT",
+           &host_ptr->ip,
+           &host_ptr->pool,
+           &client_ptr->dns,
+           client_ptr->stack,
+           sizeof(client_ptr->stack),
+           TEST_HUB_PRIORITY,
+           test_hub_unix_time_get)))
+  {
+    nx_dns_delete(&client_ptr->dns);
+    return status;
+  }
+
+  if ((status = nx_secure_x509_certificate_initialize(&client_ptr->trusted_cert,
+           (UCHAR*)test_tls_ca_cert,
+           (USHORT)test_tls_ca_cert_size,
+           NX_NULL,
+           0,
+           NX_NULL,
+           0,
+           NX_SECURE_X509_KEY_TYPE_NONE)) ||
+      (status = nx_azure_iot_hub_client_initialize(&client_ptr->hub_client,
+           &client_ptr->nx_azure_iot,
+           (UCHAR*)TEST_HUB_HOSTNAME,
+           sizeof(TEST_HUB_HOSTNAME) - 1,
+           (UCHAR*)TEST_HUB_DEVICE_ID,
+           sizeof(TEST_HUB_DEVICE_ID) - 1,
+           (UCHAR*)"",
+           0,
+           _nx_azure_iot_tls_supported_crypto,
+           _nx_azure_iot_tls_supported_crypto_size,
+           _nx_azure_iot_tls_ciphersuite_map,
+           _nx_azure_iot_tls_ciphersuite_map_size,
+           (UCHAR*)client_ptr->metadata,
+           sizeof(client_ptr->metadata),
+           &client_ptr->trusted_cert)))
+  {
+    nx_azure_iot_delete(&client_ptr->nx_azure_iot);
+    nx_dns_delete(&client_ptr->dns);
+    return status;
+  }
+
+  if ((status = nx_azure_iot_hub_client_symmetric_key_set(&client_ptr->hub_client,
+           (UCHAR*)TEST_HUB_DEVICE_KEY,
+           sizeof(TEST_HUB_DEVICE_KEY) - 1)))
+  {
+    test_hub_client_delete(client_ptr);
+  }
+
+  return status;
+}
+
+UINT test_hub_client_delete(TEST_HUB_CLIENT* client_ptr)
+{
+  UINT status;
+
+  nx_azure_iot_hub_client_deinitialize(&client_ptr->hub_client);
+  status = nx_azure_iot_delete(&client_ptr->nx_azure_iot);
+  nx_dns_delete(&client_ptr->dns);
+
+  return status;
+}
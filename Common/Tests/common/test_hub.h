@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file    test_hub.h
+  * @brief   IoT Hub client of the host tests, set up as the board helper does
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_HUB_H
+#define TEST_HUB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "nx_azure_iot_ciphersuites.h"
+#include "nx_azure_iot_hub_client.h"
+#include "test_net.h"
+
+/* The hub is the test broker: its name is the common name of the broker
+   certificate, and the test DNS responder resolves it. */
+#define TEST_HUB_HOSTNAME           "test-broker"
+#define TEST_HUB_DEVICE_ID          "device"
+
+/* Device key of the SAS tokens, base64. The broker takes any password. */
+#define TEST_HUB_DEVICE_KEY         "dGVzdC1kZXZpY2Uta2V5"
+
+/* Priority of the Azure IoT thread, NX_AZURE_IOT_THREAD_PRIORITY of the helper. */
+#define TEST_HUB_PRIORITY           4
+
+/* Seconds added to the host time of the SAS tokens and the certificate dates,
+   0 unless a test moves the clock of the device. */
+extern LONG test_hub_time_offset;
+
+typedef struct TEST_HUB_CLIENT_STRUCT
+{
+  NX_DNS                  dns;
+  NX_AZURE_IOT            nx_azure_iot;
+  NX_AZURE_IOT_HUB_CLIENT hub_client;
+  NX_SECURE_X509_CERT     trusted_cert;
+  ULONG                   metadata[NX_AZURE_IOT_TLS_METADATA_BUFFER_SIZE / sizeof(ULONG)];
+  ULONG64                 stack[8192 / sizeof(ULONG64)];
+} TEST_HUB_CLIENT;
+
+/* Create the DNS client of host with dns_address as server, the Azure IoT
+   instance and the hub client of TEST_HUB_DEVICE_ID on TEST_HUB_HOSTNAME with
+   the board crypto, trusting the test authority and using the device key. */
+UINT test_hub_client_create(TEST_HUB_CLIENT* client_ptr, TEST_NET_HOST* host_ptr, ULONG dns_address);
+
+/* Deinitialize the hub client, delete the Azure IoT instance and the DNS client. */
+UINT test_hub_client_delete(TEST_HUB_CLIENT* client_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_HUB_H */
@@ -0,0 +1,345 @@
+/**
+  ******************************************************************************
+  * @file    test_motion.c
+  * @brief   Fake ISM330DHCX of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The fake answers the register reads and writes of the ISM330DHCX driver
+   from a register file. Only the FIFO is modelled: a timer adds the
+   accelerometer samples at the lower of the output and batch data rates, the
+   FIFO status registers give the level and the watermark flag, and each word
+   read from FIFO_DATA_OUT_TAG, or the address range after it, pops a sample.
+   The samples themselves are not stored, sample n is computed from n, by
+   TEST_MOTION_SAMPLE_X, _Y and _Z or by the source of the test. */
+
+#include <string.h>
+
+#include "test_motion.h"
+
+#include "b_u585i_iot02a_motion_sensors.h"
+#include "motion_fifo.h"
+
+#define TEST_MOTION_REGISTERS       0x80
+#define TEST_MOTION_WORD_SIZE       7
+#define TEST_MOTION_STREAM_MODE     6
+#define TEST_MOTION_CTRL3_C_SELF    0x81 // BOOT and SW_RESET clear themselves
+
+/* The I2C address and the register address, then the device address again
+   before the data of a read. */
+#define TEST_MOTION_WRITE_BYTES     2
+#define TEST_MOTION_READ_BYTES      3
+
+TEST_MOTION_STATS test_motion_stats;
+void*             Motion_Sensor_CompObj[MOTION_SENSOR_INSTANCES_NBR];
+
+static ISM330DHCX_Object_t test_motion_sensor;
+static TX_TIMER            test_motion_timer;
+static UCHAR               test_motion_registers[TEST_MOTION_REGISTERS];
+static ULONG               test_motion_first; // oldest sample in the FIFO
+static UINT                test_motion_level;
+static UINT                test_motion_overrun;
+static UINT                test_motion_int1;
+static double              test_motion_due;
+static TEST_MOTION_SOURCE  test_motion_source;
+
+/* Data rates of the ODR_XL field of CTRL1_XL and of the BDR_XL field of
+   FIFO_CTRL3, in Hz. */
+static const double test_motion_rates[16] = {0, 12.5, 26, 52, 104, 208, 417, 833, 1667, 3333, 6667, 1.6};
+
+static double test_motion_rate(VOID)
+{
+  double odr = test_motion_rates[test_motion_registers[ISM330DHCX_CTRL1_XL] >> 4];
+  double bdr = test_motion_rates[test_motion_registers[ISM330DHCX_FIFO_CTRL3] & 0x0F];
+
+  if ((test_motion_registers[ISM330DHCX_FIFO_CTRL4] & 0x07) != TEST_MOTION_STREAM_MODE)
+  {
+    return 0;
+  }
+
+  return (odr < bdr) ? odr : bdr;
+}
+
+static UINT test_motion_watermark(VOID)
+{
+  return test_motion_registers[ISM330DHCX_FIFO_CTRL1] | ((test_motion_registers[ISM330DHCX_FIFO_CTRL2] & 0x01) << 8);
+}
+
+/* INT1 follows the watermark flag when it is routed there, the EXTI fires on
+   its rising edge. */
+static VOID test_motion_int1_update(VOID)
+{
+  UINT watermark = test_motion_watermark();
+  UINT int1      = (test_motion_registers[ISM330DHCX_INT1_CTRL] & 0x08) && (watermark > 0) &&
+              (test_motion_level >= watermark);
+
+  if (int1 && !test_motion_int1)
+  {
+    test_motion_stats.interrupts++;
+    motion_fifo_isr();
+  }
+  test_motion_int1 = int1;
+}
+
+static VOID test_motion_tick(ULONG input)
+{
+  (void)input;
+
+  test_motion_due += test_motion_rate() / TX_TIMER_TICKS_PER_SECOND;
+  while (test_motion_due >= 1)
+  {
+    test_motion_due -= 1;
+    test_motion_stats.samples++;
+
+    if (test_motion_level == TEST_MOTION_FIFO_WORDS)
+    {
+      test_motion_first++;
+      test_motion_overrun = TX_TRUE;
+      test_motion_stats.samples_overrun++;
+    }
+    else
+    {
+      test_motion_level++;
+    }
+  }
+
+  test_motion_int1_update();
+}
+
+static VOID test_motion_transfer(UINT bytes)
+{
+  test_motion_stats.transfers++;
+  test_motion_stats.bus_ns += (ULONG64)bytes * 9 * 1000000000ULL / TEST_MOTION_BUS_HZ;
+}
+
+static UCHAR test_motion_register_read(UINT address)
+{
+  switch (address)
+  {
+    case ISM330DHCX_FIFO_STATUS1:
+      return (UCHAR)test_motion_level;
+
+    case ISM330DHCX_FIFO_STATUS2:
+      return (UCHAR)(((test_motion_level >> 8) & 0x03) | (test_motion_overrun ? 0x40 : 0) |
+                     ((test_motion_watermark() && (test_motion_level >= test_motion_watermark())) ? 0x80 : 0));
+
+    default:
+      return test_motion_registers[address % TEST_MOTION_REGISTERS];
+  }
+}
+
+/* A word per sample, tagged as the accelerometer with the low bits of n as the
+   tag counter; a zero word when the FIFO is empty. */
+static VOID test_motion_word_pop(UCHAR* word)
+{
+  ULONG   n;
+  int16_t xyz[3];
+
+  memset(word, 0, TEST_MOTION_WORD_SIZE);
+  if (test_motion_level == 0)
+  {
+    return;
+  }
+
+  n = test_motion_first++;
+  test_motion_level--;
+  test_motion_stats.words_read++;
+
+  if (test_motion_source != TX_NULL)
+  {
+    test_motion_source(n, xyz);
+  }
+  else
+  {
+    xyz[0] = TEST_MOTION_SAMPLE_X(n);
+    xyz[1] = TEST_MOTION_SAMPLE_Y(n);
+    xyz[2] = TEST_MOTION_SAMPLE_Z(n);
+  }
+
+  word[0] = (UCHAR)((ISM330DHCX_XL_NC_TAG << 3) | ((n & 0x03) << 1));
+  word[1] = (UCHAR)xyz[0];
+  word[2] = (UCHAR)(xyz[0] >> 8);
+  word[3] = (UCHAR)xyz[1];
+  word[4] = (UCHAR)(xyz[1] >> 8);
+  word[5] = (UCHAR)xyz[2];
+  word[6] = (UCHAR)(xyz[2] >> 8);
+}
+
+static int32_t test_motion_read(uint16_t device, uint16_t address, uint8_t* data, uint16_t length)
+{
+  UCHAR word[TEST_MOTION_WORD_SIZE];
+  UINT  i;
+
+  (void)device;
+
+  test_motion_transfer(TEST_MOTION_READ_BYTES + length);
+
+  /* The output address rolls back to the tag after Z_H. */
+  if ((address >= ISM330DHCX_FIFO_DATA_OUT_TAG) && (address <= ISM330DHCX_FIFO_DATA_OUT_Z_H))
+  {
+    for (i = 0; i < length; i++)
+    {
+      if ((i == 0) || (address + i - ISM330DHCX_FIFO_DATA_OUT_TAG) % TEST_MOTION_WORD_SIZE == 0)
+      {
+        test_motion_word_pop(word);
+      }
+      data[i] = word[(address + i - ISM330DHCX_FIFO_DATA_OUT_TAG) % TEST_MOTION_WORD_SIZE];
+    }
+  }
+  else
+  {
+    for (i = 0; i < length; i++)
+    {
+      data[i] = test_motion_register_read(address + i);
+    }
+
+    /* Reading the status clears the overrun flag. */
+    if ((address <= ISM330DHCX_FIFO_STATUS2) && (address + length > ISM330DHCX_FIFO_STATUS2))
+    {
+      test_motion_overrun = TX_FALSE;
+    }
+  }
+
+  test_motion_int1_update();
+
+  return ISM330DHCX_OK;
+}
+
+static int32_t test_motion_write(uint16_t device, uint16_t address, uint8_t* data, uint16_t length)
+{
+  UINT i;
+
+  (void)device;
+
+  test_motion_transfer(TEST_MOTION_WRITE_BYTES + length);
+
+  for (i = 0; i < length; i++)
+  {
+    test_motion_registers[(address + i) % TEST_MOTION_REGISTERS] = data[i];
+  }
+  test_motion_registers[ISM330DHCX_CTRL3_C] &= (UCHAR)~TEST_MOTION_CTRL3_C_SELF;
+
+  /* Bypass mode empties the FIFO. */
+  if ((test_motion_registers[ISM330DHCX_FIFO_CTRL4] & 0x07) == 0)
+  {
+    test_motion_first += test_motion_level;
+    test_motion_level   = 0;
+    test_motion_overrun = TX_FALSE;
+  }
+
+  test_motion_int1_update();
+
+  return ISM330DHCX_OK;
+}
+
+static int32_t test_motion_bus_init(void)
+{
+  return ISM330DHCX_OK;
+}
+
+static int32_t test_motion_tick_get(void)
+{
+  return (int32_t)(tx_time_get() * (1000 / TX_TIMER_TICKS_PER_SECOND));
+}
+
+UINT test_motion_start(VOID)
+{
+  test_motion_registers[ISM330DHCX_WHO_AM_I] = ISM330DHCX_ID;
+
+  return tx_timer_create(&test_motion_timer, "Motion sensor", test_motion_tick, 0, 1, 1, TX_AUTO_ACTIVATE);
+}
+
+VOID test_motion_source_set(TEST_MOTION_SOURCE source)
+{
+  test_motion_source = source;
+}
+
+int32_t BSP_MOTION_SENSOR_Init(uint32_t Instance, uint32_t Functions)
+{
+  ISM330DHCX_IO_t io = {0};
+  uint8_t         id;
+
+  (void)Functions;
+
+  if (Instance != 0)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  io.BusType  = ISM330DHCX_I2C_BUS;
+  io.Address  = ISM330DHCX_I2C_ADD_H;
+  io.Init     = test_motion_bus_init;
+  io.DeInit   = test_motion_bus_init;
+  io.ReadReg  = test_motion_read;
+  io.WriteReg = test_motion_write;
+  io.GetTick  = test_motion_tick_get;
+
+  if ((ISM330DHCX_RegisterBusIO(&test_motion_sensor, &io) != ISM330DHCX_OK) ||
+      (ISM330DHCX_ReadID(&test_motion_sensor, &id) != ISM330DHCX_OK) || (id != ISM330DHCX_ID) ||
+      (ISM330DHCX_Init(&test_motion_sensor) != ISM330DHCX_OK))
+  {
+    return BSP_ERROR_COMPONENT_FAILURE;
+  }
+
+  Motion_Sensor_CompObj[0] = &test_motion_sensor;
+
+  return BSP_ERROR_NONE;
+}
+
+int32_t BSP_MOTION_SENSOR_Enable(uint32_t Instance, uint32_t Function)
+{
+  if ((Instance != 0) || (Motion_Sensor_CompObj[0] == TX_NULL))
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if (((Function == MOTION_ACCELERO) ? ISM330DHCX_ACC_Enable(&test_motion_sensor)
+                                     : ISM330DHCX_GYRO_Enable(&test_motion_sensor)) != ISM330DHCX_OK)
+  {
+    return BSP_ERROR_COMPONENT_FAILURE;
+  }
+
+  return BSP_ERROR_NONE;
+}
+
+int32_t BSP_MOTION_SENSOR_SetOutputDataRate(uint32_t Instance, uint32_t Function, float Odr)
+{
+  if ((Instance != 0) || (Motion_Sensor_CompObj[0] == TX_NULL))
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if (((Function == MOTION_ACCELERO) ? ISM330DHCX_ACC_SetOutputDataRate(&test_motion_sensor, Odr)
+                                     : ISM330DHCX_GYRO_SetOutputDataRate(&test_motion_sensor, Odr)) != ISM330DHCX_OK)
+  {
+    return BSP_ERROR_COMPONENT_FAILURE;
+  }
+
+  return BSP_ERROR_NONE;
+}
+
+int32_t BSP_MOTION_SENSOR_SetFullScale(uint32_t Instance, uint32_t Function, int32_t Fullscale)
+{
+  if ((Instance != 0) || (Motion_Sensor_CompObj[0] == TX_NULL))
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if (((Function == MOTION_ACCELERO) ? ISM330DHCX_ACC_SetFullScale(&test_motion_sensor, Fullscale)
+                                     : ISM330DHCX_GYRO_SetFullScale(&test_motion_sensor, Fullscale)) != ISM330DHCX_OK)
+  {
+    return BSP_ERROR_COMPONENT_FAILURE;
+  }
+
+  return BSP_ERROR_NONE;
+}
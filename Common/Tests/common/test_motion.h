@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file    test_motion.h
+  * @brief   Fake ISM330DHCX of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_MOTION_H
+#define TEST_MOTION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tx_api.h"
+
+/* Words the FIFO holds, in stream mode the oldest is dropped past them. */
+#define TEST_MOTION_FIFO_WORDS      512
+
+/* The I2C bus of the sensor, 9 bits per byte at 400 kHz. */
+#define TEST_MOTION_BUS_HZ          400000
+
+/* Accelerometer sample n of the fake: x and z hold the low and high half of n,
+   y its complement, so a reader can tell a sample lost or read twice. */
+#define TEST_MOTION_SAMPLE_X(n)     ((int16_t)(n))
+#define TEST_MOTION_SAMPLE_Y(n)     ((int16_t)~(n))
+#define TEST_MOTION_SAMPLE_Z(n)     ((int16_t)((n) >> 16))
+
+/* Source of the accelerometer samples, fills x, y and z of sample n in LSB. */
+typedef VOID (*TEST_MOTION_SOURCE)(ULONG n, int16_t* xyz);
+
+typedef struct TEST_MOTION_STATS_STRUCT
+{
+  ULONG   samples;         // written into the FIFO
+  ULONG   samples_overrun; // dropped from a full FIFO
+  ULONG   words_read;
+  ULONG   interrupts;      // rising edges of the watermark on INT1
+  ULONG   transfers;       // register reads and writes on the bus
+  ULONG64 bus_ns;          // time the transfers take on the bus
+} TEST_MOTION_STATS;
+
+extern TEST_MOTION_STATS test_motion_stats;
+
+/* Start the sensor clock. From then on, while the accelerometer is on and
+   batched in stream mode, the FIFO fills at the batch data rate, and
+   motion_fifo_isr is called when INT1 rises with the watermark. The BSP motion
+   sensor functions drive the fake through the ISM330DHCX driver. */
+UINT test_motion_start(VOID);
+
+/* Take the samples from source from the next one read out of the FIFO on,
+   TX_NULL returns to TEST_MOTION_SAMPLE_X, _Y and _Z. */
+VOID test_motion_source_set(TEST_MOTION_SOURCE source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_MOTION_H */
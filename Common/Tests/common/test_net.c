@@ -0,0 +1,132 @@
+/**
+  ******************************************************************************
+  * @file    test_net.c
+  * @brief   NetX instances of the host tests, connected by nx_host_link
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include "test_net.h"
+
+/* Hosts created, for the peak use of their pools. */
+static TEST_NET_HOST* test_net_hosts;
+
+UINT __real__nx_packet_allocate(NX_PACKET_POOL* pool_ptr, NX_PACKET** packet_ptr, ULONG packet_type, ULONG wait_option);
+UINT __wrap__nx_packet_allocate(NX_PACKET_POOL* pool_ptr, NX_PACKET** packet_ptr, ULONG packet_type, ULONG wait_option);
+
+UINT __wrap__nx_packet_allocate(NX_PACKET_POOL* pool_ptr, NX_PACKET** packet_ptr, ULONG packet_type, ULONG wait_option)
+{
+  TEST_NET_HOST* host_ptr;
+  UINT           status;
+
+  status = __real__nx_packet_allocate(pool_ptr, packet_ptr, packet_type, wait_option);
+  if (status == NX_SUCCESS)
+  {
+    for (host_ptr = test_net_hosts; host_ptr; host_ptr = host_ptr->next)
+    {
+      if ((&host_ptr->pool == pool_ptr) && (test_net_packets_used(host_ptr) > host_ptr->packets_used_max))
+      {
+        host_ptr->packets_used_max = test_net_packets_used(host_ptr);
+      }
+    }
+  }
+
+  return status;
+}
+
+UINT test_net_host_create(TEST_NET_HOST* host_ptr, CHAR* name, ULONG address, UINT packet_count)
+{
+  UINT  status;
+  ULONG link_up;
+
+  if (packet_count > TEST_NET_PACKET_COUNT_MAX)
+  {
+    return NX_INVALID_PARAMETERS;
+  }
+
+  status = nx_packet_pool_create(&host_ptr->pool,
+      name,
+      TEST_NET_PACKET_SIZE,
+      host_ptr->pool_area,
+      packet_count * (TEST_NET_PACKET_SIZE + sizeof(NX_PACKET)));
+  if (status)
+  {
+    return status;
+  }
+
+  status = nx_ip_create(&host_ptr->ip,
+      name,
+      address,
+      TEST_NET_MASK,
+      &host_ptr->pool,
+      nx_host_link_driver,
+      host_ptr->ip_stack,
+      sizeof(host_ptr->ip_stack),
+      TEST_NET_IP_PRIORITY);
+  if (status)
+  {
+    nx_packet_pool_delete(&host_ptr->pool);
+    return status;
+  }
+
+  host_ptr->packets_used_max = 0;
+  host_ptr->next = test_net_hosts;
+  test_net_hosts = host_ptr;
+
+  if ((status = nx_arp_enable(&host_ptr->ip, host_ptr->arp_cache, sizeof(host_ptr->arp_cache))) ||
+      (status = nx_icmp_enable(&host_ptr->ip)) ||
+      (status = nx_udp_enable(&host_ptr->ip)) ||
+      (status = nx_tcp_enable(&host_ptr->ip)) ||
+      (status = nx_ip_interface_status_check(&host_ptr->ip, 0, NX_IP_LINK_ENABLED, &link_up, NX_WAIT_FOREVER)))
+  {
+    test_net_host_delete(host_ptr);
+  }
+
+  return status;
+}
+
+UINT test_net_host_delete(TEST_NET_HOST* host_ptr)
+{
+  TEST_NET_HOST** link_ptr;
+  UINT            status;
+
+  if ((status = nx_ip_delete(&host_ptr->ip)))
+  {
+    return status;
+  }
+
+  for (link_ptr = &test_net_hosts; *link_ptr; link_ptr = &(*link_ptr)->next)
+  {
+    if (*link_ptr == host_ptr)
+    {
+      *link_ptr = host_ptr->next;
+      break;
+    }
+  }
+
+  return nx_packet_pool_delete(&host_ptr->pool);
+}
+
+ULONG test_net_packets_used(TEST_NET_HOST* host_ptr)
+{
+  return host_ptr->pool.nx_packet_pool_total - host_ptr->pool.nx_packet_pool_available;
+}
+
+ULONG test_net_packets_used_max(TEST_NET_HOST* host_ptr)
+{
+  return host_ptr->packets_used_max;
+}
+
+VOID test_net_packets_used_max_reset(TEST_NET_HOST* host_ptr)
+{
+  host_ptr->packets_used_max = test_net_packets_used(host_ptr);
+}
@@ -0,0 +1,71 @@
+/**
+  ******************************************************************************
+  * @file    test_net.h
+  * @brief   NetX instances of the host tests, connected by nx_host_link
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_NET_H
+#define TEST_NET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "nx_api.h"
+#include "nx_host_link.h"
+
+/* Payload of the packets, NX_PACKET_SIZE of app_netxduo.h. */
+#define TEST_NET_PACKET_SIZE        1544
+
+/* Packets a host can have in its pool. */
+#define TEST_NET_PACKET_COUNT_MAX   256
+
+#define TEST_NET_ADDRESS(d)         IP_ADDRESS(192, 168, 1, (d))
+#define TEST_NET_MASK               0xFFFFFF00UL
+
+/* Priority of the IP threads, NX_IP_STACK_PRIORITY of app_netxduo.h. */
+#define TEST_NET_IP_PRIORITY        1
+
+typedef struct TEST_NET_HOST_STRUCT
+{
+  NX_IP          ip;
+  NX_PACKET_POOL pool;
+  ULONG64        ip_stack[2048 / sizeof(ULONG64)];
+  ULONG64        arp_cache[1024 / sizeof(ULONG64)];
+  ULONG64        pool_area[TEST_NET_PACKET_COUNT_MAX * (TEST_NET_PACKET_SIZE + sizeof(NX_PACKET) + 8) /
+                           sizeof(ULONG64)];
+  ULONG          packets_used_max;
+  struct TEST_NET_HOST_STRUCT* next;
+} TEST_NET_HOST;
+
+/* Create the pool of packet_count packets, and the IP instance on the host link
+   with ARP, ICMP, UDP and TCP enabled. The interface is up when it returns. */
+UINT test_net_host_create(TEST_NET_HOST* host_ptr, CHAR* name, ULONG address, UINT packet_count);
+
+/* Delete the IP instance and the pool. */
+UINT test_net_host_delete(TEST_NET_HOST* host_ptr);
+
+/* Packets of the pool in use. */
+ULONG test_net_packets_used(TEST_NET_HOST* host_ptr);
+
+/* Most packets of the pool in use at once since the host was created or the
+   last reset. Allocations are seen through -Wl,--wrap=_nx_packet_allocate. */
+ULONG test_net_packets_used_max(TEST_NET_HOST* host_ptr);
+VOID  test_net_packets_used_max_reset(TEST_NET_HOST* host_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_NET_H */
@@ -0,0 +1,179 @@
+/**
+  ******************************************************************************
+  * @file    test_ntp.c
+  * @brief   NTP responder of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The responder thread takes the requests from its UDP socket and answers the
+   client mode ones with the version of the request, the transmit timestamp of
+   the request as origin, and the receive and transmit timestamps of its
+   clock, the delay between them. */
+
+#include <string.h>
+
+#include "test_ntp.h"
+
+#define TEST_NTP_PRIORITY           4
+#define TEST_NTP_QUEUE              8
+#define TEST_NTP_STRATUM            2
+#define TEST_NTP_PRECISION          0xEC // 2^-20 s
+
+#define NTP_PACKET_SIZE             48
+#define NTP_MODE_CLIENT             3
+#define NTP_MODE_SERVER             4
+
+/* Seconds between the NTP epoch, 1900, and the Unix epoch. */
+#define NTP_UNIX_EPOCH              0x83AA7E80UL
+
+static VOID test_ntp_entry(ULONG input);
+
+UINT test_ntp_create(TEST_NTP* ntp_ptr, ULONG address, UINT packet_count)
+{
+  UINT status;
+
+  ntp_ptr->delay = 0;
+  ntp_ptr->silent = NX_FALSE;
+  ntp_ptr->requests = 0;
+  ntp_ptr->replies = 0;
+
+  if ((status = test_net_host_create(&ntp_ptr->host, "NTP", address, packet_count)))
+  {
+    return status;
+  }
+
+  if ((status = nx_udp_socket_create(&ntp_ptr->host.ip,
+           &ntp_ptr->socket,
+           "NTP",
+           NX_IP_NORMAL,
+           NX_FRAGMENT_OKAY,
+           NX_IP_TIME_TO_LIVE,
+           TEST_NTP_QUEUE)) ||
+      (status = nx_udp_socket_bind(&ntp_ptr->socket, TEST_NTP_PORT, NX_NO_WAIT)))
+  {
+    test_net_host_delete(&ntp_ptr->host);
+    return status;
+  }
+
+  return tx_thread_create(&ntp_ptr->thread,
+      "NTP",
+      test_ntp_entry,
+      (ULONG)ntp_ptr,
+      ntp_ptr->stack,
+      sizeof(ntp_ptr->stack),
+      TEST_NTP_PRIORITY,
+      TEST_NTP_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+UINT test_ntp_delete(TEST_NTP* ntp_ptr)
+{
+  tx_thread_terminate(&ntp_ptr->thread);
+  tx_thread_delete(&ntp_ptr->thread);
+
+  nx_udp_socket_unbind(&ntp_ptr->socket);
+  nx_udp_socket_delete(&ntp_ptr->socket);
+
+  return test_net_host_delete(&ntp_ptr->host);
+}
+
+VOID test_ntp_delay_set(TEST_NTP* ntp_ptr, ULONG ticks)
+{
+  ntp_ptr->delay = ticks;
+}
+
+VOID test_ntp_silent_set(TEST_NTP* ntp_ptr, UINT silent)
+{
+  ntp_ptr->silent = silent;
+}
+
+static VOID test_ntp_ulong_put(UCHAR* data, ULONG value)
+{
+  data[0] = (UCHAR)(value >> 24);
+  data[1] = (UCHAR)(value >> 16);
+  data[2] = (UCHAR)(value >> 8);
+  data[3] = (UCHAR)value;
+}
+
+/* The NTP timestamp of the server clock at ticks. */
+static VOID test_ntp_timestamp_put(UCHAR* data, ULONG ticks)
+{
+  test_ntp_ulong_put(data, TEST_NTP_UNIX_TIME + NTP_UNIX_EPOCH + ticks / TX_TIMER_TICKS_PER_SECOND);
+  test_ntp_ulong_put(&data[4],
+      (ULONG)(((ULONG64)(ticks % TX_TIMER_TICKS_PER_SECOND) << 32) / TX_TIMER_TICKS_PER_SECOND));
+}
+
+static VOID test_ntp_entry(ULONG input)
+{
+  TEST_NTP*  ntp_ptr = (TEST_NTP*)input;
+  NX_PACKET* packet_ptr;
+  NX_PACKET* reply_ptr;
+  UCHAR      message[NTP_PACKET_SIZE];
+  ULONG      length;
+  ULONG      address;
+  ULONG      receive_ticks;
+  UINT       port;
+
+  for (;;)
+  {
+    if (nx_udp_socket_receive(&ntp_ptr->socket, &packet_ptr, NX_WAIT_FOREVER))
+    {
+      continue;
+    }
+    receive_ticks = tx_time_get();
+
+    if ((packet_ptr->nx_packet_length != NTP_PACKET_SIZE) ||
+        nx_packet_data_retrieve(packet_ptr, message, &length) ||
+        nx_udp_source_extract(packet_ptr, &address, &port))
+    {
+      nx_packet_release(packet_ptr);
+      continue;
+    }
+    nx_packet_release(packet_ptr);
+
+    ntp_ptr->requests++;
+    if (ntp_ptr->silent || ((message[0] & 0x07) != NTP_MODE_CLIENT))
+    {
+      continue;
+    }
+
+    if (ntp_ptr->delay)
+    {
+      tx_thread_sleep(ntp_ptr->delay);
+    }
+
+    /* The origin is the transmit timestamp of the request. */
+    memcpy(&message[24], &message[40], 8);
+    message[0] = (UCHAR)((message[0] & 0x38) | NTP_MODE_SERVER);
+    message[1] = TEST_NTP_STRATUM;
+    message[3] = TEST_NTP_PRECISION;
+    memset(&message[4], 0, 8);
+    test_ntp_ulong_put(&message[12], ntp_ptr->host.ip.nx_ip_interface[0].nx_interface_ip_address);
+    test_ntp_timestamp_put(&message[16], receive_ticks - receive_ticks % TX_TIMER_TICKS_PER_SECOND);
+    test_ntp_timestamp_put(&message[32], receive_ticks);
+    test_ntp_timestamp_put(&message[40], tx_time_get());
+
+    if (nx_packet_allocate(&ntp_ptr->host.pool, &reply_ptr, NX_UDP_PACKET, NX_WAIT_FOREVER))
+    {
+      continue;
+    }
+    if (nx_packet_data_append(reply_ptr, message, NTP_PACKET_SIZE, &ntp_ptr->host.pool, NX_WAIT_FOREVER) ||
+        nx_udp_socket_send(&ntp_ptr->socket, reply_ptr, address, port))
+    {
+      nx_packet_release(reply_ptr);
+      continue;
+    }
+    ntp_ptr->replies++;
+  }
+}
@@ -0,0 +1,65 @@
+/**
+  ******************************************************************************
+  * @file    test_ntp.h
+  * @brief   NTP responder of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_NTP_H
+#define TEST_NTP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "test_net.h"
+
+#define TEST_NTP_PORT               123
+
+/* Unix time of the servers at tick 0, Tuesday, Nov 14, 2023 22:13:20 GMT. */
+#define TEST_NTP_UNIX_TIME          1700000000UL
+
+/* The responder answers each client request with a stratum 2 server reply,
+   one request at a time, after delay ticks. Its clock is TEST_NTP_UNIX_TIME
+   plus the virtual time. A silent responder counts the requests and drops
+   them, as a server that is down or filtered. */
+typedef struct TEST_NTP_STRUCT
+{
+  TEST_NET_HOST host;
+  NX_UDP_SOCKET socket;
+  TX_THREAD     thread;
+  ULONG64       stack[4096 / sizeof(ULONG64)];
+  ULONG         delay;
+  UINT          silent;
+  ULONG         requests;
+  ULONG         replies;
+} TEST_NTP;
+
+/* Create the responder host at address with a pool of packet_count packets,
+   and start answering on TEST_NTP_PORT. */
+UINT test_ntp_create(TEST_NTP* ntp_ptr, ULONG address, UINT packet_count);
+
+/* Stop the responder and delete its host. */
+UINT test_ntp_delete(TEST_NTP* ntp_ptr);
+
+/* Hold each reply back for ticks, the time of the server. */
+VOID test_ntp_delay_set(TEST_NTP* ntp_ptr, ULONG ticks);
+
+/* Drop the requests instead of answering them. */
+VOID test_ntp_silent_set(TEST_NTP* ntp_ptr, UINT silent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_NTP_H */
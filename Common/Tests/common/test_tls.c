@@ -0,0 +1,245 @@
+/**
+  ******************************************************************************
+  * @file    test_tls.c
+  * @brief   Certificates and TLS client setup of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include "test_tls.h"
+
+#include "nx_azure_iot.h"
+#include "nx_azure_iot_ciphersuites.h"
+
+/* P-256 test authority, CN=test-ca, and the certificate it issued to the test
+   broker, CN=test-broker, with the broker key in SEC1 DER. NX Secure refuses a
+   self-signed server certificate, so the client trusts the authority. The
+   validity ends before 2050: NX Secure only reads UTCTime dates, which the Azure
+   IoT client checks against the time of the host. Made with:
+     openssl ecparam -name prime256v1 -genkey -noout -outform DER -out ca_key.der
+     openssl req -new -x509 -key ca_key.der -keyform DER -subj "/CN=test-ca" -days 7300 -sha256
+       -addext "basicConstraints=critical,CA:TRUE" -addext "keyUsage=critical,keyCertSign" -outform DER -out ca.der
+     openssl ecparam -name prime256v1 -genkey -noout -outform DER -out key.der
+     openssl req -new -key key.der -keyform DER -subj "/CN=test-broker" -out broker.csr
+     openssl x509 -req -in broker.csr -CA ca.der -CAform DER -CAkey ca_key.der -CAkeyform DER -set_serial 2
+       -days 7300 -sha256 -outform DER -out cert.der */
+
+const UCHAR test_tls_ca_cert[] = {
+  0x30, 0x82, 0x01, 0x89, 0x30, 0x82, 0x01, 0x2f, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x14, 0x21,
+  0x62, 0x2c, 0xf4, 0x8f, 0xea, 0x71, 0x99, 0x1c, 0x8f, 0x0c, 0x89, 0x3a, 0xf0, 0x3e, 0x99, 0xa6,
+  0x40, 0x81, 0x69, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30,
+  0x12, 0x31, 0x10, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x07, 0x74, 0x65, 0x73, 0x74,
+  0x2d, 0x63, 0x61, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x32, 0x30, 0x33,
+  0x31, 0x32, 0x36, 0x5a, 0x17, 0x0d, 0x34, 0x36, 0x31, 0x30, 0x31, 0x32, 0x32, 0x30, 0x33, 0x31,
+  0x32, 0x36, 0x5a, 0x30, 0x12, 0x31, 0x10, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x07,
+  0x74, 0x65, 0x73, 0x74, 0x2d, 0x63, 0x61, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48,
+  0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42,
+  0x00, 0x04, 0x29, 0x59, 0xe5, 0x7a, 0x2f, 0xdc, 0x06, 0x8d, 0xe1, 0x0f, 0x3e, 0x01, 0x34, 0x31,
+  0xaf, 0xdb, 0x5c, 0xb1, 0xc3, 0xbb, 0x98, 0x86, 0x61, 0x27, 0x87, 0x19, 0xf1, 0xa4, 0x1f, 0x1c,
+  0xb7, 0x3e, 0x22, 0x75, 0x88, 0x63, 0x02, 0x3b, 0x23, 0x0c, 0x27, 0xb9, 0xff, 0x6e, 0x2e, 0xd7,
+  0x94, 0x44, 0x2f, 0xde, 0xfb, 0x1a, 0xa3, 0x75, 0xb8, 0x23, 0xf2, 0x6b, 0x1d, 0x59, 0xea, 0x09,
+  0x42, 0x94, 0xa3, 0x63, 0x30, 0x61, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04,
+  0x14, 0x9d, 0xba, 0x3a, 0x6a, 0xd5, 0xa2, 0xfa, 0x4b, 0x6c, 0x51, 0x9c, 0xce, 0xbd, 0xd0, 0x3d,
+  0xd7, 0x6e, 0xe8, 0xc5, 0x54, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16,
+  0x80, 0x14, 0x9d, 0xba, 0x3a, 0x6a, 0xd5, 0xa2, 0xfa, 0x4b, 0x6c, 0x51, 0x9c, 0xce, 0xbd, 0xd0,
+  0x3d, 0xd7, 0x6e, 0xe8, 0xc5, 0x54, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff,
+  0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01,
+  0xff, 0x04, 0x04, 0x03, 0x02, 0x02, 0x04, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+  0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x20, 0x48, 0x09, 0x60, 0x3e, 0xb3, 0x65,
+  0xd0, 0x54, 0x38, 0xd0, 0x08, 0xc2, 0x45, 0x83, 0xf1, 0xac, 0x06, 0x91, 0x2e, 0xf4, 0x8b, 0xd4,
+  0x61, 0x18, 0x82, 0x8a, 0x72, 0xfc, 0x74, 0x3b, 0x0c, 0x6a, 0x02, 0x21, 0x00, 0x9b, 0xf0, 0xdb,
+  0x33, 0x09, 0xc9, 0x48, 0xbc, 0xf4, 0x7d, 0xba, 0x8b, 0xa1, 0x60, 0x09, 0x31, 0x58, 0xa1, 0x2b,
+  0x77, 0xfe, 0x2c, 0xb0, 0xcc, 0x39, 0x07, 0xc2, 0x1c, 0x95, 0xcb, 0x48, 0xed,
+};
+
+const UINT test_tls_ca_cert_size = sizeof(test_tls_ca_cert);
+
+const UCHAR test_tls_broker_cert[] = {
+  0x30, 0x82, 0x01, 0x0f, 0x30, 0x81, 0xb6, 0x02, 0x01, 0x02, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86,
+  0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x12, 0x31, 0x10, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x04,
+  0x03, 0x0c, 0x07, 0x74, 0x65, 0x73, 0x74, 0x2d, 0x63, 0x61, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x36,
+  0x31, 0x30, 0x31, 0x37, 0x32, 0x30, 0x33, 0x31, 0x32, 0x36, 0x5a, 0x17, 0x0d, 0x34, 0x36, 0x31,
+  0x30, 0x31, 0x32, 0x32, 0x30, 0x33, 0x31, 0x32, 0x36, 0x5a, 0x30, 0x16, 0x31, 0x14, 0x30, 0x12,
+  0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0b, 0x74, 0x65, 0x73, 0x74, 0x2d, 0x62, 0x72, 0x6f, 0x6b,
+  0x65, 0x72, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06,
+  0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x46, 0xcf, 0x68,
+  0xbf, 0x75, 0x05, 0x3a, 0xdb, 0xf0, 0xc4, 0xf5, 0x8d, 0x06, 0xa4, 0x5f, 0xf5, 0xdb, 0x65, 0xf0,
+  0xa0, 0xc2, 0x03, 0x78, 0x4d, 0x65, 0x4e, 0x4d, 0x8b, 0xaf, 0xa5, 0x92, 0x5c, 0x86, 0xc4, 0x38,
+  0x28, 0x84, 0x9d, 0x1a, 0x8c, 0x07, 0x23, 0x07, 0xfa, 0x4e, 0x08, 0x6c, 0xe1, 0xde, 0xb5, 0xe8,
+  0x00, 0x6b, 0x1b, 0x31, 0x19, 0xbd, 0xbb, 0x2b, 0x94, 0x73, 0x16, 0x14, 0xfa, 0x30, 0x0a, 0x06,
+  0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x21,
+  0x00, 0xf1, 0x09, 0xaa, 0xc8, 0x82, 0x87, 0x08, 0xfe, 0x64, 0x4c, 0x36, 0xb6, 0xbc, 0xf6, 0x52,
+  0x72, 0xa1, 0x2c, 0x71, 0x7a, 0x86, 0x72, 0xf8, 0x6c, 0x47, 0xe0, 0x95, 0x5d, 0xa2, 0x78, 0x39,
+  0xb6, 0x02, 0x20, 0x16, 0x8c, 0x4d, 0x90, 0x15, 0x21, 0xec, 0xc7, 0x70, 0x1d, 0xc1, 0x06, 0xdf,
+  0x79, 0x0b, 0x30, 0x45, 0x20, 0x4f, 0x82, 0xc4, 0xc7, 0xbb, 0x30, 0x76, 0xae, 0xdd, 0x82, 0x4a,
+  0x40, 0x31, 0xbe,
+};
+
+const UINT test_tls_broker_cert_size = sizeof(test_tls_broker_cert);
+
+const UCHAR test_tls_broker_key[] = {
+  0x30, 0x77, 0x02, 0x01, 0x01, 0x04, 0x20, 0xc5, 0x75, 0x27, 0x98, 0x68, 0x78, 0x3f, 0x43, 0xfe,
+  0x6a, 0xb3, 0x3e, 0xdb, 0x78, 0x69, 0x01, 0x20, 0x14, 0x83, 0x8b, 0xa8, 0xcd, 0xf4, 0x4c, 0x32,
+  0xa1, 0xd3, 0xc0, 0xd2, 0xb0, 0x74, 0x3f, 0xa0, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+  0x03, 0x01, 0x07, 0xa1, 0x44, 0x03, 0x42, 0x00, 0x04, 0x46, 0xcf, 0x68, 0xbf, 0x75, 0x05, 0x3a,
+  0xdb, 0xf0, 0xc4, 0xf5, 0x8d, 0x06, 0xa4, 0x5f, 0xf5, 0xdb, 0x65, 0xf0, 0xa0, 0xc2, 0x03, 0x78,
+  0x4d, 0x65, 0x4e, 0x4d, 0x8b, 0xaf, 0xa5, 0x92, 0x5c, 0x86, 0xc4, 0x38, 0x28, 0x84, 0x9d, 0x1a,
+  0x8c, 0x07, 0x23, 0x07, 0xfa, 0x4e, 0x08, 0x6c, 0xe1, 0xde, 0xb5, 0xe8, 0x00, 0x6b, 0x1b, 0x31,
+  0x19, 0xbd, 0xbb, 0x2b, 0x94, 0x73, 0x16, 0x14, 0xfa,
+};
+
+const UINT test_tls_broker_key_size = sizeof(test_tls_broker_key);
+
+/* A second authority, CN=test-chain-ca, with an intermediate, CN=test-intermediate,
+   which issued a certificate to the test broker, as the IoT Hub and DPS present
+   theirs. Made as above, the intermediate with:
+     openssl x509 -req -in intermediate.csr -CA ca.der -CAform DER -CAkey ca_key.der -CAkeyform DER -set_serial 3
+       -days 7300 -sha256 -extfile ca.ext -outform DER -out intermediate.der
+   ca.ext holding the basicConstraints and keyUsage of the authority, and the
+   broker certificate issued by the intermediate with -set_serial 4. */
+
+const UCHAR test_tls_chain_ca_cert[] = {
+  0x30, 0x82, 0x01, 0x95, 0x30, 0x82, 0x01, 0x3b, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x14, 0x42,
+  0xfd, 0xb3, 0x40, 0x09, 0x92, 0x07, 0x58, 0xc2, 0xb5, 0x1d, 0x23, 0x77, 0x70, 0x22, 0x7f, 0x05,
+  0x59, 0x5f, 0x29, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30,
+  0x18, 0x31, 0x16, 0x30, 0x14, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0d, 0x74, 0x65, 0x73, 0x74,
+  0x2d, 0x63, 0x68, 0x61, 0x69, 0x6e, 0x2d, 0x63, 0x61, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31,
+  0x30, 0x31, 0x37, 0x32, 0x31, 0x31, 0x33, 0x30, 0x38, 0x5a, 0x17, 0x0d, 0x34, 0x36, 0x31, 0x30,
+  0x31, 0x32, 0x32, 0x31, 0x31, 0x33, 0x30, 0x38, 0x5a, 0x30, 0x18, 0x31, 0x16, 0x30, 0x14, 0x06,
+  0x03, 0x55, 0x04, 0x03, 0x0c, 0x0d, 0x74, 0x65, 0x73, 0x74, 0x2d, 0x63, 0x68, 0x61, 0x69, 0x6e,
+  0x2d, 0x63, 0x61, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01,
+  0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x06, 0x2d,
+  0xd1, 0xcf, 0xa6, 0x63, 0xb2, 0xc5, 0x1a, 0x91, 0x78, 0xdd, 0xbd, 0x61, 0xe9, 0x0a, 0xd5, 0xc1,
+  0x05, 0xf3, 0x8d, 0xb8, 0x1b, 0xba, 0xb1, 0xb3, 0x6b, 0xf8, 0x8c, 0x53, 0xc8, 0xe1, 0x8e, 0x0d,
+  0x35, 0xc7, 0x23, 0x1e, 0xab, 0x36, 0x39, 0x96, 0xf3, 0xaf, 0x85, 0xa4, 0x1d, 0x4d, 0x94, 0xae,
+  0x16, 0xcc, 0x78, 0x9e, 0x0e, 0xf3, 0x4c, 0xa3, 0xf7, 0x62, 0x78, 0xec, 0x2f, 0xfd, 0xa3, 0x63,
+  0x30, 0x61, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x95, 0xb0, 0x38,
+  0x4e, 0xf7, 0x26, 0x4a, 0x9b, 0xd4, 0xe9, 0x64, 0x6f, 0x42, 0xa5, 0x2c, 0x67, 0xaa, 0x7f, 0x69,
+  0xc4, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x95, 0xb0,
+  0x38, 0x4e, 0xf7, 0x26, 0x4a, 0x9b, 0xd4, 0xe9, 0x64, 0x6f, 0x42, 0xa5, 0x2c, 0x67, 0xaa, 0x7f,
+  0x69, 0xc4, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03,
+  0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03,
+  0x02, 0x02, 0x04, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03,
+  0x48, 0x00, 0x30, 0x45, 0x02, 0x21, 0x00, 0xb8, 0x00, 0xd3, 0xfb, 0x2f, 0x31, 0x47, 0x83, 0x6f,
+  0x81, 0x81, 0xb6, 0x4a, 0x53, 0xd4, 0x28, 0xf8, 0x82, 0x25, 0x85, 0xf3, 0xa8, 0x7f, 0x65, 0xb6,
+  0xff, 0x8c, 0x21, 0x43, 0xe5, 0x13, 0x29, 0x02, 0x20, 0x64, 0x07, 0x57, 0x39, 0xcd, 0xd5, 0xf6,
+  0x4a, 0xf2, 0x9c, 0xc4, 0xb1, 0x9b, 0xaf, 0x3c, 0xef, 0x82, 0x78, 0x98, 0xc5, 0x15, 0xbb, 0x3a,
+  0x3d, 0x7b, 0x88, 0x6b, 0x44, 0x40, 0xc3, 0x0a, 0x28,
+};
+
+const UINT test_tls_chain_ca_cert_size = sizeof(test_tls_chain_ca_cert);
+
+const UCHAR test_tls_chain_intermediate_cert[] = {
+  0x30, 0x82, 0x01, 0x87, 0x30, 0x82, 0x01, 0x2c, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x03,
+  0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x18, 0x31, 0x16,
+  0x30, 0x14, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0d, 0x74, 0x65, 0x73, 0x74, 0x2d, 0x63, 0x68,
+  0x61, 0x69, 0x6e, 0x2d, 0x63, 0x61, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37,
+  0x32, 0x31, 0x31, 0x33, 0x30, 0x38, 0x5a, 0x17, 0x0d, 0x34, 0x36, 0x31, 0x30, 0x31, 0x32, 0x32,
+  0x31, 0x31, 0x33, 0x30, 0x38, 0x5a, 0x30, 0x1c, 0x31, 0x1a, 0x30, 0x18, 0x06, 0x03, 0x55, 0x04,
+  0x03, 0x0c, 0x11, 0x74, 0x65, 0x73, 0x74, 0x2d, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64,
+  0x69, 0x61, 0x74, 0x65, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02,
+  0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x4c,
+  0xdf, 0x46, 0xf7, 0x91, 0x61, 0x73, 0x71, 0x82, 0xfe, 0xe6, 0x63, 0x11, 0xc3, 0xb6, 0x09, 0x75,
+  0x4b, 0xe6, 0xbb, 0xf6, 0x0a, 0xa2, 0x2e, 0xa1, 0x86, 0x8c, 0x70, 0x29, 0x86, 0x96, 0x87, 0x77,
+  0xce, 0xb5, 0xf6, 0xdc, 0xe6, 0xf6, 0x15, 0xe7, 0x55, 0xc0, 0xaf, 0x97, 0xdd, 0x37, 0x11, 0x08,
+  0x2d, 0x6e, 0xa6, 0x61, 0x4d, 0x26, 0x80, 0xfd, 0xec, 0xe4, 0xae, 0x5c, 0x95, 0xc0, 0x02, 0xa3,
+  0x63, 0x30, 0x61, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30,
+  0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04,
+  0x03, 0x02, 0x02, 0x04, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x70,
+  0x76, 0x22, 0x53, 0x9b, 0x61, 0x86, 0xfe, 0x34, 0xee, 0x90, 0x4c, 0x40, 0x0a, 0x93, 0x0b, 0x91,
+  0xbc, 0x32, 0xb6, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14,
+  0x95, 0xb0, 0x38, 0x4e, 0xf7, 0x26, 0x4a, 0x9b, 0xd4, 0xe9, 0x64, 0x6f, 0x42, 0xa5, 0x2c, 0x67,
+  0xaa, 0x7f, 0x69, 0xc4, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02,
+  0x03, 0x49, 0x00, 0x30, 0x46, 0x02, 0x21, 0x00, 0xb1, 0x80, 0x4d, 0x7d, 0x46, 0xd3, 0x30, 0x92,
+  0xbe, 0xc3, 0x05, 0xb3, 0xad, 0xfa, 0x6b, 0x14, 0x1c, 0x37, 0xc0, 0x86, 0xb5, 0x1d, 0x10, 0x1d,
+  0xd1, 0x72, 0x64, 0xb2, 0xde, 0xe5, 0xe1, 0x11, 0x02, 0x21, 0x00, 0x86, 0x9d, 0x81, 0x90, 0xd8,
+  0x08, 0xce, 0x13, 0x0d, 0xbf, 0xfe, 0x91, 0x54, 0x1e, 0xfe, 0xa1, 0xda, 0x27, 0x9c, 0x7f, 0xd7,
+  0xc4, 0xc6, 0x61, 0xee, 0xb7, 0x9f, 0xee, 0xa2, 0xd5, 0x7b, 0xf7,
+};
+
+const UINT test_tls_chain_intermediate_cert_size = sizeof(test_tls_chain_intermediate_cert);
+
+const UCHAR test_tls_chain_broker_cert[] = {
+  0x30, 0x82, 0x01, 0x19, 0x30, 0x81, 0xc0, 0x02, 0x01, 0x04, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86,
+  0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x1c, 0x31, 0x1a, 0x30, 0x18, 0x06, 0x03, 0x55, 0x04,
+  0x03, 0x0c, 0x11, 0x74, 0x65, 0x73, 0x74, 0x2d, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6d, 0x65, 0x64,
+  0x69, 0x61, 0x74, 0x65, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x37, 0x32, 0x31,
+  0x31, 0x33, 0x30, 0x38, 0x5a, 0x17, 0x0d, 0x34, 0x36, 0x31, 0x30, 0x31, 0x32, 0x32, 0x31, 0x31,
+  0x33, 0x30, 0x38, 0x5a, 0x30, 0x16, 0x31, 0x14, 0x30, 0x12, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c,
+  0x0b, 0x74, 0x65, 0x73, 0x74, 0x2d, 0x62, 0x72, 0x6f, 0x6b, 0x65, 0x72, 0x30, 0x59, 0x30, 0x13,
+  0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+  0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x33, 0xbe, 0xb1, 0xba, 0xbb, 0x56, 0xe4, 0xc7, 0xcc,
+  0x9a, 0xd0, 0xf9, 0x13, 0xac, 0x99, 0x3e, 0x57, 0x02, 0x5b, 0xa8, 0x81, 0x44, 0xbe, 0x64, 0x81,
+  0x61, 0xbb, 0xad, 0x70, 0xbd, 0xa1, 0xf3, 0xff, 0x0e, 0x4d, 0xbc, 0xfc, 0xd6, 0x4f, 0xab, 0xb4,
+  0x7a, 0x2e, 0x3a, 0xaf, 0xe6, 0xd3, 0xca, 0x70, 0x51, 0x92, 0xd8, 0x7f, 0x86, 0x90, 0xac, 0x4b,
+  0xcd, 0xac, 0xfc, 0xe7, 0xe5, 0x05, 0x94, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+  0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x21, 0x00, 0xe0, 0x53, 0x83, 0x8d, 0x7a,
+  0x51, 0xf5, 0x6c, 0xc4, 0x86, 0x78, 0x67, 0x1f, 0x6c, 0x56, 0x50, 0x29, 0x6f, 0x37, 0x62, 0x4f,
+  0xd1, 0xd6, 0x80, 0x54, 0xc6, 0x34, 0xbc, 0xee, 0x9c, 0x0c, 0xc4, 0x02, 0x20, 0x2a, 0xd4, 0x3a,
+  0xf1, 0xb8, 0x3a, 0x2f, 0x32, 0xb5, 0xea, 0x6b, 0x22, 0x0e, 0x2e, 0x0d, 0xd7, 0xa4, 0x82, 0xd7,
+  0xb4, 0x12, 0x7d, 0x2b, 0x18, 0x1d, 0x2f, 0x23, 0x8b, 0x9a, 0x90, 0x0c, 0x26,
+};
+
+const UINT test_tls_chain_broker_cert_size = sizeof(test_tls_chain_broker_cert);
+
+const UCHAR test_tls_chain_broker_key[] = {
+  0x30, 0x77, 0x02, 0x01, 0x01, 0x04, 0x20, 0x21, 0x93, 0xd8, 0xb9, 0x8a, 0x4d, 0x72, 0x37, 0x22,
+  0xf0, 0x76, 0x07, 0xdf, 0xfc, 0x98, 0xa7, 0xe0, 0x59, 0xaf, 0x18, 0x0d, 0x70, 0x2f, 0xcb, 0xb6,
+  0xb0, 0xd4, 0xe7, 0xe5, 0x3e, 0x6e, 0x3a, 0xa0, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+  0x03, 0x01, 0x07, 0xa1, 0x44, 0x03, 0x42, 0x00, 0x04, 0x33, 0xbe, 0xb1, 0xba, 0xbb, 0x56, 0xe4,
+  0xc7, 0xcc, 0x9a, 0xd0, 0xf9, 0x13, 0xac, 0x99, 0x3e, 0x57, 0x02, 0x5b, 0xa8, 0x81, 0x44, 0xbe,
+  0x64, 0x81, 0x61, 0xbb, 0xad, 0x70, 0xbd, 0xa1, 0xf3, 0xff, 0x0e, 0x4d, 0xbc, 0xfc, 0xd6, 0x4f,
+  0xab, 0xb4, 0x7a, 0x2e, 0x3a, 0xaf, 0xe6, 0xd3, 0xca, 0x70, 0x51, 0x92, 0xd8, 0x7f, 0x86, 0x90,
+  0xac, 0x4b, 0xcd, 0xac, 0xfc, 0xe7, 0xe5, 0x05, 0x94,
+};
+
+const UINT test_tls_chain_broker_key_size = sizeof(test_tls_chain_broker_key);
+
+static ULONG test_tls_metadata[NX_AZURE_IOT_TLS_METADATA_BUFFER_SIZE / sizeof(ULONG)];
+static UCHAR test_tls_packet_buffer[NX_AZURE_IOT_TLS_PACKET_BUFFER_SIZE];
+
+UINT test_tls_client_setup(NXD_MQTT_CLIENT* client_ptr,
+    NX_SECURE_TLS_SESSION* tls_session,
+    NX_SECURE_X509_CERT* certificate,
+    NX_SECURE_X509_CERT* trusted_certificate)
+{
+  UINT status;
+
+  NX_PARAMETER_NOT_USED(client_ptr);
+  NX_PARAMETER_NOT_USED(certificate);
+
+  if ((status = _nx_secure_tls_session_create_ext(tls_session,
+           _nx_azure_iot_tls_supported_crypto,
+           _nx_azure_iot_tls_supported_crypto_size,
+           _nx_azure_iot_tls_ciphersuite_map,
+           _nx_azure_iot_tls_ciphersuite_map_size,
+           (UCHAR*)test_tls_metadata,
+           sizeof(test_tls_metadata))))
+  {
+    return status;
+  }
+
+  if ((status = nx_secure_x509_certificate_initialize(trusted_certificate,
+           (UCHAR*)test_tls_ca_cert,
+           (USHORT)test_tls_ca_cert_size,
+           NX_NULL,
+           0,
+           NX_NULL,
+           0,
+           NX_SECURE_X509_KEY_TYPE_NONE)) ||
+      (status = nx_secure_tls_trusted_certificate_add(tls_session, trusted_certificate)))
+  {
+    return status;
+  }
+
+  return nx_secure_tls_session_packet_buffer_set(tls_session, test_tls_packet_buffer, sizeof(test_tls_packet_buffer));
+}
@@ -0,0 +1,59 @@
+/**
+  ******************************************************************************
+  * @file    test_tls.h
+  * @brief   Certificates and TLS client setup of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_TLS_H
+#define TEST_TLS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "nxd_mqtt_client.h"
+
+/* Certificate of the test authority, in DER. */
+extern const UCHAR test_tls_ca_cert[];
+extern const UINT  test_tls_ca_cert_size;
+
+/* Certificate and private key of the test broker, issued by the test authority. */
+extern const UCHAR test_tls_broker_cert[];
+extern const UINT  test_tls_broker_cert_size;
+extern const UCHAR test_tls_broker_key[];
+extern const UINT  test_tls_broker_key_size;
+
+/* Authority, intermediate authority, and the broker certificate and key it issued. */
+extern const UCHAR test_tls_chain_ca_cert[];
+extern const UINT  test_tls_chain_ca_cert_size;
+extern const UCHAR test_tls_chain_intermediate_cert[];
+extern const UINT  test_tls_chain_intermediate_cert_size;
+extern const UCHAR test_tls_chain_broker_cert[];
+extern const UINT  test_tls_chain_broker_cert_size;
+extern const UCHAR test_tls_chain_broker_key[];
+extern const UINT  test_tls_chain_broker_key_size;
+
+/* TLS setup callback of nxd_mqtt_client_secure_connect. The session uses the
+   crypto methods and ciphersuites of the boards, nx_azure_iot_ciphersuites.c,
+   and trusts the test authority. */
+UINT test_tls_client_setup(NXD_MQTT_CLIENT* client_ptr,
+    NX_SECURE_TLS_SESSION* tls_session,
+    NX_SECURE_X509_CERT* certificate,
+    NX_SECURE_X509_CERT* trusted_certificate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_TLS_H */
@@ -0,0 +1,28 @@
+/**
+  ******************************************************************************
+  * @file    nx_user.h
+  * @brief   Board NetX configuration with the copying TLS record decryption
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_COPY_DECRYPT_NX_USER_H
+#define TEST_COPY_DECRYPT_NX_USER_H
+
+/* The files built with this directory first in the include path see the board
+   configuration without the in-place decryption, for the variants of the tests
+   that compare both receive paths. */
+#include_next "nx_user.h"
+
+#undef NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT
+
+#endif /* TEST_COPY_DECRYPT_NX_USER_H */
@@ -0,0 +1,33 @@
+/**
+  ******************************************************************************
+  * @file    nx_user.h
+  * @brief   Board NetX configuration with TCP receivers acting as the IoT Hub
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_HUB_TCP_NX_USER_H
+#define TEST_HUB_TCP_NX_USER_H
+
+/* The files built with this directory first in the include path see the board
+   configuration with TCP receivers acting as the TCP of the IoT Hub: every
+   second segment is acknowledged, and out of order segments are all kept. The
+   board leaves NX_TCP_ACK_EVERY_N_PACKETS undefined, a NetX receiver then only
+   acknowledges on its delayed ACK timer and paces a NetX sender to one
+   congestion window per 200 ms. It keeps 8 out of order segments, the sender
+   then waits for a retransmit timeout for each segment dropped above them. */
+#include_next "nx_user.h"
+
+#define NX_TCP_ACK_EVERY_N_PACKETS  2
+#undef NX_TCP_MAX_OUT_OF_ORDER_PACKETS
+
+#endif /* TEST_HUB_TCP_NX_USER_H */
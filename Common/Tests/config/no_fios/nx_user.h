@@ -0,0 +1,28 @@
+/**
+  ******************************************************************************
+  * @file    nx_user.h
+  * @brief   Board NetX configuration with the separated Montgomery loops
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_NO_FIOS_NX_USER_H
+#define TEST_NO_FIOS_NX_USER_H
+
+/* The files built with this directory first in the include path multiply and
+   reduce in separate passes, and square with the generic multiplication, for
+   the variant of the huge number test. */
+#include_next "nx_user.h"
+
+#define NX_CRYPTO_HUGE_NUMBER_DISABLE_FIOS
+
+#endif /* TEST_NO_FIOS_NX_USER_H */
@@ -0,0 +1,32 @@
+/**
+  ******************************************************************************
+  * @file    nx_user.h
+  * @brief   Board NetX configuration with the NetX TCP without selective acknowledgment
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_NO_SACK_NX_USER_H
+#define TEST_NO_SACK_NX_USER_H
+
+/* The files built with this directory first in the include path see the board
+   configuration without SACK and early retransmit, the NewReno recovery the
+   TCP tests compare with. NX_ENABLE_TCP_SACK changes NX_TCP_SOCKET, so every
+   file including nx_api.h is built again. The TCP receivers act as the
+   IoT Hub, as with config/hub_tcp. */
+#include_next "nx_user.h"
+
+#undef NX_ENABLE_TCP_SACK
+#define NX_TCP_ACK_EVERY_N_PACKETS  2
+#undef NX_TCP_MAX_OUT_OF_ORDER_PACKETS
+
+#endif /* TEST_NO_SACK_NX_USER_H */
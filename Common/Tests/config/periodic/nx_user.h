@@ -0,0 +1,30 @@
+/**
+  ******************************************************************************
+  * @file    nx_user.h
+  * @brief   Board NetX configuration with the periodic fast TCP timer
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_PERIODIC_NX_USER_H
+#define TEST_PERIODIC_NX_USER_H
+
+/* The files built with this directory first in the include path see the board
+   configuration with the stock fast TCP timer, waking the IP thread every
+   fast period, that NX_TCP_FAST_TIMER_ON_DEMAND is compared with. The option
+   changes NX_IP and NX_TCP_SOCKET, so every file including nx_api.h is built
+   again. */
+#include_next "nx_user.h"
+
+#undef NX_TCP_FAST_TIMER_ON_DEMAND
+
+#endif /* TEST_PERIODIC_NX_USER_H */
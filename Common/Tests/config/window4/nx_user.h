@@ -0,0 +1,29 @@
+/**
+  ******************************************************************************
+  * @file    nx_user.h
+  * @brief   Board NetX configuration with a sliding window of 4 bits
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TEST_WINDOW4_NX_USER_H
+#define TEST_WINDOW4_NX_USER_H
+
+/* The files built with this directory first in the include path exponentiate
+   with a window of 4 bits and its table of odd powers in the scratch, for the
+   variant of the huge number test. */
+#include_next "nx_user.h"
+
+#undef NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS
+#define NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS 4
+
+#endif /* TEST_WINDOW4_NX_USER_H */
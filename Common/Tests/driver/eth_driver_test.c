@@ -0,0 +1,458 @@
+/**
+  ******************************************************************************
+  * @file    eth_driver_test.c
+  * @brief   STM32 Ethernet driver of the F746 on a fake DMA
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* nx_stm32_eth_driver.c with the nx_stm32_eth_config.h of the 32F746GDISCOVERY,
+   legacy HAL, 4 descriptors each way and one interrupt per two frames, on the
+   fake DMA of common/test_eth.c. The test includes the driver to read its
+   descriptors. UDP datagrams numbered in their first word go both ways
+   between the device and a peer with a static ARP entry.
+
+   Receive: the frames of descriptors without interrupt are signaled by the
+   watchdog, two frames take one interrupt. With the IP thread held back,
+   four frames fill the ring and the next one is missed; the deferred
+   processing then empties the four descriptors and refills them in one pass.
+   With the pool empty the frames are dropped and their packets posted again,
+   with one packet left the oldest frame is dropped for the newest. The ring
+   must stay full throughout and no packet may leak. The D-cache lines
+   invalidated for a frame must cover the frame, not its whole buffer.
+
+   Transmit: a frame sent without interrupt is released by the reclaim
+   timer on an idle link, which then stops; two frames take one interrupt.
+   The lines cleaned must cover the frame only.
+
+   Last, the benchmark receives and sends BENCH_FRAMES datagrams and reports the
+   packets per second and cycles per packet, counted on the simulated cycle
+   counter at the 160 MHz of the host port: host time, fake DMA copies
+   included. */
+
+#include "nx_stm32_eth_driver.c"
+
+#include "stm32u5xx.h"
+#include "test_common.h"
+#include "test_eth.h"
+
+#define TEST_PRIORITY       4
+#define IP_PRIORITY         1
+
+/* NX_PACKET_SIZE and NX_PACKET_COUNT of the app_netxduo.h of the board. */
+#define PACKET_SIZE         1536
+#define PACKET_COUNT        32
+
+#define DEVICE_ADDRESS      IP_ADDRESS(192, 168, 1, 2)
+#define PEER_ADDRESS        IP_ADDRESS(192, 168, 1, 1)
+#define PEER_MAC_MSW        0x0200
+#define PEER_MAC_LSW        0x00000001
+#define DEVICE_PORT         5000
+#define PEER_PORT           6000
+
+#define PAYLOAD_SIZE        64
+#define FRAME_HEADERS       (14 + 20 + 8)
+#define CACHE_LINE          32
+
+#define BENCH_FRAMES        20000
+
+static TX_THREAD      test_thread;
+static ULONG64        test_stack[8192 / sizeof(ULONG64)];
+static NX_IP          ip;
+static NX_PACKET_POOL pool;
+static NX_UDP_SOCKET  udp_socket;
+static ULONG64        ip_stack[2048 / sizeof(ULONG64)];
+static ULONG64        arp_cache[512 / sizeof(ULONG64)];
+static ULONG64        pool_area[PACKET_COUNT * (PACKET_SIZE + sizeof(NX_PACKET) + NX_PACKET_ALIGNMENT) / sizeof(ULONG64)];
+static NX_PACKET*     held[PACKET_COUNT];
+
+static ULONG rx_sequence;
+static ULONG tx_sequence;
+static ULONG sink_sequence;
+static ULONG sink_frames;
+
+static ULONG word_get(const UCHAR* data)
+{
+  return ((ULONG)data[0] << 24) | ((ULONG)data[1] << 16) | ((ULONG)data[2] << 8) | data[3];
+}
+
+static VOID word_put(UCHAR* data, ULONG value)
+{
+  data[0] = (UCHAR)(value >> 24);
+  data[1] = (UCHAR)(value >> 16);
+  data[2] = (UCHAR)(value >> 8);
+  data[3] = (UCHAR)value;
+}
+
+/* A datagram of the peer, numbered sequence. */
+static ULONG frame_build(UCHAR* frame, ULONG sequence)
+{
+  static const UCHAR device_mac[6] = TEST_ETH_MAC;
+  UCHAR*             ip_header     = frame + 14;
+  UCHAR*             udp_header    = ip_header + 20;
+  ULONG              checksum      = 0;
+  UINT               i;
+
+  memset(frame, 0, FRAME_HEADERS + PAYLOAD_SIZE);
+  memcpy(frame, device_mac, 6);
+  frame[6]  = (UCHAR)(PEER_MAC_MSW >> 8);
+  frame[11] = (UCHAR)PEER_MAC_LSW;
+  frame[12] = 0x08;
+
+  ip_header[0] = 0x45;
+  ip_header[2] = (UCHAR)((20 + 8 + PAYLOAD_SIZE) >> 8);
+  ip_header[3] = (UCHAR)(20 + 8 + PAYLOAD_SIZE);
+  ip_header[6] = 0x40;
+  ip_header[8] = 64;
+  ip_header[9] = 17;
+  word_put(ip_header + 12, PEER_ADDRESS);
+  word_put(ip_header + 16, DEVICE_ADDRESS);
+  for (i = 0; i < 20; i += 2)
+  {
+    checksum += ((ULONG)ip_header[i] << 8) | ip_header[i + 1];
+  }
+  checksum = (checksum & 0xFFFF) + (checksum >> 16);
+  checksum = ~((checksum & 0xFFFF) + (checksum >> 16)) & 0xFFFF;
+  ip_header[10] = (UCHAR)(checksum >> 8);
+  ip_header[11] = (UCHAR)checksum;
+
+  udp_header[0] = (UCHAR)(PEER_PORT >> 8);
+  udp_header[1] = (UCHAR)PEER_PORT;
+  udp_header[2] = (UCHAR)(DEVICE_PORT >> 8);
+  udp_header[3] = (UCHAR)DEVICE_PORT;
+  udp_header[5] = 8 + PAYLOAD_SIZE;
+  word_put(udp_header + 8, sequence);
+
+  return FRAME_HEADERS + PAYLOAD_SIZE;
+}
+
+static UINT frame_receive(VOID)
+{
+  UCHAR frame[FRAME_HEADERS + PAYLOAD_SIZE];
+
+  return test_eth_receive(frame, frame_build(frame, rx_sequence++));
+}
+
+/* Datagrams queued on the socket, first must be the number of the first one. */
+static UINT datagrams_take(ULONG first)
+{
+  NX_PACKET* packet_ptr;
+  UINT       count = 0;
+
+  while (nx_udp_socket_receive(&udp_socket, &packet_ptr, NX_NO_WAIT) == NX_SUCCESS)
+  {
+    TEST_ASSERT(packet_ptr->nx_packet_length == PAYLOAD_SIZE);
+    TEST_ASSERT(word_get(packet_ptr->nx_packet_prepend_ptr) == first + count);
+    nx_packet_release(packet_ptr);
+    count++;
+  }
+
+  return count;
+}
+
+static VOID datagram_send(VOID)
+{
+  NX_PACKET* packet_ptr;
+  UCHAR      payload[PAYLOAD_SIZE] = {0};
+
+  word_put(payload, tx_sequence++);
+  TEST_ASSERT(nx_packet_allocate(&pool, &packet_ptr, NX_UDP_PACKET, NX_NO_WAIT) == NX_SUCCESS);
+  TEST_ASSERT(nx_packet_data_append(packet_ptr, payload, sizeof(payload), &pool, NX_NO_WAIT) == NX_SUCCESS);
+  TEST_ASSERT(nx_udp_socket_send(&udp_socket, packet_ptr, PEER_ADDRESS, PEER_PORT) == NX_SUCCESS);
+}
+
+static VOID frame_sink(const UCHAR* frame, ULONG length)
+{
+  TEST_ASSERT(length == FRAME_HEADERS + PAYLOAD_SIZE);
+  TEST_ASSERT((frame[0] == (UCHAR)(PEER_MAC_MSW >> 8)) && (frame[5] == (UCHAR)PEER_MAC_LSW));
+  TEST_ASSERT(word_get(frame + FRAME_HEADERS) == sink_sequence);
+  sink_sequence++;
+  sink_frames++;
+}
+
+static VOID stats_reset(VOID)
+{
+  memset(&test_eth_stats, 0, sizeof(test_eth_stats));
+}
+
+/* Packets neither in the pool nor posted to the receive ring. */
+static ULONG packets_out(VOID)
+{
+  return pool.nx_packet_pool_total - pool.nx_packet_pool_available - NX_DRIVER_RX_DESCRIPTORS;
+}
+
+static VOID ring_check(VOID)
+{
+  ETH_DMADescTypeDef* descriptors = nx_driver_information.nx_driver_information_dma_rx_descriptors;
+  UINT                i;
+  UINT                j;
+
+  TEST_ASSERT(test_eth_rx_owned() == NX_DRIVER_RX_DESCRIPTORS);
+  for (i = 0; i < NX_DRIVER_RX_DESCRIPTORS; i++)
+  {
+    NX_PACKET* packet_ptr = nx_driver_information.nx_driver_information_receive_packets[i];
+
+    TEST_ASSERT(packet_ptr != NX_NULL);
+    TEST_ASSERT(descriptors[i].Buffer1Addr == (ULONG)(packet_ptr->nx_packet_data_start + 2));
+    for (j = 0; j < i; j++)
+    {
+      TEST_ASSERT(nx_driver_information.nx_driver_information_receive_packets[j] != packet_ptr);
+    }
+  }
+}
+
+static VOID ip_priority_set(UINT priority)
+{
+  UINT old_priority;
+
+  TEST_ASSERT(tx_thread_priority_change(&ip.nx_ip_thread, priority, &old_priority) == TX_SUCCESS);
+}
+
+static VOID receive_check(VOID)
+{
+  ETH_DMADescTypeDef* descriptors = nx_driver_information.nx_driver_information_dma_rx_descriptors;
+  ULONG               first;
+  ULONG               buffer_size = nx_driver_information.nx_driver_information_rx_buffer_size;
+  UINT                i;
+
+  // Every second descriptor interrupts on completion
+  for (i = 0; i < NX_DRIVER_RX_DESCRIPTORS; i++)
+  {
+    TEST_ASSERT(!(descriptors[i].ControlBufferSize & ETH_DMARXDESC_DIC) == !((i + 1) % NX_DRIVER_RX_INTERRUPT_COALESCE));
+  }
+  ring_check();
+
+  // A frame without interrupt waits for the watchdog
+  stats_reset();
+  first = rx_sequence;
+  TEST_ASSERT(frame_receive() == NX_SUCCESS);
+  TEST_ASSERT((test_eth_stats.rx_interrupts == 0) && (datagrams_take(first) == 0));
+  test_eth_receive_watchdog();
+  TEST_ASSERT((test_eth_stats.rx_watchdogs == 1) && (test_eth_stats.rx_interrupts == 1));
+  TEST_ASSERT(datagrams_take(first) == 1);
+
+  // The second frame interrupts for both, the refill invalidates the frame
+  // bytes of the received packets and the whole buffer of the new ones
+  first = rx_sequence;
+  TEST_ASSERT(frame_receive() == NX_SUCCESS);
+  TEST_ASSERT(test_eth_stats.rx_interrupts == 2);
+  stats_reset();
+  for (i = 0; i < 2; i++)
+  {
+    TEST_ASSERT(frame_receive() == NX_SUCCESS);
+  }
+  TEST_ASSERT((test_eth_stats.rx_interrupts == 1) && (test_eth_stats.rx_watchdogs == 0));
+  TEST_ASSERT(datagrams_take(first) == 3);
+  TEST_ASSERT(test_eth_stats.invalidate_calls == 4);
+  TEST_ASSERT(test_eth_stats.invalidate_bytes <= 2 * (FRAME_HEADERS + PAYLOAD_SIZE + 4 + 2 + CACHE_LINE + buffer_size));
+  ring_check();
+
+  // The IP thread held back, four frames fill the ring and the fifth is missed
+  ip_priority_set(TEST_PRIORITY + 1);
+  stats_reset();
+  first = rx_sequence;
+  for (i = 0; i < NX_DRIVER_RX_DESCRIPTORS; i++)
+  {
+    TEST_ASSERT(frame_receive() == NX_SUCCESS);
+  }
+  TEST_ASSERT(test_eth_rx_owned() == 0);
+  TEST_ASSERT(frame_receive() == NX_NOT_SUCCESSFUL);
+  TEST_ASSERT((test_eth_stats.rx_missed == 1) && (ETH->DMASR & ETH_DMASR_RBUS));
+
+  // One deferred processing takes the four and refills the ring at once
+  tx_thread_sleep(1);
+  TEST_ASSERT(test_eth_stats.rx_interrupts == NX_DRIVER_RX_DESCRIPTORS / NX_DRIVER_RX_INTERRUPT_COALESCE);
+  ring_check();
+  TEST_ASSERT(datagrams_take(first) == NX_DRIVER_RX_DESCRIPTORS);
+  rx_sequence--;
+
+  // Pool empty: the frames are dropped, their packets posted again
+  i = 0;
+  while (nx_packet_allocate(&pool, &held[i], NX_RECEIVE_PACKET, NX_NO_WAIT) == NX_SUCCESS)
+  {
+    i++;
+  }
+  first = rx_sequence;
+  TEST_ASSERT((frame_receive() == NX_SUCCESS) && (frame_receive() == NX_SUCCESS));
+  tx_thread_sleep(1);
+  TEST_ASSERT(datagrams_take(first) == 0);
+  TEST_ASSERT(pool.nx_packet_pool_available == 0);
+  ring_check();
+
+  // One packet left: the oldest frame is dropped, the newest delivered
+  nx_packet_release(held[--i]);
+  first = rx_sequence;
+  TEST_ASSERT((frame_receive() == NX_SUCCESS) && (frame_receive() == NX_SUCCESS));
+  tx_thread_sleep(1);
+  TEST_ASSERT(datagrams_take(first + 1) == 1);
+  ring_check();
+
+  while (i)
+  {
+    nx_packet_release(held[--i]);
+  }
+  ip_priority_set(IP_PRIORITY);
+
+  first = rx_sequence;
+  TEST_ASSERT((frame_receive() == NX_SUCCESS) && (frame_receive() == NX_SUCCESS));
+  TEST_ASSERT(datagrams_take(first) == 2);
+  ring_check();
+  TEST_ASSERT(packets_out() == 0);
+}
+
+static VOID transmit_check(VOID)
+{
+  TX_TIMER* timer_ptr = &nx_driver_information.nx_driver_information_transmit_reclaim_timer;
+  UINT      active;
+  ULONG     frame_bytes = FRAME_HEADERS + PAYLOAD_SIZE;
+  UINT      i;
+
+  test_eth_sink_set(frame_sink);
+  sink_sequence = tx_sequence;
+  stats_reset();
+
+  // Sent without interrupt, the reclaim timer starts
+  datagram_send();
+  TEST_ASSERT((test_eth_stats.clean_calls == 1) && (test_eth_stats.clean_bytes <= frame_bytes + CACHE_LINE));
+  TEST_ASSERT(!(nx_driver_information.nx_driver_information_dma_tx_descriptors[0].Status & ETH_DMATXDESC_IC));
+  TEST_ASSERT(tx_timer_info_get(timer_ptr, TX_NULL, &active, TX_NULL, TX_NULL, TX_NULL) == TX_SUCCESS);
+  TEST_ASSERT(active == TX_TRUE);
+
+  // Nothing else happens on the link: the timer releases the packet and stops
+  TEST_ASSERT(test_eth_transmit() == 1);
+  TEST_ASSERT((test_eth_stats.tx_interrupts == 0) && (packets_out() == 1));
+  tx_thread_sleep(NX_DRIVER_TX_RECLAIM_TICKS);
+  TEST_ASSERT(packets_out() == 0);
+  tx_thread_sleep(NX_DRIVER_TX_RECLAIM_TICKS + 1);
+  TEST_ASSERT(tx_timer_info_get(timer_ptr, TX_NULL, &active, TX_NULL, TX_NULL, TX_NULL) == TX_SUCCESS);
+  TEST_ASSERT(active == TX_FALSE);
+  TEST_ASSERT(nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use == 0);
+
+  // The next frame interrupts, then one in two
+  datagram_send();
+  TEST_ASSERT(test_eth_transmit() == 1);
+  TEST_ASSERT((test_eth_stats.tx_interrupts == 1) && (packets_out() == 0));
+  stats_reset();
+  for (i = 0; i < 4 * NX_DRIVER_TX_INTERRUPT_COALESCE; i++)
+  {
+    datagram_send();
+    if (i % NX_DRIVER_TX_INTERRUPT_COALESCE)
+    {
+      TEST_ASSERT(test_eth_transmit() == NX_DRIVER_TX_INTERRUPT_COALESCE);
+      TEST_ASSERT(packets_out() == 0);
+    }
+  }
+  TEST_ASSERT(test_eth_stats.tx_interrupts == 4);
+  TEST_ASSERT(test_eth_stats.clean_bytes <= 4 * NX_DRIVER_TX_INTERRUPT_COALESCE * (frame_bytes + CACHE_LINE));
+  TEST_ASSERT(sink_frames == 2 + 4 * NX_DRIVER_TX_INTERRUPT_COALESCE);
+
+  tx_thread_sleep(NX_DRIVER_TX_RECLAIM_TICKS + 1);
+  TEST_ASSERT(tx_timer_info_get(timer_ptr, TX_NULL, &active, TX_NULL, TX_NULL, TX_NULL) == TX_SUCCESS);
+  TEST_ASSERT(active == TX_FALSE);
+}
+
+static VOID benchmark(VOID)
+{
+  ULONG64 start;
+  ULONG64 cycles;
+  ULONG   first = rx_sequence;
+  ULONG   count = 0;
+  UINT    i;
+
+  stats_reset();
+  start = _tx_host_cycles_get();
+  for (i = 0; i < BENCH_FRAMES; i++)
+  {
+    TEST_ASSERT(frame_receive() == NX_SUCCESS);
+    if (i % NX_DRIVER_RX_INTERRUPT_COALESCE)
+    {
+      count += datagrams_take(first + count);
+    }
+  }
+  test_eth_receive_watchdog();
+  count += datagrams_take(first + count);
+  cycles = _tx_host_cycles_get() - start;
+  TEST_ASSERT((count == BENCH_FRAMES) && (test_eth_stats.rx_missed == 0));
+  test_result("eth_driver",
+      "\"direction\":\"rx\",\"packets\":%u,\"packets_per_s\":%.0f,\"cycles_per_packet\":%.0f,"
+      "\"interrupts_per_packet\":%.2f,\"invalidated_bytes_per_packet\":%.0f",
+      BENCH_FRAMES, (double)BENCH_FRAMES * SystemCoreClock / cycles, (double)cycles / BENCH_FRAMES,
+      (double)test_eth_stats.rx_interrupts / BENCH_FRAMES, (double)test_eth_stats.invalidate_bytes / BENCH_FRAMES);
+
+  stats_reset();
+  test_eth_sink_set(TX_NULL);
+  start = _tx_host_cycles_get();
+  for (i = 0; i < BENCH_FRAMES; i++)
+  {
+    datagram_send();
+    if (i % NX_DRIVER_TX_INTERRUPT_COALESCE)
+    {
+      test_eth_transmit();
+    }
+  }
+  cycles = _tx_host_cycles_get() - start;
+  TEST_ASSERT(test_eth_stats.tx_frames == BENCH_FRAMES);
+  test_result("eth_driver",
+      "\"direction\":\"tx\",\"packets\":%u,\"packets_per_s\":%.0f,\"cycles_per_packet\":%.0f,"
+      "\"interrupts_per_packet\":%.2f,\"cleaned_bytes_per_packet\":%.0f",
+      BENCH_FRAMES, (double)BENCH_FRAMES * SystemCoreClock / cycles, (double)cycles / BENCH_FRAMES,
+      (double)test_eth_stats.tx_interrupts / BENCH_FRAMES, (double)test_eth_stats.clean_bytes / BENCH_FRAMES);
+
+  tx_thread_sleep(NX_DRIVER_TX_RECLAIM_TICKS + 1);
+  TEST_ASSERT(packets_out() == 0);
+}
+
+static VOID test_entry(ULONG input)
+{
+  ULONG status;
+
+  (void)input;
+
+  TEST_ASSERT(nx_packet_pool_create(&pool, "Pool", PACKET_SIZE, pool_area, sizeof(pool_area)) == NX_SUCCESS);
+  TEST_ASSERT(nx_ip_create(&ip, "IP", DEVICE_ADDRESS, 0xFFFFFF00UL, &pool, nx_stm32_eth_driver, ip_stack,
+                  sizeof(ip_stack), IP_PRIORITY) == NX_SUCCESS);
+  TEST_ASSERT(nx_arp_enable(&ip, arp_cache, sizeof(arp_cache)) == NX_SUCCESS);
+  TEST_ASSERT(nx_udp_enable(&ip) == NX_SUCCESS);
+  TEST_ASSERT(nx_ip_status_check(&ip, NX_IP_LINK_ENABLED, &status, NX_IP_PERIODIC_RATE) == NX_SUCCESS);
+  TEST_ASSERT(nx_arp_static_entry_create(&ip, PEER_ADDRESS, PEER_MAC_MSW, PEER_MAC_LSW) == NX_SUCCESS);
+  TEST_ASSERT(nx_udp_socket_create(&ip, &udp_socket, "Socket", NX_IP_NORMAL, NX_FRAGMENT_OKAY, 0x80, 2 * PACKET_COUNT) ==
+              NX_SUCCESS);
+  TEST_ASSERT(nx_udp_socket_bind(&udp_socket, DEVICE_PORT, NX_NO_WAIT) == NX_SUCCESS);
+  TEST_ASSERT(pool.nx_packet_pool_total >= PACKET_COUNT);
+
+  receive_check();
+  transmit_check();
+  benchmark();
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(1000);
+}
@@ -0,0 +1,311 @@
+/**
+  ******************************************************************************
+  * @file    mx_wifi_ipc_test.c
+  * @brief   IPC of the EMW3080 driver on its loopback bus
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* mx_wifi_ipc.c over io_pattern/mx_wifi_loopback.c with SPI framing, the
+   ThreadX glue of the NetX Duo driver and MIPC_REQ_LIST_SIZE slots. The test
+   holds the module thread of the loopback to choose what is on the bus when
+   it answers; it then answers everything queued last first.
+
+   Order: requests posted together are answered in reverse, each completion
+   must get its own echo. Slots: with every slot taken a request is refused
+   without being sent; a cancelled request gives its slot back at once, never
+   completes, and its answer is dropped. Timeout: a request the module does
+   not answer fails after its timeout, in ms, frees its slot, and its late
+   answer is not taken for the next request.
+
+   Last, mx_wifi_loopback_bench runs echo requests from 1, 2 and 4 threads on
+   a module that answers after one tick. Every thread must have its request
+   in flight at once, so the rate must grow with the threads. It reports
+   requests per second and the round trip, in us of the simulated cycle
+   counter. */
+
+#include <string.h>
+
+#include "mx_wifi.h"
+#include "core/mx_wifi_ipc.h"
+#define NX_DRIVER_SOURCE
+#include "nx_driver_framework.h"
+#include "stm32u5xx.h"
+#include "test_common.h"
+
+#define TEST_PRIORITY       4
+
+#define PACKET_SIZE         1600
+#define PACKET_COUNT        16
+
+#define PAYLOAD_SIZE        64
+#define TIMEOUT_MS          200
+
+#define BENCH_REQUESTS      500
+
+NX_DRIVER_INFORMATION nx_driver_information;
+
+static TX_THREAD      test_thread;
+static ULONG64        test_stack[8192 / sizeof(ULONG64)];
+static NX_PACKET_POOL pool;
+static ULONG64        pool_area[PACKET_COUNT * (PACKET_SIZE + sizeof(NX_PACKET) + NX_PACKET_ALIGNMENT) / sizeof(ULONG64)];
+
+/* The requests posted together, one more than the slots. */
+static uint8_t  request_payload[MIPC_REQ_LIST_SIZE + 1][PAYLOAD_SIZE];
+static uint8_t  reply_payload[MIPC_REQ_LIST_SIZE + 1][PAYLOAD_SIZE];
+static uint16_t reply_size[MIPC_REQ_LIST_SIZE + 1];
+static uint32_t request_id[MIPC_REQ_LIST_SIZE + 1];
+
+/* Completions in the order the receive thread called them. */
+static uint32_t completed_index[MIPC_REQ_LIST_SIZE + 1];
+static uint32_t completed;
+
+static VOID module_hold(VOID)
+{
+  TX_THREAD* module = test_thread_find("MX_WIFI_LoopbackThreadId");
+
+  TEST_ASSERT(module != TX_NULL);
+  TEST_ASSERT(tx_thread_suspend(module) == TX_SUCCESS);
+}
+
+static VOID module_release(VOID)
+{
+  TEST_ASSERT(tx_thread_resume(test_thread_find("MX_WIFI_LoopbackThreadId")) == TX_SUCCESS);
+}
+
+/* Wait for the receive thread to be done with every request in flight. */
+static VOID requests_settle(VOID)
+{
+  ULONG ticks = 0;
+
+  while (mipc_request_pending())
+  {
+    tx_thread_sleep(1);
+    TEST_ASSERT(++ticks < TX_TIMER_TICKS_PER_SECOND);
+  }
+  tx_thread_sleep(1);
+}
+
+static void request_complete(uint32_t req_id, int32_t status, uint8_t* rbuffer, uint16_t rbuffer_size, void* arg)
+{
+  uint32_t index = (uint32_t)(uintptr_t)arg;
+
+  TEST_ASSERT(status == MIPC_CODE_SUCCESS);
+  TEST_ASSERT(req_id == request_id[index]);
+  TEST_ASSERT((rbuffer == reply_payload[index]) && (rbuffer_size == PAYLOAD_SIZE));
+  TEST_ASSERT(completed <= MIPC_REQ_LIST_SIZE);
+  completed_index[completed++] = index;
+}
+
+static int32_t request_post(uint32_t index)
+{
+  memset(request_payload[index], (int)(0xA0 + index), PAYLOAD_SIZE);
+  memset(reply_payload[index], 0, PAYLOAD_SIZE);
+  reply_size[index] = PAYLOAD_SIZE;
+
+  return mipc_request_async(MIPC_API_SYS_ECHO_CMD, request_payload[index], PAYLOAD_SIZE, reply_payload[index],
+      &reply_size[index], request_complete, (void*)(uintptr_t)index, &request_id[index]);
+}
+
+static VOID echo_check(uint8_t fill)
+{
+  uint8_t  in[PAYLOAD_SIZE];
+  uint8_t  out[PAYLOAD_SIZE];
+  uint16_t out_len = sizeof(out);
+
+  memset(in, fill, sizeof(in));
+  TEST_ASSERT(mipc_echo(in, sizeof(in), out, &out_len, MX_WIFI_CMD_TIMEOUT) == MIPC_CODE_SUCCESS);
+  TEST_ASSERT((out_len == sizeof(in)) && (memcmp(in, out, sizeof(in)) == 0));
+}
+
+/* Requests on the bus together are answered last first. */
+static VOID order_check(VOID)
+{
+  uint32_t count = MIPC_REQ_LIST_SIZE / 2;
+  uint32_t i;
+
+  completed = 0;
+  module_hold();
+  for (i = 0; i < count; i++)
+  {
+    TEST_ASSERT(request_post(i) == MIPC_CODE_SUCCESS);
+  }
+  TEST_ASSERT(mipc_request_pending() == count);
+  module_release();
+  requests_settle();
+
+  TEST_ASSERT(completed == count);
+  for (i = 0; i < count; i++)
+  {
+    TEST_ASSERT(completed_index[i] == count - 1 - i);
+    TEST_ASSERT(memcmp(reply_payload[i], request_payload[i], PAYLOAD_SIZE) == 0);
+  }
+
+  test_result("mx_wifi_ipc_order", "\"requests\":%u,\"first_answered\":%u", count, completed_index[0]);
+}
+
+/* A full table refuses requests, a cancelled slot is taken again at once. */
+static VOID slot_check(VOID)
+{
+  uint8_t  in[PAYLOAD_SIZE] = {0};
+  uint8_t  out[PAYLOAD_SIZE];
+  uint16_t out_len = sizeof(out);
+  uint32_t cancelled = 1;
+  uint32_t i;
+
+  completed = 0;
+  module_hold();
+  for (i = 0; i < MIPC_REQ_LIST_SIZE; i++)
+  {
+    TEST_ASSERT(request_post(i) == MIPC_CODE_SUCCESS);
+  }
+  TEST_ASSERT(mipc_request_pending() == MIPC_REQ_LIST_SIZE);
+
+  TEST_ASSERT(request_post(MIPC_REQ_LIST_SIZE) == MIPC_CODE_NO_MEMORY);
+  TEST_ASSERT(mipc_echo(in, sizeof(in), out, &out_len, MX_WIFI_CMD_TIMEOUT) != MIPC_CODE_SUCCESS);
+  TEST_ASSERT(out_len == 0);
+
+  TEST_ASSERT(mipc_request_cancel(request_id[cancelled]) == MIPC_CODE_SUCCESS);
+  TEST_ASSERT(mipc_request_cancel(request_id[cancelled]) != MIPC_CODE_SUCCESS);
+  TEST_ASSERT(request_post(MIPC_REQ_LIST_SIZE) == MIPC_CODE_SUCCESS);
+  TEST_ASSERT(mipc_request_pending() == MIPC_REQ_LIST_SIZE);
+
+  module_release();
+  requests_settle();
+
+  // Every request but the cancelled one completes, last posted first
+  TEST_ASSERT(completed == MIPC_REQ_LIST_SIZE);
+  TEST_ASSERT(completed_index[0] == MIPC_REQ_LIST_SIZE);
+  for (i = 0; i < completed; i++)
+  {
+    TEST_ASSERT(completed_index[i] != cancelled);
+    TEST_ASSERT(memcmp(reply_payload[completed_index[i]], request_payload[completed_index[i]], PAYLOAD_SIZE) == 0);
+  }
+  TEST_ASSERT(mipc_request_pending() == 0);
+
+  test_result("mx_wifi_ipc_slots", "\"slots\":%u,\"completed\":%u", MIPC_REQ_LIST_SIZE, completed);
+}
+
+/* An unanswered request fails after its timeout, its answer comes too late. */
+static VOID timeout_check(VOID)
+{
+  uint8_t  in[PAYLOAD_SIZE];
+  uint8_t  out[PAYLOAD_SIZE];
+  uint16_t out_len = sizeof(out);
+  ULONG    start;
+  ULONG    waited_ms;
+
+  module_hold();
+  memset(in, 0x55, sizeof(in));
+  start = tx_time_get();
+  TEST_ASSERT(mipc_echo(in, sizeof(in), out, &out_len, TIMEOUT_MS) != MIPC_CODE_SUCCESS);
+  waited_ms = (tx_time_get() - start) * 1000 / TX_TIMER_TICKS_PER_SECOND;
+  TEST_ASSERT((waited_ms >= TIMEOUT_MS) && (waited_ms <= TIMEOUT_MS + 1000 / TX_TIMER_TICKS_PER_SECOND));
+  TEST_ASSERT((out_len == 0) && (mipc_request_pending() == 0));
+
+  // The late answer is dropped, the next request gets its own
+  module_release();
+  requests_settle();
+  echo_check(0x66);
+  TEST_ASSERT(mipc_request_pending() == 0);
+
+  test_result("mx_wifi_ipc_timeout", "\"timeout_ms\":%d,\"waited_ms\":%u", TIMEOUT_MS, waited_ms);
+}
+
+static uint32_t bench_clock_us(void)
+{
+  return (uint32_t)(_tx_host_cycles_get() / (SystemCoreClock / 1000000));
+}
+
+static VOID benchmark(VOID)
+{
+  static const uint32_t   threads[] = {1, 2, 4};
+  mx_wifi_loopback_bench_t result;
+  double                   rate;
+  double                   single_rate = 0;
+  UINT                     i;
+
+  for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+  {
+    TEST_ASSERT(mx_wifi_loopback_bench(threads[i], BENCH_REQUESTS, PAYLOAD_SIZE, bench_clock_us, &result) == 0);
+    TEST_ASSERT((result.requests == threads[i] * BENCH_REQUESTS) && (result.errors == 0));
+    TEST_ASSERT(result.max_pending == threads[i]);
+    TEST_ASSERT(mipc_request_pending() == 0);
+
+    rate = result.requests * 1e6 / result.elapsed_us;
+    if (i == 0)
+    {
+      single_rate = rate;
+    }
+    TEST_ASSERT(rate >= single_rate * threads[i] * 9 / 10);
+
+    test_result("mx_wifi_loopback",
+        "\"threads\":%u,\"requests\":%u,\"requests_per_s\":%.0f,\"latency_avg_us\":%u,\"latency_max_us\":%u,"
+        "\"max_pending\":%u",
+        threads[i], result.requests, rate,
+        result.latency_avg_us, result.latency_max_us, result.max_pending);
+  }
+}
+
+static VOID test_entry(ULONG input)
+{
+  MX_WIFIObject_t* wifi;
+  void*            context;
+
+  (void)input;
+
+  TEST_ASSERT(nx_packet_pool_create(&pool, "Pool", PACKET_SIZE, pool_area, sizeof(pool_area)) == NX_SUCCESS);
+  nx_driver_information.nx_driver_information_packet_pool_ptr = &pool;
+  TEST_ASSERT(mx_wifi_alloc_init() == NX_SUCCESS);
+
+  // The bring-up asks the loopback for its version and MAC address
+  TEST_ASSERT(mxwifi_probe(&context) == 0);
+  wifi = (MX_WIFIObject_t*)context;
+  TEST_ASSERT(wifi == wifi_obj_get());
+  TEST_ASSERT(MX_WIFI_Init(wifi) == MX_WIFI_STATUS_OK);
+  TEST_ASSERT(strcmp((const char*)wifi->SysInfo.FW_Rev, "loopback-1.0") == 0);
+  TEST_ASSERT((wifi->SysInfo.MAC[0] == 0x02) && (wifi->SysInfo.MAC[5] == 0x01));
+  echo_check(0x11);
+
+  // The driver reports the answers it drops
+  test_log_mute();
+
+  order_check();
+  slot_check();
+  timeout_check();
+  benchmark();
+
+  TEST_ASSERT(pool.nx_packet_pool_available == pool.nx_packet_pool_total);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(3000);
+}
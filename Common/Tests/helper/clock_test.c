@@ -0,0 +1,308 @@
+/**
+  ******************************************************************************
+  * @file    clock_test.c
+  * @brief   SNTP disciplined wall clock on a drifting tick
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* nx_azure_iot_clock.c on a tick source that runs 40 ppm fast, then 40 ppm
+   slow. The test thread sets tx_time_get itself, one second of ticks at a
+   time, and keeps the true time those ticks stand for; a reference time is
+   given every UPDATE_INTERVAL, as the SNTP client does. The tick starts two
+   hours before the 32 bit wrap.
+
+   Once settled, every reading must be within ERROR_BOUND_US of the true time
+   and the drift estimate within DRIFT_BOUND_PPB of the tick error, before
+   and after the wrap and after the tick changes from fast to slow. The
+   reference then moves 800 ms ahead, below the step limit: the clock must
+   slew to it, never faster than AZURE_IOT_CLOCK_MAX_PPB over its drift
+   correction, keep its drift estimate and settle again. Last, the reference
+   steps 3 seconds back: readings must hold, never go backwards, and move
+   again once the clock has caught up with the last one handed out.
+
+   Readings are checked to never decrease all along. */
+
+#include <math.h>
+
+#include "nx_azure_iot_clock.h"
+#include "test_common.h"
+
+#define TEST_PRIORITY       4
+
+#define UNIX_START_US       1700000000000000ULL
+#define TICK_START          (0xFFFFFFFFUL - 2 * 3600 * TX_TIMER_TICKS_PER_SECOND + 1)
+
+/* Poll interval of the SNTP client. */
+#define UPDATE_INTERVAL     64
+
+#define PHASE_SECONDS       (3 * 3600)
+#define SETTLE_SECONDS      (10 * 60)
+#define SLEW_AT_SECONDS     (60 * 60)
+
+#define TICK_PPM            40
+#define ERROR_BOUND_US      1000
+#define DRIFT_BOUND_PPB     1000
+
+#define SLEW_OFFSET_US      800000
+#define STEP_BACK_US        3000000
+
+/* A reading advanced in one second of ticks, truncations of clock_read. */
+#define READ_ROUNDING_US    2
+
+static TX_THREAD test_thread;
+static ULONG64   test_stack[8192 / sizeof(ULONG64)];
+
+/* The simulated tick and the true time it stands for. */
+static ULONG64 tick_now;
+static double  true_us;
+static LONG    tick_ppm;
+
+static ULONG64 last_reading;
+static ULONG   settle_until;
+static ULONG   seconds;
+
+static LONG  max_error_us;
+static ULONG readings;
+
+static VOID clock_advance(ULONG ticks)
+{
+  tick_now += ticks;
+  true_us += (double)ticks * 1e6 / TX_TIMER_TICKS_PER_SECOND / (1.0 + tick_ppm * 1e-6);
+  tx_time_set((ULONG)tick_now);
+}
+
+static ULONG64 clock_reading(VOID)
+{
+  ULONG64 unix_us;
+
+  TEST_ASSERT(nx_azure_iot_clock_get_us(&unix_us) == NX_SUCCESS);
+  TEST_ASSERT(unix_us >= last_reading);
+  last_reading = unix_us;
+  readings++;
+
+  return unix_us;
+}
+
+static VOID clock_reference(double offset_us)
+{
+  nx_azure_iot_clock_update((ULONG64)llround(true_us + offset_us), tx_time_get());
+}
+
+/* The drift correction the tick needs, in parts per billion. */
+static int32_t expected_drift_ppb(VOID)
+{
+  return (int32_t)lround((1.0 / (1.0 + tick_ppm * 1e-6) - 1.0) * 1e9);
+}
+
+static VOID drift_check(VOID)
+{
+  AZURE_IOT_CLOCK state;
+
+  nx_azure_iot_clock_state_get(&state);
+  TEST_ASSERT(labs((long)state.drift_ppb - expected_drift_ppb()) <= DRIFT_BOUND_PPB);
+}
+
+/* One second of ticks, a reference on the update interval, and the error of
+   the reading once settled. */
+static ULONG64 clock_second(VOID)
+{
+  ULONG64 reading;
+  LONG    error_us;
+
+  clock_advance(TX_TIMER_TICKS_PER_SECOND);
+  seconds++;
+
+  if (seconds % UPDATE_INTERVAL == 0)
+  {
+    clock_reference(0);
+  }
+
+  reading = clock_reading();
+
+  if (seconds >= settle_until)
+  {
+    error_us = (LONG)llabs((long long)(reading - (ULONG64)llround(true_us)));
+    TEST_ASSERT(error_us <= ERROR_BOUND_US);
+    if (error_us > max_error_us)
+    {
+      max_error_us = error_us;
+    }
+  }
+
+  return reading;
+}
+
+static VOID clock_run(ULONG count)
+{
+  while (count--)
+  {
+    clock_second();
+  }
+}
+
+/* The reference moves ahead by less than the step limit. */
+static VOID slew_check(VOID)
+{
+  AZURE_IOT_CLOCK state;
+  ULONG64         previous;
+  ULONG64         reading;
+  LONG            excess_ppm;
+  LONG            max_excess_ppm = 0;
+  ULONG           slew_seconds   = 0;
+  ULONG           steps;
+  int32_t         drift_ppb;
+
+  nx_azure_iot_clock_state_get(&state);
+  steps     = state.steps;
+  drift_ppb = state.drift_ppb;
+
+  true_us += SLEW_OFFSET_US;
+  settle_until = seconds + SLEW_OFFSET_US / (AZURE_IOT_CLOCK_MAX_PPB / 1000) + SETTLE_SECONDS;
+
+  previous = clock_reading();
+  while (seconds < settle_until)
+  {
+    reading = clock_second();
+
+    nx_azure_iot_clock_state_get(&state);
+    TEST_ASSERT((state.slew_ppb <= AZURE_IOT_CLOCK_MAX_PPB) && (state.slew_ppb >= -AZURE_IOT_CLOCK_MAX_PPB));
+
+    // What the reading gained over one second of ticks corrected for the drift
+    excess_ppm = (LONG)((long long)(reading - previous) - 1000000 - state.drift_ppb / 1000);
+    TEST_ASSERT(excess_ppm <= AZURE_IOT_CLOCK_MAX_PPB / 1000 + READ_ROUNDING_US);
+    if (excess_ppm > max_excess_ppm)
+    {
+      max_excess_ppm = excess_ppm;
+    }
+    if (excess_ppm > AZURE_IOT_CLOCK_MAX_PPB / 2000)
+    {
+      slew_seconds++;
+    }
+
+    previous = reading;
+  }
+
+  // Slewed at the limit, no step, and the offset was not taken for drift
+  nx_azure_iot_clock_state_get(&state);
+  TEST_ASSERT(state.steps == steps);
+  TEST_ASSERT(max_excess_ppm >= AZURE_IOT_CLOCK_MAX_PPB / 1000 - READ_ROUNDING_US);
+  TEST_ASSERT(slew_seconds >= SLEW_OFFSET_US / (AZURE_IOT_CLOCK_MAX_PPB / 1000) * 9 / 10);
+  TEST_ASSERT(labs((long)state.drift_ppb - drift_ppb) <= DRIFT_BOUND_PPB);
+
+  test_result("clock_slew", "\"offset_us\":%d,\"max_excess_ppm\":%d,\"slew_seconds\":%u",
+      SLEW_OFFSET_US, max_excess_ppm, slew_seconds);
+}
+
+/* The reference steps back: readings hold until the clock catches up. */
+static VOID step_back_check(VOID)
+{
+  AZURE_IOT_CLOCK state;
+  ULONG64         held;
+  ULONG64         reading;
+  ULONG           held_ticks = 0;
+  ULONG           steps;
+
+  nx_azure_iot_clock_state_get(&state);
+  steps = state.steps;
+
+  held = clock_reading();
+  clock_reference(-STEP_BACK_US);
+
+  nx_azure_iot_clock_state_get(&state);
+  TEST_ASSERT(state.steps == steps + 1);
+
+  for (;;)
+  {
+    clock_advance(1);
+    reading = clock_reading();
+    if (reading != held)
+    {
+      break;
+    }
+
+    held_ticks++;
+    TEST_ASSERT(held_ticks <= (STEP_BACK_US / 1000000 + 1) * TX_TIMER_TICKS_PER_SECOND);
+  }
+
+  // Held for the step, then running again from the last reading
+  TEST_ASSERT(held_ticks >= (STEP_BACK_US / 1000000) * TX_TIMER_TICKS_PER_SECOND * 99 / 100);
+  TEST_ASSERT(reading - held <= 1000000 / TX_TIMER_TICKS_PER_SECOND);
+
+  test_result("clock_step_back", "\"step_us\":%d,\"held_ms\":%u", STEP_BACK_US,
+      held_ticks * 1000 / TX_TIMER_TICKS_PER_SECOND);
+}
+
+static VOID test_entry(ULONG input)
+{
+  ULONG64 unix_us;
+  ULONG   wrap_seconds;
+
+  (void)input;
+
+  TEST_ASSERT(nx_azure_iot_clock_get_us(&unix_us) == NX_NOT_SUCCESSFUL);
+
+  tick_now = TICK_START;
+  true_us  = (double)UNIX_START_US;
+  tick_ppm = TICK_PPM;
+  tx_time_set((ULONG)tick_now);
+
+  clock_reference(0);
+  settle_until = SETTLE_SECONDS;
+
+  // Fast tick, the reference moves ahead, then across the wrap
+  clock_run(SLEW_AT_SECONDS);
+  drift_check();
+  slew_check();
+
+  wrap_seconds = (ULONG)((0x100000000ULL - TICK_START) / TX_TIMER_TICKS_PER_SECOND);
+  TEST_ASSERT(seconds < wrap_seconds);
+  clock_run(PHASE_SECONDS - seconds);
+  TEST_ASSERT(tick_now > 0xFFFFFFFFULL);
+  drift_check();
+  test_result("clock_drift", "\"tick_ppm\":%d,\"max_error_us\":%d,\"readings\":%u", tick_ppm, max_error_us,
+      readings);
+
+  // Slow tick
+  tick_ppm     = -TICK_PPM;
+  max_error_us = 0;
+  settle_until = seconds + SETTLE_SECONDS;
+  clock_run(PHASE_SECONDS);
+  drift_check();
+  test_result("clock_drift", "\"tick_ppm\":%d,\"max_error_us\":%d,\"readings\":%u", tick_ppm, max_error_us,
+      readings);
+
+  step_back_check();
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100);
+}
@@ -0,0 +1,325 @@
+/**
+  ******************************************************************************
+  * @file    command_dispatch_test.c
+  * @brief   Commands through client_run, their responses and round trip
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The board helper, nx_azure_iot_client.c, runs the IoT Hub client against
+   the broker, which sends direct method requests as the hub does and reads
+   the responses the device publishes. With no command callback every request
+   is answered 501. With the callback of the test, an echo command is answered
+   200 with its payload and any other 404, and a payload spread over several
+   packets 413. The round trip, from the request written by the broker to the
+   response it reads, must stay within the two link delays and a few ticks of
+   processing: client_run wakes on the command event instead of polling. The
+   test reports it, and the delay from the command event to the callback.
+   Last, a burst of requests larger than a receive batch is answered in full,
+   in order. */
+
+#include "nx_host_link.h"
+#include "test_broker.h"
+#include "test_common.h"
+#include "test_dns.h"
+#include "test_helper.h"
+
+#define TEST_PRIORITY       12
+#define HELPER_PRIORITY     10
+#define DEVICE_PACKETS      64
+#define BROKER_PACKETS      64
+#define DNS_PACKETS         16
+
+/* The link: 50 ms one way, 2 Mbit/s. */
+#define LINK_DELAY          5
+#define LINK_RATE           2500
+#define LINK_QUEUE          (64 * 1024)
+
+/* Ticks a round trip may take on top of the two link delays. */
+#define PROCESSING_TICKS    4
+
+#define COMMANDS            200
+#define BURST               20
+#define LARGE_PAYLOAD       (3 * 1024)
+
+#define COMMAND_ECHO        "echo"
+#define COMMAND_UNKNOWN     "reboot"
+#define REQUEST_TOPIC       "$iothub/methods/POST/"
+#define RESPONSE_TOPIC      "$iothub/methods/res/"
+#define RID_KEY             "/?$rid="
+
+#define STATUS_OK           200
+#define STATUS_NOT_FOUND    404
+#define STATUS_TOO_LARGE    413
+#define STATUS_NOT_IMPL     501
+
+/* The last response the broker read. */
+typedef struct COMMAND_RESPONSE_STRUCT
+{
+  ULONG tick;
+  UINT  status;
+  ULONG request_id;
+  UCHAR payload[64];
+  UINT  payload_length;
+} COMMAND_RESPONSE;
+
+static TEST_NET_HOST device;
+static TEST_BROKER   broker;
+static TEST_DNS      dns;
+static TEST_HELPER   helper;
+static TX_THREAD     test_thread;
+static ULONG64       test_stack[16384 / sizeof(ULONG64)];
+
+static UCHAR            large_payload[LARGE_PAYLOAD];
+static ULONG            request_id;
+static COMMAND_RESPONSE response;
+static ULONG            responses;
+static ULONG            responses_out_of_order;
+
+/* Delay from the command event to the callback, in ticks. */
+static ULONG dispatch_ticks_max;
+static ULONG dispatch_ticks_total;
+static ULONG dispatches;
+
+static VOID command_received_callback(AZURE_IOT_CONTEXT* context,
+    const UCHAR*                                         component_name,
+    USHORT                                               component_name_length,
+    const UCHAR*                                         command_name,
+    USHORT                                               command_name_length,
+    UCHAR*                                               payload,
+    USHORT                                               payload_length,
+    VOID*                                                context_ptr,
+    USHORT                                               context_length)
+{
+  ULONG ticks = tx_time_get() - context->command_receive_tick;
+  UINT  status;
+
+  (void)component_name;
+  (void)component_name_length;
+
+  if (ticks > dispatch_ticks_max)
+  {
+    dispatch_ticks_max = ticks;
+  }
+  dispatch_ticks_total += ticks;
+  dispatches++;
+
+  if ((command_name_length == sizeof(COMMAND_ECHO) - 1) &&
+      (memcmp(command_name, COMMAND_ECHO, sizeof(COMMAND_ECHO) - 1) == 0))
+  {
+    status = nx_azure_iot_hub_client_command_message_response(
+        &context->iothub_client, STATUS_OK, context_ptr, context_length, payload, payload_length, NX_WAIT_FOREVER);
+  }
+  else
+  {
+    status = nx_azure_iot_hub_client_command_message_response(
+        &context->iothub_client, STATUS_NOT_FOUND, context_ptr, context_length, NX_NULL, 0, NX_WAIT_FOREVER);
+  }
+
+  TEST_ASSERT(status == NX_AZURE_IOT_SUCCESS);
+}
+
+static ULONG decimal_parse(const UCHAR* text, UINT length, UINT* offset_ptr)
+{
+  ULONG value = 0;
+
+  for (; (*offset_ptr < length) && (text[*offset_ptr] >= '0') && (text[*offset_ptr] <= '9'); (*offset_ptr)++)
+  {
+    value = value * 10 + (text[*offset_ptr] - '0');
+  }
+
+  return value;
+}
+
+/* Keep the status, request id and payload of a response, $iothub/methods/res/{status}/?$rid={id}. */
+static VOID publish_notify(
+    TEST_BROKER* broker_ptr, const UCHAR* topic, UINT topic_length, const UCHAR* payload, UINT payload_length)
+{
+  UINT  offset = sizeof(RESPONSE_TOPIC) - 1;
+  UINT  status;
+  ULONG id;
+
+  (void)broker_ptr;
+
+  if ((topic_length < offset) || memcmp(topic, RESPONSE_TOPIC, offset))
+  {
+    return;
+  }
+
+  status = (UINT)decimal_parse(topic, topic_length, &offset);
+  TEST_ASSERT((topic_length >= offset + sizeof(RID_KEY) - 1) && !memcmp(&topic[offset], RID_KEY, sizeof(RID_KEY) - 1));
+  offset += sizeof(RID_KEY) - 1;
+  id = decimal_parse(topic, topic_length, &offset);
+  TEST_ASSERT(offset == topic_length);
+
+  if (responses && (id != response.request_id + 1))
+  {
+    responses_out_of_order++;
+  }
+
+  response.tick = tx_time_get();
+  response.status = status;
+  response.request_id = id;
+  response.payload_length = (payload_length < sizeof(response.payload)) ? payload_length : sizeof(response.payload);
+  memcpy(response.payload, payload, response.payload_length);
+  responses++;
+}
+
+/* Send the request, a QoS 0 PUBLISH on $iothub/methods/POST/{name}/?$rid={id}. */
+static VOID command_send(const CHAR* name, const UCHAR* payload, UINT payload_length)
+{
+  CHAR topic[64];
+
+  snprintf(topic, sizeof(topic), REQUEST_TOPIC "%s" RID_KEY "%u", name, (UINT)++request_id);
+  TEST_ASSERT(test_broker_publish(&broker, topic, payload, payload_length) == NX_SUCCESS);
+}
+
+/* Send one request, wait for its response and return the round trip in ticks. */
+static ULONG command_call(const CHAR* name, const UCHAR* payload, UINT payload_length, UINT expected_status)
+{
+  ULONG expected = responses + 1;
+  ULONG start = tx_time_get();
+
+  command_send(name, payload, payload_length);
+  while (responses < expected)
+  {
+    tx_thread_sleep(1);
+  }
+
+  TEST_ASSERT(response.request_id == request_id);
+  TEST_ASSERT(response.status == expected_status);
+
+  return response.tick - start;
+}
+
+static VOID round_trip_run(const CHAR* callback)
+{
+  static const UCHAR payload[] = "{\"value\":42}";
+  ULONG              ticks;
+  ULONG              ticks_max = 0;
+  ULONG              ticks_total = 0;
+  UINT               count;
+
+  for (count = 0; count < COMMANDS; count++)
+  {
+    ticks = command_call(COMMAND_ECHO,
+        payload,
+        sizeof(payload) - 1,
+        (helper.context.command_received_cb == NX_NULL) ? STATUS_NOT_IMPL : STATUS_OK);
+    if (helper.context.command_received_cb != NX_NULL)
+    {
+      TEST_ASSERT((response.payload_length == sizeof(payload) - 1) &&
+                  !memcmp(response.payload, payload, sizeof(payload) - 1));
+    }
+
+    if (ticks > ticks_max)
+    {
+      ticks_max = ticks;
+    }
+    ticks_total += ticks;
+  }
+
+  TEST_ASSERT(ticks_max <= 2 * LINK_DELAY + PROCESSING_TICKS);
+
+  test_result("command_round_trip",
+      "\"callback\":\"%s\",\"commands\":%u,\"round_trip_ms\":%.1f,\"round_trip_max_ms\":%u,"
+      "\"dispatch_ms\":%.1f,\"dispatch_max_ms\":%u",
+      callback,
+      COMMANDS,
+      (double)ticks_total * 1000 / TX_TIMER_TICKS_PER_SECOND / COMMANDS,
+      (UINT)(ticks_max * 1000 / TX_TIMER_TICKS_PER_SECOND),
+      dispatches ? (double)dispatch_ticks_total * 1000 / TX_TIMER_TICKS_PER_SECOND / dispatches : 0.0,
+      (UINT)(dispatch_ticks_max * 1000 / TX_TIMER_TICKS_PER_SECOND));
+}
+
+static VOID test_entry(ULONG input)
+{
+  ULONG expected;
+  UINT  count;
+
+  (void)input;
+
+  test_log_mute();
+  nx_host_link_configure(LINK_DELAY, LINK_RATE, LINK_QUEUE);
+  nx_secure_tls_initialize();
+  TEST_ASSERT(test_broker_create(&broker, TEST_NET_ADDRESS(1), BROKER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_create(&dns, TEST_NET_ADDRESS(3), DNS_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_record_add(&dns, TEST_HUB_HOSTNAME, TEST_NET_ADDRESS(1)) == NX_SUCCESS);
+  TEST_ASSERT(test_net_host_create(&device, "Device", TEST_NET_ADDRESS(2), DEVICE_PACKETS) == NX_SUCCESS);
+  broker.publish_notify = publish_notify;
+
+  TEST_ASSERT(test_helper_create(&helper, &device, TEST_NET_ADDRESS(3)) == NX_SUCCESS);
+  TEST_ASSERT(test_helper_start(&helper, HELPER_PRIORITY) == TX_SUCCESS);
+
+  /* The connect and its properties request stay out of the measures. */
+  test_helper_connected_wait(&helper);
+  tx_thread_sleep(NX_IP_PERIODIC_RATE);
+
+  /* No callback, as the apps of the boards: not implemented. */
+  round_trip_run("none");
+
+  /* The callback of the test answers, it can be registered only once. */
+  TEST_ASSERT(nx_azure_iot_client_register_command_callback(&helper.context, command_received_callback) ==
+              NX_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_client_register_command_callback(&helper.context, command_received_callback) !=
+              NX_SUCCESS);
+  round_trip_run("echo");
+  TEST_ASSERT(dispatches == COMMANDS);
+  TEST_ASSERT(dispatch_ticks_max <= 1);
+
+  command_call(COMMAND_UNKNOWN, NX_NULL, 0, STATUS_NOT_FOUND);
+
+  /* The payload does not fit the packets of the device, the callback never sees it. */
+  memset(large_payload, 'x', sizeof(large_payload));
+  command_call(COMMAND_ECHO, large_payload, sizeof(large_payload), STATUS_TOO_LARGE);
+  TEST_ASSERT(dispatches == COMMANDS + 1);
+
+  /* More requests than a wakeup of client_run takes, each answered once. */
+  expected = responses + BURST;
+  for (count = 0; count < BURST; count++)
+  {
+    command_send(COMMAND_ECHO, (const UCHAR*)"{}", 2);
+  }
+  while (responses < expected)
+  {
+    tx_thread_sleep(NX_IP_PERIODIC_RATE / 10);
+  }
+  tx_thread_sleep(NX_IP_PERIODIC_RATE);
+
+  TEST_ASSERT(responses == expected);
+  TEST_ASSERT((response.request_id == request_id) && (response.status == STATUS_OK));
+  TEST_ASSERT(responses_out_of_order == 0);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  nx_system_initialize();
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(6000000);
+}
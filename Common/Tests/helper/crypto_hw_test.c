@@ -0,0 +1,720 @@
+/**
+  ******************************************************************************
+  * @file    crypto_hw_test.c
+  * @brief   Crypto methods of the helper on a fake peripheral driver
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* nx_azure_iot_crypto_hw.c of the board against a fake of the AES, HASH and
+   PKA peripherals, set with nx_azure_iot_crypto_hw_driver_set. The fake runs
+   the software AES, SHA-256 and curve of NX Crypto and counts the calls.
+   Against the software methods:
+   - AES-GCM and AES-CBC give the same records and tags, in place or not, on
+     lengths around the offload threshold and the chunk size. Below
+     NX_AZURE_IOT_CRYPTO_HW_AES_MIN_BYTES the peripheral is not taken, above
+     it GCM and CBC decryption go in chunks of
+     NX_AZURE_IOT_CRYPTO_HW_AES_CHUNK_BYTES, CBC encryption block by block;
+   - a chunk the driver fails after writing part of the output, or a driver
+     without aes_chunk, goes block by block, a busy peripheral leaves the
+     update in software;
+   - the one shot digests go to the driver, the streamed ones stay in
+     software;
+   - ECDHE between the offloaded and the software curve agree, on P-256 and
+     P-384, and the driver gets -3 for a.
+
+   The benchmark encrypts a 16 KB record, the largest TLS record, and reports
+   the driver calls: one block per call, against one chunk per call. The host
+   CPU time is reported as well; the fake runs the same software AES as the
+   reference, so it only measures the cost of the dispatch and the copies, not
+   the peripheral. */
+
+#include <string.h>
+#include <time.h>
+
+#include "nx_azure_iot_crypto_hw.h"
+#include "nx_crypto_aes.h"
+#include "nx_crypto_ec.h"
+#include "nx_crypto_ecdh.h"
+#include "nx_crypto_hmac_sha2.h"
+#include "nx_crypto_sha2.h"
+#include "test_common.h"
+
+#define TEST_PRIORITY   4
+
+#define RECORD_BYTES    16384
+#define GCM_IV_BYTES    12
+#define GCM_TAG_BYTES   16
+#define AAD_BYTES       13
+#define BENCH_RECORDS   64
+
+extern NX_CRYPTO_METHOD crypto_method_aes_128_gcm_16;
+extern NX_CRYPTO_METHOD crypto_method_aes_cbc_128;
+extern NX_CRYPTO_METHOD crypto_method_sha256;
+extern NX_CRYPTO_METHOD crypto_method_hmac_sha256;
+extern NX_CRYPTO_METHOD crypto_method_ec_secp256;
+extern NX_CRYPTO_METHOD crypto_method_ec_secp384;
+extern NX_CRYPTO_METHOD crypto_method_ecdh;
+
+/* The state of the fake peripherals. */
+typedef struct FAKE_STATS_STRUCT
+{
+  ULONG aes_begins;
+  ULONG aes_blocks;
+  ULONG aes_chunks;
+  ULONG aes_chunk_bytes;
+  ULONG sha256;
+  ULONG hmac_sha256;
+  ULONG ecc_multiply;
+} FAKE_STATS;
+
+static TX_THREAD     test_thread;
+static ULONG64       test_stack[65536 / sizeof(ULONG64)];
+static FAKE_STATS    fake;
+static NX_CRYPTO_AES fake_aes;
+static UINT          fake_aes_decrypt;
+static UINT          fake_aes_open;
+static UINT          fake_busy;
+static UINT          fake_chunk_fail;
+static HN_UBASE      fake_scratch[NX_CRYPTO_ECDH_SCRATCH_BUFFER_SIZE >> HN_SIZE_SHIFT];
+
+static ULONG         aes_sw_metadata[sizeof(NX_CRYPTO_AES) / sizeof(ULONG) + 1];
+static ULONG         aes_hw_metadata[sizeof(NX_CRYPTO_AES) / sizeof(ULONG) + 1];
+static ULONG         ecdh_sw_metadata[sizeof(NX_CRYPTO_ECDH) / sizeof(ULONG) + 1];
+static ULONG         ecdh_hw_metadata[sizeof(NX_CRYPTO_ECDH) / sizeof(ULONG) + 1];
+static ULONG         hash_metadata[sizeof(NX_CRYPTO_SHA256_HMAC) / sizeof(ULONG) + 1];
+
+static UCHAR         plain[RECORD_BYTES];
+static UCHAR         sw_record[RECORD_BYTES + GCM_TAG_BYTES];
+static UCHAR         hw_record[RECORD_BYTES + GCM_TAG_BYTES];
+static UCHAR         opened[RECORD_BYTES];
+
+static const UCHAR   key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+static const UCHAR   gcm_iv[1 + GCM_IV_BYTES] = {GCM_IV_BYTES, 0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce,
+                                                 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88};
+static const UCHAR   cbc_iv[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                   0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+static const UCHAR   aad[AAD_BYTES] = {0, 0, 0, 0, 0, 0, 0, 1, 0x17, 0x03, 0x03, 0x40, 0x00};
+
+static UINT fake_aes_begin(const UCHAR* key_ptr, UINT key_size_in_bits, UINT decrypt)
+{
+  if (fake_busy)
+  {
+    return NX_CRYPTO_NOT_SUCCESSFUL;
+  }
+
+  TEST_ASSERT(!fake_aes_open);
+  TEST_ASSERT(key_size_in_bits == 128);
+  TEST_ASSERT(memcmp(key_ptr, key, sizeof(key)) == 0);
+
+  _nx_crypto_aes_key_set(&fake_aes, (UCHAR*)key_ptr, key_size_in_bits >> 5);
+  fake_aes_decrypt = decrypt;
+  fake_aes_open = NX_CRYPTO_TRUE;
+  fake.aes_begins++;
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+static VOID fake_aes_block(const UCHAR* input, UCHAR* output)
+{
+  TEST_ASSERT(fake_aes_open);
+
+  (fake_aes_decrypt ? _nx_crypto_aes_decrypt : _nx_crypto_aes_encrypt)(&fake_aes,
+      (UCHAR*)input,
+      output,
+      NX_CRYPTO_AES_BLOCK_SIZE);
+  fake.aes_blocks++;
+}
+
+/* The DMA of the board takes word aligned buffers only, the fake checks it as well. */
+static UINT fake_aes_chunk(const UCHAR* input, UCHAR* output, UINT length)
+{
+  UINT offset;
+
+  TEST_ASSERT(fake_aes_open);
+  TEST_ASSERT((length > 0) && (length <= NX_AZURE_IOT_CRYPTO_HW_AES_CHUNK_BYTES));
+  TEST_ASSERT((length % NX_CRYPTO_AES_BLOCK_SIZE) == 0);
+  TEST_ASSERT((((ULONG)input | (ULONG)output) & 0x3) == 0);
+
+  // A transfer error half way, the blocks already out are in the output
+  if (fake_chunk_fail)
+  {
+    memset(output, 0xA5, length / 2);
+    return NX_CRYPTO_NOT_SUCCESSFUL;
+  }
+
+  for (offset = 0; offset < length; offset += NX_CRYPTO_AES_BLOCK_SIZE)
+  {
+    (fake_aes_decrypt ? _nx_crypto_aes_decrypt : _nx_crypto_aes_encrypt)(&fake_aes,
+        (UCHAR*)input + offset,
+        output + offset,
+        NX_CRYPTO_AES_BLOCK_SIZE);
+  }
+  fake.aes_chunks++;
+  fake.aes_chunk_bytes += length;
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+static VOID fake_aes_end(VOID)
+{
+  TEST_ASSERT(fake_aes_open);
+  fake_aes_open = NX_CRYPTO_FALSE;
+}
+
+static UINT fake_sha256(const UCHAR* input, UINT length, UCHAR* digest)
+{
+  NX_CRYPTO_SHA256 context;
+
+  if (fake_busy)
+  {
+    return NX_CRYPTO_NOT_SUCCESSFUL;
+  }
+
+  _nx_crypto_sha256_initialize(&context, NX_CRYPTO_HASH_SHA256);
+  _nx_crypto_sha256_update(&context, (UCHAR*)input, length);
+  _nx_crypto_sha256_digest_calculate(&context, digest, NX_CRYPTO_HASH_SHA256);
+  fake.sha256++;
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+static UINT fake_hmac_sha256(const UCHAR* key_ptr, UINT key_length, const UCHAR* input, UINT length, UCHAR* digest)
+{
+  NX_CRYPTO_SHA256_HMAC context;
+  VOID*                 handle = NX_CRYPTO_NULL;
+
+  if (fake_busy)
+  {
+    return NX_CRYPTO_NOT_SUCCESSFUL;
+  }
+
+  crypto_method_hmac_sha256.nx_crypto_init(
+      &crypto_method_hmac_sha256, (UCHAR*)key_ptr, key_length << 3, &handle, &context, sizeof(context));
+  crypto_method_hmac_sha256.nx_crypto_operation(NX_CRYPTO_AUTHENTICATE,
+      handle,
+      &crypto_method_hmac_sha256,
+      (UCHAR*)key_ptr,
+      key_length << 3,
+      (UCHAR*)input,
+      length,
+      NX_CRYPTO_NULL,
+      digest,
+      32,
+      &context,
+      sizeof(context),
+      NX_CRYPTO_NULL,
+      NX_CRYPTO_NULL);
+  fake.hmac_sha256++;
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+/* The software curve of the same size does the multiplication, from the bytes the PKA gets. */
+static UINT fake_ecc_multiply(
+    const NX_AZURE_IOT_CRYPTO_HW_CURVE* curve, const UCHAR* k, const UCHAR* px, const UCHAR* py, UCHAR* rx, UCHAR* ry)
+{
+  NX_CRYPTO_METHOD*     method = (curve->size == 32) ? &crypto_method_ec_secp256 : &crypto_method_ec_secp384;
+  NX_CRYPTO_EC*         sw_curve;
+  NX_CRYPTO_EC_POINT    point;
+  NX_CRYPTO_EC_POINT    result;
+  NX_CRYPTO_HUGE_NUMBER scalar;
+  HN_UBASE*             scratch = fake_scratch;
+  UCHAR                 p[NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES];
+  UINT                  index;
+
+  if (fake_busy)
+  {
+    return NX_CRYPTO_NOT_SUCCESSFUL;
+  }
+
+  TEST_ASSERT((curve->size == 32) || (curve->size == 48));
+  method->nx_crypto_operation(NX_CRYPTO_EC_CURVE_GET,
+      NX_CRYPTO_NULL,
+      method,
+      NX_CRYPTO_NULL,
+      0,
+      NX_CRYPTO_NULL,
+      0,
+      NX_CRYPTO_NULL,
+      (UCHAR*)&sw_curve,
+      sizeof(sw_curve),
+      NX_CRYPTO_NULL,
+      0,
+      NX_CRYPTO_NULL,
+      NX_CRYPTO_NULL);
+
+  /* The NIST curves have a = -3, the peripheral gets the sign and 3. */
+  TEST_ASSERT(curve->a_negative);
+  for (index = 0; index + 1 < curve->size; index++)
+  {
+    TEST_ASSERT(curve->a_abs[index] == 0);
+  }
+  TEST_ASSERT(curve->a_abs[curve->size - 1] == 3);
+  _nx_crypto_huge_number_extract_fixed_size(&sw_curve->nx_crypto_ec_field.fp, p, curve->size);
+  TEST_ASSERT(memcmp(p, curve->p, curve->size) == 0);
+
+  NX_CRYPTO_EC_POINT_INITIALIZE(&point, NX_CRYPTO_EC_POINT_AFFINE, scratch, curve->size);
+  NX_CRYPTO_EC_POINT_INITIALIZE(&result, NX_CRYPTO_EC_POINT_AFFINE, scratch, curve->size);
+  NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&scalar, scratch, curve->size);
+  _nx_crypto_huge_number_setup(&point.nx_crypto_ec_point_x, px, curve->size);
+  _nx_crypto_huge_number_setup(&point.nx_crypto_ec_point_y, py, curve->size);
+  _nx_crypto_huge_number_setup(&scalar, k, curve->size);
+
+  _nx_crypto_ec_fp_projective_multiple(sw_curve, &point, &scalar, &result, scratch);
+
+  _nx_crypto_huge_number_extract_fixed_size(&result.nx_crypto_ec_point_x, rx, curve->size);
+  _nx_crypto_huge_number_extract_fixed_size(&result.nx_crypto_ec_point_y, ry, curve->size);
+  fake.ecc_multiply++;
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+static const NX_AZURE_IOT_CRYPTO_HW_DRIVER fake_driver = {
+    .aes_begin    = fake_aes_begin,
+    .aes_block    = fake_aes_block,
+    .aes_chunk    = fake_aes_chunk,
+    .aes_end      = fake_aes_end,
+    .sha256       = fake_sha256,
+    .hmac_sha256  = fake_hmac_sha256,
+    .ecc_multiply = fake_ecc_multiply,
+};
+
+/* The peripheral of the F746, AES without DMA. */
+static const NX_AZURE_IOT_CRYPTO_HW_DRIVER fake_driver_no_chunk = {
+    .aes_begin = fake_aes_begin,
+    .aes_block = fake_aes_block,
+    .aes_end   = fake_aes_end,
+};
+
+static UINT aes_run(NX_CRYPTO_METHOD* method, ULONG* metadata, UINT op, UINT length, UCHAR* input, UCHAR* output)
+{
+  UINT   gcm = (method->nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_AES_GCM_16);
+  UINT   decrypt = (op == NX_CRYPTO_DECRYPT);
+  UCHAR* iv = gcm ? (UCHAR*)gcm_iv : (UCHAR*)cbc_iv;
+  VOID*  handle = NX_CRYPTO_NULL;
+  UINT   status;
+
+  memset(metadata, 0, sizeof(NX_CRYPTO_AES));
+  if ((status = method->nx_crypto_init(method, (UCHAR*)key, 128, &handle, metadata, sizeof(NX_CRYPTO_AES))))
+  {
+    return status;
+  }
+
+  if (gcm)
+  {
+    // The record as NX Secure runs it: the AAD, the update, then the tag after the data
+    if ((status = method->nx_crypto_operation(decrypt ? NX_CRYPTO_DECRYPT_INITIALIZE : NX_CRYPTO_ENCRYPT_INITIALIZE,
+             handle, method, NX_CRYPTO_NULL, 0, (UCHAR*)aad, sizeof(aad), iv, NX_CRYPTO_NULL, 0, metadata,
+             sizeof(NX_CRYPTO_AES), NX_CRYPTO_NULL, NX_CRYPTO_NULL)) ||
+        (status = method->nx_crypto_operation(decrypt ? NX_CRYPTO_DECRYPT_UPDATE : NX_CRYPTO_ENCRYPT_UPDATE,
+             handle, method, NX_CRYPTO_NULL, 0, input, length, NX_CRYPTO_NULL, output, length, metadata,
+             sizeof(NX_CRYPTO_AES), NX_CRYPTO_NULL, NX_CRYPTO_NULL)))
+    {
+      return status;
+    }
+
+    return decrypt ? method->nx_crypto_operation(NX_CRYPTO_DECRYPT_CALCULATE, handle, method, NX_CRYPTO_NULL, 0,
+                         input + length, GCM_TAG_BYTES, NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0, metadata,
+                         sizeof(NX_CRYPTO_AES), NX_CRYPTO_NULL, NX_CRYPTO_NULL)
+                   : method->nx_crypto_operation(NX_CRYPTO_ENCRYPT_CALCULATE, handle, method, NX_CRYPTO_NULL, 0,
+                         NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, output + length, GCM_TAG_BYTES, metadata,
+                         sizeof(NX_CRYPTO_AES), NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  }
+
+  if ((status = method->nx_crypto_operation(decrypt ? NX_CRYPTO_DECRYPT_INITIALIZE : NX_CRYPTO_ENCRYPT_INITIALIZE,
+           handle, method, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, 0, iv, NX_CRYPTO_NULL, 0, metadata,
+           sizeof(NX_CRYPTO_AES), NX_CRYPTO_NULL, NX_CRYPTO_NULL)))
+  {
+    return status;
+  }
+
+  return method->nx_crypto_operation(decrypt ? NX_CRYPTO_DECRYPT_UPDATE : NX_CRYPTO_ENCRYPT_UPDATE, handle, method,
+      NX_CRYPTO_NULL, 0, input, length, NX_CRYPTO_NULL, output, length, metadata, sizeof(NX_CRYPTO_AES),
+      NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+}
+
+/* Seal then open length bytes with sw and hw, in place or not: the records, tags and plain text
+   must match. Returns the driver calls of the sealing through the peripheral. */
+static FAKE_STATS aes_check(NX_CRYPTO_METHOD* sw, NX_CRYPTO_METHOD* hw, UINT length, UINT in_place)
+{
+  UINT       tag = (sw->nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_AES_GCM_16) ? GCM_TAG_BYTES : 0;
+  FAKE_STATS sealed;
+
+  TEST_ASSERT(aes_run(sw, aes_sw_metadata, NX_CRYPTO_ENCRYPT, length, plain, sw_record) == NX_CRYPTO_SUCCESS);
+
+  memset(&fake, 0, sizeof(fake));
+  if (in_place)
+  {
+    memcpy(hw_record, plain, length);
+    TEST_ASSERT(aes_run(hw, aes_hw_metadata, NX_CRYPTO_ENCRYPT, length, hw_record, hw_record) ==
+                NX_CRYPTO_SUCCESS);
+  }
+  else
+  {
+    TEST_ASSERT(aes_run(hw, aes_hw_metadata, NX_CRYPTO_ENCRYPT, length, plain, hw_record) == NX_CRYPTO_SUCCESS);
+  }
+  TEST_ASSERT(memcmp(sw_record, hw_record, length + tag) == 0);
+  sealed = fake;
+
+  if (in_place)
+  {
+    TEST_ASSERT(aes_run(hw, aes_hw_metadata, NX_CRYPTO_DECRYPT, length, hw_record, hw_record) ==
+                NX_CRYPTO_SUCCESS);
+    TEST_ASSERT(memcmp(hw_record, plain, length) == 0);
+  }
+  else
+  {
+    TEST_ASSERT(aes_run(hw, aes_hw_metadata, NX_CRYPTO_DECRYPT, length, sw_record, opened) == NX_CRYPTO_SUCCESS);
+    TEST_ASSERT(memcmp(opened, plain, length) == 0);
+  }
+
+  // A tag that does not match fails through the peripheral as in software
+  if (tag)
+  {
+    sw_record[length] ^= 1;
+    TEST_ASSERT(aes_run(hw, aes_hw_metadata, NX_CRYPTO_DECRYPT, length, sw_record, opened) != NX_CRYPTO_SUCCESS);
+  }
+
+  TEST_ASSERT(!fake_aes_open);
+
+  return sealed;
+}
+
+static ULONG chunks_of(UINT length)
+{
+  return (length + NX_AZURE_IOT_CRYPTO_HW_AES_CHUNK_BYTES - 1) / NX_AZURE_IOT_CRYPTO_HW_AES_CHUNK_BYTES;
+}
+
+static ULONG blocks_of(UINT length)
+{
+  return (length + NX_CRYPTO_AES_BLOCK_SIZE - 1) / NX_CRYPTO_AES_BLOCK_SIZE;
+}
+
+static VOID gcm_test(VOID)
+{
+  static const UINT lengths[] = {16, 63, 64, 100, 256, 257, 1000, 4101, RECORD_BYTES};
+  FAKE_STATS        calls;
+  UINT              index;
+
+  for (index = 0; index < sizeof(lengths) / sizeof(lengths[0]); index++)
+  {
+    calls = aes_check(&crypto_method_aes_128_gcm_16, &crypto_method_aes_128_gcm_16_hw, lengths[index], index & 1);
+
+    if (lengths[index] < NX_AZURE_IOT_CRYPTO_HW_AES_MIN_BYTES)
+    {
+      TEST_ASSERT((calls.aes_begins == 0) && (calls.aes_chunks == 0) && (calls.aes_blocks == 0));
+      continue;
+    }
+
+    // Every counter block in chunks, the partial last block included, GHASH in software
+    TEST_ASSERT(calls.aes_begins == 1);
+    TEST_ASSERT(calls.aes_chunks == chunks_of(lengths[index]));
+    TEST_ASSERT(calls.aes_chunk_bytes == blocks_of(lengths[index]) * NX_CRYPTO_AES_BLOCK_SIZE);
+    TEST_ASSERT(calls.aes_blocks == 0);
+  }
+}
+
+static VOID cbc_test(VOID)
+{
+  static const UINT lengths[] = {16, 48, 64, 80, 256, 272, 1008, 4096, RECORD_BYTES};
+  FAKE_STATS        calls;
+  FAKE_STATS        opened_calls;
+  UINT              index;
+  UINT              length;
+
+  for (index = 0; index < sizeof(lengths) / sizeof(lengths[0]); index++)
+  {
+    length = lengths[index];
+    calls = aes_check(&crypto_method_aes_cbc_128, &crypto_method_aes_cbc_128_hw, length, index & 1);
+
+    if (length < NX_AZURE_IOT_CRYPTO_HW_AES_MIN_BYTES)
+    {
+      TEST_ASSERT((calls.aes_begins == 0) && (calls.aes_chunks == 0) && (calls.aes_blocks == 0));
+      continue;
+    }
+
+    // Encryption chains on the previous output, one block per call
+    TEST_ASSERT(calls.aes_begins == 1);
+    TEST_ASSERT(calls.aes_chunks == 0);
+    TEST_ASSERT(calls.aes_blocks == blocks_of(length));
+
+    // Decryption in chunks
+    memset(&fake, 0, sizeof(fake));
+    TEST_ASSERT(aes_run(&crypto_method_aes_cbc_128_hw, aes_hw_metadata, NX_CRYPTO_DECRYPT, length, sw_record,
+                    opened) == NX_CRYPTO_SUCCESS);
+    opened_calls = fake;
+    TEST_ASSERT(memcmp(opened, plain, length) == 0);
+    TEST_ASSERT(opened_calls.aes_chunks == chunks_of(length));
+    TEST_ASSERT(opened_calls.aes_chunk_bytes == length);
+    TEST_ASSERT(opened_calls.aes_blocks == 0);
+  }
+}
+
+/* The chunks fail, or the driver has none: the blocks go one at a time, the records stay the same. */
+static VOID chunk_fallback_test(VOID)
+{
+  FAKE_STATS calls;
+  UINT       length = 1000;
+
+  fake_chunk_fail = NX_CRYPTO_TRUE;
+  calls = aes_check(&crypto_method_aes_128_gcm_16, &crypto_method_aes_128_gcm_16_hw, length, NX_CRYPTO_FALSE);
+  TEST_ASSERT((calls.aes_chunks == 0) && (calls.aes_blocks == blocks_of(length)));
+
+  memset(&fake, 0, sizeof(fake));
+  aes_check(&crypto_method_aes_cbc_128, &crypto_method_aes_cbc_128_hw, 1008, NX_CRYPTO_TRUE);
+  TEST_ASSERT(fake.aes_chunks == 0);
+  fake_chunk_fail = NX_CRYPTO_FALSE;
+
+  nx_azure_iot_crypto_hw_driver_set(&fake_driver_no_chunk);
+  calls = aes_check(&crypto_method_aes_128_gcm_16, &crypto_method_aes_128_gcm_16_hw, length, NX_CRYPTO_TRUE);
+  TEST_ASSERT((calls.aes_begins == 1) && (calls.aes_blocks == blocks_of(length)));
+  nx_azure_iot_crypto_hw_driver_set(&fake_driver);
+}
+
+/* The peripheral is taken by another thread: the update runs in software. */
+static VOID busy_test(VOID)
+{
+  FAKE_STATS calls;
+
+  fake_busy = NX_CRYPTO_TRUE;
+  calls = aes_check(&crypto_method_aes_128_gcm_16, &crypto_method_aes_128_gcm_16_hw, 4101, NX_CRYPTO_FALSE);
+  TEST_ASSERT((calls.aes_begins == 0) && (calls.aes_chunks == 0) && (calls.aes_blocks == 0));
+  calls = aes_check(&crypto_method_aes_cbc_128, &crypto_method_aes_cbc_128_hw, 4096, NX_CRYPTO_FALSE);
+  TEST_ASSERT((calls.aes_begins == 0) && (calls.aes_chunks == 0) && (calls.aes_blocks == 0));
+  fake_busy = NX_CRYPTO_FALSE;
+
+  // Without a driver, the methods are the software ones
+  nx_azure_iot_crypto_hw_driver_set(NX_CRYPTO_NULL);
+  calls = aes_check(&crypto_method_aes_128_gcm_16, &crypto_method_aes_128_gcm_16_hw, 4101, NX_CRYPTO_TRUE);
+  TEST_ASSERT(calls.aes_begins == 0);
+  nx_azure_iot_crypto_hw_driver_set(&fake_driver);
+}
+
+static UINT hash_run(NX_CRYPTO_METHOD* method, UINT streamed, UCHAR* input, UINT length, UCHAR* digest)
+{
+  UINT   hmac = (method->nx_crypto_algorithm == NX_CRYPTO_AUTHENTICATION_HMAC_SHA2_256);
+  UCHAR* key_ptr = hmac ? (UCHAR*)key : NX_CRYPTO_NULL;
+  UINT   key_bits = hmac ? sizeof(key) << 3 : 0;
+  VOID*  handle = NX_CRYPTO_NULL;
+  UINT   status;
+
+  memset(hash_metadata, 0, sizeof(hash_metadata));
+  if ((status = method->nx_crypto_init(method, key_ptr, key_bits, &handle, hash_metadata, sizeof(hash_metadata))))
+  {
+    return status;
+  }
+
+  if (!streamed)
+  {
+    return method->nx_crypto_operation(NX_CRYPTO_AUTHENTICATE, handle, method, key_ptr, key_bits, input, length,
+        NX_CRYPTO_NULL, digest, 32, hash_metadata, sizeof(hash_metadata), NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  }
+
+  // The handshake hash: two updates, then the digest
+  if ((status = method->nx_crypto_operation(NX_CRYPTO_HASH_INITIALIZE, handle, method, key_ptr, key_bits,
+           NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0, hash_metadata, sizeof(hash_metadata),
+           NX_CRYPTO_NULL, NX_CRYPTO_NULL)) ||
+      (status = method->nx_crypto_operation(NX_CRYPTO_HASH_UPDATE, handle, method, key_ptr, key_bits, input,
+           length / 2, NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0, hash_metadata, sizeof(hash_metadata), NX_CRYPTO_NULL,
+           NX_CRYPTO_NULL)) ||
+      (status = method->nx_crypto_operation(NX_CRYPTO_HASH_UPDATE, handle, method, key_ptr, key_bits,
+           input + length / 2, length - length / 2, NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0, hash_metadata,
+           sizeof(hash_metadata), NX_CRYPTO_NULL, NX_CRYPTO_NULL)))
+  {
+    return status;
+  }
+
+  return method->nx_crypto_operation(NX_CRYPTO_HASH_CALCULATE, handle, method, key_ptr, key_bits, NX_CRYPTO_NULL, 0,
+      NX_CRYPTO_NULL, digest, 32, hash_metadata, sizeof(hash_metadata), NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+}
+
+static VOID hash_check(NX_CRYPTO_METHOD* sw, NX_CRYPTO_METHOD* hw, ULONG* offloaded)
+{
+  UCHAR sw_digest[32];
+  UCHAR hw_digest[32];
+  UINT  streamed;
+
+  for (streamed = 0; streamed < 2; streamed++)
+  {
+    TEST_ASSERT(hash_run(sw, streamed, plain, 1000, sw_digest) == NX_CRYPTO_SUCCESS);
+
+    *offloaded = 0;
+    TEST_ASSERT(hash_run(hw, streamed, plain, 1000, hw_digest) == NX_CRYPTO_SUCCESS);
+    TEST_ASSERT(memcmp(sw_digest, hw_digest, sizeof(sw_digest)) == 0);
+    TEST_ASSERT(*offloaded == !streamed);
+  }
+
+  // Busy, the one shot digest in software
+  fake_busy = NX_CRYPTO_TRUE;
+  TEST_ASSERT(hash_run(hw, NX_CRYPTO_FALSE, plain, 1000, hw_digest) == NX_CRYPTO_SUCCESS);
+  TEST_ASSERT(memcmp(sw_digest, hw_digest, sizeof(sw_digest)) == 0);
+  fake_busy = NX_CRYPTO_FALSE;
+}
+
+static VOID ecdh_party(NX_CRYPTO_METHOD* curve, ULONG* metadata, UCHAR* public_key, ULONG* public_length)
+{
+  NX_CRYPTO_EXTENDED_OUTPUT output;
+  VOID*                     handle = NX_CRYPTO_NULL;
+
+  memset(metadata, 0, sizeof(NX_CRYPTO_ECDH));
+  TEST_ASSERT(crypto_method_ecdh.nx_crypto_init(&crypto_method_ecdh, NX_CRYPTO_NULL, 0, &handle, metadata,
+                  sizeof(NX_CRYPTO_ECDH)) == NX_CRYPTO_SUCCESS);
+  TEST_ASSERT(crypto_method_ecdh.nx_crypto_operation(NX_CRYPTO_EC_CURVE_SET, handle, &crypto_method_ecdh,
+                  NX_CRYPTO_NULL, 0, (UCHAR*)curve, sizeof(NX_CRYPTO_METHOD*), NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0,
+                  metadata, sizeof(NX_CRYPTO_ECDH), NX_CRYPTO_NULL, NX_CRYPTO_NULL) == NX_CRYPTO_SUCCESS);
+
+  output.nx_crypto_extended_output_data = public_key;
+  output.nx_crypto_extended_output_length_in_byte = 1 + 2 * NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES;
+  TEST_ASSERT(crypto_method_ecdh.nx_crypto_operation(NX_CRYPTO_DH_SETUP, handle, &crypto_method_ecdh,
+                  NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, (UCHAR*)&output, sizeof(output), metadata,
+                  sizeof(NX_CRYPTO_ECDH), NX_CRYPTO_NULL, NX_CRYPTO_NULL) == NX_CRYPTO_SUCCESS);
+  *public_length = output.nx_crypto_extended_output_actual_size;
+}
+
+static ULONG ecdh_secret(ULONG* metadata, UCHAR* remote_key, ULONG remote_length, UCHAR* secret)
+{
+  NX_CRYPTO_EXTENDED_OUTPUT output;
+
+  output.nx_crypto_extended_output_data = secret;
+  output.nx_crypto_extended_output_length_in_byte = NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES;
+  TEST_ASSERT(crypto_method_ecdh.nx_crypto_operation(NX_CRYPTO_DH_CALCULATE, NX_CRYPTO_NULL, &crypto_method_ecdh,
+                  NX_CRYPTO_NULL, 0, remote_key, remote_length, NX_CRYPTO_NULL, (UCHAR*)&output, sizeof(output),
+                  metadata, sizeof(NX_CRYPTO_ECDH), NX_CRYPTO_NULL, NX_CRYPTO_NULL) == NX_CRYPTO_SUCCESS);
+
+  return output.nx_crypto_extended_output_actual_size;
+}
+
+/* The device through the PKA, the server in software. */
+static VOID ecdh_check(NX_CRYPTO_METHOD* sw, NX_CRYPTO_METHOD* hw)
+{
+  UCHAR device_key[1 + 2 * NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES];
+  UCHAR server_key[1 + 2 * NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES];
+  UCHAR device_secret[NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES];
+  UCHAR server_secret[NX_AZURE_IOT_CRYPTO_HW_ECC_MAX_BYTES];
+  ULONG device_length;
+  ULONG server_length;
+  ULONG secret_length;
+
+  memset(&fake, 0, sizeof(fake));
+  ecdh_party(hw, ecdh_hw_metadata, device_key, &device_length);
+  ecdh_party(sw, ecdh_sw_metadata, server_key, &server_length);
+  TEST_ASSERT(fake.ecc_multiply == 1);
+
+  secret_length = ecdh_secret(ecdh_hw_metadata, server_key, server_length, device_secret);
+  TEST_ASSERT(fake.ecc_multiply == 2);
+  TEST_ASSERT(ecdh_secret(ecdh_sw_metadata, device_key, device_length, server_secret) == secret_length);
+  TEST_ASSERT(fake.ecc_multiply == 2);
+  TEST_ASSERT(memcmp(device_secret, server_secret, secret_length) == 0);
+
+  // Busy, the multiplication in software
+  fake_busy = NX_CRYPTO_TRUE;
+  TEST_ASSERT(ecdh_secret(ecdh_hw_metadata, server_key, server_length, server_secret) == secret_length);
+  TEST_ASSERT(memcmp(device_secret, server_secret, secret_length) == 0);
+  TEST_ASSERT(fake.ecc_multiply == 2);
+  fake_busy = NX_CRYPTO_FALSE;
+}
+
+static ULONG64 host_ns(VOID)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (ULONG64)now.tv_sec * 1000000000u + (ULONG64)now.tv_nsec;
+}
+
+/* BENCH_RECORDS 16 KB GCM records, the host time of one and the driver calls. */
+static VOID record_bench(const CHAR* name, const NX_AZURE_IOT_CRYPTO_HW_DRIVER* driver, NX_CRYPTO_METHOD* method)
+{
+  ULONG64 start;
+  ULONG64 elapsed;
+  UINT    index;
+
+  nx_azure_iot_crypto_hw_driver_set(driver);
+  memset(&fake, 0, sizeof(fake));
+
+  start = host_ns();
+  for (index = 0; index < BENCH_RECORDS; index++)
+  {
+    TEST_ASSERT(aes_run(method, aes_hw_metadata, NX_CRYPTO_ENCRYPT, RECORD_BYTES, plain, hw_record) ==
+                NX_CRYPTO_SUCCESS);
+  }
+  elapsed = host_ns() - start;
+
+  test_result("crypto_hw",
+      "\"driver\":\"%s\",\"record_bytes\":%u,\"aes_begins\":%lu,\"aes_blocks\":%lu,\"aes_chunks\":%lu,"
+      "\"driver_calls\":%lu,\"host_us\":%.1f",
+      name,
+      RECORD_BYTES,
+      fake.aes_begins / BENCH_RECORDS,
+      fake.aes_blocks / BENCH_RECORDS,
+      fake.aes_chunks / BENCH_RECORDS,
+      (fake.aes_begins + fake.aes_blocks + fake.aes_chunks) / BENCH_RECORDS,
+      (double)elapsed / BENCH_RECORDS / 1000.0);
+}
+
+static VOID test_entry(ULONG input)
+{
+  UINT index;
+
+  (void)input;
+
+  for (index = 0; index < sizeof(plain); index++)
+  {
+    plain[index] = (UCHAR)(index * 7 + (index >> 8));
+  }
+
+  nx_azure_iot_crypto_hw_driver_set(&fake_driver);
+
+  gcm_test();
+  cbc_test();
+  chunk_fallback_test();
+  busy_test();
+
+  hash_check(&crypto_method_sha256, &crypto_method_sha256_hw, &fake.sha256);
+  hash_check(&crypto_method_hmac_sha256, &crypto_method_hmac_sha256_hw, &fake.hmac_sha256);
+
+  ecdh_check(&crypto_method_ec_secp256, &crypto_method_ec_secp256_hw);
+  ecdh_check(&crypto_method_ec_secp384, &crypto_method_ec_secp384_hw);
+
+  // One transfer per chunk against one per block, the same 16 KB record
+  record_bench("software", NX_CRYPTO_NULL, &crypto_method_aes_128_gcm_16);
+  record_bench("block", &fake_driver_no_chunk, &crypto_method_aes_128_gcm_16_hw);
+  record_bench("chunk", &fake_driver, &crypto_method_aes_128_gcm_16_hw);
+  TEST_ASSERT(fake.aes_chunks == BENCH_RECORDS * chunks_of(RECORD_BYTES));
+
+  nx_azure_iot_crypto_hw_driver_set(NX_CRYPTO_NULL);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100);
+}
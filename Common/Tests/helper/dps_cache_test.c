@@ -0,0 +1,286 @@
+/**
+  ******************************************************************************
+  * @file    dps_cache_test.c
+  * @brief   DPS cache of the helper on a RAM storage, load and invalidation
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The board helper, nx_azure_iot_client.c, keeps the hub assigned by DPS in a
+   record its storage callbacks read and write, here a RAM copy standing for
+   the flash of the apps. The record is checked through
+   nx_azure_iot_client_endpoint_get, which gives the cached hub or else the DPS
+   endpoint: a storage read failing, a wrong magic, a bad checksum, lengths out
+   of range and a record of another registration are all refused. Then the
+   helper runs with DPS on a valid record: it must connect to the broker, the
+   hub, without provisioning. The broker drops the connection, a communication
+   failure keeps the cache. The broker then refuses the CONNECT as not
+   authorized: the helper must erase the record and go back to DPS. */
+
+#include "nx_host_link.h"
+#include "test_broker.h"
+#include "test_common.h"
+#include "test_dns.h"
+#include "test_helper.h"
+
+#define TEST_PRIORITY       12
+#define HELPER_PRIORITY     10
+#define DEVICE_PACKETS      64
+#define BROKER_PACKETS      64
+#define DNS_PACKETS         16
+
+/* The link: 50 ms one way, 2 Mbit/s. */
+#define LINK_DELAY          5
+#define LINK_RATE           2500
+#define LINK_QUEUE          (64 * 1024)
+
+/* DPS_ENDPOINT of the helper. */
+#define DPS_ENDPOINT        "global.azure-devices-provisioning.net"
+
+/* Return code of a CONNACK refusing the client, MQTT 3.1.1. */
+#define CONNACK_NOT_AUTHORIZED  5
+
+#define FNV_OFFSET          2166136261UL
+#define FNV_PRIME           16777619UL
+
+static TEST_NET_HOST device;
+static TEST_BROKER   broker;
+static TEST_DNS      dns;
+static TEST_HELPER   helper;
+static TX_THREAD     test_thread;
+static ULONG64       test_stack[16384 / sizeof(ULONG64)];
+
+/* The storage: a record, and whether reading it succeeds. */
+static AZURE_IOT_DPS_CACHE storage;
+static UINT                storage_readable;
+static ULONG               storage_reads;
+static ULONG               storage_writes;
+
+static UINT dps_cache_read(AZURE_IOT_DPS_CACHE* cache)
+{
+  storage_reads++;
+  if (!storage_readable)
+  {
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  memcpy(cache, &storage, sizeof(storage));
+
+  return NX_SUCCESS;
+}
+
+static UINT dps_cache_write(const AZURE_IOT_DPS_CACHE* cache)
+{
+  storage_writes++;
+  memcpy(&storage, cache, sizeof(storage));
+  storage_readable = NX_TRUE;
+
+  return NX_SUCCESS;
+}
+
+/* FNV-1a, as the helper seals its record. */
+static ULONG hash(ULONG value, const VOID* data, UINT length)
+{
+  const UCHAR* bytes = (const UCHAR*)data;
+
+  while (length--)
+  {
+    value = (value ^ *bytes++) * FNV_PRIME;
+  }
+
+  return value;
+}
+
+static VOID record_seal(AZURE_IOT_DPS_CACHE* cache)
+{
+  cache->checksum = hash(FNV_OFFSET, cache, offsetof(AZURE_IOT_DPS_CACHE, checksum));
+}
+
+/* The record of the broker as hub for a registration, sealed. */
+static VOID record_build(AZURE_IOT_DPS_CACHE* cache, const CHAR* registration_id)
+{
+  memset(cache, 0, sizeof(*cache));
+  cache->magic = AZURE_IOT_DPS_CACHE_MAGIC;
+  cache->config_hash = hash(FNV_OFFSET, TEST_HELPER_DPS_ID_SCOPE, sizeof(TEST_HELPER_DPS_ID_SCOPE) - 1);
+  cache->config_hash = hash(cache->config_hash, "/", 1);
+  cache->config_hash = hash(cache->config_hash, registration_id, strlen(registration_id));
+  cache->hub_hostname_length = sizeof(TEST_HUB_HOSTNAME) - 1;
+  memcpy(cache->hub_hostname, TEST_HUB_HOSTNAME, cache->hub_hostname_length);
+  cache->hub_device_id_length = sizeof(TEST_HUB_DEVICE_ID) - 1;
+  memcpy(cache->hub_device_id, TEST_HUB_DEVICE_ID, cache->hub_device_id_length);
+  record_seal(cache);
+}
+
+/* Whether the helper takes the stored record: the endpoint is the cached hub. */
+static UINT record_accepted(VOID)
+{
+  CHAR hostname[AZURE_IOT_HOST_NAME_SIZE];
+
+  TEST_ASSERT(nx_azure_iot_client_endpoint_get(&helper.context, hostname, sizeof(hostname)) == NX_SUCCESS);
+  if (strcmp(hostname, TEST_HUB_HOSTNAME) == 0)
+  {
+    return NX_TRUE;
+  }
+
+  TEST_ASSERT(strcmp(hostname, DPS_ENDPOINT) == 0);
+
+  return NX_FALSE;
+}
+
+static VOID load_check(VOID)
+{
+  AZURE_IOT_DPS_CACHE valid;
+
+  /* nx_azure_iot_client_dps_run keeps the registration before it runs. */
+  helper.context.azure_iot_dps_id_scope = (CHAR*)TEST_HELPER_DPS_ID_SCOPE;
+  helper.context.azure_iot_dps_id_scope_length = sizeof(TEST_HELPER_DPS_ID_SCOPE) - 1;
+  helper.context.azure_iot_dps_registration_id = (CHAR*)TEST_HELPER_DPS_REGISTRATION_ID;
+  helper.context.azure_iot_dps_registration_id_length = sizeof(TEST_HELPER_DPS_REGISTRATION_ID) - 1;
+
+  record_build(&valid, TEST_HELPER_DPS_REGISTRATION_ID);
+
+  /* Nothing stored, the storage read fails. */
+  storage_readable = NX_FALSE;
+  TEST_ASSERT(!record_accepted());
+  TEST_ASSERT(storage_reads == 1);
+
+  storage = valid;
+  storage_readable = NX_TRUE;
+  TEST_ASSERT(record_accepted());
+  TEST_ASSERT((helper.context.azure_iot_hub_hostname_length == sizeof(TEST_HUB_HOSTNAME) - 1) &&
+              !memcmp(helper.context.azure_iot_hub_hostname, TEST_HUB_HOSTNAME, sizeof(TEST_HUB_HOSTNAME) - 1));
+  TEST_ASSERT((helper.context.azure_iot_hub_device_id_length == sizeof(TEST_HUB_DEVICE_ID) - 1) &&
+              !memcmp(helper.context.azure_iot_hub_device_id, TEST_HUB_DEVICE_ID, sizeof(TEST_HUB_DEVICE_ID) - 1));
+
+  /* Erased, as after an invalidation. */
+  memset(&storage, 0, sizeof(storage));
+  TEST_ASSERT(!record_accepted());
+
+  /* Torn write: a byte of the hub name changed after the record was sealed. */
+  storage = valid;
+  storage.hub_hostname[0] ^= 0x20;
+  TEST_ASSERT(!record_accepted());
+
+  storage = valid;
+  storage.checksum ^= 1;
+  TEST_ASSERT(!record_accepted());
+
+  storage = valid;
+  storage.magic = ~AZURE_IOT_DPS_CACHE_MAGIC;
+  record_seal(&storage);
+  TEST_ASSERT(!record_accepted());
+
+  /* Sealed, but the lengths do not fit the buffers. */
+  storage = valid;
+  storage.hub_hostname_length = sizeof(storage.hub_hostname) + 1;
+  record_seal(&storage);
+  TEST_ASSERT(!record_accepted());
+
+  storage = valid;
+  storage.hub_device_id_length = 0;
+  record_seal(&storage);
+  TEST_ASSERT(!record_accepted());
+
+  /* Stale: the device was registered again under another id. */
+  record_build(&storage, "other-device");
+  TEST_ASSERT(!record_accepted());
+
+  /* Loading never writes the storage. */
+  TEST_ASSERT(storage_writes == 0);
+
+  storage = valid;
+  TEST_ASSERT(record_accepted());
+}
+
+static VOID test_entry(ULONG input)
+{
+  ULONG connects;
+
+  (void)input;
+
+  test_log_mute();
+  nx_host_link_configure(LINK_DELAY, LINK_RATE, LINK_QUEUE);
+  nx_secure_tls_initialize();
+  TEST_ASSERT(test_broker_create(&broker, TEST_NET_ADDRESS(1), BROKER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_create(&dns, TEST_NET_ADDRESS(3), DNS_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_record_add(&dns, TEST_HUB_HOSTNAME, TEST_NET_ADDRESS(1)) == NX_SUCCESS);
+  TEST_ASSERT(test_net_host_create(&device, "Device", TEST_NET_ADDRESS(2), DEVICE_PACKETS) == NX_SUCCESS);
+
+  TEST_ASSERT(test_helper_create(&helper, &device, TEST_NET_ADDRESS(3)) == NX_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_client_register_dps_cache(&helper.context, dps_cache_read, NX_NULL) == NX_PTR_ERROR);
+  TEST_ASSERT(nx_azure_iot_client_register_dps_cache(&helper.context, dps_cache_read, dps_cache_write) ==
+              NX_SUCCESS);
+
+  load_check();
+
+  /* Warm boot: the hub of the record, no DPS answers. */
+  TEST_ASSERT(test_helper_dps_start(&helper, HELPER_PRIORITY) == TX_SUCCESS);
+  test_helper_connected_wait(&helper);
+  TEST_ASSERT(helper.context.dps_cache_used);
+  TEST_ASSERT(broker.stats.connects == 1);
+  TEST_ASSERT(storage_writes == 0);
+
+  /* The hub goes away and comes back, the assignment still holds. */
+  connects = broker.stats.connects;
+  test_broker_drop(&broker);
+  while (broker.stats.connects == connects)
+  {
+    tx_thread_sleep(NX_IP_PERIODIC_RATE / 10);
+  }
+  test_helper_connected_wait(&helper);
+  TEST_ASSERT(helper.context.dps_cache_used);
+  TEST_ASSERT(storage_writes == 0);
+  TEST_ASSERT(record_accepted());
+
+  /* The hub no longer knows the device: the record is erased and the
+     helper provisions again, which cannot succeed here. */
+  broker.connack_code = CONNACK_NOT_AUTHORIZED;
+  test_broker_drop(&broker);
+  while (helper.context.dps_cache_used)
+  {
+    tx_thread_sleep(NX_IP_PERIODIC_RATE / 10);
+  }
+  TEST_ASSERT(storage_writes == 1);
+  TEST_ASSERT(storage.magic != AZURE_IOT_DPS_CACHE_MAGIC);
+  TEST_ASSERT(!record_accepted());
+
+  /* The next attempts go to DPS, never to the hub of the erased record. */
+  connects = broker.stats.connects;
+  tx_thread_sleep(60 * NX_IP_PERIODIC_RATE);
+  TEST_ASSERT(broker.stats.connects == connects);
+  TEST_ASSERT(helper.context.azure_iot_connection_status != NX_SUCCESS);
+  TEST_ASSERT(storage_writes == 1);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  nx_system_initialize();
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(6000000);
+}
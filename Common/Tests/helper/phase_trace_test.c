@@ -0,0 +1,270 @@
+/**
+  ******************************************************************************
+  * @file    phase_trace_test.c
+  * @brief   Connection phase trace against a scripted server
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The board helper connects to the broker over a link with a 120 ms round
+   trip, 50 ms each way and the tick each frame waits for its delivery, and
+   publishes a telemetry sample every second. For each script the DNS
+   responder and the broker are given the delay of their answers, the
+   sessions and the DNS cache are flushed and the broker drops the connection:
+   the helper reconnects through every phase of the trace, DNS resolve, TCP
+   connect, the full TLS handshake with its certificate check, CONNACK, twin
+   GET and the PUBACK of the first sample. The test prints the trace of each
+   script, as nx_azure_iot_trace_append_properties publishes it, and checks
+   the phases: without delays each exchange takes one round trip, two for the
+   twin GET sent once its response topic is subscribed, and each delay adds
+   its own time to its phase only, twice for the handshake where the broker
+   answers two flights.
+
+   Virtual time only moves while every thread waits, so the ticks of the
+   phases hold the network and server times; the CPU time of the device is
+   not in them. The certificate check does not wait, it is timed with the
+   cycle counter, virtual time and host CPU time at the board clock. The
+   signature cache is cleared before each script, so the check verifies the
+   signature of the broker certificate: it must take cycles, less than the
+   handshake around it and less than a second. */
+
+#include "main.h"
+#include "nx_azure_iot_trace.h"
+#include "nx_host_link.h"
+#include "nx_secure_x509.h"
+#include "test_broker.h"
+#include "test_common.h"
+#include "test_dns.h"
+#include "test_helper.h"
+
+#define TEST_PRIORITY       12
+#define HELPER_PRIORITY     10
+#define DEVICE_PACKETS      64
+#define BROKER_PACKETS      64
+#define DNS_PACKETS         16
+
+/* The link: 50 ms one way, 2 Mbit/s. */
+#define LINK_DELAY          5
+#define LINK_RATE           2500
+#define LINK_QUEUE          (64 * 1024)
+
+/* A frame arrives on the tick after the end of its propagation. */
+#define ROUND_TRIP          (2 * (LINK_DELAY + 1))
+#define TELEMETRY_INTERVAL  1
+#define TRACE_JSON_SIZE     512
+
+/* Server delays in ticks. */
+typedef struct PHASE_SCRIPT_STRUCT
+{
+  const CHAR*        name;
+  ULONG              dns_delay;
+  TEST_BROKER_SCRIPT broker;
+} PHASE_SCRIPT;
+
+static const PHASE_SCRIPT scripts[] = {
+    {"baseline", 0, {0, 0, 0, 0}},
+    {"slow_server", 30, {20, 15, 25, 10}},
+    {"slow_handshake", 0, {50, 0, 0, 0}},
+};
+
+static TEST_NET_HOST device;
+static TEST_BROKER   broker;
+static TEST_DNS      dns;
+static TEST_HELPER   helper;
+static TX_THREAD     test_thread;
+static ULONG64       test_stack[16384 / sizeof(ULONG64)];
+static ULONG         baseline[NX_PHASE_COUNT];
+
+static UINT sample_append(NX_AZURE_IOT_JSON_WRITER* json_writer_ptr)
+{
+  return nx_azure_iot_json_writer_append_property_with_int32_value(
+      json_writer_ptr, (UCHAR*)"temperature", sizeof("temperature") - 1, 21);
+}
+
+static VOID telemetry_callback(AZURE_IOT_CONTEXT* context)
+{
+  nx_azure_iot_client_queue_telemetry(context, NX_NULL, sample_append);
+}
+
+/* Each phase the reconnect goes through has completed once. */
+static UINT trace_complete(const AZURE_IOT_PHASE_TRACE* trace_ptr)
+{
+  UINT phase;
+
+  for (phase = NX_PHASE_DNS_RESOLVE; phase <= NX_PHASE_MQTT_PUBACK; phase++)
+  {
+    if (trace_ptr->phase[phase].count == 0)
+    {
+      return NX_FALSE;
+    }
+  }
+
+  return NX_TRUE;
+}
+
+static VOID trace_report(const CHAR* script)
+{
+  UCHAR                    json[TRACE_JSON_SIZE];
+  NX_AZURE_IOT_JSON_WRITER json_writer;
+
+  TEST_ASSERT(nx_azure_iot_json_writer_with_buffer_init(&json_writer, json, sizeof(json)) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_json_writer_append_begin_object(&json_writer) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_trace_append_properties(&json_writer) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_json_writer_append_end_object(&json_writer) == NX_AZURE_IOT_SUCCESS);
+
+  test_result("phase_trace",
+      "\"script\":\"%s\",\"phases_ms\":%.*s,\"cert_verify_cycles\":%lu",
+      script,
+      (INT)nx_azure_iot_json_writer_get_bytes_used(&json_writer),
+      json,
+      nx_azure_iot_trace_get()->phase[NX_PHASE_TLS_CERT_VERIFY].last_cycles);
+}
+
+/* The certificate check took cycles within the handshake, and no tick. */
+static VOID cert_verify_check(const AZURE_IOT_PHASE_TRACE* trace_ptr)
+{
+  ULONG cycles = trace_ptr->phase[NX_PHASE_TLS_CERT_VERIFY].last_cycles;
+
+  TEST_ASSERT(trace_ptr->phase[NX_PHASE_TLS_CERT_VERIFY].last_ticks == 0);
+  TEST_ASSERT(cycles > 0);
+  TEST_ASSERT(cycles < trace_ptr->phase[NX_PHASE_TLS_HANDSHAKE].last_cycles);
+  TEST_ASSERT(cycles < SystemCoreClock);
+}
+
+/* The phase took expected ticks, one more for a frame ending past a tick. */
+static VOID phase_check(const AZURE_IOT_PHASE_TRACE* trace_ptr, UINT phase, ULONG expected)
+{
+  ULONG ticks = trace_ptr->phase[phase].last_ticks;
+
+  TEST_ASSERT((ticks >= expected) && (ticks <= expected + 1));
+}
+
+static VOID script_run(const PHASE_SCRIPT* script_ptr)
+{
+  const AZURE_IOT_PHASE_TRACE* trace_ptr = nx_azure_iot_trace_get();
+  ULONG                        handshake_delay = 2 * script_ptr->broker.handshake_delay;
+  UINT                         phase;
+#ifdef NX_SECURE_X509_VERIFY_CACHE_SIZE
+  ULONG                        misses;
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
+
+  test_broker_script_set(&broker, &script_ptr->broker);
+  test_dns_delay_set(&dns, script_ptr->dns_delay);
+  test_broker_sessions_flush(&broker);
+  TEST_ASSERT(test_helper_dns_flush(&helper) == NX_SUCCESS);
+#ifdef NX_SECURE_X509_VERIFY_CACHE_SIZE
+  _nx_secure_x509_verify_cache_clear();
+  misses = _nx_secure_x509_verify_cache_misses;
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
+
+  /* Drop between two samples, the PUBACK traced is the one of the new connection. */
+  while (trace_ptr->phase[NX_PHASE_MQTT_PUBACK].active)
+  {
+    tx_thread_sleep(1);
+  }
+  nx_azure_iot_trace_reset();
+  test_broker_drop(&broker);
+
+  while (!trace_complete(trace_ptr))
+  {
+    tx_thread_sleep(1);
+  }
+
+  trace_report(script_ptr->name);
+  cert_verify_check(trace_ptr);
+#ifdef NX_SECURE_X509_VERIFY_CACHE_SIZE
+  TEST_ASSERT(_nx_secure_x509_verify_cache_misses > misses);
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
+
+  if (script_ptr == &scripts[0])
+  {
+    phase_check(trace_ptr, NX_PHASE_DNS_RESOLVE, ROUND_TRIP);
+    phase_check(trace_ptr, NX_PHASE_TCP_CONNECT, ROUND_TRIP);
+    phase_check(trace_ptr, NX_PHASE_MQTT_CONNACK, ROUND_TRIP);
+
+    /* The request waits for the SUBACK of the twin response topic. */
+    phase_check(trace_ptr, NX_PHASE_TWIN_GET, 2 * ROUND_TRIP);
+    phase_check(trace_ptr, NX_PHASE_MQTT_PUBACK, ROUND_TRIP);
+
+    /* Two round trips and the time to send the certificates. */
+    TEST_ASSERT(trace_ptr->phase[NX_PHASE_TLS_HANDSHAKE].last_ticks >= 2 * ROUND_TRIP);
+
+    for (phase = 0; phase < NX_PHASE_COUNT; phase++)
+    {
+      baseline[phase] = trace_ptr->phase[phase].last_ticks;
+    }
+    return;
+  }
+
+  phase_check(trace_ptr, NX_PHASE_DNS_RESOLVE, baseline[NX_PHASE_DNS_RESOLVE] + script_ptr->dns_delay);
+  phase_check(trace_ptr, NX_PHASE_TCP_CONNECT, baseline[NX_PHASE_TCP_CONNECT]);
+  phase_check(trace_ptr, NX_PHASE_TLS_HANDSHAKE, baseline[NX_PHASE_TLS_HANDSHAKE] + handshake_delay);
+  phase_check(trace_ptr, NX_PHASE_MQTT_CONNACK, baseline[NX_PHASE_MQTT_CONNACK] + script_ptr->broker.connack_delay);
+  phase_check(trace_ptr, NX_PHASE_TWIN_GET, baseline[NX_PHASE_TWIN_GET] + script_ptr->broker.twin_delay);
+  phase_check(trace_ptr, NX_PHASE_MQTT_PUBACK, baseline[NX_PHASE_MQTT_PUBACK] + script_ptr->broker.puback_delay);
+}
+
+static VOID test_entry(ULONG input)
+{
+  UINT i;
+
+  (void)input;
+
+  test_log_mute();
+  nx_host_link_configure(LINK_DELAY, LINK_RATE, LINK_QUEUE);
+  nx_secure_tls_initialize();
+  TEST_ASSERT(test_broker_create(&broker, TEST_NET_ADDRESS(1), BROKER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_create(&dns, TEST_NET_ADDRESS(3), DNS_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_record_add(&dns, TEST_HUB_HOSTNAME, TEST_NET_ADDRESS(1)) == NX_SUCCESS);
+  TEST_ASSERT(test_net_host_create(&device, "Device", TEST_NET_ADDRESS(2), DEVICE_PACKETS) == NX_SUCCESS);
+
+  TEST_ASSERT(test_helper_create(&helper, &device, TEST_NET_ADDRESS(3)) == NX_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_client_register_timer_callback(&helper.context, telemetry_callback, TELEMETRY_INTERVAL) ==
+              NX_SUCCESS);
+  TEST_ASSERT(test_helper_start(&helper, HELPER_PRIORITY) == TX_SUCCESS);
+
+  /* The helper sees its first connect through, a drop before would be retried after a backoff. */
+  test_helper_connected_wait(&helper);
+  while (!trace_complete(nx_azure_iot_trace_get()))
+  {
+    tx_thread_sleep(1);
+  }
+
+  for (i = 0; i < sizeof(scripts) / sizeof(scripts[0]); i++)
+  {
+    script_run(&scripts[i]);
+  }
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  nx_system_initialize();
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100000);
+}
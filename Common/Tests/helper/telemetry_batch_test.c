@@ -0,0 +1,286 @@
+/**
+  ******************************************************************************
+  * @file    telemetry_batch_test.c
+  * @brief   Telemetry messages and bytes on the wire, batched and per sample
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The board helper, nx_azure_iot_client.c, runs the IoT Hub client against
+   the broker and queues a telemetry sample from its timer callback every
+   TELEMETRY_INTERVAL seconds, as app_azure_iot.c does. SAMPLES samples go out
+   one message each, batching off, then SAMPLES more with the batch thresholds
+   of the board. For both the test reports the messages per second, and per
+   sample the MQTT payload bytes, the TLS bytes, the IP bytes on the link and
+   the device CPU time. Each sample carries a sequence number: the broker
+   checks every sample arrives, once. Last, the broker drops the connection
+   while samples are batched, they must go out after the reconnect. */
+
+#include "nx_host_link.h"
+#include "test_broker.h"
+#include "test_common.h"
+#include "test_dns.h"
+#include "test_helper.h"
+
+#define TEST_PRIORITY       12
+#define HELPER_PRIORITY     10
+#define DEVICE_PACKETS      64
+#define BROKER_PACKETS      64
+#define DNS_PACKETS         16
+
+/* The link: 50 ms one way, 2 Mbit/s. */
+#define LINK_DELAY          5
+#define LINK_RATE           2500
+#define LINK_QUEUE          (64 * 1024)
+
+/* telemetry_interval and TELEMETRY_BATCH_* of app_azure_iot.c. */
+#define TELEMETRY_INTERVAL  10
+#define BATCH_MAX_SAMPLES   6
+#define BATCH_MAX_BYTES     1024
+#define BATCH_MAX_AGE       60
+
+#define SAMPLES             2000
+#define SAMPLES_MAX         (2 * SAMPLES + 2 * BATCH_MAX_SAMPLES)
+
+#define SAMPLE_SEQUENCE     "seq"
+#define SAMPLE_TEMPERATURE  "temperature"
+#define TELEMETRY_TOPIC     "devices/" TEST_HUB_DEVICE_ID "/messages/events/"
+
+typedef struct PHASE_COUNTERS_STRUCT
+{
+  ULONG   ticks;
+  ULONG   messages;
+  ULONG   publish_bytes;
+  ULONG   tls_bytes;
+  ULONG   ip_bytes;
+  ULONG64 cpu_ns;
+} PHASE_COUNTERS;
+
+static TEST_NET_HOST device;
+static TEST_BROKER   broker;
+static TEST_DNS      dns;
+static TEST_HELPER   helper;
+static TX_THREAD     test_thread;
+static ULONG64       test_stack[16384 / sizeof(ULONG64)];
+
+/* Samples are numbered from 0, the callback queues them up to sample_end. */
+static ULONG sample_next;
+static ULONG sample_end;
+
+/* What the broker received. */
+static UCHAR sample_received[SAMPLES_MAX];
+static ULONG samples_received;
+static ULONG samples_duplicate;
+static ULONG telemetry_messages;
+
+static UINT sample_append(NX_AZURE_IOT_JSON_WRITER* json_writer_ptr)
+{
+  UINT status;
+
+  if ((status = nx_azure_iot_json_writer_append_property_with_int32_value(json_writer_ptr,
+           (UCHAR*)SAMPLE_SEQUENCE,
+           sizeof(SAMPLE_SEQUENCE) - 1,
+           (int32_t)sample_next)) ||
+      (status = nx_azure_iot_json_writer_append_property_with_double_value(json_writer_ptr,
+           (UCHAR*)SAMPLE_TEMPERATURE,
+           sizeof(SAMPLE_TEMPERATURE) - 1,
+           21.5 + (sample_next % 40) / 10.0,
+           2)))
+  {
+    return status;
+  }
+
+  sample_next++;
+
+  return NX_AZURE_IOT_SUCCESS;
+}
+
+static VOID telemetry_callback(AZURE_IOT_CONTEXT* context)
+{
+  if (sample_next < sample_end)
+  {
+    nx_azure_iot_client_queue_telemetry(context, NX_NULL, sample_append);
+  }
+}
+
+/* Mark the sequence numbers of a telemetry payload, one object or an array of them. */
+static VOID publish_notify(
+    TEST_BROKER* broker_ptr, const UCHAR* topic, UINT topic_length, const UCHAR* payload, UINT payload_length)
+{
+  static const CHAR key[] = "\"" SAMPLE_SEQUENCE "\":";
+  UINT              offset;
+  ULONG             sequence;
+
+  (void)broker_ptr;
+
+  if ((topic_length < sizeof(TELEMETRY_TOPIC) - 1) || memcmp(topic, TELEMETRY_TOPIC, sizeof(TELEMETRY_TOPIC) - 1))
+  {
+    return;
+  }
+  telemetry_messages++;
+
+  for (offset = 0; offset + sizeof(key) - 1 < payload_length; offset++)
+  {
+    if (memcmp(&payload[offset], key, sizeof(key) - 1))
+    {
+      continue;
+    }
+
+    for (offset += sizeof(key) - 1, sequence = 0; (offset < payload_length) && (payload[offset] >= '0') &&
+                                                  (payload[offset] <= '9');
+         offset++)
+    {
+      sequence = sequence * 10 + (payload[offset] - '0');
+    }
+
+    TEST_ASSERT(sequence < SAMPLES_MAX);
+    if (sample_received[sequence])
+    {
+      samples_duplicate++;
+    }
+    else
+    {
+      sample_received[sequence] = NX_TRUE;
+      samples_received++;
+    }
+  }
+}
+
+static VOID counters_get(PHASE_COUNTERS* counters_ptr)
+{
+  counters_ptr->ticks = tx_time_get();
+  counters_ptr->messages = telemetry_messages;
+  counters_ptr->publish_bytes = broker.stats.publish_bytes;
+  counters_ptr->tls_bytes = broker.stats.bytes_received + broker.stats.bytes_sent;
+  counters_ptr->ip_bytes = nx_host_link_stats_get(nx_host_link_station_get(&device.ip))->bytes_delivered +
+                           nx_host_link_stats_get(nx_host_link_station_get(&broker.host.ip))->bytes_delivered;
+  counters_ptr->cpu_ns = test_helper_cpu_ns(&helper, &device);
+}
+
+/* Queue count more samples and wait until the broker has every sample. */
+static VOID samples_send(ULONG count)
+{
+  sample_end += count;
+
+  while (samples_received < sample_end)
+  {
+    tx_thread_sleep(NX_IP_PERIODIC_RATE);
+  }
+}
+
+static VOID phase_run(const CHAR* telemetry, UINT max_samples, UINT max_bytes, UINT max_age)
+{
+  PHASE_COUNTERS start;
+  PHASE_COUNTERS end;
+  ULONG          messages;
+  ULONG          seconds;
+
+  TEST_ASSERT(nx_azure_iot_client_telemetry_batch_set(&helper.context, max_samples, max_bytes, max_age) == NX_SUCCESS);
+
+  counters_get(&start);
+  samples_send(SAMPLES);
+  counters_get(&end);
+
+  messages = end.messages - start.messages;
+  seconds = (end.ticks - start.ticks) / NX_IP_PERIODIC_RATE;
+
+  /* A message per sample, or one per full batch and one for the rest. */
+  TEST_ASSERT(samples_duplicate == 0);
+  if (max_samples)
+  {
+    TEST_ASSERT(messages <= (SAMPLES + max_samples - 1) / max_samples);
+  }
+  else
+  {
+    TEST_ASSERT(messages == SAMPLES);
+  }
+
+  test_result("telemetry_batch",
+      "\"telemetry\":\"%s\",\"samples\":%u,\"messages\":%lu,\"messages_per_s\":%.4f,"
+      "\"payload_bytes_per_sample\":%.1f,\"tls_bytes_per_sample\":%.1f,\"ip_bytes_per_sample\":%.1f,"
+      "\"cpu_us_per_sample\":%.1f",
+      telemetry,
+      SAMPLES,
+      messages,
+      (double)messages / seconds,
+      (double)(end.publish_bytes - start.publish_bytes) / SAMPLES,
+      (double)(end.tls_bytes - start.tls_bytes) / SAMPLES,
+      (double)(end.ip_bytes - start.ip_bytes) / SAMPLES,
+      (end.cpu_ns - start.cpu_ns) / 1000.0 / SAMPLES);
+}
+
+static VOID test_entry(ULONG input)
+{
+  ULONG connects;
+
+  (void)input;
+
+  test_log_mute();
+  nx_host_link_configure(LINK_DELAY, LINK_RATE, LINK_QUEUE);
+  nx_secure_tls_initialize();
+  TEST_ASSERT(test_broker_create(&broker, TEST_NET_ADDRESS(1), BROKER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_create(&dns, TEST_NET_ADDRESS(3), DNS_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_record_add(&dns, TEST_HUB_HOSTNAME, TEST_NET_ADDRESS(1)) == NX_SUCCESS);
+  TEST_ASSERT(test_net_host_create(&device, "Device", TEST_NET_ADDRESS(2), DEVICE_PACKETS) == NX_SUCCESS);
+  broker.publish_notify = publish_notify;
+
+  TEST_ASSERT(test_helper_create(&helper, &device, TEST_NET_ADDRESS(3)) == NX_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_client_register_timer_callback(&helper.context, telemetry_callback, TELEMETRY_INTERVAL) ==
+              NX_SUCCESS);
+  TEST_ASSERT(test_helper_start(&helper, HELPER_PRIORITY) == TX_SUCCESS);
+
+  /* The connect and its properties request stay out of the measures. */
+  test_helper_connected_wait(&helper);
+
+  phase_run("per_sample", 0, 0, 0);
+  phase_run("batched", BATCH_MAX_SAMPLES, BATCH_MAX_BYTES, BATCH_MAX_AGE);
+
+  /* Half a batch is queued when the broker goes away. The samples are held
+     while the helper reconnects, and leave with the next full batch. */
+  sample_end += BATCH_MAX_SAMPLES / 2;
+  while (sample_next < sample_end)
+  {
+    tx_thread_sleep(NX_IP_PERIODIC_RATE);
+  }
+  TEST_ASSERT(helper.context.telemetry_batch.count == BATCH_MAX_SAMPLES / 2);
+
+  connects = broker.stats.connects;
+  test_broker_drop(&broker);
+  samples_send(BATCH_MAX_SAMPLES - BATCH_MAX_SAMPLES / 2);
+
+  TEST_ASSERT(broker.stats.connects == connects + 1);
+  TEST_ASSERT((samples_received == sample_end) && (samples_duplicate == 0));
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  nx_system_initialize();
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(6000000);
+}
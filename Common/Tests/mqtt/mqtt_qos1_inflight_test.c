@@ -0,0 +1,239 @@
+/**
+  ******************************************************************************
+  * @file    mqtt_qos1_inflight_test.c
+  * @brief   QoS 1 publishes in flight per pool size, table and copy paths
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The broker holds its PUBACKs back while the device publishes QoS 1 messages
+   until a publish fails. A clean session tracks the messages by packet
+   identifier (NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE), a persistent session keeps a
+   copy of each for the DUP republish. For each pool size the test reports the
+   messages in flight, the packets of the pool they hold, the bytes copied per
+   publish, read from the MQTT transmit queue, and the device CPU time of a
+   publish. The PUBACKs are then released. The table path must drain; the copy
+   path only does when the copies left a packet to receive the PUBACKs. */
+
+#include "test_broker.h"
+#include "test_common.h"
+#include "test_tls.h"
+
+#define DEVICE_PRIORITY     10
+#define MQTT_PRIORITY       9
+#define PAYLOAD_SIZE        256
+#define PUBLISH_MAX         64
+#define KEEPALIVE           300
+
+static const UINT pool_sizes[] = {8, 12, 16, 24, 32};
+
+static TEST_NET_HOST   device;
+static TEST_BROKER     broker;
+static NXD_MQTT_CLIENT mqtt;
+static ULONG64         mqtt_stack[8192 / sizeof(ULONG64)];
+static TX_THREAD       device_thread;
+static ULONG64         device_stack[16384 / sizeof(ULONG64)];
+static CHAR            payload[PAYLOAD_SIZE];
+
+static UINT inflight_count(VOID)
+{
+#ifdef NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE
+  return mqtt.message_qos1_inflight_count;
+#else
+  return 0;
+#endif /* NXD_MQTT_QOS1_INFLIGHT_TABLE_SIZE */
+}
+
+static ULONG transmit_queue_bytes(UINT* count)
+{
+  NX_PACKET* packet_ptr;
+  ULONG      bytes = 0;
+
+  *count = 0;
+  for (packet_ptr = mqtt.message_transmit_queue_head; packet_ptr; packet_ptr = packet_ptr->nx_packet_queue_next)
+  {
+    bytes += packet_ptr->nx_packet_length;
+    (*count)++;
+  }
+
+  return bytes;
+}
+
+/* Wait until the broker acknowledged every TCP segment sent, the packets still
+   used are then held by the MQTT session only. The acknowledgment never comes
+   when the device has no packet left to receive it. */
+static UINT tcp_acked_wait(VOID)
+{
+  UINT i;
+
+  for (i = 0; (i < 1000) && mqtt.nxd_mqtt_client_socket.nx_tcp_socket_transmit_sent_count; i++)
+  {
+    tx_thread_sleep(1);
+  }
+
+  return(mqtt.nxd_mqtt_client_socket.nx_tcp_socket_transmit_sent_count == 0);
+}
+
+static VOID run(UINT pool_size, UINT clean_session)
+{
+  NXD_ADDRESS server;
+  ULONG       idle_used;
+  ULONG       used_max = 0;
+  ULONG64     cpu_start;
+  ULONG64     cpu_ns = 0;
+  UINT        published = 0;
+  ULONG       broker_publishes = broker.stats.publishes;
+  UINT        queued;
+  UINT        remaining;
+  UINT        unsent = 0;
+  UINT        drained;
+  ULONG       copied;
+  UINT        status = NXD_MQTT_SUCCESS;
+  UINT        i;
+
+  TEST_ASSERT(test_net_host_create(&device, "Device", TEST_NET_ADDRESS(2), pool_size) == NX_SUCCESS);
+  TEST_ASSERT(nxd_mqtt_client_create(&mqtt,
+                  "MQTT",
+                  "device",
+                  6,
+                  &device.ip,
+                  &device.pool,
+                  mqtt_stack,
+                  sizeof(mqtt_stack),
+                  MQTT_PRIORITY,
+                  NX_NULL,
+                  0) == NXD_MQTT_SUCCESS);
+
+  server.nxd_ip_version = NX_IP_VERSION_V4;
+  server.nxd_ip_address.v4 = TEST_NET_ADDRESS(1);
+  TEST_ASSERT(nxd_mqtt_client_secure_connect(
+                  &mqtt, &server, TEST_BROKER_PORT, test_tls_client_setup, KEEPALIVE, clean_session, NX_WAIT_FOREVER) ==
+              NXD_MQTT_SUCCESS);
+
+  tcp_acked_wait();
+  idle_used = test_net_packets_used(&device);
+
+  test_broker_puback_hold(&broker, NX_TRUE);
+
+  while (published < PUBLISH_MAX)
+  {
+    cpu_start = tx_host_thread_cpu_ns(&device_thread);
+    status = nxd_mqtt_client_publish(&mqtt, "telemetry", 9, payload, PAYLOAD_SIZE, 0, 1, NX_NO_WAIT);
+    cpu_ns += tx_host_thread_cpu_ns(&device_thread) - cpu_start;
+    if (status != NXD_MQTT_SUCCESS)
+    {
+      break;
+    }
+    published++;
+
+    /* Stop with NX_NO_PACKET when the pool cannot take the acknowledgment. */
+    if (!tcp_acked_wait())
+    {
+      status = NX_NO_PACKET;
+      break;
+    }
+    if (test_net_packets_used(&device) > used_max)
+    {
+      used_max = test_net_packets_used(&device);
+    }
+  }
+
+  copied = transmit_queue_bytes(&queued);
+  TEST_ASSERT(published > 0);
+  if (clean_session)
+  {
+    TEST_ASSERT(inflight_count() == published);
+    TEST_ASSERT(queued == 0);
+  }
+  else
+  {
+
+    /* A copy whose send failed stays queued for the republish after a reconnect. */
+    unsent = (status == NXD_MQTT_COMMUNICATION_FAILURE) ? 1 : 0;
+    TEST_ASSERT(queued == published + unsent);
+  }
+  TEST_ASSERT(broker.stats.publishes - broker_publishes == published);
+
+  /* Every message sent is acknowledged once the PUBACKs are released, unless the
+     copies left the pool without a packet to receive them. */
+  test_broker_puback_hold(&broker, NX_FALSE);
+  remaining = queued;
+  for (i = 0; (i < 100) && (inflight_count() || (remaining > unsent)); i++)
+  {
+    tx_thread_sleep(1);
+    transmit_queue_bytes(&remaining);
+  }
+  drained = (inflight_count() == 0) && (remaining == unsent);
+
+  /* The table path holds no packet, it always drains. */
+  TEST_ASSERT(drained || !clean_session);
+
+  test_result("mqtt_qos1_inflight",
+      "\"path\":\"%s\",\"pool_packets\":%u,\"in_flight\":%u,\"stop\":\"0x%02x\",\"packets_held\":%lu,"
+      "\"bytes_copied_per_publish\":%lu,\"cpu_ns_per_publish\":%llu,\"drained\":%s",
+      clean_session ? "table" : "copy",
+      pool_size,
+      published,
+      status,
+      (unsigned long)(used_max - idle_used),
+      (unsigned long)(queued ? copied / queued : 0),
+      cpu_ns / published,
+      drained ? "true" : "false");
+
+  TEST_ASSERT(nxd_mqtt_client_disconnect(&mqtt) == NXD_MQTT_SUCCESS);
+  TEST_ASSERT(nxd_mqtt_client_delete(&mqtt) == NXD_MQTT_SUCCESS);
+
+  /* Let the broker close its side before the device goes away. */
+  tx_thread_sleep(10);
+  TEST_ASSERT(test_net_host_delete(&device) == NX_SUCCESS);
+}
+
+static VOID device_entry(ULONG input)
+{
+  UINT i;
+
+  (void)input;
+
+  memset(payload, 'x', sizeof(payload));
+  nx_secure_tls_initialize();
+  TEST_ASSERT(test_broker_create(&broker, TEST_NET_ADDRESS(1), 64) == NX_SUCCESS);
+
+  for (i = 0; i < sizeof(pool_sizes) / sizeof(pool_sizes[0]); i++)
+  {
+    run(pool_sizes[i], NX_TRUE);
+    run(pool_sizes[i], NX_FALSE);
+  }
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  nx_system_initialize();
+  tx_thread_create(&device_thread,
+      "Device",
+      device_entry,
+      0,
+      device_stack,
+      sizeof(device_stack),
+      DEVICE_PRIORITY,
+      DEVICE_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100000);
+}
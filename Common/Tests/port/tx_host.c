@@ -0,0 +1,342 @@
+/**
+  ******************************************************************************
+  * @file    tx_host.c
+  * @brief   ThreadX port running the kernel in one host process
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* This file implements the port functions the Cortex-M ports write in
+   assembly: low level initialization, stack build, scheduler, system return
+   and timer interrupt. Each thread is a ucontext on a stack of the static
+   tx_host_stacks area. The scheduler runs on the stack of tx_host_run and
+   switches to _tx_thread_execute_ptr; a thread switches back whenever
+   _tx_thread_system_return is called. When no thread is ready, the timer
+   interrupt is taken once, which advances the virtual time by one tick. */
+
+#define TX_SOURCE_CODE
+
+#include <setjmp.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "tx_api.h"
+#include "tx_initialize.h"
+#include "tx_thread.h"
+#include "tx_timer.h"
+#include "tx_host.h"
+
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
+VOID _tx_execution_thread_enter(VOID);
+VOID _tx_execution_thread_exit(VOID);
+VOID _tx_execution_isr_enter(VOID);
+VOID _tx_execution_isr_exit(VOID);
+#endif
+
+typedef struct TX_HOST_CONTEXT_STRUCT
+{
+  ucontext_t context;
+  UINT       used;
+  ULONG64    cpu_ns;
+} TX_HOST_CONTEXT;
+
+static TX_HOST_CONTEXT tx_host_contexts[TX_HOST_MAX_THREADS];
+static ULONG64         tx_host_stacks[TX_HOST_MAX_THREADS][TX_HOST_THREAD_STACK_SIZE / sizeof(ULONG64)];
+
+/* First unused memory handed to tx_application_define. */
+static ULONG64         tx_host_free_memory[1024];
+
+static ucontext_t      tx_host_scheduler_context;
+static jmp_buf         tx_host_exit;
+static ULONG           tx_host_max_ticks;
+static UINT            tx_host_status;
+static UINT            tx_host_stop_requested;
+static ULONG64         tx_host_run_start;
+static ULONG           tx_host_idle;
+static ULONG           tx_host_switch_count;
+static ULONG64         tx_host_isr_ns;
+
+static VOID tx_host_timer_interrupt(VOID);
+static UINT tx_host_timer_active(VOID);
+
+UINT tx_host_run(ULONG max_ticks)
+{
+  tx_host_max_ticks = max_ticks;
+  tx_host_status = TX_HOST_STOPPED;
+  tx_host_stop_requested = TX_FALSE;
+
+  if (setjmp(tx_host_exit) == 0)
+  {
+    _tx_initialize_kernel_enter();
+  }
+
+  return tx_host_status;
+}
+
+VOID tx_host_stop(VOID)
+{
+  TX_THREAD *thread_ptr = _tx_thread_current_ptr;
+
+  tx_host_stop_requested = TX_TRUE;
+  _tx_thread_current_ptr = TX_NULL;
+  swapcontext(&((TX_HOST_CONTEXT *)thread_ptr->tx_thread_host_context)->context, &tx_host_scheduler_context);
+}
+
+ULONG64 tx_host_cpu_ns(VOID)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return (ULONG64)now.tv_sec * 1000000000ULL + (ULONG64)now.tv_nsec;
+}
+
+ULONG tx_host_idle_ticks(VOID)
+{
+  return tx_host_idle;
+}
+
+ULONG tx_host_switches(VOID)
+{
+  return tx_host_switch_count;
+}
+
+ULONG64 tx_host_thread_cpu_ns(TX_THREAD *thread_ptr)
+{
+  TX_HOST_CONTEXT *host_ptr = (TX_HOST_CONTEXT *)thread_ptr->tx_thread_host_context;
+  ULONG64 cpu_ns = 0;
+
+  if (host_ptr != TX_NULL)
+  {
+    cpu_ns = host_ptr->cpu_ns;
+
+    /* Add the time of the current run for the calling thread. */
+    if (thread_ptr == _tx_thread_current_ptr)
+    {
+      cpu_ns += tx_host_cpu_ns() - tx_host_run_start;
+    }
+  }
+
+  return cpu_ns;
+}
+
+ULONG64 tx_host_isr_cpu_ns(VOID)
+{
+  return tx_host_isr_ns;
+}
+
+ULONG64 _tx_host_cycles_get(VOID)
+{
+  /* Virtual time plus the host CPU time, both counted at the board clock. */
+  return (ULONG64)_tx_timer_system_clock * TX_HOST_CYCLES_PER_TICK +
+         tx_host_cpu_ns() * TX_HOST_CYCLES_PER_TICK / (1000000000ULL / TX_TIMER_TICKS_PER_SECOND);
+}
+
+UINT _tx_thread_interrupt_control(UINT new_posture)
+{
+  (void)new_posture;
+  return TX_INT_ENABLE;
+}
+
+VOID _tx_initialize_low_level(VOID)
+{
+  _tx_initialize_unused_memory = (VOID *)tx_host_free_memory;
+}
+
+VOID _tx_thread_stack_build(TX_THREAD *thread_ptr, VOID (*function_ptr)(VOID))
+{
+  TX_HOST_CONTEXT *host_ptr = (TX_HOST_CONTEXT *)thread_ptr->tx_thread_host_context;
+  UINT i;
+
+  if (host_ptr == TX_NULL)
+  {
+    for (i = 0; i < TX_HOST_MAX_THREADS; i++)
+    {
+      if (!tx_host_contexts[i].used)
+      {
+        break;
+      }
+    }
+    if (i == TX_HOST_MAX_THREADS)
+    {
+      abort();
+    }
+    host_ptr = &tx_host_contexts[i];
+    host_ptr->used = TX_TRUE;
+    thread_ptr->tx_thread_host_context = host_ptr;
+  }
+
+  i = (UINT)(host_ptr - tx_host_contexts);
+  host_ptr->cpu_ns = 0;
+  getcontext(&host_ptr->context);
+  host_ptr->context.uc_stack.ss_sp = tx_host_stacks[i];
+  host_ptr->context.uc_stack.ss_size = sizeof(tx_host_stacks[i]);
+  host_ptr->context.uc_link = TX_NULL;
+  makecontext(&host_ptr->context, function_ptr, 0);
+
+  /* The ThreadX stack itself is not used, leave it as filled by create. */
+  thread_ptr->tx_thread_stack_ptr = thread_ptr->tx_thread_stack_end;
+}
+
+VOID _tx_host_thread_delete(TX_THREAD *thread_ptr)
+{
+  TX_HOST_CONTEXT *host_ptr = (TX_HOST_CONTEXT *)thread_ptr->tx_thread_host_context;
+
+  if (host_ptr != TX_NULL)
+  {
+    host_ptr->used = TX_FALSE;
+    thread_ptr->tx_thread_host_context = TX_NULL;
+  }
+}
+
+VOID _tx_thread_system_return(VOID)
+{
+  TX_THREAD *thread_ptr = _tx_thread_current_ptr;
+
+  if (thread_ptr == TX_NULL)
+  {
+    return;
+  }
+
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
+  _tx_execution_thread_exit();
+#endif
+
+  /* Keep the rest of the time-slice, as PendSV does. */
+  if (_tx_timer_time_slice)
+  {
+    thread_ptr->tx_thread_time_slice = _tx_timer_time_slice;
+    _tx_timer_time_slice = 0;
+  }
+
+  _tx_thread_current_ptr = TX_NULL;
+  swapcontext(&((TX_HOST_CONTEXT *)thread_ptr->tx_thread_host_context)->context, &tx_host_scheduler_context);
+}
+
+VOID _tx_thread_schedule(VOID)
+{
+  TX_THREAD *thread_ptr;
+
+  /* Scheduling starts with preemption enabled. */
+  _tx_thread_preempt_disable = 0;
+
+  for (;;)
+  {
+    thread_ptr = _tx_thread_execute_ptr;
+    if (thread_ptr == TX_NULL)
+    {
+      if (_tx_timer_system_clock >= tx_host_max_ticks)
+      {
+        tx_host_status = TX_HOST_TIMED_OUT;
+        longjmp(tx_host_exit, 1);
+      }
+      if (!tx_host_timer_active())
+      {
+        tx_host_status = TX_HOST_DEADLOCK;
+        longjmp(tx_host_exit, 1);
+      }
+
+      tx_host_idle++;
+      tx_host_timer_interrupt();
+      continue;
+    }
+
+    _tx_thread_current_ptr = thread_ptr;
+    thread_ptr->tx_thread_run_count++;
+    _tx_timer_time_slice = thread_ptr->tx_thread_time_slice;
+    tx_host_switch_count++;
+
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
+    _tx_execution_thread_enter();
+#endif
+
+    tx_host_run_start = tx_host_cpu_ns();
+    swapcontext(&tx_host_scheduler_context, &((TX_HOST_CONTEXT *)thread_ptr->tx_thread_host_context)->context);
+    if (thread_ptr->tx_thread_host_context != TX_NULL)
+    {
+      ((TX_HOST_CONTEXT *)thread_ptr->tx_thread_host_context)->cpu_ns += tx_host_cpu_ns() - tx_host_run_start;
+    }
+    if (tx_host_stop_requested)
+    {
+      longjmp(tx_host_exit, 1);
+    }
+  }
+}
+
+/* Check whether a timer, or a thread timeout, can still make a thread ready. */
+static UINT tx_host_timer_active(VOID)
+{
+  TX_TIMER_INTERNAL **list_ptr;
+
+  for (list_ptr = _tx_timer_list_start; list_ptr < _tx_timer_list_end; list_ptr++)
+  {
+    if (*list_ptr != TX_NULL)
+    {
+      return TX_TRUE;
+    }
+  }
+
+  return TX_FALSE;
+}
+
+/* C version of _tx_timer_interrupt of the Cortex-M ports, taken with
+   _tx_thread_system_state set as in an ISR. */
+static VOID tx_host_timer_interrupt(VOID)
+{
+  ULONG64 start = tx_host_cpu_ns();
+
+  _tx_thread_system_state++;
+
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
+  _tx_execution_isr_enter();
+#endif
+
+  _tx_timer_system_clock++;
+
+  if (_tx_timer_time_slice)
+  {
+    _tx_timer_time_slice--;
+    if (_tx_timer_time_slice == 0)
+    {
+      _tx_timer_expired_time_slice = TX_TRUE;
+    }
+  }
+
+  if (*_tx_timer_current_ptr)
+  {
+    _tx_timer_expired = TX_TRUE;
+  }
+  else
+  {
+    _tx_timer_current_ptr++;
+    if (_tx_timer_current_ptr == _tx_timer_list_end)
+    {
+      _tx_timer_current_ptr = _tx_timer_list_start;
+    }
+  }
+
+  if (_tx_timer_expired)
+  {
+    _tx_timer_expiration_process();
+  }
+  if (_tx_timer_expired_time_slice)
+  {
+    _tx_thread_time_slice();
+  }
+
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
+  _tx_execution_isr_exit();
+#endif
+
+  _tx_thread_system_state--;
+
+  tx_host_isr_ns += tx_host_cpu_ns() - start;
+}
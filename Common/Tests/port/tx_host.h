@@ -0,0 +1,58 @@
+/**
+  ******************************************************************************
+  * @file    tx_host.h
+  * @brief   Control of the ThreadX host port used by the tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef TX_HOST_H
+#define TX_HOST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tx_api.h"
+
+/* Outcome of tx_host_run. */
+#define TX_HOST_STOPPED     0 /* tx_host_stop was called */
+#define TX_HOST_TIMED_OUT   1 /* the virtual time limit was reached */
+#define TX_HOST_DEADLOCK    2 /* no thread ready and no timer active */
+
+/* Run ThreadX until a thread calls tx_host_stop, or for at most max_ticks of
+   virtual time. tx_application_define is called first, as on the boards. */
+UINT tx_host_run(ULONG max_ticks);
+
+/* Return to tx_host_run from a thread. The thread is not resumed. */
+VOID tx_host_stop(VOID);
+
+/* Host CPU time spent so far, in nanoseconds. */
+ULONG64 tx_host_cpu_ns(VOID);
+
+/* Number of virtual ticks taken while no thread was ready. */
+ULONG tx_host_idle_ticks(VOID);
+
+/* Number of thread switches done by the scheduler. */
+ULONG tx_host_switches(VOID);
+
+/* Host CPU time a thread has run for since it was created, in nanoseconds. */
+ULONG64 tx_host_thread_cpu_ns(TX_THREAD* thread_ptr);
+
+/* Host CPU time spent in the timer interrupt, timer expirations included. */
+ULONG64 tx_host_isr_cpu_ns(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TX_HOST_H */
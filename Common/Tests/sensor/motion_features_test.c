@@ -0,0 +1,317 @@
+/**
+  ******************************************************************************
+  * @file    motion_features_test.c
+  * @brief   Vibration features of the motion blocks, cost per window and payload
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* motion_fifo.c and motion_features.c of the board run on the fake ISM330DHCX
+   of common/, at the 208 Hz and 4 g of the board. The fake plays vibration
+   traces computed from the sample number, so each run gives the same samples:
+   - idle, 1 g on z and a few mg of noise on every axis;
+   - tones, a sine in each of bands 2, 3 and 4, on x, y and z over 1 g;
+   - impacts, a 2 g spike every half second on y.
+   Each trace plays for WINDOW_SECONDS after a settling window, the window the
+   application would close with its vibration telemetry. The test checks the
+   features against the trace: the RMS, peak to peak and crest factor of a
+   sine, its energy in its band and almost none in the others, gravity and the
+   noise out of the RMS, the crest factor of the impacts. It reports the cycles
+   per block and per window, DWT->CYCCNT of the board being the simulated
+   cycle counter, the CPU time of the features thread, and the JSON bytes the
+   features take in the telemetry, as pnp_model_append_vibration writes them,
+   against the bytes of the raw samples.
+
+   The cycles are the host CPU time counted at the board clock, they compare
+   the traces and the builds, not the Cortex-M33 cycles. */
+
+#include <math.h>
+
+#include "motion_features.h"
+#include "motion_fifo.h"
+#include "nx_azure_iot.h"
+#include "pnp_model.h"
+#include "test_common.h"
+#include "test_motion.h"
+
+#define TEST_PRIORITY       10
+#define WINDOW_SECONDS      10
+#define JSON_SIZE           1024
+
+#define TRACE_AXES          MOTION_FEATURES_AXES
+#define GRAVITY_MG          1000.0
+#define NOISE_MG            8.0
+#define IMPACT_MG           2000.0
+#define IMPACT_PERIOD       104 // samples, half a second
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* A tone of a trace: amplitude in mg, frequency in Hz and the band it falls in. */
+typedef struct TRACE_TONE_STRUCT
+{
+  double amplitude;
+  double frequency;
+  UINT   band;
+} TRACE_TONE;
+
+typedef struct VIBRATION_TRACE_STRUCT
+{
+  const CHAR*        name;
+  TEST_MOTION_SOURCE source;
+} VIBRATION_TRACE;
+
+/* The tones of the tones trace, band 2 on x, 3 on y and 4 on z. */
+static const TRACE_TONE tones[TRACE_AXES] = {{500, 20, 1}, {250, 40, 2}, {100, 80, 3}};
+
+static TX_THREAD  test_thread;
+static ULONG64    test_stack[8192 / sizeof(ULONG64)];
+static TX_THREAD* features_thread_ptr;
+static double     lsb_per_mg;
+
+static int16_t trace_lsb(double mg)
+{
+  return (int16_t)lrint(mg * lsb_per_mg);
+}
+
+/* A noise of +-NOISE_MG from the sample number and the axis. */
+static double trace_noise(ULONG n, UINT axis)
+{
+  ULONG hash = (n * TRACE_AXES + axis + 1) * 2654435761UL;
+
+  hash ^= hash >> 15;
+  hash *= 2246822519UL;
+  hash ^= hash >> 13;
+
+  return NOISE_MG * (2.0 * (hash & 0xFFFF) / 0xFFFF - 1.0);
+}
+
+static VOID trace_idle(ULONG n, int16_t* xyz)
+{
+  xyz[0] = trace_lsb(trace_noise(n, 0));
+  xyz[1] = trace_lsb(trace_noise(n, 1));
+  xyz[2] = trace_lsb(GRAVITY_MG + trace_noise(n, 2));
+}
+
+static VOID trace_tones(ULONG n, int16_t* xyz)
+{
+  double t = n / (double)MOTION_FIFO_ODR;
+  UINT   axis;
+
+  for (axis = 0; axis < TRACE_AXES; axis++)
+  {
+    xyz[axis] = trace_lsb(((axis == 2) ? GRAVITY_MG : 0) +
+                          tones[axis].amplitude * sin(2 * M_PI * tones[axis].frequency * t));
+  }
+}
+
+static VOID trace_impacts(ULONG n, int16_t* xyz)
+{
+  xyz[0] = 0;
+  xyz[1] = trace_lsb((n % IMPACT_PERIOD) ? 0 : IMPACT_MG);
+  xyz[2] = trace_lsb(GRAVITY_MG);
+}
+
+static const VIBRATION_TRACE traces[] = {
+    {"idle", trace_idle},
+    {"tones", trace_tones},
+    {"impacts", trace_impacts},
+};
+
+static VOID model_axis_get(PNP_MODEL_VIBRATION_X* model, const MOTION_AXIS_FEATURES* axis)
+{
+  model->rms    = axis->rms;
+  model->p2p    = axis->peak_to_peak;
+  model->crest  = axis->crest_factor;
+  model->band_1 = axis->band_rms[0];
+  model->band_2 = axis->band_rms[1];
+  model->band_3 = axis->band_rms[2];
+  model->band_4 = axis->band_rms[3];
+}
+
+/* The bytes the features add to the telemetry object, as append_vibration_telemetry writes them. */
+static UINT payload_bytes(const MOTION_FEATURES* features)
+{
+  UCHAR                    json[JSON_SIZE];
+  NX_AZURE_IOT_JSON_WRITER json_writer;
+  PNP_MODEL_VIBRATION      model;
+  UINT                     start_length;
+
+  model_axis_get(&model.x, &features->axis[0]);
+  model_axis_get(&model.y, &features->axis[1]);
+  model_axis_get(&model.z, &features->axis[2]);
+
+  TEST_ASSERT(nx_azure_iot_json_writer_with_buffer_init(&json_writer, json, sizeof(json)) == NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_json_writer_append_begin_object(&json_writer) == NX_AZURE_IOT_SUCCESS);
+  start_length = nx_azure_iot_json_writer_get_bytes_used(&json_writer);
+  TEST_ASSERT(pnp_model_append_vibration(&json_writer, &model) == NX_AZURE_IOT_SUCCESS);
+
+  return nx_azure_iot_json_writer_get_bytes_used(&json_writer) - start_length;
+}
+
+/* The value is within tolerance of expected, as a fraction of it. */
+static UINT near(double value, double expected, double tolerance)
+{
+  return fabs(value - expected) <= tolerance * expected;
+}
+
+static VOID features_check(const VIBRATION_TRACE* trace_ptr, const MOTION_FEATURES* features)
+{
+  const MOTION_AXIS_FEATURES* axis_ptr;
+  double                      rms;
+  UINT                        axis;
+  UINT                        band;
+
+  TEST_ASSERT(features->dropped_blocks == 0);
+  TEST_ASSERT(features->samples == features->blocks * MOTION_FIFO_BLOCK_SAMPLES);
+
+  for (axis = 0; axis < TRACE_AXES; axis++)
+  {
+    axis_ptr = &features->axis[axis];
+
+    if (trace_ptr->source == trace_idle)
+    {
+      /* Uniform noise, the mean and gravity removed. */
+      TEST_ASSERT(near(axis_ptr->rms, NOISE_MG / sqrt(3), 0.1));
+      TEST_ASSERT(axis_ptr->peak_to_peak <= 2 * NOISE_MG + 1);
+    }
+    else if (trace_ptr->source == trace_tones)
+    {
+      rms = tones[axis].amplitude / sqrt(2);
+
+      TEST_ASSERT(near(axis_ptr->rms, rms, 0.02));
+      TEST_ASSERT(near(axis_ptr->peak_to_peak, 2 * tones[axis].amplitude, 0.02));
+      TEST_ASSERT(near(axis_ptr->crest_factor, sqrt(2), 0.05));
+
+      for (band = 0; band < MOTION_FEATURES_BANDS; band++)
+      {
+        if (band == tones[axis].band)
+        {
+          TEST_ASSERT(near(axis_ptr->band_rms[band], rms, 0.05));
+        }
+        else
+        {
+          TEST_ASSERT(axis_ptr->band_rms[band] < 0.05 * rms);
+        }
+      }
+    }
+    else if (axis == 1)
+    {
+      /* One spike per IMPACT_PERIOD samples, its energy spread over every band. */
+      rms = IMPACT_MG / sqrt(IMPACT_PERIOD);
+
+      TEST_ASSERT(near(axis_ptr->rms, rms, 0.05));
+      TEST_ASSERT(near(axis_ptr->peak_to_peak, IMPACT_MG, 0.01));
+      TEST_ASSERT(axis_ptr->crest_factor > 0.9 * sqrt(IMPACT_PERIOD));
+      for (band = 0; band < MOTION_FEATURES_BANDS; band++)
+      {
+        TEST_ASSERT(axis_ptr->band_rms[band] > 0.2 * rms);
+      }
+    }
+    else
+    {
+      TEST_ASSERT(axis_ptr->rms == 0);
+    }
+  }
+}
+
+static VOID trace_run(const VIBRATION_TRACE* trace_ptr)
+{
+  MOTION_FEATURES features;
+  ULONG64         cpu_ns;
+  UINT            json_bytes;
+  ULONG           raw_bytes;
+
+  test_motion_source_set(trace_ptr->source);
+
+  /* The blocks of the previous trace leave with the settling window. */
+  tx_thread_sleep(WINDOW_SECONDS * TX_TIMER_TICKS_PER_SECOND);
+  TEST_ASSERT(motion_features_get(&features) == TX_SUCCESS);
+
+  cpu_ns = tx_host_thread_cpu_ns(features_thread_ptr);
+  tx_thread_sleep(WINDOW_SECONDS * TX_TIMER_TICKS_PER_SECOND);
+  TEST_ASSERT(motion_features_get(&features) == TX_SUCCESS);
+  cpu_ns = tx_host_thread_cpu_ns(features_thread_ptr) - cpu_ns;
+
+  features_check(trace_ptr, &features);
+
+  json_bytes = payload_bytes(&features);
+  raw_bytes  = features.samples * sizeof(MOTION_SAMPLE);
+  TEST_ASSERT(json_bytes <= PNP_MODEL_VIBRATION_MAX_SIZE);
+
+  test_result("motion_features",
+      "\"trace\":\"%s\",\"window_s\":%u,\"samples\":%lu,\"blocks\":%lu,\"avg_block_cycles\":%lu,"
+      "\"max_block_cycles\":%lu,\"window_cycles\":%lu,\"cpu_us_per_window\":%.1f,"
+      "\"rms_mg\":[%.1f,%.1f,%.1f],\"crest\":[%.2f,%.2f,%.2f],\"raw_bytes\":%lu,\"json_bytes\":%u,"
+      "\"shrink\":%.1f",
+      trace_ptr->name,
+      WINDOW_SECONDS,
+      features.samples,
+      features.blocks,
+      features.avg_block_cycles,
+      features.max_block_cycles,
+      features.avg_block_cycles * features.blocks,
+      cpu_ns / 1000.0,
+      features.axis[0].rms,
+      features.axis[1].rms,
+      features.axis[2].rms,
+      features.axis[0].crest_factor,
+      features.axis[1].crest_factor,
+      features.axis[2].crest_factor,
+      raw_bytes,
+      json_bytes,
+      (double)raw_bytes / json_bytes);
+}
+
+static VOID test_entry(ULONG input)
+{
+  UINT i;
+
+  (void)input;
+
+  test_log_mute();
+  TEST_ASSERT(test_motion_start() == TX_SUCCESS);
+  TEST_ASSERT(motion_fifo_init() == TX_SUCCESS);
+  TEST_ASSERT(motion_features_init() == TX_SUCCESS);
+  TEST_ASSERT((features_thread_ptr = test_thread_find("Motion Features Thread")) != TX_NULL);
+
+  lsb_per_mg = 1.0 / motion_fifo_stats_get()->acc_sensitivity;
+
+  for (i = 0; i < sizeof(traces) / sizeof(traces[0]); i++)
+  {
+    trace_run(&traces[i]);
+  }
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100000);
+}
@@ -0,0 +1,229 @@
+/**
+  ******************************************************************************
+  * @file    motion_fifo_test.c
+  * @brief   ISM330DHCX FIFO drain throughput and cost per sample
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* motion_fifo.c of the board drains the fake ISM330DHCX of common/ through
+   the ISM330DHCX driver. The test takes the blocks every tick, as a telemetry
+   thread would, at batch data rates from the 208 Hz of the board up to
+   3333 Hz; 6667 Hz would need more than the 400 kHz bus. For each rate it
+   reports the samples per second, the watermark interrupts and drains, the
+   CPU time of the motion thread and the bus time per sample. Every sample must
+   arrive, in order, in whole blocks. Last, the test stops taking the blocks
+   until the ring is full: the blocks dropped must show as sequence gaps, and
+   the samples after them must follow on.
+
+   The CPU time of the motion thread includes the register accesses of the
+   fake, which stand for the blocking I2C transfers of the board. */
+
+#include "motion_fifo.h"
+#include "test_common.h"
+#include "test_motion.h"
+
+#include "b_u585i_iot02a_motion_sensors.h"
+
+#define TEST_PRIORITY       10
+#define MEASURE_SECONDS     10
+
+/* Blocks held back to fill the ring, and a few more to be dropped. */
+#define STALL_BLOCKS        (MOTION_FIFO_BLOCKS + 3)
+
+static const ULONG rates[] = {208, 833, 1667, 3333};
+
+static TX_THREAD  test_thread;
+static ULONG64    test_stack[8192 / sizeof(ULONG64)];
+static TX_THREAD* motion_thread_ptr;
+
+/* What the consumer saw. */
+static UINT  blocks_started;
+static ULONG block_sequence_next;
+static ULONG sample_next;
+static ULONG blocks_taken;
+static ULONG blocks_missing;
+
+/* Check the samples of a block follow the last one taken, after the blocks of
+   the sequence gap. */
+static VOID block_check(const MOTION_BLOCK* block_ptr)
+{
+  ULONG gap = block_ptr->sequence - block_sequence_next;
+  UINT  i;
+
+  if (!blocks_started)
+  {
+    sample_next    = (USHORT)block_ptr->sample[0].x;
+    blocks_started = TX_TRUE;
+    gap            = 0;
+  }
+  sample_next += gap * MOTION_FIFO_BLOCK_SAMPLES;
+  blocks_missing += gap;
+
+  for (i = 0; i < MOTION_FIFO_BLOCK_SAMPLES; i++, sample_next++)
+  {
+    TEST_ASSERT(block_ptr->sample[i].x == TEST_MOTION_SAMPLE_X(sample_next));
+    TEST_ASSERT(block_ptr->sample[i].y == TEST_MOTION_SAMPLE_Y(sample_next));
+  }
+
+  block_sequence_next = block_ptr->sequence + 1;
+  blocks_taken++;
+}
+
+static VOID blocks_take(VOID)
+{
+  const MOTION_BLOCK* block_ptr;
+
+  while ((block_ptr = motion_fifo_block_get()) != TX_NULL)
+  {
+    block_check(block_ptr);
+    motion_fifo_block_release();
+  }
+}
+
+/* Take the blocks every tick for ticks. */
+static VOID blocks_take_for(ULONG ticks)
+{
+  while (ticks--)
+  {
+    tx_thread_sleep(1);
+    blocks_take();
+  }
+}
+
+static VOID rate_set(ULONG rate)
+{
+  ISM330DHCX_Object_t* sensor_ptr = (ISM330DHCX_Object_t*)Motion_Sensor_CompObj[0];
+
+  motion_fifo_bus_lock();
+  TEST_ASSERT(ISM330DHCX_ACC_SetOutputDataRate(sensor_ptr, (float)rate) == ISM330DHCX_OK);
+  TEST_ASSERT(ISM330DHCX_FIFO_ACC_Set_BDR(sensor_ptr, (float)rate) == ISM330DHCX_OK);
+  motion_fifo_bus_unlock();
+}
+
+static VOID rate_measure(ULONG rate)
+{
+  const MOTION_FIFO_STATS* fifo_ptr = motion_fifo_stats_get();
+  MOTION_FIFO_STATS        fifo_start;
+  TEST_MOTION_STATS        sensor_start;
+  ULONG64                  cpu_ns;
+  ULONG                    samples;
+  ULONG                    drains;
+
+  rate_set(rate);
+
+  /* Let the samples at the old rate leave the FIFO. */
+  blocks_take_for(TX_TIMER_TICKS_PER_SECOND);
+
+  fifo_start   = *fifo_ptr;
+  sensor_start = test_motion_stats;
+  cpu_ns       = tx_host_thread_cpu_ns(motion_thread_ptr);
+
+  blocks_take_for(MEASURE_SECONDS * TX_TIMER_TICKS_PER_SECOND);
+
+  samples = fifo_ptr->samples - fifo_start.samples;
+  drains  = fifo_ptr->drains - fifo_start.drains;
+  cpu_ns  = tx_host_thread_cpu_ns(motion_thread_ptr) - cpu_ns;
+
+  /* Nothing lost, and the drains keep up with the sensor. */
+  TEST_ASSERT(test_motion_stats.samples_overrun == 0);
+  TEST_ASSERT(fifo_ptr->dropped_blocks == 0);
+  TEST_ASSERT(samples >= (test_motion_stats.samples - sensor_start.samples) - MOTION_FIFO_WATERMARK);
+  TEST_ASSERT(test_motion_stats.bus_ns - sensor_start.bus_ns < MEASURE_SECONDS * 1000000000ULL);
+
+  test_result("motion_fifo",
+      "\"rate_hz\":%lu,\"samples_per_s\":%.1f,\"interrupts_per_s\":%.1f,\"drains_per_s\":%.1f,"
+      "\"words_per_drain\":%.1f,\"max_drain\":%lu,\"cpu_ns_per_sample\":%llu,\"bus_us_per_sample\":%.1f,"
+      "\"bus_load_pct\":%.1f",
+      rate,
+      (double)samples / MEASURE_SECONDS,
+      (double)(test_motion_stats.interrupts - sensor_start.interrupts) / MEASURE_SECONDS,
+      (double)drains / MEASURE_SECONDS,
+      drains ? (double)(test_motion_stats.words_read - sensor_start.words_read) / drains : 0,
+      fifo_ptr->max_drain,
+      samples ? cpu_ns / samples : 0,
+      samples ? (test_motion_stats.bus_ns - sensor_start.bus_ns) / 1000.0 / samples : 0,
+      (test_motion_stats.bus_ns - sensor_start.bus_ns) / (MEASURE_SECONDS * 10000000.0));
+}
+
+/* Hold the blocks until the ring overflows, then take them all. */
+static VOID ring_overflow(VOID)
+{
+  const MOTION_FIFO_STATS* fifo_ptr = motion_fifo_stats_get();
+  ULONG                    dropped  = fifo_ptr->dropped_blocks;
+  ULONG                    missing  = blocks_missing;
+
+  rate_set((ULONG)MOTION_FIFO_ODR);
+  blocks_take_for(TX_TIMER_TICKS_PER_SECOND);
+
+  tx_thread_sleep(STALL_BLOCKS * MOTION_FIFO_BLOCK_SAMPLES * TX_TIMER_TICKS_PER_SECOND / (ULONG)MOTION_FIFO_ODR);
+  blocks_take();
+
+  /* Keep taking until a block of the resumed sequence arrives after the gap. */
+  while (blocks_missing == missing)
+  {
+    blocks_take_for(1);
+  }
+
+  TEST_ASSERT(test_motion_stats.samples_overrun == 0);
+  TEST_ASSERT(fifo_ptr->dropped_blocks > dropped);
+  TEST_ASSERT(blocks_missing - missing == fifo_ptr->dropped_blocks - dropped);
+
+  test_result("motion_fifo",
+      "\"phase\":\"ring_overflow\",\"stalled_blocks\":%u,\"dropped_blocks\":%lu",
+      STALL_BLOCKS,
+      fifo_ptr->dropped_blocks - dropped);
+}
+
+static VOID test_entry(ULONG input)
+{
+  UINT i;
+
+  (void)input;
+
+  test_log_mute();
+  TEST_ASSERT(test_motion_start() == TX_SUCCESS);
+  TEST_ASSERT(motion_fifo_init() == TX_SUCCESS);
+  TEST_ASSERT((motion_thread_ptr = test_thread_find("Motion Thread")) != TX_NULL);
+
+  for (i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+  {
+    rate_measure(rates[i]);
+  }
+
+  ring_overflow();
+
+  TEST_ASSERT(blocks_taken > 0);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100000);
+}
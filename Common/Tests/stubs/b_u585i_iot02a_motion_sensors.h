@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file    b_u585i_iot02a_motion_sensors.h
+  * @brief   Host stand-in for the motion sensors BSP of the board
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef B_U585I_IOT02A_MOTION_SENSORS_H
+#define B_U585I_IOT02A_MOTION_SENSORS_H
+
+#include "ism330dhcx.h"
+
+/* The functions the application uses, implemented in common/test_motion.c
+   with the ISM330DHCX driver on the fake sensor. */
+#define BSP_ERROR_NONE              0
+#define BSP_ERROR_WRONG_PARAM       -2
+#define BSP_ERROR_COMPONENT_FAILURE -5
+
+#define MOTION_SENSOR_INSTANCES_NBR 2U
+#define MOTION_GYRO                 1U
+#define MOTION_ACCELERO             2U
+#define MOTION_MAGNETO              4U
+
+extern void* Motion_Sensor_CompObj[MOTION_SENSOR_INSTANCES_NBR];
+
+int32_t BSP_MOTION_SENSOR_Init(uint32_t Instance, uint32_t Functions);
+int32_t BSP_MOTION_SENSOR_Enable(uint32_t Instance, uint32_t Function);
+int32_t BSP_MOTION_SENSOR_SetOutputDataRate(uint32_t Instance, uint32_t Function, float Odr);
+int32_t BSP_MOTION_SENSOR_SetFullScale(uint32_t Instance, uint32_t Function, int32_t Fullscale);
+
+#endif /* B_U585I_IOT02A_MOTION_SENSORS_H */
@@ -0,0 +1,51 @@
+/**
+  ******************************************************************************
+  * @file    main.h
+  * @brief   Host stand-in for the main.h of the board
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include "stm32u5xx.h"
+
+/* The pin setup of the application code has no effect on the host, the
+   interrupts are raised by the fakes of the tests. */
+typedef struct
+{
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+  uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+#define GPIO_PIN_11                 ((uint16_t)0x0800)
+#define GPIO_MODE_IT_RISING         0x10110000U
+#define GPIO_NOPULL                 0x00000000U
+#define GPIOE                       ((void*)0)
+#define EXTI11_IRQn                 22
+
+#define __HAL_RCC_GPIOE_CLK_ENABLE()
+#define HAL_GPIO_Init(port, init)   ((void)(port), (void)(init))
+#define HAL_NVIC_SetPriority(irq, preempt, sub)
+#define HAL_NVIC_EnableIRQ(irq)
+
+#define ISM330DHCX_INT1_Pin         GPIO_PIN_11
+#define ISM330DHCX_INT1_GPIO_Port   GPIOE
+#define ISM330DHCX_INT1_EXTI_IRQn   EXTI11_IRQn
+
+void Error_Handler(void);
+
+#endif /* __MAIN_H */
@@ -0,0 +1,26 @@
+/**
+  ******************************************************************************
+  * @file    nx_driver_emw3080.h
+  * @brief   Host stand-in for the NetX driver of the EMW3080 Wi-Fi module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef NX_DRIVER_EMW3080_H
+#define NX_DRIVER_EMW3080_H
+
+#include "nx_host_link.h"
+
+/* The IP instance of app_netxduo.c joins the simulated segment of the tests. */
+#define nx_driver_emw3080_entry     nx_host_link_driver
+
+#endif /* NX_DRIVER_EMW3080_H */
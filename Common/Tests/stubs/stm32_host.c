@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file    stm32_host.c
+  * @brief   Host stand-ins for the device registers used by the application
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include <stdlib.h>
+
+#include "stm32u5xx.h"
+#include "tx_api.h"
+
+DWT_Type       host_dwt;
+CoreDebug_Type host_core_debug;
+
+/* The U585 runs at 160 MHz, TX_HOST_CYCLES_PER_TICK matches it. */
+uint32_t SystemCoreClock = 160000000UL;
+
+DWT_Type* host_dwt_get(void)
+{
+  if (host_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk)
+  {
+    host_dwt.CYCCNT = (uint32_t)_tx_host_cycles_get();
+  }
+
+  return &host_dwt;
+}
+
+/* The board stops in a loop, the host test program aborts. */
+void Error_Handler(void)
+{
+  abort();
+}
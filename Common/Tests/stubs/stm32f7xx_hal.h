@@ -0,0 +1,147 @@
+/**
+  ******************************************************************************
+  * @file    stm32f7xx_hal.h
+  * @brief   Host stand-in for the HAL of the F746, legacy Ethernet part
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32F7XX_HAL_H
+#define STM32F7XX_HAL_H
+
+#include <stdint.h>
+
+/* Only what nx_stm32_eth_driver.c uses with STM32_ETH_HAL_LEGACY, with the
+   values of stm32f7xx_hal_eth.h and stm32f746xx.h. The DMA working the
+   descriptors and the interrupt are the fake of common/test_eth.c. */
+
+#define __IO                        volatile
+#define RESET                       0U
+
+/* The D-cache maintenance is counted by the fake. */
+#define __DCACHE_PRESENT            1U
+
+typedef enum
+{
+  HAL_OK      = 0x00U,
+  HAL_ERROR   = 0x01U,
+  HAL_BUSY    = 0x02U,
+  HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+/* The registers are plain memory: the status bits are not cleared by writing
+   them, and the fake DMA polls its descriptors instead of waiting for a poll
+   demand. */
+typedef struct
+{
+  __IO uint32_t MACFFR;
+  __IO uint32_t DMATPDR;
+  __IO uint32_t DMARPDR;
+  __IO uint32_t DMARDLAR;
+  __IO uint32_t DMATDLAR;
+  __IO uint32_t DMASR;
+  __IO uint32_t DMAIER;
+  __IO uint32_t DMARSWTR;
+} ETH_TypeDef;
+
+extern ETH_TypeDef test_eth_registers;
+
+#define ETH                         (&test_eth_registers)
+
+/* stm32f7xx_hal_conf.h of the board. */
+#define ETH_RXBUFNB                 4U
+#define ETH_TXBUFNB                 4U
+
+#define ETH_MACFFR_PAM              0x00000010U
+
+#define ETH_DMASR_NIS               0x00010000U
+#define ETH_DMASR_RBUS              0x00000080U
+#define ETH_DMASR_RS                0x00000040U
+#define ETH_DMASR_TBUS              0x00000004U
+#define ETH_DMASR_TS                0x00000001U
+
+#define ETH_DMA_IT_NIS              0x00010000U
+#define ETH_DMA_IT_R                0x00000040U
+#define ETH_DMA_IT_T                0x00000001U
+
+#define ETH_DMATXDESC_OWN           0x80000000U
+#define ETH_DMATXDESC_IC            0x40000000U
+#define ETH_DMATXDESC_LS            0x20000000U
+#define ETH_DMATXDESC_FS            0x10000000U
+#define ETH_DMATXDESC_CIC           0x00C00000U
+#define ETH_DMATXDESC_CIC_IPV4HEADER      0x00400000U
+#define ETH_DMATXDESC_CIC_TCPUDPICMP_FULL 0x00C00000U
+#define ETH_DMATXDESC_TCH           0x00100000U
+#define ETH_DMATXDESC_TBS1          0x00001FFFU
+
+#define ETH_DMARXDESC_OWN           0x80000000U
+#define ETH_DMARXDESC_FL            0x3FFF0000U
+#define ETH_DMARXDESC_FRAME_LENGTHSHIFT 16U
+#define ETH_DMARXDESC_ES            0x00008000U
+#define ETH_DMARXDESC_FS            0x00000200U
+#define ETH_DMARXDESC_LS            0x00000100U
+#define ETH_DMARXDESC_DIC           0x80000000U
+#define ETH_DMARXDESC_RCH           0x00004000U
+#define ETH_DMARXDESC_RBS1          0x00001FFFU
+
+#define ETH_SPEED_10M               0x00000000U
+#define ETH_SPEED_100M              0x00004000U
+#define ETH_MODE_FULLDUPLEX         0x00000800U
+#define ETH_MODE_HALFDUPLEX         0x00000000U
+#define ETH_CHECKSUM_BY_HARDWARE    0x00000000U
+#define ETH_CHECKSUM_BY_SOFTWARE    0x00000001U
+
+typedef struct
+{
+  uint32_t Speed;
+  uint32_t DuplexMode;
+  uint8_t* MACAddr;
+  uint32_t ChecksumMode;
+} ETH_InitTypeDef;
+
+typedef struct
+{
+  __IO uint32_t Status;
+  uint32_t      ControlBufferSize;
+  uint32_t      Buffer1Addr;
+  uint32_t      Buffer2NextDescAddr;
+  uint32_t      ExtendedStatus;
+  uint32_t      Reserved1;
+  uint32_t      TimeStampLow;
+  uint32_t      TimeStampHigh;
+} ETH_DMADescTypeDef;
+
+typedef struct
+{
+  ETH_TypeDef*    Instance;
+  ETH_InitTypeDef Init;
+} ETH_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t Reserved;
+} ETH_MACInitTypeDef;
+
+#define __HAL_ETH_DMA_ENABLE_IT(__HANDLE__, __INTERRUPT__) ((__HANDLE__)->Instance->DMAIER |= (__INTERRUPT__))
+
+HAL_StatusTypeDef HAL_ETH_Start(ETH_HandleTypeDef* heth);
+HAL_StatusTypeDef HAL_ETH_Stop(ETH_HandleTypeDef* heth);
+HAL_StatusTypeDef HAL_ETH_ConfigMAC(ETH_HandleTypeDef* heth, ETH_MACInitTypeDef* macconf);
+
+/* Called by the interrupt of the fake, defined by the driver. */
+void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef* heth);
+void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef* heth);
+
+void SCB_CleanDCache_by_Addr(uint32_t* addr, int32_t dsize);
+void SCB_InvalidateDCache_by_Addr(uint32_t* addr, int32_t dsize);
+
+#endif /* STM32F7XX_HAL_H */
@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    stm32u5xx.h
+  * @brief   Host stand-in for the CMSIS device header of the U585
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#ifndef STM32U5XX_H
+#define STM32U5XX_H
+
+#include <stdint.h>
+
+/* Only the core debug registers the application code touches. The cycle
+   counter is simulated by the ThreadX host port, see THREAD_PROFILE_CYCLES in
+   the test Makefile: while it is enabled, each access to DWT loads CYCCNT with
+   _tx_host_cycles_get. */
+typedef struct
+{
+  volatile uint32_t CTRL;
+  volatile uint32_t CYCCNT;
+  volatile uint32_t LAR;
+} DWT_Type;
+
+typedef struct
+{
+  volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type       host_dwt;
+extern CoreDebug_Type host_core_debug;
+extern uint32_t       SystemCoreClock;
+
+DWT_Type* host_dwt_get(void);
+
+#define DWT                         (host_dwt_get())
+#define CoreDebug                   (&host_core_debug)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+/* The barrier of the single producer, single consumer rings. */
+#define __DMB()                     __sync_synchronize()
+
+/* The CMSIS helpers of the DSP code, without __ARM_FEATURE_DSP it takes its C
+   paths. */
+#define __ALIGNED(x)                __attribute__((aligned(x)))
+
+static inline int32_t __SSAT(int32_t value, uint32_t bits)
+{
+  const int32_t max = (int32_t)((1U << (bits - 1)) - 1);
+
+  return (value > max) ? max : ((value < -max - 1) ? -max - 1 : value);
+}
+
+#endif /* STM32U5XX_H */
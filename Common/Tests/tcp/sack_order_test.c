@@ -0,0 +1,396 @@
+/**
+  ******************************************************************************
+  * @file    sack_order_test.c
+  * @brief   Order of the SACK blocks reported by a NetX receiver
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Once its congestion window is open, the device sends SEGMENTS full
+   segments to the server, one at a time, and the link drops every copy of the
+   odd ones below LAST_DROPPED until the device has sent them all: the server
+   holds one more block of out of order data after each even segment, more
+   than fit in an ACK. The link reads the SACK option of each ACK of the
+   server. RFC 2018 section 4 asks that its first block holds the segment just
+   received, so the ACK forced by out of order data must leave once the segment
+   is queued, and that the blocks of the previous ACK follow, so a block is
+   reported in several ACKs before it falls off. Every option must also stay
+   within NX_TCP_SACK_MAX_BLOCKS blocks above the cumulative ACK, without
+   overlap. The drops then stop, the device repairs the holes and the server
+   must receive every byte, in order. */
+
+#include "test_common.h"
+#include "test_net.h"
+
+#include "nx_host_link.h"
+#include "nx_tcp.h"
+
+#define DEVICE_PRIORITY     10
+#define SERVER_PRIORITY     5
+#define DEVICE_PACKETS      64
+#define SERVER_PACKETS      64
+#define SERVER_PORT         5000
+#define SOCKET_WINDOW       65535
+
+/* The link: 20 ms one way, 2 Mbit/s. */
+#define LINK_DELAY          2
+#define LINK_RATE           2500
+#define LINK_QUEUE          (64 * 1024)
+
+/* A segment is sent every SEND_INTERVAL ticks, its ACK is back before the next. */
+#define SEGMENT_SIZE        1460
+#define WARMUP_SEGMENTS     64
+#define SEGMENTS            10
+#define LAST_DROPPED        7
+#define SEND_INTERVAL       5
+
+#define ACKS_MAX            64
+
+#define ETHERNET_HEADER     14
+#define ETHERNET_IPV4       0x0800
+#define IP_PROTOCOL_TCP     6
+#define TCP_OPTION_END      0
+#define TCP_OPTION_NOP      1
+
+/* The SACK option of an ACK of the server, in segments of the device. */
+typedef struct SACK_ACK_STRUCT
+{
+  UINT received; // last segment the link delivered to the server
+  UINT ack;      // segments acknowledged
+  UINT count;
+  UINT starts[4];
+  UINT ends[4];  // segment after the block
+} SACK_ACK;
+
+static TEST_NET_HOST device;
+static TEST_NET_HOST server;
+static NX_TCP_SOCKET device_socket;
+static NX_TCP_SOCKET server_socket;
+static TX_THREAD     device_thread;
+static TX_THREAD     server_thread;
+static ULONG64       device_stack[8192 / sizeof(ULONG64)];
+static ULONG64       server_stack[8192 / sizeof(ULONG64)];
+
+/* First sequence of the segments sent with drops, once the window is open. */
+static ULONG sequence_base;
+static UINT  observing;
+static UINT  segments_sent;
+static UINT  dropping;
+static UINT  last_received;
+static ULONG data_received;
+
+static SACK_ACK sack_acks[ACKS_MAX];
+static UINT     sack_ack_count;
+
+static ULONG read_ulong(const UCHAR* data)
+{
+  return ((ULONG)data[0] << 24) | ((ULONG)data[1] << 16) | ((ULONG)data[2] << 8) | data[3];
+}
+
+/* Segment of a sequence of the device, the blocks end on segment boundaries. */
+static UINT segment_of(ULONG sequence)
+{
+  ULONG offset = sequence - sequence_base;
+
+  TEST_ASSERT(offset % SEGMENT_SIZE == 0);
+
+  return (UINT)(offset / SEGMENT_SIZE);
+}
+
+/* Keep the SACK blocks found in the TCP options of an ACK. */
+static VOID sack_ack_record(const UCHAR* options, UINT length, ULONG ack)
+{
+  SACK_ACK* sack_ack;
+  UINT      offset = 0;
+  UINT      i;
+
+  while ((offset < length) && (options[offset] != TCP_OPTION_END))
+  {
+    if (options[offset] == TCP_OPTION_NOP)
+    {
+      offset++;
+      continue;
+    }
+
+    TEST_ASSERT((offset + 1 < length) && (options[offset + 1] >= 2) && (offset + options[offset + 1] <= length));
+    if (options[offset] == NX_TCP_SACK_KIND)
+    {
+      TEST_ASSERT(sack_ack_count < ACKS_MAX);
+      sack_ack = &sack_acks[sack_ack_count++];
+      sack_ack->received = last_received;
+      sack_ack->ack = segment_of(ack);
+      sack_ack->count = (options[offset + 1] - 2) / 8;
+      TEST_ASSERT((sack_ack->count >= 1) && (sack_ack->count <= 4));
+      for (i = 0; i < sack_ack->count; i++)
+      {
+        sack_ack->starts[i] = segment_of(read_ulong(&options[offset + 2 + 8 * i]));
+        sack_ack->ends[i] = segment_of(read_ulong(&options[offset + 6 + 8 * i]));
+      }
+    }
+    offset += options[offset + 1];
+  }
+}
+
+/* Drop the odd segments of the device while dropping is set, and read the
+   SACK options of the server. */
+static UINT sack_filter(UINT from, UINT to, UCHAR* frame, UINT length)
+{
+  UCHAR* ip;
+  UCHAR* tcp;
+  UINT   ip_length;
+  UINT   tcp_length;
+  UINT   data_length;
+  UINT   segment;
+
+  (void)to;
+
+  if (!observing || (length < ETHERNET_HEADER + 20) ||
+      ((((UINT)frame[12] << 8) | frame[13]) != ETHERNET_IPV4) || (frame[ETHERNET_HEADER + 9] != IP_PROTOCOL_TCP))
+  {
+    return NX_FALSE;
+  }
+
+  ip = frame + ETHERNET_HEADER;
+  ip_length = (ip[0] & 0x0F) * 4;
+  tcp = ip + ip_length;
+  tcp_length = (tcp[12] >> 4) * 4;
+  data_length = (((UINT)ip[2] << 8) | ip[3]) - ip_length - tcp_length;
+
+  if ((from == nx_host_link_station_get(&device.ip)) && data_length)
+  {
+    segment = segment_of(read_ulong(&tcp[4]));
+    if (dropping && (segment & 1) && (segment <= LAST_DROPPED))
+    {
+      return NX_TRUE;
+    }
+    last_received = segment;
+  }
+  else if ((from == nx_host_link_station_get(&server.ip)) && (tcp_length > 20))
+  {
+    sack_ack_record(tcp + 20, tcp_length - 20, read_ulong(&tcp[8]));
+  }
+
+  return NX_FALSE;
+}
+
+static VOID server_entry(ULONG input)
+{
+  NX_PACKET* packet_ptr;
+
+  (void)input;
+
+  TEST_ASSERT(nx_tcp_socket_create(&server.ip,
+                  &server_socket,
+                  "Server",
+                  NX_IP_NORMAL,
+                  NX_FRAGMENT_OKAY,
+                  NX_IP_TIME_TO_LIVE,
+                  SOCKET_WINDOW,
+                  NX_NULL,
+                  NX_NULL) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_server_socket_listen(&server.ip, SERVER_PORT, &server_socket, 1, NX_NULL) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_server_socket_accept(&server_socket, NX_WAIT_FOREVER) == NX_SUCCESS);
+
+  /* The data comes in order, each byte the number of its segment. */
+  while (nx_tcp_socket_receive(&server_socket, &packet_ptr, NX_WAIT_FOREVER) == NX_SUCCESS)
+  {
+    UCHAR data[TEST_NET_PACKET_SIZE];
+    ULONG length;
+    ULONG i;
+
+    TEST_ASSERT(nx_packet_data_retrieve(packet_ptr, data, &length) == NX_SUCCESS);
+    nx_packet_release(packet_ptr);
+    for (i = 0; i < length; i++, data_received++)
+    {
+      TEST_ASSERT(data[i] == (UCHAR)(data_received / SEGMENT_SIZE));
+    }
+  }
+}
+
+static VOID segment_send(VOID)
+{
+  NX_PACKET* packet_ptr;
+  UCHAR      data[SEGMENT_SIZE];
+
+  memset(data, (int)segments_sent++, sizeof(data));
+
+  TEST_ASSERT(nx_packet_allocate(&device.pool, &packet_ptr, NX_TCP_PACKET, NX_WAIT_FOREVER) == NX_SUCCESS);
+  TEST_ASSERT(nx_packet_data_append(packet_ptr, data, sizeof(data), &device.pool, NX_WAIT_FOREVER) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_socket_send(&device_socket, packet_ptr, NX_WAIT_FOREVER) == NX_SUCCESS);
+}
+
+/* Whether the blocks of an ACK, from its first, are the segment ranges given. */
+static UINT sack_ack_is(const SACK_ACK* sack_ack, UINT count, const UINT* ranges)
+{
+  UINT i;
+
+  if (sack_ack->count != count)
+  {
+    return NX_FALSE;
+  }
+
+  for (i = 0; i < count; i++)
+  {
+    if ((sack_ack->starts[i] != ranges[2 * i]) || (sack_ack->ends[i] != ranges[2 * i + 1]))
+    {
+      return NX_FALSE;
+    }
+  }
+
+  return NX_TRUE;
+}
+
+/* The last ACK that reports the segment just delivered. */
+static const SACK_ACK* sack_ack_find(UINT received)
+{
+  UINT i;
+
+  for (i = sack_ack_count; i > 0; i--)
+  {
+    if (sack_acks[i - 1].received == received)
+    {
+      return &sack_acks[i - 1];
+    }
+  }
+
+  return NX_NULL;
+}
+
+static VOID device_entry(ULONG input)
+{
+  static const UINT after_4[] = {4, 5, 2, 3};
+  static const UINT after_8[] = {8, 9, 6, 7, 4, 5};
+  static const UINT after_9[] = {8, 10, 6, 7, 4, 5};
+  const SACK_ACK*   sack_ack;
+  UINT              i;
+  UINT              j;
+
+  (void)input;
+
+  nx_host_link_configure(LINK_DELAY, LINK_RATE, LINK_QUEUE);
+  TEST_ASSERT(test_net_host_create(&server, "Server", TEST_NET_ADDRESS(1), SERVER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_net_host_create(&device, "Device", TEST_NET_ADDRESS(2), DEVICE_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_socket_create(&device.ip,
+                  &device_socket,
+                  "Device",
+                  NX_IP_NORMAL,
+                  NX_FRAGMENT_OKAY,
+                  NX_IP_TIME_TO_LIVE,
+                  SOCKET_WINDOW,
+                  NX_NULL,
+                  NX_NULL) == NX_SUCCESS);
+  TEST_ASSERT(tx_thread_create(&server_thread,
+                  "Server",
+                  server_entry,
+                  0,
+                  server_stack,
+                  sizeof(server_stack),
+                  SERVER_PRIORITY,
+                  SERVER_PRIORITY,
+                  TX_NO_TIME_SLICE,
+                  TX_AUTO_START) == TX_SUCCESS);
+  nx_host_link_filter_set(sack_filter);
+
+  TEST_ASSERT(nx_tcp_client_socket_bind(&device_socket, NX_ANY_PORT, NX_WAIT_FOREVER) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_client_socket_connect(&device_socket, TEST_NET_ADDRESS(1), SERVER_PORT, NX_WAIT_FOREVER) ==
+              NX_SUCCESS);
+  TEST_ASSERT(device_socket.nx_tcp_socket_sack_permitted && server_socket.nx_tcp_socket_sack_permitted);
+  TEST_ASSERT(device_socket.nx_tcp_socket_connect_mss >= SEGMENT_SIZE);
+
+  /* Open the congestion window first, the segments with drops are all sent
+     while the holes stay. */
+  for (i = 0; i < WARMUP_SEGMENTS; i++)
+  {
+    segment_send();
+  }
+  while (data_received < WARMUP_SEGMENTS * SEGMENT_SIZE)
+  {
+    tx_thread_sleep(SEND_INTERVAL);
+  }
+  tx_thread_sleep(NX_IP_PERIODIC_RATE);
+  TEST_ASSERT(device_socket.nx_tcp_socket_tx_window_congestion >= SEGMENTS * SEGMENT_SIZE);
+
+  sequence_base = device_socket.nx_tcp_socket_tx_sequence;
+  dropping = NX_TRUE;
+  observing = NX_TRUE;
+
+  for (i = 0; i < SEGMENTS; i++)
+  {
+    segment_send();
+    tx_thread_sleep(SEND_INTERVAL);
+  }
+
+  /* The ACK of the last segment is back. */
+  tx_thread_sleep(2 * LINK_DELAY + SEND_INTERVAL);
+
+  /* The block just received first, then those of the previous ACK. Four
+     blocks are held after segment 8, the lowest falls off. */
+  TEST_ASSERT(((sack_ack = sack_ack_find(2)) != NX_NULL) && (sack_ack->count == 1) && (sack_ack->starts[0] == 2));
+  TEST_ASSERT(((sack_ack = sack_ack_find(4)) != NX_NULL) && sack_ack_is(sack_ack, 2, after_4));
+  TEST_ASSERT(((sack_ack = sack_ack_find(8)) != NX_NULL) && sack_ack_is(sack_ack, NX_TCP_SACK_MAX_BLOCKS, after_8));
+  TEST_ASSERT(((sack_ack = sack_ack_find(9)) != NX_NULL) && sack_ack_is(sack_ack, NX_TCP_SACK_MAX_BLOCKS, after_9));
+
+  dropping = NX_FALSE;
+  while (data_received < (WARMUP_SEGMENTS + SEGMENTS) * SEGMENT_SIZE)
+  {
+    tx_thread_sleep(SEND_INTERVAL);
+  }
+
+  /* Every option: its first block holds the segment just received when that
+     was out of order, all blocks above the ACK, without overlap. */
+  for (i = 0; i < sack_ack_count; i++)
+  {
+    sack_ack = &sack_acks[i];
+    TEST_ASSERT(sack_ack->count <= NX_TCP_SACK_MAX_BLOCKS);
+    if (sack_ack->received > sack_ack->ack)
+    {
+      TEST_ASSERT((sack_ack->starts[0] <= sack_ack->received) && (sack_ack->received < sack_ack->ends[0]));
+    }
+
+    for (j = 0; j < sack_ack->count; j++)
+    {
+      TEST_ASSERT((sack_ack->starts[j] > sack_ack->ack) && (sack_ack->starts[j] < sack_ack->ends[j]));
+      TEST_ASSERT((j == 0) || (sack_ack->ends[j] <= sack_ack->starts[j - 1]) ||
+                  (sack_ack->starts[j] >= sack_ack->ends[j - 1]));
+    }
+  }
+
+  test_result("sack_order",
+      "\"segments\":%u,\"sack_acks\":%u,\"retransmits\":%u",
+      SEGMENTS,
+      sack_ack_count,
+      (UINT)device_socket.nx_tcp_socket_retransmit_packets);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  nx_system_initialize();
+  tx_thread_create(&device_thread,
+      "Device",
+      device_entry,
+      0,
+      device_stack,
+      sizeof(device_stack),
+      DEVICE_PRIORITY,
+      DEVICE_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100000);
+}
@@ -0,0 +1,312 @@
+/**
+  ******************************************************************************
+  * @file    tcp_loss_test.c
+  * @brief   TCP goodput and message latency on a lossy link
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The device sends to the server over a link of 2 Mbit/s with a 40 ms round
+   trip, losing 0 to 10 % of the frames in each direction. For each loss rate a
+   new connection first carries a bulk transfer, giving the goodput, then
+   telemetry sized messages sent every 100 ms, giving the latency from send to
+   receive of each message at the 50th and 99th percentile and at worst. The
+   server checks that every byte arrives in order.
+
+   The program is built twice: tcp_loss_test with the board configuration,
+   NX_ENABLE_TCP_SACK, and tcp_loss_test_no_sack with NewReno recovery only.
+   In both the server receives as the TCP of the IoT Hub, config/hub_tcp.
+   Losses come from fixed seeds, so each run of a build gives the same results. */
+
+#include <stdlib.h>
+
+#include "test_common.h"
+#include "test_net.h"
+
+#define DEVICE_PRIORITY     10
+#define SERVER_PRIORITY     5
+#define DEVICE_PACKETS      64
+#define SERVER_PACKETS      128
+#define SERVER_PORT         5000
+
+/* The link: one way delay, rate and queue of each station. */
+#define LINK_DELAY          2
+#define LINK_RATE           2500
+#define LINK_QUEUE          (64 * 1024)
+
+/* The device window of the MQTT client, NXD_MQTT_CLIENT_SOCKET_WINDOW_SIZE,
+   and a server window that does not limit the sender. */
+#define DEVICE_WINDOW       8192
+#define SERVER_WINDOW       65535
+
+#define BULK_BYTES          (512 * 1024)
+#define BULK_SEGMENT        1460
+#define MESSAGES            500
+#define MESSAGE_SIZE        256
+#define MESSAGE_INTERVAL    10
+
+#define TICK_MS             (1000 / NX_IP_PERIODIC_RATE)
+
+#ifdef NX_ENABLE_TCP_SACK
+#define RECOVERY            "sack"
+#else
+#define RECOVERY            "newreno"
+#endif /* NX_ENABLE_TCP_SACK */
+
+/* Each message starts with its sequence number and the tick it was sent at. */
+typedef struct MESSAGE_HEADER_STRUCT
+{
+  ULONG sequence;
+  ULONG tick;
+} MESSAGE_HEADER;
+
+static const ULONG loss_ppms[] = {0, 10000, 20000, 50000, 100000};
+
+static TEST_NET_HOST device;
+static TEST_NET_HOST server;
+static NX_TCP_SOCKET device_socket;
+static NX_TCP_SOCKET server_socket;
+static TX_THREAD     device_thread;
+static TX_THREAD     server_thread;
+static ULONG64       device_stack[8192 / sizeof(ULONG64)];
+static ULONG64       server_stack[8192 / sizeof(ULONG64)];
+
+/* Receive side of the server, reset by the device between phases. */
+static UINT  message_size;
+static ULONG received_messages;
+static ULONG received_tick;
+static ULONG latencies[MESSAGES];
+static UINT  partial_length;
+static UCHAR partial[BULK_SEGMENT];
+
+static VOID server_receive(NX_PACKET* packet_ptr)
+{
+  UCHAR          data[TEST_NET_PACKET_SIZE];
+  ULONG          length;
+  ULONG          offset;
+  ULONG          size;
+  MESSAGE_HEADER header;
+
+  TEST_ASSERT(nx_packet_data_retrieve(packet_ptr, data, &length) == NX_SUCCESS);
+  nx_packet_release(packet_ptr);
+
+  for (offset = 0; offset < length; offset += size)
+  {
+    size = message_size - partial_length;
+    if (size > length - offset)
+    {
+      size = length - offset;
+    }
+    memcpy(&partial[partial_length], &data[offset], size);
+    partial_length += size;
+
+    if (partial_length == message_size)
+    {
+      memcpy(&header, partial, sizeof(header));
+      TEST_ASSERT(header.sequence == received_messages);
+      if (received_messages < MESSAGES)
+      {
+        latencies[received_messages] = tx_time_get() - header.tick;
+      }
+      received_messages++;
+      received_tick = tx_time_get();
+      partial_length = 0;
+    }
+  }
+}
+
+static VOID server_entry(ULONG input)
+{
+  NX_PACKET* packet_ptr;
+
+  (void)input;
+
+  TEST_ASSERT(nx_tcp_socket_create(&server.ip,
+                  &server_socket,
+                  "Server",
+                  NX_IP_NORMAL,
+                  NX_FRAGMENT_OKAY,
+                  NX_IP_TIME_TO_LIVE,
+                  SERVER_WINDOW,
+                  NX_NULL,
+                  NX_NULL) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_server_socket_listen(&server.ip, SERVER_PORT, &server_socket, 1, NX_NULL) == NX_SUCCESS);
+
+  for (;;)
+  {
+    if (nx_tcp_server_socket_accept(&server_socket, NX_WAIT_FOREVER) == NX_SUCCESS)
+    {
+      while (nx_tcp_socket_receive(&server_socket, &packet_ptr, NX_WAIT_FOREVER) == NX_SUCCESS)
+      {
+        server_receive(packet_ptr);
+      }
+    }
+
+    /* Close on the FIN of the device; without a wait the connection is reset. */
+    nx_tcp_socket_disconnect(&server_socket, NX_IP_PERIODIC_RATE);
+    nx_tcp_server_socket_unaccept(&server_socket);
+    nx_tcp_server_socket_relisten(&server.ip, SERVER_PORT, &server_socket);
+  }
+}
+
+static VOID phase_start(UINT size)
+{
+  message_size = size;
+  received_messages = 0;
+  partial_length = 0;
+}
+
+/* Wait until the server received the messages of the phase, return the tick
+   of the last one. */
+static ULONG phase_wait(ULONG messages)
+{
+  while (received_messages < messages)
+  {
+    tx_thread_sleep(1);
+  }
+
+  return received_tick;
+}
+
+static VOID message_send(ULONG sequence, UINT size)
+{
+  NX_PACKET*     packet_ptr;
+  UCHAR          data[BULK_SEGMENT];
+  MESSAGE_HEADER header;
+
+  header.sequence = sequence;
+  header.tick = tx_time_get();
+  memset(data, (int)sequence, size);
+  memcpy(data, &header, sizeof(header));
+
+  TEST_ASSERT(nx_packet_allocate(&device.pool, &packet_ptr, NX_TCP_PACKET, NX_WAIT_FOREVER) == NX_SUCCESS);
+  TEST_ASSERT(nx_packet_data_append(packet_ptr, data, size, &device.pool, NX_WAIT_FOREVER) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_socket_send(&device_socket, packet_ptr, NX_WAIT_FOREVER) == NX_SUCCESS);
+}
+
+static int latency_compare(const void* a, const void* b)
+{
+  ULONG x = *(const ULONG*)a;
+  ULONG y = *(const ULONG*)b;
+
+  return (x > y) - (x < y);
+}
+
+static VOID run(ULONG loss_ppm)
+{
+  UINT  device_station = nx_host_link_station_get(&device.ip);
+  UINT  server_station = nx_host_link_station_get(&server.ip);
+  ULONG retransmits = device_socket.nx_tcp_socket_retransmit_packets;
+  ULONG start;
+  ULONG bulk_ticks;
+  ULONG i;
+
+  TEST_ASSERT(nx_tcp_client_socket_bind(&device_socket, NX_ANY_PORT, NX_WAIT_FOREVER) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_client_socket_connect(&device_socket, TEST_NET_ADDRESS(1), SERVER_PORT, NX_WAIT_FOREVER) ==
+              NX_SUCCESS);
+
+  /* The same losses for both builds. */
+  nx_host_link_loss_set(device_station, loss_ppm, 0x1234 + loss_ppm);
+  nx_host_link_loss_set(server_station, loss_ppm, 0x5678 + loss_ppm);
+
+  phase_start(BULK_SEGMENT);
+  start = tx_time_get();
+  for (i = 0; i < BULK_BYTES / BULK_SEGMENT; i++)
+  {
+    message_send(i, BULK_SEGMENT);
+  }
+  bulk_ticks = phase_wait(BULK_BYTES / BULK_SEGMENT) - start;
+
+  phase_start(MESSAGE_SIZE);
+  for (i = 0; i < MESSAGES; i++)
+  {
+    message_send(i, MESSAGE_SIZE);
+    tx_thread_sleep(MESSAGE_INTERVAL);
+  }
+  phase_wait(MESSAGES);
+  qsort(latencies, MESSAGES, sizeof(latencies[0]), latency_compare);
+
+  test_result("tcp_loss",
+      "\"recovery\":\"%s\",\"loss_pct\":%.0f,\"goodput_kbps\":%lu,\"latency_p50_ms\":%lu,\"latency_p99_ms\":%lu,"
+      "\"latency_max_ms\":%lu,\"retransmits\":%lu",
+      RECOVERY,
+      loss_ppm / 10000.0,
+      (unsigned long)((BULK_BYTES / BULK_SEGMENT) * BULK_SEGMENT * 8ULL * NX_IP_PERIODIC_RATE / 1000 / bulk_ticks),
+      (unsigned long)(latencies[MESSAGES / 2] * TICK_MS),
+      (unsigned long)(latencies[MESSAGES * 99 / 100] * TICK_MS),
+      (unsigned long)(latencies[MESSAGES - 1] * TICK_MS),
+      (unsigned long)(device_socket.nx_tcp_socket_retransmit_packets - retransmits));
+
+  nx_host_link_loss_set(device_station, 0, 0);
+  nx_host_link_loss_set(server_station, 0, 0);
+  TEST_ASSERT(nx_tcp_socket_disconnect(&device_socket, 5 * NX_IP_PERIODIC_RATE) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_client_socket_unbind(&device_socket) == NX_SUCCESS);
+}
+
+static VOID device_entry(ULONG input)
+{
+  UINT i;
+
+  (void)input;
+
+  nx_host_link_configure(LINK_DELAY, LINK_RATE, LINK_QUEUE);
+  TEST_ASSERT(test_net_host_create(&server, "Server", TEST_NET_ADDRESS(1), SERVER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_net_host_create(&device, "Device", TEST_NET_ADDRESS(2), DEVICE_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_socket_create(&device.ip,
+                  &device_socket,
+                  "Device",
+                  NX_IP_NORMAL,
+                  NX_FRAGMENT_OKAY,
+                  NX_IP_TIME_TO_LIVE,
+                  DEVICE_WINDOW,
+                  NX_NULL,
+                  NX_NULL) == NX_SUCCESS);
+  TEST_ASSERT(tx_thread_create(&server_thread,
+                  "Server",
+                  server_entry,
+                  0,
+                  server_stack,
+                  sizeof(server_stack),
+                  SERVER_PRIORITY,
+                  SERVER_PRIORITY,
+                  TX_NO_TIME_SLICE,
+                  TX_AUTO_START) == TX_SUCCESS);
+
+  for (i = 0; i < sizeof(loss_ppms) / sizeof(loss_ppms[0]); i++)
+  {
+    run(loss_ppms[i]);
+  }
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  nx_system_initialize();
+  tx_thread_create(&device_thread,
+      "Device",
+      device_entry,
+      0,
+      device_stack,
+      sizeof(device_stack),
+      DEVICE_PRIORITY,
+      DEVICE_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(1000000);
+}
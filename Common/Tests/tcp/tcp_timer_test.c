@@ -0,0 +1,303 @@
+/**
+  ******************************************************************************
+  * @file    tcp_timer_test.c
+  * @brief   IP thread wakeups and CPU time per TCP socket count
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The device opens 1 to 32 TCP connections to the server. For each count, the
+   connections are first left idle, then each sends a telemetry sized message
+   every second, the sends spread over the second. For both phases the test
+   reports the wakeups of the device IP thread per second and its CPU time, per
+   second and per wakeup.
+
+   The program is built twice: tcp_timer_test with the board configuration,
+   NX_TCP_FAST_TIMER_ON_DEMAND, and tcp_timer_test_periodic with the fast TCP
+   timer waking the IP thread every 100 ms, config/periodic. Idle, the on
+   demand timer leaves only the wakeups of the 1 s slow timer. */
+
+#include "test_common.h"
+#include "test_net.h"
+
+#include "nx_ip.h"
+
+#define DEVICE_PRIORITY     10
+#define SERVER_PRIORITY     5
+#define DEVICE_PACKETS      64
+#define SERVER_PACKETS      128
+#define SERVER_PORT         5000
+#define SOCKET_WINDOW       8192
+
+#define LINK_DELAY          2
+#define LINK_RATE           2500
+#define LINK_QUEUE          (64 * 1024)
+
+#define SOCKETS_MAX         32
+#define MESSAGE_SIZE        100
+#define IDLE_SECONDS        60
+#define ACTIVE_SECONDS      60
+
+#define SERVER_ACCEPT       1
+#define SERVER_RECEIVE      2
+
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+#define TIMER               "on_demand"
+#else
+#define TIMER               "periodic"
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
+
+static const UINT socket_counts[] = {1, 2, 4, 8, 16, 32};
+
+static TEST_NET_HOST        device;
+static TEST_NET_HOST        server;
+static NX_TCP_SOCKET        device_sockets[SOCKETS_MAX];
+static NX_TCP_SOCKET        server_sockets[SOCKETS_MAX];
+static UINT                 socket_count;
+static UINT                 server_accepted;
+static TX_EVENT_FLAGS_GROUP server_events;
+static ULONG                server_bytes;
+static TX_THREAD            device_thread;
+static TX_THREAD            server_thread;
+static ULONG64              device_stack[8192 / sizeof(ULONG64)];
+static ULONG64              server_stack[8192 / sizeof(ULONG64)];
+
+static VOID server_listen_notify(NX_TCP_SOCKET* socket_ptr, UINT port)
+{
+  (void)socket_ptr;
+  (void)port;
+
+  tx_event_flags_set(&server_events, SERVER_ACCEPT, TX_OR);
+}
+
+static VOID server_receive_notify(NX_TCP_SOCKET* socket_ptr)
+{
+  (void)socket_ptr;
+
+  tx_event_flags_set(&server_events, SERVER_RECEIVE, TX_OR);
+}
+
+/* Accept the connections requested and drain the connections accepted,
+   counting the bytes received. */
+static VOID server_entry(ULONG input)
+{
+  NX_PACKET* packet_ptr;
+  ULONG      flags;
+  UINT       i;
+
+  (void)input;
+
+  for (;;)
+  {
+    tx_event_flags_get(&server_events, SERVER_ACCEPT | SERVER_RECEIVE, TX_OR_CLEAR, &flags, TX_WAIT_FOREVER);
+
+    if (flags & SERVER_ACCEPT)
+    {
+      TEST_ASSERT(nx_tcp_server_socket_accept(&server_sockets[server_accepted], NX_IP_PERIODIC_RATE) == NX_SUCCESS);
+      server_accepted++;
+    }
+
+    for (i = 0; i < server_accepted; i++)
+    {
+      while (nx_tcp_socket_receive(&server_sockets[i], &packet_ptr, NX_NO_WAIT) == NX_SUCCESS)
+      {
+        server_bytes += packet_ptr->nx_packet_length;
+        nx_packet_release(packet_ptr);
+      }
+    }
+  }
+}
+
+/* Connect one more device socket, taken by the next server socket listening. */
+static VOID socket_add(VOID)
+{
+  NX_TCP_SOCKET* server_socket_ptr = &server_sockets[socket_count];
+  NX_TCP_SOCKET* device_socket_ptr = &device_sockets[socket_count];
+
+  TEST_ASSERT(nx_tcp_socket_create(&server.ip,
+                  server_socket_ptr,
+                  "Server",
+                  NX_IP_NORMAL,
+                  NX_FRAGMENT_OKAY,
+                  NX_IP_TIME_TO_LIVE,
+                  SOCKET_WINDOW,
+                  NX_NULL,
+                  NX_NULL) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_socket_receive_notify(server_socket_ptr, server_receive_notify) == NX_SUCCESS);
+  if (socket_count == 0)
+  {
+    TEST_ASSERT(nx_tcp_server_socket_listen(&server.ip, SERVER_PORT, server_socket_ptr, 1, server_listen_notify) ==
+                NX_SUCCESS);
+  }
+  else
+  {
+    TEST_ASSERT(nx_tcp_server_socket_relisten(&server.ip, SERVER_PORT, server_socket_ptr) == NX_SUCCESS);
+  }
+
+  TEST_ASSERT(nx_tcp_socket_create(&device.ip,
+                  device_socket_ptr,
+                  "Device",
+                  NX_IP_NORMAL,
+                  NX_FRAGMENT_OKAY,
+                  NX_IP_TIME_TO_LIVE,
+                  SOCKET_WINDOW,
+                  NX_NULL,
+                  NX_NULL) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_client_socket_bind(device_socket_ptr, NX_ANY_PORT, NX_WAIT_FOREVER) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_client_socket_connect(device_socket_ptr, TEST_NET_ADDRESS(1), SERVER_PORT, NX_WAIT_FOREVER) ==
+              NX_SUCCESS);
+  socket_count++;
+
+  while (server_accepted < socket_count)
+  {
+    tx_thread_sleep(1);
+  }
+}
+
+static VOID message_send(NX_TCP_SOCKET* socket_ptr)
+{
+  NX_PACKET* packet_ptr;
+  UCHAR      data[MESSAGE_SIZE];
+
+  memset(data, 'x', sizeof(data));
+  TEST_ASSERT(nx_packet_allocate(&device.pool, &packet_ptr, NX_TCP_PACKET, NX_WAIT_FOREVER) == NX_SUCCESS);
+  TEST_ASSERT(nx_packet_data_append(packet_ptr, data, sizeof(data), &device.pool, NX_WAIT_FOREVER) == NX_SUCCESS);
+  TEST_ASSERT(nx_tcp_socket_send(socket_ptr, packet_ptr, NX_WAIT_FOREVER) == NX_SUCCESS);
+}
+
+/* Sleep until tick, a time of the measure that must not have passed. */
+static VOID sleep_until(ULONG tick)
+{
+  ULONG now = tx_time_get();
+
+  TEST_ASSERT((LONG)(tick - now) >= 0);
+  if (tick != now)
+  {
+    tx_thread_sleep(tick - now);
+  }
+}
+
+static VOID measure(const CHAR* phase, ULONG seconds, UINT active)
+{
+  TX_THREAD* ip_thread_ptr = &device.ip.nx_ip_thread;
+  ULONG      runs = ip_thread_ptr->tx_thread_run_count;
+  ULONG64    cpu_ns = tx_host_thread_cpu_ns(ip_thread_ptr);
+  ULONG      bytes = server_bytes;
+  ULONG      start = tx_time_get();
+  ULONG      wakeups;
+  ULONG      second;
+  UINT       i;
+
+  for (second = 0; active && (second < seconds); second++)
+  {
+    for (i = 0; i < socket_count; i++)
+    {
+      sleep_until(start + second * NX_IP_PERIODIC_RATE + i * NX_IP_PERIODIC_RATE / socket_count);
+      message_send(&device_sockets[i]);
+    }
+  }
+  sleep_until(start + seconds * NX_IP_PERIODIC_RATE);
+
+  wakeups = ip_thread_ptr->tx_thread_run_count - runs;
+  cpu_ns = tx_host_thread_cpu_ns(ip_thread_ptr) - cpu_ns;
+
+  /* Idle, only the timers of the IP instance wake its thread: the slow timer
+     every second and, unless on demand, the fast timer every 100 ms. */
+  if (!active)
+  {
+#ifdef NX_TCP_FAST_TIMER_ON_DEMAND
+    TEST_ASSERT(wakeups <= seconds + 1);
+#else
+    TEST_ASSERT(wakeups >= seconds * NX_IP_FAST_TIMER_RATE);
+#endif /* NX_TCP_FAST_TIMER_ON_DEMAND */
+  }
+
+  test_result("tcp_timer",
+      "\"timer\":\"%s\",\"phase\":\"%s\",\"sockets\":%u,\"wakeups_per_s\":%.1f,\"ip_cpu_us_per_s\":%.1f,"
+      "\"ip_cpu_ns_per_wakeup\":%llu",
+      TIMER,
+      phase,
+      socket_count,
+      (double)wakeups / seconds,
+      cpu_ns / 1000.0 / seconds,
+      wakeups ? cpu_ns / wakeups : 0);
+
+  /* Every message reached the server. */
+  if (active)
+  {
+    for (i = 0; (i < 100) && (server_bytes - bytes < seconds * socket_count * MESSAGE_SIZE); i++)
+    {
+      tx_thread_sleep(1);
+    }
+    TEST_ASSERT(server_bytes - bytes == seconds * socket_count * MESSAGE_SIZE);
+  }
+}
+
+static VOID device_entry(ULONG input)
+{
+  UINT i;
+
+  (void)input;
+
+  nx_host_link_configure(LINK_DELAY, LINK_RATE, LINK_QUEUE);
+  TEST_ASSERT(test_net_host_create(&server, "Server", TEST_NET_ADDRESS(1), SERVER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_net_host_create(&device, "Device", TEST_NET_ADDRESS(2), DEVICE_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(tx_event_flags_create(&server_events, "Server") == TX_SUCCESS);
+  TEST_ASSERT(tx_thread_create(&server_thread,
+                  "Server",
+                  server_entry,
+                  0,
+                  server_stack,
+                  sizeof(server_stack),
+                  SERVER_PRIORITY,
+                  SERVER_PRIORITY,
+                  TX_NO_TIME_SLICE,
+                  TX_AUTO_START) == TX_SUCCESS);
+
+  for (i = 0; i < sizeof(socket_counts) / sizeof(socket_counts[0]); i++)
+  {
+    while (socket_count < socket_counts[i])
+    {
+      socket_add();
+    }
+
+    /* Let the timeouts of the connects expire before measuring. */
+    tx_thread_sleep(2 * NX_IP_PERIODIC_RATE);
+
+    measure("idle", IDLE_SECONDS, NX_FALSE);
+    measure("active", ACTIVE_SECONDS, NX_TRUE);
+  }
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  nx_system_initialize();
+  tx_thread_create(&device_thread,
+      "Device",
+      device_entry,
+      0,
+      device_stack,
+      sizeof(device_stack),
+      DEVICE_PRIORITY,
+      DEVICE_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(200000);
+}
@@ -0,0 +1,253 @@
+/**
+  ******************************************************************************
+  * @file    thread_profile_test.c
+  * @brief   Checks of the thread profiler on the simulated cycle counter
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* thread_profile.c of the board runs on the execution profile hooks of the
+   host port, THREAD_PROFILE_CYCLES is the simulated cycle counter. Each tick
+   a setter thread sets the event flags of two workers, then runs
+   SETTER_CYCLES before it sleeps again. The workers run A_CYCLES and
+   B_CYCLES on each wake, the first at a higher priority than the second.
+   Over a window of one second the profile must show:
+   - the CPU share of each thread, against the cycles it ran;
+   - one wake per set, the first worker waiting for the setter, the second
+     for the setter and the first worker;
+   - the idle share, what the window has left.
+   The next window, with the setter stopped, has no wake and no load.
+
+   The threads of the host port run on host stacks and leave their ThreadX
+   stack as filled by tx_thread_create, so a high-water mark never moves on
+   its own. The test writes into the stack of a worker as a deep call would,
+   and checks the profiler finds it. */
+
+#include <string.h>
+
+#include "stm32u5xx.h"
+#include "test_common.h"
+#include "thread_profile.h"
+
+#define TEST_PRIORITY     4
+#define SETTER_PRIORITY   6
+#define A_PRIORITY        8
+#define B_PRIORITY        10
+
+/* At the 160 MHz of the board, 100, 200 and 600 us. */
+#define CYCLES_PER_US     (SystemCoreClock / 1000000)
+#define SETTER_CYCLES     16000
+#define A_CYCLES          32000
+#define B_CYCLES          96000
+
+#define WINDOW_TICKS      TX_TIMER_TICKS_PER_SECOND
+#define STACK_MARK        1536
+
+#define FLAG_A            1
+#define FLAG_B            2
+
+static TX_THREAD            test_thread;
+static TX_THREAD            setter_thread;
+static TX_THREAD            a_thread;
+static TX_THREAD            b_thread;
+static ULONG64              test_stack[4096 / sizeof(ULONG64)];
+static ULONG64              setter_stack[2048 / sizeof(ULONG64)];
+static ULONG64              a_stack[4096 / sizeof(ULONG64)];
+static ULONG64              b_stack[2048 / sizeof(ULONG64)];
+static TX_EVENT_FLAGS_GROUP work;
+static THREAD_PROFILE       profile;
+static volatile UINT        setter_run;
+static ULONG                sets;
+
+/* Run for cycles of the counter. */
+static VOID cycles_burn(ULONG cycles)
+{
+  ULONG start = THREAD_PROFILE_CYCLES();
+
+  while ((ULONG)(THREAD_PROFILE_CYCLES() - start) < cycles)
+  {
+  }
+}
+
+static VOID setter_entry(ULONG input)
+{
+  (void)input;
+
+  for (;;)
+  {
+    tx_thread_sleep(1);
+    if (setter_run)
+    {
+      sets++;
+      tx_event_flags_set(&work, FLAG_A | FLAG_B, TX_OR);
+      cycles_burn(SETTER_CYCLES);
+    }
+  }
+}
+
+static VOID worker_entry(ULONG input)
+{
+  ULONG flags;
+
+  for (;;)
+  {
+    tx_event_flags_get(&work, input, TX_OR_CLEAR, &flags, TX_WAIT_FOREVER);
+    cycles_burn((input == FLAG_A) ? A_CYCLES : B_CYCLES);
+  }
+}
+
+static THREAD_PROFILE_ENTRY* profile_entry(TX_THREAD* thread)
+{
+  UINT index;
+
+  for (index = 0; index < profile.count; index++)
+  {
+    if (profile.thread[index].name == thread->tx_thread_name)
+    {
+      return &profile.thread[index];
+    }
+  }
+
+  TEST_ASSERT(0);
+  return TX_NULL;
+}
+
+/* The CPU share of cycles per tick, within one permille. */
+static VOID cpu_check(THREAD_PROFILE_ENTRY* entry, ULONG cycles)
+{
+  ULONG expected = (ULONG)((ULONG64)cycles * 1000 / (SystemCoreClock / TX_TIMER_TICKS_PER_SECOND));
+
+  TEST_ASSERT((entry->cpu_permille + 1 >= expected) && (entry->cpu_permille <= expected + 1));
+}
+
+/* The average wake latency, the cycles run before the thread, plus up to 20 us
+   of switching on the host. */
+static VOID wake_check(THREAD_PROFILE_ENTRY* entry, ULONG cycles)
+{
+  ULONG expected = cycles / CYCLES_PER_US;
+
+  TEST_ASSERT((entry->wakes + 1 >= sets) && (entry->wakes <= sets + 1));
+  TEST_ASSERT((entry->wake_avg_us >= expected) && (entry->wake_avg_us <= expected + 20));
+  TEST_ASSERT(entry->wake_max_us >= entry->wake_avg_us);
+}
+
+static VOID profile_report(const CHAR* window)
+{
+  THREAD_PROFILE_ENTRY* entry;
+  UINT                  index;
+
+  test_result("thread_profile",
+      "\"window\":\"%s\",\"window_ms\":%lu,\"idle_permille\":%lu,\"threads\":%u,\"sets\":%lu",
+      window,
+      profile.window_ms,
+      profile.idle_permille,
+      profile.count,
+      sets);
+
+  for (index = 0; index < profile.count; index++)
+  {
+    entry = &profile.thread[index];
+    test_result("thread_profile",
+        "\"window\":\"%s\",\"thread\":\"%s\",\"priority\":%u,\"cpu_permille\":%lu,\"stack_used\":%lu,"
+        "\"stack_size\":%lu,\"wakes\":%lu,\"wake_avg_us\":%lu,\"wake_max_us\":%lu",
+        window,
+        entry->name,
+        entry->priority,
+        entry->cpu_permille,
+        entry->stack_used,
+        entry->stack_size,
+        entry->wakes,
+        entry->wake_avg_us,
+        entry->wake_max_us);
+  }
+}
+
+static VOID test_entry(ULONG input)
+{
+  THREAD_PROFILE_ENTRY* a;
+  THREAD_PROFILE_ENTRY* b;
+  THREAD_PROFILE_ENTRY* setter;
+  ULONG                 busy;
+
+  (void)input;
+
+  TEST_ASSERT(thread_profile_init() == TX_SUCCESS);
+
+  /* Loaded window. */
+  setter_run = TX_TRUE;
+  tx_thread_sleep(WINDOW_TICKS);
+  setter_run = TX_FALSE;
+
+  /* A deep call of the first worker, in its ThreadX stack. */
+  memset((UCHAR*)a_thread.tx_thread_stack_end - STACK_MARK + 1, 0, STACK_MARK);
+
+  TEST_ASSERT(thread_profile_get(&profile) == TX_SUCCESS);
+  profile_report("loaded");
+
+  TEST_ASSERT(profile.window_ms == WINDOW_TICKS * 1000 / TX_TIMER_TICKS_PER_SECOND);
+  TEST_ASSERT(sets >= WINDOW_TICKS - 1);
+
+  setter = profile_entry(&setter_thread);
+  a = profile_entry(&a_thread);
+  b = profile_entry(&b_thread);
+
+  cpu_check(setter, SETTER_CYCLES);
+  cpu_check(a, A_CYCLES);
+  cpu_check(b, B_CYCLES);
+
+  wake_check(a, SETTER_CYCLES);
+  wake_check(b, SETTER_CYCLES + A_CYCLES);
+  TEST_ASSERT(setter->wakes == 0);
+
+  busy = (ULONG)((ULONG64)(SETTER_CYCLES + A_CYCLES + B_CYCLES) * 1000 /
+                 (SystemCoreClock / TX_TIMER_TICKS_PER_SECOND));
+  TEST_ASSERT((profile.idle_permille + busy >= 995) && (profile.idle_permille + busy <= 1001));
+
+  TEST_ASSERT(a->stack_size == sizeof(a_stack));
+  TEST_ASSERT(a->stack_used == STACK_MARK);
+  TEST_ASSERT(b->stack_used < STACK_MARK);
+
+  /* Idle window, the counters were restarted. */
+  tx_thread_sleep(WINDOW_TICKS);
+  sets = 0;
+  TEST_ASSERT(thread_profile_get(&profile) == TX_SUCCESS);
+  profile_report("idle");
+
+  a = profile_entry(&a_thread);
+  b = profile_entry(&b_thread);
+  TEST_ASSERT((a->wakes == 0) && (b->wakes == 0));
+  TEST_ASSERT((a->cpu_permille == 0) && (b->cpu_permille == 0));
+  TEST_ASSERT(a->stack_used == STACK_MARK);
+  TEST_ASSERT(profile.idle_permille >= 995);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_event_flags_create(&work, "Work");
+  tx_thread_create(&test_thread, "Test", test_entry, 0, test_stack, sizeof(test_stack), TEST_PRIORITY,
+      TEST_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+  tx_thread_create(&setter_thread, "Setter", setter_entry, 0, setter_stack, sizeof(setter_stack),
+      SETTER_PRIORITY, SETTER_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+  tx_thread_create(&a_thread, "Worker A", worker_entry, FLAG_A, a_stack, sizeof(a_stack), A_PRIORITY,
+      A_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+  tx_thread_create(&b_thread, "Worker B", worker_entry, FLAG_B, b_stack, sizeof(b_stack), B_PRIORITY,
+      B_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(1000);
+}
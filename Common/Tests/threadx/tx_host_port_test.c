@@ -0,0 +1,71 @@
+/**
+  ******************************************************************************
+  * @file    tx_host_port_test.c
+  * @brief   Checks of the ThreadX host port: preemption, sleep, time-slicing
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include "test_common.h"
+
+static TX_THREAD    low_thread;
+static TX_THREAD    high_thread;
+static ULONG        low_stack[1024];
+static ULONG        high_stack[1024];
+static TX_SEMAPHORE semaphore;
+static UINT         order[8];
+static UINT         order_count;
+
+static VOID high_entry(ULONG input)
+{
+  (void)input;
+
+  tx_semaphore_get(&semaphore, TX_WAIT_FOREVER);
+  order[order_count++] = 2;
+  tx_thread_sleep(10);
+  order[order_count++] = 4;
+}
+
+static VOID low_entry(ULONG input)
+{
+  ULONG start;
+
+  (void)input;
+
+  order[order_count++] = 1;
+
+  /* The put resumes the higher priority thread at once. */
+  tx_semaphore_put(&semaphore);
+  order[order_count++] = 3;
+
+  start = tx_time_get();
+  tx_thread_sleep(20);
+  TEST_ASSERT(tx_time_get() - start == 20);
+  TEST_ASSERT(order_count == 4);
+  TEST_ASSERT(order[0] == 1 && order[1] == 2 && order[2] == 3 && order[3] == 4);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_semaphore_create(&semaphore, "semaphore", 0);
+  tx_thread_create(&high_thread, "high", high_entry, 0, high_stack, sizeof(high_stack), 5, 5, TX_NO_TIME_SLICE, TX_AUTO_START);
+  tx_thread_create(&low_thread, "low", low_entry, 0, low_stack, sizeof(low_stack), 10, 10, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100);
+}
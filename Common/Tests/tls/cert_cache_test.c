@@ -0,0 +1,241 @@
+/**
+  ******************************************************************************
+  * @file    cert_cache_test.c
+  * @brief   Handshake cost with the verified certificate cache cold and warm
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The broker presents a certificate issued by an intermediate authority,
+   with the intermediate, as the IoT Hub and DPS do; the device trusts the
+   authority above the intermediate, along with the test authority. Every
+   connect is a full handshake, the broker forgets its sessions before each.
+   Each round connects twice: once after _nx_secure_x509_verify_cache_clear,
+   the two signatures of the chain are checked (two misses), then with the
+   cache warm, both are skipped (two hits). The test reports the CPU time of
+   the device threads per connect, cold and warm.
+
+   With the cache warm, the checks the cache does not cover still fail a
+   handshake:
+   - a hub name other than the common name of the certificate, the chain is
+     taken from the cache and the name check of Azure IoT refuses it;
+   - a device clock past the end of the validity, the expiration is checked
+     before the chain. */
+
+#include "nx_secure_x509.h"
+#include "test_broker.h"
+#include "test_common.h"
+#include "test_dns.h"
+#include "test_hub.h"
+#include "test_tls.h"
+
+#define DEVICE_PRIORITY     10
+#define DEVICE_PACKETS      64
+#define BROKER_PACKETS      64
+#define DNS_PACKETS         16
+
+/* The link: 50 ms one way, 2 Mbit/s. */
+#define LINK_DELAY          5
+#define LINK_RATE           2500
+#define LINK_QUEUE          (64 * 1024)
+
+#define ROUNDS              5
+
+/* Signatures in the chain: the broker certificate and the intermediate. */
+#define CHAIN_SIGNATURES    2
+
+/* Another name of the broker, resolved as the hub. */
+#define OTHER_HOSTNAME      "other-broker"
+
+/* Past the end of every test certificate, and of UTCTime. */
+#define EXPIRED_OFFSET      (30L * 365 * 24 * 3600)
+
+#define TICK_MS             (1000 / NX_IP_PERIODIC_RATE)
+
+typedef struct CONNECT_COST_STRUCT
+{
+  ULONG   connects;
+  ULONG   ticks;
+  ULONG64 cpu_ns;
+  ULONG   hits;
+  ULONG   misses;
+} CONNECT_COST;
+
+static TEST_NET_HOST       device;
+static TEST_BROKER         broker;
+static TEST_DNS            dns;
+static TEST_HUB_CLIENT     hub;
+static NX_SECURE_X509_CERT chain_ca;
+static TX_THREAD           device_thread;
+static ULONG64             device_stack[16384 / sizeof(ULONG64)];
+
+/* The handshake runs on the connecting thread, the records are received on
+   the IP thread and the MQTT client runs on the cloud thread of Azure IoT. */
+static ULONG64 device_cpu_ns(VOID)
+{
+  return tx_host_thread_cpu_ns(&device_thread) + tx_host_thread_cpu_ns(&device.ip.nx_ip_thread) +
+         tx_host_thread_cpu_ns(&hub.nx_azure_iot.nx_azure_iot_cloud.nx_cloud_thread);
+}
+
+/* Let the broker close its side before the next connect. */
+static VOID broker_idle_wait(VOID)
+{
+  while (broker.connected)
+  {
+    tx_thread_sleep(1);
+  }
+}
+
+/* A full handshake, adding its cost and the cache counters to cost_ptr. */
+static VOID connect_once(CONNECT_COST* cost_ptr)
+{
+  ULONG   handshakes = broker.stats.handshakes;
+  ULONG   hits = _nx_secure_x509_verify_cache_hits;
+  ULONG   misses = _nx_secure_x509_verify_cache_misses;
+  ULONG   start;
+  ULONG64 cpu_start;
+
+  test_broker_sessions_flush(&broker);
+
+  start = tx_time_get();
+  cpu_start = device_cpu_ns();
+
+  TEST_ASSERT(nx_azure_iot_hub_client_connect(&hub.hub_client, NX_TRUE, NX_WAIT_FOREVER) == NX_AZURE_IOT_SUCCESS);
+
+  cost_ptr->ticks += tx_time_get() - start;
+  cost_ptr->cpu_ns += device_cpu_ns() - cpu_start;
+  cost_ptr->hits += _nx_secure_x509_verify_cache_hits - hits;
+  cost_ptr->misses += _nx_secure_x509_verify_cache_misses - misses;
+  cost_ptr->connects++;
+
+  TEST_ASSERT(broker.stats.handshakes == handshakes + 1);
+  TEST_ASSERT(broker.stats.handshakes_resumed == 0);
+
+  TEST_ASSERT(nx_azure_iot_hub_client_disconnect(&hub.hub_client) == NX_AZURE_IOT_SUCCESS);
+  broker_idle_wait();
+}
+
+/* A connect the device must refuse, returns the cache hits it made. */
+static ULONG connect_refused(VOID)
+{
+  ULONG hits = _nx_secure_x509_verify_cache_hits;
+  ULONG misses = _nx_secure_x509_verify_cache_misses;
+
+  test_broker_sessions_flush(&broker);
+  TEST_ASSERT(nx_azure_iot_hub_client_connect(&hub.hub_client, NX_TRUE, NX_WAIT_FOREVER) != NX_AZURE_IOT_SUCCESS);
+  broker_idle_wait();
+
+  TEST_ASSERT(_nx_secure_x509_verify_cache_misses == misses);
+
+  return _nx_secure_x509_verify_cache_hits - hits;
+}
+
+static VOID cost_report(const CHAR* cache, CONNECT_COST* cost_ptr)
+{
+  test_result("cert_cache",
+      "\"cache\":\"%s\",\"connects\":%lu,\"connect_ms\":%lu,\"cpu_us\":%llu,\"hits\":%lu,\"misses\":%lu",
+      cache,
+      cost_ptr->connects,
+      cost_ptr->ticks * TICK_MS / cost_ptr->connects,
+      cost_ptr->cpu_ns / 1000 / cost_ptr->connects,
+      cost_ptr->hits,
+      cost_ptr->misses);
+}
+
+static VOID device_entry(ULONG input)
+{
+  CONNECT_COST  cold = {0};
+  CONNECT_COST  warm = {0};
+  CONNECT_COST  check = {0};
+  NX_AZURE_IOT_RESOURCE* resource = &hub.hub_client.nx_azure_iot_hub_client_resource;
+  UINT          round;
+
+  (void)input;
+
+  test_log_mute();
+  nx_host_link_configure(LINK_DELAY, LINK_RATE, LINK_QUEUE);
+  nx_secure_tls_initialize();
+  TEST_ASSERT(test_broker_create(&broker, TEST_NET_ADDRESS(1), BROKER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_broker_chain_use(&broker) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_create(&dns, TEST_NET_ADDRESS(3), DNS_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_record_add(&dns, TEST_HUB_HOSTNAME, TEST_NET_ADDRESS(1)) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_record_add(&dns, OTHER_HOSTNAME, TEST_NET_ADDRESS(1)) == NX_SUCCESS);
+  TEST_ASSERT(test_net_host_create(&device, "Device", TEST_NET_ADDRESS(2), DEVICE_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_hub_client_create(&hub, &device, TEST_NET_ADDRESS(3)) == NX_SUCCESS);
+
+  /* The roots of the board are trusted together, the chain leads to the second one. */
+  TEST_ASSERT(nx_secure_x509_certificate_initialize(&chain_ca,
+                  (UCHAR*)test_tls_chain_ca_cert,
+                  (USHORT)test_tls_chain_ca_cert_size,
+                  NX_NULL,
+                  0,
+                  NX_NULL,
+                  0,
+                  NX_SECURE_X509_KEY_TYPE_NONE) == NX_SECURE_X509_SUCCESS);
+  TEST_ASSERT(nx_azure_iot_hub_client_trusted_cert_add(&hub.hub_client, &chain_ca) == NX_AZURE_IOT_SUCCESS);
+
+  for (round = 0; round < ROUNDS; round++)
+  {
+    _nx_secure_x509_verify_cache_clear();
+    connect_once(&cold);
+    connect_once(&warm);
+  }
+
+  TEST_ASSERT((cold.hits == 0) && (cold.misses == ROUNDS * CHAIN_SIGNATURES));
+  TEST_ASSERT((warm.hits == ROUNDS * CHAIN_SIGNATURES) && (warm.misses == 0));
+  TEST_ASSERT(warm.cpu_ns < cold.cpu_ns);
+
+  cost_report("cold", &cold);
+  cost_report("warm", &warm);
+
+  /* The name is checked on every handshake, after the chain. */
+  resource->resource_hostname = (const UCHAR*)OTHER_HOSTNAME;
+  resource->resource_hostname_length = sizeof(OTHER_HOSTNAME) - 1;
+  TEST_ASSERT(connect_refused() == CHAIN_SIGNATURES);
+  resource->resource_hostname = (const UCHAR*)TEST_HUB_HOSTNAME;
+  resource->resource_hostname_length = sizeof(TEST_HUB_HOSTNAME) - 1;
+
+  /* The expiration is checked on every handshake, before the chain. */
+  test_hub_time_offset = EXPIRED_OFFSET;
+  TEST_ASSERT(connect_refused() == 0);
+  test_hub_time_offset = 0;
+
+  /* The cache still holds the chain. */
+  connect_once(&check);
+  TEST_ASSERT((check.hits == CHAIN_SIGNATURES) && (check.misses == 0));
+
+  TEST_ASSERT(test_hub_client_delete(&hub) == NX_SUCCESS);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  nx_system_initialize();
+  tx_thread_create(&device_thread,
+      "Device",
+      device_entry,
+      0,
+      device_stack,
+      sizeof(device_stack),
+      DEVICE_PRIORITY,
+      DEVICE_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100000);
+}
@@ -0,0 +1,155 @@
+/**
+  ******************************************************************************
+  * @file    crypto_benchmark_test.c
+  * @brief   The NetX Crypto method benchmark on the simulated cycle counter
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* _nx_crypto_method_benchmark_run over the methods of the TLS connection:
+   AES-CBC and AES-GCM records and SHA-256 from 64 bytes to 16 KB, ECDSA and
+   ECDH on P-256 and P-384, RSA 2048 and 4096. The clock is the simulated
+   cycle counter of the host port, at the 160 MHz of the board, so the
+   ticks per operation are host time counted in board cycles: they compare
+   builds and configurations, not Cortex-M33 cycles.
+
+   Every measurement must pass and run at least once, each method must fit
+   the metadata area, and each result must format as one JSON line. Each
+   result is reported with its bytes per second and cycles per operation. */
+
+#include <string.h>
+
+#include "nx_crypto_method_benchmark.h"
+#include "stm32u5xx.h"
+#include "test_common.h"
+
+#define TEST_PRIORITY       4
+
+/* 20 ms of cycles per measurement. */
+#define BENCH_DURATION      (SystemCoreClock / 50)
+
+/* Encrypt and decrypt of the 3 ciphers and the 2 hashes at 5 sizes, ECDSA
+   sign and verify on 2 curves, ECDH on 2 curves, RSA public and private at
+   2 sizes. */
+#define BENCH_RESULTS       (8 * 5 + 4 + 2 + 4)
+
+#define LINE_SIZE           512
+
+extern NX_CRYPTO_METHOD crypto_method_aes_cbc_128;
+extern NX_CRYPTO_METHOD crypto_method_aes_128_gcm_16;
+extern NX_CRYPTO_METHOD crypto_method_aes_256_gcm_16;
+extern NX_CRYPTO_METHOD crypto_method_sha256;
+extern NX_CRYPTO_METHOD crypto_method_hmac_sha256;
+extern NX_CRYPTO_METHOD crypto_method_ecdsa;
+extern NX_CRYPTO_METHOD crypto_method_ecdh;
+extern NX_CRYPTO_METHOD crypto_method_rsa;
+
+static const NX_CRYPTO_METHOD* methods[] = {&crypto_method_aes_cbc_128,
+    &crypto_method_aes_128_gcm_16,
+    &crypto_method_aes_256_gcm_16,
+    &crypto_method_sha256,
+    &crypto_method_hmac_sha256,
+    &crypto_method_ecdsa,
+    &crypto_method_ecdh,
+    &crypto_method_rsa};
+
+/* NX_CRYPTO_BENCHMARK_ENCRYPT ... NX_CRYPTO_BENCHMARK_PRIVATE. */
+static const CHAR* operations[] = {
+    "", "encrypt", "decrypt", "hash", "sign", "verify", "key_exchange", "public", "private"};
+
+static TX_THREAD test_thread;
+static ULONG64   test_stack[32768 / sizeof(ULONG64)];
+static ULONG64   metadata[16384 / sizeof(ULONG64)];
+static UINT      results;
+
+static ULONG cycles_get(VOID)
+{
+  return (ULONG)_tx_host_cycles_get();
+}
+
+static VOID result_report(NX_CRYPTO_BENCHMARK_RESULT* result, VOID* context)
+{
+  CHAR line[LINE_SIZE];
+  UINT length;
+
+  (void)context;
+
+  TEST_ASSERT(result->nx_crypto_benchmark_result_status == NX_CRYPTO_SUCCESS);
+  TEST_ASSERT((result->nx_crypto_benchmark_result_operation >= NX_CRYPTO_BENCHMARK_ENCRYPT) &&
+              (result->nx_crypto_benchmark_result_operation <= NX_CRYPTO_BENCHMARK_PRIVATE));
+  TEST_ASSERT(result->nx_crypto_benchmark_result_count > 0);
+  TEST_ASSERT(result->nx_crypto_benchmark_result_ticks >= BENCH_DURATION);
+
+  TEST_ASSERT(_nx_crypto_method_benchmark_result_format(result, line, sizeof(line), &length) == NX_CRYPTO_SUCCESS);
+  TEST_ASSERT((length == strlen(line)) && (line[0] == '{') && (line[length - 1] == '\n'));
+
+  test_result("crypto_benchmark",
+      "\"method\":\"%s\",\"operation\":\"%s\",\"key_size\":%u,\"data_size\":%u,\"count\":%lu,\"ops_per_s\":%lu,"
+      "\"mb_per_s\":%.2f,\"cycles_per_op\":%lu",
+      result->nx_crypto_benchmark_result_name,
+      operations[result->nx_crypto_benchmark_result_operation],
+      result->nx_crypto_benchmark_result_key_size,
+      result->nx_crypto_benchmark_result_data_size,
+      result->nx_crypto_benchmark_result_count,
+      result->nx_crypto_benchmark_result_ops_per_second,
+      result->nx_crypto_benchmark_result_bytes_per_second / 1e6,
+      result->nx_crypto_benchmark_result_ticks_per_operation);
+
+  results++;
+}
+
+static VOID test_entry(ULONG input)
+{
+  NX_CRYPTO_BENCHMARK benchmark;
+  UINT                index;
+
+  (void)input;
+
+  for (index = 0; index < sizeof(methods) / sizeof(methods[0]); index++)
+  {
+    TEST_ASSERT(methods[index]->nx_crypto_metadata_area_size <= sizeof(metadata));
+  }
+
+  memset(&benchmark, 0, sizeof(benchmark));
+  benchmark.nx_crypto_benchmark_clock         = cycles_get;
+  benchmark.nx_crypto_benchmark_clock_rate    = SystemCoreClock;
+  benchmark.nx_crypto_benchmark_duration      = BENCH_DURATION;
+  benchmark.nx_crypto_benchmark_report        = result_report;
+  benchmark.nx_crypto_benchmark_metadata      = metadata;
+  benchmark.nx_crypto_benchmark_metadata_size = sizeof(metadata);
+
+  TEST_ASSERT(_nx_crypto_method_benchmark_run(&benchmark) == NX_CRYPTO_SUCCESS);
+  TEST_ASSERT(results == BENCH_RESULTS);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100);
+}
@@ -0,0 +1,390 @@
+/**
+  ******************************************************************************
+  * @file    huge_number_test.c
+  * @brief   The modular exponentiation of RSA and DH against the host OpenSSL
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* _nx_crypto_rsa_operation with the public exponent, with a full length
+   private exponent, and with the private exponent and the primes (CRT), on
+   keys of 1024 and 2048 bits, and with a full length exponent on a 4096 bit
+   odd modulus. Every result must match BN_mod_exp, and the operation must
+   stay within the scratch documented in nx_crypto_rsa.h: 7 times the modulus
+   plus 8 bytes without CRT, 10 times the modulus plus 24 bytes with CRT, plus
+   NX_CRYPTO_HUGE_NUMBER_WINDOW_SCRATCH_SIZE of the modulus or of the prime.
+   The scratch past that size is filled with a pattern that must be left as
+   it is, and NX_CRYPTO_RSA_SCRATCH_BUFFER_SIZE must hold the largest.
+
+   Two parties of DH group 2 must compute the same secret, the public key must
+   be the generator to the private key modulo the prime, and the scratch past
+   NX_CRYPTO_DIFFIE_HELLMAN_SCRATCH_SIZE must be left as it is.
+
+   The test is built with the board configuration, and again as
+   huge_number_test_window4, huge_number_test_window6 and
+   huge_number_test_no_fios, so the window of 1, 4 and 6 bits and both
+   Montgomery multiplications are checked. Each operation is reported with
+   its cycles on the simulated cycle counter of the host port. */
+
+#include <string.h>
+
+#include <openssl/bn.h>
+
+#include "nx_crypto_dh.h"
+#include "nx_crypto_rsa.h"
+#include "stm32u5xx.h"
+#include "test_common.h"
+
+#define TEST_PRIORITY       4
+
+#define RSA_EXPONENT        65537
+
+/* The largest modulus of the test, in bytes. */
+#define MODULUS_MAX         (4096 / 8)
+
+/* Bytes past the documented scratch that must keep their pattern. */
+#define SCRATCH_GUARD       256
+#define SCRATCH_PATTERN     0xA5
+
+/* Operations measured for the cycles of each result. */
+#define OPERATION_COUNT     4
+
+#define DH_PARTIES          2
+
+typedef struct RSA_KEY_STRUCT
+{
+  UINT   modulus_length;
+  UCHAR  modulus[MODULUS_MAX];
+  UCHAR  public_exponent[4];
+  UINT   public_exponent_length;
+  UCHAR  private_exponent[MODULUS_MAX];
+  UCHAR  p[MODULUS_MAX / 2];
+  UCHAR  q[MODULUS_MAX / 2];
+  BIGNUM* n;
+  BIGNUM* e;
+  BIGNUM* d;
+} RSA_KEY;
+
+static TX_THREAD test_thread;
+static ULONG64   test_stack[32768 / sizeof(ULONG64)];
+static ULONG64   scratch[(NX_CRYPTO_RSA_SCRATCH_BUFFER_SIZE * sizeof(USHORT) + SCRATCH_GUARD) / sizeof(ULONG64) + 1];
+static ULONG64   dh_scratch[(NX_CRYPTO_DIFFIE_HELLMAN_SCRATCH_SIZE + SCRATCH_GUARD) / sizeof(ULONG64) + 1];
+static BN_CTX*   bn_ctx;
+
+static UINT rsa_scratch_size(UINT modulus_length, UINT crt)
+{
+  if (crt)
+  {
+    return 10 * modulus_length + 24 + NX_CRYPTO_HUGE_NUMBER_WINDOW_SCRATCH_SIZE(modulus_length / 2);
+  }
+
+  return 7 * modulus_length + 8 + NX_CRYPTO_HUGE_NUMBER_WINDOW_SCRATCH_SIZE(modulus_length);
+}
+
+static VOID guard_fill(UCHAR* buffer, UINT size)
+{
+  memset(buffer, SCRATCH_PATTERN, size + SCRATCH_GUARD);
+}
+
+static UINT guard_check(const UCHAR* buffer, UINT size)
+{
+  UINT index;
+
+  for (index = size; index < size + SCRATCH_GUARD; index++)
+  {
+    if (buffer[index] != SCRATCH_PATTERN)
+    {
+      return NX_FALSE;
+    }
+  }
+
+  return NX_TRUE;
+}
+
+static VOID bn_bytes(const BIGNUM* number, UCHAR* bytes, UINT length)
+{
+  TEST_ASSERT(BN_bn2binpad(number, bytes, (int)length) == (int)length);
+}
+
+static VOID rsa_key_generate(RSA_KEY* key, UINT bits)
+{
+  BIGNUM* p   = BN_new();
+  BIGNUM* q   = BN_new();
+  BIGNUM* p1  = BN_new();
+  BIGNUM* q1  = BN_new();
+  BIGNUM* phi = BN_new();
+
+  memset(key, 0, sizeof(*key));
+  key->modulus_length = bits / 8;
+  key->n              = BN_new();
+  key->e              = BN_new();
+  key->d              = BN_new();
+  TEST_ASSERT(BN_set_word(key->e, RSA_EXPONENT));
+
+  do
+  {
+    TEST_ASSERT(BN_generate_prime_ex(p, (int)bits / 2, 0, NULL, NULL, NULL));
+    TEST_ASSERT(BN_generate_prime_ex(q, (int)bits / 2, 0, NULL, NULL, NULL));
+    TEST_ASSERT(BN_mul(key->n, p, q, bn_ctx));
+    TEST_ASSERT(BN_sub(p1, p, BN_value_one()) && BN_sub(q1, q, BN_value_one()));
+    TEST_ASSERT(BN_mul(phi, p1, q1, bn_ctx));
+  } while ((BN_num_bits(key->n) != (int)bits) || (BN_mod_inverse(key->d, key->e, phi, bn_ctx) == NULL));
+
+  bn_bytes(key->n, key->modulus, key->modulus_length);
+  bn_bytes(key->d, key->private_exponent, key->modulus_length);
+  bn_bytes(p, key->p, key->modulus_length / 2);
+  bn_bytes(q, key->q, key->modulus_length / 2);
+  key->public_exponent_length = (UINT)BN_num_bytes(key->e);
+  bn_bytes(key->e, key->public_exponent, key->public_exponent_length);
+
+  BN_free(p);
+  BN_free(q);
+  BN_free(p1);
+  BN_free(q1);
+  BN_free(phi);
+}
+
+/* Any odd modulus of the full length, with a full length exponent, for the
+   exponentiation without CRT. */
+static VOID rsa_modulus_generate(RSA_KEY* key, UINT bits)
+{
+  memset(key, 0, sizeof(*key));
+  key->modulus_length = bits / 8;
+  key->n              = BN_new();
+  key->e              = BN_new();
+  key->d              = BN_new();
+
+  TEST_ASSERT(BN_rand(key->n, (int)bits, BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ODD));
+  TEST_ASSERT(BN_rand(key->d, (int)bits, BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ANY));
+  TEST_ASSERT(BN_mod(key->d, key->d, key->n, bn_ctx));
+
+  bn_bytes(key->n, key->modulus, key->modulus_length);
+  bn_bytes(key->d, key->private_exponent, key->modulus_length);
+}
+
+static VOID rsa_key_free(RSA_KEY* key)
+{
+  BN_free(key->n);
+  BN_free(key->e);
+  BN_free(key->d);
+}
+
+static VOID rsa_check(const CHAR* operation, RSA_KEY* key, UINT private_key, UINT crt)
+{
+  UCHAR*       buffer      = (UCHAR*)scratch;
+  UINT         size        = rsa_scratch_size(key->modulus_length, crt);
+  const UCHAR* exponent    = private_key ? key->private_exponent : key->public_exponent;
+  UINT         exponent_length = private_key ? key->modulus_length : key->public_exponent_length;
+  BIGNUM*      input       = BN_new();
+  BIGNUM*      expected    = BN_new();
+  UCHAR        input_bytes[MODULUS_MAX];
+  UCHAR        expected_bytes[MODULUS_MAX];
+  UCHAR        output[MODULUS_MAX];
+  ULONG64      cycles = 0;
+  ULONG64      start;
+  UINT         count;
+
+  TEST_ASSERT(size + SCRATCH_GUARD <= sizeof(scratch));
+  TEST_ASSERT(size <= NX_CRYPTO_RSA_SCRATCH_BUFFER_SIZE * sizeof(USHORT));
+
+  for (count = 0; count < OPERATION_COUNT; count++)
+  {
+    TEST_ASSERT(BN_rand_range(input, key->n));
+    TEST_ASSERT(BN_mod_exp(expected, input, private_key ? key->d : key->e, key->n, bn_ctx));
+    bn_bytes(input, input_bytes, key->modulus_length);
+    bn_bytes(expected, expected_bytes, key->modulus_length);
+
+    guard_fill(buffer, size);
+    memset(output, 0, sizeof(output));
+
+    start = _tx_host_cycles_get();
+    TEST_ASSERT(_nx_crypto_rsa_operation(exponent,
+                    exponent_length,
+                    key->modulus,
+                    key->modulus_length,
+                    crt ? key->p : NX_CRYPTO_NULL,
+                    key->modulus_length / 2,
+                    crt ? key->q : NX_CRYPTO_NULL,
+                    key->modulus_length / 2,
+                    input_bytes,
+                    key->modulus_length,
+                    output,
+                    (USHORT*)buffer,
+                    size) == NX_CRYPTO_SUCCESS);
+    cycles += _tx_host_cycles_get() - start;
+
+    /* The result is extracted without its leading zero digits. */
+    TEST_ASSERT(memcmp(output,
+                    expected_bytes + key->modulus_length - ((BN_num_bytes(expected) + 3) & ~3),
+                    (BN_num_bytes(expected) + 3) & ~3) == 0);
+    TEST_ASSERT(guard_check(buffer, size));
+  }
+
+  test_result("huge_number",
+      "\"operation\":\"%s\",\"modulus_bits\":%u,\"window_bits\":%u,\"fios\":%s,\"scratch\":%u,\"cycles_per_op\":%llu",
+      operation,
+      key->modulus_length * 8,
+      NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS,
+#ifdef NX_CRYPTO_HUGE_NUMBER_DISABLE_FIOS
+      "false",
+#else
+      "true",
+#endif
+      size,
+      (unsigned long long)(cycles / OPERATION_COUNT));
+
+  BN_free(input);
+  BN_free(expected);
+}
+
+static VOID dh_check(VOID)
+{
+  static NX_CRYPTO_DH dh[DH_PARTIES];
+  UCHAR*              buffer = (UCHAR*)dh_scratch;
+  UCHAR               public_key[DH_PARTIES][NX_CRYPTO_DIFFIE_HELLMAN_MAX_KEY_SIZE];
+  UINT                public_key_length[DH_PARTIES];
+  UCHAR               secret[DH_PARTIES][NX_CRYPTO_DIFFIE_HELLMAN_MAX_KEY_SIZE];
+  ULONG               secret_length[DH_PARTIES];
+  UCHAR               expected_bytes[NX_CRYPTO_DIFFIE_HELLMAN_MAX_KEY_SIZE];
+  UCHAR               private_bytes[NX_CRYPTO_DIFFIE_HELLMAN_MAX_KEY_SIZE];
+  BIGNUM*             prime = BN_get_rfc2409_prime_1024(NULL);
+  BIGNUM*             generator = BN_new();
+  BIGNUM*             private_key = BN_new();
+  BIGNUM*             expected = BN_new();
+  ULONG64             cycles = 0;
+  ULONG64             start;
+  UINT                party;
+  UINT                index;
+
+  TEST_ASSERT((prime != NULL) && BN_set_word(generator, 2));
+
+  for (party = 0; party < DH_PARTIES; party++)
+  {
+    guard_fill(buffer, NX_CRYPTO_DIFFIE_HELLMAN_SCRATCH_SIZE);
+    memset(&dh[party], 0, sizeof(dh[party]));
+
+    start = _tx_host_cycles_get();
+    TEST_ASSERT(_nx_crypto_dh_setup(&dh[party],
+                    public_key[party],
+                    &public_key_length[party],
+                    NX_CRYPTO_DH_GROUP_2,
+                    (HN_UBASE*)buffer) == NX_CRYPTO_SUCCESS);
+    cycles += _tx_host_cycles_get() - start;
+
+    TEST_ASSERT(public_key_length[party] == NX_CRYPTO_DIFFIE_HELLMAN_GROUP_2_KEY_SIZE);
+    TEST_ASSERT(guard_check(buffer, NX_CRYPTO_DIFFIE_HELLMAN_SCRATCH_SIZE));
+
+    /* The private key is kept as little endian digits. */
+    for (index = 0; index < NX_CRYPTO_DIFFIE_HELLMAN_GROUP_2_KEY_SIZE; index++)
+    {
+      private_bytes[NX_CRYPTO_DIFFIE_HELLMAN_GROUP_2_KEY_SIZE - 1 - index] =
+          (UCHAR)(dh[party].nx_crypto_dh_private_key_buffer[index / sizeof(HN_UBASE)] >> (8 * (index % sizeof(HN_UBASE))));
+    }
+    TEST_ASSERT(BN_bin2bn(private_bytes, NX_CRYPTO_DIFFIE_HELLMAN_GROUP_2_KEY_SIZE, private_key) != NULL);
+    TEST_ASSERT(BN_mod_exp(expected, generator, private_key, prime, bn_ctx));
+    bn_bytes(expected, expected_bytes, NX_CRYPTO_DIFFIE_HELLMAN_GROUP_2_KEY_SIZE);
+    TEST_ASSERT(memcmp(public_key[party], expected_bytes, NX_CRYPTO_DIFFIE_HELLMAN_GROUP_2_KEY_SIZE) == 0);
+  }
+
+  for (party = 0; party < DH_PARTIES; party++)
+  {
+    guard_fill(buffer, NX_CRYPTO_DIFFIE_HELLMAN_SCRATCH_SIZE);
+    secret_length[party] = sizeof(secret[party]);
+
+    start = _tx_host_cycles_get();
+    TEST_ASSERT(_nx_crypto_dh_compute_secret(&dh[party],
+                    secret[party],
+                    &secret_length[party],
+                    public_key[DH_PARTIES - 1 - party],
+                    public_key_length[DH_PARTIES - 1 - party],
+                    (HN_UBASE*)buffer) == NX_CRYPTO_SUCCESS);
+    cycles += _tx_host_cycles_get() - start;
+
+    TEST_ASSERT(guard_check(buffer, NX_CRYPTO_DIFFIE_HELLMAN_SCRATCH_SIZE));
+  }
+
+  TEST_ASSERT((secret_length[0] == secret_length[1]) && (secret_length[0] > 0));
+  TEST_ASSERT(memcmp(secret[0], secret[1], secret_length[0]) == 0);
+
+  test_result("huge_number",
+      "\"operation\":\"dh_group_2\",\"modulus_bits\":%u,\"window_bits\":%u,\"fios\":%s,\"scratch\":%u,\"cycles_per_op\":%llu",
+      NX_CRYPTO_DIFFIE_HELLMAN_GROUP_2_KEY_SIZE * 8,
+      NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS,
+#ifdef NX_CRYPTO_HUGE_NUMBER_DISABLE_FIOS
+      "false",
+#else
+      "true",
+#endif
+      (UINT)NX_CRYPTO_DIFFIE_HELLMAN_SCRATCH_SIZE,
+      (unsigned long long)(cycles / (2 * DH_PARTIES)));
+
+  BN_free(prime);
+  BN_free(generator);
+  BN_free(private_key);
+  BN_free(expected);
+}
+
+static VOID test_entry(ULONG input)
+{
+  static RSA_KEY key;
+  static const UINT key_bits[] = {1024, 2048};
+  UINT           index;
+
+  (void)input;
+
+  bn_ctx = BN_CTX_new();
+  TEST_ASSERT(bn_ctx != NULL);
+
+  /* The largest exponentiation of the TLS connection must fit the scratch of the RSA method. */
+  TEST_ASSERT(rsa_scratch_size(NX_CRYPTO_MAX_RSA_MODULUS_SIZE / 8, NX_TRUE) <= NX_CRYPTO_RSA_SCRATCH_BUFFER_SIZE * sizeof(USHORT));
+  TEST_ASSERT(rsa_scratch_size(NX_CRYPTO_MAX_RSA_MODULUS_SIZE / 8, NX_FALSE) <= NX_CRYPTO_RSA_SCRATCH_BUFFER_SIZE * sizeof(USHORT));
+
+  for (index = 0; index < sizeof(key_bits) / sizeof(key_bits[0]); index++)
+  {
+    rsa_key_generate(&key, key_bits[index]);
+    rsa_check("rsa_public", &key, NX_FALSE, NX_FALSE);
+    rsa_check("rsa_private", &key, NX_TRUE, NX_FALSE);
+    rsa_check("rsa_private_crt", &key, NX_TRUE, NX_TRUE);
+    rsa_key_free(&key);
+  }
+
+  rsa_modulus_generate(&key, MODULUS_MAX * 8);
+  rsa_check("rsa_private", &key, NX_TRUE, NX_FALSE);
+  rsa_key_free(&key);
+
+  dh_check();
+
+  BN_CTX_free(bn_ctx);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread,
+      "Test",
+      test_entry,
+      0,
+      test_stack,
+      sizeof(test_stack),
+      TEST_PRIORITY,
+      TEST_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100);
+}
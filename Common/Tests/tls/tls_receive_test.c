@@ -0,0 +1,216 @@
+/**
+  ******************************************************************************
+  * @file    tls_receive_test.c
+  * @brief   TLS application data receive rate and pool use per record size
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The broker publishes messages that each fill one TLS record of 1 to 16 KB,
+   over the AES-GCM suite. The device receives them one at a time through the
+   MQTT client. For each record size the test reports the receive rate, as
+   bytes per CPU time of the device IP and MQTT threads, and the most packets
+   of the device pool in use at once. The payloads are checked.
+
+   The program is built twice: tls_receive_test decrypts in the received
+   packets (NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT, as on the boards), and
+   tls_receive_test_copy_decrypt decrypts into a second chain. */
+
+#include "test_broker.h"
+#include "test_common.h"
+#include "test_tls.h"
+
+#define DEVICE_PRIORITY     10
+#define MQTT_PRIORITY       9
+#define DEVICE_PACKETS      128
+#define BROKER_PACKETS      128
+#define KEEPALIVE           300
+
+/* Bytes received in a round, and the rounds for each record size. The rate
+   reported is the one of the fastest round, the others include host noise. */
+#define RECEIVE_BYTES       (1024 * 1024)
+#define ROUNDS              5
+
+#define TOPIC               "bench"
+#define TOPIC_LENGTH        (sizeof(TOPIC) - 1)
+
+#ifdef NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT
+#define DECRYPT_PATH        "in_place"
+#else
+#define DECRYPT_PATH        "copy"
+#endif /* NX_SECURE_TLS_ENABLE_IN_PLACE_DECRYPT */
+
+static const UINT record_sizes[] = {1024, 2048, 4096, 8192, 16384};
+
+static TEST_NET_HOST   device;
+static TEST_BROKER     broker;
+static NXD_MQTT_CLIENT mqtt;
+static ULONG64         mqtt_stack[8192 / sizeof(ULONG64)];
+static TX_THREAD       device_thread;
+static ULONG64         device_stack[16384 / sizeof(ULONG64)];
+static TX_SEMAPHORE    received;
+static UCHAR           sent[TEST_BROKER_PACKET_MAX];
+static UCHAR           message[TEST_BROKER_PACKET_MAX];
+
+static VOID receive_notify(NXD_MQTT_CLIENT* client_ptr, UINT number_of_messages)
+{
+  (void)client_ptr;
+  (void)number_of_messages;
+
+  tx_semaphore_put(&received);
+}
+
+/* Payload of a PUBLISH whose MQTT packet is record_size bytes. */
+static UINT payload_length_get(UINT record_size)
+{
+  UINT remaining = record_size - 1 - 1;
+
+  /* The remaining length takes one more byte from 128 and from 16384. */
+  if (remaining >= 128)
+  {
+    remaining--;
+  }
+  if (remaining >= 16384)
+  {
+    remaining--;
+  }
+
+  return remaining - 2 - TOPIC_LENGTH;
+}
+
+/* The MQTT client runs on the thread of its cloud helper, NXD_MQTT_CLOUD_ENABLE. */
+static ULONG64 device_cpu_ns(VOID)
+{
+  return tx_host_thread_cpu_ns(&device.ip.nx_ip_thread) +
+         tx_host_thread_cpu_ns(&mqtt.nxd_mqtt_client_cloud_ptr->nx_cloud_thread);
+}
+
+static VOID run(UINT record_size)
+{
+  UINT    payload_length = payload_length_get(record_size);
+  UINT    count = RECEIVE_BYTES / record_size;
+  UINT    topic_length;
+  UINT    message_length;
+  UCHAR   topic[16];
+  ULONG   idle_used;
+  ULONG64 cpu_start;
+  ULONG64 cpu_ns = 0;
+  UINT    round;
+  UINT    i;
+  UINT    j;
+
+  idle_used = test_net_packets_used(&device);
+  test_net_packets_used_max_reset(&device);
+
+  for (round = 0; round < ROUNDS; round++)
+  {
+    cpu_start = device_cpu_ns();
+
+    for (i = 0; i < count; i++)
+    {
+      for (j = 0; j < payload_length; j++)
+      {
+        sent[j] = (UCHAR)(round + i + j * 7);
+      }
+
+      TEST_ASSERT(test_broker_publish(&broker, TOPIC, sent, payload_length) == NX_SUCCESS);
+      TEST_ASSERT(tx_semaphore_get(&received, 10 * NX_IP_PERIODIC_RATE) == TX_SUCCESS);
+      TEST_ASSERT(nxd_mqtt_client_message_get(&mqtt,
+                      topic,
+                      sizeof(topic),
+                      &topic_length,
+                      message,
+                      sizeof(message),
+                      &message_length) == NXD_MQTT_SUCCESS);
+      TEST_ASSERT((topic_length == TOPIC_LENGTH) && (memcmp(topic, TOPIC, TOPIC_LENGTH) == 0));
+      TEST_ASSERT((message_length == payload_length) && (memcmp(message, sent, payload_length) == 0));
+    }
+
+    if ((round == 0) || (device_cpu_ns() - cpu_start < cpu_ns))
+    {
+      cpu_ns = device_cpu_ns() - cpu_start;
+    }
+  }
+
+  test_result("tls_receive",
+      "\"path\":\"%s\",\"record_bytes\":%u,\"records\":%u,\"mb_per_s\":%.1f,\"pool_packets_peak\":%lu",
+      DECRYPT_PATH,
+      record_size,
+      count,
+      (double)count * record_size * 1000.0 / (double)cpu_ns,
+      (unsigned long)(test_net_packets_used_max(&device) - idle_used));
+}
+
+static VOID device_entry(ULONG input)
+{
+  NXD_ADDRESS server;
+  UINT        i;
+
+  (void)input;
+
+  nx_secure_tls_initialize();
+  TEST_ASSERT(tx_semaphore_create(&received, "Received", 0) == TX_SUCCESS);
+  TEST_ASSERT(test_broker_create(&broker, TEST_NET_ADDRESS(1), BROKER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_net_host_create(&device, "Device", TEST_NET_ADDRESS(2), DEVICE_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(nxd_mqtt_client_create(&mqtt,
+                  "MQTT",
+                  "device",
+                  6,
+                  &device.ip,
+                  &device.pool,
+                  mqtt_stack,
+                  sizeof(mqtt_stack),
+                  MQTT_PRIORITY,
+                  NX_NULL,
+                  0) == NXD_MQTT_SUCCESS);
+  TEST_ASSERT(nxd_mqtt_client_receive_notify_set(&mqtt, receive_notify) == NXD_MQTT_SUCCESS);
+
+  server.nxd_ip_version = NX_IP_VERSION_V4;
+  server.nxd_ip_address.v4 = TEST_NET_ADDRESS(1);
+  TEST_ASSERT(nxd_mqtt_client_secure_connect(
+                  &mqtt, &server, TEST_BROKER_PORT, test_tls_client_setup, KEEPALIVE, NX_TRUE, NX_WAIT_FOREVER) ==
+              NXD_MQTT_SUCCESS);
+  TEST_ASSERT(mqtt.nxd_mqtt_tls_session.nx_secure_tls_session_ciphersuite->nx_secure_tls_ciphersuite ==
+              TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256);
+
+  for (i = 0; i < sizeof(record_sizes) / sizeof(record_sizes[0]); i++)
+  {
+    run(record_sizes[i]);
+  }
+
+  TEST_ASSERT(nxd_mqtt_client_disconnect(&mqtt) == NXD_MQTT_SUCCESS);
+  TEST_ASSERT(nxd_mqtt_client_delete(&mqtt) == NXD_MQTT_SUCCESS);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  nx_system_initialize();
+  tx_thread_create(&device_thread,
+      "Device",
+      device_entry,
+      0,
+      device_stack,
+      sizeof(device_stack),
+      DEVICE_PRIORITY,
+      DEVICE_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100000);
+}
@@ -0,0 +1,174 @@
+/**
+  ******************************************************************************
+  * @file    tls_resumption_test.c
+  * @brief   IoT Hub reconnect time with and without TLS session resumption
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* The device connects the IoT Hub client to the broker over a link with a
+   100 ms round trip, resolving the hub name with the DNS responder. After a
+   first connect, each round reconnects twice: once after the broker forgot its
+   sessions, so the session offered from the Azure IoT cache is refused and the
+   handshake is full, then once with the session of that handshake, resumed.
+   For the cold first connect, the full and the resumed reconnects the test
+   reports the time of nx_azure_iot_hub_client_connect, the CPU time of the
+   device threads and the TLS bytes exchanged. The handshakes counted by the
+   broker and by nx_azure_iot_tls_session_statistics_get are checked. */
+
+#include "test_broker.h"
+#include "test_common.h"
+#include "test_dns.h"
+#include "test_hub.h"
+
+#define DEVICE_PRIORITY     10
+#define DEVICE_PACKETS      64
+#define BROKER_PACKETS      64
+#define DNS_PACKETS         16
+
+/* The link: 50 ms one way, 2 Mbit/s. */
+#define LINK_DELAY          5
+#define LINK_RATE           2500
+#define LINK_QUEUE          (64 * 1024)
+
+#define ROUNDS              5
+
+#define TICK_MS             (1000 / NX_IP_PERIODIC_RATE)
+
+typedef struct CONNECT_COST_STRUCT
+{
+  ULONG   connects;
+  ULONG   ticks;
+  ULONG64 cpu_ns;
+  ULONG   tls_bytes;
+} CONNECT_COST;
+
+static TEST_NET_HOST   device;
+static TEST_BROKER     broker;
+static TEST_DNS        dns;
+static TEST_HUB_CLIENT hub;
+static TX_THREAD       device_thread;
+static ULONG64         device_stack[16384 / sizeof(ULONG64)];
+
+/* The handshake runs on the connecting thread, the records are received on
+   the IP thread and the MQTT client runs on the cloud thread of Azure IoT. */
+static ULONG64 device_cpu_ns(VOID)
+{
+  return tx_host_thread_cpu_ns(&device_thread) + tx_host_thread_cpu_ns(&device.ip.nx_ip_thread) +
+         tx_host_thread_cpu_ns(&hub.nx_azure_iot.nx_azure_iot_cloud.nx_cloud_thread);
+}
+
+/* Connect and disconnect, adding the cost of the connect to cost_ptr. The
+   handshake must have been resumed when resumed is set. */
+static VOID connect_once(CONNECT_COST* cost_ptr, UINT resumed)
+{
+  ULONG   handshakes = broker.stats.handshakes;
+  ULONG   handshakes_resumed = broker.stats.handshakes_resumed;
+  ULONG   tls_bytes = broker.stats.bytes_received + broker.stats.bytes_sent;
+  ULONG   start = tx_time_get();
+  ULONG64 cpu_start = device_cpu_ns();
+
+  TEST_ASSERT(nx_azure_iot_hub_client_connect(&hub.hub_client, NX_TRUE, NX_WAIT_FOREVER) == NX_AZURE_IOT_SUCCESS);
+
+  cost_ptr->ticks += tx_time_get() - start;
+  cost_ptr->cpu_ns += device_cpu_ns() - cpu_start;
+  cost_ptr->connects++;
+
+  TEST_ASSERT(broker.stats.handshakes == handshakes + 1);
+  TEST_ASSERT(broker.stats.handshakes_resumed == handshakes_resumed + (resumed ? 1 : 0));
+
+  TEST_ASSERT(nx_azure_iot_hub_client_disconnect(&hub.hub_client) == NX_AZURE_IOT_SUCCESS);
+
+  /* Let the broker close its side, its counters then hold the whole session. */
+  while (broker.connected)
+  {
+    tx_thread_sleep(1);
+  }
+  cost_ptr->tls_bytes += broker.stats.bytes_received + broker.stats.bytes_sent - tls_bytes;
+}
+
+static VOID cost_report(const CHAR* handshake, CONNECT_COST* cost_ptr)
+{
+  test_result("tls_resumption",
+      "\"handshake\":\"%s\",\"connects\":%lu,\"connect_ms\":%lu,\"cpu_us\":%llu,\"tls_bytes\":%lu",
+      handshake,
+      cost_ptr->connects,
+      cost_ptr->ticks * TICK_MS / cost_ptr->connects,
+      cost_ptr->cpu_ns / 1000 / cost_ptr->connects,
+      cost_ptr->tls_bytes / cost_ptr->connects);
+}
+
+static VOID device_entry(ULONG input)
+{
+  CONNECT_COST cold = {0};
+  CONNECT_COST full = {0};
+  CONNECT_COST resumed = {0};
+  ULONG        resumed_count;
+  ULONG        full_count;
+  UINT         round;
+
+  (void)input;
+
+  nx_host_link_configure(LINK_DELAY, LINK_RATE, LINK_QUEUE);
+  nx_secure_tls_initialize();
+  TEST_ASSERT(test_broker_create(&broker, TEST_NET_ADDRESS(1), BROKER_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_create(&dns, TEST_NET_ADDRESS(3), DNS_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_dns_record_add(&dns, TEST_HUB_HOSTNAME, TEST_NET_ADDRESS(1)) == NX_SUCCESS);
+  TEST_ASSERT(test_net_host_create(&device, "Device", TEST_NET_ADDRESS(2), DEVICE_PACKETS) == NX_SUCCESS);
+  TEST_ASSERT(test_hub_client_create(&hub, &device, TEST_NET_ADDRESS(3)) == NX_SUCCESS);
+
+  /* Nothing cached yet: the name is resolved and the handshake is full. */
+  connect_once(&cold, NX_FALSE);
+
+  for (round = 0; round < ROUNDS; round++)
+  {
+    test_broker_sessions_flush(&broker);
+    connect_once(&full, NX_FALSE);
+    connect_once(&resumed, NX_TRUE);
+  }
+
+  /* The refused sessions count as full handshakes. */
+  TEST_ASSERT(nx_azure_iot_tls_session_statistics_get(&hub.nx_azure_iot, &resumed_count, &full_count) ==
+              NX_AZURE_IOT_SUCCESS);
+  TEST_ASSERT((resumed_count == ROUNDS) && (full_count == ROUNDS + 1));
+  TEST_ASSERT(dns.queries == 1);
+
+  cost_report("cold", &cold);
+  cost_report("full", &full);
+  cost_report("resumed", &resumed);
+
+  TEST_ASSERT(test_hub_client_delete(&hub) == NX_SUCCESS);
+
+  test_pass();
+}
+
+VOID tx_application_define(VOID* first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  nx_system_initialize();
+  tx_thread_create(&device_thread,
+      "Device",
+      device_entry,
+      0,
+      device_stack,
+      sizeof(device_stack),
+      DEVICE_PRIORITY,
+      DEVICE_PRIORITY,
+      TX_NO_TIME_SLICE,
+      TX_AUTO_START);
+}
+
+int main(void)
+{
+  return test_run(100000);
+}